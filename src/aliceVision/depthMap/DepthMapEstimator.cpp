@@ -21,6 +21,15 @@
 #include <aliceVision/depthMap/cuda/host/DeviceCache.hpp>
 #include <aliceVision/depthMap/cuda/host/DeviceStreamManager.hpp>
 #include <aliceVision/depthMap/cuda/planeSweeping/deviceDepthSimilarityMap.hpp>
+#include <aliceVision/depthMap/cpu/HostMipmapImage.hpp>
+#include <aliceVision/depthMap/cpu/SgmCpu.hpp>
+#include <aliceVision/depthMap/cpu/RefineCpu.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <exception>
+#include <memory>
+#include <set>
 
 namespace aliceVision {
 namespace depthMap {
@@ -170,6 +179,85 @@ int DepthMapEstimator::getNbSimultaneousTiles() const
     return out_nbSimultaneousTiles;
 }
 
+int DepthMapEstimator::getNbSimultaneousTilesOnCpu() const
+{
+    const int nbTilesPerCamera = _tileRoiList.size();
+
+    // mipmap image cost
+    // mipmap image should not exceed (1.5 * max_width) * max_height
+    // note: the first mipmap level is the minimum SGM / Refine downscale
+    const int minMipmapDownscale = std::min(_refineParams.scale, _sgmParams.scale);
+    const double mipmapCostMB = (((_mp.getMaxImageWidth() / minMipmapDownscale) * 1.5) * (_mp.getMaxImageHeight() / minMipmapDownscale) *
+                                 sizeof(HostColor)) /
+                                (1024.0 * 1024.0);
+
+    // cameras cost per R camera computation
+    // Rc mipmap + Tcs mipmaps
+    const double rcCamsCostMB = mipmapCostMB + _depthMapParams.maxTCams * mipmapCostMB;
+
+    // single tile SGM / Refine cost
+    double sgmTileCostMB = 0.0;
+    double refineTileCostMB = 0.0;
+
+    {
+        const HostMipmapImages noMipmapImages;
+        const bool sgmComputeDepthSimMap = !_depthMapParams.useRefine;
+
+        SgmCpu sgm(_mp, _tileParams, _sgmParams, sgmComputeDepthSimMap, noMipmapImages);
+        sgmTileCostMB = sgm.getMemoryConsumption();
+
+        if (_depthMapParams.useRefine)
+        {
+            RefineCpu refine(_mp, _tileParams, _sgmParams, _refineParams, noMipmapImages);
+            refineTileCostMB = refine.getMemoryConsumption();
+        }
+    }
+
+    // tile computation cost
+    // SGM tile cost + Refine tile cost + final depth/sim map tile
+    const double tileCostMB = sgmTileCostMB + refineTileCostMB;
+
+    // min/max cost of an R camera computation
+    // min cost for a single tile computation
+    // max cost for all tiles computation
+    const double rcMinCostMB = rcCamsCostMB + tileCostMB;
+    const double rcMaxCostMB = rcCamsCostMB + nbTilesPerCamera * tileCostMB;
+
+    // available host memory
+    const double hostMemoryMB = (system::getMemoryInfo().availableRam / (1024.0 * 1024.0)) * 0.8;  // available memory margin
+
+    // number of full R camera computation that can be done simultaneously
+    const int nbSimultaneousFullRc = static_cast<int>(hostMemoryMB / rcMaxCostMB);
+
+    // try to add a part of an R camera computation
+    int nbRemainingTiles = 0;
+    {
+        const double remainingMemoryMB = hostMemoryMB - (nbSimultaneousFullRc * rcMaxCostMB);
+        nbRemainingTiles = static_cast<int>(std::max(0.0, remainingMemoryMB - rcCamsCostMB) / tileCostMB);
+    }
+
+    // compute number of simultaneous tiles
+    const int out_nbSimultaneousTiles = nbSimultaneousFullRc * nbTilesPerCamera + nbRemainingTiles;
+
+    // log memory information
+    ALICEVISION_LOG_INFO("Host memory:" << std::endl
+                                        << "\t- available: " << hostMemoryMB << " MB" << std::endl
+                                        << "\t- requirement for the first tile: " << rcMinCostMB << " MB" << std::endl
+                                        << "\t- # computation buffers per tile: " << tileCostMB << " MB"
+                                        << " (Sgm: " << sgmTileCostMB << " MB"
+                                        << ", Refine: " << refineTileCostMB << " MB)" << std::endl
+                                        << "\t- # input images (R + " << _depthMapParams.maxTCams << " Ts): " << rcCamsCostMB
+                                        << " MB (single mipmap image size: " << mipmapCostMB << " MB)");
+
+    // check at least one single tile computation
+    if (out_nbSimultaneousTiles < 1)
+    {
+        ALICEVISION_THROW_ERROR("Not enough host memory to compute a single tile.");
+    }
+
+    return out_nbSimultaneousTiles;
+}
+
 void DepthMapEstimator::getTilesList(const std::vector<int>& cams, std::vector<Tile>& tiles) const
 {
     const int nbTilesPerCamera = _tileRoiList.size();
@@ -511,5 +599,217 @@ void DepthMapEstimator::compute(int cudaDeviceId, const std::vector<int>& cams)
     refinePerStream.clear();
 }
 
+void DepthMapEstimator::computeOnCpu(const std::vector<int>& cams)
+{
+    // initialize RAM image cache
+    mvsUtils::ImagesCache<image::Image<image::RGBAfColor>> ic(_mp, image::EImageColorSpace::LINEAR);
+
+    // build tile list order by R camera
+    std::vector<Tile> tiles;
+    getTilesList(cams, tiles);
+
+    // warn about options not available on CPU
+    if (_sgmParams.useCustomPatchPattern || _refineParams.useCustomPatchPattern)
+        ALICEVISION_LOG_WARNING("Custom patch pattern is not available on CPU, use the full patch.");
+
+    if (_sgmParams.exportIntermediateDepthSimMaps || _sgmParams.exportIntermediateNormalMaps || _sgmParams.exportIntermediateVolumes ||
+        _sgmParams.exportIntermediateCrossVolumes || _sgmParams.exportIntermediateVolume9pCsv || _refineParams.exportIntermediateDepthSimMaps ||
+        _refineParams.exportIntermediateNormalMaps || _refineParams.exportIntermediateCrossVolumes || _refineParams.exportIntermediateVolume9pCsv)
+        ALICEVISION_LOG_WARNING("Intermediate results export is not available on CPU.");
+
+    // get number of parallel workers
+    // each worker computes a whole tile (SGM + Refine) with its own buffers
+    // note: with a single worker, the tile kernels are parallelized instead
+    const int nbTilesPerCamera = static_cast<int>(_tileRoiList.size());
+    const int nbWorkers = std::max(1, std::min({getNbSimultaneousTilesOnCpu(), omp_get_max_threads(), static_cast<int>(tiles.size())}));
+    const int nbRcPerBatch = divideRoundUp(nbWorkers, nbTilesPerCamera);  // number of R cameras in the same batch
+    const int nbTilesPerBatch = nbRcPerBatch * nbTilesPerCamera;          // number of tiles in the same batch
+
+    ALICEVISION_LOG_INFO("CPU parallelization:" << std::endl
+                                                << "\t- # workers: " << nbWorkers << std::endl
+                                                << "\t- # simultaneous depth maps computation: " << nbRcPerBatch);
+
+    // cameras mipmap images in host memory
+    HostMipmapImages mipmapImages;
+
+    // allocate Sgm and Refine per worker in host memory
+    std::vector<SgmCpu> sgmPerWorker;
+    std::vector<RefineCpu> refinePerWorker;
+
+    sgmPerWorker.reserve(nbWorkers);
+    refinePerWorker.reserve(_depthMapParams.useRefine ? nbWorkers : 0);
+
+    {
+        const bool sgmComputeDepthSimMap = !_depthMapParams.useRefine;
+
+        for (int i = 0; i < nbWorkers; ++i)
+            sgmPerWorker.emplace_back(_mp, _tileParams, _sgmParams, sgmComputeDepthSimMap, mipmapImages);
+
+        if (_depthMapParams.useRefine)
+            for (int i = 0; i < nbWorkers; ++i)
+                refinePerWorker.emplace_back(_mp, _tileParams, _sgmParams, _refineParams, mipmapImages);
+    }
+
+    // allocate final deth/similarity map tile list in host memory
+    std::vector<std::vector<HostFloat2Map>> depthSimMapTilePerCam(nbRcPerBatch, std::vector<HostFloat2Map>(nbTilesPerCamera));
+    std::vector<std::vector<std::pair<float, float>>> depthMinMaxTilePerCam(nbRcPerBatch, std::vector<std::pair<float, float>>(nbTilesPerCamera));
+
+    // final depth/similarity map downscale
+    const int finalScale = (_depthMapParams.useRefine) ? _refineParams.scale : _sgmParams.scale;
+    const int finalStepXY = (_depthMapParams.useRefine) ? _refineParams.stepXY : _sgmParams.stepXY;
+
+    // compute number of batches
+    const int nbBatches = divideRoundUp(static_cast<int>(tiles.size()), nbTilesPerBatch);
+    const int minMipmapDownscale = std::min(_refineParams.scale, _sgmParams.scale);
+    const int maxMipmapDownscale = std::max(_refineParams.scale, _sgmParams.scale) * std::pow(2, 6);  // we add 6 downscale levels
+
+    // compute each batch of R cameras
+    for (int b = 0; b < nbBatches; ++b)
+    {
+        // find first/last tile to compute
+        const int firstTileIndex = b * nbTilesPerBatch;
+        const int lastTileIndex = std::min((b + 1) * nbTilesPerBatch, static_cast<int>(tiles.size()));
+
+        // find batch R and T cameras
+        std::set<int> batchCams;
+        for (int i = firstTileIndex; i < lastTileIndex; ++i)
+        {
+            const Tile& tile = tiles.at(i);
+
+            batchCams.insert(tile.rc);
+            batchCams.insert(tile.sgmTCams.begin(), tile.sgmTCams.end());
+
+            if (_depthMapParams.useRefine)
+                batchCams.insert(tile.refineTCams.begin(), tile.refineTCams.end());
+        }
+
+        // release mipmap images not used by the batch
+        for (auto it = mipmapImages.begin(); it != mipmapImages.end();)
+        {
+            if (batchCams.count(it->first) == 0)
+                it = mipmapImages.erase(it);
+            else
+                ++it;
+        }
+
+        // load batch cameras mipmap images in host memory
+        for (const int cam : batchCams)
+        {
+            if (mipmapImages.count(cam) != 0)
+                continue;
+
+            std::unique_ptr<HostMipmapImage> mipmapImage(new HostMipmapImage());
+            mipmapImage->fill(*ic.getImg_sync(cam), minMipmapDownscale, maxMipmapDownscale);
+            mipmapImages.emplace(cam, std::move(mipmapImage));
+        }
+
+        std::exception_ptr exception = nullptr;
+
+        // compute each batch tile
+        // note: dynamic schedule, a worker takes the next tile as soon as it is done
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nbWorkers)
+        for (int i = firstTileIndex; i < lastTileIndex; ++i)
+        {
+            try
+            {
+                Tile& tile = tiles.at(i);
+                // note: a batch starts on the first tile of a R camera, the R camera tiles are consecutive
+                const int batchCamIndex = (i - firstTileIndex) / nbTilesPerCamera;
+                const int workerIndex = omp_get_thread_num();
+
+                // do not compute empty ROI
+                // some images in the dataset may be smaller than others
+                if (tile.roi.isEmpty())
+                    continue;
+
+                // get tile result depth/similarity map in host memory
+                HostFloat2Map& tileDepthSimMap = depthSimMapTilePerCam.at(batchCamIndex).at(tile.id);
+
+                // reset tile result depth/similarity map
+                {
+                    const ROI downscaledRoi = downscaleROI(tile.roi, finalScale * finalStepXY);
+                    tileDepthSimMap.resize(int(downscaledRoi.width()), int(downscaledRoi.height()));
+                    tileDepthSimMap.fill(-1.f, 1.f);
+                }
+
+                // check T cameras
+                if (tile.sgmTCams.empty() || (_depthMapParams.useRefine && tile.refineTCams.empty()))  // no T camera found
+                    continue;
+
+                // build tile SGM depth list
+                SgmDepthList sgmDepthList(_mp, _sgmParams, tile);
+
+                // compute the R camera depth list
+                sgmDepthList.computeListRc();
+
+                // check number of depths
+                if (sgmDepthList.getDepths().empty())  // no depth found
+                {
+                    depthMinMaxTilePerCam.at(batchCamIndex).at(tile.id) = {0.f, 0.f};
+                    continue;
+                }
+
+                // remove T cameras with no depth found.
+                sgmDepthList.removeTcWithNoDepth(tile);
+
+                // store min/max depth
+                depthMinMaxTilePerCam.at(batchCamIndex).at(tile.id) = sgmDepthList.getMinMaxDepths();
+
+                // log debug camera / depth information
+                sgmDepthList.logRcTcDepthInformation();
+
+                // check if starting and stopping depth are valid
+                sgmDepthList.checkStartingAndStoppingDepth();
+
+                // compute Semi-Global Matching
+                SgmCpu& sgm = sgmPerWorker.at(workerIndex);
+                sgm.sgmRc(tile, sgmDepthList);
+
+                if (_depthMapParams.useRefine)
+                {
+                    // smooth SGM thickness map
+                    // in order to be a proper Refine input parameter
+                    sgm.smoothThicknessMap(tile, _refineParams);
+
+                    // compute Refine
+                    RefineCpu& refine = refinePerWorker.at(workerIndex);
+                    refine.refineRc(tile, sgm.getDepthThicknessMap());
+
+                    // copy Refine depth/similarity map
+                    tileDepthSimMap = refine.getDepthSimMap();
+                }
+                else
+                {
+                    // copy Sgm depth/similarity map
+                    tileDepthSimMap = sgm.getDepthSimMap();
+                }
+            }
+            catch (...)
+            {
+#pragma omp critical
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+
+        // forward the first tile computation error
+        if (exception)
+            std::rethrow_exception(exception);
+
+        // write depth/sim map result
+        // note: the batch contains all the tiles of its R cameras
+        for (int i = firstTileIndex; i < lastTileIndex; i += nbTilesPerCamera)
+        {
+            const int c = tiles.at(i).rc;
+            const int batchCamIndex = (i - firstTileIndex) / nbTilesPerCamera;
+
+            writeDepthSimMapFromTileList(c, _mp, _tileParams, _tileRoiList, depthSimMapTilePerCam.at(batchCamIndex), finalScale, finalStepXY);
+
+            if (_depthMapParams.exportTilePattern)
+                exportDepthSimMapTilePatternObj(c, _mp, _tileRoiList, depthMinMaxTilePerCam.at(batchCamIndex));
+        }
+    }
+}
+
 }  // namespace depthMap
 }  // namespace aliceVision
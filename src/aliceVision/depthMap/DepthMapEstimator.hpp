@@ -57,6 +57,13 @@ class DepthMapEstimator : public IGPUJob
      */
     void compute(int cudaDeviceId, const std::vector<int>& cams) override;
 
+    /**
+     * @brief Compute depth/similarity maps of the given cameras on CPU.
+     * @note Tiles are computed in parallel, each thread owns its Sgm and Refine buffers.
+     * @param[in] cams the list of cameras
+     */
+    void computeOnCpu(const std::vector<int>& cams) override;
+
   private:
     // private methods
 
@@ -67,6 +74,13 @@ class DepthMapEstimator : public IGPUJob
      */
     int getNbSimultaneousTiles() const;
 
+    /**
+     * @brief Compute the maximum number of tiles (volumes, buffer, images, ...)
+     *        that fit in host memory and can be computed simultaneously.
+     * @return number of tiles
+     */
+    int getNbSimultaneousTilesOnCpu() const;
+
     /**
      * @brief Build tile list from the given cameras.
      * @param[in] cams the list of cameras
@@ -12,6 +12,11 @@
 namespace aliceVision {
 namespace depthMap {
 
+void IGPUJob::computeOnCpu(const std::vector<int>& cams)
+{
+    ALICEVISION_THROW_ERROR("No CUDA-Enabled GPU and no CPU implementation for this computation.");
+}
+
 void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPUsToUse)
 {
     const int nbGPUDevices = listCudaDevices();
@@ -19,6 +24,13 @@ void computeOnMultiGPUs(const std::vector<int>& cams, IGPUJob& gpujob, int nbGPU
 
     ALICEVISION_LOG_INFO("Number of GPU devices: " << nbGPUDevices << ", number of CPU threads: " << nbCPUThreads);
 
+    if (nbGPUDevices < 1)
+    {
+        ALICEVISION_LOG_WARNING("No CUDA-Enabled GPU found, fallback on CPU computation (" << nbCPUThreads << " threads).");
+        gpujob.computeOnCpu(cams);
+        return;
+    }
+
     int nbThreads = std::min(nbGPUDevices, nbCPUThreads);
 
     if (nbGPUsToUse > 0)
@@ -24,10 +24,18 @@ class IGPUJob
      * @param[in] cams the list of cameras
      */
     virtual void compute(int cudaDeviceId, const std::vector<int>& cams) = 0;
+
+    /**
+     * @brief Perform computation from the given cameras on CPU.
+     * @note Used when no CUDA device is available, throw by default.
+     * @param[in] cams the list of cameras
+     */
+    virtual void computeOnCpu(const std::vector<int>& cams);
 };
 
 /**
  * @brief Perform computation from the given cameras on multiple GPUs.
+ * @note Fallback on IGPUJob::computeOnCpu if no CUDA device is available.
  * @param[in] cams the given list of cameras
  * @param[in,out] gpujob the object that wrap computation (should use IGPUJob interface)
  * @param[in] nbGPUsToUse the number of GPUs to use
@@ -0,0 +1,45 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "HostCameraParams.hpp"
+
+#include <aliceVision/mvsData/Matrix3x3.hpp>
+#include <aliceVision/mvsData/Matrix3x4.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+void fillHostCameraParams(HostCameraParams& cameraParams, int camId, int downscale, const mvsUtils::MultiViewParams& mp)
+{
+    Matrix3x3 scaleM;
+    scaleM.m11 = 1.0 / float(downscale);
+    scaleM.m12 = 0.0;
+    scaleM.m13 = 0.0;
+    scaleM.m21 = 0.0;
+    scaleM.m22 = 1.0 / float(downscale);
+    scaleM.m23 = 0.0;
+    scaleM.m31 = 0.0;
+    scaleM.m32 = 0.0;
+    scaleM.m33 = 1.0;
+
+    const Matrix3x3 K = scaleM * mp.KArr[camId];
+    const Matrix3x3 iK = K.inverse();
+    const Matrix3x4 P = K * (mp.RArr[camId] | (Point3d(0.0, 0.0, 0.0) - mp.RArr[camId] * mp.CArr[camId]));
+    const Matrix3x3 iP = mp.iRArr[camId] * iK;
+    const Matrix3x3& iR = mp.iRArr[camId];
+
+    cameraParams.P << P.m11, P.m12, P.m13, P.m14, P.m21, P.m22, P.m23, P.m24, P.m31, P.m32, P.m33, P.m34;
+    cameraParams.iP << iP.m11, iP.m12, iP.m13, iP.m21, iP.m22, iP.m23, iP.m31, iP.m32, iP.m33;
+    cameraParams.C = Vec3f(mp.CArr[camId].x, mp.CArr[camId].y, mp.CArr[camId].z);
+
+    // camera axes in world coordinates: iR columns
+    cameraParams.XVect = Vec3f(iR.m11, iR.m21, iR.m31).normalized();
+    cameraParams.YVect = Vec3f(iR.m12, iR.m22, iR.m32).normalized();
+    cameraParams.ZVect = Vec3f(iR.m13, iR.m23, iR.m33).normalized();
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,143 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+
+#include <cmath>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @struct Host camera parameters
+ * @brief Camera parameters used by the CPU depth map estimation.
+ * @note Host counterpart of DeviceCameraParams, in single precision.
+ */
+struct HostCameraParams
+{
+    Eigen::Matrix<float, 3, 4> P;  //< projection matrix of the downscaled image
+    Eigen::Matrix3f iP;            //< inverse of the projection rotation part
+    Vec3f C;                       //< camera center
+    Vec3f XVect;                   //< camera X axis in world coordinates
+    Vec3f YVect;                   //< camera Y axis in world coordinates
+    Vec3f ZVect;                   //< camera Z axis in world coordinates
+};
+
+/**
+ * @brief Fill the host camera parameters of the given camera at the given downscale.
+ * @param[out] cameraParams the output camera parameters
+ * @param[in] camId the camera index in the ImagesCache / MultiViewParams
+ * @param[in] downscale the camera downscale factor
+ * @param[in] mp the multi-view parameters
+ */
+void fillHostCameraParams(HostCameraParams& cameraParams, int camId, int downscale, const mvsUtils::MultiViewParams& mp);
+
+/*
+ * Geometry helpers, identical to the CUDA device functions (matrix.cuh / Patch.cuh).
+ */
+
+inline Vec2f project3DPoint(const HostCameraParams& cam, const Vec3f& p)
+{
+    const Vec3f pp = cam.P.leftCols<3>() * p + cam.P.col(3);
+    return Vec2f(pp.x() / pp.z(), pp.y() / pp.z());
+}
+
+inline Vec3f pixelRay(const HostCameraParams& cam, const Vec2f& pix) { return (cam.iP * Vec3f(pix.x(), pix.y(), 1.f)).normalized(); }
+
+inline Vec3f linePlaneIntersect(const Vec3f& linePoint, const Vec3f& lineVect, const Vec3f& planePoint, const Vec3f& planeNormal)
+{
+    const float k = (planePoint.dot(planeNormal) - planeNormal.dot(linePoint)) / planeNormal.dot(lineVect);
+    return linePoint + lineVect * k;
+}
+
+inline Vec3f closestPointToLine3D(const Vec3f& point, const Vec3f& linePoint, const Vec3f& lineVectNormalized)
+{
+    return linePoint + lineVectNormalized * lineVectNormalized.dot(point - linePoint);
+}
+
+inline float pointLineDistance3D(const Vec3f& point, const Vec3f& linePoint, const Vec3f& lineVectNormalized)
+{
+    return lineVectNormalized.cross(linePoint - point).norm();
+}
+
+inline float angleBetwABandAC(const Vec3f& a, const Vec3f& b, const Vec3f& c)
+{
+    const Vec3f v1 = (b - a).normalized();
+    const Vec3f v2 = (c - a).normalized();
+    double angle = std::acos(double(v1.dot(v2)));
+    angle = std::isinf(angle) ? 0.0 : angle;
+    return float(std::abs(angle) / (M_PI / 180.0));
+}
+
+inline Vec3f get3DPointForPixelAndFrontoParallelPlaneRC(const HostCameraParams& cam, const Vec2f& pix, float fpPlaneDepth)
+{
+    const Vec3f planep = cam.C + cam.ZVect * fpPlaneDepth;
+    return linePlaneIntersect(cam.C, pixelRay(cam, pix), planep, cam.ZVect);
+}
+
+inline Vec3f get3DPointForPixelAndDepthFromRC(const HostCameraParams& cam, const Vec2f& pix, float depth)
+{
+    return cam.C + pixelRay(cam, pix) * depth;
+}
+
+inline float depthPlaneToDepth(const HostCameraParams& cam, float fpPlaneDepth, const Vec2f& pix)
+{
+    return (cam.C - get3DPointForPixelAndFrontoParallelPlaneRC(cam, pix, fpPlaneDepth)).norm();
+}
+
+inline float computePixSize(const HostCameraParams& cam, const Vec3f& p)
+{
+    const Vec2f rp = project3DPoint(cam, p);
+    return pointLineDistance3D(p, cam.C, pixelRay(cam, rp + Vec2f(1.f, 0.f)));
+}
+
+inline void move3DPointByRcPixSize(Vec3f& p, const HostCameraParams& rcCam, float rcPixSize)
+{
+    p += (p - rcCam.C).normalized() * rcPixSize;
+}
+
+/**
+ * @brief Compute the R and T mipmap levels for a consistent scale patch comparison.
+ * @see computeRcTcMipmapLevels in Patch.cuh
+ */
+inline void computeRcTcMipmapLevels(float& out_rcMipmapLevel,
+                                    float& out_tcMipmapLevel,
+                                    float mipmapLevel,
+                                    const HostCameraParams& rcCam,
+                                    const HostCameraParams& tcCam,
+                                    const Vec2f& rp0,
+                                    const Vec2f& tp0,
+                                    const Vec3f& p0)
+{
+    const Vec3f prp1 = rcCam.C + pixelRay(rcCam, rp0 + Vec2f(1.f, 0.f)) * (rcCam.C - p0).norm();
+    const Vec3f ptp1 = tcCam.C + pixelRay(tcCam, tp0 + Vec2f(1.f, 0.f)) * (tcCam.C - p0).norm();
+
+    const float distFactor = (p0 - prp1).norm() / (p0 - ptp1).norm();
+
+    if (distFactor < 1.f)
+    {
+        // T camera has a lower resolution
+        out_tcMipmapLevel = mipmapLevel - std::log2(1.f / distFactor);
+
+        if (out_tcMipmapLevel < 0.f)
+        {
+            out_rcMipmapLevel = mipmapLevel + std::abs(out_tcMipmapLevel);
+            out_tcMipmapLevel = 0.f;
+        }
+    }
+    else
+    {
+        // T camera has a higher resolution
+        out_rcMipmapLevel = mipmapLevel;
+        out_tcMipmapLevel = mipmapLevel + std::log2(distFactor);
+    }
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,218 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "HostMipmapImage.hpp"
+
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+namespace {
+
+/**
+ * @brief Gaussian weights of the given radius (delta 1), as the device constant Gaussian array.
+ */
+std::vector<float> getGaussianWeights(int radius)
+{
+    std::vector<float> weights(2 * radius + 1);
+    for (int i = -radius; i <= radius; ++i)
+        weights[i + radius] = std::exp(-float(i * i) / 2.f);
+    return weights;
+}
+
+/**
+ * @brief Linear RGB (0..255) to CIELAB (0..255), as rgb2lab_kernel.
+ */
+void rgb2lab(HostColor& c)
+{
+    constexpr float d = 1.f / 255.f;
+    const float r = c.x * d;
+    const float g = c.y * d;
+    const float b = c.z * d;
+
+    // linear RGB to XYZ
+    // assuming whitepoint D65, XYZ=(0.95047, 1.00000, 1.08883)
+    const float xyz[3] = {(0.4124564f * r + 0.3575761f * g + 0.1804375f * b) / 0.95047f,
+                          0.2126729f * r + 0.7151522f * g + 0.0721750f * b,
+                          (0.0193339f * r + 0.1191920f * g + 0.9503041f * b) / 1.08883f};
+
+    // XYZ to CIELAB
+    float f[3];
+    for (int i = 0; i < 3; ++i)
+        f[i] = (xyz[i] > 216.0f / 24389.0f) ? std::cbrt(xyz[i]) : (24389.0f / 27.0f * xyz[i] + 16.0f) / 116.0f;
+
+    // convert values to fit into 0..255
+    c.x = (116.0f * f[1] - 16.0f) * 2.55f;
+    c.y = (500.0f * (f[0] - f[1])) * 2.55f;
+    c.z = (200.0f * (f[1] - f[2])) * 2.55f;
+}
+
+}  // namespace
+
+void HostMipmapImage::fill(const image::Image<image::RGBAfColor>& img, int minDownscale, int maxDownscale)
+{
+    // update private members
+    _minDownscale = minDownscale;
+    _maxDownscale = maxDownscale;
+    _width = img.width();
+    _height = img.height();
+
+    const int nbLevels = int(std::log2(maxDownscale / minDownscale)) + 1;
+
+    _levels.clear();
+    _levels.resize(nbLevels);
+
+    // full-size image in range (0, 255)
+    Level fullSize;
+    fullSize.width = int(_width);
+    fullSize.height = int(_height);
+    fullSize.data.resize(_width * _height);
+
+#pragma omp parallel for
+    for (int y = 0; y < fullSize.height; ++y)
+    {
+        for (int x = 0; x < fullSize.width; ++x)
+        {
+            const image::RGBAfColor& rgba = img(y, x);
+            HostColor& c = fullSize.data[std::size_t(y) * fullSize.width + x];
+            c.x = rgba.r() * 255.0f;
+            c.y = rgba.g() * 255.0f;
+            c.z = rgba.b() * 255.0f;
+            c.w = rgba.a() * 255.0f;
+        }
+    }
+
+    Level& level0 = _levels.front();
+
+    // downscale full-size image to min downscale with gaussian blur
+    if (minDownscale > 1)
+    {
+        const int radius = minDownscale;
+        const std::vector<float> weights = getGaussianWeights(radius);
+        const float s = float(minDownscale) * 0.5f;
+
+        level0.width = divideRoundUp(fullSize.width, minDownscale);
+        level0.height = divideRoundUp(fullSize.height, minDownscale);
+        level0.data.resize(std::size_t(level0.width) * level0.height);
+
+#pragma omp parallel for
+        for (int y = 0; y < level0.height; ++y)
+        {
+            for (int x = 0; x < level0.width; ++x)
+            {
+                HostColor acc;
+                float sumFactor = 0.f;
+
+                for (int i = -radius; i <= radius; ++i)
+                {
+                    for (int j = -radius; j <= radius; ++j)
+                    {
+                        const HostColor c = fullSize.sampleTexel(float(x * minDownscale + j) + s, float(y * minDownscale + i) + s);
+                        const float factor = weights[i + radius] * weights[j + radius];
+                        acc.x += c.x * factor;
+                        acc.y += c.y * factor;
+                        acc.z += c.z * factor;
+                        acc.w += c.w * factor;
+                        sumFactor += factor;
+                    }
+                }
+
+                HostColor& out = level0.data[std::size_t(y) * level0.width + x];
+                out.x = acc.x / sumFactor;
+                out.y = acc.y / sumFactor;
+                out.z = acc.z / sumFactor;
+                out.w = acc.w / sumFactor;
+            }
+        }
+    }
+    else
+    {
+        level0 = std::move(fullSize);
+    }
+
+    // in-place color conversion into CIELAB
+#pragma omp parallel for
+    for (int i = 0; i < int(level0.data.size()); ++i)
+        rgb2lab(level0.data[i]);
+
+    // compute each level from the previous one, with a gaussian filter of radius 2
+    const int radius = 2;
+    const std::vector<float> weights = getGaussianWeights(radius);
+
+    for (int l = 1; l < nbLevels; ++l)
+    {
+        const Level& previous = _levels[l - 1];
+        Level& current = _levels[l];
+
+        current.width = previous.width / 2;
+        current.height = previous.height / 2;
+        current.data.resize(std::size_t(current.width) * current.height);
+
+        const float px = 1.f / float(current.width);
+        const float py = 1.f / float(current.height);
+
+#pragma omp parallel for
+        for (int y = 0; y < current.height; ++y)
+        {
+            for (int x = 0; x < current.width; ++x)
+            {
+                HostColor acc;
+                float sumFactor = 0.f;
+
+                for (int i = -radius; i <= radius; ++i)
+                {
+                    for (int j = -radius; j <= radius; ++j)
+                    {
+                        const HostColor c = previous.sample((x + j + 0.5f) * px, (y + i + 0.5f) * py);
+                        const float factor = weights[i + radius] * weights[j + radius];
+                        acc.x += c.x * factor;
+                        acc.y += c.y * factor;
+                        acc.z += c.z * factor;
+                        acc.w += c.w * factor;
+                        sumFactor += factor;
+                    }
+                }
+
+                HostColor& out = current.data[std::size_t(y) * current.width + x];
+                out.x = acc.x / sumFactor;
+                out.y = acc.y / sumFactor;
+                out.z = acc.z / sumFactor;
+                out.w = acc.w / sumFactor;
+            }
+        }
+    }
+}
+
+float HostMipmapImage::getLevel(unsigned int downscale) const
+{
+    // check given downscale
+    if (downscale < _minDownscale || downscale > _maxDownscale)
+        ALICEVISION_THROW_ERROR("Cannot get host mipmap image level (downscale: " << downscale << ")");
+
+    return std::log2(float(downscale) / float(_minDownscale));
+}
+
+Pixel HostMipmapImage::getDimensions(unsigned int downscale) const
+{
+    // check given downscale
+    if (downscale < _minDownscale || downscale > _maxDownscale)
+        ALICEVISION_THROW_ERROR("Cannot get host mipmap image level dimensions (downscale: " << downscale << ")");
+
+    return Pixel(divideRoundUp(int(_width), int(downscale)), divideRoundUp(int(_height), int(downscale)));
+}
+
+std::size_t HostMipmapImage::getMemoryConsumption() const
+{
+    std::size_t bytes = 0;
+    for (const Level& level : _levels)
+        bytes += level.data.size() * sizeof(HostColor);
+    return bytes;
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
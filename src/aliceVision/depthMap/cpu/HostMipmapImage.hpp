@@ -0,0 +1,178 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/pixelTypes.hpp>
+#include <aliceVision/mvsData/Pixel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @struct Host color
+ * @brief Mipmap image pixel: CIELAB color (x, y, z) and alpha (w), all in range (0, 255).
+ */
+struct HostColor
+{
+    float x = 0.f;
+    float y = 0.f;
+    float z = 0.f;
+    float w = 0.f;
+};
+
+/// Euclidean distance between two CIELAB colors (alpha ignored)
+inline float labDistance(const HostColor& a, const HostColor& b)
+{
+    const float dx = a.x - b.x;
+    const float dy = a.y - b.y;
+    const float dz = a.z - b.z;
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * @class Host mipmap image
+ * @brief Support class to maintain an image pyramid in host memory.
+ * @note Host counterpart of DeviceMipmapImage: same levels, same color conversion
+ *       and same sampling (normalized coordinates, bilinear filtering, linear filtering between levels, clamp).
+ */
+class HostMipmapImage
+{
+  public:
+    // default constructor
+    HostMipmapImage() = default;
+
+    // this class handles unique data, no copy constructor
+    HostMipmapImage(HostMipmapImage const&) = delete;
+
+    // this class handles unique data, no copy operator
+    void operator=(HostMipmapImage const&) = delete;
+
+    /**
+     * @brief Update the HostMipmapImage from an image.
+     * @param[in] img the input linear RGBA image, in range (0, 1)
+     * @param[in] minDownscale the first downscale level of the mipmap image (level 0)
+     * @param[in] maxDownscale the last downscale level of the mipmap image
+     */
+    void fill(const image::Image<image::RGBAfColor>& img, int minDownscale, int maxDownscale);
+
+    /**
+     * @brief Get the corresponding mipmap image level of the given downscale
+     * @note throw if the given downscale is not contained in the mipmap image
+     * @return corresponding mipmap image level
+     */
+    float getLevel(unsigned int downscale) const;
+
+    /**
+     * @brief Get the corresponding mipmap image level dimensions (width, height) of the given downscale.
+     * @note throw if the given downscale is not contained in the mipmap image
+     * @return corresponding mipmap image downscale level dimensions
+     */
+    Pixel getDimensions(unsigned int downscale) const;
+
+    /**
+     * @brief Get the mipmap image memory consumption.
+     * @return memory consumption (in bytes)
+     */
+    std::size_t getMemoryConsumption() const;
+
+    /**
+     * @brief Sample the mipmap image, as tex2DLod on the device mipmap image texture.
+     * @param[in] u the normalized x coordinate
+     * @param[in] v the normalized y coordinate
+     * @param[in] level the mipmap level (clamped)
+     * @return the interpolated color
+     */
+    inline HostColor sample(float u, float v, float level) const
+    {
+        level = std::min(std::max(level, 0.f), float(_levels.size() - 1));
+
+        const int level0 = int(level);
+        const float levelFactor = level - float(level0);
+
+        if (levelFactor <= 0.f)
+            return _levels[level0].sample(u, v);
+
+        const HostColor c0 = _levels[level0].sample(u, v);
+        const HostColor c1 = _levels[level0 + 1].sample(u, v);
+
+        HostColor c;
+        c.x = c0.x + (c1.x - c0.x) * levelFactor;
+        c.y = c0.y + (c1.y - c0.y) * levelFactor;
+        c.z = c0.z + (c1.z - c0.z) * levelFactor;
+        c.w = c0.w + (c1.w - c0.w) * levelFactor;
+        return c;
+    }
+
+  private:
+    /**
+     * @struct Mipmap image level
+     */
+    struct Level
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<HostColor> data;
+
+        inline const HostColor& at(int x, int y) const { return data[std::size_t(y) * width + x]; }
+
+        /// bilinear interpolation with texel coordinates (texel centers at +0.5) and clamp
+        inline HostColor sampleTexel(float x, float y) const
+        {
+            const float xb = x - 0.5f;
+            const float yb = y - 0.5f;
+            const float xf = std::floor(xb);
+            const float yf = std::floor(yb);
+            const float ax = xb - xf;
+            const float ay = yb - yf;
+
+            const int x0 = std::min(std::max(int(xf), 0), width - 1);
+            const int y0 = std::min(std::max(int(yf), 0), height - 1);
+            const int x1 = std::min(std::max(int(xf) + 1, 0), width - 1);
+            const int y1 = std::min(std::max(int(yf) + 1, 0), height - 1);
+
+            const HostColor& c00 = at(x0, y0);
+            const HostColor& c10 = at(x1, y0);
+            const HostColor& c01 = at(x0, y1);
+            const HostColor& c11 = at(x1, y1);
+
+            const float w00 = (1.f - ax) * (1.f - ay);
+            const float w10 = ax * (1.f - ay);
+            const float w01 = (1.f - ax) * ay;
+            const float w11 = ax * ay;
+
+            HostColor c;
+            c.x = c00.x * w00 + c10.x * w10 + c01.x * w01 + c11.x * w11;
+            c.y = c00.y * w00 + c10.y * w10 + c01.y * w01 + c11.y * w11;
+            c.z = c00.z * w00 + c10.z * w10 + c01.z * w01 + c11.z * w11;
+            c.w = c00.w * w00 + c10.w * w10 + c01.w * w01 + c11.w * w11;
+            return c;
+        }
+
+        /// bilinear interpolation with normalized coordinates and clamp
+        inline HostColor sample(float u, float v) const { return sampleTexel(u * float(width), v * float(height)); }
+    };
+
+    std::vector<Level> _levels;      //< mipmap image levels, level 0 at min downscale
+    unsigned int _minDownscale = 0;  //< the min downscale factor (must be power of two), first downscale level
+    unsigned int _maxDownscale = 0;  //< the max downscale factor (must be power of two), last downscale level
+    std::size_t _width = 0;          //< original image width (no downscale)
+    std::size_t _height = 0;         //< original image height (no downscale)
+};
+
+/// Mipmap images in host memory, indexed by camera index
+using HostMipmapImages = std::map<int, std::unique_ptr<HostMipmapImage>>;
+
+}  // namespace depthMap
+}  // namespace aliceVision
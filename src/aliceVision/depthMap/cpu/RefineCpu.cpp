@@ -0,0 +1,180 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "RefineCpu.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/depthMap/cpu/HostCameraParams.hpp>
+#include <aliceVision/depthMap/cpu/hostPlaneSweeping.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+RefineCpu::RefineCpu(const mvsUtils::MultiViewParams& mp,
+                     const mvsUtils::TileParams& tileParams,
+                     const SgmParams& sgmParams,
+                     const RefineParams& refineParams,
+                     const HostMipmapImages& mipmapImages)
+  : _mp(mp),
+    _tileParams(tileParams),
+    _refineParams(refineParams),
+    _mipmapImages(mipmapImages)
+{
+    // get tile maximum dimensions
+    const int downscale = _refineParams.scale * _refineParams.stepXY;
+    const int maxTileWidth = divideRoundUp(tileParams.bufferWidth, downscale);
+    const int maxTileHeight = divideRoundUp(tileParams.bufferHeight, downscale);
+
+    // compute SGM depth/thickness map upscale ratio
+    // note: same ratio as the device implementation (tile buffer widths ratio)
+    const int sgmMaxTileWidth = divideRoundUp(tileParams.bufferWidth, sgmParams.scale * sgmParams.stepXY);
+    _sgmUpscaleRatio = float(sgmMaxTileWidth) / float(maxTileWidth);
+
+    // allocate depth/sim maps in host memory
+    _sgmDepthPixSizeMap.resize(maxTileWidth, maxTileHeight);
+    _refinedDepthSimMap.resize(maxTileWidth, maxTileHeight);
+    _optimizedDepthSimMap.resize(maxTileWidth, maxTileHeight);
+
+    // allocate refine volume in host memory
+    const int nbDepthsToRefine = _refineParams.halfNbDepths * 2 + 1;
+    _volumeRefineSim.resize(maxTileWidth, maxTileHeight, nbDepthsToRefine);
+}
+
+double RefineCpu::getMemoryConsumption() const
+{
+    size_t bytes = 0;
+
+    bytes += _sgmDepthPixSizeMap.getMemoryConsumption();
+    bytes += _refinedDepthSimMap.getMemoryConsumption();
+    bytes += _optimizedDepthSimMap.getMemoryConsumption();
+    bytes += _volumeRefineSim.getMemoryConsumption();
+
+    return (double(bytes) / (1024.0 * 1024.0));
+}
+
+void RefineCpu::refineRc(const Tile& tile, const HostFloat2Map& in_sgmDepthThicknessMap)
+{
+    const IndexT viewId = _mp.getViewId(tile.rc);
+
+    ALICEVISION_LOG_INFO(tile << "Refine depth/sim map (CPU) of view id: " << viewId << ", rc: " << tile.rc << " (" << (tile.rc + 1) << " / "
+                              << _mp.ncams << ").");
+
+    // downscale the region of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _refineParams.scale * _refineParams.stepXY);
+
+    // resize tile buffers to the downscaled region of interest
+    {
+        const int width = int(downscaledRoi.width());
+        const int height = int(downscaledRoi.height());
+
+        _sgmDepthPixSizeMap.resize(width, height);
+        _refinedDepthSimMap.resize(width, height);
+        _optimizedDepthSimMap.resize(width, height);
+        _volumeRefineSim.resize(width, height, _refineParams.halfNbDepths * 2 + 1);
+    }
+
+    // compute upscaled SGM depth/pixSize map
+    // - upscale SGM depth/thickness map
+    // - filter masked pixels (alpha)
+    // - compute pixSize from SGM thickness
+    cpu_computeSgmUpscaledDepthPixSizeMap(
+      _sgmDepthPixSizeMap, in_sgmDepthThicknessMap, *_mipmapImages.at(tile.rc), _refineParams, _sgmUpscaleRatio, downscaledRoi);
+
+    // refine and fuse depth/sim map
+    if (_refineParams.useRefineFuse)
+    {
+        // refine and fuse with volume strategy
+        refineAndFuseDepthSimMap(tile);
+    }
+    else
+    {
+        ALICEVISION_LOG_INFO(tile << "Refine and fuse depth/sim map volume disabled.");
+        cpu_depthSimMapCopyDepthOnly(_refinedDepthSimMap, _sgmDepthPixSizeMap, 1.0f);
+    }
+
+    // optimize depth/sim map
+    if (_refineParams.useColorOptimization && _refineParams.optimizationNbIterations > 0)
+    {
+        optimizeDepthSimMap(tile);
+    }
+    else
+    {
+        ALICEVISION_LOG_INFO(tile << "Color optimize depth/sim map disabled.");
+        _optimizedDepthSimMap = _refinedDepthSimMap;
+    }
+
+    ALICEVISION_LOG_INFO(tile << "Refine depth/sim map (CPU) done.");
+}
+
+void RefineCpu::refineAndFuseDepthSimMap(const Tile& tile)
+{
+    ALICEVISION_LOG_INFO(tile << "Refine and fuse depth/sim map volume.");
+
+    // downscale the region of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _refineParams.scale * _refineParams.stepXY);
+
+    // initialize the similarity volume at 0
+    // each tc filtered and inverted similarity value will be summed in this volume
+    _volumeRefineSim.fill(TSimRefineHost(0.f));
+
+    // get R camera parameters and mipmap image
+    HostCameraParams rcCameraParams;
+    fillHostCameraParams(rcCameraParams, tile.rc, _refineParams.scale, _mp);
+    const HostMipmapImage& rcMipmapImage = *_mipmapImages.at(tile.rc);
+
+    // compute for each RcTc each similarity value for each depth to refine
+    // sum the inverted / filtered similarity value, best value is the HIGHEST
+    for (std::size_t tci = 0; tci < tile.refineTCams.size(); ++tci)
+    {
+        const int tc = tile.refineTCams.at(tci);
+
+        // get T camera parameters and mipmap image
+        HostCameraParams tcCameraParams;
+        fillHostCameraParams(tcCameraParams, tc, _refineParams.scale, _mp);
+        const HostMipmapImage& tcMipmapImage = *_mipmapImages.at(tc);
+
+        ALICEVISION_LOG_DEBUG(tile << "Refine similarity volume:" << std::endl
+                                   << "\t- rc: " << tile.rc << std::endl
+                                   << "\t- tc: " << tc << " (" << (tci + 1) << "/" << tile.refineTCams.size() << ")" << std::endl
+                                   << "\t- tile range x: [" << downscaledRoi.x.begin << " - " << downscaledRoi.x.end << "]" << std::endl
+                                   << "\t- tile range y: [" << downscaledRoi.y.begin << " - " << downscaledRoi.y.end << "]" << std::endl);
+
+        cpu_volumeRefineSimilarity(
+          _volumeRefineSim, _sgmDepthPixSizeMap, rcCameraParams, tcCameraParams, rcMipmapImage, tcMipmapImage, _refineParams, downscaledRoi);
+    }
+
+    // retrieve the best depth/sim in the volume
+    // compute sub-pixel sample using a sliding gaussian
+    cpu_volumeRefineBestDepth(_refinedDepthSimMap, _sgmDepthPixSizeMap, _volumeRefineSim, _refineParams, downscaledRoi);
+
+    ALICEVISION_LOG_INFO(tile << "Refine and fuse depth/sim map volume done.");
+}
+
+void RefineCpu::optimizeDepthSimMap(const Tile& tile)
+{
+    ALICEVISION_LOG_INFO(tile << "Color optimize depth/sim map.");
+
+    // downscale the region of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _refineParams.scale * _refineParams.stepXY);
+
+    // get R camera parameters
+    HostCameraParams rcCameraParams;
+    fillHostCameraParams(rcCameraParams, tile.rc, _refineParams.scale, _mp);
+
+    cpu_depthSimMapOptimizeGradientDescent(_optimizedDepthSimMap,  // output depth/sim map optimized
+                                           _sgmDepthPixSizeMap,    // input SGM upscaled depth/pixSize map
+                                           _refinedDepthSimMap,    // input refined and fused depth/sim map
+                                           rcCameraParams,
+                                           *_mipmapImages.at(tile.rc),
+                                           _refineParams,
+                                           downscaledRoi);
+
+    ALICEVISION_LOG_INFO(tile << "Color optimize depth/sim map done.");
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
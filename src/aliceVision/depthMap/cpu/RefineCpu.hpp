@@ -0,0 +1,97 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/ROI.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/mvsUtils/TileParams.hpp>
+#include <aliceVision/depthMap/Tile.hpp>
+#include <aliceVision/depthMap/SgmParams.hpp>
+#include <aliceVision/depthMap/RefineParams.hpp>
+#include <aliceVision/depthMap/cpu/hostBuffer.hpp>
+#include <aliceVision/depthMap/cpu/HostMipmapImage.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @class Depth map estimation Refine on CPU
+ * @brief Manages the calculation of the Refine step in host memory.
+ * @note CPU counterpart of Refine, used when no CUDA device is available.
+ */
+class RefineCpu
+{
+  public:
+    /**
+     * @brief RefineCpu constructor.
+     * @param[in] mp the multi-view parameters
+     * @param[in] tileParams tile workflow parameters
+     * @param[in] sgmParams the Semi Global Matching parameters (input depth/thickness map downscale)
+     * @param[in] refineParams the Refine parameters
+     * @param[in] mipmapImages the cameras mipmap images in host memory
+     */
+    RefineCpu(const mvsUtils::MultiViewParams& mp,
+              const mvsUtils::TileParams& tileParams,
+              const SgmParams& sgmParams,
+              const RefineParams& refineParams,
+              const HostMipmapImages& mipmapImages);
+
+    // no default constructor
+    RefineCpu() = delete;
+
+    // default destructor
+    ~RefineCpu() = default;
+
+    // final depth/similarity map getter
+    inline const HostFloat2Map& getDepthSimMap() const { return _optimizedDepthSimMap; }
+
+    /**
+     * @brief Get memory consumption in host memory.
+     * @return host memory consumption (in MB)
+     */
+    double getMemoryConsumption() const;
+
+    /**
+     * @brief Refine for a single R camera the Semi-Global Matching depth/sim map.
+     * @param[in] tile The given tile for Refine computation
+     * @param[in] in_sgmDepthThicknessMap the SGM depth/thickness map
+     */
+    void refineRc(const Tile& tile, const HostFloat2Map& in_sgmDepthThicknessMap);
+
+  private:
+    // private methods
+
+    /**
+     * @brief Refine and fuse the given depth/sim map using volume strategy.
+     * @param[in] tile The given tile for Refine computation
+     */
+    void refineAndFuseDepthSimMap(const Tile& tile);
+
+    /**
+     * @brief Optimize the refined depth/sim maps.
+     * @param[in] tile The given tile for Refine computation
+     */
+    void optimizeDepthSimMap(const Tile& tile);
+
+    // private members
+
+    const mvsUtils::MultiViewParams& _mp;     //< Multi-view parameters
+    const mvsUtils::TileParams& _tileParams;  //< tile workflow parameters
+    const RefineParams& _refineParams;        //< Refine parameters
+    const HostMipmapImages& _mipmapImages;    //< cameras mipmap images
+    float _sgmUpscaleRatio;                   //< SGM depth/thickness map upscale ratio
+
+    // private members in host memory
+
+    HostFloat2Map _sgmDepthPixSizeMap;            //< rc upscaled SGM depth/pixSize map
+    HostFloat2Map _refinedDepthSimMap;            //< rc refined and fused depth/sim map
+    HostFloat2Map _optimizedDepthSimMap;          //< rc optimized depth/sim map
+    HostVolume<TSimRefineHost> _volumeRefineSim;  //< rc refine similarity volume
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
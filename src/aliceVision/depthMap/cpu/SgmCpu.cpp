@@ -0,0 +1,222 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "SgmCpu.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/depthMap/cpu/HostCameraParams.hpp>
+#include <aliceVision/depthMap/cpu/hostPlaneSweeping.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+SgmCpu::SgmCpu(const mvsUtils::MultiViewParams& mp,
+               const mvsUtils::TileParams& tileParams,
+               const SgmParams& sgmParams,
+               bool computeDepthSimMap,
+               const HostMipmapImages& mipmapImages)
+  : _mp(mp),
+    _tileParams(tileParams),
+    _sgmParams(sgmParams),
+    _computeDepthSimMap(computeDepthSimMap || sgmParams.exportIntermediateDepthSimMaps),
+    _mipmapImages(mipmapImages)
+{
+    // get tile maximum dimensions
+    const int downscale = _sgmParams.scale * _sgmParams.stepXY;
+    const int maxTileWidth = divideRoundUp(tileParams.bufferWidth, downscale);
+    const int maxTileHeight = divideRoundUp(tileParams.bufferHeight, downscale);
+
+    // allocate depth thickness map in host memory
+    _depthThicknessMap.resize(maxTileWidth, maxTileHeight);
+
+    // allocate depth/sim map in host memory
+    if (_computeDepthSimMap)
+        _depthSimMap.resize(maxTileWidth, maxTileHeight);
+
+    // allocate similarity volumes in host memory
+    // note: volumes are resized per tile, the allocated memory is kept
+    _volumeBestSim.resize(maxTileWidth, maxTileHeight, _sgmParams.maxDepths);
+    _volumeSecBestSim.resize(maxTileWidth, maxTileHeight, _sgmParams.maxDepths);
+}
+
+double SgmCpu::getMemoryConsumption() const
+{
+    size_t bytes = 0;
+
+    bytes += _depthThicknessMap.getMemoryConsumption();
+    bytes += _depthSimMap.getMemoryConsumption();
+    bytes += _volumeBestSim.getMemoryConsumption();
+    bytes += _volumeSecBestSim.getMemoryConsumption();
+
+    return (double(bytes) / (1024.0 * 1024.0));
+}
+
+void SgmCpu::sgmRc(const Tile& tile, const SgmDepthList& tileDepthList)
+{
+    const IndexT viewId = _mp.getViewId(tile.rc);
+
+    ALICEVISION_LOG_INFO(tile << "SGM depth/thickness map (CPU) of view id: " << viewId << ", rc: " << tile.rc << " (" << (tile.rc + 1) << " / "
+                              << _mp.ncams << ").");
+
+    // check SGM depth list and T cameras
+    if (tile.sgmTCams.empty() || tileDepthList.getDepths().empty())
+        ALICEVISION_THROW_ERROR(tile << "Cannot compute Semi-Global Matching, no depths or no T cameras (viewId: " << viewId << ").");
+
+    // resize tile buffers to the downscaled region of interest
+    {
+        const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+        const int width = int(downscaledRoi.width());
+        const int height = int(downscaledRoi.height());
+        const int nbDepths = int(tileDepthList.getDepths().size());
+
+        _depthThicknessMap.resize(width, height);
+
+        if (_computeDepthSimMap)
+            _depthSimMap.resize(width, height);
+
+        _volumeBestSim.resize(width, height, nbDepths);
+        _volumeSecBestSim.resize(width, height, nbDepths);
+    }
+
+    // compute best sim and second best sim volumes
+    computeSimilarityVolumes(tile, tileDepthList);
+
+    // this is here for experimental purposes
+    // to show how SGGC work on non optimized depthmaps
+    // it must equals to true in normal case
+    if (_sgmParams.doSgmOptimizeVolume)
+    {
+        optimizeSimilarityVolume(tile, tileDepthList);
+    }
+    else
+    {
+        // best sim volume is normally reuse to put optimized similarity
+        _volumeBestSim.copyFrom(_volumeSecBestSim);
+    }
+
+    // retrieve best depth
+    retrieveBestDepth(tile, tileDepthList);
+
+    ALICEVISION_LOG_INFO(tile << "SGM depth/thickness map (CPU) done.");
+}
+
+void SgmCpu::smoothThicknessMap(const Tile& tile, const RefineParams& refineParams)
+{
+    ALICEVISION_LOG_INFO(tile << "SGM Smooth thickness map.");
+
+    // downscale the region of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+
+    // in-place result thickness map smoothing with adjacent pixels
+    cpu_depthThicknessSmoothThickness(_depthThicknessMap, _sgmParams, refineParams, downscaledRoi);
+
+    ALICEVISION_LOG_INFO(tile << "SGM Smooth thickness map done.");
+}
+
+void SgmCpu::computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDepthList)
+{
+    ALICEVISION_LOG_INFO(tile << "SGM Compute similarity volume.");
+
+    // downscale the region of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+
+    // initialize the two similarity volumes at 255
+    _volumeBestSim.fill(TSimHost(255));
+    _volumeSecBestSim.fill(TSimHost(255));
+
+    // get R camera parameters and mipmap image
+    HostCameraParams rcCameraParams;
+    fillHostCameraParams(rcCameraParams, tile.rc, _sgmParams.scale, _mp);
+    const HostMipmapImage& rcMipmapImage = *_mipmapImages.at(tile.rc);
+
+    // compute similarity volume per Rc Tc
+    for (std::size_t tci = 0; tci < tile.sgmTCams.size(); ++tci)
+    {
+        const int tc = tile.sgmTCams.at(tci);
+
+        const int firstDepth = tileDepthList.getDepthsTcLimits()[tci].x;
+        const int lastDepth = firstDepth + tileDepthList.getDepthsTcLimits()[tci].y;
+
+        const Range tcDepthRange(firstDepth, lastDepth);
+
+        // get T camera parameters and mipmap image
+        HostCameraParams tcCameraParams;
+        fillHostCameraParams(tcCameraParams, tc, _sgmParams.scale, _mp);
+        const HostMipmapImage& tcMipmapImage = *_mipmapImages.at(tc);
+
+        ALICEVISION_LOG_DEBUG(tile << "Compute similarity volume:" << std::endl
+                                   << "\t- rc: " << tile.rc << std::endl
+                                   << "\t- tc: " << tc << " (" << (tci + 1) << "/" << tile.sgmTCams.size() << ")" << std::endl
+                                   << "\t- tc first depth: " << firstDepth << std::endl
+                                   << "\t- tc last depth: " << lastDepth << std::endl
+                                   << "\t- tile range x: [" << downscaledRoi.x.begin << " - " << downscaledRoi.x.end << "]" << std::endl
+                                   << "\t- tile range y: [" << downscaledRoi.y.begin << " - " << downscaledRoi.y.end << "]" << std::endl);
+
+        cpu_volumeComputeSimilarity(_volumeBestSim,
+                                    _volumeSecBestSim,
+                                    tileDepthList.getDepths(),
+                                    rcCameraParams,
+                                    tcCameraParams,
+                                    rcMipmapImage,
+                                    tcMipmapImage,
+                                    _sgmParams,
+                                    tcDepthRange,
+                                    downscaledRoi);
+    }
+
+    // update second best uninitialized similarity volume values with first best similarity volume values
+    if (_sgmParams.updateUninitializedSim)  // should always be true, false for debug purposes
+    {
+        ALICEVISION_LOG_DEBUG(tile << "SGM Update uninitialized similarity volume values from best similarity volume.");
+
+        cpu_volumeUpdateUninitializedSimilarity(_volumeBestSim, _volumeSecBestSim);
+    }
+
+    ALICEVISION_LOG_INFO(tile << "SGM Compute similarity volume done.");
+}
+
+void SgmCpu::optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDepthList)
+{
+    ALICEVISION_LOG_INFO(tile << "SGM Optimizing volume (filtering axes: " << _sgmParams.filteringAxes << ").");
+
+    // downscale the region of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+
+    cpu_volumeOptimize(_volumeBestSim,     // output volume (reuse best sim to put optimized similarity)
+                       _volumeSecBestSim,  // input volume
+                       *_mipmapImages.at(tile.rc),
+                       _sgmParams,
+                       tileDepthList.getDepths().size(),
+                       downscaledRoi);
+
+    ALICEVISION_LOG_INFO(tile << "SGM Optimizing volume done.");
+}
+
+void SgmCpu::retrieveBestDepth(const Tile& tile, const SgmDepthList& tileDepthList)
+{
+    ALICEVISION_LOG_INFO(tile << "SGM Retrieve best depth in volume.");
+
+    // downscale the region of interest
+    const ROI downscaledRoi = downscaleROI(tile.roi, _sgmParams.scale * _sgmParams.stepXY);
+
+    // get R camera parameters at scale 1
+    HostCameraParams rcCameraParams;
+    fillHostCameraParams(rcCameraParams, tile.rc, 1, _mp);
+
+    cpu_volumeRetrieveBestDepth(_depthThicknessMap,                                // output depth thickness map
+                                (_computeDepthSimMap) ? &_depthSimMap : nullptr,  // output depth/sim map (or nullptr)
+                                tileDepthList.getDepths(),                        // rc depth
+                                _volumeBestSim,                                   // second best sim volume optimized in best sim volume
+                                rcCameraParams,
+                                _sgmParams,
+                                downscaledRoi);
+
+    ALICEVISION_LOG_INFO(tile << "SGM Retrieve best depth in volume done.");
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
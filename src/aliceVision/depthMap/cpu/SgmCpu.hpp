@@ -0,0 +1,118 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/ROI.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/mvsUtils/TileParams.hpp>
+#include <aliceVision/depthMap/Tile.hpp>
+#include <aliceVision/depthMap/RefineParams.hpp>
+#include <aliceVision/depthMap/SgmParams.hpp>
+#include <aliceVision/depthMap/SgmDepthList.hpp>
+#include <aliceVision/depthMap/cpu/hostBuffer.hpp>
+#include <aliceVision/depthMap/cpu/HostMipmapImage.hpp>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @class Depth map estimation Semi-Global Matching on CPU
+ * @brief Manages the calculation of the Semi-Global Matching step in host memory.
+ * @note CPU counterpart of Sgm, used when no CUDA device is available.
+ */
+class SgmCpu
+{
+  public:
+    /**
+     * @brief SgmCpu constructor.
+     * @param[in] mp the multi-view parameters
+     * @param[in] tileParams tile workflow parameters
+     * @param[in] sgmParams the Semi Global Matching parameters
+     * @param[in] computeDepthSimMap Enable final depth/sim map computation
+     * @param[in] mipmapImages the cameras mipmap images in host memory
+     */
+    SgmCpu(const mvsUtils::MultiViewParams& mp,
+           const mvsUtils::TileParams& tileParams,
+           const SgmParams& sgmParams,
+           bool computeDepthSimMap,
+           const HostMipmapImages& mipmapImages);
+
+    // no default constructor
+    SgmCpu() = delete;
+
+    // default destructor
+    ~SgmCpu() = default;
+
+    // final depth/thickness map getter
+    inline const HostFloat2Map& getDepthThicknessMap() const { return _depthThicknessMap; }
+
+    // final depth/similarity map getter (optional: could be empty)
+    inline const HostFloat2Map& getDepthSimMap() const { return _depthSimMap; }
+
+    /**
+     * @brief Get memory consumption in host memory.
+     * @return host memory consumption (in MB)
+     */
+    double getMemoryConsumption() const;
+
+    /**
+     * @brief Compute for a single R camera the Semi-Global Matching.
+     * @param[in] tile The given tile for SGM computation
+     * @param[in] tileDepthList the tile SGM depth list
+     */
+    void sgmRc(const Tile& tile, const SgmDepthList& tileDepthList);
+
+    /**
+     * @brief Smooth SGM result thickness map
+     * @note Important to be a proper Refine input parameter.
+     * @param[in] tile The given tile for SGM computation
+     * @param[in] refineParams the Refine parameters
+     */
+    void smoothThicknessMap(const Tile& tile, const RefineParams& refineParams);
+
+  private:
+    // private methods
+
+    /**
+     * @brief Compute for each RcTc the best / second best similarity volumes.
+     * @param[in] tile The given tile for SGM computation
+     * @param[in] tileDepthList the tile SGM depth list
+     */
+    void computeSimilarityVolumes(const Tile& tile, const SgmDepthList& tileDepthList);
+
+    /**
+     * @brief Optimize the given similarity volume.
+     * @param[in] tile The given tile for SGM computation
+     * @param[in] tileDepthList the tile SGM depth list
+     */
+    void optimizeSimilarityVolume(const Tile& tile, const SgmDepthList& tileDepthList);
+
+    /**
+     * @brief Retrieve the best depths in the given similarity volume.
+     * @param[in] tile The given tile for SGM computation
+     * @param[in] tileDepthList the tile SGM depth list
+     */
+    void retrieveBestDepth(const Tile& tile, const SgmDepthList& tileDepthList);
+
+    // private members
+
+    const mvsUtils::MultiViewParams& _mp;     //< Multi-view parameters
+    const mvsUtils::TileParams& _tileParams;  //< tile workflow parameters
+    const SgmParams& _sgmParams;              //< Semi Global Matching parameters
+    const bool _computeDepthSimMap;           //< needs to compute a final depth/sim map
+    const HostMipmapImages& _mipmapImages;    //< cameras mipmap images
+
+    // private members in host memory
+
+    HostFloat2Map _depthThicknessMap;        //< rc result depth thickness map
+    HostFloat2Map _depthSimMap;              //< rc result depth/sim map
+    HostVolume<TSimHost> _volumeBestSim;     //< rc best similarity volume
+    HostVolume<TSimHost> _volumeSecBestSim;  //< rc second best similarity volume
+};
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,103 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/Image.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/**
+ * @struct Host two-channel map
+ * @brief Two-channel tile map in host memory (depth/sim, depth/thickness or depth/pixSize map).
+ * @note Host counterpart of CudaDeviceMemoryPitched<float2, 2>, stored as two planes.
+ */
+struct HostFloat2Map
+{
+    image::Image<float> x;  //< first channel (depth)
+    image::Image<float> y;  //< second channel (similarity, thickness or pixSize)
+
+    inline int width() const { return x.width(); }
+    inline int height() const { return x.height(); }
+
+    inline void resize(int width, int height)
+    {
+        x.resize(width, height, false);
+        y.resize(width, height, false);
+    }
+
+    inline void fill(float valueX, float valueY)
+    {
+        x.fill(valueX);
+        y.fill(valueY);
+    }
+
+    inline std::size_t getMemoryConsumption() const { return 2 * std::size_t(width()) * std::size_t(height()) * sizeof(float); }
+};
+
+/**
+ * @class Host volume
+ * @brief Tile volume in host memory.
+ * @note The depth axis is contiguous: the depth loops of the kernels are vectorized by the compiler.
+ */
+template<typename T>
+class HostVolume
+{
+  public:
+    inline int dimX() const { return _dimX; }
+    inline int dimY() const { return _dimY; }
+    inline int dimZ() const { return _dimZ; }
+
+    /**
+     * @brief Resize the volume, the allocated memory is kept for smaller sizes.
+     */
+    inline void resize(int dimX, int dimY, int dimZ)
+    {
+        _dimX = dimX;
+        _dimY = dimY;
+        _dimZ = dimZ;
+        _data.resize(std::size_t(dimX) * std::size_t(dimY) * std::size_t(dimZ));
+    }
+
+    inline void fill(T value) { std::fill(_data.begin(), _data.end(), value); }
+
+    /// depth column of the given voxel
+    inline T* column(int x, int y) { return _data.data() + (std::size_t(y) * _dimX + x) * _dimZ; }
+    inline const T* column(int x, int y) const { return _data.data() + (std::size_t(y) * _dimX + x) * _dimZ; }
+
+    inline T& operator()(int x, int y, int z) { return column(x, y)[z]; }
+    inline const T& operator()(int x, int y, int z) const { return column(x, y)[z]; }
+
+    inline std::size_t getMemoryConsumption() const { return _data.capacity() * sizeof(T); }
+
+    inline void copyFrom(const HostVolume<T>& other)
+    {
+        _dimX = other._dimX;
+        _dimY = other._dimY;
+        _dimZ = other._dimZ;
+        _data.assign(other._data.begin(), other._data.end());
+    }
+
+  private:
+    int _dimX = 0;
+    int _dimY = 0;
+    int _dimZ = 0;
+    std::vector<T> _data;
+};
+
+/// SGM similarity volume value type, (0, 254) similarity, 255 for uninitialized values
+using TSimHost = unsigned char;
+
+/// Refine similarity volume value type
+using TSimRefineHost = float;
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,206 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/Pixel.hpp>
+#include <aliceVision/depthMap/cpu/HostCameraParams.hpp>
+#include <aliceVision/depthMap/cpu/HostMipmapImage.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace aliceVision {
+namespace depthMap {
+
+/// R camera patch center minimum alpha, texture range (0, 255)
+constexpr float HOST_DEPTHMAP_RC_MIN_ALPHA = 255.f * 0.9f;
+
+/// T camera patch center minimum alpha, texture range (0, 255)
+constexpr float HOST_DEPTHMAP_TC_MIN_ALPHA = 255.f * 0.4f;
+
+/// Invalid similarity value
+constexpr float HOST_DEPTHMAP_INVALID_SIM = std::numeric_limits<float>::infinity();
+
+/**
+ * @struct Host patch
+ * @brief Oriented 3d patch, as the CUDA Patch.
+ */
+struct HostPatch
+{
+    Vec3f p;  //< 3d point
+    Vec3f n;  //< normal
+    Vec3f x;  //< x axis
+    Vec3f y;  //< y axis
+    float d;  //< pixel size
+};
+
+inline float sigmoid(float zeroVal, float endVal, float sigwidth, float sigMid, float xval)
+{
+    return zeroVal + (endVal - zeroVal) * (1.0f / (1.0f + std::exp(10.0f * ((xval - sigMid) / sigwidth))));
+}
+
+inline float sigmoid2(float zeroVal, float endVal, float sigwidth, float sigMid, float xval)
+{
+    return zeroVal + (endVal - zeroVal) * (1.0f / (1.0f + std::exp(10.0f * ((sigMid - xval) / sigwidth))));
+}
+
+/**
+ * @brief Compute the patch coordinate system, the patch is on the epipolar plane and faces both cameras.
+ */
+inline void computeRotCSEpip(HostPatch& patch, const HostCameraParams& rcCam, const HostCameraParams& tcCam)
+{
+    const Vec3f v1 = (rcCam.C - patch.p).normalized();
+    const Vec3f v2 = (tcCam.C - patch.p).normalized();
+
+    patch.y = v1.cross(v2).normalized();
+    patch.n = ((v1 + v2) / 2.0f).normalized();
+    patch.x = patch.y.cross(patch.n).normalized();
+}
+
+/**
+ * @brief Compute the patch of the given R camera pixel on the given fronto-parallel plane.
+ */
+inline void volume_computePatch(HostPatch& patch, const HostCameraParams& rcCam, const HostCameraParams& tcCam, float fpPlaneDepth, const Vec2f& pix)
+{
+    patch.p = get3DPointForPixelAndFrontoParallelPlaneRC(rcCam, pix, fpPlaneDepth);
+    patch.d = computePixSize(rcCam, patch.p);
+    computeRotCSEpip(patch, rcCam, tcCam);
+}
+
+/**
+ * @brief Compute the weighted Normalized Cross-Correlation of a patch, with adaptive support-weights (Yoon & Kweon).
+ * @note CPU port of compNCCby3DptsYK (Patch.cuh).
+ *       The patch pixels are projected incrementally in homogeneous coordinates
+ *       and the R and T support-weights are merged in a single exponential.
+ *
+ * @tparam TInvertAndFilter invert and filter output similarity value
+ * @return similarity value in range (-1, 0), (0, 1) if inverted and filtered, or HOST_DEPTHMAP_INVALID_SIM
+ */
+template<bool TInvertAndFilter>
+inline float compNCCby3DptsYK(const HostCameraParams& rcCam,
+                              const HostCameraParams& tcCam,
+                              const HostMipmapImage& rcImg,
+                              const HostMipmapImage& tcImg,
+                              const Pixel& rcLevelDim,
+                              const Pixel& tcLevelDim,
+                              float mipmapLevel,
+                              int wsh,
+                              float invGammaC,
+                              float invGammaP,
+                              bool useConsistentScale,
+                              const HostPatch& patch)
+{
+    // get R and T image 2d coordinates from patch center 3d point
+    const Vec2f rp = project3DPoint(rcCam, patch.p);
+    const Vec2f tp = project3DPoint(tcCam, patch.p);
+
+    // image 2d coordinates margin
+    const float dd = wsh + 2.0f;
+
+    // check R and T image 2d coordinates
+    if (!(rp.x() >= dd && rp.x() <= float(rcLevelDim.x - 1) - dd && tp.x() >= dd && tp.x() <= float(tcLevelDim.x - 1) - dd && rp.y() >= dd &&
+          rp.y() <= float(rcLevelDim.y - 1) - dd && tp.y() >= dd && tp.y() <= float(tcLevelDim.y - 1) - dd))
+    {
+        return HOST_DEPTHMAP_INVALID_SIM;  // uninitialized
+    }
+
+    const float rcInvLevelWidth = 1.f / float(rcLevelDim.x);
+    const float rcInvLevelHeight = 1.f / float(rcLevelDim.y);
+    const float tcInvLevelWidth = 1.f / float(tcLevelDim.x);
+    const float tcInvLevelHeight = 1.f / float(tcLevelDim.y);
+
+    float rcMipmapLevel = mipmapLevel;
+    float tcMipmapLevel = mipmapLevel;
+
+    // update R and T mipmap image level in order to get consistent scale patch comparison
+    if (useConsistentScale)
+        computeRcTcMipmapLevels(rcMipmapLevel, tcMipmapLevel, mipmapLevel, rcCam, tcCam, rp, tp, patch.p);
+
+    // compute patch center color (CIELAB) at R and T mipmap image level
+    const HostColor rcCenterColor = rcImg.sample((rp.x() + 0.5f) * rcInvLevelWidth, (rp.y() + 0.5f) * rcInvLevelHeight, rcMipmapLevel);
+    const HostColor tcCenterColor = tcImg.sample((tp.x() + 0.5f) * tcInvLevelWidth, (tp.y() + 0.5f) * tcInvLevelHeight, tcMipmapLevel);
+
+    // check the alpha values of the patch pixel center of the R and T cameras
+    if (rcCenterColor.w < HOST_DEPTHMAP_RC_MIN_ALPHA || tcCenterColor.w < HOST_DEPTHMAP_TC_MIN_ALPHA)
+        return HOST_DEPTHMAP_INVALID_SIM;  // masked
+
+    // homogeneous projections of the patch center and of the patch axes (one pixel size step)
+    const Eigen::Matrix3f rcP = rcCam.P.leftCols<3>();
+    const Eigen::Matrix3f tcP = tcCam.P.leftCols<3>();
+    const Vec3f rh0 = rcP * patch.p + rcCam.P.col(3);
+    const Vec3f th0 = tcP * patch.p + tcCam.P.col(3);
+    const Vec3f rhx = rcP * (patch.x * patch.d);
+    const Vec3f rhy = rcP * (patch.y * patch.d);
+    const Vec3f thx = tcP * (patch.x * patch.d);
+    const Vec3f thy = tcP * (patch.y * patch.d);
+
+    // weighted statistics
+    float wsum = 0.f;
+    float xsum = 0.f;
+    float ysum = 0.f;
+    float xxsum = 0.f;
+    float yysum = 0.f;
+    float xysum = 0.f;
+
+    // compute patch (wsh*2+1)x(wsh*2+1)
+    for (int yp = -wsh; yp <= wsh; ++yp)
+    {
+        const Vec3f rhRow = rh0 + rhy * float(yp);
+        const Vec3f thRow = th0 + thy * float(yp);
+
+        for (int xp = -wsh; xp <= wsh; ++xp)
+        {
+            // get R and T image 2d coordinates from 3d point
+            const Vec3f rh = rhRow + rhx * float(xp);
+            const Vec3f th = thRow + thx * float(xp);
+            const float rpx = rh.x() / rh.z();
+            const float rpy = rh.y() / rh.z();
+            const float tpx = th.x() / th.z();
+            const float tpy = th.y() / th.z();
+
+            // get R and T image color (CIELAB) from 2d coordinates
+            const HostColor rcColor = rcImg.sample((rpx + 0.5f) * rcInvLevelWidth, (rpy + 0.5f) * rcInvLevelHeight, rcMipmapLevel);
+            const HostColor tcColor = tcImg.sample((tpx + 0.5f) * tcInvLevelWidth, (tpy + 0.5f) * tcInvLevelHeight, tcMipmapLevel);
+
+            // support-weight based on the color difference to the patch center and the distance to the patch center
+            // R and T weights product, see CostYKfromLab
+            const float deltaC = labDistance(rcCenterColor, rcColor) + labDistance(tcCenterColor, tcColor);
+            const float deltaP = 2.f * std::sqrt(float(xp * xp + yp * yp));
+            const float w = std::exp(-(deltaC * invGammaC + deltaP * invGammaP));
+
+            // update statistics
+            const float gx = rcColor.x;
+            const float gy = tcColor.x;
+            wsum += w;
+            xsum += w * gx;
+            ysum += w * gy;
+            xxsum += w * gx * gx;
+            yysum += w * gy * gy;
+            xysum += w * gx * gy;
+        }
+    }
+
+    // compute weighted NCC
+    const float varianceX = (xxsum - xsum * xsum / wsum) / wsum;
+    const float varianceY = (yysum - ysum * ysum / wsum) / wsum;
+    const float varianceXY = (xysum - xsum * ysum / wsum) / wsum;
+    const float rawSim = varianceXY / std::sqrt(varianceX * varianceY);
+    const float sim = std::isfinite(rawSim) ? -rawSim : 1.0f;
+
+    if (TInvertAndFilter)
+    {
+        // invert and filter similarity
+        // best similarity value was -1, worst was 0
+        // best similarity value is 1, worst is still 0
+        return sigmoid(0.0f, 1.0f, 0.7f, -0.7f, sim);
+    }
+
+    return sim;
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,917 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "hostPlaneSweeping.hpp"
+
+#include <aliceVision/depthMap/cpu/hostPatch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace aliceVision {
+namespace depthMap {
+
+void cpu_volumeComputeSimilarity(HostVolume<TSimHost>& out_volBestSim,
+                                 HostVolume<TSimHost>& out_volSecBestSim,
+                                 const std::vector<float>& depths,
+                                 const HostCameraParams& rcCam,
+                                 const HostCameraParams& tcCam,
+                                 const HostMipmapImage& rcMipmapImage,
+                                 const HostMipmapImage& tcMipmapImage,
+                                 const SgmParams& sgmParams,
+                                 const Range& depthRange,
+                                 const ROI& roi)
+{
+    const float rcMipmapLevel = rcMipmapImage.getLevel(sgmParams.scale);
+    const Pixel rcLevelDim = rcMipmapImage.getDimensions(sgmParams.scale);
+    const Pixel tcLevelDim = tcMipmapImage.getDimensions(sgmParams.scale);
+
+    const float invGammaC = 1.f / float(sgmParams.gammaC);
+    const float invGammaP = 1.f / float(sgmParams.gammaP);
+
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int vy = 0; vy < roiHeight; ++vy)
+    {
+        // corresponding image coordinates
+        const float y = float(roi.y.begin + vy) * float(sgmParams.stepXY);
+
+        for (int vx = 0; vx < roiWidth; ++vx)
+        {
+            const float x = float(roi.x.begin + vx) * float(sgmParams.stepXY);
+
+            TSimHost* bestSimColumn = out_volBestSim.column(vx, vy);
+            TSimHost* secBestSimColumn = out_volSecBestSim.column(vx, vy);
+
+            for (int vz = int(depthRange.begin); vz < int(depthRange.end); ++vz)
+            {
+                // compute patch
+                HostPatch patch;
+                volume_computePatch(patch, rcCam, tcCam, depths[vz], Vec2f(x, y));
+
+                // compute patch similarity
+                float fsim = compNCCby3DptsYK<false>(rcCam,
+                                                     tcCam,
+                                                     rcMipmapImage,
+                                                     tcMipmapImage,
+                                                     rcLevelDim,
+                                                     tcLevelDim,
+                                                     rcMipmapLevel,
+                                                     sgmParams.wsh,
+                                                     invGammaC,
+                                                     invGammaP,
+                                                     sgmParams.useConsistentScale,
+                                                     patch);
+
+                if (fsim == HOST_DEPTHMAP_INVALID_SIM)
+                {
+                    fsim = 255.0f;  // 255 is the invalid similarity value
+                }
+                else
+                {
+                    // remap similarity value from (-1, 1) to (0, 254)
+                    // 255 is reserved for the similarity initialization, i.e. undefined values
+                    fsim = std::min(1.0f, std::max(0.0f, (fsim + 1.0f) * 0.5f)) * 254.0f;
+                }
+
+                TSimHost& fsim1st = bestSimColumn[vz];
+                TSimHost& fsim2nd = secBestSimColumn[vz];
+
+                if (fsim < fsim1st)
+                {
+                    fsim2nd = fsim1st;
+                    fsim1st = TSimHost(fsim);
+                }
+                else if (fsim < fsim2nd)
+                {
+                    fsim2nd = TSimHost(fsim);
+                }
+            }
+        }
+    }
+}
+
+void cpu_volumeUpdateUninitializedSimilarity(const HostVolume<TSimHost>& in_volBestSim, HostVolume<TSimHost>& inout_volSecBestSim)
+{
+    const int dimX = inout_volSecBestSim.dimX();
+    const int dimY = inout_volSecBestSim.dimY();
+    const int dimZ = inout_volSecBestSim.dimZ();
+
+#pragma omp parallel for
+    for (int vy = 0; vy < dimY; ++vy)
+    {
+        for (int vx = 0; vx < dimX; ++vx)
+        {
+            const TSimHost* bestSimColumn = in_volBestSim.column(vx, vy);
+            TSimHost* secBestSimColumn = inout_volSecBestSim.column(vx, vy);
+
+            for (int vz = 0; vz < dimZ; ++vz)
+            {
+                // invalid or uninitialized similarity value
+                if (secBestSimColumn[vz] == 255)
+                    secBestSimColumn[vz] = bestSimColumn[vz];
+            }
+        }
+    }
+}
+
+namespace {
+
+/**
+ * @brief Aggregate a single Semi-Global Matching path in the output volume.
+ * @note Same recurrence and same boundary handling as cuda_volumeAggregatePath.
+ *       The path costs are integers stored in float (at most 255 + 255), so the depth loop is vectorizable.
+ */
+void volumeAggregatePath(HostVolume<TSimHost>& out_volAgr,
+                         const HostVolume<TSimHost>& in_volSim,
+                         const HostMipmapImage& rcMipmapImage,
+                         const Pixel& rcLevelDim,
+                         float rcMipmapLevel,
+                         const std::array<int, 3>& axisT,
+                         const SgmParams& sgmParams,
+                         int volDimZ,
+                         int filteringIndex,
+                         bool invY,
+                         const ROI& roi)
+{
+    const std::array<int, 3> volDim = {in_volSim.dimX(), in_volSim.dimY(), volDimZ};
+
+    const int volDimX = volDim[axisT[0]];
+    const int volDimY = volDim[axisT[1]];
+
+    const int ySign = (invY ? -1 : 1);
+    const int step = sgmParams.stepXY;
+    const float P1 = float(sgmParams.p1);
+    const float P2Weighting = float(sgmParams.p2Weighting);
+
+    // find image offset
+    const int beginX = (axisT[0] == 0) ? int(roi.x.begin) : int(roi.y.begin);
+    const int beginY = (axisT[0] == 0) ? int(roi.y.begin) : int(roi.x.begin);
+
+    const float invLevelWidth = 1.f / float(rcLevelDim.x);
+    const float invLevelHeight = 1.f / float(rcLevelDim.y);
+
+    const float filteringWeight = float(filteringIndex);
+    const float invFilteringCount = 1.f / float(filteringIndex + 1);
+
+    // each path line (fixed x) is independent
+#pragma omp parallel for schedule(dynamic)
+    for (int x = 0; x < volDimX; ++x)
+    {
+        std::vector<float> sliceYm1(volDimZ);  // path costs at y - 1
+        std::vector<float> sliceY(volDimZ);    // path costs at y
+
+        // volume coordinates of the path line element y
+        const auto getVoxel = [&](int y) {
+            std::array<int, 3> v;
+            v[axisT[0]] = x;
+            v[axisT[1]] = y;
+            return v;
+        };
+
+        // first slice: copy similarity, output is initialized at 255
+        {
+            const std::array<int, 3> v = getVoxel(0);
+            const TSimHost* simColumn = in_volSim.column(v[0], v[1]);
+            TSimHost* outColumn = out_volAgr.column(v[0], v[1]);
+
+            for (int z = 0; z < volDimZ; ++z)
+            {
+                sliceYm1[z] = float(simColumn[z]);
+                outColumn[z] = TSimHost(255);
+            }
+        }
+
+        for (int iy = 1; iy < volDimY; ++iy)
+        {
+            const int y = invY ? volDimY - 1 - iy : iy;
+            const std::array<int, 3> v = getVoxel(y);
+
+            // best path cost of the previous slice
+            const float bestCostInColM1 = *std::min_element(sliceYm1.begin(), sliceYm1.end());
+
+            // penalty P2, depends on the color difference with the previous element of the path
+            float P2 = 0.f;
+
+            if (P2Weighting < 0.f)
+            {
+                // P2 convention: use negative value to skip the use of deltaC.
+                P2 = std::abs(P2Weighting);
+            }
+            else
+            {
+                const int imX0 = (beginX + v[0]) * step;  // current
+                const int imY0 = (beginY + v[1]) * step;
+
+                const int imX1 = imX0 - ySign * step * (axisT[1] == 0);  // M1
+                const int imY1 = imY0 - ySign * step * (axisT[1] == 1);
+
+                const HostColor gcr0 =
+                  rcMipmapImage.sample((float(imX0) + 0.5f) * invLevelWidth, (float(imY0) + 0.5f) * invLevelHeight, rcMipmapLevel);
+                const HostColor gcr1 =
+                  rcMipmapImage.sample((float(imX1) + 0.5f) * invLevelWidth, (float(imY1) + 0.5f) * invLevelHeight, rcMipmapLevel);
+                const float deltaC = labDistance(gcr0, gcr1);
+
+                P2 = sigmoid(80.f, 255.f, 80.f, P2Weighting, deltaC);
+            }
+
+            const TSimHost* simColumn = in_volSim.column(v[0], v[1]);
+            TSimHost* outColumn = out_volAgr.column(v[0], v[1]);
+
+            const float* pathCostM = sliceYm1.data();
+            float* pathCost = sliceY.data();
+            const float bestCostP2 = bestCostInColM1 + P2;
+
+            // first and last depths are not aggregated
+            pathCost[0] = 255.f;
+            pathCost[volDimZ - 1] = 255.f;
+
+            for (int z = 1; z < volDimZ - 1; ++z)
+            {
+                const float minCost = std::min(std::min(pathCostM[z], pathCostM[z - 1] + P1), std::min(pathCostM[z + 1] + P1, bestCostP2));
+                pathCost[z] = float(simColumn[z]) + minCost - bestCostInColM1;
+            }
+
+            for (int z = 0; z < volDimZ; ++z)
+            {
+                // clamp into the TSim range and aggregate into the final output
+                const float cost = std::min(255.0f, std::max(0.0f, pathCost[z]));
+                outColumn[z] = TSimHost((float(outColumn[z]) * filteringWeight + cost) * invFilteringCount);
+
+                // path costs are accumulated as integers
+                pathCost[z] = std::trunc(pathCost[z]);
+            }
+
+            std::swap(sliceYm1, sliceY);
+        }
+    }
+}
+
+}  // namespace
+
+void cpu_volumeOptimize(HostVolume<TSimHost>& out_volSimFiltered,
+                        const HostVolume<TSimHost>& in_volSim,
+                        const HostMipmapImage& rcMipmapImage,
+                        const SgmParams& sgmParams,
+                        int lastDepthIndex,
+                        const ROI& roi)
+{
+    const float rcMipmapLevel = rcMipmapImage.getLevel(sgmParams.scale);
+    const Pixel rcLevelDim = rcMipmapImage.getDimensions(sgmParams.scale);
+
+    // a path needs at least three depths
+    if (lastDepthIndex < 3)
+    {
+        out_volSimFiltered.copyFrom(in_volSim);
+        return;
+    }
+
+    int npaths = 0;
+    const auto updateAggrVolume = [&](const std::array<int, 3>& axisT, bool invX) {
+        volumeAggregatePath(
+          out_volSimFiltered, in_volSim, rcMipmapImage, rcLevelDim, rcMipmapLevel, axisT, sgmParams, lastDepthIndex, npaths, invX, roi);
+        npaths++;
+    };
+
+    for (char axis : sgmParams.filteringAxes)
+    {
+        const std::array<int, 3> axisT = (axis == 'X') ? std::array<int, 3>{1, 0, 2}   // XYZ -> YXZ
+                                                       : std::array<int, 3>{0, 1, 2};  // XYZ
+        updateAggrVolume(axisT, false);  // without transpose
+        updateAggrVolume(axisT, true);   // with transpose of the last axis
+    }
+}
+
+void cpu_volumeRetrieveBestDepth(HostFloat2Map& out_sgmDepthThicknessMap,
+                                 HostFloat2Map* out_sgmDepthSimMap,
+                                 const std::vector<float>& depths,
+                                 const HostVolume<TSimHost>& in_volSim,
+                                 const HostCameraParams& rcCam,
+                                 const SgmParams& sgmParams,
+                                 const ROI& roi)
+{
+    const int scaleStep = sgmParams.scale * sgmParams.stepXY;
+    const float thicknessMultFactor = 1.f + float(sgmParams.depthThicknessInflate);
+    const float maxSimilarity = float(sgmParams.maxSimilarity) * 254.f;  // convert from (0, 1) to (0, 254)
+    const int nbDepths = int(depths.size());
+
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+
+#pragma omp parallel for
+    for (int vy = 0; vy < roiHeight; ++vy)
+    {
+        for (int vx = 0; vx < roiWidth; ++vx)
+        {
+            // corresponding image coordinates
+            const Vec2f pix(float((roi.x.begin + vx) * scaleStep), float((roi.y.begin + vy) * scaleStep));
+
+            // find the best depth plane index for the current pixel
+            // - best possible similarity value is 0
+            // - worst possible similarity value is 254
+            // - invalid similarity value is 255
+            const TSimHost* simColumn = in_volSim.column(vx, vy);
+            float bestSim = 255.f;
+            int bestZIdx = -1;
+
+            for (int vz = 0; vz < nbDepths; ++vz)
+            {
+                if (simColumn[vz] < bestSim)
+                {
+                    bestSim = simColumn[vz];
+                    bestZIdx = vz;
+                }
+            }
+
+            // filtering out invalid values and values with a too bad score (above the user maximum similarity threshold)
+            if ((bestZIdx == -1) || (bestSim > maxSimilarity))
+            {
+                out_sgmDepthThicknessMap.x(vy, vx) = -1.f;  // invalid depth
+                out_sgmDepthThicknessMap.y(vy, vx) = -1.f;  // invalid thickness
+
+                if (out_sgmDepthSimMap != nullptr)
+                {
+                    out_sgmDepthSimMap->x(vy, vx) = -1.f;  // invalid depth
+                    out_sgmDepthSimMap->y(vy, vx) = 1.f;   // worst similarity value
+                }
+                continue;
+            }
+
+            // find best depth plane previous and next indexes
+            const int bestZIdx_m1 = std::max(0, bestZIdx - 1);
+            const int bestZIdx_p1 = std::min(nbDepths - 1, bestZIdx + 1);
+
+            const float bestDepth = depthPlaneToDepth(rcCam, depths[bestZIdx], pix);
+            const float bestDepth_m1 = depthPlaneToDepth(rcCam, depths[bestZIdx_m1], pix);
+            const float bestDepth_p1 = depthPlaneToDepth(rcCam, depths[bestZIdx_p1], pix);
+
+            // thickness is the maximum distance between output best depth and previous or next depth
+            const float bestDepthThickness = std::max(bestDepth_p1 - bestDepth, bestDepth - bestDepth_m1) * thicknessMultFactor;
+
+            out_sgmDepthThicknessMap.x(vy, vx) = bestDepth;
+            out_sgmDepthThicknessMap.y(vy, vx) = bestDepthThickness;
+
+            if (out_sgmDepthSimMap != nullptr)
+            {
+                out_sgmDepthSimMap->x(vy, vx) = bestDepth;
+                out_sgmDepthSimMap->y(vy, vx) = (bestSim / 255.0f) * 2.0f - 1.0f;  // convert from (0, 255) to (-1, +1)
+            }
+        }
+    }
+}
+
+void cpu_depthThicknessSmoothThickness(HostFloat2Map& inout_depthThicknessMap,
+                                       const SgmParams& sgmParams,
+                                       const RefineParams& refineParams,
+                                       const ROI& roi)
+{
+    const int sgmScaleStep = sgmParams.scale * sgmParams.stepXY;
+    const int refineScaleStep = refineParams.scale * refineParams.stepXY;
+
+    // min/max number of Refine samples in SGM thickness area
+    const float minNbRefineSamples = 2.f;
+    const float maxNbRefineSamples = std::max(sgmScaleStep / float(refineScaleStep), minNbRefineSamples);
+
+    // min/max SGM thickness inflate factor
+    const float minThicknessInflate = refineParams.halfNbDepths / maxNbRefineSamples;
+    const float maxThicknessInflate = refineParams.halfNbDepths / minNbRefineSamples;
+
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+
+    // note: only the thickness is updated and only the depths are read from neighbors, in-place is safe
+#pragma omp parallel for
+    for (int roiY = 0; roiY < roiHeight; ++roiY)
+    {
+        for (int roiX = 0; roiX < roiWidth; ++roiX)
+        {
+            const float depth = inout_depthThicknessMap.x(roiY, roiX);
+
+            // depth invalid or masked
+            if (depth <= 0.0f)
+                continue;
+
+            const float thickness = inout_depthThicknessMap.y(roiY, roiX);
+            const float minThickness = minThicknessInflate * thickness;
+            const float maxThickness = maxThicknessInflate * thickness;
+
+            // compute average depth distance to the center pixel
+            float sumCenterDepthDist = 0.f;
+            int nbValidPatchPixels = 0;
+
+            // patch 3x3
+            for (int yp = -1; yp <= 1; ++yp)
+            {
+                for (int xp = -1; xp <= 1; ++xp)
+                {
+                    const int roiXp = roiX + xp;
+                    const int roiYp = roiY + yp;
+
+                    if ((xp == 0 && yp == 0) || roiXp < 0 || roiXp >= roiWidth || roiYp < 0 || roiYp >= roiHeight)
+                        continue;
+
+                    const float depthPatch = inout_depthThicknessMap.x(roiYp, roiXp);
+
+                    if (depthPatch > 0.0f)
+                    {
+                        const float depthDistance = std::abs(depth - depthPatch);
+                        sumCenterDepthDist += std::max(minThickness, std::min(maxThickness, depthDistance));
+                        ++nbValidPatchPixels;
+                    }
+                }
+            }
+
+            // we require at least 3 valid patch pixels (over 8)
+            if (nbValidPatchPixels < 3)
+                continue;
+
+            inout_depthThicknessMap.y(roiY, roiX) = sumCenterDepthDist / nbValidPatchPixels;
+        }
+    }
+}
+
+void cpu_computeSgmUpscaledDepthPixSizeMap(HostFloat2Map& out_upscaledDepthPixSizeMap,
+                                           const HostFloat2Map& in_sgmDepthThicknessMap,
+                                           const HostMipmapImage& rcMipmapImage,
+                                           const RefineParams& refineParams,
+                                           float ratio,
+                                           const ROI& roi)
+{
+    const float rcMipmapLevel = rcMipmapImage.getLevel(refineParams.scale);
+    const Pixel rcLevelDim = rcMipmapImage.getDimensions(refineParams.scale);
+    const float invLevelWidth = 1.f / float(rcLevelDim.x);
+    const float invLevelHeight = 1.f / float(rcLevelDim.y);
+
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+
+    // input map bounds, the upscaled coordinates are clamped
+    const int inMaxX = in_sgmDepthThicknessMap.width() - 1;
+    const int inMaxY = in_sgmDepthThicknessMap.height() - 1;
+
+    const auto getDepthThickness = [&](int xp, int yp) {
+        xp = std::min(std::max(xp, 0), inMaxX);
+        yp = std::min(std::max(yp, 0), inMaxY);
+        return Vec2f(in_sgmDepthThicknessMap.x(yp, xp), in_sgmDepthThicknessMap.y(yp, xp));
+    };
+
+#pragma omp parallel for
+    for (int roiY = 0; roiY < roiHeight; ++roiY)
+    {
+        for (int roiX = 0; roiX < roiWidth; ++roiX)
+        {
+            // corresponding image coordinates
+            const float x = float((roi.x.begin + roiX) * refineParams.stepXY);
+            const float y = float((roi.y.begin + roiY) * refineParams.stepXY);
+
+            const float alpha = rcMipmapImage.sample((x + 0.5f) * invLevelWidth, (y + 0.5f) * invLevelHeight, rcMipmapLevel).w;
+
+            const float ox = (float(roiX) - 0.5f) * ratio;
+            const float oy = (float(roiY) - 0.5f) * ratio;
+
+            Vec2f depthThickness;
+
+            if (refineParams.interpolateMiddleDepth)
+            {
+                // filter masked pixels with alpha
+                if (alpha < HOST_DEPTHMAP_RC_MIN_ALPHA)
+                {
+                    out_upscaledDepthPixSizeMap.x(roiY, roiX) = -2.f;
+                    out_upscaledDepthPixSizeMap.y(roiY, roiX) = 0.f;
+                    continue;
+                }
+
+                // find adjacent pixels
+                const int xp = std::min(int(std::floor(ox)), int(roiWidth * ratio) - 2);
+                const int yp = std::min(int(std::floor(oy)), int(roiHeight * ratio) - 2);
+
+                const Vec2f lu = getDepthThickness(xp, yp);
+                const Vec2f ru = getDepthThickness(xp + 1, yp);
+                const Vec2f rd = getDepthThickness(xp + 1, yp + 1);
+                const Vec2f ld = getDepthThickness(xp, yp + 1);
+
+                if (lu.x() <= 0.0f || ru.x() <= 0.0f || rd.x() <= 0.0f || ld.x() <= 0.0f)
+                {
+                    // at least one corner depth is invalid
+                    // average the other corners to get a proper depth/thickness
+                    Vec2f sumDepthThickness(0.f, 0.f);
+                    int count = 0;
+
+                    for (const Vec2f* corner : {&lu, &ru, &rd, &ld})
+                    {
+                        if (corner->x() > 0.0f)
+                        {
+                            sumDepthThickness += *corner;
+                            ++count;
+                        }
+                    }
+
+                    if (count == 0)
+                    {
+                        // invalid depth
+                        out_upscaledDepthPixSizeMap.x(roiY, roiX) = -1.f;
+                        out_upscaledDepthPixSizeMap.y(roiY, roiX) = 1.f;
+                        continue;
+                    }
+
+                    depthThickness = sumDepthThickness / float(count);
+                }
+                else
+                {
+                    // bilinear interpolation
+                    const float ui = ox - float(xp);
+                    const float vi = oy - float(yp);
+                    const Vec2f u = lu + (ru - lu) * ui;
+                    const Vec2f d = ld + (rd - ld) * ui;
+                    depthThickness = u + (d - u) * vi;
+                }
+            }
+            else
+            {
+                // filter masked pixels (alpha < 0.9f)
+                if (alpha < 0.9f)
+                {
+                    out_upscaledDepthPixSizeMap.x(roiY, roiX) = -2.f;
+                    out_upscaledDepthPixSizeMap.y(roiY, roiX) = 0.f;
+                    continue;
+                }
+
+                // nearest neighbor, no interpolation
+                const int xp = std::min(int(std::floor(ox + 0.5f)), int(roiWidth * ratio) - 1);
+                const int yp = std::min(int(std::floor(oy + 0.5f)), int(roiHeight * ratio) - 1);
+
+                depthThickness = getDepthThickness(xp, yp);
+            }
+
+            // write output depth/pixSize, pixSize from depth thickness
+            out_upscaledDepthPixSizeMap.x(roiY, roiX) = depthThickness.x();
+            out_upscaledDepthPixSizeMap.y(roiY, roiX) = depthThickness.y() / refineParams.halfNbDepths;
+        }
+    }
+}
+
+void cpu_volumeRefineSimilarity(HostVolume<TSimRefineHost>& inout_volSim,
+                                const HostFloat2Map& in_sgmDepthPixSizeMap,
+                                const HostCameraParams& rcCam,
+                                const HostCameraParams& tcCam,
+                                const HostMipmapImage& rcMipmapImage,
+                                const HostMipmapImage& tcMipmapImage,
+                                const RefineParams& refineParams,
+                                const ROI& roi)
+{
+    const float rcMipmapLevel = rcMipmapImage.getLevel(refineParams.scale);
+    const Pixel rcLevelDim = rcMipmapImage.getDimensions(refineParams.scale);
+    const Pixel tcLevelDim = tcMipmapImage.getDimensions(refineParams.scale);
+
+    const float invGammaC = 1.f / float(refineParams.gammaC);
+    const float invGammaP = 1.f / float(refineParams.gammaP);
+
+    const int volDimZ = inout_volSim.dimZ();
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int vy = 0; vy < roiHeight; ++vy)
+    {
+        const float y = float(roi.y.begin + vy) * float(refineParams.stepXY);
+
+        for (int vx = 0; vx < roiWidth; ++vx)
+        {
+            const float x = float(roi.x.begin + vx) * float(refineParams.stepXY);
+
+            // corresponding input sgm depth/pixSize (middle depth)
+            const float sgmDepth = in_sgmDepthPixSizeMap.x(vy, vx);
+            const float sgmPixSize = in_sgmDepthPixSizeMap.y(vy, vx);
+
+            // sgm depth (middle depth) invalid or masked
+            if (sgmDepth <= 0.0f)
+                continue;
+
+            // rc 3d point at sgm depth (middle depth)
+            const Vec3f p0 = get3DPointForPixelAndDepthFromRC(rcCam, Vec2f(x, y), sgmDepth);
+
+            TSimRefineHost* simColumn = inout_volSim.column(vx, vy);
+
+            for (int vz = 0; vz < volDimZ; ++vz)
+            {
+                HostPatch patch;
+                patch.p = p0;
+
+                // move rc 3d point by relative depth index offset * sgm pixSize
+                const int relativeDepthIndexOffset = vz - ((volDimZ - 1) / 2);
+
+                if (relativeDepthIndexOffset != 0)
+                    move3DPointByRcPixSize(patch.p, rcCam, relativeDepthIndexOffset * sgmPixSize);
+
+                patch.d = computePixSize(rcCam, patch.p);
+                computeRotCSEpip(patch, rcCam, tcCam);
+
+                // we need positive and filtered similarity values
+                const float fsimInvertedFiltered = compNCCby3DptsYK<true>(rcCam,
+                                                                          tcCam,
+                                                                          rcMipmapImage,
+                                                                          tcMipmapImage,
+                                                                          rcLevelDim,
+                                                                          tcLevelDim,
+                                                                          rcMipmapLevel,
+                                                                          refineParams.wsh,
+                                                                          invGammaC,
+                                                                          invGammaP,
+                                                                          refineParams.useConsistentScale,
+                                                                          patch);
+
+                // invalid similarity
+                if (fsimInvertedFiltered == HOST_DEPTHMAP_INVALID_SIM)
+                    continue;
+
+                simColumn[vz] += TSimRefineHost(fsimInvertedFiltered);
+            }
+        }
+    }
+}
+
+void cpu_volumeRefineBestDepth(HostFloat2Map& out_refineDepthSimMap,
+                               const HostFloat2Map& in_sgmDepthPixSizeMap,
+                               const HostVolume<TSimRefineHost>& in_volSim,
+                               const RefineParams& refineParams,
+                               const ROI& roi)
+{
+    const int volDimZ = in_volSim.dimZ();
+    const int samplesPerPixSize = refineParams.nbSubsamples;
+    const int halfNbSamples = refineParams.nbSubsamples * refineParams.halfNbDepths;
+    const int halfNbDepths = refineParams.halfNbDepths;
+    const int nbSamples = 2 * halfNbSamples + 1;
+    const float twoTimesSigmaPowerTwo = float(2.0 * refineParams.sigma * refineParams.sigma);
+
+    // sliding gaussian window weights, for each sample and each depth
+    std::vector<float> gaussianWeights(std::size_t(nbSamples) * volDimZ);
+
+    for (int s = 0; s < nbSamples; ++s)
+    {
+        const int sample = s - halfNbSamples;
+
+        for (int vz = 0; vz < volDimZ; ++vz)
+        {
+            const int zs = (vz - halfNbDepths) * samplesPerPixSize;  // relative sample offset
+            gaussianWeights[std::size_t(s) * volDimZ + vz] = std::exp(-float((zs - sample) * (zs - sample)) / twoTimesSigmaPowerTwo);
+        }
+    }
+
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+
+#pragma omp parallel for schedule(dynamic)
+    for (int vy = 0; vy < roiHeight; ++vy)
+    {
+        for (int vx = 0; vx < roiWidth; ++vx)
+        {
+            const float sgmDepth = in_sgmDepthPixSizeMap.x(vy, vx);
+            const float sgmPixSize = in_sgmDepthPixSizeMap.y(vy, vx);
+
+            // sgm depth (middle depth) invalid or masked
+            if (sgmDepth <= 0.0f)
+            {
+                out_refineDepthSimMap.x(vy, vx) = sgmDepth;  // -1 (invalid) or -2 (masked)
+                out_refineDepthSimMap.y(vy, vx) = 1.0f;      // similarity between (-1, +1)
+                continue;
+            }
+
+            const TSimRefineHost* simColumn = in_volSim.column(vx, vy);
+
+            // find best z sample per pixel
+            float bestSampleSim = 0.f;      // all sample sim <= 0.f
+            int bestSampleOffsetIndex = 0;  // default is middle depth (SGM)
+
+            for (int s = 0; s < nbSamples; ++s)
+            {
+                const float* weights = gaussianWeights.data() + std::size_t(s) * volDimZ;
+                float sampleSim = 0.f;
+
+                // inverted similarity sum, best value is the HIGHEST
+                for (int vz = 0; vz < volDimZ; ++vz)
+                    sampleSim -= simColumn[vz] * weights[vz];
+
+                if (sampleSim < bestSampleSim)
+                {
+                    bestSampleOffsetIndex = s - halfNbSamples;
+                    bestSampleSim = sampleSim;
+                }
+            }
+
+            // best depth: input sgm depth (middle depth) + sample size offset from z center
+            const float sampleSize = sgmPixSize / samplesPerPixSize;
+
+            out_refineDepthSimMap.x(vy, vx) = sgmDepth + bestSampleOffsetIndex * sampleSize;
+            out_refineDepthSimMap.y(vy, vx) = bestSampleSim;
+        }
+    }
+}
+
+void cpu_depthSimMapCopyDepthOnly(HostFloat2Map& out_depthSimMap, const HostFloat2Map& in_depthSimMap, float defaultSim)
+{
+    out_depthSimMap.x = in_depthSimMap.x;
+    out_depthSimMap.y.resize(in_depthSimMap.width(), in_depthSimMap.height(), true, defaultSim);
+}
+
+namespace {
+
+/**
+ * @brief Compute the smoothing step and the energy of the given cell, as getCellSmoothStepEnergy.
+ * @return (smoothStep, energy)
+ */
+Vec2f getCellSmoothStepEnergy(const HostCameraParams& rcCam, const image::Image<float>& depthMap, int cellX, int cellY, const Vec2f& offsetRoi)
+{
+    Vec2f out(0.0f, 180.0f);
+
+    const float d0 = depthMap(cellY, cellX);
+
+    // early exit: depth is <= 0
+    if (d0 <= 0.0f)
+        return out;
+
+    // clamp neighbor coordinates to the map
+    const auto getDepth = [&](int x, int y) {
+        return depthMap(std::min(std::max(y, 0), depthMap.height() - 1), std::min(std::max(x, 0), depthMap.width() - 1));
+    };
+
+    // consider the neighbor pixels
+    const float dL = getDepth(cellX, cellY - 1);  // Left
+    const float dR = getDepth(cellX, cellY + 1);  // Right
+    const float dU = getDepth(cellX - 1, cellY);  // Up
+    const float dB = getDepth(cellX + 1, cellY);  // Bottom
+
+    const Vec2f cell0(static_cast<float>(cellX), static_cast<float>(cellY));
+
+    const Vec3f p0 = get3DPointForPixelAndDepthFromRC(rcCam, cell0 + offsetRoi, d0);
+    const Vec3f pL = get3DPointForPixelAndDepthFromRC(rcCam, cell0 + Vec2f(0.f, -1.f) + offsetRoi, dL);
+    const Vec3f pR = get3DPointForPixelAndDepthFromRC(rcCam, cell0 + Vec2f(0.f, 1.f) + offsetRoi, dR);
+    const Vec3f pU = get3DPointForPixelAndDepthFromRC(rcCam, cell0 + Vec2f(-1.f, 0.f) + offsetRoi, dU);
+    const Vec3f pB = get3DPointForPixelAndDepthFromRC(rcCam, cell0 + Vec2f(1.f, 0.f) + offsetRoi, dB);
+
+    // compute the average point based on neighbors (cg)
+    Vec3f cg(0.0f, 0.0f, 0.0f);
+    float n = 0.0f;
+
+    if (dL > 0.0f) { cg += pL; n++; }
+    if (dR > 0.0f) { cg += pR; n++; }
+    if (dU > 0.0f) { cg += pU; n++; }
+    if (dB > 0.0f) { cg += pB; n++; }
+
+    if (n > 1.0f)
+    {
+        cg /= n;  // average of x, y, depth
+
+        const Vec3f vcn = (rcCam.C - p0).normalized();
+
+        // pS: projection of cg on the line from p0 to camera
+        const Vec3f pS = closestPointToLine3D(cg, p0, vcn);
+
+        // keep the depth difference between pS and p0 as the smoothing step
+        out.x() = (rcCam.C - pS).norm() - d0;
+    }
+
+    float e = 0.0f;
+    n = 0.0f;
+
+    if (dL > 0.0f && dR > 0.0f)
+    {
+        // large angle between neighbors == flat area => low energy
+        // small angle between neighbors == non-flat area => high energy
+        e = std::max(e, (180.0f - angleBetwABandAC(p0, pL, pR)));
+        n++;
+    }
+
+    if (dU > 0.0f && dB > 0.0f)
+    {
+        e = std::max(e, (180.0f - angleBetwABandAC(p0, pU, pB)));
+        n++;
+    }
+
+    // the higher the energy, the less flat the area
+    if (n > 0.0f)
+        out.y() = e;
+
+    return out;
+}
+
+}  // namespace
+
+void cpu_depthSimMapOptimizeGradientDescent(HostFloat2Map& out_optimizeDepthSimMap,
+                                            const HostFloat2Map& in_sgmDepthPixSizeMap,
+                                            const HostFloat2Map& in_refineDepthSimMap,
+                                            const HostCameraParams& rcCam,
+                                            const HostMipmapImage& rcMipmapImage,
+                                            const RefineParams& refineParams,
+                                            const ROI& roi)
+{
+    const float rcMipmapLevel = rcMipmapImage.getLevel(refineParams.scale);
+    const Pixel rcLevelDim = rcMipmapImage.getDimensions(refineParams.scale);
+    const float invLevelWidth = 1.f / float(rcLevelDim.x);
+    const float invLevelHeight = 1.f / float(rcLevelDim.y);
+
+    const int roiWidth = int(roi.width());
+    const int roiHeight = int(roi.height());
+    const Vec2f offsetRoi(float(roi.x.begin), float(roi.y.begin));
+
+    // initialize depth/sim map optimized with SGM depth/pixSize map
+    out_optimizeDepthSimMap.x = in_sgmDepthPixSizeMap.x;
+    out_optimizeDepthSimMap.y = in_sgmDepthPixSizeMap.y;
+
+    // compute image gradient size of L
+    image::Image<float> imgVariance(roiWidth, roiHeight);
+
+#pragma omp parallel for
+    for (int roiY = 0; roiY < roiHeight; ++roiY)
+    {
+        for (int roiX = 0; roiX < roiWidth; ++roiX)
+        {
+            const float x = float(roi.x.begin + roiX) * float(refineParams.stepXY);
+            const float y = float(roi.y.begin + roiY) * float(refineParams.stepXY);
+
+            const float xM1 = rcMipmapImage.sample(((x - 1.f) + 0.5f) * invLevelWidth, (y + 0.5f) * invLevelHeight, rcMipmapLevel).x;
+            const float xP1 = rcMipmapImage.sample(((x + 1.f) + 0.5f) * invLevelWidth, (y + 0.5f) * invLevelHeight, rcMipmapLevel).x;
+            const float yM1 = rcMipmapImage.sample((x + 0.5f) * invLevelWidth, ((y - 1.f) + 0.5f) * invLevelHeight, rcMipmapLevel).x;
+            const float yP1 = rcMipmapImage.sample((x + 0.5f) * invLevelWidth, ((y + 1.f) + 0.5f) * invLevelHeight, rcMipmapLevel).x;
+
+            imgVariance(roiY, roiX) = Vec2f(xM1 - xP1, yM1 - yP1).norm();
+        }
+    }
+
+    image::Image<float> tmpOptDepthMap;
+
+    for (int iter = 0; iter < refineParams.optimizationNbIterations; ++iter)  // default nb iterations is 100
+    {
+        // copy depths values from the optimized depth/sim map
+        tmpOptDepthMap = out_optimizeDepthSimMap.x;
+
+#pragma omp parallel for schedule(dynamic)
+        for (int roiY = 0; roiY < roiHeight; ++roiY)
+        {
+            for (int roiX = 0; roiX < roiWidth; ++roiX)
+            {
+                // SGM upscale (rough) depth/pixSize
+                const float sgmDepth = in_sgmDepthPixSizeMap.x(roiY, roiX);
+                const float sgmPixSize = in_sgmDepthPixSizeMap.y(roiY, roiX);
+
+                // refined and fused (fine) depth/sim
+                const float refineDepth = in_refineDepthSimMap.x(roiY, roiX);
+                const float refineSim = in_refineDepthSimMap.y(roiY, roiX);
+
+                // output optimized depth/sim
+                float& out_optDepth = out_optimizeDepthSimMap.x(roiY, roiX);
+                float& out_optSim = out_optimizeDepthSimMap.y(roiY, roiX);
+
+                if (iter == 0)
+                {
+                    out_optDepth = sgmDepth;
+                    out_optSim = refineSim;
+                }
+
+                const float depthOpt = out_optDepth;
+
+                if (depthOpt <= 0.0f)
+                    continue;
+
+                const Vec2f depthSmoothStepEnergy = getCellSmoothStepEnergy(rcCam, tmpOptDepthMap, roiX, roiY, offsetRoi);  // (smoothStep, energy)
+
+                float stepToSmoothDepth = depthSmoothStepEnergy.x();
+                stepToSmoothDepth = std::copysign(std::min(std::abs(stepToSmoothDepth), sgmPixSize / 10.0f), stepToSmoothDepth);
+
+                const float depthEnergy = depthSmoothStepEnergy.y();  // max angle with neighbors
+
+                float stepToFineDM = refineDepth - depthOpt;  // distance to refined/noisy input depth map
+                stepToFineDM = std::copysign(std::min(std::abs(stepToFineDM), sgmPixSize / 10.0f), stepToFineDM);
+
+                const float stepToRoughDM = sgmDepth - depthOpt;  // distance to smooth/robust input depth map
+
+                const float imgColorVariance = imgVariance(roiY, roiX);
+                const float colorVarianceThresholdForSmoothing = 20.0f;
+                const float angleThresholdForSmoothing = 30.0f;
+
+                const float weightedColorVariance =
+                  sigmoid2(5.0f, angleThresholdForSmoothing, 40.0f, colorVarianceThresholdForSmoothing, imgColorVariance);
+                const float fineSimWeight = sigmoid(0.0f, 1.0f, 0.7f, -0.7f, refineSim);
+                const float energyLowerThanVarianceWeight = sigmoid(0.0f, 1.0f, 30.0f, weightedColorVariance, depthEnergy);
+                const float closeToRoughWeight = 1.0f - sigmoid(0.0f, 1.0f, 10.0f, 17.0f, std::abs(stepToRoughDM / sgmPixSize));
+
+                const float depthOptStep =
+                  closeToRoughWeight * stepToRoughDM +
+                  (1.0f - closeToRoughWeight) *
+                    (energyLowerThanVarianceWeight * fineSimWeight * stepToFineDM + (1.0f - energyLowerThanVarianceWeight) * stepToSmoothDepth);
+
+                out_optDepth = depthOpt + depthOptStep;
+                out_optSim = (1.0f - closeToRoughWeight) * (energyLowerThanVarianceWeight * fineSimWeight * refineSim +
+                                                            (1.0f - energyLowerThanVarianceWeight) * (depthEnergy / 20.0f));
+            }
+        }
+    }
+}
+
+}  // namespace depthMap
+}  // namespace aliceVision
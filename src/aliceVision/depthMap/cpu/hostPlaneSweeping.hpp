@@ -0,0 +1,184 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/ROI.hpp>
+#include <aliceVision/depthMap/SgmParams.hpp>
+#include <aliceVision/depthMap/RefineParams.hpp>
+#include <aliceVision/depthMap/cpu/hostBuffer.hpp>
+#include <aliceVision/depthMap/cpu/HostCameraParams.hpp>
+#include <aliceVision/depthMap/cpu/HostMipmapImage.hpp>
+
+#include <vector>
+
+namespace aliceVision {
+namespace depthMap {
+
+/*
+ * CPU counterparts of the CUDA plane sweeping functions (deviceSimilarityVolume.hpp / deviceDepthSimilarityMap.hpp).
+ * Buffers are sized to the given downscaled ROI, volumes store the depth axis contiguously.
+ * Each function is parallelized over the ROI rows (or lines) with OpenMP dynamic scheduling,
+ * nested calls inside an active parallel region run on the calling thread.
+ */
+
+/**
+ * @brief Compute the best / second best similarity volumes for a given R camera and T camera.
+ * @param[in,out] out_volBestSim the best similarity volume
+ * @param[in,out] out_volSecBestSim the second best similarity volume
+ * @param[in] depths the R camera depth list
+ * @param[in] rcCam the R camera parameters at SGM scale
+ * @param[in] tcCam the T camera parameters at SGM scale
+ * @param[in] rcMipmapImage the R camera mipmap image
+ * @param[in] tcMipmapImage the T camera mipmap image
+ * @param[in] sgmParams the Semi Global Matching parameters
+ * @param[in] depthRange the volume depth range to compute
+ * @param[in] roi the 2d region of interest
+ */
+void cpu_volumeComputeSimilarity(HostVolume<TSimHost>& out_volBestSim,
+                                 HostVolume<TSimHost>& out_volSecBestSim,
+                                 const std::vector<float>& depths,
+                                 const HostCameraParams& rcCam,
+                                 const HostCameraParams& tcCam,
+                                 const HostMipmapImage& rcMipmapImage,
+                                 const HostMipmapImage& tcMipmapImage,
+                                 const SgmParams& sgmParams,
+                                 const Range& depthRange,
+                                 const ROI& roi);
+
+/**
+ * @brief Update second best uninitialized similarity volume values with first best similarity volume values.
+ * @param[in] in_volBestSim the best similarity volume
+ * @param[in,out] inout_volSecBestSim the second best similarity volume
+ */
+void cpu_volumeUpdateUninitializedSimilarity(const HostVolume<TSimHost>& in_volBestSim, HostVolume<TSimHost>& inout_volSecBestSim);
+
+/**
+ * @brief Filter / Optimize the given similarity volume (Semi-Global Matching paths aggregation).
+ * @note Each path line is independent: lines are distributed across threads, the depth loop is contiguous.
+ * @param[out] out_volSimFiltered the output similarity volume
+ * @param[in] in_volSim the input similarity volume
+ * @param[in] rcMipmapImage the R camera mipmap image
+ * @param[in] sgmParams the Semi Global Matching parameters
+ * @param[in] lastDepthIndex the R camera number of depths
+ * @param[in] roi the 2d region of interest
+ */
+void cpu_volumeOptimize(HostVolume<TSimHost>& out_volSimFiltered,
+                        const HostVolume<TSimHost>& in_volSim,
+                        const HostMipmapImage& rcMipmapImage,
+                        const SgmParams& sgmParams,
+                        int lastDepthIndex,
+                        const ROI& roi);
+
+/**
+ * @brief Retrieve the best depth/thickness (and depth/sim) in the given similarity volume.
+ * @param[out] out_sgmDepthThicknessMap the output depth/thickness map
+ * @param[out] out_sgmDepthSimMap the output depth/sim map (or nullptr)
+ * @param[in] depths the R camera depth list
+ * @param[in] in_volSim the input similarity volume
+ * @param[in] rcCam the R camera parameters at scale 1
+ * @param[in] sgmParams the Semi Global Matching parameters
+ * @param[in] roi the 2d region of interest
+ */
+void cpu_volumeRetrieveBestDepth(HostFloat2Map& out_sgmDepthThicknessMap,
+                                 HostFloat2Map* out_sgmDepthSimMap,
+                                 const std::vector<float>& depths,
+                                 const HostVolume<TSimHost>& in_volSim,
+                                 const HostCameraParams& rcCam,
+                                 const SgmParams& sgmParams,
+                                 const ROI& roi);
+
+/**
+ * @brief Smooth the thickness of the given depth/thickness map (in-place, depth unchanged).
+ * @param[in,out] inout_depthThicknessMap the depth/thickness map
+ * @param[in] sgmParams the Semi Global Matching parameters
+ * @param[in] refineParams the Refine parameters
+ * @param[in] roi the 2d region of interest
+ */
+void cpu_depthThicknessSmoothThickness(HostFloat2Map& inout_depthThicknessMap,
+                                       const SgmParams& sgmParams,
+                                       const RefineParams& refineParams,
+                                       const ROI& roi);
+
+/**
+ * @brief Upscale the given SGM depth/thickness map, filter masked pixels and compute pixSize from thickness.
+ * @param[out] out_upscaledDepthPixSizeMap the output upscaled depth/pixSize map
+ * @param[in] in_sgmDepthThicknessMap the input SGM depth/thickness map
+ * @param[in] rcMipmapImage the R camera mipmap image
+ * @param[in] refineParams the Refine parameters
+ * @param[in] ratio the upscale ratio (SGM tile buffer width / Refine tile buffer width)
+ * @param[in] roi the 2d region of interest at Refine scale
+ */
+void cpu_computeSgmUpscaledDepthPixSizeMap(HostFloat2Map& out_upscaledDepthPixSizeMap,
+                                           const HostFloat2Map& in_sgmDepthThicknessMap,
+                                           const HostMipmapImage& rcMipmapImage,
+                                           const RefineParams& refineParams,
+                                           float ratio,
+                                           const ROI& roi);
+
+/**
+ * @brief Refine the best similarity volume for a given R camera and T camera.
+ * @note Filtered and inverted similarity values are summed in the volume.
+ * @param[in,out] inout_volSim the similarity volume
+ * @param[in] in_sgmDepthPixSizeMap the SGM upscaled depth/pixSize map (middle depth)
+ * @param[in] rcCam the R camera parameters at Refine scale
+ * @param[in] tcCam the T camera parameters at Refine scale
+ * @param[in] rcMipmapImage the R camera mipmap image
+ * @param[in] tcMipmapImage the T camera mipmap image
+ * @param[in] refineParams the Refine parameters
+ * @param[in] roi the 2d region of interest
+ */
+void cpu_volumeRefineSimilarity(HostVolume<TSimRefineHost>& inout_volSim,
+                                const HostFloat2Map& in_sgmDepthPixSizeMap,
+                                const HostCameraParams& rcCam,
+                                const HostCameraParams& tcCam,
+                                const HostMipmapImage& rcMipmapImage,
+                                const HostMipmapImage& tcMipmapImage,
+                                const RefineParams& refineParams,
+                                const ROI& roi);
+
+/**
+ * @brief Retrieve the best depth/sim in the given refined similarity volume (sliding gaussian).
+ * @param[out] out_refineDepthSimMap the output refined and fused depth/sim map
+ * @param[in] in_sgmDepthPixSizeMap the SGM upscaled depth/pixSize map (middle depth)
+ * @param[in] in_volSim the refined similarity volume
+ * @param[in] refineParams the Refine parameters
+ * @param[in] roi the 2d region of interest
+ */
+void cpu_volumeRefineBestDepth(HostFloat2Map& out_refineDepthSimMap,
+                               const HostFloat2Map& in_sgmDepthPixSizeMap,
+                               const HostVolume<TSimRefineHost>& in_volSim,
+                               const RefineParams& refineParams,
+                               const ROI& roi);
+
+/**
+ * @brief Copy the depth of the given depth/sim map and set the similarity to the given default value.
+ * @param[out] out_depthSimMap the output depth/sim map
+ * @param[in] in_depthSimMap the input depth/sim map
+ * @param[in] defaultSim the default similarity value
+ */
+void cpu_depthSimMapCopyDepthOnly(HostFloat2Map& out_depthSimMap, const HostFloat2Map& in_depthSimMap, float defaultSim);
+
+/**
+ * @brief Optimize the refined depth/sim map with the SGM depth/pixSize map and the R camera image gradient.
+ * @param[out] out_optimizeDepthSimMap the output optimized depth/sim map
+ * @param[in] in_sgmDepthPixSizeMap the SGM upscaled depth/pixSize map
+ * @param[in] in_refineDepthSimMap the refined and fused depth/sim map
+ * @param[in] rcCam the R camera parameters at Refine scale
+ * @param[in] rcMipmapImage the R camera mipmap image
+ * @param[in] refineParams the Refine parameters
+ * @param[in] roi the 2d region of interest
+ */
+void cpu_depthSimMapOptimizeGradientDescent(HostFloat2Map& out_optimizeDepthSimMap,
+                                            const HostFloat2Map& in_sgmDepthPixSizeMap,
+                                            const HostFloat2Map& in_refineDepthSimMap,
+                                            const HostCameraParams& rcCam,
+                                            const HostMipmapImage& rcMipmapImage,
+                                            const RefineParams& refineParams,
+                                            const ROI& roi);
+
+}  // namespace depthMap
+}  // namespace aliceVision
@@ -0,0 +1,341 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/depthMap/cpu/hostPlaneSweeping.hpp>
+#include <aliceVision/depthMap/cpu/hostPatch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#define BOOST_TEST_MODULE depthMapHostPlaneSweeping
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::depthMap;
+
+namespace {
+
+// Synthetic scene: two cameras with identity rotation and a horizontal baseline,
+// looking at a textured fronto-parallel plane.
+constexpr int imageWidth = 160;
+constexpr int imageHeight = 120;
+constexpr float focal = 200.f;
+constexpr float baseline = 0.4f;
+constexpr float textureCellSize = 0.08f;
+
+/// Value noise in range (0, 1) on a grid of the plane, with bilinear interpolation
+float planeTexture(float x, float y)
+{
+    const auto hash = [](int i, int j) {
+        std::uint32_t h = std::uint32_t(i) * 73856093u ^ std::uint32_t(j) * 19349663u;
+        h ^= h >> 13;
+        h *= 0x5bd1e995u;
+        h ^= h >> 15;
+        return float(h & 0xffffu) / float(0xffffu);
+    };
+
+    const float u = x / textureCellSize;
+    const float v = y / textureCellSize;
+    const int i = int(std::floor(u));
+    const int j = int(std::floor(v));
+    const float a = u - float(i);
+    const float b = v - float(j);
+
+    return (1.f - a) * (1.f - b) * hash(i, j) + a * (1.f - b) * hash(i + 1, j) + (1.f - a) * b * hash(i, j + 1) + a * b * hash(i + 1, j + 1);
+}
+
+/// Camera parameters of a camera at the given center with an identity rotation, at the given downscale
+HostCameraParams getCameraParams(const Vec3f& center, int downscale)
+{
+    Eigen::Matrix3f K = Eigen::Matrix3f::Identity();
+    K(0, 0) = focal / float(downscale);
+    K(1, 1) = focal / float(downscale);
+    K(0, 2) = float(imageWidth) * 0.5f / float(downscale);
+    K(1, 2) = float(imageHeight) * 0.5f / float(downscale);
+
+    HostCameraParams cam;
+    cam.P.leftCols<3>() = K;
+    cam.P.col(3) = -K * center;
+    cam.iP = K.inverse();
+    cam.C = center;
+    cam.XVect = Vec3f(1.f, 0.f, 0.f);
+    cam.YVect = Vec3f(0.f, 1.f, 0.f);
+    cam.ZVect = Vec3f(0.f, 0.f, 1.f);
+    return cam;
+}
+
+/// Render the full-size image of the plane at the given depth seen by the camera at the given center
+void renderPlane(image::Image<image::RGBAfColor>& img, const Vec3f& center, float planeDepth)
+{
+    const HostCameraParams cam = getCameraParams(center, 1);
+    img.resize(imageWidth, imageHeight);
+
+    for (int y = 0; y < imageHeight; ++y)
+    {
+        for (int x = 0; x < imageWidth; ++x)
+        {
+            const Vec3f ray = pixelRay(cam, Vec2f(float(x), float(y)));
+            const Vec3f p = cam.C + ray * ((planeDepth - cam.C.z()) / ray.z());
+            const float value = 0.1f + 0.8f * planeTexture(p.x(), p.y());
+            img(y, x) = image::RGBAfColor(value, value, value, 1.f);
+        }
+    }
+}
+
+/// Ground truth depth (distance to the camera center) of the given pixel of a camera with an identity rotation
+float groundTruthDepth(const HostCameraParams& cam, const Vec2f& pix, float planeDepth)
+{
+    const Vec3f ray = pixelRay(cam, pix);
+    return (planeDepth - cam.C.z()) / ray.z();
+}
+
+/// Median of the given values
+float median(std::vector<float> values)
+{
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+/**
+ * @brief Synthetic scene fixture: R and T mipmap images of a textured plane,
+ *        and the SGM depth list in fronto-parallel plane depths (regular in disparity).
+ */
+struct PlaneScene
+{
+    PlaneScene(float planeDepth, int sgmScale)
+      : planeDepth(planeDepth),
+        rcCenter(0.f, 0.f, 0.f),
+        tcCenter(baseline, 0.f, 0.f)
+    {
+        image::Image<image::RGBAfColor> rcImage;
+        image::Image<image::RGBAfColor> tcImage;
+        renderPlane(rcImage, rcCenter, planeDepth);
+        renderPlane(tcImage, tcCenter, planeDepth);
+        rcMipmapImage.fill(rcImage, 1, 4);
+        tcMipmapImage.fill(tcImage, 1, 4);
+
+        // disparity at SGM scale from 4 to 12 pixels, by step of 0.5 pixel
+        const float sgmFocal = focal / float(sgmScale);
+        for (float disparity = 12.f; disparity >= 4.f; disparity -= 0.5f)
+            depths.push_back(sgmFocal * baseline / disparity);
+    }
+
+    float planeDepth;
+    Vec3f rcCenter;
+    Vec3f tcCenter;
+    HostMipmapImage rcMipmapImage;
+    HostMipmapImage tcMipmapImage;
+    std::vector<float> depths;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(depthMap_cpu_sgm_plane)
+{
+    SgmParams sgmParams;
+    sgmParams.scale = 2;
+    sgmParams.stepXY = 2;
+
+    // the plane is exactly at a depth of the SGM depth list (disparity of 8 pixels at SGM scale)
+    const float planeDepth = (focal / float(sgmParams.scale)) * baseline / 8.f;
+    const PlaneScene scene(planeDepth, sgmParams.scale);
+    const int nbDepths = int(scene.depths.size());
+    const int planeDepthIndex = int(std::find(scene.depths.begin(), scene.depths.end(), planeDepth) - scene.depths.begin());
+    BOOST_REQUIRE_LT(planeDepthIndex, nbDepths);
+
+    const ROI roi(0, imageWidth / (sgmParams.scale * sgmParams.stepXY), 0, imageHeight / (sgmParams.scale * sgmParams.stepXY));
+    const int width = int(roi.width());
+    const int height = int(roi.height());
+
+    const HostCameraParams rcCam = getCameraParams(scene.rcCenter, sgmParams.scale);
+    const HostCameraParams tcCam = getCameraParams(scene.tcCenter, sgmParams.scale);
+
+    // similarity volume
+    HostVolume<TSimHost> volBestSim;
+    HostVolume<TSimHost> volSecBestSim;
+    volBestSim.resize(width, height, nbDepths);
+    volSecBestSim.resize(width, height, nbDepths);
+    volBestSim.fill(TSimHost(255));
+    volSecBestSim.fill(TSimHost(255));
+
+    cpu_volumeComputeSimilarity(volBestSim,
+                                volSecBestSim,
+                                scene.depths,
+                                rcCam,
+                                tcCam,
+                                scene.rcMipmapImage,
+                                scene.tcMipmapImage,
+                                sgmParams,
+                                Range(0, nbDepths),
+                                roi);
+
+    // the best similarity of the valid pixels is at the plane depth, with a high correlation
+    int nbValidPixels = 0;
+    int nbPlaneDepthPixels = 0;
+    int nbHighSimilarityPixels = 0;
+
+    for (int vy = 0; vy < height; ++vy)
+    {
+        for (int vx = 0; vx < width; ++vx)
+        {
+            const TSimHost* simColumn = volBestSim.column(vx, vy);
+            if (simColumn[planeDepthIndex] == 255)
+                continue;  // out of the T camera image
+
+            ++nbValidPixels;
+            if (std::min_element(simColumn, simColumn + nbDepths) - simColumn == planeDepthIndex)
+                ++nbPlaneDepthPixels;
+            // similarity (0, 254) from NCC (-1, 1), NCC < -0.8 at the plane depth
+            if (simColumn[planeDepthIndex] < 0.1f * 254.f)
+                ++nbHighSimilarityPixels;
+        }
+    }
+
+    BOOST_CHECK_GT(nbValidPixels, width * height / 2);
+    BOOST_CHECK_GT(nbPlaneDepthPixels, 0.95 * nbValidPixels);
+    BOOST_CHECK_GT(nbHighSimilarityPixels, 0.95 * nbValidPixels);
+
+    // SGM optimization and best depth retrieval
+    cpu_volumeUpdateUninitializedSimilarity(volBestSim, volSecBestSim);
+
+    HostVolume<TSimHost> volSimFiltered;
+    volSimFiltered.resize(width, height, nbDepths);
+    cpu_volumeOptimize(volSimFiltered, volSecBestSim, scene.rcMipmapImage, sgmParams, nbDepths, roi);
+
+    HostFloat2Map depthThicknessMap;
+    depthThicknessMap.resize(width, height);
+    const HostCameraParams rcCamScale1 = getCameraParams(scene.rcCenter, 1);
+    cpu_volumeRetrieveBestDepth(depthThicknessMap, nullptr, scene.depths, volSimFiltered, rcCamScale1, sgmParams, roi);
+
+    int nbValidDepths = 0;
+    int nbExactDepths = 0;
+
+    for (int vy = 0; vy < height; ++vy)
+    {
+        for (int vx = 0; vx < width; ++vx)
+        {
+            const float depth = depthThicknessMap.x(vy, vx);
+            if (depth <= 0.f)
+                continue;
+
+            ++nbValidDepths;
+            const Vec2f pix(float(vx * sgmParams.scale * sgmParams.stepXY), float(vy * sgmParams.scale * sgmParams.stepXY));
+            const float gtDepth = groundTruthDepth(rcCamScale1, pix, planeDepth);
+            if (std::abs(depth - gtDepth) < 1e-3f * gtDepth)
+                ++nbExactDepths;
+
+            BOOST_CHECK_GT(depthThicknessMap.y(vy, vx), 0.f);
+        }
+    }
+
+    BOOST_CHECK_GE(nbValidDepths, nbValidPixels);
+    BOOST_CHECK_GT(nbExactDepths, 0.95 * nbValidPixels);
+}
+
+BOOST_AUTO_TEST_CASE(depthMap_cpu_refine_plane)
+{
+    SgmParams sgmParams;
+    sgmParams.scale = 2;
+    sgmParams.stepXY = 2;
+
+    RefineParams refineParams;
+    refineParams.scale = 1;
+    refineParams.stepXY = 1;
+
+    // the plane is between two depths of the SGM depth list
+    const float planeDepth = 5.15f;
+    const PlaneScene scene(planeDepth, sgmParams.scale);
+
+    // SGM depth/thickness map: the closest depth of the depth list
+    const ROI sgmRoi(0, imageWidth / (sgmParams.scale * sgmParams.stepXY), 0, imageHeight / (sgmParams.scale * sgmParams.stepXY));
+    const HostCameraParams rcCamScale1 = getCameraParams(scene.rcCenter, 1);
+
+    const int closestIndex = int(std::min_element(scene.depths.begin(),
+                                                  scene.depths.end(),
+                                                  [&](float a, float b) { return std::abs(a - planeDepth) < std::abs(b - planeDepth); }) -
+                                 scene.depths.begin());
+    BOOST_REQUIRE(closestIndex > 0 && closestIndex + 1 < int(scene.depths.size()));
+
+    HostFloat2Map sgmDepthThicknessMap;
+    sgmDepthThicknessMap.resize(int(sgmRoi.width()), int(sgmRoi.height()));
+
+    for (int vy = 0; vy < sgmDepthThicknessMap.height(); ++vy)
+    {
+        for (int vx = 0; vx < sgmDepthThicknessMap.width(); ++vx)
+        {
+            const Vec2f pix(float(vx * sgmParams.scale * sgmParams.stepXY), float(vy * sgmParams.scale * sgmParams.stepXY));
+            const float depth = depthPlaneToDepth(rcCamScale1, scene.depths[closestIndex], pix);
+            const float depthM1 = depthPlaneToDepth(rcCamScale1, scene.depths[closestIndex - 1], pix);
+            const float depthP1 = depthPlaneToDepth(rcCamScale1, scene.depths[closestIndex + 1], pix);
+            sgmDepthThicknessMap.x(vy, vx) = depth;
+            sgmDepthThicknessMap.y(vy, vx) = std::max(std::abs(depthP1 - depth), std::abs(depth - depthM1));
+        }
+    }
+
+    // upscaled SGM depth/pixSize map
+    const ROI roi(0, imageWidth / (refineParams.scale * refineParams.stepXY), 0, imageHeight / (refineParams.scale * refineParams.stepXY));
+    const int width = int(roi.width());
+    const int height = int(roi.height());
+    const float ratio = float(sgmDepthThicknessMap.width()) / float(width);
+
+    HostFloat2Map sgmDepthPixSizeMap;
+    sgmDepthPixSizeMap.resize(width, height);
+    cpu_computeSgmUpscaledDepthPixSizeMap(sgmDepthPixSizeMap, sgmDepthThicknessMap, scene.rcMipmapImage, refineParams, ratio, roi);
+
+    // refine similarity volume and best depth
+    const HostCameraParams rcCam = getCameraParams(scene.rcCenter, refineParams.scale);
+    const HostCameraParams tcCam = getCameraParams(scene.tcCenter, refineParams.scale);
+
+    HostVolume<TSimRefineHost> volRefineSim;
+    volRefineSim.resize(width, height, refineParams.halfNbDepths * 2 + 1);
+    volRefineSim.fill(TSimRefineHost(0.f));
+
+    cpu_volumeRefineSimilarity(
+      volRefineSim, sgmDepthPixSizeMap, rcCam, tcCam, scene.rcMipmapImage, scene.tcMipmapImage, refineParams, roi);
+
+    HostFloat2Map refinedDepthSimMap;
+    refinedDepthSimMap.resize(width, height);
+    cpu_volumeRefineBestDepth(refinedDepthSimMap, sgmDepthPixSizeMap, volRefineSim, refineParams, roi);
+
+    // compare the SGM and refined depth errors on the pixels seen by the T camera
+    const int margin = refineParams.wsh + 3;
+    std::vector<float> sgmErrors;
+    std::vector<float> refinedErrors;
+    std::vector<float> refinedSims;
+
+    for (int y = margin; y < height - margin; ++y)
+    {
+        for (int x = margin; x < width - margin; ++x)
+        {
+            const Vec2f pix(static_cast<float>(x), static_cast<float>(y));
+            const Vec2f tp = project3DPoint(tcCam, get3DPointForPixelAndDepthFromRC(rcCam, pix, groundTruthDepth(rcCam, pix, planeDepth)));
+            if (tp.x() < float(margin) || tp.x() > float(width - margin))
+                continue;
+
+            const float gtDepth = groundTruthDepth(rcCam, pix, planeDepth);
+            sgmErrors.push_back(std::abs(sgmDepthPixSizeMap.x(y, x) - gtDepth));
+            refinedErrors.push_back(std::abs(refinedDepthSimMap.x(y, x) - gtDepth));
+            refinedSims.push_back(refinedDepthSimMap.y(y, x));
+        }
+    }
+
+    BOOST_REQUIRE_GT(refinedErrors.size(), std::size_t(width * height / 2));
+
+    const float sgmMedianError = median(sgmErrors);
+    const float refinedMedianError = median(refinedErrors);
+
+    BOOST_TEST_MESSAGE("SGM median depth error: " << sgmMedianError << ", refined median depth error: " << refinedMedianError);
+
+    // the refined depth is a fraction of the SGM pixSize from the plane (SGM depth error is about 0.15)
+    BOOST_CHECK_GT(sgmMedianError, 0.1f);
+    BOOST_CHECK_LT(refinedMedianError, 0.02f);
+
+    // refined similarity is the opposite of the sliding gaussian sum of inverted similarities (best is the lowest)
+    BOOST_CHECK_LT(median(refinedSims), 0.f);
+}
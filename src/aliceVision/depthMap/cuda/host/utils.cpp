@@ -18,11 +18,12 @@ int listCudaDevices()
     int nbDevices = 0;  // number of CUDA GPUs
 
     // determine the number of CUDA capable GPUs
+    // note: no device / no driver is not fatal, the caller may fallback on CPU
     cudaError_t err = cudaGetDeviceCount(&nbDevices);
-    CHECK_CUDA_ERROR();
     if (err != cudaSuccess)
     {
-        ALICEVISION_LOG_ERROR("Cannot get CUDA device count.");
+        cudaGetLastError();  // reset the last error
+        ALICEVISION_LOG_ERROR("Cannot get CUDA device count: " << cudaGetErrorString(err));
         return 0;
     }
 
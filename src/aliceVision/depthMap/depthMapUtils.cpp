@@ -239,14 +239,26 @@ void writeDepthSimMap(int rc,
     writeFloat2Map(rc, mp, tileParams, roi, in_depthSimMap_dmp, fileTypeX, fileTypeY, scale, step, name);
 }
 
-void writeDepthSimMapFromTileList(int rc,
-                                  const mvsUtils::MultiViewParams& mp,
-                                  const mvsUtils::TileParams& tileParams,
-                                  const std::vector<ROI>& tileRoiList,
-                                  const std::vector<CudaHostMemoryHeap<float2, 2>>& in_depthSimMapTiles_hmh,
-                                  int scale,
-                                  int step,
-                                  const std::string& name)
+void copyFloat2Map(image::Image<float>& out_mapX, image::Image<float>& out_mapY, const HostFloat2Map& in_map, const ROI& roi, int downscale)
+{
+    const ROI downscaledROI = downscaleROI(roi, downscale);
+    const int width = int(downscaledROI.width());
+    const int height = int(downscaledROI.height());
+
+    // copy the region of interest block from the host map to output images
+    out_mapX = in_map.x.block(0, 0, height, width);
+    out_mapY = in_map.y.block(0, 0, height, width);
+}
+
+template<typename TileMap>
+void writeDepthSimMapFromTileListImpl(int rc,
+                                      const mvsUtils::MultiViewParams& mp,
+                                      const mvsUtils::TileParams& tileParams,
+                                      const std::vector<ROI>& tileRoiList,
+                                      const std::vector<TileMap>& in_depthSimMapTiles,
+                                      int scale,
+                                      int step,
+                                      const std::string& name)
 {
     ALICEVISION_LOG_TRACE("Merge and write depth/similarity map tiles (rc: " << rc << ", view id: " << mp.getViewId(rc) << ").");
 
@@ -272,7 +284,7 @@ void writeDepthSimMapFromTileList(int rc,
         image::Image<float> tileSimMap;
 
         // copy tile depth/sim map from host memory
-        copyFloat2Map(tileDepthMap, tileSimMap, in_depthSimMapTiles_hmh.at(i), roi, scaleStep);
+        copyFloat2Map(tileDepthMap, tileSimMap, in_depthSimMapTiles.at(i), roi, scaleStep);
 
         // add tile maps to the full-size maps with weighting
         mvsUtils::addTileMapWeighted(rc, mp, tileParams, roi, scaleStep, tileDepthMap, depthMap);
@@ -284,6 +296,30 @@ void writeDepthSimMapFromTileList(int rc,
     mvsUtils::writeMap(rc, mp, mvsUtils::EFileType::simMap, simMap, scale, step, customSuffix);      // write the merged similarity map
 }
 
+void writeDepthSimMapFromTileList(int rc,
+                                  const mvsUtils::MultiViewParams& mp,
+                                  const mvsUtils::TileParams& tileParams,
+                                  const std::vector<ROI>& tileRoiList,
+                                  const std::vector<CudaHostMemoryHeap<float2, 2>>& in_depthSimMapTiles_hmh,
+                                  int scale,
+                                  int step,
+                                  const std::string& name)
+{
+    writeDepthSimMapFromTileListImpl(rc, mp, tileParams, tileRoiList, in_depthSimMapTiles_hmh, scale, step, name);
+}
+
+void writeDepthSimMapFromTileList(int rc,
+                                  const mvsUtils::MultiViewParams& mp,
+                                  const mvsUtils::TileParams& tileParams,
+                                  const std::vector<ROI>& tileRoiList,
+                                  const std::vector<HostFloat2Map>& in_depthSimMapTiles,
+                                  int scale,
+                                  int step,
+                                  const std::string& name)
+{
+    writeDepthSimMapFromTileListImpl(rc, mp, tileParams, tileRoiList, in_depthSimMapTiles, scale, step, name);
+}
+
 void resetDepthSimMap(CudaHostMemoryHeap<float2, 2>& inout_depthSimMap_hmh, float depth, float sim)
 {
     const CudaSize<2>& depthSimMapSize = inout_depthSimMap_hmh.getSize();
@@ -12,6 +12,7 @@
 #include <aliceVision/mvsUtils/TileParams.hpp>
 #include <aliceVision/depthMap/Tile.hpp>
 #include <aliceVision/depthMap/cuda/host/memory.hpp>
+#include <aliceVision/depthMap/cpu/hostBuffer.hpp>
 
 #include <vector>
 #include <string>
@@ -147,6 +148,26 @@ void writeDepthSimMapFromTileList(int rc,
                                   int step,
                                   const std::string& name = "");
 
+/**
+ * @brief Write a depth/similarity map on disk from a tile list computed on CPU.
+ * @param[in] rc the related R camera index
+ * @param[in] mp the multi-view parameters
+ * @param[in] tileParams tile workflow parameters
+ * @param[in] tileRoiList the 2d region of interest of each tile
+ * @param[in] in_depthSimMapTiles the depth/similarity map tile list in host memory
+ * @param[in] scale the depth/similarity map downscale factor
+ * @param[in] step the depth/similarity map step factor
+ * @param[in] name the export filename suffix
+ */
+void writeDepthSimMapFromTileList(int rc,
+                                  const mvsUtils::MultiViewParams& mp,
+                                  const mvsUtils::TileParams& tileParams,
+                                  const std::vector<ROI>& tileRoiList,
+                                  const std::vector<HostFloat2Map>& in_depthSimMapTiles,
+                                  int scale,
+                                  int step,
+                                  const std::string& name = "");
+
 /**
  * @brief Reset a depth/similarity map in host memory to the given default depth and similarity.
  * @param[in,out] inout_depthSimMap_hmh the depth/similarity map in host memory
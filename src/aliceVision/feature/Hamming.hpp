@@ -8,6 +8,7 @@
 #pragma once
 
 #include "metric.hpp"
+#include "distanceKernels.hpp"
 
 #include <bitset>
 
@@ -171,6 +172,22 @@ struct Hamming
     }
 };
 
+// Hamming distance on uint8 raw memory
+//  using the SIMD kernel selected at runtime
+template<>
+struct Hamming<unsigned char>
+{
+    typedef unsigned char ElementType;
+    typedef unsigned int ResultType;
+
+    // Size must be equal to number of ElementType
+    template<typename Iterator1, typename Iterator2>
+    inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
+    {
+        return hammingDistanceUChar(reinterpret_cast<const unsigned char*>(a), reinterpret_cast<const unsigned char*>(b), size);
+    }
+};
+
 template<typename T>
 struct SquaredHamming
 {
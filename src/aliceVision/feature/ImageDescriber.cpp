@@ -199,6 +199,18 @@ void ImageDescriber::Save(const Regions* regions, const std::string& sfileNameFe
     fs::rename(tmpDescsPath, sfileNameDescs);
 }
 
+void ImageDescriber::SaveBinary(const Regions* regions, const std::string& sfileNameRegions) const
+{
+    const fs::path bRegionsPath = fs::path(sfileNameRegions);
+    const std::string tmpRegionsPath =
+      (bRegionsPath.parent_path() / bRegionsPath.stem()).string() + "." + utils::generateUniqueFilename() + bRegionsPath.extension().string();
+
+    regions->SaveBinary(tmpRegionsPath, EImageDescriberType_enumToString(getDescriberType()));
+
+    // rename temporary filename
+    fs::rename(tmpRegionsPath, sfileNameRegions);
+}
+
 std::unique_ptr<ImageDescriber> createImageDescriber(EImageDescriberType imageDescriberType)
 {
     std::unique_ptr<ImageDescriber> describerPtr;
@@ -257,6 +257,15 @@ class ImageDescriber
 
     void Save(const Regions* regions, const std::string& sfileNameFeats, const std::string& sfileNameDescs) const;
 
+    // IO - one binary file for region features and region descriptors
+
+    void LoadBinary(Regions* regions, const std::string& sfileNameRegions, bool memoryMapped = false) const
+    {
+        regions->LoadBinary(sfileNameRegions, memoryMapped);
+    }
+
+    void SaveBinary(const Regions* regions, const std::string& sfileNameRegions) const;
+
     void LoadFeatures(Regions* regions, const std::string& sfileNameFeats) const { regions->LoadFeatures(sfileNameFeats); }
 };
 
@@ -12,7 +12,9 @@
 #include <aliceVision/feature/PointFeature.hpp>
 #include <aliceVision/feature/Descriptor.hpp>
 #include <aliceVision/feature/metric.hpp>
+#include <aliceVision/feature/regionsBinaryIO.hpp>
 
+#include <stdexcept>
 #include <string>
 #include <cstddef>
 #include <typeinfo>
@@ -54,6 +56,9 @@ class Regions
   public:
     void LoadFeatures(const std::string& sfileNameFeats) { loadFeatsFromFile(sfileNameFeats, _vec_feats); }
 
+    /// Read only the features from a binary regions file (the descriptors pages are never read).
+    void LoadFeaturesBinary(const std::string& sfileNameRegions) { loadFeatsFromRegionsFile(readRegionsFile(sfileNameRegions), _vec_feats); }
+
     PointFeatures GetRegionsPositions() const { return PointFeatures(_vec_feats.begin(), _vec_feats.end()); }
 
     Vec2 GetRegionPosition(std::size_t i) const { return Vec2f(_vec_feats[i].coords()).cast<double>(); }
@@ -75,6 +80,24 @@ class Regions
 
     virtual void SaveDesc(const std::string& sfileNameDescs) const = 0;
 
+    //--
+    // IO - one binary file for region features and region descriptors
+    //--
+
+    /**
+     * @brief Read the regions and their descriptors from a binary regions file.
+     * @param[in] sfileNameRegions The binary regions file
+     * @param[in] memoryMapped If true, the file stays mapped and the descriptors are exposed from it without copy
+     */
+    virtual void LoadBinary(const std::string& sfileNameRegions, bool memoryMapped) = 0;
+
+    /**
+     * @brief Export the regions and their descriptors in a binary regions file.
+     * @param[in] sfileNameRegions The binary regions file
+     * @param[in] describerTypeName The image describer type name stored in the file header
+     */
+    virtual void SaveBinary(const std::string& sfileNameRegions, const std::string& describerTypeName) const = 0;
+
     //--
     //- Basic description of a descriptor [Type, Length]
     //--
@@ -85,10 +108,14 @@ class Regions
     virtual std::string Type_id() const = 0;
     virtual std::size_t DescriptorLength() const = 0;
 
+    /// size in bytes of one descriptor
+    virtual std::size_t DescriptorSize() const = 0;
+
     /**
-     * @brief Return a blind pointer to the container of the descriptors array.
+     * @brief Return a blind pointer to the first descriptor of the descriptors array.
      *
-     * @note: Descriptors are always stored as an std::vector<DescType>.
+     * @note: Descriptors are always exposed as a flat array of RegionCount() DescType,
+     *        from the descriptors container or from the memory-mapped regions file.
      */
     virtual const void* blindDescriptors() const = 0;
 
@@ -140,6 +167,40 @@ struct SquaredMetric<T, ERegionType::Binary>
     using Metric = SquaredHamming<T>;
 };
 
+/**
+ * @brief Read-only view over a contiguous array of descriptors,
+ *        owned by a descriptors container or by a memory-mapped regions file.
+ */
+template<typename DescriptorT>
+class DescriptorsView
+{
+  public:
+    typedef DescriptorT value_type;
+    typedef const DescriptorT* const_iterator;
+
+    DescriptorsView(const DescriptorT* data, std::size_t size)
+      : _data(data),
+        _size(size)
+    {}
+
+    inline const DescriptorT* data() const { return _data; }
+    inline std::size_t size() const { return _size; }
+    inline bool empty() const { return _size == 0; }
+
+    inline const_iterator begin() const { return _data; }
+    inline const_iterator end() const { return _data + _size; }
+
+    inline const DescriptorT& operator[](std::size_t i) const
+    {
+        assert(i < _size);
+        return _data[i];
+    }
+
+  private:
+    const DescriptorT* _data;
+    std::size_t _size;
+};
+
 template<typename T, std::size_t L, ERegionType regionType>
 class FeatDescRegions : public Regions
 {
@@ -149,13 +210,37 @@ class FeatDescRegions : public Regions
     typedef Descriptor<T, L> DescriptorT;
     /// Container for multiple regions description
     typedef std::vector<DescriptorT> DescsT;
+    /// Read-only view of multiple regions description
+    typedef DescriptorsView<DescriptorT> DescsViewT;
 
   protected:
     std::vector<DescriptorT> _vec_descs;  // region descriptions
 
+    // memory-mapped region descriptions, used instead of _vec_descs when set
+    std::shared_ptr<const MappedFile> _mappedFile;
+    const DescriptorT* _mappedDescs = nullptr;
+    std::size_t _mappedDescsCount = 0;
+
+    static_assert(sizeof(DescriptorT) == L * sizeof(T), "Descriptors must be stored as a flat array of bins");
+
+    /// Return the descriptors, from the memory mapping or from the descriptors container
+    inline const DescriptorT* descriptorsData() const { return _mappedDescs ? _mappedDescs : _vec_descs.data(); }
+
+    /// Return the number of descriptors, from the memory mapping or from the descriptors container
+    inline std::size_t descriptorsCount() const { return _mappedDescs ? _mappedDescsCount : _vec_descs.size(); }
+
+    /// Release the memory mapping, if any
+    inline void releaseMapping()
+    {
+        _mappedDescs = nullptr;
+        _mappedDescsCount = 0;
+        _mappedFile.reset();
+    }
+
   public:
     std::string Type_id() const override { return typeid(T).name(); }
     std::size_t DescriptorLength() const override { return static_cast<std::size_t>(L); }
+    std::size_t DescriptorSize() const override { return sizeof(DescriptorT); }
 
     bool IsScalar() const override { return regionType == ERegionType::Scalar; }
     bool IsBinary() const override { return regionType == ERegionType::Binary; }
@@ -165,6 +250,7 @@ class FeatDescRegions : public Regions
     /// Read from files the regions and their corresponding descriptors.
     void Load(const std::string& sfileNameFeats, const std::string& sfileNameDescs) override
     {
+        releaseMapping();
         loadFeatsFromFile(sfileNameFeats, this->_vec_feats);
         loadDescsFromBinFile(sfileNameDescs, _vec_descs);
     }
@@ -173,37 +259,104 @@ class FeatDescRegions : public Regions
     void Save(const std::string& sfileNameFeats, const std::string& sfileNameDescs) const override
     {
         saveFeatsToFile(sfileNameFeats, this->_vec_feats);
-        saveDescsToBinFile(sfileNameDescs, _vec_descs);
+        SaveDesc(sfileNameDescs);
     }
 
-    void SaveDesc(const std::string& sfileNameDescs) const override { saveDescsToBinFile(sfileNameDescs, _vec_descs); }
+    void SaveDesc(const std::string& sfileNameDescs) const override
+    {
+        if (_mappedDescs)
+        {
+            const DescsT descs(_mappedDescs, _mappedDescs + _mappedDescsCount);
+            saveDescsToBinFile(sfileNameDescs, descs);
+        }
+        else
+            saveDescsToBinFile(sfileNameDescs, _vec_descs);
+    }
 
-    /// Mutable and non-mutable DescriptorT getters.
-    inline std::vector<DescriptorT>& Descriptors() { return _vec_descs; }
-    inline const std::vector<DescriptorT>& Descriptors() const { return _vec_descs; }
+    /// Read from a binary regions file the regions and their corresponding descriptors.
+    void LoadBinary(const std::string& sfileNameRegions, bool memoryMapped) override
+    {
+        const RegionsFileContent content = readRegionsFile(sfileNameRegions);
+        checkRegionsFileDescriptors(content, sfileNameRegions, L, sizeof(T), IsBinary());
+        loadFeatsFromRegionsFile(content, this->_vec_feats);
 
-    inline const void* blindDescriptors() const override { return &_vec_descs; }
+        const DescriptorT* descs = reinterpret_cast<const DescriptorT*>(content.descriptors);
+        if (memoryMapped)
+        {
+            _vec_descs.clear();
+            _mappedFile = content.file;
+            _mappedDescs = descs;
+            _mappedDescsCount = content.descriptorCount;
+        }
+        else
+        {
+            releaseMapping();
+            _vec_descs.assign(descs, descs + content.descriptorCount);
+        }
+    }
 
-    inline const void* DescriptorRawData() const override { return &_vec_descs[0]; }
+    /// Export in a binary regions file the regions and their corresponding descriptors.
+    void SaveBinary(const std::string& sfileNameRegions, const std::string& describerTypeName) const override
+    {
+        writeRegionsFile(sfileNameRegions, describerTypeName, this->_vec_feats, descriptorsData(), L, sizeof(T), IsBinary());
+    }
 
-    inline void clearDescriptors() override { _vec_descs.clear(); }
+    /// Return true if the descriptors are exposed from a memory-mapped regions file.
+    inline bool isMemoryMapped() const { return _mappedDescs != nullptr; }
+
+    /**
+     * @brief Copy the memory-mapped descriptors into the descriptors container and release the mapping.
+     *        Required before any mutable access to the descriptors of memory-mapped regions.
+     */
+    void detachDescriptors()
+    {
+        if (!_mappedDescs)
+            return;
+        _vec_descs.assign(_mappedDescs, _mappedDescs + _mappedDescsCount);
+        releaseMapping();
+    }
+
+    /// Mutable DescriptorT container getter.
+    /// Memory-mapped regions must be detached first (see detachDescriptors).
+    inline std::vector<DescriptorT>& Descriptors()
+    {
+        if (_mappedDescs)
+            throw std::logic_error("Mutable descriptors access on memory-mapped regions, detachDescriptors() must be called first.");
+        return _vec_descs;
+    }
+
+    /// Non-mutable DescriptorT getter, valid on memory-mapped regions.
+    inline DescsViewT Descriptors() const { return DescsViewT(descriptorsData(), descriptorsCount()); }
+
+    inline const void* blindDescriptors() const override { return descriptorsData(); }
+
+    inline const void* DescriptorRawData() const override { return descriptorsData(); }
+
+    inline void clearDescriptors() override
+    {
+        _vec_descs.clear();
+        releaseMapping();
+    }
 
     inline void swap(This& other)
     {
         this->_vec_feats.swap(other._vec_feats);
         _vec_descs.swap(other._vec_descs);
+        _mappedFile.swap(other._mappedFile);
+        std::swap(_mappedDescs, other._mappedDescs);
+        std::swap(_mappedDescsCount, other._mappedDescsCount);
     }
 
     // Return the distance between two descriptors
     double SquaredDescriptorDistance(std::size_t i, const Regions* genericRegions, std::size_t j) const override
     {
-        assert(i < this->_vec_descs.size());
+        assert(i < this->RegionCount());
         assert(genericRegions);
         assert(j < genericRegions->RegionCount());
 
         const This* regionsT = dynamic_cast<const This*>(genericRegions);
         static typename SquaredMetric<T, regionType>::Metric metric;
-        return metric(this->_vec_descs[i].getData(), regionsT->_vec_descs[j].getData(), DescriptorT::static_size);
+        return metric(this->descriptorsData()[i].getData(), regionsT->descriptorsData()[j].getData(), DescriptorT::static_size);
     }
 
     /**
@@ -213,9 +366,11 @@ class FeatDescRegions : public Regions
      */
     void CopyRegion(std::size_t i, Regions* outRegionContainer) const override
     {
-        assert(i < this->_vec_feats.size() && i < this->_vec_descs.size());
-        static_cast<This*>(outRegionContainer)->_vec_feats.push_back(this->_vec_feats[i]);
-        static_cast<This*>(outRegionContainer)->_vec_descs.push_back(this->_vec_descs[i]);
+        assert(i < this->_vec_feats.size());
+        This* outRegions = static_cast<This*>(outRegionContainer);
+        outRegions->detachDescriptors();
+        outRegions->_vec_feats.push_back(this->_vec_feats[i]);
+        outRegions->_vec_descs.push_back(this->descriptorsData()[i]);
     }
 
     /**
@@ -240,7 +395,7 @@ class FeatDescRegions : public Regions
         {
             const FeatureInImage& feat = featuresInImage[i];
             regionsPtr->Features().push_back(this->_vec_feats[feat._featureIndex]);
-            regionsPtr->Descriptors().push_back(this->_vec_descs[feat._featureIndex]);
+            regionsPtr->Descriptors().push_back(this->descriptorsData()[feat._featureIndex]);
 
             // This assert should be valid in theory, but in the context of CameraLocalization
             // we can have the same 2D feature associated to different 3D points (2 in practice).
@@ -104,6 +104,8 @@ class RegionsPerView
         return aliceVision::feature::getCommonDescTypes(regionsA, regionsB);
     }
 
+    void removeRegions(IndexT viewId) { _data.erase(viewId); }
+
     void clearDescriptors()
     {
         for (auto& itA : _data)
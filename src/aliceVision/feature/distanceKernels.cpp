@@ -0,0 +1,270 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "distanceKernels.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if (defined __GNUC__ || defined __clang__) && (defined __x86_64__ || defined __amd64__)
+    #define ALICEVISION_DISTANCE_KERNELS_X86
+    #include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace aliceVision {
+namespace feature {
+
+std::string EDistanceKernelsSimd_enumToString(EDistanceKernelsSimd simd)
+{
+    switch (simd)
+    {
+        case EDistanceKernelsSimd::SCALAR:
+            return "scalar";
+        case EDistanceKernelsSimd::AVX2:
+            return "avx2";
+        case EDistanceKernelsSimd::AVX512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+namespace detail {
+
+inline unsigned int popcount64(uint64_t n)
+{
+#if defined _MSC_VER && defined _M_X64
+    return static_cast<unsigned int>(__popcnt64(n));
+#elif defined __GNUC__ || defined __clang__
+    return static_cast<unsigned int>(__builtin_popcountll(n));
+#else
+    n -= ((n >> 1) & 0x5555555555555555ULL);
+    n = (n & 0x3333333333333333ULL) + ((n >> 2) & 0x3333333333333333ULL);
+    return static_cast<unsigned int>((((n + (n >> 4)) & 0x0f0f0f0f0f0f0f0fULL) * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+unsigned int squaredL2DistanceUCharScalar(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    unsigned int result = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const int diff = static_cast<int>(a[i]) - static_cast<int>(b[i]);
+        result += static_cast<unsigned int>(diff * diff);
+    }
+    return result;
+}
+
+unsigned int hammingDistanceUCharScalar(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    unsigned int result = 0;
+    std::size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t wa, wb;
+        std::memcpy(&wa, a + i, sizeof(uint64_t));
+        std::memcpy(&wb, b + i, sizeof(uint64_t));
+        result += popcount64(wa ^ wb);
+    }
+    for (; i < size; ++i)
+        result += popcount64(static_cast<uint64_t>(a[i] ^ b[i]));
+    return result;
+}
+
+}  // namespace detail
+
+#ifdef ALICEVISION_DISTANCE_KERNELS_X86
+
+namespace {
+
+__attribute__((target("avx2"))) unsigned int squaredL2DistanceUCharAvx2(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    __m256i sum = _mm256_setzero_si256();
+    std::size_t i = 0;
+
+    // 16 bins per iteration: widen to 16 bits, subtract and multiply-add pairs in 32 bits
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m256i va = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        const __m256i vb = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        const __m256i diff = _mm256_sub_epi16(va, vb);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(diff, diff));
+    }
+
+    // horizontal sum
+    __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    return static_cast<unsigned int>(_mm_cvtsi128_si32(sum128)) + detail::squaredL2DistanceUCharScalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx2"))) unsigned int hammingDistanceUCharAvx2(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    // population count of each nibble
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0f);
+
+    __m256i sum = _mm256_setzero_si256();
+    std::size_t i = 0;
+
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const __m256i x = _mm256_xor_si256(va, vb);
+        const __m256i lo = _mm256_and_si256(x, lowMask);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), lowMask);
+        const __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        // sum the byte counts in 4 x 64 bits
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+
+    const uint64_t result = static_cast<uint64_t>(_mm256_extract_epi64(sum, 0)) + static_cast<uint64_t>(_mm256_extract_epi64(sum, 1)) +
+                            static_cast<uint64_t>(_mm256_extract_epi64(sum, 2)) + static_cast<uint64_t>(_mm256_extract_epi64(sum, 3));
+
+    return static_cast<unsigned int>(result) + detail::hammingDistanceUCharScalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx512f,avx512bw"))) unsigned int squaredL2DistanceUCharAvx512(const unsigned char* a,
+                                                                                      const unsigned char* b,
+                                                                                      std::size_t size)
+{
+    __m512i sum = _mm512_setzero_si512();
+    std::size_t i = 0;
+
+    // 32 bins per iteration
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m512i va = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+        const __m512i vb = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        const __m512i diff = _mm512_sub_epi16(va, vb);
+        sum = _mm512_add_epi32(sum, _mm512_madd_epi16(diff, diff));
+    }
+
+    alignas(64) uint32_t lanes[16];
+    _mm512_store_si512(lanes, sum);
+    unsigned int result = 0;
+    for (const uint32_t lane : lanes)
+        result += lane;
+
+    return result + detail::squaredL2DistanceUCharScalar(a + i, b + i, size - i);
+}
+
+__attribute__((target("avx512f,avx512bw"))) unsigned int hammingDistanceUCharAvx512(const unsigned char* a,
+                                                                                    const unsigned char* b,
+                                                                                    std::size_t size)
+{
+    // population count of each nibble: {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4} in each 128 bits lane
+    const __m512i lookup = _mm512_set4_epi64(0x0403030203020201LL, 0x0302020102010100LL, 0x0403030203020201LL, 0x0302020102010100LL);
+    const __m512i lowMask = _mm512_set1_epi8(0x0f);
+
+    __m512i sum = _mm512_setzero_si512();
+    std::size_t i = 0;
+
+    for (; i + 64 <= size; i += 64)
+    {
+        const __m512i va = _mm512_loadu_si512(a + i);
+        const __m512i vb = _mm512_loadu_si512(b + i);
+        const __m512i x = _mm512_xor_si512(va, vb);
+        const __m512i lo = _mm512_and_si512(x, lowMask);
+        const __m512i hi = _mm512_and_si512(_mm512_srli_epi16(x, 4), lowMask);
+        const __m512i counts = _mm512_add_epi8(_mm512_shuffle_epi8(lookup, lo), _mm512_shuffle_epi8(lookup, hi));
+        sum = _mm512_add_epi64(sum, _mm512_sad_epu8(counts, _mm512_setzero_si512()));
+    }
+
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512(lanes, sum);
+    uint64_t result = 0;
+    for (const uint64_t lane : lanes)
+        result += lane;
+
+    // remaining bytes with the AVX2 kernel
+    return static_cast<unsigned int>(result) + hammingDistanceUCharAvx2(a + i, b + i, size - i);
+}
+
+EDistanceKernelsSimd detectDistanceKernelsSimd()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        return EDistanceKernelsSimd::AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return EDistanceKernelsSimd::AVX2;
+    return EDistanceKernelsSimd::SCALAR;
+}
+
+}  // namespace
+
+#else
+
+namespace {
+
+EDistanceKernelsSimd detectDistanceKernelsSimd() { return EDistanceKernelsSimd::SCALAR; }
+
+}  // namespace
+
+#endif  // ALICEVISION_DISTANCE_KERNELS_X86
+
+namespace {
+
+using DistanceKernel = unsigned int (*)(const unsigned char*, const unsigned char*, std::size_t);
+
+struct DistanceKernels
+{
+    EDistanceKernelsSimd simd = EDistanceKernelsSimd::SCALAR;
+    DistanceKernel squaredL2 = &detail::squaredL2DistanceUCharScalar;
+    DistanceKernel hamming = &detail::hammingDistanceUCharScalar;
+};
+
+DistanceKernels selectDistanceKernels()
+{
+    DistanceKernels kernels;
+    kernels.simd = detectDistanceKernelsSimd();
+
+#ifdef ALICEVISION_DISTANCE_KERNELS_X86
+    switch (kernels.simd)
+    {
+        case EDistanceKernelsSimd::AVX512:
+            kernels.squaredL2 = &squaredL2DistanceUCharAvx512;
+            kernels.hamming = &hammingDistanceUCharAvx512;
+            break;
+        case EDistanceKernelsSimd::AVX2:
+            kernels.squaredL2 = &squaredL2DistanceUCharAvx2;
+            kernels.hamming = &hammingDistanceUCharAvx2;
+            break;
+        case EDistanceKernelsSimd::SCALAR:
+            break;
+    }
+#endif
+
+    return kernels;
+}
+
+const DistanceKernels& getDistanceKernels()
+{
+    static const DistanceKernels kernels = selectDistanceKernels();
+    return kernels;
+}
+
+}  // namespace
+
+EDistanceKernelsSimd getDistanceKernelsSimd() { return getDistanceKernels().simd; }
+
+unsigned int squaredL2DistanceUChar(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    return getDistanceKernels().squaredL2(a, b, size);
+}
+
+unsigned int hammingDistanceUChar(const unsigned char* a, const unsigned char* b, std::size_t size)
+{
+    return getDistanceKernels().hamming(a, b, size);
+}
+
+}  // namespace feature
+}  // namespace aliceVision
@@ -0,0 +1,64 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace aliceVision {
+namespace feature {
+
+/**
+ * Distance kernels on raw uint8 descriptors.
+ *
+ * The implementation is selected once at runtime according to the instruction sets
+ * supported by the CPU: AVX-512 (F + BW), AVX2 or a portable scalar fallback.
+ * SIMD implementations are only compiled with GCC and Clang on x86-64.
+ */
+
+enum class EDistanceKernelsSimd
+{
+    SCALAR = 0,
+    AVX2,
+    AVX512
+};
+
+std::string EDistanceKernelsSimd_enumToString(EDistanceKernelsSimd simd);
+
+/**
+ * @brief Get the instruction set used by the distance kernels on this machine.
+ */
+EDistanceKernelsSimd getDistanceKernelsSimd();
+
+/**
+ * @brief Squared L2 distance between two uint8 descriptors.
+ * @param[in] a The first descriptor
+ * @param[in] b The second descriptor
+ * @param[in] size The number of bins
+ * @return The squared L2 distance (exact)
+ */
+unsigned int squaredL2DistanceUChar(const unsigned char* a, const unsigned char* b, std::size_t size);
+
+/**
+ * @brief Hamming distance between two binary descriptors.
+ * @param[in] a The first descriptor
+ * @param[in] b The second descriptor
+ * @param[in] size The number of bytes
+ * @return The number of different bits
+ */
+unsigned int hammingDistanceUChar(const unsigned char* a, const unsigned char* b, std::size_t size);
+
+namespace detail {
+
+// portable implementations, exposed for testing
+unsigned int squaredL2DistanceUCharScalar(const unsigned char* a, const unsigned char* b, std::size_t size);
+unsigned int hammingDistanceUCharScalar(const unsigned char* a, const unsigned char* b, std::size_t size);
+
+}  // namespace detail
+
+}  // namespace feature
+}  // namespace aliceVision
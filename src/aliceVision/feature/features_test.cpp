@@ -129,3 +129,67 @@ BOOST_AUTO_TEST_CASE(descriptorIO_BINARY)
             BOOST_CHECK_EQUAL(vec_descs[i][j], vec_descs_read[i][j]);
     }
 }
+
+// Test binary regions file export, with copied and memory-mapped descriptors
+BOOST_AUTO_TEST_CASE(regionsIO_BINARY)
+{
+    typedef ScalarRegions<unsigned char, DESC_LENGTH> Regions_T;
+
+    Regions_T regions;
+    for (int i = 0; i < CARD; ++i)
+    {
+        regions.Features().push_back(Feature_T(i, i * 2, i * 3, i * 4));
+        Regions_T::DescriptorT desc;
+        for (int j = 0; j < DESC_LENGTH; ++j)
+            desc[j] = static_cast<unsigned char>(i + j);
+        regions.Descriptors().push_back(desc);
+    }
+
+    BOOST_CHECK_NO_THROW(regions.SaveBinary("tempRegions.regions", "sift"));
+
+    for (const bool memoryMapped : {false, true})
+    {
+        Regions_T regionsRead;
+        BOOST_CHECK_NO_THROW(regionsRead.LoadBinary("tempRegions.regions", memoryMapped));
+        BOOST_CHECK_EQUAL(regionsRead.isMemoryMapped(), memoryMapped);
+        BOOST_CHECK_EQUAL(CARD, regionsRead.RegionCount());
+
+        const Regions_T::DescriptorT* descs = reinterpret_cast<const Regions_T::DescriptorT*>(regionsRead.DescriptorRawData());
+        for (int i = 0; i < CARD; ++i)
+        {
+            BOOST_CHECK_EQUAL(regions.Features()[i], regionsRead.Features()[i]);
+            BOOST_CHECK_EQUAL(regionsRead.SquaredDescriptorDistance(i, &regions, i), 0.0);
+            for (int j = 0; j < DESC_LENGTH; ++j)
+                BOOST_CHECK_EQUAL(regions.Descriptors()[i][j], descs[i][j]);
+        }
+
+        // non-mutable access is valid on memory-mapped descriptors
+        const Regions_T& constRegionsRead = regionsRead;
+        BOOST_CHECK_EQUAL(CARD, constRegionsRead.Descriptors().size());
+        BOOST_CHECK_EQUAL(constRegionsRead.Descriptors().data(), descs);
+        BOOST_CHECK_EQUAL(constRegionsRead.blindDescriptors(), regionsRead.DescriptorRawData());
+
+        // mutable access requires to detach the memory-mapped descriptors
+        if (memoryMapped)
+            BOOST_CHECK_THROW(regionsRead.Descriptors(), std::logic_error);
+        regionsRead.detachDescriptors();
+        BOOST_CHECK(!regionsRead.isMemoryMapped());
+        BOOST_CHECK_EQUAL(CARD, regionsRead.Descriptors().size());
+        for (int i = 0; i < CARD; ++i)
+            BOOST_CHECK_EQUAL(regionsRead.SquaredDescriptorDistance(i, &regions, i), 0.0);
+    }
+
+    // features only
+    Regions_T featuresRead;
+    BOOST_CHECK_NO_THROW(featuresRead.LoadFeaturesBinary("tempRegions.regions"));
+    BOOST_CHECK_EQUAL(CARD, featuresRead.RegionCount());
+
+    // descriptors of another type
+    ScalarRegions<float, DESC_LENGTH> floatRegions;
+    BOOST_CHECK_THROW(floatRegions.LoadBinary("tempRegions.regions", true), std::exception);
+
+    // not a regions file
+    BOOST_CHECK_NO_THROW(saveFeatsToFile("tempFeatsNotRegions.feat", regions.Features()));
+    BOOST_CHECK_THROW(featuresRead.LoadBinary("tempFeatsNotRegions.feat", false), std::exception);
+    BOOST_CHECK_THROW(featuresRead.LoadBinary("x.regions", false), std::exception);
+}
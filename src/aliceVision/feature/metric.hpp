@@ -8,6 +8,7 @@
 #pragma once
 
 #include "Hamming.hpp"
+#include "distanceKernels.hpp"
 
 #include <aliceVision/numeric/Accumulator.hpp>
 #include <aliceVision/config.hpp>
@@ -79,6 +80,21 @@ struct L2_Vectorized
     }
 };
 
+// Template specification to run the SIMD L2 squared distance kernel
+//  on uint8 vector
+template<>
+struct L2_Vectorized<unsigned char>
+{
+    typedef unsigned char ElementType;
+    typedef Accumulator<unsigned char>::Type ResultType;
+
+    template<typename Iterator1, typename Iterator2>
+    inline ResultType operator()(Iterator1 a, Iterator2 b, size_t size) const
+    {
+        return static_cast<ResultType>(squaredL2DistanceUChar(&a[0], &b[0], size));
+    }
+};
+
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
 
 namespace optim_ss2 {
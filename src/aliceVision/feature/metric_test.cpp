@@ -8,7 +8,9 @@
 #include <aliceVision/feature/metric.hpp>
 
 #include <iostream>
+#include <random>
 #include <string>
+#include <vector>
 
 #define BOOST_TEST_MODULE matchingMetric
 
@@ -152,3 +154,33 @@ BOOST_AUTO_TEST_CASE(Metric_HAMMING_BITSET_RAW_MEMORY_32BITS)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(Metric_DistanceKernels)
+{
+    BOOST_TEST_MESSAGE("Distance kernels: " << EDistanceKernelsSimd_enumToString(getDistanceKernelsSimd()));
+
+    std::mt19937 randomNumberGenerator(0);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    // sizes covering the SIMD blocks and the remainders (SIFT: 128, AKAZE MLDB: 64)
+    for (std::size_t size : {0, 1, 7, 15, 16, 31, 32, 33, 61, 63, 64, 65, 127, 128, 129, 200})
+    {
+        std::vector<unsigned char> a(size);
+        std::vector<unsigned char> b(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            a[i] = static_cast<unsigned char>(distribution(randomNumberGenerator));
+            b[i] = static_cast<unsigned char>(distribution(randomNumberGenerator));
+        }
+
+        BOOST_CHECK_EQUAL(squaredL2DistanceUChar(a.data(), b.data(), size), detail::squaredL2DistanceUCharScalar(a.data(), b.data(), size));
+        BOOST_CHECK_EQUAL(hammingDistanceUChar(a.data(), b.data(), size), detail::hammingDistanceUCharScalar(a.data(), b.data(), size));
+        BOOST_CHECK_EQUAL(L2_Vectorized<unsigned char>()(a.data(), b.data(), size), L2_Simple<unsigned char>()(a.data(), b.data(), size));
+    }
+
+    // worst case values
+    const std::vector<unsigned char> zeros(128, 0);
+    const std::vector<unsigned char> ones(128, 255);
+    BOOST_CHECK_EQUAL(squaredL2DistanceUChar(zeros.data(), ones.data(), 128), 128 * 255 * 255);
+    BOOST_CHECK_EQUAL(hammingDistanceUChar(zeros.data(), ones.data(), 128), 128 * 8);
+}
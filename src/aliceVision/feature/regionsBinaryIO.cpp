@@ -0,0 +1,268 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "regionsBinaryIO.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace aliceVision {
+namespace feature {
+
+namespace {
+
+constexpr char REGIONS_FILE_MAGIC[8] = {'A', 'V', 'R', 'E', 'G', 'I', 'O', 'N'};
+constexpr std::size_t FEATURE_RECORD_SIZE = 4 * sizeof(float);
+
+std::size_t alignOffset(std::size_t offset) { return (offset + REGIONS_FILE_ALIGNMENT - 1) / REGIONS_FILE_ALIGNMENT * REGIONS_FILE_ALIGNMENT; }
+
+}  // namespace
+
+MappedFile::MappedFile(const std::string& path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Can't map file, can't open '" + path + "' !");
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Can't map file, can't get the size of '" + path + "' !");
+    }
+    _fileHandle = file;
+    _size = static_cast<std::size_t>(fileSize.QuadPart);
+    if (_size == 0)
+        return;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Can't map file '" + path + "' !");
+    }
+    _mappingHandle = mapping;
+    _data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (_data == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Can't map file '" + path + "' !");
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Can't map file, can't open '" + path + "' !");
+
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Can't map file, can't get the size of '" + path + "' !");
+    }
+    _size = static_cast<std::size_t>(fileStat.st_size);
+    if (_size == 0)
+    {
+        ::close(fd);
+        return;
+    }
+
+    void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid once the file descriptor is closed
+    ::close(fd);
+    if (data == MAP_FAILED)
+        throw std::runtime_error("Can't map file '" + path + "' !");
+    _data = static_cast<const unsigned char*>(data);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (_data != nullptr)
+        UnmapViewOfFile(_data);
+    if (_mappingHandle != nullptr)
+        CloseHandle(_mappingHandle);
+    if (_fileHandle != nullptr)
+        CloseHandle(_fileHandle);
+#else
+    if (_data != nullptr)
+        ::munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+}
+
+void writeRegionsFile(const std::string& path,
+                      const std::string& describerTypeName,
+                      const std::vector<PointFeature>& features,
+                      const void* descriptors,
+                      std::size_t descriptorLength,
+                      std::size_t descriptorBinSize,
+                      bool isBinary)
+{
+    RegionsFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, REGIONS_FILE_MAGIC, sizeof(header.magic));
+    header.version = REGIONS_FILE_VERSION;
+    header.sectionCount = 2;
+    std::strncpy(header.describerType, describerTypeName.c_str(), sizeof(header.describerType) - 1);
+    header.descriptorLength = static_cast<uint32_t>(descriptorLength);
+    header.descriptorBinSize = static_cast<uint32_t>(descriptorBinSize);
+    header.isBinary = isBinary ? 1 : 0;
+
+    const std::size_t descriptorSize = descriptorLength * descriptorBinSize;
+
+    std::array<RegionsFileSection, 2> sections;
+    sections[0].type = static_cast<uint32_t>(ERegionsFileSection::FEATURES);
+    sections[0].elementSize = static_cast<uint32_t>(FEATURE_RECORD_SIZE);
+    sections[0].count = features.size();
+    sections[0].offset = alignOffset(sizeof(RegionsFileHeader) + sections.size() * sizeof(RegionsFileSection));
+
+    sections[1].type = static_cast<uint32_t>(ERegionsFileSection::DESCRIPTORS);
+    sections[1].elementSize = static_cast<uint32_t>(descriptorSize);
+    sections[1].count = features.size();
+    sections[1].offset = alignOffset(sections[0].offset + sections[0].count * sections[0].elementSize);
+
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Can't save regions binary file, can't open '" + path + "' !");
+
+    const char padding[REGIONS_FILE_ALIGNMENT] = {};
+    const auto padTo = [&](std::size_t offset) {
+        const std::size_t position = static_cast<std::size_t>(file.tellp());
+        file.write(padding, offset - position);
+    };
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(RegionsFileSection));
+
+    padTo(sections[0].offset);
+    std::vector<float> featureRecords(features.size() * 4);
+    for (std::size_t i = 0; i < features.size(); ++i)
+    {
+        featureRecords[4 * i + 0] = features[i].x();
+        featureRecords[4 * i + 1] = features[i].y();
+        featureRecords[4 * i + 2] = features[i].scale();
+        featureRecords[4 * i + 3] = features[i].orientation();
+    }
+    file.write(reinterpret_cast<const char*>(featureRecords.data()), featureRecords.size() * sizeof(float));
+
+    padTo(sections[1].offset);
+    file.write(static_cast<const char*>(descriptors), features.size() * descriptorSize);
+
+    if (!file.good())
+        throw std::runtime_error("Can't save regions binary file, '" + path + "' is incorrect !");
+
+    file.close();
+}
+
+RegionsFileContent readRegionsFile(const std::string& path)
+{
+    RegionsFileContent content;
+    content.file = std::make_shared<const MappedFile>(path);
+
+    const unsigned char* data = content.file->data();
+    const std::size_t size = content.file->size();
+
+    if (size < sizeof(RegionsFileHeader))
+        throw std::runtime_error("Can't load regions binary file, '" + path + "' is too small !");
+
+    std::memcpy(&content.header, data, sizeof(RegionsFileHeader));
+    const RegionsFileHeader& header = content.header;
+
+    if (std::memcmp(header.magic, REGIONS_FILE_MAGIC, sizeof(header.magic)) != 0)
+        throw std::runtime_error("Can't load regions binary file, '" + path + "' is not a regions file !");
+
+    if (header.version != REGIONS_FILE_VERSION)
+        throw std::runtime_error("Can't load regions binary file, '" + path + "' has unsupported version " + std::to_string(header.version) + " !");
+
+    if (sizeof(RegionsFileHeader) + std::size_t(header.sectionCount) * sizeof(RegionsFileSection) > size)
+        throw std::runtime_error("Can't load regions binary file, '" + path + "' has an invalid section table !");
+
+    bool hasFeatures = false;
+    bool hasDescriptors = false;
+    const std::size_t descriptorSize = std::size_t(header.descriptorLength) * header.descriptorBinSize;
+
+    for (uint32_t i = 0; i < header.sectionCount; ++i)
+    {
+        RegionsFileSection section;
+        std::memcpy(&section, data + sizeof(RegionsFileHeader) + i * sizeof(RegionsFileSection), sizeof(RegionsFileSection));
+
+        if (section.offset % REGIONS_FILE_ALIGNMENT != 0 || section.offset > size ||
+            (section.elementSize != 0 && section.count > (size - section.offset) / section.elementSize))
+            throw std::runtime_error("Can't load regions binary file, '" + path + "' has an invalid section !");
+
+        switch (static_cast<ERegionsFileSection>(section.type))
+        {
+            case ERegionsFileSection::FEATURES:
+                if (section.elementSize != FEATURE_RECORD_SIZE)
+                    throw std::runtime_error("Can't load regions binary file, '" + path + "' has an invalid features section !");
+                content.features = reinterpret_cast<const float*>(data + section.offset);
+                content.featureCount = section.count;
+                hasFeatures = true;
+                break;
+            case ERegionsFileSection::DESCRIPTORS:
+                if (section.elementSize != descriptorSize)
+                    throw std::runtime_error("Can't load regions binary file, '" + path + "' has an invalid descriptors section !");
+                content.descriptors = data + section.offset;
+                content.descriptorCount = section.count;
+                hasDescriptors = true;
+                break;
+            default:
+                // unknown sections are ignored for forward compatibility
+                break;
+        }
+    }
+
+    if (!hasFeatures || !hasDescriptors || content.featureCount != content.descriptorCount)
+        throw std::runtime_error("Can't load regions binary file, '" + path + "' is incomplete !");
+
+    return content;
+}
+
+void checkRegionsFileDescriptors(const RegionsFileContent& content,
+                                 const std::string& path,
+                                 std::size_t descriptorLength,
+                                 std::size_t descriptorBinSize,
+                                 bool isBinary)
+{
+    const RegionsFileHeader& header = content.header;
+    if (header.descriptorLength != descriptorLength || header.descriptorBinSize != descriptorBinSize || (header.isBinary != 0) != isBinary)
+    {
+        throw std::runtime_error("Can't load regions binary file, '" + path + "' contains descriptors of length " +
+                                 std::to_string(header.descriptorLength) + " (" + std::to_string(header.descriptorBinSize) +
+                                 " bytes per bin), expected length " + std::to_string(descriptorLength) + " (" +
+                                 std::to_string(descriptorBinSize) + " bytes per bin) !");
+    }
+}
+
+void loadFeatsFromRegionsFile(const RegionsFileContent& content, std::vector<PointFeature>& vec_feats)
+{
+    vec_feats.resize(content.featureCount);
+    for (std::size_t i = 0; i < content.featureCount; ++i)
+    {
+        const float* f = content.features + 4 * i;
+        vec_feats[i] = PointFeature(f[0], f[1], f[2], f[3]);
+    }
+}
+
+}  // namespace feature
+}  // namespace aliceVision
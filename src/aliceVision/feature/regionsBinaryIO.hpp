@@ -0,0 +1,146 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/feature/PointFeature.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace feature {
+
+/**
+ * Binary regions file (".regions"): features and descriptors of one view for one describer type.
+ *
+ * Layout (version 1, native little-endian):
+ *  - RegionsFileHeader
+ *  - RegionsFileSection table (RegionsFileHeader::sectionCount entries)
+ *  - section payloads, each one starting at an offset aligned on REGIONS_FILE_ALIGNMENT bytes
+ *
+ * Features are stored as 4 floats (x, y, scale, orientation).
+ * Descriptors are stored as a flat array of descriptorLength bins of descriptorBinSize bytes,
+ * so they can be used in place from a memory mapping of the file.
+ */
+
+constexpr const char* REGIONS_FILE_EXTENSION = ".regions";
+constexpr uint32_t REGIONS_FILE_VERSION = 1;
+constexpr std::size_t REGIONS_FILE_ALIGNMENT = 64;
+
+enum class ERegionsFileSection : uint32_t
+{
+    FEATURES = 1,
+    DESCRIPTORS = 2
+};
+
+struct RegionsFileHeader
+{
+    char magic[8];               // "AVREGION"
+    uint32_t version;            // REGIONS_FILE_VERSION
+    uint32_t sectionCount;       // number of entries in the section table
+    char describerType[32];      // image describer type name, zero-padded
+    uint32_t descriptorLength;   // number of bins per descriptor
+    uint32_t descriptorBinSize;  // size in bytes of one descriptor bin
+    uint32_t isBinary;           // 1 for binary descriptors (Hamming metric), 0 for scalar ones
+    uint32_t reserved;
+};
+
+struct RegionsFileSection
+{
+    uint32_t type;         // ERegionsFileSection
+    uint32_t elementSize;  // size in bytes of one element of the section
+    uint64_t count;        // number of elements
+    uint64_t offset;       // absolute offset of the payload in the file
+};
+
+static_assert(sizeof(RegionsFileHeader) == 64, "Unexpected RegionsFileHeader size");
+static_assert(sizeof(RegionsFileSection) == 24, "Unexpected RegionsFileSection size");
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ */
+class MappedFile
+{
+  public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return _data; }
+    std::size_t size() const { return _size; }
+
+  private:
+    const unsigned char* _data = nullptr;
+    std::size_t _size = 0;
+#ifdef _WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#endif
+};
+
+/**
+ * @brief Validated view on the content of a memory-mapped binary regions file.
+ */
+struct RegionsFileContent
+{
+    std::shared_ptr<const MappedFile> file;
+    RegionsFileHeader header;
+    /// features as 4 floats per feature (x, y, scale, orientation)
+    const float* features = nullptr;
+    std::size_t featureCount = 0;
+    /// first byte of the flat descriptor array
+    const unsigned char* descriptors = nullptr;
+    std::size_t descriptorCount = 0;
+};
+
+/**
+ * @brief Write a binary regions file.
+ * @param[in] path The output file path
+ * @param[in] describerTypeName The image describer type name stored in the header
+ * @param[in] features The region features
+ * @param[in] descriptors Pointer to the flat descriptor array (features.size() descriptors)
+ * @param[in] descriptorLength Number of bins per descriptor
+ * @param[in] descriptorBinSize Size in bytes of one descriptor bin
+ * @param[in] isBinary True for binary descriptors
+ */
+void writeRegionsFile(const std::string& path,
+                      const std::string& describerTypeName,
+                      const std::vector<PointFeature>& features,
+                      const void* descriptors,
+                      std::size_t descriptorLength,
+                      std::size_t descriptorBinSize,
+                      bool isBinary);
+
+/**
+ * @brief Memory-map a binary regions file and check its header and section table.
+ * @param[in] path The input file path
+ * @return the file content, pointing into the mapping
+ */
+RegionsFileContent readRegionsFile(const std::string& path);
+
+/**
+ * @brief Check that the descriptors of a regions file match the expected descriptor type.
+ * @throw std::runtime_error if the descriptor layout differs
+ */
+void checkRegionsFileDescriptors(const RegionsFileContent& content,
+                                 const std::string& path,
+                                 std::size_t descriptorLength,
+                                 std::size_t descriptorBinSize,
+                                 bool isBinary);
+
+/**
+ * @brief Copy the features of a regions file into a vector of PointFeature.
+ */
+void loadFeatsFromRegionsFile(const RegionsFileContent& content, std::vector<PointFeature>& vec_feats);
+
+}  // namespace feature
+}  // namespace aliceVision
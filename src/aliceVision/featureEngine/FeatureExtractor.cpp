@@ -25,14 +25,19 @@ FeatureExtractorViewJob::FeatureExtractorViewJob(const sfmData::View& view, cons
 
 FeatureExtractorViewJob::~FeatureExtractorViewJob() = default;
 
-void FeatureExtractorViewJob::setImageDescribers(const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers)
+void FeatureExtractorViewJob::setImageDescribers(const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers, bool binaryRegions)
 {
     for (std::size_t i = 0; i < imageDescribers.size(); ++i)
     {
         const std::shared_ptr<feature::ImageDescriber>& imageDescriber = imageDescribers.at(i);
         feature::EImageDescriberType imageDescriberType = imageDescriber->getDescriberType();
 
-        if (utils::exists(getFeaturesPath(imageDescriberType)) && utils::exists(getDescriptorPath(imageDescriberType)))
+        if (binaryRegions && utils::exists(getRegionsPath(imageDescriberType)))
+        {
+            continue;
+        }
+
+        if (!binaryRegions && utils::exists(getFeaturesPath(imageDescriberType)) && utils::exists(getDescriptorPath(imageDescriberType)))
         {
             continue;
         }
@@ -79,7 +84,7 @@ void FeatureExtractor::process(const HardwareContext& hContext, const image::EIm
         const sfmData::View& view = *(it->second.get());
         FeatureExtractorViewJob viewJob(view, _outputFolder);
 
-        viewJob.setImageDescribers(_imageDescribers);
+        viewJob.setImageDescribers(_imageDescribers, _binaryRegions);
         jobMaxMemoryConsuption = std::max(jobMaxMemoryConsuption, viewJob.memoryConsuption());
 
         if (viewJob.useCPU())
@@ -296,7 +301,10 @@ void FeatureExtractor::computeViewJob(const FeatureExtractorViewJob& job, bool u
             regions = regions->createFilteredRegions(selectedIndices, out_associated3dPoint, out_mapFullToLocal);
         }
 
-        imageDescriber->Save(regions.get(), job.getFeaturesPath(imageDescriberType), job.getDescriptorPath(imageDescriberType));
+        if (_binaryRegions)
+            imageDescriber->SaveBinary(regions.get(), job.getRegionsPath(imageDescriberType));
+        else
+            imageDescriber->Save(regions.get(), job.getFeaturesPath(imageDescriberType), job.getDescriptorPath(imageDescriberType));
         ALICEVISION_LOG_INFO(std::left << std::setw(6) << " " << regions->RegionCount() << " " << imageDescriberTypeName
                                        << " features extracted from view '" << job.view().getImage().getImagePath() << "'");
     }
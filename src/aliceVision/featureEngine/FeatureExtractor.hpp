@@ -32,7 +32,12 @@ class FeatureExtractorViewJob
         return _outputBasename + "." + EImageDescriberType_enumToString(imageDescriberType) + ".desc";
     }
 
-    void setImageDescribers(const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers);
+    std::string getRegionsPath(feature::EImageDescriberType imageDescriberType) const
+    {
+        return _outputBasename + "." + EImageDescriberType_enumToString(imageDescriberType) + feature::REGIONS_FILE_EXTENSION;
+    }
+
+    void setImageDescribers(const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers, bool binaryRegions = false);
 
     const sfmData::View& view() const { return _view; }
 
@@ -72,6 +77,13 @@ class FeatureExtractor
 
     void setOutputFolder(const std::string& folder) { _outputFolder = folder; }
 
+    /**
+     * @brief Export the regions in a single binary regions file per describer type
+     *        instead of the .feat/.desc files
+     * @param[in] binaryRegions
+     */
+    void setBinaryRegions(bool binaryRegions) { _binaryRegions = binaryRegions; }
+
     void addImageDescriber(std::shared_ptr<feature::ImageDescriber>& imageDescriber) { _imageDescribers.push_back(imageDescriber); }
 
     void process(const HardwareContext& hcontext, const image::EImageColorSpace workingColorSpace = image::EImageColorSpace::SRGB);
@@ -87,6 +99,7 @@ class FeatureExtractor
     std::string _maskExtension;
     bool _maskInvert;
     std::string _outputFolder;
+    bool _binaryRegions = false;
     int _rangeStart = -1;
     int _rangeSize = -1;
 };
@@ -0,0 +1,146 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/fuseCut/delaunayGraphCutTypes.hpp>
+#include <aliceVision/fuseCut/Tetrahedralization.hpp>
+
+#include <boost/atomic/atomic_ref.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @brief Cell weight modified by a ray
+ */
+enum class ECellWeight : std::uint8_t
+{
+    EmptinessScore = 0,
+    GEdgeVisWeight0 = 1,  //< gEdgeVisWeight[0], next values for gEdgeVisWeight[1..3]
+    CellSWeight = 5,      //< assignment, not summed
+    CellTWeight = 6,
+    On = 7
+};
+
+/**
+ * @brief Cell weights accumulation with an atomic operation per contribution.
+ * @note Rays can be marched in any order by any thread.
+ */
+class AtomicCellWeights
+{
+  public:
+    explicit AtomicCellWeights(std::vector<GC_cellInfo>& cellsAttr)
+      : _cellsAttr(cellsAttr)
+    {}
+
+    inline void addEmptinessScore(CellIndex ci, float w) { boost::atomic_ref<float>{_cellsAttr[ci].emptinessScore} += w; }
+    inline void addGEdgeVisWeight(CellIndex ci, int k, float w) { boost::atomic_ref<float>{_cellsAttr[ci].gEdgeVisWeight[k]} += w; }
+    inline void setCellSWeight(CellIndex ci, float w) { boost::atomic_ref<float>{_cellsAttr[ci].cellSWeight} = w; }
+    inline void addCellTWeight(CellIndex ci, float w) { boost::atomic_ref<float>{_cellsAttr[ci].cellTWeight} += w; }
+    inline void addOn(CellIndex ci, float w) { boost::atomic_ref<float>{_cellsAttr[ci].on} += w; }
+
+  private:
+    std::vector<GC_cellInfo>& _cellsAttr;
+};
+
+/**
+ * @brief Thread-local cell weights contributions, bucketed by cell range.
+ * @note Contributions are recorded without any synchronization,
+ *       then applied with apply(): each cell range can be applied by a different thread,
+ *       a cell range being applied by a single thread for all the CellRangeWeights.
+ */
+class CellRangeWeights
+{
+  public:
+    /**
+     * @brief CellRangeWeights constructor.
+     * @param[in] nbCells the number of cells
+     * @param[in] rangeShift the cell range size is (1 << rangeShift) cells
+     */
+    CellRangeWeights(std::size_t nbCells, int rangeShift)
+      : _rangeShift(rangeShift),
+        _ranges((nbCells >> rangeShift) + 1)
+    {}
+
+    /// get the number of cell ranges
+    static inline std::size_t getNbRanges(std::size_t nbCells, int rangeShift) { return (nbCells >> rangeShift) + 1; }
+
+    inline void addEmptinessScore(CellIndex ci, float w) { record(ci, ECellWeight::EmptinessScore, w); }
+    inline void addGEdgeVisWeight(CellIndex ci, int k, float w) { record(ci, ECellWeight(int(ECellWeight::GEdgeVisWeight0) + k), w); }
+    inline void setCellSWeight(CellIndex ci, float w) { record(ci, ECellWeight::CellSWeight, w); }
+    inline void addCellTWeight(CellIndex ci, float w) { record(ci, ECellWeight::CellTWeight, w); }
+    inline void addOn(CellIndex ci, float w) { record(ci, ECellWeight::On, w); }
+
+    /**
+     * @brief Apply and release the recorded contributions of a cell range.
+     * @param[in] range the cell range index
+     * @param[in,out] cellsAttr the cells attributes
+     */
+    void apply(std::size_t range, std::vector<GC_cellInfo>& cellsAttr)
+    {
+        std::vector<Contribution>& contributions = _ranges[range];
+
+        for (const Contribution& contribution : contributions)
+        {
+            GC_cellInfo& c = cellsAttr[contribution.cellIndex];
+
+            switch (contribution.weight)
+            {
+                case ECellWeight::EmptinessScore:
+                    c.emptinessScore += contribution.value;
+                    break;
+                case ECellWeight::CellSWeight:
+                    c.cellSWeight = contribution.value;
+                    break;
+                case ECellWeight::CellTWeight:
+                    c.cellTWeight += contribution.value;
+                    break;
+                case ECellWeight::On:
+                    c.on += contribution.value;
+                    break;
+                default:
+                    c.gEdgeVisWeight[int(contribution.weight) - int(ECellWeight::GEdgeVisWeight0)] += contribution.value;
+                    break;
+            }
+        }
+
+        // keep the capacity for the next batch
+        contributions.clear();
+    }
+
+    /**
+     * @brief Get the contributions buffer memory consumption.
+     * @return memory consumption (in bytes)
+     */
+    std::size_t getMemoryConsumption() const
+    {
+        std::size_t bytes = _ranges.capacity() * sizeof(std::vector<Contribution>);
+        for (const auto& contributions : _ranges)
+            bytes += contributions.capacity() * sizeof(Contribution);
+        return bytes;
+    }
+
+  private:
+    struct Contribution
+    {
+        CellIndex cellIndex;
+        ECellWeight weight;
+        float value;
+    };
+
+    inline void record(CellIndex ci, ECellWeight weight, float value) { _ranges[ci >> _rangeShift].push_back({ci, weight, value}); }
+
+    const int _rangeShift;
+    std::vector<std::vector<Contribution>> _ranges;  //< contributions per cell range
+};
+
+}  // namespace fuseCut
+}  // namespace aliceVision
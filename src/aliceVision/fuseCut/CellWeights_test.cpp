@@ -0,0 +1,174 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/CellWeights.hpp>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_MODULE cellWeights
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+namespace {
+
+struct RayContribution
+{
+    CellIndex cellIndex;
+    ECellWeight weight;
+    float value;
+};
+
+using Ray = std::vector<RayContribution>;
+
+/// rays crossing neighboring cells, with exactly representable weights so that the sums do not depend on the order
+std::vector<Ray> createRays(std::size_t nbCells, std::size_t nbRays)
+{
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<CellIndex> cellDist(0, nbCells - 1);
+    std::uniform_int_distribution<int> stepDist(-300, 300);
+    std::uniform_int_distribution<int> lengthDist(1, 40);
+    std::uniform_int_distribution<int> weightDist(int(ECellWeight::EmptinessScore), int(ECellWeight::On));
+    std::uniform_int_distribution<int> valueDist(1, 16);
+
+    std::vector<Ray> rays(nbRays);
+    for (Ray& ray : rays)
+    {
+        CellIndex ci = cellDist(gen);
+        const int length = lengthDist(gen);
+        for (int i = 0; i < length; ++i)
+        {
+            const ECellWeight weight = ECellWeight(weightDist(gen));
+            // the cellSWeight assignment is the same for all the rays
+            const float value = (weight == ECellWeight::CellSWeight) ? 1000.f : valueDist(gen) * 0.25f;
+            ray.push_back({ci, weight, value});
+            ci = CellIndex(std::clamp<long long>(static_cast<long long>(ci) + stepDist(gen), 0, nbCells - 1));
+        }
+    }
+    return rays;
+}
+
+template<class CellWeightsT>
+void march(const Ray& ray, CellWeightsT& cellWeights)
+{
+    for (const RayContribution& c : ray)
+    {
+        switch (c.weight)
+        {
+            case ECellWeight::EmptinessScore:
+                cellWeights.addEmptinessScore(c.cellIndex, c.value);
+                break;
+            case ECellWeight::CellSWeight:
+                cellWeights.setCellSWeight(c.cellIndex, c.value);
+                break;
+            case ECellWeight::CellTWeight:
+                cellWeights.addCellTWeight(c.cellIndex, c.value);
+                break;
+            case ECellWeight::On:
+                cellWeights.addOn(c.cellIndex, c.value);
+                break;
+            default:
+                cellWeights.addGEdgeVisWeight(c.cellIndex, int(c.weight) - int(ECellWeight::GEdgeVisWeight0), c.value);
+                break;
+        }
+    }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(cellWeights_rangesSameAsAtomic)
+{
+    const std::size_t nbCells = 50000;
+    const std::vector<Ray> rays = createRays(nbCells, 20000);
+
+    // atomic accumulation
+    std::vector<GC_cellInfo> atomicCellsAttr(nbCells);
+    {
+        AtomicCellWeights cellWeights(atomicCellsAttr);
+#pragma omp parallel for
+        for (int i = 0; i < rays.size(); ++i)
+            march(rays[i], cellWeights);
+    }
+
+    // thread-local contributions by cell ranges, applied after each batch of rays
+    std::vector<GC_cellInfo> rangesCellsAttr(nbCells);
+    {
+        const int rangeShift = 12;
+        const std::size_t nbRanges = CellRangeWeights::getNbRanges(nbCells, rangeShift);
+        const int nbThreads = omp_get_max_threads();
+        std::vector<CellRangeWeights> threadsCellWeights(nbThreads, CellRangeWeights(nbCells, rangeShift));
+
+        const int batchSize = 3000;
+        for (int batchBegin = 0; batchBegin < rays.size(); batchBegin += batchSize)
+        {
+            const int batchEnd = std::min(batchBegin + batchSize, int(rays.size()));
+#pragma omp parallel for
+            for (int i = batchBegin; i < batchEnd; ++i)
+                march(rays[i], threadsCellWeights[omp_get_thread_num()]);
+
+#pragma omp parallel for
+            for (int range = 0; range < nbRanges; ++range)
+                for (CellRangeWeights& cellWeights : threadsCellWeights)
+                    cellWeights.apply(range, rangesCellsAttr);
+        }
+    }
+
+    for (std::size_t ci = 0; ci < nbCells; ++ci)
+    {
+        const GC_cellInfo& a = atomicCellsAttr[ci];
+        const GC_cellInfo& b = rangesCellsAttr[ci];
+        BOOST_CHECK_EQUAL(a.emptinessScore, b.emptinessScore);
+        BOOST_CHECK_EQUAL(a.cellSWeight, b.cellSWeight);
+        BOOST_CHECK_EQUAL(a.cellTWeight, b.cellTWeight);
+        BOOST_CHECK_EQUAL(a.on, b.on);
+        for (int k = 0; k < 4; ++k)
+            BOOST_CHECK_EQUAL(a.gEdgeVisWeight[k], b.gEdgeVisWeight[k]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cellWeights_applyReleasesContributions)
+{
+    const std::size_t nbCells = 10000;
+    const int rangeShift = 10;
+    const std::size_t nbRanges = CellRangeWeights::getNbRanges(nbCells, rangeShift);
+    const std::vector<Ray> rays = createRays(nbCells, 100);
+
+    CellRangeWeights cellWeights(nbCells, rangeShift);
+    std::vector<GC_cellInfo> cellsAttr(nbCells);
+    std::vector<GC_cellInfo> expectedCellsAttr(nbCells);
+    AtomicCellWeights expectedCellWeights(expectedCellsAttr);
+
+    for (const Ray& ray : rays)
+    {
+        march(ray, cellWeights);
+        march(ray, expectedCellWeights);
+    }
+
+    // applying twice does not add the contributions twice, the buffers capacity is kept
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (std::size_t range = 0; range < nbRanges; ++range)
+            cellWeights.apply(range, cellsAttr);
+    }
+    const std::size_t memory = cellWeights.getMemoryConsumption();
+    BOOST_CHECK_GT(memory, nbRanges * sizeof(std::vector<int>));
+
+    for (std::size_t ci = 0; ci < nbCells; ++ci)
+    {
+        BOOST_CHECK_EQUAL(cellsAttr[ci].emptinessScore, expectedCellsAttr[ci].emptinessScore);
+        BOOST_CHECK_EQUAL(cellsAttr[ci].on, expectedCellsAttr[ci].on);
+    }
+
+    // the next batch reuses the buffers
+    march(rays.front(), cellWeights);
+    BOOST_CHECK_EQUAL(cellWeights.getMemoryConsumption(), memory);
+}
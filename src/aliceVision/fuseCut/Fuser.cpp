@@ -7,6 +7,7 @@
 #include "Fuser.hpp"
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
@@ -22,6 +23,7 @@
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 
+#include <deque>
 #include <filesystem>
 
 #include <iostream>
@@ -45,7 +47,8 @@ unsigned long computeNumberOfAllPoints(const mvsUtils::MultiViewParams& mp, int
 }
 
 Fuser::Fuser(const mvsUtils::MultiViewParams& mp)
-  : _mp(mp)
+  : _mp(mp),
+    _mapCache(mp, system::getMemoryInfo().availableRam / 2)  // keep half of the available memory for the computation
 {}
 
 Fuser::~Fuser() {}
@@ -121,23 +124,87 @@ bool Fuser::updateInSurr(float pixToleranceFactor,
     return true;
 }
 
+std::vector<int> Fuser::getNeighborAwareOrder(const std::vector<int>& cams, const std::vector<StaticVector<int>>& tcamsPerCam) const
+{
+    // camera index to position in cams
+    std::vector<int> camsIndexes(_mp.ncams, -1);
+    for (int c = 0; c < cams.size(); ++c)
+        camsIndexes[cams[c]] = c;
+
+    std::vector<int> order;
+    std::vector<bool> visited(cams.size(), false);
+    std::deque<int> toVisit;
+
+    order.reserve(cams.size());
+
+    for (int first = 0; first < cams.size(); ++first)
+    {
+        if (visited[first])
+            continue;
+
+        // breadth-first traversal from the first not visited camera
+        visited[first] = true;
+        toVisit.push_back(first);
+
+        while (!toVisit.empty())
+        {
+            const int c = toVisit.front();
+            toVisit.pop_front();
+            order.push_back(c);
+
+            const StaticVector<int>& tcams = tcamsPerCam[c];
+            for (int i = 0; i < tcams.size(); ++i)
+            {
+                const int tcIndex = camsIndexes[tcams[i]];
+
+                if (tcIndex >= 0 && !visited[tcIndex])
+                {
+                    visited[tcIndex] = true;
+                    toVisit.push_back(tcIndex);
+                }
+            }
+        }
+    }
+
+    return order;
+}
+
 // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
 void Fuser::filterGroups(const std::vector<int>& cams, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams)
 {
     ALICEVISION_LOG_INFO("Precomputing groups.");
     long t1 = clock();
+
+    // get nearest cameras of each camera
+    std::vector<StaticVector<int>> tcamsPerCam(cams.size());
+
 #pragma omp parallel for
     for (int c = 0; c < cams.size(); c++)
     {
-        int rc = cams[c];
-        filterGroupsRC(rc, pixToleranceFactor, pixSizeBall, pixSizeBallWSP, nNearestCams);
+        tcamsPerCam[c] = _mp.findNearestCamsFromLandmarks(cams[c], nNearestCams);
     }
 
+    // process neighbor cameras together, their depth maps are read once and shared through the map cache
+    const std::vector<int> order = getNeighborAwareOrder(cams, tcamsPerCam);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < order.size(); i++)
+    {
+        const int c = order[i];
+        filterGroupsRC(cams[c], pixToleranceFactor, pixSizeBall, pixSizeBallWSP, tcamsPerCam[c]);
+    }
+
+    _mapCache.logStatistics();
     mvsUtils::printfElapsedTime(t1);
 }
 
 // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
 bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams)
+{
+    return filterGroupsRC(rc, pixToleranceFactor, pixSizeBall, pixSizeBallWSP, _mp.findNearestCamsFromLandmarks(rc, nNearestCams));
+}
+
+bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, const StaticVector<int>& tcams)
 {
     if (utils::exists(getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap)))
     {
@@ -148,12 +215,12 @@ bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, in
     int w = _mp.getWidth(rc);
     int h = _mp.getHeight(rc);
 
-    image::Image<float> depthMap;
-    image::Image<float> simMap;
+    // get depth/sim maps from depthMapEstimation folder (through the map cache)
+    const mvsUtils::MapCache::MapSharedPtr depthMapPtr = _mapCache.getMap_sync(rc, mvsUtils::EFileType::depthMap);
+    const mvsUtils::MapCache::MapSharedPtr simMapPtr = _mapCache.getMap_sync(rc, mvsUtils::EFileType::simMap);
 
-    // read depth/sim maps from depthMapEstimation folder
-    mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMap, depthMap);
-    mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::simMap, simMap);
+    const image::Image<float>& depthMap = *depthMapPtr;
+    const image::Image<float>& simMap = *simMapPtr;
 
     image::Image<unsigned char> numOfModalsMap(w, h, true, 0);
 
@@ -169,17 +236,14 @@ bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, in
     numOfPtsMap->reserve(w * h);
     numOfPtsMap->resize_with(w * h, 0);
 
-    StaticVector<int> tcams = _mp.findNearestCamsFromLandmarks(rc, nNearestCams);
-
     for (int c = 0; c < tcams.size(); c++)
     {
         numOfPtsMap->resize_with(w * h, 0);
         int tc = tcams[c];
 
-        image::Image<float> tcdepthMap;
-
-        // read Tc depth map from depthMapEstimation folder
-        mvsUtils::readMap(tc, _mp, mvsUtils::EFileType::depthMap, tcdepthMap);
+        // get Tc depth map from depthMapEstimation folder (through the map cache)
+        const mvsUtils::MapCache::MapSharedPtr tcdepthMapPtr = _mapCache.getMap_sync(tc, mvsUtils::EFileType::depthMap);
+        const image::Image<float>& tcdepthMap = *tcdepthMapPtr;
 
         if (tcdepthMap.height() > 0 && tcdepthMap.width() > 0)
         {
@@ -230,6 +294,10 @@ void Fuser::filterDepthMaps(const std::vector<int>& cams, int minNumOfModals, in
         filterDepthMapsRC(rc, minNumOfModals, minNumOfModalsWSP2SSP);
     }
 
+    // depth/sim maps are no longer needed
+    _mapCache.logStatistics();
+    _mapCache.clear();
+
     mvsUtils::printfElapsedTime(t1);
 }
 
@@ -238,14 +306,11 @@ bool Fuser::filterDepthMapsRC(int rc, int minNumOfModals, int minNumOfModalsWSP2
 {
     long t1 = clock();
 
-    image::Image<float> depthMap;
-    image::Image<float> simMap;
+    // copy depth/sim maps from depthMapEstimation folder (through the map cache, maps may be still loaded from filterGroups)
+    image::Image<float> depthMap = *_mapCache.getMap_sync(rc, mvsUtils::EFileType::depthMap);
+    image::Image<float> simMap = *_mapCache.getMap_sync(rc, mvsUtils::EFileType::simMap);
     image::Image<unsigned char> numOfModalsMap;
 
-    // read depth/sim maps from depthMapEstimation folder
-    mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMap, depthMap);
-    mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::simMap, simMap);
-
     image::readImage(getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap), numOfModalsMap, image::EImageColorSpace::NO_CONVERSION);
 
     if (depthMap.width() != simMap.width() || depthMap.width() != numOfModalsMap.width() || depthMap.height() != simMap.height() ||
@@ -8,6 +8,7 @@
 
 #include <aliceVision/image/Image.hpp>
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/mvsUtils/MapCache.hpp>
 #include <aliceVision/mvsData/Point3d.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
 #include <aliceVision/mvsData/Universe.hpp>
@@ -41,6 +42,18 @@ class Fuser
     float computeAveragePixelSizeInHexahedron(Point3d* hexah, const sfmData::SfMData& sfmData);
 
   private:
+    /**
+     * @brief Compute cameras processing order that maximizes neighbor maps reuse.
+     * @note Breadth-first traversal of the nearest cameras graph,
+     *       cameras processed at the same time share most of their neighbors.
+     * @param[in] cams the cameras to process
+     * @param[in] tcamsPerCam the nearest cameras of each camera to process
+     * @return the cameras indexes (in cams) in processing order
+     */
+    std::vector<int> getNeighborAwareOrder(const std::vector<int>& cams, const std::vector<StaticVector<int>>& tcamsPerCam) const;
+
+    bool filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, const StaticVector<int>& tcams);
+
     bool updateInSurr(float pixToleranceFactor,
                       int pixSizeBall,
                       int pixSizeBallWSP,
@@ -51,6 +64,8 @@ class Fuser
                       const image::Image<float>& depthMap,
                       const image::Image<float>& simMap,
                       int scale);
+
+    mvsUtils::MapCache _mapCache;  //< depth/sim maps shared across cameras processing
 };
 
 unsigned long computeNumberOfAllPoints(const mvsUtils::MultiViewParams& mp, int scale);
@@ -7,15 +7,60 @@
 #include "GraphFiller.hpp"
 
 #include <aliceVision/mvsUtils/common.hpp>
+#include <aliceVision/fuseCut/CellWeights.hpp>
 #include <aliceVision/fuseCut/Intersections.hpp>
 #include <aliceVision/fuseCut/MaxFlow_AdjList.hpp>
+#include <aliceVision/fuseCut/MaxFlow_CSR.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
-#include <boost/atomic/atomic_ref.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <algorithm>
+#include <numeric>
 
 
 namespace aliceVision {
 namespace fuseCut {
 
+EMaxFlowSolver EMaxFlowSolver_stringToEnum(const std::string& solver)
+{
+    std::string s = solver;
+    boost::to_lower(s);
+
+    if (s == "boykovkolmogorov")
+        return EMaxFlowSolver::BoykovKolmogorov;
+    if (s == "pushrelabel")
+        return EMaxFlowSolver::PushRelabel;
+    throw std::out_of_range("Invalid max flow solver " + solver);
+}
+
+std::string EMaxFlowSolver_enumToString(EMaxFlowSolver solver)
+{
+    switch (solver)
+    {
+        case EMaxFlowSolver::BoykovKolmogorov:
+            return "BoykovKolmogorov";
+        case EMaxFlowSolver::PushRelabel:
+            return "PushRelabel";
+    }
+    throw std::out_of_range("Unrecognized EMaxFlowSolver");
+}
+
+std::istream& operator>>(std::istream& in, EMaxFlowSolver& solver)
+{
+    std::string token;
+    in >> token;
+    solver = EMaxFlowSolver_stringToEnum(token);
+    return in;
+}
+
+std::ostream& operator<<(std::ostream& os, EMaxFlowSolver solver)
+{
+    os << EMaxFlowSolver_enumToString(solver);
+    return os;
+}
+
 GraphFiller::GraphFiller(mvsUtils::MultiViewParams& mp, 
                         const PointCloud & pc, 
                         const Tetrahedralization & tetrahedralization)
@@ -56,14 +101,18 @@ void GraphFiller::build(const StaticVector<int>& cams)
     const double nPixelSizeBehind = _mp.userParams.get<double>("delaunaycut.nPixelSizeBehind", 4.0);
     const float fullWeight = float(_mp.userParams.get<double>("delaunaycut.fullWeight", 1.0));
     const bool forceTEdge = _mp.userParams.get<bool>("delaunaycut.voteFilteringForWeaklySupportedSurfaces", true);
+    _batchedAccumulation = _mp.userParams.get<bool>("delaunaycut.batchedAccumulation", true);
+    _rayBatchSize = std::max(1, _mp.userParams.get<int>("delaunaycut.rayBatchSize", 65536));
 
     addToInfiniteSw((float)maxint);
 
-    fillGraph(nPixelSizeBehind, fullWeight);
+    const std::vector<Ray> rays = getRays(_batchedAccumulation);
+
+    fillGraph(rays, nPixelSizeBehind, fullWeight);
 
     if (forceTEdge)
     {
-        forceTedgesByGradientIJCV(nPixelSizeBehind);
+        forceTedgesByGradientIJCV(rays, nPixelSizeBehind);
     }
 }
 
@@ -79,41 +128,127 @@ void GraphFiller::addToInfiniteSw(float sW)
     }
 }
 
-void GraphFiller::fillGraph(double nPixelSizeBehind, float fullWeight)
+std::vector<GraphFiller::Ray> GraphFiller::getRays(bool sortByStartingCell) const
 {
-    ALICEVISION_LOG_INFO("Computing s-t graph weights.");
+    std::vector<int> verticesIds;
+
+    if (sortByStartingCell)
+    {
+        // the first neighboring cell (lowest index) of each vertex
+        std::vector<CellIndex> startingCells(_verticesAttr.size(), GEO::NO_CELL);
 
-    // choose random order to prevent waiting
-    const unsigned int seed = (unsigned int)_mp.userParams.get<unsigned int>("delaunaycut.seed", 0);
-    const std::vector<int> verticesRandIds = mvsUtils::createRandomArrayOfIntegers(_verticesAttr.size(), seed);
+#pragma omp parallel for
+        for (int vi = 0; vi < int(_verticesAttr.size()); ++vi)
+        {
+            const std::vector<CellIndex>& neighboringCells = _tetrahedralization.getNeighboringCellsByVertexIndex(vi);
+            if (!neighboringCells.empty())
+                startingCells[vi] = neighboringCells.front();
+        }
 
-#pragma omp parallel for 
-    for (int i = 0; i < verticesRandIds.size(); i++)
+        // rays starting from close cells are marched together, for a better locality in the cells data
+        verticesIds.resize(_verticesAttr.size());
+        std::iota(verticesIds.begin(), verticesIds.end(), 0);
+        std::sort(verticesIds.begin(), verticesIds.end(), [&](int a, int b) {
+            return (startingCells[a] != startingCells[b]) ? (startingCells[a] < startingCells[b]) : (a < b);
+        });
+    }
+    else
     {
-        const int vertexIndex = verticesRandIds[i];
-        const GC_vertexInfo& v = _verticesAttr[vertexIndex];
+        // choose random order to prevent waiting
+        const unsigned int seed = (unsigned int)_mp.userParams.get<unsigned int>("delaunaycut.seed", 0);
+        verticesIds = mvsUtils::createRandomArrayOfIntegers(_verticesAttr.size(), seed);
+    }
 
-        if (!v.isReal())
-        {  
-            continue;
+    std::vector<Ray> rays;
+
+    for (const int vertexIndex : verticesIds)
+    {
+        // note: virtual vertices have no camera
+        for (const int cam : _verticesAttr[vertexIndex].cams)
+            rays.push_back({vertexIndex, cam});
+    }
+
+    return rays;
+}
+
+template<typename RayFunction>
+void GraphFiller::marchRays(const std::vector<Ray>& rays, RayFunction rayFunction)
+{
+    const int nbRays = int(rays.size());
+
+    if (!_batchedAccumulation)
+    {
+        AtomicCellWeights weights(_cellsAttr);
+
+#pragma omp parallel for
+        for (int i = 0; i < nbRays; ++i)
+            rayFunction(rays[i], weights);
+
+        return;
+    }
+
+    // 4096 cells per range
+    const int rangeShift = 12;
+    const std::size_t nbCells = _cellsAttr.size();
+    const int nbRanges = int(CellRangeWeights::getNbRanges(nbCells, rangeShift));
+
+    std::vector<CellRangeWeights> threadsWeights(omp_get_max_threads(), CellRangeWeights(nbCells, rangeShift));
+    std::size_t maxMemory = 0;
+
+    for (int batchBegin = 0; batchBegin < nbRays; batchBegin += _rayBatchSize)
+    {
+        const int batchEnd = std::min(nbRays, batchBegin + _rayBatchSize);
+
+        // march rays, contributions are recorded in the thread buffer
+        // note: rays are sorted by starting cell, small chunks keep close rays in the same thread
+#pragma omp parallel for schedule(dynamic, 16)
+        for (int i = batchBegin; i < batchEnd; ++i)
+            rayFunction(rays[i], threadsWeights[omp_get_thread_num()]);
+
+        std::size_t memory = 0;
+        for (const CellRangeWeights& weights : threadsWeights)
+            memory += weights.getMemoryConsumption();
+        maxMemory = std::max(maxMemory, memory);
+
+        // reduce contributions, each cell range is updated by a single thread
+#pragma omp parallel for schedule(dynamic, 16)
+        for (int r = 0; r < nbRanges; ++r)
+        {
+            for (CellRangeWeights& weights : threadsWeights)
+                weights.apply(r, _cellsAttr);
         }
-        
+    }
+
+    ALICEVISION_LOG_DEBUG("Batched cell weights accumulation: " << nbRays << " rays, " << nbRanges << " cell ranges, "
+                          << threadsWeights.size() << " thread buffers (memory: " << (maxMemory / (1024.0 * 1024.0)) << " MB).");
+}
+
+void GraphFiller::fillGraph(const std::vector<Ray>& rays, double nPixelSizeBehind, float fullWeight)
+{
+    ALICEVISION_LOG_INFO("Computing s-t graph weights.");
+
+    system::Timer timer;
+
+    marchRays(rays, [&](const Ray& ray, auto& weights) {
+        const GC_vertexInfo& v = _verticesAttr[ray.vertexIndex];
+
         float weight = (float)v.nrc;  // number of cameras
 
         //Overwrite with forced weight if available
         weight = (float)_mp.userParams.get<double>("LargeScale.forceWeight", weight);
 
-        for (int c = 0; c < v.cams.size(); c++)
-        {
-            rayMarchingGraphEmpty(vertexIndex, v.cams[c], weight);
-            rayMarchingGraphFull(vertexIndex, v.cams[c], weight* fullWeight, nPixelSizeBehind);
-        }
-    }
+        rayMarchingGraphEmpty(ray.vertexIndex, ray.cam, weight, weights);
+        rayMarchingGraphFull(ray.vertexIndex, ray.cam, weight * fullWeight, nPixelSizeBehind, weights);
+    });
+
+    ALICEVISION_LOG_INFO("Computing s-t graph weights done in " << timer.elapsed() << " s (" << rays.size() << " rays).");
 }
 
+template<typename CellWeights>
 void GraphFiller::rayMarchingGraphEmpty(int vertexIndex,
                                          int cam,
-                                         float weight)
+                                         float weight,
+                                         CellWeights& weights)
 {
     const int maxint = std::numeric_limits<int>::max();
 
@@ -133,6 +268,7 @@ void GraphFiller::rayMarchingGraphEmpty(int vertexIndex,
     TetrahedronsRayMarching marching(_tetrahedralization, vertexIndex, _camsVertexes[cam], false);
 
     Facet lastIntersectedFacet;
+    CellIndex lastEmptyCell = GEO::NO_CELL;
     bool lastGeoIsVertex = false;
     // Break only when we reach our camera vertex (as long as we find a next geometry)
     while (geometry.type != EGeometryType::Vertex || (_mp.CArr[cam] - intersectPt).size() >= 1.0e-3)
@@ -159,8 +295,8 @@ void GraphFiller::rayMarchingGraphEmpty(int vertexIndex,
         {
             GeometryIntersection previousGeometry = marching.getPreviousIntersection();
 
-            boost::atomic_ref<float>{_cellsAttr[previousGeometry.facet.cellIndex].emptinessScore} += weight;
-            boost::atomic_ref<float>{_cellsAttr[previousGeometry.facet.cellIndex].gEdgeVisWeight[previousGeometry.facet.localVertexIndex]} += weight;
+            weights.addEmptinessScore(previousGeometry.facet.cellIndex, weight);
+            weights.addGEdgeVisWeight(previousGeometry.facet.cellIndex, previousGeometry.facet.localVertexIndex, weight);
 
             
             lastIntersectedFacet = geometry.facet;
@@ -169,7 +305,7 @@ void GraphFiller::rayMarchingGraphEmpty(int vertexIndex,
         {
             if (previousGeometry.type == EGeometryType::Facet)
             {
-                boost::atomic_ref<float>{_cellsAttr[previousGeometry.facet.cellIndex].emptinessScore} += weight;
+                weights.addEmptinessScore(previousGeometry.facet.cellIndex, weight);
             }
 
             if (geometry.type == EGeometryType::Vertex)
@@ -182,23 +318,28 @@ void GraphFiller::rayMarchingGraphEmpty(int vertexIndex,
         }
 
         // Declare the last part of the empty path as connected to EMPTY (S node in the graph cut)
-        if (lastIntersectedFacet.cellIndex != GEO::NO_CELL && (_mp.CArr[cam] - intersectPt).size() < 0.2 * pointCamDistance)
+        // note: the assignment is done once per cell
+        if (lastIntersectedFacet.cellIndex != GEO::NO_CELL && lastIntersectedFacet.cellIndex != lastEmptyCell &&
+            (_mp.CArr[cam] - intersectPt).size() < 0.2 * pointCamDistance)
         {
-            boost::atomic_ref<float>{_cellsAttr[lastIntersectedFacet.cellIndex].cellSWeight} = (float)maxint;
+            weights.setCellSWeight(lastIntersectedFacet.cellIndex, (float)maxint);
+            lastEmptyCell = lastIntersectedFacet.cellIndex;
         }
     }
 
     // Vote for the last intersected facet (close to the cam)
-    if (lastIntersectedFacet.cellIndex != GEO::NO_CELL)
+    if (lastIntersectedFacet.cellIndex != GEO::NO_CELL && lastIntersectedFacet.cellIndex != lastEmptyCell)
     {
-        boost::atomic_ref<float>{_cellsAttr[lastIntersectedFacet.cellIndex].cellSWeight} = (float)maxint;
+        weights.setCellSWeight(lastIntersectedFacet.cellIndex, (float)maxint);
     }
 }
 
+template<typename CellWeights>
 void GraphFiller::rayMarchingGraphFull(int vertexIndex,
                                          int cam,
                                          float fullWeight,
-                                         double nPixelSizeBehind)
+                                         double nPixelSizeBehind,
+                                         CellWeights& weights)
 {
     const int maxint = std::numeric_limits<int>::max();
     const Point3d& originPt = _verticesCoords[vertexIndex];
@@ -242,18 +383,19 @@ void GraphFiller::rayMarchingGraphFull(int vertexIndex,
         if (geometry.type == EGeometryType::Facet)
         {
             lastIntersectedFacet = geometry.facet;
-            boost::atomic_ref<float>{_cellsAttr[geometry.facet.cellIndex].gEdgeVisWeight[geometry.facet.localVertexIndex]} += fullWeight;
+            weights.addGEdgeVisWeight(geometry.facet.cellIndex, geometry.facet.localVertexIndex, fullWeight);
         }
     }
 
     // found facet Vote for the last intersected facet (farthest from the camera)
     if (lastIntersectedFacet.cellIndex != GEO::NO_CELL)
     {
-        boost::atomic_ref<float>{_cellsAttr[lastIntersectedFacet.cellIndex].cellTWeight} += fullWeight;
+        weights.addCellTWeight(lastIntersectedFacet.cellIndex, fullWeight);
     }
 }
 
-void GraphFiller::forceTedgesByGradientIJCV(float nPixelSizeBehind)
+template<typename CellWeights>
+void GraphFiller::forceTedgeByGradientIJCV(int vertexIndex, int cam, float nPixelSizeBehind, CellWeights& weights)
 {
     const float forceTEdgeDelta = 0.1f;
     const float minJumpPartRange = 10000.0f;
@@ -262,193 +404,175 @@ void GraphFiller::forceTedgesByGradientIJCV(float nPixelSizeBehind)
     const float nsigmaFrontSilentPart = 2.0f;
     const float nsigmaBackSilentPart = 2.0f;
 
+    const Point3d& originPt = _verticesCoords[vertexIndex];
+    const float maxDist = nPixelSizeBehind * _mp.getCamPixelSize(originPt, cam);
 
-    // choose random order to prevent waiting
-    const unsigned int seed = (unsigned int)_mp.userParams.get<unsigned int>("delaunaycut.seed", 0);
-    const std::vector<int> verticesRandIds = mvsUtils::createRandomArrayOfIntegers(_verticesAttr.size(), seed);
-
+    float maxJump = 0.0f;
+    float maxSilent = 0.0f;
+    float midSilent = 10000000.0f;
 
-#pragma omp parallel for
-    for (int i = 0; i < verticesRandIds.size(); ++i)
     {
-        const int vertexIndex = verticesRandIds[i];
-        const GC_vertexInfo& v = _verticesAttr[vertexIndex];
-        
-        if (v.isVirtual())
-        {
-            continue;
-        }
-
-        const Point3d& originPt = _verticesCoords[vertexIndex];
-        // For each camera that has visibility over the vertex v (vertexIndex)
-        for (const int cam : v.cams)
+        // Initialisation
+        GeometryIntersection geometry(vertexIndex);  // Starting on global vertex index
+        Point3d intersectPt = originPt;
+        // toTheCam
+    
+
+        TetrahedronsRayMarching marching(_tetrahedralization, vertexIndex, _camsVertexes[cam], false);
+
+        // As long as we find a next geometry
+        Point3d lastIntersectPt = originPt;
+        // Iterate on geometries in the direction of camera's vertex within margin defined by maxDist (as long as we find a next geometry)
+        while ((geometry.type != EGeometryType::Vertex || (_mp.CArr[cam] - intersectPt).size() > 1.0e-3)  // We reach our camera vertex
+               &&
+               (lastIntersectPt - originPt).size() <= (nsigmaJumpPart + nsigmaFrontSilentPart) * maxDist)  // We are to far from the originPt
         {
-            
-            const float maxDist = nPixelSizeBehind * _mp.getCamPixelSize(originPt, cam);
+            // Keep previous informations
+            const GeometryIntersection previousGeometry = geometry;
+            lastIntersectPt = intersectPt;
 
-            float maxJump = 0.0f;
-            float maxSilent = 0.0f;
-            float midSilent = 10000000.0f;
+            geometry = marching.intersectNextGeom();
+            Eigen::Vector3d eintersectPt = marching.getIntersectionPoint();
+            intersectPt.x = eintersectPt.x();
+            intersectPt.y = eintersectPt.y();
+            intersectPt.z = eintersectPt.z();
 
+            if (geometry.type == EGeometryType::None)
             {
-                // Initialisation
-                GeometryIntersection geometry(vertexIndex);  // Starting on global vertex index
-                Point3d intersectPt = originPt;
-                // toTheCam
-            
+                break;
+            }
 
-                TetrahedronsRayMarching marching(_tetrahedralization, vertexIndex, _camsVertexes[cam], false);
+            if (geometry.type == EGeometryType::Facet)
+            {
+                GeometryIntersection previousGeometry = marching.getPreviousIntersection();
 
-                // As long as we find a next geometry
-                Point3d lastIntersectPt = originPt;
-                // Iterate on geometries in the direction of camera's vertex within margin defined by maxDist (as long as we find a next geometry)
-                while ((geometry.type != EGeometryType::Vertex || (_mp.CArr[cam] - intersectPt).size() > 1.0e-3)  // We reach our camera vertex
-                       &&
-                       (lastIntersectPt - originPt).size() <= (nsigmaJumpPart + nsigmaFrontSilentPart) * maxDist)  // We are to far from the originPt
+                const GC_cellInfo& c = _cellsAttr[previousGeometry.facet.cellIndex];
+                if ((lastIntersectPt - originPt).size() > nsigmaFrontSilentPart * maxDist)  // (p-originPt).size() > 2 * sigma
                 {
-                    // Keep previous informations
-                    const GeometryIntersection previousGeometry = geometry;
-                    lastIntersectPt = intersectPt;
-
-                    geometry = marching.intersectNextGeom();
-                    Eigen::Vector3d eintersectPt = marching.getIntersectionPoint();
-                    intersectPt.x = eintersectPt.x();
-                    intersectPt.y = eintersectPt.y();
-                    intersectPt.z = eintersectPt.z();
-
-                    if (geometry.type == EGeometryType::None)
-                    {
-                        break;
-                    }
-
-                    if (geometry.type == EGeometryType::Facet)
-                    {
-                        GeometryIntersection previousGeometry = marching.getPreviousIntersection();
-
-                        const GC_cellInfo& c = _cellsAttr[previousGeometry.facet.cellIndex];
-                        if ((lastIntersectPt - originPt).size() > nsigmaFrontSilentPart * maxDist)  // (p-originPt).size() > 2 * sigma
-                        {
-                            maxJump = std::max(maxJump, c.emptinessScore);
-                        }
-                        else
-                        {
-                            maxSilent = std::max(maxSilent, c.emptinessScore);
-                        }
-                    }
+                    maxJump = std::max(maxJump, c.emptinessScore);
+                }
+                else
+                {
+                    maxSilent = std::max(maxSilent, c.emptinessScore);
                 }
             }
-            {
-                // Initialisation
-                GeometryIntersection geometry(vertexIndex);
-                Point3d intersectPt = originPt;
+        }
+    }
+    {
+        // Initialisation
+        GeometryIntersection geometry(vertexIndex);
+        Point3d intersectPt = originPt;
 
-               
-                TetrahedronsRayMarching marching(_tetrahedralization, vertexIndex, _camsVertexes[cam], true);
+       
+        TetrahedronsRayMarching marching(_tetrahedralization, vertexIndex, _camsVertexes[cam], true);
 
-                Facet lastIntersectedFacet;
-                bool firstIteration = true;
-                Point3d lastIntersectPt = originPt;
+        Facet lastIntersectedFacet;
+        bool firstIteration = true;
+        Point3d lastIntersectPt = originPt;
 
-                // While we are within the surface margin defined by maxDist (as long as we find a next geometry)
-                while ((lastIntersectPt - originPt).size() <= nsigmaBackSilentPart * maxDist)
-                {
-                    // Keep previous informations
-                    const GeometryIntersection previousGeometry = geometry;
-                    lastIntersectPt = intersectPt;
+        // While we are within the surface margin defined by maxDist (as long as we find a next geometry)
+        while ((lastIntersectPt - originPt).size() <= nsigmaBackSilentPart * maxDist)
+        {
+            // Keep previous informations
+            const GeometryIntersection previousGeometry = geometry;
+            lastIntersectPt = intersectPt;
 
 
-                    geometry = marching.intersectNextGeom();
+            geometry = marching.intersectNextGeom();
 
-                    Eigen::Vector3d eintersectPt = marching.getIntersectionPoint();
-                    intersectPt.x = eintersectPt.x();
-                    intersectPt.y = eintersectPt.y();
-                    intersectPt.z = eintersectPt.z();
-                    
+            Eigen::Vector3d eintersectPt = marching.getIntersectionPoint();
+            intersectPt.x = eintersectPt.x();
+            intersectPt.y = eintersectPt.y();
+            intersectPt.z = eintersectPt.z();
+            
 
-                    if (geometry.type == EGeometryType::None)
-                    {
-                        break;
-                    }
+            if (geometry.type == EGeometryType::None)
+            {
+                break;
+            }
 
-                   
-                    if (geometry.type == EGeometryType::Facet)
-                    {
-                        GeometryIntersection previousGeometry = marching.getPreviousIntersection();
+           
+            if (geometry.type == EGeometryType::Facet)
+            {
+                GeometryIntersection previousGeometry = marching.getPreviousIntersection();
 
-                        // Vote for the first cell found (only once)
-                        if (firstIteration)
-                        {
-                            midSilent = _cellsAttr[previousGeometry.facet.cellIndex].emptinessScore;
-                            firstIteration = false;
-                        }
+                // Vote for the first cell found (only once)
+                if (firstIteration)
+                {
+                    midSilent = _cellsAttr[previousGeometry.facet.cellIndex].emptinessScore;
+                    firstIteration = false;
+                }
 
-                        const GC_cellInfo& c = _cellsAttr[previousGeometry.facet.cellIndex];
-                        maxSilent = std::max(maxSilent, c.emptinessScore);
+                const GC_cellInfo& c = _cellsAttr[previousGeometry.facet.cellIndex];
+                maxSilent = std::max(maxSilent, c.emptinessScore);
 
-                        lastIntersectedFacet = geometry.facet;
-                    }
-                    else
+                lastIntersectedFacet = geometry.facet;
+            }
+            else
+            {
+                // Vote for the first cell found (only once)
+                // if we come from an edge or vertex to an other we have to vote for the first intersected cell.
+                if (firstIteration)
+                {
+                    if (previousGeometry.type != EGeometryType::Vertex)
                     {
-                        // Vote for the first cell found (only once)
-                        // if we come from an edge or vertex to an other we have to vote for the first intersected cell.
-                        if (firstIteration)
-                        {
-                            if (previousGeometry.type != EGeometryType::Vertex)
-                            {
-                                ALICEVISION_LOG_ERROR("The firstIteration vote could only happen during for "
-                                                      "the first cell when we come from the first vertex.");
-                                // throw std::runtime_error("[error] The firstIteration vote could only happen during for the first cell when we come
-                                // from the first vertex.");
-                            }
-                            // the information of first intersected cell can only be found by taking intersection of neighbouring cells for both
-                            // geometries
-                            const std::vector<CellIndex> previousNeighbouring = _tetrahedralization.getNeighboringCellsByVertexIndex(previousGeometry.vertexIndex);
-                            const std::vector<CellIndex> currentNeigbouring = getNeighboringCellsByGeometry(geometry);
-
-                            std::vector<CellIndex> neighboringCells;
-                            std::set_intersection(previousNeighbouring.begin(),
-                                                  previousNeighbouring.end(),
-                                                  currentNeigbouring.begin(),
-                                                  currentNeigbouring.end(),
-                                                  std::back_inserter(neighboringCells));
-
-                            for (const CellIndex& ci : neighboringCells)
-                            {
-                                midSilent = _cellsAttr[geometry.facet.cellIndex].emptinessScore;
-                            }
-                            firstIteration = false;
-                        }
-
+                        ALICEVISION_LOG_ERROR("The firstIteration vote could only happen during for "
+                                              "the first cell when we come from the first vertex.");
+                        // throw std::runtime_error("[error] The firstIteration vote could only happen during for the first cell when we come
+                        // from the first vertex.");
                     }
-                }
-
-                if (lastIntersectedFacet.cellIndex != GEO::NO_CELL)
-                {
-                    // Equation 6 in paper
-                    //   (g / B) < k_rel
-                    //   (B - g) > k_abs
-                    //   g < k_outl
-
-                    // In the paper:
-                    // B (beta): max value before point p
-                    // g (gamma): mid-range score behind point p
-
-                    // In the code:
-                    // maxJump: max score of emptiness in all the tetrahedron along the line of sight between camera c and 2*sigma before p
-                    // midSilent: score of the next tetrahedron directly after p (called T1 in the paper)
-                    // maxSilent: max score of emptiness for the tetrahedron around the point p (+/- 2*sigma around p)
-
-                    if ((midSilent / maxJump < forceTEdgeDelta) &&   // (g / B) < k_rel    //// k_rel=0.1
-                        (maxJump - midSilent > minJumpPartRange) &&  // (B - g) > k_abs   //// k_abs=10000 // 1000 in the paper
-                        (maxSilent < maxSilentPartRange))            // g < k_outl                  //// k_outl=100  // 400 in the paper
-                                                                     //(maxSilent-minSilent<maxSilentPartRange))
+                    // the information of first intersected cell can only be found by taking intersection of neighbouring cells for both
+                    // geometries
+                    const std::vector<CellIndex> previousNeighbouring = _tetrahedralization.getNeighboringCellsByVertexIndex(previousGeometry.vertexIndex);
+                    const std::vector<CellIndex> currentNeigbouring = getNeighboringCellsByGeometry(geometry);
+
+                    std::vector<CellIndex> neighboringCells;
+                    std::set_intersection(previousNeighbouring.begin(),
+                                          previousNeighbouring.end(),
+                                          currentNeigbouring.begin(),
+                                          currentNeigbouring.end(),
+                                          std::back_inserter(neighboringCells));
+
+                    for (const CellIndex& ci : neighboringCells)
                     {
-                        boost::atomic_ref<float>{_cellsAttr[lastIntersectedFacet.cellIndex].on} += (maxJump - midSilent);
+                        midSilent = _cellsAttr[geometry.facet.cellIndex].emptinessScore;
                     }
+                    firstIteration = false;
                 }
+
+            }
+        }
+
+        if (lastIntersectedFacet.cellIndex != GEO::NO_CELL)
+        {
+            // Equation 6 in paper
+            //   (g / B) < k_rel
+            //   (B - g) > k_abs
+            //   g < k_outl
+
+            // In the paper:
+            // B (beta): max value before point p
+            // g (gamma): mid-range score behind point p
+
+            // In the code:
+            // maxJump: max score of emptiness in all the tetrahedron along the line of sight between camera c and 2*sigma before p
+            // midSilent: score of the next tetrahedron directly after p (called T1 in the paper)
+            // maxSilent: max score of emptiness for the tetrahedron around the point p (+/- 2*sigma around p)
+
+            if ((midSilent / maxJump < forceTEdgeDelta) &&   // (g / B) < k_rel    //// k_rel=0.1
+                (maxJump - midSilent > minJumpPartRange) &&  // (B - g) > k_abs   //// k_abs=10000 // 1000 in the paper
+                (maxSilent < maxSilentPartRange))            // g < k_outl                  //// k_outl=100  // 400 in the paper
+                                                             //(maxSilent-minSilent<maxSilentPartRange))
+            {
+                weights.addOn(lastIntersectedFacet.cellIndex, maxJump - midSilent);
             }
         }
     }
+}
+
+void GraphFiller::forceTedgesByGradientIJCV(const std::vector<Ray>& rays, float nPixelSizeBehind)
+{
+    marchRays(rays, [&](const Ray& ray, auto& weights) { forceTedgeByGradientIJCV(ray.vertexIndex, ray.cam, nPixelSizeBehind, weights); });
 
     for (GC_cellInfo& c : _cellsAttr)
     {
@@ -476,11 +600,29 @@ std::vector<CellIndex> GraphFiller::getNeighboringCellsByGeometry(const Geometry
     throw std::runtime_error("[error] getNeighboringCellsByGeometry: an undefined/None geometry has no neighboring cells.");
 }
 
-void GraphFiller::binarize()
+void GraphFiller::binarize(EMaxFlowSolver solver)
+{
+    ALICEVISION_LOG_INFO("Graph cut with max flow solver: " << solver);
+
+    switch (solver)
+    {
+        case EMaxFlowSolver::BoykovKolmogorov:
+            binarizeWith<MaxFlow_AdjList>();
+            break;
+        case EMaxFlowSolver::PushRelabel:
+            binarizeWith<MaxFlow_CSR>();
+            break;
+    }
+}
+
+template<typename MaxFlowGraph>
+void GraphFiller::binarizeWith()
 {
     const std::size_t nbCells = _cellsAttr.size();
 
-    MaxFlow_AdjList maxFlowGraph(nbCells);
+    system::Timer timer;
+
+    MaxFlowGraph maxFlowGraph(nbCells);
 
     // fill s-t edges
     for (CellIndex ci = 0; ci < nbCells; ++ci)
@@ -528,9 +670,16 @@ void GraphFiller::binarize()
     //Clear graph
     _cellsAttr.clear();
 
+    ALICEVISION_LOG_INFO("Max flow graph filled in " << timer.elapsed() << " s (memory: "
+                         << (maxFlowGraph.getMemoryConsumption() / (1024.0 * 1024.0)) << " MB).");
+    timer.reset();
+
     // Find graph-cut solution
     const float totalFlow = maxFlowGraph.compute();
 
+    ALICEVISION_LOG_INFO("Max flow solved in " << timer.elapsed() << " s (flow: " << totalFlow << ", memory: "
+                         << (maxFlowGraph.getMemoryConsumption() / (1024.0 * 1024.0)) << " MB).");
+
     _cellIsFull.resize(nbCells);
     std::size_t nbFullCells = 0;
     for (CellIndex ci = 0; ci < nbCells; ++ci)
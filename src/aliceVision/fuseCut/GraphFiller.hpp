@@ -11,10 +11,27 @@
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 #include <aliceVision/fuseCut/Intersections.hpp>
 
+#include <iostream>
+#include <string>
+
 
 namespace aliceVision {
 namespace fuseCut {
 
+/**
+ * @brief Max flow solver used for the graph cut
+ */
+enum class EMaxFlowSolver
+{
+    BoykovKolmogorov = 0,  //< boost Boykov-Kolmogorov on an adjacency list (single-threaded)
+    PushRelabel = 1        //< parallel push-relabel on a CSR graph
+};
+
+EMaxFlowSolver EMaxFlowSolver_stringToEnum(const std::string& solver);
+std::string EMaxFlowSolver_enumToString(EMaxFlowSolver solver);
+std::istream& operator>>(std::istream& in, EMaxFlowSolver& solver);
+std::ostream& operator<<(std::ostream& os, EMaxFlowSolver solver);
+
 class GraphFiller
 {
 public:
@@ -32,16 +49,50 @@ public:
         return _cellIsFull;
     }
 
-    void binarize();
+    void binarize(EMaxFlowSolver solver = EMaxFlowSolver::BoykovKolmogorov);
 
 private:
+    template<typename MaxFlowGraph>
+    void binarizeWith();
+
     void initCells();
     void addToInfiniteSw(float sW);
 
-    void fillGraph(double nPixelSizeBehind, float fullWeight);
-    void rayMarchingGraphEmpty(int vertexIndex, int cam, float weight);
-    void rayMarchingGraphFull(int vertexIndex, int cam, float fullWeight, double nPixelSizeBehind);
-    void forceTedgesByGradientIJCV(float nPixelSizeBehind);
+    /**
+     * @brief Line of sight from a vertex to a camera which has visibility over it
+     */
+    struct Ray
+    {
+        int vertexIndex;
+        int cam;
+    };
+
+    /**
+     * @brief Get the rays of all the vertices.
+     * @param[in] sortByStartingCell sort rays by the first neighboring cell of the vertex, random vertices order otherwise
+     * @return the rays, rays of the same vertex are contiguous
+     */
+    std::vector<Ray> getRays(bool sortByStartingCell) const;
+
+    /**
+     * @brief March the rays in parallel and accumulate the cell weights.
+     * @note In batched accumulation mode, contributions are recorded in thread-local buffers
+     *       and reduced per cell range after each batch of rays, without atomic operations.
+     *       Otherwise, contributions are accumulated with an atomic operation per cell weight.
+     * @param[in] rays the rays to march
+     * @param[in] rayFunction the ray function, called with a Ray and a cell weights accumulator
+     */
+    template<typename RayFunction>
+    void marchRays(const std::vector<Ray>& rays, RayFunction rayFunction);
+
+    void fillGraph(const std::vector<Ray>& rays, double nPixelSizeBehind, float fullWeight);
+    template<typename CellWeights>
+    void rayMarchingGraphEmpty(int vertexIndex, int cam, float weight, CellWeights& weights);
+    template<typename CellWeights>
+    void rayMarchingGraphFull(int vertexIndex, int cam, float fullWeight, double nPixelSizeBehind, CellWeights& weights);
+    void forceTedgesByGradientIJCV(const std::vector<Ray>& rays, float nPixelSizeBehind);
+    template<typename CellWeights>
+    void forceTedgeByGradientIJCV(int vertexIndex, int cam, float nPixelSizeBehind, CellWeights& weights);
     
     std::vector<CellIndex> getNeighboringCellsByGeometry(const GeometryIntersection& g) const;
 
@@ -55,6 +106,8 @@ private:
     mvsUtils::MultiViewParams& _mp;
     std::vector<GC_cellInfo> _cellsAttr;
     std::vector<bool> _cellIsFull;
+    bool _batchedAccumulation = true;  //< thread-local accumulation of the cell weights, atomic accumulation otherwise
+    int _rayBatchSize = 65536;         //< number of rays marched between two reductions in batched accumulation mode
 };
 
 }
@@ -46,6 +46,20 @@ void MaxFlow_AdjList::printStats() const
     }
 }
 
+std::size_t MaxFlow_AdjList::getMemoryConsumption() const
+{
+    using StoredVertex = typename decltype(_graph.m_vertices)::value_type;
+    using StoredEdge = typename decltype(StoredVertex().m_out_edges)::value_type;
+
+    // vertices, out edges and edge properties (allocated per edge)
+    std::size_t bytes = _graph.m_vertices.capacity() * sizeof(StoredVertex);
+    for (const StoredVertex& v : _graph.m_vertices)
+        bytes += v.m_out_edges.capacity() * sizeof(StoredEdge) + v.m_out_edges.size() * sizeof(Edge);
+
+    bytes += _color.capacity() * sizeof(boost::default_color_type);
+    return bytes;
+}
+
 void MaxFlow_AdjList::printColorStats() const
 {
     std::map<int, int> histColor;
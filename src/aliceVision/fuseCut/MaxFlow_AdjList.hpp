@@ -110,6 +110,12 @@ class MaxFlow_AdjList
     void printStats() const;
     void printColorStats() const;
 
+    /**
+     * @brief Get the graph memory consumption (approximation).
+     * @return memory consumption (in bytes)
+     */
+    std::size_t getMemoryConsumption() const;
+
     inline ValueType compute()
     {
         printStats();
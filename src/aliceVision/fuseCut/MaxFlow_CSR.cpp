@@ -0,0 +1,393 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MaxFlow_CSR.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace aliceVision {
+namespace fuseCut {
+
+namespace {
+
+inline void atomicAdd(std::atomic<MaxFlow_CSR::ValueType>& a, MaxFlow_CSR::ValueType value)
+{
+    MaxFlow_CSR::ValueType previous = a.load(std::memory_order_relaxed);
+    while (!a.compare_exchange_weak(previous, previous + value, std::memory_order_relaxed))
+    {
+    }
+}
+
+}  // namespace
+
+void MaxFlow_CSR::printStats() const
+{
+    ALICEVISION_LOG_INFO("# vertices: " << _nbNodes << ", # arcs: " << ((_heads.empty()) ? (2 * _edges.size()) : _heads.size())
+                                        << ", memory: " << (getMemoryConsumption() / (1024.0 * 1024.0)) << " MB");
+}
+
+std::size_t MaxFlow_CSR::getMemoryConsumption() const
+{
+    std::size_t bytes = 0;
+    bytes += _edges.capacity() * sizeof(Edge);
+    bytes += _offsets.capacity() * sizeof(ArcIndex);
+    bytes += _heads.capacity() * sizeof(NodeType);
+    bytes += _reverse.capacity() * sizeof(ArcIndex);
+    bytes += _residual.capacity() * sizeof(ValueType);
+    bytes += _excess.capacity() * sizeof(ValueType);
+    bytes += _terminalCapacity.capacity() * sizeof(ValueType);
+    bytes += _isSource.capacity() * sizeof(unsigned char);
+    return bytes;
+}
+
+void MaxFlow_CSR::buildCSR()
+{
+    // count arcs per node
+    _offsets.assign(std::size_t(_nbNodes) + 1, 0);
+    for (const Edge& e : _edges)
+    {
+        ++_offsets[e.n1 + 1];
+        ++_offsets[e.n2 + 1];
+    }
+    for (NodeType n = 0; n < _nbNodes; ++n)
+        _offsets[n + 1] += _offsets[n];
+
+    const ArcIndex nbArcs = _offsets.back();
+    _heads.resize(nbArcs);
+    _reverse.resize(nbArcs);
+    _residual.resize(nbArcs);
+
+    // fill arcs, reverse problem: arc n1->n2 gets the n2->n1 capacity
+    std::vector<ArcIndex> cursor(_offsets.begin(), _offsets.end() - 1);
+    for (const Edge& e : _edges)
+    {
+        const ArcIndex a = cursor[e.n1]++;
+        const ArcIndex b = cursor[e.n2]++;
+
+        _heads[a] = e.n2;
+        _heads[b] = e.n1;
+        _reverse[a] = b;
+        _reverse[b] = a;
+        _residual[a] = e.reverseCapacity;
+        _residual[b] = e.capacity;
+    }
+
+    // release the edge list
+    std::vector<Edge>().swap(_edges);
+}
+
+void MaxFlow_CSR::globalRelabel(std::vector<std::atomic<int>>& labels) const
+{
+    std::vector<NodeType> frontier;
+
+    // first level: nodes connected to the sink
+#pragma omp parallel
+    {
+        std::vector<NodeType> localFrontier;
+
+#pragma omp for
+        for (NodeType v = 0; v < _nbNodes; ++v)
+        {
+            if (_terminalCapacity[v] > 0)
+            {
+                labels[v].store(1, std::memory_order_relaxed);
+                localFrontier.push_back(v);
+            }
+            else
+            {
+                labels[v].store(unreachableLabel(), std::memory_order_relaxed);
+            }
+        }
+
+#pragma omp critical
+        frontier.insert(frontier.end(), localFrontier.begin(), localFrontier.end());
+    }
+
+    // breadth-first search on the reverse residual graph
+    int level = 1;
+    while (!frontier.empty())
+    {
+        std::vector<NodeType> nextFrontier;
+
+#pragma omp parallel
+        {
+            std::vector<NodeType> localFrontier;
+
+#pragma omp for schedule(dynamic, 1024)
+            for (int i = 0; i < int(frontier.size()); ++i)
+            {
+                const NodeType w = frontier[i];
+
+                for (ArcIndex a = _offsets[w]; a < _offsets[w + 1]; ++a)
+                {
+                    const NodeType u = _heads[a];
+
+                    // u can push to w
+                    if (_residual[_reverse[a]] <= 0 || labels[u].load(std::memory_order_relaxed) != unreachableLabel())
+                        continue;
+
+                    int expected = unreachableLabel();
+                    if (labels[u].compare_exchange_strong(expected, level + 1, std::memory_order_relaxed))
+                        localFrontier.push_back(u);
+                }
+            }
+
+#pragma omp critical
+            nextFrontier.insert(nextFrontier.end(), localFrontier.begin(), localFrontier.end());
+        }
+
+        frontier.swap(nextFrontier);
+        ++level;
+    }
+}
+
+void MaxFlow_CSR::discharge(NodeType v,
+                            const std::vector<std::atomic<int>>& labels,
+                            std::vector<std::atomic<ValueType>>& incomingExcess,
+                            std::vector<std::atomic<char>>& isCandidate,
+                            std::vector<NodeType>& candidates,
+                            double& flow)
+{
+    ValueType excess = _excess[v];
+    const int label = labels[v].load(std::memory_order_relaxed);
+
+    // push to the sink
+    if (label == 1 && _terminalCapacity[v] > 0)
+    {
+        const ValueType delta = std::min(excess, _terminalCapacity[v]);
+        _terminalCapacity[v] = (delta == _terminalCapacity[v]) ? 0.f : (_terminalCapacity[v] - delta);
+        excess = (delta == excess) ? 0.f : (excess - delta);
+        flow += delta;
+    }
+
+    // push to neighbor nodes
+    for (ArcIndex a = _offsets[v]; a < _offsets[v + 1] && excess > 0; ++a)
+    {
+        const NodeType w = _heads[a];
+
+        // check the label first: the reverse arc can be read only by an admissible node
+        if (labels[w].load(std::memory_order_relaxed) != label - 1)
+            continue;
+
+        const ValueType residual = _residual[a];
+        if (residual <= 0)
+            continue;
+
+        ValueType delta;
+        if (excess < residual)
+        {
+            delta = excess;
+            _residual[a] = residual - excess;
+            excess = 0.f;
+        }
+        else
+        {
+            delta = residual;
+            _residual[a] = 0.f;
+            excess -= residual;
+        }
+
+        _residual[_reverse[a]] += delta;
+        atomicAdd(incomingExcess[w], delta);
+
+        if (isCandidate[w].exchange(1, std::memory_order_relaxed) == 0)
+            candidates.push_back(w);
+    }
+
+    _excess[v] = excess;
+}
+
+int MaxFlow_CSR::relabel(NodeType v, const std::vector<std::atomic<int>>& labels) const
+{
+    if (_terminalCapacity[v] > 0)
+        return 1;
+
+    int newLabel = unreachableLabel();
+
+    for (ArcIndex a = _offsets[v]; a < _offsets[v + 1]; ++a)
+    {
+        if (_residual[a] > 0)
+            newLabel = std::min(newLabel, labels[_heads[a]].load(std::memory_order_relaxed) + 1);
+    }
+
+    return newLabel;
+}
+
+MaxFlow_CSR::ValueType MaxFlow_CSR::compute()
+{
+    system::Timer timer;
+
+    buildCSR();
+    printStats();
+
+    ALICEVISION_LOG_INFO("Build CSR graph done in " << timer.elapsed() << " s.");
+    ALICEVISION_LOG_INFO("Compute parallel push-relabel max flow.");
+
+    timer.reset();
+
+    const ArcIndex nbArcs = _heads.size();
+
+    std::vector<std::atomic<int>> labels(_nbNodes);
+    std::vector<std::atomic<ValueType>> incomingExcess(_nbNodes);
+    std::vector<std::atomic<char>> isCandidate(_nbNodes);
+
+#pragma omp parallel for
+    for (NodeType v = 0; v < _nbNodes; ++v)
+    {
+        incomingExcess[v].store(0.f, std::memory_order_relaxed);
+        isCandidate[v].store(0, std::memory_order_relaxed);
+    }
+
+    // work between two global relabels (relabel operations cost)
+    const std::int64_t globalRelabelWork = (6 * std::int64_t(_nbNodes) + std::int64_t(nbArcs)) / 2;
+    std::int64_t work = 0;
+    int nbRounds = 0;
+    int nbGlobalRelabels = 0;
+    double flow = 0.0;
+
+    std::vector<NodeType> active;
+    std::vector<int> newLabels;
+
+    const auto globalRelabelAndActivate = [&]() {
+        globalRelabel(labels);
+        ++nbGlobalRelabels;
+        work = 0;
+
+        active.clear();
+
+#pragma omp parallel
+        {
+            std::vector<NodeType> localActive;
+
+#pragma omp for
+            for (NodeType v = 0; v < _nbNodes; ++v)
+            {
+                if (_excess[v] > 0 && labels[v].load(std::memory_order_relaxed) < unreachableLabel())
+                    localActive.push_back(v);
+            }
+
+#pragma omp critical
+            active.insert(active.end(), localActive.begin(), localActive.end());
+        }
+    };
+
+    globalRelabelAndActivate();
+
+    while (!active.empty())
+    {
+        ++nbRounds;
+
+        const int nbActive = int(active.size());
+        std::vector<NodeType> candidates;
+
+        // push phase, labels are frozen
+#pragma omp parallel
+        {
+            std::vector<NodeType> localCandidates;
+            double localFlow = 0.0;
+
+#pragma omp for schedule(dynamic, 64)
+            for (int i = 0; i < nbActive; ++i)
+                discharge(active[i], labels, incomingExcess, isCandidate, localCandidates, localFlow);
+
+#pragma omp critical
+            {
+                candidates.insert(candidates.end(), localCandidates.begin(), localCandidates.end());
+                flow += localFlow;
+            }
+        }
+
+        // relabel phase, new labels are computed from the frozen labels
+        newLabels.resize(nbActive);
+        std::int64_t roundWork = 0;
+
+#pragma omp parallel for schedule(dynamic, 64) reduction(+ : roundWork)
+        for (int i = 0; i < nbActive; ++i)
+        {
+            const NodeType v = active[i];
+
+            if (_excess[v] > 0)
+            {
+                newLabels[i] = relabel(v, labels);
+                roundWork += std::int64_t(_offsets[v + 1] - _offsets[v]) + 12;
+            }
+            else
+            {
+                newLabels[i] = labels[v].load(std::memory_order_relaxed);
+            }
+        }
+
+        // apply new labels, nodes with remaining excess are still candidates
+#pragma omp parallel
+        {
+            std::vector<NodeType> localCandidates;
+
+#pragma omp for
+            for (int i = 0; i < nbActive; ++i)
+            {
+                const NodeType v = active[i];
+                labels[v].store(newLabels[i], std::memory_order_relaxed);
+
+                if (_excess[v] > 0 && isCandidate[v].exchange(1, std::memory_order_relaxed) == 0)
+                    localCandidates.push_back(v);
+            }
+
+#pragma omp critical
+            candidates.insert(candidates.end(), localCandidates.begin(), localCandidates.end());
+        }
+
+        // add pushed excess and build the next active nodes
+        active.clear();
+
+#pragma omp parallel
+        {
+            std::vector<NodeType> localActive;
+
+#pragma omp for
+            for (int i = 0; i < int(candidates.size()); ++i)
+            {
+                const NodeType v = candidates[i];
+
+                _excess[v] += incomingExcess[v].exchange(0.f, std::memory_order_relaxed);
+                isCandidate[v].store(0, std::memory_order_relaxed);
+
+                if (_excess[v] > 0 && labels[v].load(std::memory_order_relaxed) < unreachableLabel())
+                    localActive.push_back(v);
+            }
+
+#pragma omp critical
+            active.insert(active.end(), localActive.begin(), localActive.end());
+        }
+
+        work += roundWork;
+        if (work > globalRelabelWork)
+            globalRelabelAndActivate();
+    }
+
+    // the nodes that can still reach the sink of the reverse problem
+    // are the nodes reachable from the source of the original problem
+    globalRelabel(labels);
+
+    _isSource.resize(_nbNodes);
+
+#pragma omp parallel for
+    for (NodeType v = 0; v < _nbNodes; ++v)
+        _isSource[v] = (labels[v].load(std::memory_order_relaxed) < unreachableLabel()) ? 1 : 0;
+
+    ALICEVISION_LOG_INFO("Parallel push-relabel max flow done in " << timer.elapsed() << " s:" << std::endl
+                                                                    << "\t- # rounds: " << nbRounds << std::endl
+                                                                    << "\t- # global relabels: " << nbGlobalRelabels << std::endl
+                                                                    << "\t- flow: " << flow);
+
+    return ValueType(flow);
+}
+
+}  // namespace fuseCut
+}  // namespace aliceVision
@@ -0,0 +1,130 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @brief Maxflow computation based on a Compressed Sparse Row graph representation
+ *        with a parallel (synchronous) push-relabel solver.
+ *
+ * Same interface and same cut as MaxFlow_AdjList:
+ * isSource() is true for the nodes reachable from the source in the final residual graph.
+ *
+ * Edges are accumulated with addNode/addEdge, the CSR graph is built at the beginning of compute().
+ * Source/sink edges are not stored as arcs: they are stored as a node excess or a node sink capacity.
+ *
+ * @see MaxFlow_AdjList which uses the single-threaded boost Boykov-Kolmogorov solver.
+ */
+class MaxFlow_CSR
+{
+  public:
+    using NodeType = int;
+    using ValueType = float;
+    using ArcIndex = std::size_t;
+
+  public:
+    explicit MaxFlow_CSR(size_t numNodes)
+      : _nbNodes(NodeType(numNodes)),
+        _excess(numNodes, 0.f),
+        _terminalCapacity(numNodes, 0.f)
+    {
+        _edges.reserve(numNodes * 4);
+    }
+
+    inline void addNode(NodeType n, ValueType source, ValueType sink)
+    {
+        assert(source >= 0 && sink >= 0);
+
+        // note: the solver works on the reverse problem (source and sink swapped, arcs reversed)
+        //       so that the nodes connected to the (original) sink at the end are those reachable from the source.
+        const ValueType score = source - sink;
+        if (score > 0)
+            _terminalCapacity[n] = score;
+        else
+            _excess[n] = -score;
+    }
+
+    inline void addEdge(NodeType n1, NodeType n2, ValueType capacity, ValueType reverseCapacity)
+    {
+        assert(capacity >= 0 && reverseCapacity >= 0);
+        _edges.push_back({n1, n2, capacity, reverseCapacity});
+    }
+
+    void printStats() const;
+
+    /**
+     * @brief Build the CSR graph and compute the maximum flow.
+     * @return the maximum flow value
+     */
+    ValueType compute();
+
+    /**
+     * @brief Get the graph memory consumption.
+     * @return memory consumption (in bytes)
+     */
+    std::size_t getMemoryConsumption() const;
+
+    /// is empty
+    inline bool isSource(NodeType n) const { return _isSource[n] != 0; }
+    /// is full
+    inline bool isTarget(NodeType n) const { return _isSource[n] == 0; }
+
+  private:
+    struct Edge
+    {
+        NodeType n1;
+        NodeType n2;
+        ValueType capacity;
+        ValueType reverseCapacity;
+    };
+
+    /// build CSR arrays from the edge list
+    void buildCSR();
+
+    /**
+     * @brief Compute exact distance labels to the sink with a parallel breadth-first search.
+     * @note Nodes that cannot reach the sink get the label unreachableLabel().
+     */
+    void globalRelabel(std::vector<std::atomic<int>>& labels) const;
+
+    /// label of the nodes that cannot reach the sink (a path to the sink goes through at most _nbNodes nodes)
+    inline int unreachableLabel() const { return _nbNodes + 1; }
+
+    /**
+     * @brief Push the node excess along admissible arcs.
+     * @note Labels are frozen during the push phase, an arc pair is modified by a single node.
+     */
+    void discharge(NodeType v,
+                   const std::vector<std::atomic<int>>& labels,
+                   std::vector<std::atomic<ValueType>>& incomingExcess,
+                   std::vector<std::atomic<char>>& isCandidate,
+                   std::vector<NodeType>& candidates,
+                   double& flow);
+
+    /// compute the node new label from the frozen labels
+    int relabel(NodeType v, const std::vector<std::atomic<int>>& labels) const;
+
+    const NodeType _nbNodes;
+    std::vector<Edge> _edges;               //< edge list, released when the CSR graph is built
+    std::vector<ArcIndex> _offsets;         //< node first arc
+    std::vector<NodeType> _heads;           //< arc head node
+    std::vector<ArcIndex> _reverse;         //< arc reverse arc
+    std::vector<ValueType> _residual;       //< arc residual capacity
+    std::vector<ValueType> _excess;         //< node excess
+    std::vector<ValueType> _terminalCapacity;  //< node residual capacity to the sink
+    std::vector<unsigned char> _isSource;   //< node cut side
+};
+
+}  // namespace fuseCut
+}  // namespace aliceVision
@@ -0,0 +1,168 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/MaxFlow_AdjList.hpp>
+#include <aliceVision/fuseCut/MaxFlow_CSR.hpp>
+
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_MODULE fuseCutMaxFlow
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+namespace {
+
+struct RandomGraph
+{
+    struct TerminalEdges
+    {
+        int node;
+        float source;
+        float sink;
+    };
+
+    struct Edge
+    {
+        int n1;
+        int n2;
+        float capacity;
+        float reverseCapacity;
+    };
+
+    int nbNodes = 0;
+    std::vector<TerminalEdges> terminals;
+    std::vector<Edge> edges;
+};
+
+/**
+ * @brief Generate a random graph with integer capacities (exact float flow sums).
+ *        Some nodes only have terminal edges, some capacities are zero.
+ */
+RandomGraph generateRandomGraph(std::mt19937& generator, int nbNodes, int nbEdgesPerNode)
+{
+    std::uniform_int_distribution<int> nodeDistribution(0, nbNodes - 1);
+    std::uniform_int_distribution<int> capacityDistribution(0, 10);
+    std::uniform_int_distribution<int> caseDistribution(0, 9);
+
+    RandomGraph graph;
+    graph.nbNodes = nbNodes;
+
+    for (int n = 0; n < nbNodes; ++n)
+    {
+        const int terminalCase = caseDistribution(generator);
+        if (terminalCase == 0)
+            continue;  // no terminal edge
+        if (terminalCase == 1)
+            graph.terminals.push_back({n, 0.f, 0.f});  // zero capacity terminal edges
+        else
+            graph.terminals.push_back({n, float(capacityDistribution(generator)), float(capacityDistribution(generator))});
+    }
+
+    for (int n = 0; n < nbNodes; ++n)
+    {
+        // terminal-only nodes
+        if (caseDistribution(generator) < 2)
+            continue;
+
+        for (int i = 0; i < nbEdgesPerNode; ++i)
+        {
+            const int n2 = nodeDistribution(generator);
+            if (n2 == n)
+                continue;
+
+            // one or both capacities may be zero
+            graph.edges.push_back({n, n2, float(capacityDistribution(generator)), float(capacityDistribution(generator))});
+        }
+    }
+    return graph;
+}
+
+template<class MaxFlow>
+float computeMaxFlow(const RandomGraph& graph, std::vector<bool>& isSource)
+{
+    MaxFlow maxFlow(graph.nbNodes);
+
+    for (const auto& t : graph.terminals)
+        maxFlow.addNode(t.node, t.source, t.sink);
+    for (const auto& e : graph.edges)
+        maxFlow.addEdge(e.n1, e.n2, e.capacity, e.reverseCapacity);
+
+    const float flow = maxFlow.compute();
+
+    isSource.resize(graph.nbNodes);
+    for (int n = 0; n < graph.nbNodes; ++n)
+        isSource[n] = maxFlow.isSource(n);
+
+    return flow;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(fuseCut_maxFlowCSR_randomGraphs)
+{
+    std::mt19937 generator(42);
+
+    const std::vector<int> nbNodesList = {1, 2, 5, 20, 100, 1000, 5000};
+    const std::vector<int> nbEdgesPerNodeList = {0, 1, 3, 8};
+
+    for (const int nbNodes : nbNodesList)
+    {
+        for (const int nbEdgesPerNode : nbEdgesPerNodeList)
+        {
+            for (int trial = 0; trial < 5; ++trial)
+            {
+                const RandomGraph graph = generateRandomGraph(generator, nbNodes, nbEdgesPerNode);
+
+                std::vector<bool> isSourceAdjList;
+                std::vector<bool> isSourceCSR;
+                const float flowAdjList = computeMaxFlow<MaxFlow_AdjList>(graph, isSourceAdjList);
+                const float flowCSR = computeMaxFlow<MaxFlow_CSR>(graph, isSourceCSR);
+
+                BOOST_TEST_CONTEXT("nbNodes: " << nbNodes << ", nbEdgesPerNode: " << nbEdgesPerNode << ", trial: " << trial)
+                {
+                    // integer capacities: the flow values are exact
+                    BOOST_CHECK_EQUAL(flowCSR, flowAdjList);
+
+                    // both solvers return the minimal source side of the cut (the nodes reachable from the source),
+                    // which is unique
+                    int nbDifferentNodes = 0;
+                    for (int n = 0; n < nbNodes; ++n)
+                        nbDifferentNodes += (isSourceCSR[n] != isSourceAdjList[n]) ? 1 : 0;
+                    BOOST_CHECK_EQUAL(nbDifferentNodes, 0);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_maxFlowCSR_terminalOnly)
+{
+    // no edge between nodes: each node is cut on its weakest terminal edge
+    RandomGraph graph;
+    graph.nbNodes = 4;
+    graph.terminals = {{0, 3.f, 1.f}, {1, 1.f, 3.f}, {2, 0.f, 0.f}, {3, 2.f, 2.f}};
+
+    std::vector<bool> isSourceAdjList;
+    std::vector<bool> isSourceCSR;
+    const float flowAdjList = computeMaxFlow<MaxFlow_AdjList>(graph, isSourceAdjList);
+    const float flowCSR = computeMaxFlow<MaxFlow_CSR>(graph, isSourceCSR);
+
+    // terminal edges are merged into a single edge of capacity |source - sink|: no flow
+    BOOST_CHECK_EQUAL(flowAdjList, 0.f);
+    BOOST_CHECK_EQUAL(flowCSR, 0.f);
+
+    for (int n = 0; n < graph.nbNodes; ++n)
+        BOOST_CHECK_EQUAL(isSourceCSR[n], isSourceAdjList[n]);
+
+    BOOST_CHECK(isSourceCSR[0]);
+    BOOST_CHECK(!isSourceCSR[1]);
+    BOOST_CHECK(!isSourceCSR[2]);
+    BOOST_CHECK(!isSourceCSR[3]);
+}
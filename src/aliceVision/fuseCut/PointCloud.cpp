@@ -15,6 +15,8 @@
 #include <aliceVision/mvsData/geometry.hpp>
 
 #include <aliceVision/fuseCut/Kdtree.hpp>
+#include <aliceVision/fuseCut/PointGrid.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <geogram/mesh/mesh.h>
 #include <geogram/basic/geometry_nd.h>
@@ -25,40 +27,56 @@ namespace fuseCut {
 namespace fs = std::filesystem;
 
 /// Filter by pixSize
+/// A point is removed if there is a point with a smaller pixSize score in its pixSize radius.
 void filterByPixSize(const std::vector<Point3d>& verticesCoordsPrepare,
                      std::vector<double>& pixSizePrepare,
                      double pixSizeMarginCoef,
                      std::vector<float>& simScorePrepare)
 {
+    const int nbVertices = verticesCoordsPrepare.size();
 
-    ALICEVISION_LOG_INFO("Build nanoflann KdTree index.");
-    PointVectorAdaptator pointCloudRef(verticesCoordsPrepare);
-    KdTree kdTree(3 /*dim*/, pointCloudRef, nanoflann::KDTreeSingleIndexAdaptorParams(MAX_LEAF_ELEMENTS));
-    kdTree.buildIndex();
+    // scores are computed before the filtering, so the result does not depend on the points order
+    std::vector<double> pixSizeScores(nbVertices, 0.0);
+    std::vector<bool> isValid(nbVertices, false);
+    std::vector<double> radiuses;
+    radiuses.reserve(nbVertices);
 
-    ALICEVISION_LOG_INFO("KdTree created for " << verticesCoordsPrepare.size() << " points.");
-
-#pragma omp parallel for
-    for (int vIndex = 0; vIndex < verticesCoordsPrepare.size(); ++vIndex)
+    for (int vIndex = 0; vIndex < nbVertices; ++vIndex)
     {
         if (pixSizePrepare[vIndex] == -1.0)
-        {
             continue;
-        }
-        const double pixSizeScore = pixSizeMarginCoef * simScorePrepare[vIndex] * pixSizePrepare[vIndex] * pixSizePrepare[vIndex];
-        if (pixSizeScore < std::numeric_limits<double>::epsilon())
+
+        pixSizeScores[vIndex] = simScorePrepare[vIndex] * pixSizePrepare[vIndex] * pixSizePrepare[vIndex];
+        if (pixSizeMarginCoef * pixSizeScores[vIndex] < std::numeric_limits<double>::epsilon())
         {
             pixSizePrepare[vIndex] = -1.0;
             continue;
         }
+        isValid[vIndex] = true;
+        radiuses.push_back(std::sqrt(pixSizeMarginCoef * pixSizeScores[vIndex]));
+    }
 
+    if (radiuses.empty())
+        return;
 
-        static const nanoflann::SearchParameters searchParams(0.f, false);  // false: dont need to sort
-        SmallerPixSizeInRadius<double, std::size_t> resultSet(pixSizeScore, pixSizePrepare, simScorePrepare, vIndex);
-        kdTree.findNeighbors(resultSet, verticesCoordsPrepare[vIndex].m, searchParams);
-        if (resultSet.found)
-            pixSizePrepare[vIndex] = -1.0;
+    // grid cell size is the median search radius
+    std::nth_element(radiuses.begin(), radiuses.begin() + radiuses.size() / 2, radiuses.end());
+    const PointGrid grid(verticesCoordsPrepare, radiuses[radiuses.size() / 2], &isValid);
 
+    ALICEVISION_LOG_INFO("Point grid created for " << radiuses.size() << " points (" << grid.getNbCells() << " cells).");
+
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int vIndex = 0; vIndex < nbVertices; ++vIndex)
+    {
+        if (!isValid[vIndex])
+            continue;
+
+        const double pixSizeScore = pixSizeScores[vIndex];
+        const bool found = !grid.forEachPointInRadius(verticesCoordsPrepare[vIndex],
+                                                      std::sqrt(pixSizeMarginCoef * pixSizeScore),
+                                                      [&](int index, double) { return pixSizeScores[index] >= pixSizeScore; });
+        if (found)
+            pixSizePrepare[vIndex] = -1.0;
     }
     ALICEVISION_LOG_INFO("Filtering done.");
 }
@@ -128,109 +146,170 @@ void createVerticesWithVisibilities(const StaticVector<int>& cams,
                                     float contributeMarginFactor,
                                     float simGaussianSize)
 {
+    const int nbVertices = verticesCoordsPrepare.size();
+
+    if (nbVertices == 0)
+        return;
+
+    // vote radius of the vertices, a depth map point votes for the closest vertex in its vote radius
+    double maxSimScore = 0.0;
+    std::vector<double> voteRadiuses(nbVertices);
+    for (int vi = 0; vi < nbVertices; ++vi)
+    {
+        maxSimScore = std::max(maxSimScore, double(simScorePrepare[vi]));
+        voteRadiuses[vi] = std::sqrt(voteMarginFactor * simScorePrepare[vi]) * pixSizePrepare[vi];
+    }
 
-    PointVectorAdaptator pointCloudRef(verticesCoordsPrepare);
-    KdTree kdTree(3 /*dim*/, pointCloudRef, nanoflann::KDTreeSingleIndexAdaptorParams(MAX_LEAF_ELEMENTS));
-    kdTree.buildIndex();
-    ALICEVISION_LOG_INFO("NANOFLANN: KdTree created.");
+    // grid cell size is the median vote radius
+    std::nth_element(voteRadiuses.begin(), voteRadiuses.begin() + nbVertices / 2, voteRadiuses.end());
+    const double minSearchRadius = voteRadiuses[nbVertices / 2];
+    const double searchRadiusFactor = std::sqrt(voteMarginFactor * maxSimScore);
+    std::vector<double>().swap(voteRadiuses);
 
+    const PointGrid grid(verticesCoordsPrepare, minSearchRadius);
+    ALICEVISION_LOG_INFO("Point grid created for " << nbVertices << " points (" << grid.getNbCells() << " cells).");
 
-    std::vector<omp_lock_t> locks(verticesCoordsPrepare.size());
-    for (auto& lock : locks)
-        omp_init_lock(&lock);
+    // vertices ranges: each range is a set of neighbor vertices (consecutive vertices in the grid order)
+    const int rangeShift = 12;
+    const int nbRanges = (nbVertices >> rangeShift) + 1;
+    std::vector<int> vertexRange(nbVertices);
+    {
+        const std::vector<int>& sortedIndices = grid.getSortedIndices();
+        for (int i = 0; i < sortedIndices.size(); ++i)
+            vertexRange[sortedIndices[i]] = i >> rangeShift;
+    }
 
-    omp_set_nested(1);
-#pragma omp parallel for num_threads(3)
-    for (int c = 0; c < cams.size(); ++c)
+    // camera votes for a vertex (consecutive votes of a camera for the same vertex are merged)
+    struct Vote
     {
-        ALICEVISION_LOG_INFO("Create visibilities (" << c << "/" << cams.size() << ")");
-        image::Image<float> depthMap;
-        image::Image<float> simMap;
-        const int width = mp.getWidth(c);
-        const int height = mp.getHeight(c);
+        int vertexIndex;
+        int nbContributions;
+        Point3d contributionsSum;
+    };
 
-        // read depth map
-        mvsUtils::readMap(c, mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+    // cameras are processed by batches: each thread reads a depth map and stores its votes per vertices range,
+    // then each range is updated by a single thread, without locks.
+    const int batchSize = std::max(1, omp_get_max_threads());
 
-        if (depthMap.size() <= 0)
-        {
-            ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << c << ")");
-            continue;
-        }
+    for (int batchBegin = 0; batchBegin < cams.size(); batchBegin += batchSize)
+    {
+        const int batchEnd = std::min(int(cams.size()), batchBegin + batchSize);
 
-        // read similarity map
-        try
-        {
-            mvsUtils::readMap(c, mp, mvsUtils::EFileType::simMapFiltered, simMap);
-            image::Image<float> simMapTmp(simMap.width(), simMap.height());
-            imageAlgo::convolveImage(simMap, simMapTmp, "gaussian", simGaussianSize, simGaussianSize);
-            simMap.swap(simMapTmp);
-        }
-        catch (const std::exception& e)
-        {
-            ALICEVISION_LOG_WARNING("Cannot find similarity map file.");
-            simMap.resize(width * height, -1);
-        }
+        // votes per batch camera, per vertices range
+        std::vector<std::vector<std::vector<Vote>>> batchVotes(batchEnd - batchBegin);
 
-// Add visibility
-#pragma omp parallel for
-        for (int y = 0; y < depthMap.height(); ++y)
+#pragma omp parallel for schedule(dynamic)
+        for (int c = batchBegin; c < batchEnd; ++c)
         {
-            for (int x = 0; x < depthMap.width(); ++x)
+            const int rc = cams[c];
+            std::vector<std::vector<Vote>>& votes = batchVotes[c - batchBegin];
+            votes.resize(nbRanges);
+
+            ALICEVISION_LOG_INFO("Create visibilities (" << c << "/" << cams.size() << ")");
+            image::Image<float> depthMap;
+            image::Image<float> simMap;
+            const int width = mp.getWidth(rc);
+            const int height = mp.getHeight(rc);
+
+            // read depth map
+            mvsUtils::readMap(rc, mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+
+            if (depthMap.size() <= 0)
             {
-                const std::size_t index = y * depthMap.width() + x;
-                const float depth = depthMap(index);
-                if (depth <= 0.0f)
-                    continue;
+                ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << rc << ")");
+                continue;
+            }
 
-                const Point3d p = mp.backproject(c, Point2d(x, y), depth);
-                const double pixSize = mp.getCamPixelSize(p, c);
+            // read similarity map
+            try
+            {
+                mvsUtils::readMap(rc, mp, mvsUtils::EFileType::simMapFiltered, simMap);
+                image::Image<float> simMapTmp(simMap.width(), simMap.height());
+                imageAlgo::convolveImage(simMap, simMapTmp, "gaussian", simGaussianSize, simGaussianSize);
+                simMap.swap(simMapTmp);
+            }
+            catch (const std::exception& e)
+            {
+                ALICEVISION_LOG_WARNING("Cannot find similarity map file.");
+                simMap.resize(width, height, true, -1);
+            }
 
-                nanoflann::KNNResultSet<double, std::size_t> resultSet(1);
-                std::size_t nearestVertexIndex = std::numeric_limits<std::size_t>::max();
-                double dist = std::numeric_limits<double>::max();
-                resultSet.init(&nearestVertexIndex, &dist);
-                if (!kdTree.findNeighbors(resultSet, p.m, nanoflann::SearchParameters()))
+            // Add visibility
+            for (int y = 0; y < depthMap.height(); ++y)
+            {
+                for (int x = 0; x < depthMap.width(); ++x)
                 {
-                    ALICEVISION_LOG_TRACE("Failed to find Neighbors.");
-                    continue;
-                }
+                    const std::size_t index = y * depthMap.width() + x;
+                    const float depth = depthMap(index);
+                    if (depth <= 0.0f)
+                        continue;
+
+                    const Point3d p = mp.backproject(rc, Point2d(x, y), depth);
+                    const double pixSize = mp.getCamPixelSize(p, rc);
+
+                    // closest vertex in the search radius
+                    int nearestVertexIndex = -1;
+                    double dist = std::numeric_limits<double>::max();
+                    grid.forEachPointInRadius(p, std::max(minSearchRadius, searchRadiusFactor * pixSize), [&](int vIndex, double sqDist) {
+                        if (sqDist < dist)
+                        {
+                            nearestVertexIndex = vIndex;
+                            dist = sqDist;
+                        }
+                        return true;
+                    });
 
-                const float pixSizeScoreI = simScorePrepare[nearestVertexIndex] * pixSize * pixSize;
-                const float pixSizeScoreV =
-                  simScorePrepare[nearestVertexIndex] * pixSizePrepare[nearestVertexIndex] * pixSizePrepare[nearestVertexIndex];
+                    if (nearestVertexIndex == -1)
+                        continue;
 
-                if (dist < voteMarginFactor * std::max(pixSizeScoreI, pixSizeScoreV))
-                {
-                    GC_vertexInfo& va = verticesAttrPrepare[nearestVertexIndex];
-                    Point3d& vc = verticesCoordsPrepare[nearestVertexIndex];
-                    const float simValue = simMap(index);
-                    // remap similarity values from [-1;+1] to [+1;+simFactor]
-                    // interpretation is [goodSimilarity;badSimilarity]
-                    const float simScore = simValue < -1.0f ? 1.0f : 1.0f + (1.0f + simValue) * simFactor;
-
-                    // Custom locks to limit it to the index: nearestVertexIndex
-                    // to avoid using "omp critical"
-                    omp_lock_t* lock = &locks[nearestVertexIndex];
-                    omp_set_lock(lock);
+                    const float pixSizeScoreI = simScorePrepare[nearestVertexIndex] * pixSize * pixSize;
+                    const float pixSizeScoreV =
+                      simScorePrepare[nearestVertexIndex] * pixSizePrepare[nearestVertexIndex] * pixSizePrepare[nearestVertexIndex];
+
+                    if (dist < voteMarginFactor * std::max(pixSizeScoreI, pixSizeScoreV))
                     {
-                        va.cams.push_back_distinct(c);
-                        if (dist < contributeMarginFactor * pixSizeScoreV)
-                        {
-                            vc = (vc * (double)va.nrc + p) / double(va.nrc + 1);
+                        const bool contributes = dist < contributeMarginFactor * pixSizeScoreV;
+                        std::vector<Vote>& rangeVotes = votes[vertexRange[nearestVertexIndex]];
 
-                            va.nrc += 1;
+                        if (rangeVotes.empty() || rangeVotes.back().vertexIndex != nearestVertexIndex)
+                            rangeVotes.push_back({nearestVertexIndex, 0, Point3d()});
+
+                        if (contributes)
+                        {
+                            Vote& vote = rangeVotes.back();
+                            vote.contributionsSum = vote.contributionsSum + p;
+                            ++vote.nbContributions;
                         }
                     }
-                    omp_unset_lock(lock);
                 }
             }
         }
-    }
-    omp_set_nested(0);
 
-    for (auto& lock : locks)
-        omp_destroy_lock(&lock);
+        // apply the votes, in the cameras order
+#pragma omp parallel for schedule(dynamic)
+        for (int r = 0; r < nbRanges; ++r)
+        {
+            for (int c = batchBegin; c < batchEnd; ++c)
+            {
+                const std::vector<std::vector<Vote>>& votes = batchVotes[c - batchBegin];
+                if (votes.empty())
+                    continue;
+
+                for (const Vote& vote : votes[r])
+                {
+                    GC_vertexInfo& va = verticesAttrPrepare[vote.vertexIndex];
+                    va.cams.push_back_distinct(cams[c]);
+
+                    if (vote.nbContributions > 0)
+                    {
+                        Point3d& vc = verticesCoordsPrepare[vote.vertexIndex];
+                        vc = (vc * double(va.nrc) + vote.contributionsSum) / double(va.nrc + vote.nbContributions);
+                        va.nrc += vote.nbContributions;
+                    }
+                }
+            }
+        }
+    }
 
 // compute pixSize
 #pragma omp parallel for
@@ -292,31 +371,32 @@ void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d
 
     ALICEVISION_LOG_INFO("Load depth maps and add points.");
     {
-        omp_set_nested(1);
-#pragma omp parallel for num_threads(3)
+        // flat parallelism over the cameras: each camera writes its own range of points
+#pragma omp parallel for schedule(dynamic)
         for (int c = 0; c < cams.size(); c++)
         {
+            const int rc = cams[c];
             image::Image<float> depthMap;
             image::Image<float> simMap;
             image::Image<unsigned char> numOfModalsMap;
 
-            const int width = _mp.getWidth(c);
-            const int height = _mp.getHeight(c);
+            const int width = _mp.getWidth(rc);
+            const int height = _mp.getHeight(rc);
 
             {
                 // read depth map
-                mvsUtils::readMap(c, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+                mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
 
                 if (depthMap.size() <= 0)
                 {
-                    ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << c << ")");
+                    ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << rc << ")");
                     continue;
                 }
 
                 // read similarity map
                 try
                 {
-                    mvsUtils::readMap(c, _mp, mvsUtils::EFileType::simMapFiltered, simMap);
+                    mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::simMapFiltered, simMap);
                     image::Image<float> simMapTmp;
                     imageAlgo::convolveImage(simMap, simMapTmp, "gaussian", params.simGaussianSizeInit, params.simGaussianSizeInit);
                     simMap.swap(simMapTmp);
@@ -329,7 +409,7 @@ void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d
 
                 // read nmod map
                 int wTmp, hTmp;
-                const std::string nmodMapFilepath = getFileNameFromIndex(_mp, c, mvsUtils::EFileType::nmodMap);
+                const std::string nmodMapFilepath = getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap);
                 // If we have an nModMap in input (from depthmapfilter) use it,
                 // else init with a constant value.
                 if (utils::exists(nmodMapFilepath))
@@ -347,12 +427,11 @@ void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d
 
             const int syMax = divideRoundUp(height, step);
             const int sxMax = divideRoundUp(width, step);
-#pragma omp parallel for
             for (int sy = 0; sy < syMax; ++sy)
             {
                 for (int sx = 0; sx < sxMax; ++sx)
                 {
-                    const int index = startIndex[c] + sy * sxMax + sx;
+                    const int index = startIndex[rc] + sy * sxMax + sx;
                     float bestDepth = std::numeric_limits<float>::max();
                     float bestScore = 0;
                     float bestSimScore = 0;
@@ -403,14 +482,14 @@ void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d
                     }
                     else
                     {
-                        const Point3d p = _mp.CArr[c] + (_mp.iCamArr[c] * Point2d((float)bestX, (float)bestY)).normalize() * bestDepth;
+                        const Point3d p = _mp.CArr[rc] + (_mp.iCamArr[rc] * Point2d((float)bestX, (float)bestY)).normalize() * bestDepth;
 
                         // TODO: isPointInHexahedron: here or in the previous loop per pixel to not loose point?
                         if (voxel == nullptr || mvsUtils::isPointInHexahedron(p, voxel))
                         {
                             verticesCoordsPrepare[index] = p;
                             simScorePrepare[index] = bestSimScore;
-                            pixSizePrepare[index] = _mp.getCamPixelSize(p, c);
+                            pixSizePrepare[index] = _mp.getCamPixelSize(p, rc);
                         }
                         else
                         {
@@ -422,7 +501,6 @@ void PointCloud::fuseFromDepthMaps(const StaticVector<int>& cams, const Point3d
                 }
             }
         }
-        omp_set_nested(0);
     }
 
     ALICEVISION_LOG_INFO("Filter initial 3D points by pixel size to remove duplicates.");
@@ -849,12 +927,13 @@ void PointCloud::addMaskHelperPoints(const Point3d voxel[8], const StaticVector<
     {
         for (int c = 0; c < cams.size(); c++)
         {
+            const int rc = cams[c];
             image::Image<float> depthMap;
-            mvsUtils::readMap(c, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+            mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
 
             if (depthMap.size() <= 0)
             {
-                ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << c << ")");
+                ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << rc << ")");
                 continue;
             }
 
@@ -904,8 +983,8 @@ void PointCloud::addMaskHelperPoints(const Point3d voxel[8], const StaticVector<
                     }
                     if (bestScore > 0.0f)
                     {
-                        const Point3d& cam = _mp.CArr[c];
-                        Point3d maxP = cam + (_mp.iCamArr[c] * Point2d((float)bestX, (float)bestY)).normalize() * 10000000.0;
+                        const Point3d& cam = _mp.CArr[rc];
+                        Point3d maxP = cam + (_mp.iCamArr[rc] * Point2d((float)bestX, (float)bestY)).normalize() * 10000000.0;
                         StaticVector<Point3d>* intersectionsPtr = mvsUtils::lineSegmentHexahedronIntersection(cam, maxP, inflatedVoxel);
 
                         if (intersectionsPtr->size() <= 0)
@@ -925,7 +1004,7 @@ void PointCloud::addMaskHelperPoints(const Point3d voxel[8], const StaticVector<
                         GC_vertexInfo newv;
                         newv.nrc = params.maskHelperPointsWeight;
                         newv.pixSize = 0.0f;
-                        newv.cams.push_back_distinct(c);
+                        newv.cams.push_back_distinct(rc);
 
                         _verticesAttr.push_back(newv);
                         _verticesCoords.emplace_back(p);
@@ -0,0 +1,94 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "PointGrid.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <limits>
+#include <numeric>
+
+namespace aliceVision {
+namespace fuseCut {
+
+PointGrid::PointGrid(const std::vector<Point3d>& points, double cellSize, const std::vector<bool>* isValid)
+  : _points(points),
+    _cellSize(cellSize)
+{
+    const auto isInserted = [&](std::size_t i) { return isValid == nullptr || (*isValid)[i]; };
+
+    // points bounding box
+    Point3d bbMin(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    Point3d bbMax(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+    std::size_t nbPoints = 0;
+
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        if (!isInserted(i))
+            continue;
+        ++nbPoints;
+        for (int k = 0; k < 3; ++k)
+        {
+            bbMin.m[k] = std::min(bbMin.m[k], points[i].m[k]);
+            bbMax.m[k] = std::max(bbMax.m[k], points[i].m[k]);
+        }
+    }
+
+    _cellOffsets.push_back(0);
+
+    if (nbPoints == 0)
+        return;
+
+    _origin = bbMin;
+
+    // limit the number of cells per axis to keep 64 bits cell keys
+    const double maxCellsPerAxis = double(1 << 20);
+    const double extent = std::max(bbMax.x - bbMin.x, std::max(bbMax.y - bbMin.y, bbMax.z - bbMin.z));
+
+    if (!(_cellSize > 0.0) || !std::isfinite(_cellSize) || extent / _cellSize >= maxCellsPerAxis)
+    {
+        const double minCellSize = std::max(extent / (maxCellsPerAxis - 1.0), std::numeric_limits<double>::min());
+        ALICEVISION_LOG_DEBUG("PointGrid: cell size " << _cellSize << " is replaced by " << minCellSize << ".");
+        _cellSize = std::max(minCellSize, std::isfinite(_cellSize) ? _cellSize : 0.0);
+    }
+
+    for (int k = 0; k < 3; ++k)
+        _dims[k] = long(std::floor((bbMax.m[k] - bbMin.m[k]) / _cellSize)) + 1;
+
+    // sort points by cell key
+    std::vector<std::pair<CellKey, int>> keys;
+    keys.reserve(nbPoints);
+
+    std::array<long, 3> cell;
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        if (!isInserted(i))
+            continue;
+        getCell(points[i], cell);
+        keys.emplace_back(getCellKey(cell[0], cell[1], cell[2]), int(i));
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    _indices.resize(nbPoints);
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        _indices[i] = keys[i].second;
+
+        if (i == 0 || keys[i].first != keys[i - 1].first)
+        {
+            if (i > 0)
+                _cellOffsets.push_back(int(i));
+            _cellKeys.push_back(keys[i].first);
+        }
+    }
+    _cellOffsets.push_back(int(nbPoints));
+
+    ALICEVISION_LOG_DEBUG("PointGrid: " << nbPoints << " points in " << _cellKeys.size() << " cells (cell size: " << _cellSize << ").");
+}
+
+}  // namespace fuseCut
+}  // namespace aliceVision
@@ -0,0 +1,137 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/Point3d.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @class Point grid
+ * @brief Uniform grid of 3d points for fixed-radius neighbor queries.
+ * @note The grid is stored as sorted cell keys with the points indices of each cell (no hash table),
+ *       points of the same cell are contiguous in getSortedIndices().
+ *       The grid is read-only once built, queries can be done in parallel.
+ */
+class PointGrid
+{
+  public:
+    using CellKey = std::uint64_t;
+
+    /**
+     * @brief PointGrid constructor.
+     * @param[in] points the 3d points, points are read during the queries (positions can be updated slightly)
+     * @param[in] cellSize the grid cell size
+     * @param[in] isValid optional points validity, invalid points are not inserted
+     */
+    PointGrid(const std::vector<Point3d>& points, double cellSize, const std::vector<bool>* isValid = nullptr);
+
+    /// get the grid cell size
+    inline double getCellSize() const { return _cellSize; }
+
+    /// get the number of non-empty cells
+    inline std::size_t getNbCells() const { return _cellKeys.size(); }
+
+    /**
+     * @brief Get the inserted points indices, sorted by cell.
+     * @note Close points have close ranks: this order can be used to split points into spatial ranges.
+     */
+    inline const std::vector<int>& getSortedIndices() const { return _indices; }
+
+    /**
+     * @brief Call the visitor for each inserted point in the cells intersecting the ball of the given radius.
+     * @note The visitor is called with the point index and the squared distance to the query point.
+     *       Points farther than the radius (but in the visited cells) are not visited.
+     *       The visitor returns false to stop the search.
+     * @param[in] p the query point
+     * @param[in] radius the query radius
+     * @param[in] visitor the visitor: bool(int index, double sqDist)
+     * @return false if the search was stopped by the visitor
+     */
+    template<typename Visitor>
+    bool forEachPointInRadius(const Point3d& p, double radius, Visitor visitor) const
+    {
+        const double sqRadius = radius * radius;
+        const int rings = std::max(1, int(std::ceil(radius / _cellSize)));
+
+        std::array<long, 3> cell;
+        getCell(p, cell);
+
+        const long zBegin = std::max(0L, cell[2] - rings);
+        const long zEnd = std::min(_dims[2] - 1, cell[2] + rings);
+        const long yBegin = std::max(0L, cell[1] - rings);
+        const long yEnd = std::min(_dims[1] - 1, cell[1] + rings);
+
+        // large radius compared to the cell size: visiting all the points is cheaper than visiting the rows
+        if (double(zEnd - zBegin + 1) * double(yEnd - yBegin + 1) > double(_cellKeys.size()))
+        {
+            for (const int index : _indices)
+            {
+                const double sqDist = (_points[index] - p).size2();
+
+                if (sqDist < sqRadius && !visitor(index, sqDist))
+                    return false;
+            }
+            return true;
+        }
+
+        for (long z = zBegin; z <= zEnd; ++z)
+        {
+            for (long y = yBegin; y <= yEnd; ++y)
+            {
+                // cells of a row have contiguous keys
+                const long xBegin = std::max(0L, cell[0] - rings);
+                const long xEnd = std::min(_dims[0] - 1, cell[0] + rings);
+
+                auto it = std::lower_bound(_cellKeys.begin(), _cellKeys.end(), getCellKey(xBegin, y, z));
+                const CellKey keyEnd = getCellKey(xEnd, y, z);
+
+                for (; it != _cellKeys.end() && *it <= keyEnd; ++it)
+                {
+                    const std::size_t cellIndex = std::size_t(it - _cellKeys.begin());
+
+                    for (int i = _cellOffsets[cellIndex]; i < _cellOffsets[cellIndex + 1]; ++i)
+                    {
+                        const int index = _indices[i];
+                        const double sqDist = (_points[index] - p).size2();
+
+                        if (sqDist < sqRadius && !visitor(index, sqDist))
+                            return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+  private:
+    inline void getCell(const Point3d& p, std::array<long, 3>& cell) const
+    {
+        for (int i = 0; i < 3; ++i)
+            cell[i] = std::min(_dims[i] - 1, std::max(0L, long(std::floor((p.m[i] - _origin.m[i]) / _cellSize))));
+    }
+
+    inline CellKey getCellKey(long x, long y, long z) const { return (CellKey(z) * CellKey(_dims[1]) + CellKey(y)) * CellKey(_dims[0]) + CellKey(x); }
+
+    const std::vector<Point3d>& _points;
+    double _cellSize;
+    Point3d _origin;                  //< grid origin (points bounding box minimum)
+    std::array<long, 3> _dims{{1, 1, 1}};  //< number of cells along each axis
+    std::vector<CellKey> _cellKeys;   //< sorted non-empty cells keys
+    std::vector<int> _cellOffsets;    //< cell first index in _indices
+    std::vector<int> _indices;        //< points indices sorted by cell
+};
+
+}  // namespace fuseCut
+}  // namespace aliceVision
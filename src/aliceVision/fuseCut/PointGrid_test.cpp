@@ -0,0 +1,196 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/mvsData/Point3d.hpp>
+#include <aliceVision/fuseCut/PointGrid.hpp>
+#include <aliceVision/fuseCut/Kdtree.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_MODULE pointGrid
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+namespace {
+
+/// nanoflann result set collecting all the points in radius (squared distance)
+class AllInRadius
+{
+  public:
+    explicit AllInRadius(double sqRadius)
+      : _sqRadius(sqRadius)
+    {}
+
+    inline void init() { clear(); }
+    inline void clear() { indices.clear(); }
+    inline size_t size() const { return indices.size(); }
+    inline bool full() const { return true; }
+    inline double worstDist() const { return _sqRadius; }
+
+    inline bool addPoint(double dist, std::size_t index)
+    {
+        if (dist < _sqRadius)
+            indices.push_back(int(index));
+        return true;
+    }
+
+    std::vector<int> indices;
+
+  private:
+    const double _sqRadius;
+};
+
+/// clusters of points of different densities, as in fused depth maps
+std::vector<Point3d> createPoints(std::size_t nbPoints)
+{
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> centerDist(-10.0, 10.0);
+    std::uniform_real_distribution<double> spreadDist(0.01, 2.0);
+
+    std::vector<Point3d> points;
+    while (points.size() < nbPoints)
+    {
+        const Point3d center(centerDist(gen), centerDist(gen), 0.1 * centerDist(gen));
+        std::normal_distribution<double> pointDist(0.0, spreadDist(gen));
+        for (int i = 0; i < 500 && points.size() < nbPoints; ++i)
+            points.emplace_back(center.x + pointDist(gen), center.y + pointDist(gen), center.z + pointDist(gen));
+    }
+    return points;
+}
+
+std::vector<int> getGridPointsInRadius(const PointGrid& grid, const Point3d& p, double radius)
+{
+    std::vector<int> indices;
+    grid.forEachPointInRadius(p, radius, [&](int index, double) {
+        indices.push_back(index);
+        return true;
+    });
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+std::vector<int> getKdTreePointsInRadius(const KdTree& kdTree, const std::vector<bool>& isValid, const Point3d& p, double radius)
+{
+    AllInRadius resultSet(radius * radius);
+    kdTree.findNeighbors(resultSet, p.m, nanoflann::SearchParameters(0.f, false));
+
+    std::vector<int> indices;
+    for (const int index : resultSet.indices)
+    {
+        if (isValid[index])
+            indices.push_back(index);
+    }
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(pointGrid_radiusSameAsKdTree)
+{
+    const std::vector<Point3d> points = createPoints(20000);
+
+    // some points are not inserted in the grid
+    std::vector<bool> isValid(points.size(), true);
+    for (std::size_t i = 0; i < points.size(); i += 7)
+        isValid[i] = false;
+
+    PointVectorAdaptator pointCloudRef(points);
+    KdTree kdTree(3 /*dim*/, pointCloudRef, nanoflann::KDTreeSingleIndexAdaptorParams(MAX_LEAF_ELEMENTS));
+    kdTree.buildIndex();
+
+    const PointGrid grid(points, 0.05, &isValid);
+    BOOST_CHECK_EQUAL(grid.getSortedIndices().size(), points.size() - (points.size() + 6) / 7);
+
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<std::size_t> indexDist(0, points.size() - 1);
+    std::uniform_real_distribution<double> offsetDist(-0.5, 0.5);
+
+    // radiuses smaller and larger than the cell size, the largest one visits all the points
+    for (const double radius : {0.01, 0.05, 0.3, 2.0, 50.0})
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            Point3d p = points[indexDist(gen)];
+            if (i % 2)
+                p = p + Point3d(offsetDist(gen), offsetDist(gen), offsetDist(gen));
+
+            BOOST_CHECK(getGridPointsInRadius(grid, p, radius) == getKdTreePointsInRadius(kdTree, isValid, p, radius));
+        }
+    }
+
+    // query point outside of the grid bounding box
+    const Point3d outside(30.0, 0.0, 0.0);
+    BOOST_CHECK(getGridPointsInRadius(grid, outside, 25.0) == getKdTreePointsInRadius(kdTree, isValid, outside, 25.0));
+}
+
+BOOST_AUTO_TEST_CASE(pointGrid_filterByPixSizeSameAsKdTree)
+{
+    const std::vector<Point3d> points = createPoints(20000);
+
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<double> pixSizeDist(0.01, 0.05);
+    std::uniform_real_distribution<float> simScoreDist(0.5f, 1.5f);
+
+    std::vector<double> pixSizes(points.size());
+    std::vector<float> simScores(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        pixSizes[i] = pixSizeDist(gen);
+        simScores[i] = simScoreDist(gen);
+    }
+    const double pixSizeMarginCoef = 2.0;
+
+    PointVectorAdaptator pointCloudRef(points);
+    KdTree kdTree(3 /*dim*/, pointCloudRef, nanoflann::KDTreeSingleIndexAdaptorParams(MAX_LEAF_ELEMENTS));
+    kdTree.buildIndex();
+
+    std::vector<double> pixSizeScores(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+        pixSizeScores[i] = simScores[i] * pixSizes[i] * pixSizes[i];
+
+    const PointGrid grid(points, 0.05);
+
+    // a point is filtered if a point in its radius has a smaller pixSize score
+    std::size_t nbFiltered = 0;
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        SmallerPixSizeInRadius<double, std::size_t> resultSet(pixSizeMarginCoef * pixSizeScores[i], pixSizes, simScores, int(i));
+        kdTree.findNeighbors(resultSet, points[i].m, nanoflann::SearchParameters(0.f, false));
+
+        const double pixSizeScore = pixSizeScores[i];
+        const bool found = !grid.forEachPointInRadius(
+          points[i], std::sqrt(pixSizeMarginCoef * pixSizeScore), [&](int index, double) { return pixSizeScores[index] >= pixSizeScore; });
+
+        BOOST_CHECK_EQUAL(found, resultSet.found);
+        nbFiltered += found;
+    }
+    BOOST_CHECK_GT(nbFiltered, 0);
+    BOOST_CHECK_LT(nbFiltered, points.size());
+}
+
+BOOST_AUTO_TEST_CASE(pointGrid_stopSearch)
+{
+    const std::vector<Point3d> points = createPoints(1000);
+    const PointGrid grid(points, 0.5);
+
+    int nbVisited = 0;
+    const bool completed = grid.forEachPointInRadius(points.front(), 100.0, [&](int, double) { return ++nbVisited < 10; });
+    BOOST_CHECK(!completed);
+    BOOST_CHECK_EQUAL(nbVisited, 10);
+
+    // empty grid
+    const std::vector<bool> isValid(points.size(), false);
+    const PointGrid emptyGrid(points, 0.5, &isValid);
+    BOOST_CHECK_EQUAL(emptyGrid.getNbCells(), 0);
+    BOOST_CHECK(emptyGrid.forEachPointInRadius(points.front(), 100.0, [](int, double) { return false; }));
+}
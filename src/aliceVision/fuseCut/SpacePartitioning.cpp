@@ -0,0 +1,96 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "SpacePartitioning.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace aliceVision {
+namespace fuseCut {
+
+SpacePartitioning::SpacePartitioning(const Point3d* hexah, int nbBlocks, double overlap)
+  : _origin(hexah[0]),
+    _axes{{hexah[1] - hexah[0], hexah[3] - hexah[0], hexah[4] - hexah[0]}},
+    _gridSize(1, 1, 1),
+    _overlap(std::max(0.0, overlap))
+{
+    Eigen::Matrix3d axes;
+    for (int i = 0; i < 3; ++i)
+        axes.col(i) = toEigen(_axes[i]);
+    _toLocal = axes.inverse();
+
+    // split the longest block axis until we have enough blocks
+    while (getNbBlocks() < nbBlocks)
+    {
+        const double sx = _axes[0].size() / _gridSize.x;
+        const double sy = _axes[1].size() / _gridSize.y;
+        const double sz = _axes[2].size() / _gridSize.z;
+
+        if (sx >= sy && sx >= sz)
+            ++_gridSize.x;
+        else if (sy >= sz)
+            ++_gridSize.y;
+        else
+            ++_gridSize.z;
+    }
+
+    ALICEVISION_LOG_INFO("Space partitioning: " << _gridSize.x << "x" << _gridSize.y << "x" << _gridSize.z << " blocks (overlap: " << _overlap << ").");
+}
+
+std::array<Point3d, 8> SpacePartitioning::getBlockHexahedron(int blockIndex) const
+{
+    const Voxel block = getBlockCoordinates(blockIndex);
+
+    // block range along an axis, in normalized hexahedron coordinates
+    const auto range = [&](int b, int n, double& begin, double& end) {
+        const double margin = _overlap / n;
+        begin = std::max(0.0, double(b) / n - margin);
+        end = std::min(1.0, double(b + 1) / n + margin);
+    };
+
+    double x0, x1, y0, y1, z0, z1;
+    range(block.x, _gridSize.x, x0, x1);
+    range(block.y, _gridSize.y, y0, y1);
+    range(block.z, _gridSize.z, z0, z1);
+
+    const auto point = [&](double x, double y, double z) { return _origin + _axes[0] * x + _axes[1] * y + _axes[2] * z; };
+
+    // same points order as the input hexahedron
+    return {{point(x0, y0, z0),
+             point(x1, y0, z0),
+             point(x1, y1, z0),
+             point(x0, y1, z0),
+             point(x0, y0, z1),
+             point(x1, y0, z1),
+             point(x1, y1, z1),
+             point(x0, y1, z1)}};
+}
+
+int SpacePartitioning::getBlockIndex(const Point3d& p) const
+{
+    const Eigen::Vector3d local = getLocalCoordinates(p);
+
+    if ((local.array() < 0.0).any() || (local.array() > 1.0).any())
+        return -1;
+
+    // note: points on the upper border belong to the last block
+    const int bx = std::min(_gridSize.x - 1, int(std::floor(local.x() * _gridSize.x)));
+    const int by = std::min(_gridSize.y - 1, int(std::floor(local.y() * _gridSize.y)));
+    const int bz = std::min(_gridSize.z - 1, int(std::floor(local.z() * _gridSize.z)));
+
+    return getBlockIndex(Voxel(bx, by, bz));
+}
+
+Voxel SpacePartitioning::getBlockCoordinates(int blockIndex) const
+{
+    return Voxel(blockIndex % _gridSize.x, (blockIndex / _gridSize.x) % _gridSize.y, blockIndex / (_gridSize.x * _gridSize.y));
+}
+
+}  // namespace fuseCut
+}  // namespace aliceVision
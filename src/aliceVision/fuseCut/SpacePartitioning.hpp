@@ -0,0 +1,88 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/Point3d.hpp>
+#include <aliceVision/mvsData/Voxel.hpp>
+
+#include <Eigen/Dense>
+
+#include <array>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @class Space partitioning
+ * @brief Regular grid partitioning of a hexahedron into meshing blocks.
+ * @note Block cores are a partition of the hexahedron, each point belongs to a single block core.
+ *       Block hexahedrons are the block cores inflated by an overlap margin on each side,
+ *       so that the surface of a block core is not affected by the block borders.
+ */
+class SpacePartitioning
+{
+  public:
+    /**
+     * @brief SpacePartitioning constructor.
+     * @param[in] hexah the hexahedron to divide (8 points)
+     * @param[in] nbBlocks the minimum number of blocks, the grid is refined along the longest block axis
+     * @param[in] overlap the overlap margin on each side of a block, relative to the block core size
+     */
+    SpacePartitioning(const Point3d* hexah, int nbBlocks, double overlap);
+
+    /// get the number of blocks
+    inline int getNbBlocks() const { return _gridSize.x * _gridSize.y * _gridSize.z; }
+
+    /// get the number of blocks along each hexahedron axis
+    inline const Voxel& getGridSize() const { return _gridSize; }
+
+    /**
+     * @brief Get the block hexahedron, including the overlap margin.
+     * @param[in] blockIndex the block index
+     * @return the block hexahedron (8 points)
+     */
+    std::array<Point3d, 8> getBlockHexahedron(int blockIndex) const;
+
+    /**
+     * @brief Get the index of the block core containing the given point.
+     * @param[in] p the 3d point
+     * @return the block index, -1 if the point is outside the hexahedron
+     */
+    int getBlockIndex(const Point3d& p) const;
+
+    /**
+     * @brief Get the index of a block from its coordinates in the grid.
+     * @param[in] block the block position along each hexahedron axis
+     * @return the block index
+     */
+    inline int getBlockIndex(const Voxel& block) const { return block.x + _gridSize.x * (block.y + _gridSize.y * block.z); }
+
+    /**
+     * @brief Get the block coordinates in the grid.
+     * @param[in] blockIndex the block index
+     * @return the block position along each hexahedron axis
+     */
+    Voxel getBlockCoordinates(int blockIndex) const;
+
+    /**
+     * @brief Get the normalized hexahedron coordinates of a point.
+     * @note The coordinates are in [0, 1] inside the hexahedron, the block cores borders are at i / gridSize.
+     * @param[in] p the 3d point
+     * @return the normalized coordinates along each hexahedron axis
+     */
+    inline Eigen::Vector3d getLocalCoordinates(const Point3d& p) const { return _toLocal * toEigen(p - _origin); }
+
+  private:
+    Point3d _origin;                  //< hexahedron origin (hexah[0])
+    std::array<Point3d, 3> _axes;     //< hexahedron edges (hexah[1], hexah[3], hexah[4] minus the origin)
+    Eigen::Matrix3d _toLocal;         //< world to normalized hexahedron coordinates
+    Voxel _gridSize;                  //< number of blocks along each axis
+    double _overlap;                  //< relative overlap margin
+};
+
+}  // namespace fuseCut
+}  // namespace aliceVision
@@ -0,0 +1,689 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "SubMeshMerger.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace aliceVision {
+namespace fuseCut {
+
+namespace {
+
+/// distance to a core face below which a vertex is on the face, relative to the block core size
+constexpr double seamPlaneEpsilon = 1e-6;
+
+inline std::uint64_t getEdgeKey(int a, int b)
+{
+    if (a > b)
+        std::swap(a, b);
+    return (std::uint64_t(a) << 32) | std::uint64_t(std::uint32_t(b));
+}
+
+/// count the number of triangles of each edge
+std::unordered_map<std::uint64_t, int> getEdgesNbTriangles(const mesh::Mesh& mesh)
+{
+    std::unordered_map<std::uint64_t, int> edgesNbTris;
+    edgesNbTris.reserve(std::size_t(mesh.tris.size()) * 2);
+
+    for (int i = 0; i < mesh.tris.size(); ++i)
+    {
+        const mesh::Mesh::triangle& t = mesh.tris[i];
+        for (int k = 0; k < 3; ++k)
+            ++edgesNbTris[getEdgeKey(t.v[k], t.v[(k + 1) % 3])];
+    }
+    return edgesNbTris;
+}
+
+int findRoot(std::vector<int>& parents, int i)
+{
+    while (parents[i] != i)
+    {
+        parents[i] = parents[parents[i]];  // path halving
+        i = parents[i];
+    }
+    return i;
+}
+
+/// working copy of a block sub-mesh for the clipping
+struct ClippedMesh
+{
+    std::vector<Point3d> pts;
+    std::vector<Eigen::Vector3d> localPts;  //< normalized hexahedron coordinates
+    std::vector<StaticVector<int>> ptsCams;
+    std::vector<rgb> colors;                //< empty if the sub-mesh has no colors
+    std::vector<std::array<int, 3>> tris;
+};
+
+/**
+ * @brief Clip the triangles by a plane of the normalized hexahedron coordinates.
+ * @note The kept side is side * (local[axis] - value) <= 0. Triangles crossing the plane are split,
+ *       the vertex created on an edge is shared by the two triangles of the edge, so the clipped mesh stays closed.
+ *       Vertices closer to the plane than epsilon are considered on the plane, to avoid slivers.
+ */
+void clipMesh(ClippedMesh& mesh, int axis, double value, double side, double epsilon)
+{
+    const auto getSignedDistance = [&](int i) {
+        const double d = side * (mesh.localPts[i][axis] - value);
+        return (std::abs(d) < epsilon) ? 0.0 : d;
+    };
+
+    std::vector<double> distances(mesh.pts.size());
+    for (std::size_t i = 0; i < mesh.pts.size(); ++i)
+        distances[i] = getSignedDistance(int(i));
+
+    // vertex created on each clipped edge
+    std::unordered_map<std::uint64_t, int> edgesNewPt;
+
+    const auto getEdgeNewPt = [&](int a, int b) {
+        if (a > b)
+            std::swap(a, b);
+
+        const auto it = edgesNewPt.find(getEdgeKey(a, b));
+        if (it != edgesNewPt.end())
+            return it->second;
+
+        const double t = distances[a] / (distances[a] - distances[b]);
+        const int newPt = int(mesh.pts.size());
+
+        mesh.pts.push_back(mesh.pts[a] + (mesh.pts[b] - mesh.pts[a]) * t);
+        mesh.localPts.push_back(mesh.localPts[a] + (mesh.localPts[b] - mesh.localPts[a]) * t);
+        mesh.localPts.back()[axis] = value;
+        distances.push_back(0.0);
+
+        // the new vertex is seen by the cameras of both edge vertices
+        StaticVector<int> cams = mesh.ptsCams[a];
+        for (const int cam : mesh.ptsCams[b])
+        {
+            if (std::find(cams.begin(), cams.end(), cam) == cams.end())
+                cams.push_back(cam);
+        }
+        mesh.ptsCams.push_back(cams);
+
+        if (!mesh.colors.empty())
+        {
+            const rgb& ca = mesh.colors[a];
+            const rgb& cb = mesh.colors[b];
+            const auto lerp = [t](unsigned char va, unsigned char vb) { return static_cast<unsigned char>(std::lround(va + (vb - va) * t)); };
+            mesh.colors.emplace_back(lerp(ca.r, cb.r), lerp(ca.g, cb.g), lerp(ca.b, cb.b));
+        }
+
+        edgesNewPt.emplace(getEdgeKey(a, b), newPt);
+        return newPt;
+    };
+
+    std::vector<std::array<int, 3>> tris;
+    tris.reserve(mesh.tris.size());
+
+    for (const std::array<int, 3>& t : mesh.tris)
+    {
+        const double d[3] = {distances[t[0]], distances[t[1]], distances[t[2]]};
+
+        if (d[0] <= 0.0 && d[1] <= 0.0 && d[2] <= 0.0)
+        {
+            tris.push_back(t);
+            continue;
+        }
+        if (d[0] >= 0.0 && d[1] >= 0.0 && d[2] >= 0.0)
+            continue;
+
+        // Sutherland-Hodgman clipping of the triangle, keeps the vertices order
+        std::array<int, 4> polygon;
+        int polygonSize = 0;
+
+        for (int k = 0; k < 3; ++k)
+        {
+            const int next = (k + 1) % 3;
+            if (d[k] <= 0.0)
+                polygon[polygonSize++] = t[k];
+            if ((d[k] < 0.0 && d[next] > 0.0) || (d[k] > 0.0 && d[next] < 0.0))
+                polygon[polygonSize++] = getEdgeNewPt(t[k], t[next]);
+        }
+
+        for (int k = 2; k < polygonSize; ++k)
+            tris.push_back({{polygon[0], polygon[k - 1], polygon[k]}});
+    }
+
+    mesh.tris.swap(tris);
+}
+
+/// chain of boundary vertices, in the boundary edges direction
+struct Chain
+{
+    std::vector<int> pts;
+    bool closed = false;
+};
+
+/// split directed boundary edges into chains
+std::vector<Chain> getChains(const std::vector<std::pair<int, int>>& edges)
+{
+    std::unordered_map<int, int> nextPts;
+    std::unordered_set<int> hasPreviousPt;
+
+    for (const auto& edge : edges)
+    {
+        nextPts.emplace(edge.first, edge.second);
+        hasPreviousPt.insert(edge.second);
+    }
+
+    std::vector<Chain> chains;
+    std::unordered_set<int> visited;
+
+    const auto walk = [&](int start) {
+        Chain chain;
+        int v = start;
+        while (true)
+        {
+            chain.pts.push_back(v);
+            visited.insert(v);
+
+            const auto it = nextPts.find(v);
+            if (it == nextPts.end())
+                break;
+            if (visited.count(it->second))
+            {
+                chain.closed = (it->second == start);
+                break;
+            }
+            v = it->second;
+        }
+        if (chain.pts.size() > 1)
+            chains.push_back(std::move(chain));
+    };
+
+    // open chains start at a vertex without previous vertex, the remaining edges are loops
+    for (const auto& edge : edges)
+    {
+        if (!hasPreviousPt.count(edge.first) && !visited.count(edge.first))
+            walk(edge.first);
+    }
+    for (const auto& edge : edges)
+    {
+        if (!visited.count(edge.first))
+            walk(edge.first);
+    }
+
+    return chains;
+}
+
+Point3d getBarycenter(const StaticVector<Point3d>& pts, const Chain& chain)
+{
+    Point3d barycenter;
+    for (const int v : chain.pts)
+        barycenter = barycenter + pts[v];
+    return barycenter / double(chain.pts.size());
+}
+
+/**
+ * @brief Get the neighbour block sharing the core face of a block where a boundary edge lies.
+ * @return the neighbour block index, -1 if the edge is not on a core face shared with another block
+ */
+int getSeamNeighbour(const SpacePartitioning& partitioning, const Point3d& a, const Point3d& b, int blockIndex)
+{
+    const Voxel& gridSize = partitioning.getGridSize();
+    const Voxel block = partitioning.getBlockCoordinates(blockIndex);
+    const Eigen::Vector3d localA = partitioning.getLocalCoordinates(a);
+    const Eigen::Vector3d localB = partitioning.getLocalCoordinates(b);
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const int n = gridSize.m[axis];
+        // note: the clipping snaps on the face the vertices closer than seamPlaneEpsilon, with rounding errors
+        const double epsilon = 2.0 * seamPlaneEpsilon / n;
+
+        for (const int face : {block.m[axis], block.m[axis] + 1})
+        {
+            if (face == 0 || face == n)
+                continue;
+
+            const double value = double(face) / n;
+            if (std::abs(localA[axis] - value) > epsilon || std::abs(localB[axis] - value) > epsilon)
+                continue;
+
+            Voxel neighbour = block;
+            neighbour.m[axis] += (face == block.m[axis]) ? -1 : 1;
+            return partitioning.getBlockIndex(neighbour);
+        }
+    }
+    return -1;
+}
+
+}  // namespace
+
+void SubMeshMerger::addSubMesh(const mesh::Mesh& subMesh, const StaticVector<StaticVector<int>>& subPtsCams, int blockIndex)
+{
+    ClippedMesh clippedMesh;
+    clippedMesh.pts.assign(subMesh.pts.begin(), subMesh.pts.end());
+    clippedMesh.ptsCams.resize(clippedMesh.pts.size());
+    clippedMesh.localPts.reserve(clippedMesh.pts.size());
+
+    for (std::size_t i = 0; i < clippedMesh.pts.size(); ++i)
+    {
+        clippedMesh.localPts.push_back(_partitioning.getLocalCoordinates(clippedMesh.pts[i]));
+        if (i < std::size_t(subPtsCams.size()))
+            clippedMesh.ptsCams[i] = subPtsCams[i];
+    }
+
+    if (subMesh.colors().size() == clippedMesh.pts.size())
+        clippedMesh.colors = subMesh.colors();
+
+    clippedMesh.tris.reserve(subMesh.tris.size());
+    for (int i = 0; i < subMesh.tris.size(); ++i)
+    {
+        const mesh::Mesh::triangle& t = subMesh.tris[i];
+        clippedMesh.tris.push_back({{t.v[0], t.v[1], t.v[2]}});
+    }
+
+    // clip the sub-mesh by the block core faces shared with another block,
+    // so that the sub-meshes of two neighbour blocks have their seam boundaries on the same plane
+    const Voxel& gridSize = _partitioning.getGridSize();
+    const Voxel block = _partitioning.getBlockCoordinates(blockIndex);
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const int n = gridSize.m[axis];
+        const double epsilon = seamPlaneEpsilon / n;
+
+        if (block.m[axis] > 0)
+            clipMesh(clippedMesh, axis, double(block.m[axis]) / n, -1.0, epsilon);
+        if (block.m[axis] < n - 1)
+            clipMesh(clippedMesh, axis, double(block.m[axis] + 1) / n, 1.0, epsilon);
+    }
+
+    ALICEVISION_LOG_INFO("Sub-mesh of block " << blockIndex << ": " << clippedMesh.tris.size() << " triangles in the block core (" << subMesh.tris.size()
+                                              << " triangles before clipping).");
+
+    // append the clipped mesh and its visibilities, without the unused vertices
+    std::vector<int> ptIdToNewPtId(clippedMesh.pts.size(), -1);
+    for (const std::array<int, 3>& t : clippedMesh.tris)
+    {
+        for (const int v : t)
+            ptIdToNewPtId[v] = 0;
+    }
+
+    const bool hasColors = !clippedMesh.colors.empty() && (_mesh.colors().size() == std::size_t(_mesh.pts.size()));
+
+    for (std::size_t i = 0; i < clippedMesh.pts.size(); ++i)
+    {
+        if (ptIdToNewPtId[i] < 0)
+            continue;
+
+        ptIdToNewPtId[i] = _mesh.pts.size();
+        _mesh.pts.push_back(clippedMesh.pts[i]);
+        _ptsCams.push_back(clippedMesh.ptsCams[i]);
+        _ptsBlock.push_back(blockIndex);
+
+        if (hasColors)
+            _mesh.colors().push_back(clippedMesh.colors[i]);
+    }
+
+    for (const std::array<int, 3>& t : clippedMesh.tris)
+    {
+        _mesh.tris.push_back(mesh::Mesh::triangle(ptIdToNewPtId[t[0]], ptIdToNewPtId[t[1]], ptIdToNewPtId[t[2]]));
+        _trisBlock.push_back(blockIndex);
+    }
+}
+
+void SubMeshMerger::weldSeams(double weldFactor)
+{
+    // directed boundary edges of each block on the core faces shared with another block
+    // note: the two boundaries of a seam are stored separately, for the lower and the upper block index
+    std::map<std::pair<int, int>, std::array<std::vector<std::pair<int, int>>, 2>> seamsEdges;
+    {
+        std::unordered_map<std::uint64_t, std::pair<int, int>> edgesTriangle;  // edge -> (nb triangles, triangle * 3 + k)
+        edgesTriangle.reserve(std::size_t(_mesh.tris.size()) * 2);
+
+        for (int i = 0; i < _mesh.tris.size(); ++i)
+        {
+            const mesh::Mesh::triangle& t = _mesh.tris[i];
+            for (int k = 0; k < 3; ++k)
+            {
+                std::pair<int, int>& edge = edgesTriangle[getEdgeKey(t.v[k], t.v[(k + 1) % 3])];
+                ++edge.first;
+                edge.second = i * 3 + k;
+            }
+        }
+
+        for (const auto& edge : edgesTriangle)
+        {
+            if (edge.second.first != 1)
+                continue;
+
+            const int tri = edge.second.second / 3;
+            const int k = edge.second.second % 3;
+            const int a = _mesh.tris[tri].v[k];
+            const int b = _mesh.tris[tri].v[(k + 1) % 3];
+            const int block = _trisBlock[tri];
+            const int neighbour = getSeamNeighbour(_partitioning, _mesh.pts[a], _mesh.pts[b], block);
+
+            if (neighbour < 0)
+                continue;
+
+            seamsEdges[std::minmax(block, neighbour)][block < neighbour ? 0 : 1].emplace_back(a, b);
+        }
+    }
+
+    if (seamsEdges.empty())
+    {
+        ALICEVISION_LOG_INFO("Weld sub-meshes seams: no seam boundary.");
+        return;
+    }
+
+    const int nbPts = _mesh.pts.size();
+
+    std::vector<int> parents(nbPts);
+    std::iota(parents.begin(), parents.end(), 0);
+
+    // blocks of the vertices of each welded group (sorted, valid for the roots only):
+    // a group never contains two vertices of the same block, so that in-block edges are not collapsed
+    std::vector<std::vector<int>> rootBlocks(nbPts);
+    for (int i = 0; i < nbPts; ++i)
+        rootBlocks[i].push_back(_ptsBlock[i]);
+
+    const auto haveCommonBlock = [](const std::vector<int>& blocksA, const std::vector<int>& blocksB) {
+        auto itA = blocksA.begin();
+        auto itB = blocksB.begin();
+        while (itA != blocksA.end() && itB != blocksB.end())
+        {
+            if (*itA == *itB)
+                return true;
+            if (*itA < *itB)
+                ++itA;
+            else
+                ++itB;
+        }
+        return false;
+    };
+
+    int nbRejectedWelds = 0;
+
+    const auto weld = [&](int a, int b) {
+        const int rootA = findRoot(parents, a);
+        const int rootB = findRoot(parents, b);
+        if (rootA == rootB)
+            return;
+
+        if (haveCommonBlock(rootBlocks[rootA], rootBlocks[rootB]))
+        {
+            ++nbRejectedWelds;
+            return;
+        }
+
+        std::vector<int> blocks;
+        blocks.reserve(rootBlocks[rootA].size() + rootBlocks[rootB].size());
+        std::merge(rootBlocks[rootA].begin(), rootBlocks[rootA].end(), rootBlocks[rootB].begin(), rootBlocks[rootB].end(), std::back_inserter(blocks));
+
+        parents[rootA] = rootB;
+        rootBlocks[rootB].swap(blocks);
+        std::vector<int>().swap(rootBlocks[rootA]);
+    };
+
+    const auto distance = [&](int a, int b) { return (_mesh.pts[a] - _mesh.pts[b]).size(); };
+
+    // match the chains of the two boundaries of each seam
+    // note: the upper block chains are reversed, so that both chains of a pair go in the same direction
+    std::vector<std::pair<Chain, Chain>> chainPairs;
+    int nbChains = 0;
+
+    for (const auto& seamEdges : seamsEdges)
+    {
+        std::vector<Chain> lowerChains = getChains(seamEdges.second[0]);
+        std::vector<Chain> upperChains = getChains(seamEdges.second[1]);
+        nbChains += lowerChains.size() + upperChains.size();
+
+        for (Chain& chain : upperChains)
+            std::reverse(chain.pts.begin(), chain.pts.end());
+
+        // candidate pairs: open chains with close ends, closed chains with close barycenters
+        std::vector<std::tuple<double, int, int>> candidates;
+
+        for (int i = 0; i < int(lowerChains.size()); ++i)
+        {
+            const Chain& lower = lowerChains[i];
+            for (int j = 0; j < int(upperChains.size()); ++j)
+            {
+                const Chain& upper = upperChains[j];
+                if (lower.closed != upper.closed)
+                    continue;
+
+                if (lower.closed)
+                {
+                    candidates.emplace_back((getBarycenter(_mesh.pts, lower) - getBarycenter(_mesh.pts, upper)).size(), i, j);
+                    continue;
+                }
+
+                const double tolerance = weldFactor * std::max({distance(lower.pts[0], lower.pts[1]),
+                                                                distance(lower.pts.rbegin()[0], lower.pts.rbegin()[1]),
+                                                                distance(upper.pts[0], upper.pts[1]),
+                                                                distance(upper.pts.rbegin()[0], upper.pts.rbegin()[1])});
+                const double endsDistance = std::max(distance(lower.pts.front(), upper.pts.front()), distance(lower.pts.back(), upper.pts.back()));
+
+                if (endsDistance <= tolerance)
+                    candidates.emplace_back(endsDistance, i, j);
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+
+        std::vector<bool> lowerMatched(lowerChains.size(), false);
+        std::vector<bool> upperMatched(upperChains.size(), false);
+
+        for (const auto& candidate : candidates)
+        {
+            const int i = std::get<1>(candidate);
+            const int j = std::get<2>(candidate);
+            if (lowerMatched[i] || upperMatched[j])
+                continue;
+
+            Chain& lower = lowerChains[i];
+            Chain& upper = upperChains[j];
+
+            if (lower.closed)
+            {
+                // start both loops at their closest vertices
+                double closestDist = std::numeric_limits<double>::max();
+                std::size_t closestLower = 0;
+                std::size_t closestUpper = 0;
+                double maxEdgeLength = 0.0;
+
+                for (std::size_t a = 0; a < lower.pts.size(); ++a)
+                {
+                    maxEdgeLength = std::max(maxEdgeLength, distance(lower.pts[a], lower.pts[(a + 1) % lower.pts.size()]));
+                    for (std::size_t b = 0; b < upper.pts.size(); ++b)
+                    {
+                        const double d = distance(lower.pts[a], upper.pts[b]);
+                        if (d < closestDist)
+                        {
+                            closestDist = d;
+                            closestLower = a;
+                            closestUpper = b;
+                        }
+                    }
+                }
+
+                if (closestDist > weldFactor * maxEdgeLength)
+                    continue;
+
+                std::rotate(lower.pts.begin(), lower.pts.begin() + closestLower, lower.pts.end());
+                std::rotate(upper.pts.begin(), upper.pts.begin() + closestUpper, upper.pts.end());
+                lower.pts.push_back(lower.pts.front());
+                upper.pts.push_back(upper.pts.front());
+            }
+
+            lowerMatched[i] = true;
+            upperMatched[j] = true;
+
+            weld(lower.pts.front(), upper.pts.front());
+            weld(lower.pts.back(), upper.pts.back());
+
+            chainPairs.emplace_back(std::move(lower), std::move(upper));
+        }
+    }
+
+    if (nbRejectedWelds > 0)
+        ALICEVISION_LOG_INFO("Weld sub-meshes seams: " << nbRejectedWelds << " chain ends not welded (already welded to a vertex of the same block).");
+
+    // welded vertices are moved to the mean position and share their visibilities
+    std::vector<Point3d> sums(nbPts);
+    std::vector<int> counts(nbPts, 0);
+    int nbWeldedPts = 0;
+
+    for (int i = 0; i < nbPts; ++i)
+    {
+        const int root = findRoot(parents, i);
+        sums[root] = sums[root] + _mesh.pts[i];
+        ++counts[root];
+
+        if (root != i)
+        {
+            ++nbWeldedPts;
+            StaticVector<int>& rootCams = _ptsCams[root];
+            for (const int cam : _ptsCams[i])
+            {
+                if (std::find(rootCams.begin(), rootCams.end(), cam) == rootCams.end())
+                    rootCams.push_back(cam);
+            }
+        }
+    }
+
+    for (int i = 0; i < nbPts; ++i)
+    {
+        if (counts[i] > 1)
+            _mesh.pts[i] = sums[i] / double(counts[i]);
+    }
+
+    // stitch each pair of chains with a strip of triangles, advancing along the shortest diagonal
+    // note: a boundary edge a -> b of a block triangle is closed by a triangle with the edge b -> a
+    const auto rootDistance = [&](int a, int b) { return distance(findRoot(parents, a), findRoot(parents, b)); };
+    const int nbTrisBeforeStitching = _mesh.tris.size();
+
+    for (const auto& chainPair : chainPairs)
+    {
+        const std::vector<int>& lower = chainPair.first.pts;
+        const std::vector<int>& upper = chainPair.second.pts;
+        std::size_t i = 0;
+        std::size_t j = 0;
+
+        while (i + 1 < lower.size() || j + 1 < upper.size())
+        {
+            const bool advanceLower = (j + 1 == upper.size()) ||
+                                      (i + 1 < lower.size() && rootDistance(lower[i + 1], upper[j]) <= rootDistance(lower[i], upper[j + 1]));
+
+            if (advanceLower)
+            {
+                _mesh.tris.push_back(mesh::Mesh::triangle(lower[i + 1], lower[i], upper[j]));
+                _trisBlock.push_back(-1);
+                ++i;
+            }
+            else
+            {
+                _mesh.tris.push_back(mesh::Mesh::triangle(upper[j], upper[j + 1], lower[i]));
+                _trisBlock.push_back(-1);
+                ++j;
+            }
+        }
+    }
+
+    ALICEVISION_LOG_INFO("Weld sub-meshes seams: " << seamsEdges.size() << " seams, " << chainPairs.size() << " stitched chain pairs ("
+                                                   << (nbChains - 2 * int(chainPairs.size())) << " unmatched chains), " << nbWeldedPts
+                                                   << " welded vertices, " << (_mesh.tris.size() - nbTrisBeforeStitching) << " stitching triangles.");
+
+    // remap triangles, remove degenerated and duplicated triangles
+    // note: the stitching triangles on welded chain ends are degenerated
+    {
+        StaticVector<mesh::Mesh::triangle> tris;
+        tris.reserve(_mesh.tris.size());
+        std::vector<int> trisBlock;
+        trisBlock.reserve(_mesh.tris.size());
+        std::set<std::array<int, 3>> trisVertices;
+
+        for (int i = 0; i < _mesh.tris.size(); ++i)
+        {
+            mesh::Mesh::triangle t = _mesh.tris[i];
+            for (int k = 0; k < 3; ++k)
+                t.v[k] = findRoot(parents, t.v[k]);
+
+            if (t.v[0] == t.v[1] || t.v[1] == t.v[2] || t.v[2] == t.v[0])
+                continue;
+
+            std::array<int, 3> vertices{{t.v[0], t.v[1], t.v[2]}};
+            std::sort(vertices.begin(), vertices.end());
+            if (!trisVertices.insert(vertices).second)
+                continue;
+
+            tris.push_back(t);
+            trisBlock.push_back(_trisBlock[i]);
+        }
+
+        _mesh.tris.swap(tris);
+        _trisBlock.swap(trisBlock);
+    }
+
+    // remove welded vertices
+    StaticVector<int> ptIdToNewPtId;
+    _mesh.removeFreePointsFromMesh(ptIdToNewPtId);
+
+    StaticVector<StaticVector<int>> ptsCams;
+    ptsCams.resize(_mesh.pts.size());
+    std::vector<int> ptsBlock(_mesh.pts.size());
+
+    for (int i = 0; i < ptIdToNewPtId.size(); ++i)
+    {
+        const int newId = ptIdToNewPtId[i];
+        if (newId > -1)
+        {
+            ptsCams[newId].swap(_ptsCams[i]);
+            ptsBlock[newId] = _ptsBlock[i];
+        }
+    }
+
+    _ptsCams.swap(ptsCams);
+    _ptsBlock.swap(ptsBlock);
+
+    int nbBoundaryEdges = 0;
+    for (const auto& edge : getEdgesNbTriangles(_mesh))
+    {
+        if (edge.second == 1)
+            ++nbBoundaryEdges;
+    }
+
+    ALICEVISION_LOG_INFO("Weld sub-meshes seams done: " << _mesh.pts.size() << " vertices, " << _mesh.tris.size() << " triangles, "
+                                                        << nbBoundaryEdges << " remaining boundary edges.");
+}
+
+mesh::Mesh* SubMeshMerger::releaseMesh(StaticVector<StaticVector<int>>& out_ptsCams)
+{
+    mesh::Mesh* mesh = new mesh::Mesh();
+    mesh->pts.swap(_mesh.pts);
+    mesh->tris.swap(_mesh.tris);
+    if (_mesh.colors().size() == std::size_t(mesh->pts.size()))
+        mesh->colors().swap(_mesh.colors());
+
+    out_ptsCams.swap(_ptsCams);
+
+    _mesh.colors().clear();
+    _ptsCams.clear();
+    _ptsBlock.clear();
+    _trisBlock.clear();
+
+    return mesh;
+}
+
+}  // namespace fuseCut
+}  // namespace aliceVision
@@ -0,0 +1,69 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/fuseCut/SpacePartitioning.hpp>
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mvsData/StaticVector.hpp>
+
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @class Sub-mesh merger
+ * @brief Merge the sub-meshes of the blocks of a SpacePartitioning into a single mesh.
+ * @note Each block sub-mesh is clipped by the block core faces shared with the neighbour blocks,
+ *       so that two neighbour sub-meshes have their seam boundaries on the same plane.
+ *       The two boundaries of each seam are then welded at their ends and stitched together.
+ */
+class SubMeshMerger
+{
+  public:
+    explicit SubMeshMerger(const SpacePartitioning& partitioning)
+      : _partitioning(partitioning)
+    {}
+
+    /**
+     * @brief Add the part of a block sub-mesh inside the block core.
+     * @note Triangles crossing a core face shared with another block are split on the face.
+     * @param[in] subMesh the block sub-mesh
+     * @param[in] subPtsCams the block sub-mesh points visibilities
+     * @param[in] blockIndex the block index in the space partitioning
+     */
+    void addSubMesh(const mesh::Mesh& subMesh, const StaticVector<StaticVector<int>>& subPtsCams, int blockIndex);
+
+    /**
+     * @brief Close the seams between the sub-meshes.
+     * @note The boundaries of two neighbour sub-meshes on their shared core face are split into chains.
+     *       Each chain of a block is paired with the chain of the neighbour block with the closest ends,
+     *       the chain ends are welded and the two chains are stitched with a strip of triangles.
+     *       Chains with ends farther than weldFactor times their end edges length are not paired and remain open.
+     *       Two vertices of the same block are never welded together (directly or through other blocks vertices).
+     * @param[in] weldFactor the maximal distance between paired chain ends, relative to the chain end edges length
+     */
+    void weldSeams(double weldFactor);
+
+    /**
+     * @brief Get the merged mesh and points visibilities.
+     * @note The merger is empty after this call.
+     * @param[out] out_ptsCams the merged mesh points visibilities
+     * @return the merged mesh (ownership is given to the caller)
+     */
+    mesh::Mesh* releaseMesh(StaticVector<StaticVector<int>>& out_ptsCams);
+
+  private:
+    const SpacePartitioning& _partitioning;
+    mesh::Mesh _mesh;                           //< merged mesh
+    StaticVector<StaticVector<int>> _ptsCams;   //< merged mesh points visibilities
+    std::vector<int> _ptsBlock;                 //< merged mesh points block index
+    std::vector<int> _trisBlock;                //< merged mesh triangles block index (-1 for the stitching triangles)
+};
+
+}  // namespace fuseCut
+}  // namespace aliceVision
@@ -0,0 +1,272 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/SpacePartitioning.hpp>
+#include <aliceVision/fuseCut/SubMeshMerger.hpp>
+
+#include <Eigen/Geometry>
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#define BOOST_TEST_MODULE fuseCutSubMeshMerger
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+namespace {
+
+/// axis-aligned hexahedron, same points order as the meshing hexahedron
+std::array<Point3d, 8> createBox(const Point3d& min, const Point3d& max)
+{
+    return {{Point3d(min.x, min.y, min.z),
+             Point3d(max.x, min.y, min.z),
+             Point3d(max.x, max.y, min.z),
+             Point3d(min.x, max.y, min.z),
+             Point3d(min.x, min.y, max.z),
+             Point3d(max.x, min.y, max.z),
+             Point3d(max.x, max.y, max.z),
+             Point3d(min.x, max.y, max.z)}};
+}
+
+/// closed UV sphere, triangles oriented outwards
+void createSphere(const Point3d& center, double radius, int nbRings, int nbSectors, const Eigen::Matrix3d& rotation, mesh::Mesh& mesh)
+{
+    const auto addPoint = [&](const Eigen::Vector3d& p) {
+        const Eigen::Vector3d rotated = rotation * p * radius;
+        mesh.pts.push_back(center + Point3d(rotated.x(), rotated.y(), rotated.z()));
+    };
+
+    addPoint(Eigen::Vector3d(0.0, 0.0, 1.0));
+    for (int r = 1; r < nbRings; ++r)
+    {
+        const double theta = M_PI * r / nbRings;
+        for (int s = 0; s < nbSectors; ++s)
+        {
+            const double phi = 2.0 * M_PI * s / nbSectors;
+            addPoint(Eigen::Vector3d(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)));
+        }
+    }
+    addPoint(Eigen::Vector3d(0.0, 0.0, -1.0));
+
+    const int southPole = mesh.pts.size() - 1;
+    const auto ringPoint = [&](int r, int s) { return 1 + (r - 1) * nbSectors + (s % nbSectors); };
+
+    for (int s = 0; s < nbSectors; ++s)
+    {
+        mesh.tris.push_back(mesh::Mesh::triangle(0, ringPoint(1, s), ringPoint(1, s + 1)));
+        for (int r = 1; r < nbRings - 1; ++r)
+        {
+            mesh.tris.push_back(mesh::Mesh::triangle(ringPoint(r, s), ringPoint(r + 1, s), ringPoint(r + 1, s + 1)));
+            mesh.tris.push_back(mesh::Mesh::triangle(ringPoint(r, s), ringPoint(r + 1, s + 1), ringPoint(r, s + 1)));
+        }
+        mesh.tris.push_back(mesh::Mesh::triangle(ringPoint(nbRings - 1, s), southPole, ringPoint(nbRings - 1, s + 1)));
+    }
+}
+
+/// open height field z = f(x, y) on [-size, size]^2, regular grid triangulation
+void createHeightField(double size, int nbCellsX, int nbCellsY, mesh::Mesh& mesh)
+{
+    for (int j = 0; j <= nbCellsY; ++j)
+    {
+        for (int i = 0; i <= nbCellsX; ++i)
+        {
+            const double x = size * (2.0 * i / nbCellsX - 1.0);
+            const double y = size * (2.0 * j / nbCellsY - 1.0);
+            mesh.pts.push_back(Point3d(x, y, 0.1 * std::sin(2.0 * x) * std::cos(y)));
+        }
+    }
+
+    const auto gridPoint = [&](int i, int j) { return j * (nbCellsX + 1) + i; };
+
+    for (int j = 0; j < nbCellsY; ++j)
+    {
+        for (int i = 0; i < nbCellsX; ++i)
+        {
+            mesh.tris.push_back(mesh::Mesh::triangle(gridPoint(i, j), gridPoint(i + 1, j), gridPoint(i + 1, j + 1)));
+            mesh.tris.push_back(mesh::Mesh::triangle(gridPoint(i, j), gridPoint(i + 1, j + 1), gridPoint(i, j + 1)));
+        }
+    }
+}
+
+/// count the number of triangles of each (undirected) edge
+std::map<std::pair<int, int>, int> getEdgesNbTriangles(const mesh::Mesh& mesh)
+{
+    std::map<std::pair<int, int>, int> edgesNbTris;
+    for (int i = 0; i < mesh.tris.size(); ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            const int a = mesh.tris[i].v[k];
+            const int b = mesh.tris[i].v[(k + 1) % 3];
+            ++edgesNbTris[std::make_pair(std::min(a, b), std::max(a, b))];
+        }
+    }
+    return edgesNbTris;
+}
+
+double getArea(const mesh::Mesh& mesh)
+{
+    double area = 0.0;
+    for (int i = 0; i < mesh.tris.size(); ++i)
+    {
+        const mesh::Mesh::triangle& t = mesh.tris[i];
+        area += 0.5 * cross(mesh.pts[t.v[1]] - mesh.pts[t.v[0]], mesh.pts[t.v[2]] - mesh.pts[t.v[0]]).size();
+    }
+    return area;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(fuseCut_spacePartitioning)
+{
+    const std::array<Point3d, 8> hexah = createBox(Point3d(-2.0, -1.0, -0.5), Point3d(2.0, 1.0, 0.5));
+    const SpacePartitioning partitioning(hexah.data(), 8, 0.1);
+
+    // the longest block axis is split first: 1x1x1, 2x1x1, 3x1x1, 3x2x1, 4x2x1 blocks of size 1
+    BOOST_CHECK_EQUAL(partitioning.getGridSize().x, 4);
+    BOOST_CHECK_EQUAL(partitioning.getGridSize().y, 2);
+    BOOST_CHECK_EQUAL(partitioning.getGridSize().z, 1);
+    BOOST_CHECK_EQUAL(partitioning.getNbBlocks(), 8);
+
+    BOOST_CHECK_EQUAL(partitioning.getBlockIndex(Point3d(-1.5, -0.5, 0.0)), 0);
+    BOOST_CHECK_EQUAL(partitioning.getBlockIndex(Point3d(1.5, 0.5, 0.0)), 7);
+    BOOST_CHECK_EQUAL(partitioning.getBlockIndex(Point3d(2.0, 1.0, 0.5)), 7);
+    BOOST_CHECK_EQUAL(partitioning.getBlockIndex(Point3d(2.5, 0.0, 0.0)), -1);
+
+    for (int blockIndex = 0; blockIndex < partitioning.getNbBlocks(); ++blockIndex)
+    {
+        const Voxel block = partitioning.getBlockCoordinates(blockIndex);
+        const std::array<Point3d, 8> blockHexah = partitioning.getBlockHexahedron(blockIndex);
+
+        BOOST_CHECK_EQUAL(partitioning.getBlockIndex(block), blockIndex);
+
+        // the block core center belongs to the block
+        const Point3d coreCenter(-2.0 + (block.x + 0.5), -1.0 + (block.y + 0.5), 0.0);
+        BOOST_CHECK_EQUAL(partitioning.getBlockIndex(coreCenter), blockIndex);
+
+        // the block hexahedron is the block core inflated by the overlap, clamped to the hexahedron
+        BOOST_CHECK_CLOSE(blockHexah[0].x, std::max(-2.0, -2.0 + block.x - 0.1), 1e-9);
+        BOOST_CHECK_CLOSE(blockHexah[6].x, std::min(2.0, -2.0 + block.x + 1.1), 1e-9);
+        BOOST_CHECK_CLOSE(blockHexah[0].y, std::max(-1.0, -1.0 + block.y - 0.1), 1e-9);
+        BOOST_CHECK_CLOSE(blockHexah[6].y, std::min(1.0, -1.0 + block.y + 1.1), 1e-9);
+        BOOST_CHECK_CLOSE(blockHexah[0].z, -0.5, 1e-9);
+        BOOST_CHECK_CLOSE(blockHexah[6].z, 0.5, 1e-9);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_subMeshMerger_watertightSeams)
+{
+    // a closed surface crossing all the seams of a 2x2x2 partitioning,
+    // each block meshes it with a different triangulation (as independent graph-cuts would do)
+    const std::array<Point3d, 8> hexah = createBox(Point3d(-1.5, -1.5, -1.5), Point3d(1.5, 1.5, 1.5));
+    const SpacePartitioning partitioning(hexah.data(), 8, 0.1);
+    BOOST_REQUIRE_EQUAL(partitioning.getNbBlocks(), 8);
+
+    const Point3d center(0.1, -0.05, 0.07);
+    const double radius = 1.0;
+
+    SubMeshMerger merger(partitioning);
+
+    for (int blockIndex = 0; blockIndex < partitioning.getNbBlocks(); ++blockIndex)
+    {
+        const Eigen::Matrix3d rotation = (Eigen::AngleAxisd(0.3 * blockIndex, Eigen::Vector3d::UnitZ()) *
+                                          Eigen::AngleAxisd(0.7 + 0.2 * blockIndex, Eigen::Vector3d::UnitX()))
+                                           .toRotationMatrix();
+        mesh::Mesh subMesh;
+        createSphere(center, radius, 20 + 2 * blockIndex, 32 + 3 * blockIndex, rotation, subMesh);
+
+        StaticVector<StaticVector<int>> subPtsCams;
+        subPtsCams.resize(subMesh.pts.size());
+        for (int i = 0; i < subPtsCams.size(); ++i)
+            subPtsCams[i].push_back(blockIndex);
+
+        merger.addSubMesh(subMesh, subPtsCams, blockIndex);
+    }
+
+    merger.weldSeams(1.0);
+
+    StaticVector<StaticVector<int>> ptsCams;
+    std::unique_ptr<mesh::Mesh> mergedMesh(merger.releaseMesh(ptsCams));
+
+    BOOST_REQUIRE_EQUAL(ptsCams.size(), mergedMesh->pts.size());
+    BOOST_CHECK_GT(mergedMesh->tris.size(), 0);
+
+    // no boundary edge (nor non-manifold edge) along the seams
+    int nbOpenEdges = 0;
+    for (const auto& edge : getEdgesNbTriangles(*mergedMesh))
+    {
+        if (edge.second != 2)
+            ++nbOpenEdges;
+    }
+    BOOST_CHECK_EQUAL(nbOpenEdges, 0);
+
+    // the merged surface is the sphere
+    for (int i = 0; i < mergedMesh->pts.size(); ++i)
+    {
+        BOOST_CHECK_SMALL((mergedMesh->pts[i] - center).size() - radius, 0.02);
+        BOOST_CHECK(!ptsCams[i].empty());
+    }
+    BOOST_CHECK_CLOSE(getArea(*mergedMesh), 4.0 * M_PI * radius * radius, 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_subMeshMerger_openSurfaceSeams)
+{
+    // an open surface crossing the seams of a 2x2x1 partitioning, the seams end on the surface border
+    const std::array<Point3d, 8> hexah = createBox(Point3d(-1.5, -1.5, -0.5), Point3d(1.5, 1.5, 0.5));
+    const SpacePartitioning partitioning(hexah.data(), 4, 0.1);
+    BOOST_REQUIRE_EQUAL(partitioning.getGridSize().z, 1);
+    BOOST_REQUIRE_EQUAL(partitioning.getNbBlocks(), 4);
+
+    const double size = 1.2;
+
+    SubMeshMerger merger(partitioning);
+
+    for (int blockIndex = 0; blockIndex < partitioning.getNbBlocks(); ++blockIndex)
+    {
+        mesh::Mesh subMesh;
+        createHeightField(size, 11 + 3 * blockIndex, 13 + 2 * blockIndex, subMesh);
+
+        StaticVector<StaticVector<int>> subPtsCams;
+        subPtsCams.resize(subMesh.pts.size());
+        for (int i = 0; i < subPtsCams.size(); ++i)
+            subPtsCams[i].push_back(blockIndex);
+
+        merger.addSubMesh(subMesh, subPtsCams, blockIndex);
+    }
+
+    merger.weldSeams(1.0);
+
+    StaticVector<StaticVector<int>> ptsCams;
+    std::unique_ptr<mesh::Mesh> mergedMesh(merger.releaseMesh(ptsCams));
+
+    // the only boundary edges are on the surface border
+    const auto isOnBorder = [&](const Point3d& p) { return std::abs(std::abs(p.x) - size) < 1e-9 || std::abs(std::abs(p.y) - size) < 1e-9; };
+
+    int nbInnerOpenEdges = 0;
+    int nbBorderEdges = 0;
+    for (const auto& edge : getEdgesNbTriangles(*mergedMesh))
+    {
+        const bool border = isOnBorder(mergedMesh->pts[edge.first.first]) && isOnBorder(mergedMesh->pts[edge.first.second]);
+        if (edge.second == 1 && border)
+            ++nbBorderEdges;
+        else if (edge.second != 2)
+            ++nbInnerOpenEdges;
+    }
+    BOOST_CHECK_EQUAL(nbInnerOpenEdges, 0);
+    BOOST_CHECK_GT(nbBorderEdges, 0);
+
+    // the merged surface is the height field
+    mesh::Mesh fineMesh;
+    createHeightField(size, 200, 200, fineMesh);
+    BOOST_CHECK_CLOSE(getArea(*mergedMesh), getArea(fineMesh), 1.0);
+}
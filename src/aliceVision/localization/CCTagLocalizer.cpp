@@ -929,7 +929,7 @@ float viewSimilarity(const feature::CCTAG_Regions& regionsA, const feature::CCTA
     return (descriptorViewA & descriptorViewB).count();
 }
 
-std::bitset<128> constructCCTagViewDescriptor(const std::vector<feature::CCTAG_Regions::DescriptorT>& vCCTagDescriptors)
+std::bitset<128> constructCCTagViewDescriptor(const feature::CCTAG_Regions::DescsViewT& vCCTagDescriptors)
 {
     std::bitset<128> descriptorView;
     for (const auto& cctagDescriptor : vCCTagDescriptors)
@@ -199,7 +199,7 @@ void kNearestKeyFrames(const feature::CCTAG_Regions& queryRegions,
  * @return The view descriptor as a set of bit representing the visibility of
  * each possible marker for that view.
  */
-std::bitset<128> constructCCTagViewDescriptor(const std::vector<feature::CCTAG_Regions::DescriptorT>& vCCTagDescriptors);
+std::bitset<128> constructCCTagViewDescriptor(const feature::CCTAG_Regions::DescsViewT& vCCTagDescriptors);
 
 float viewSimilarity(const feature::CCTAG_Regions& regionsA, const feature::CCTAG_Regions& regionsB);
 
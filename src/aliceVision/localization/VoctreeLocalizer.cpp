@@ -341,7 +341,7 @@ bool VoctreeLocalizer::initDatabase(const std::string& vocTreeFilepath, const st
 
             if (descType == _voctreeDescType)
             {
-                voctree::SparseHistogram histo = _voctree->quantizeToSparse(currRegions->blindDescriptors());
+                voctree::SparseHistogram histo = _voctree->quantizeToSparse(currRegions->blindDescriptors(), currRegions->RegionCount());
 #pragma omp critical
                 {
                     _database.insert(id_view, histo);
@@ -374,7 +374,8 @@ bool VoctreeLocalizer::localizeFirstBestResult(const feature::MapRegionsPerDesc&
     ALICEVISION_LOG_DEBUG("[database]\tRequest closest images from voctree");
     // pass the descriptors through the vocabulary tree to get the visual words
     // associated to each feature
-    voctree::SparseHistogram requestImageWords = _voctree->quantizeToSparse(queryRegions.at(_voctreeDescType)->blindDescriptors());
+    voctree::SparseHistogram requestImageWords = _voctree->quantizeToSparse(queryRegions.at(_voctreeDescType)->blindDescriptors(),
+                                                                          queryRegions.at(_voctreeDescType)->RegionCount());
 
     // Request closest images from voctree
     std::vector<voctree::DocMatch> matchedImages;
@@ -741,7 +742,8 @@ void VoctreeLocalizer::getAllAssociations(const feature::MapRegionsPerDesc& quer
                                                                 << " in query region.");
         return;
     }
-    voctree::SparseHistogram requestImageWords = _voctree->quantizeToSparse(queryRegions.at(_voctreeDescType)->blindDescriptors());
+    voctree::SparseHistogram requestImageWords = _voctree->quantizeToSparse(queryRegions.at(_voctreeDescType)->blindDescriptors(),
+                                                                          queryRegions.at(_voctreeDescType)->RegionCount());
 
     // Request closest images from voctree
     _database.find(requestImageWords, (param._numResults == 0) ? (_database.size()) : (param._numResults), out_matchedImages);
@@ -10,12 +10,14 @@
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/matching/ArrayMatcher.hpp>
 #include <aliceVision/feature/metric.hpp>
-#include <aliceVision/stl/indexedSort.hpp>
 
 #include <aliceVision/config.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
 #include <memory>
-#include <iostream>
+#include <vector>
 
 namespace aliceVision {
 namespace matching {
@@ -65,21 +67,20 @@ class ArrayMatcher_bruteForce : public ArrayMatcher<Scalar, Metric>
         if (memMapping.get() == nullptr)
             return false;
 
-        // matrix representation of the input data;
-        Eigen::Map<BaseMat> mat_query((Scalar*)query, 1, (*memMapping).cols());
+        const int nbRows = static_cast<int>((*memMapping).rows());
+        const int dimension = static_cast<int>((*memMapping).cols());
+        const Scalar* rowPtr = (*memMapping).data();
         Metric metric;
-        std::vector<DistanceType> vec_dist((*memMapping).rows(), 0.0);
-        for (int i = 0; i < (*memMapping).rows(); ++i)
-        {
-            // Compute Distance Metric
-            vec_dist[i] = metric((Scalar*)query, (*memMapping).row(i).data(), (*memMapping).cols());
-        }
-        if (!vec_dist.empty())
+
+        // running minimum (first occurrence on ties)
+        for (int i = 0; i < nbRows; ++i, rowPtr += dimension)
         {
-            // Find the minimum distance :
-            typename std::vector<DistanceType>::const_iterator min_iter = min_element(vec_dist.begin(), vec_dist.end());
-            *indice = std::distance(typename std::vector<DistanceType>::const_iterator(vec_dist.begin()), min_iter);
-            *distance = static_cast<DistanceType>(*min_iter);
+            const DistanceType dist = metric(query, rowPtr, dimension);
+            if (i == 0 || dist < *distance)
+            {
+                *indice = i;
+                *distance = dist;
+            }
         }
         return true;
     }
@@ -102,46 +103,131 @@ class ArrayMatcher_bruteForce : public ArrayMatcher<Scalar, Metric>
             return false;
         }
 
+        // not enough dataset rows to find NN neighbours: no result, as the unfilled
+        // neighbours would have no valid index
         if (NN > (*memMapping).rows() || nbQuery < 1)
         {
             return false;
         }
 
-        // matrix representation of the input data;
-        Eigen::Map<BaseMat> mat_query((Scalar*)query, nbQuery, (*memMapping).cols());
-        Metric metric;
+        const int nbRows = static_cast<int>((*memMapping).rows());
+        const int dimension = static_cast<int>((*memMapping).cols());
+        // every neighbour slot is filled by a dataset row since NN <= nbRows
+        const int nbNeighbours = static_cast<int>(std::min(NN, static_cast<std::size_t>(nbRows)));
+        const Scalar* datasetPtr = (*memMapping).data();
 
         pvec_distances->resize(nbQuery * NN);
         pvec_indices->resize(nbQuery * NN);
 
+        const int nbQueryBlocks = (nbQuery + queryBlockSize - 1) / queryBlockSize;
+
+        // blocked query x dataset traversal: a block of dataset rows stays in cache
+        // while it is compared to all the queries of the block.
 #pragma omp parallel for schedule(dynamic)
-        for (int queryIndex = 0; queryIndex < nbQuery; ++queryIndex)
+        for (int queryBlock = 0; queryBlock < nbQueryBlocks; ++queryBlock)
         {
-            std::vector<DistanceType> vec_distance((*memMapping).rows(), 0.0);
-            const Scalar* queryPtr = mat_query.row(queryIndex).data();
-            const Scalar* rowPtr = (*memMapping).data();
-            for (int i = 0; i < (*memMapping).rows(); ++i)
+            const int queryBegin = queryBlock * queryBlockSize;
+            const int queryEnd = std::min(queryBegin + queryBlockSize, nbQuery);
+            Metric metric;
+
+            // sorted N best (distance, index) of each query of the block
+            std::vector<DistanceType> bestDistances(queryBlockSize * NN, std::numeric_limits<DistanceType>::max());
+            std::vector<int> bestIndices(queryBlockSize * NN, -1);
+
+            for (int rowBegin = 0; rowBegin < nbRows; rowBegin += datasetBlockSize)
             {
-                vec_distance[i] = metric(queryPtr, rowPtr, (*memMapping).cols());
-                rowPtr += (*memMapping).cols();
+                const int rowEnd = std::min(rowBegin + datasetBlockSize, nbRows);
+
+                for (int queryIndex = queryBegin; queryIndex < queryEnd; ++queryIndex)
+                {
+                    const Scalar* queryPtr = query + static_cast<std::size_t>(queryIndex) * dimension;
+                    DistanceType* queryBestDistances = &bestDistances[(queryIndex - queryBegin) * NN];
+                    int* queryBestIndices = &bestIndices[(queryIndex - queryBegin) * NN];
+
+                    if (nbNeighbours == 2)
+                    {
+                        // ratio test case: keep the top-2 in locals
+                        DistanceType best0 = queryBestDistances[0];
+                        DistanceType best1 = queryBestDistances[1];
+                        int index0 = queryBestIndices[0];
+                        int index1 = queryBestIndices[1];
+
+                        const Scalar* rowPtr = datasetPtr + static_cast<std::size_t>(rowBegin) * dimension;
+                        for (int i = rowBegin; i < rowEnd; ++i, rowPtr += dimension)
+                        {
+                            const DistanceType dist = metric(queryPtr, rowPtr, dimension);
+                            if (dist < best1 || index1 < 0)
+                            {
+                                if (dist < best0 || index0 < 0)
+                                {
+                                    best1 = best0;
+                                    index1 = index0;
+                                    best0 = dist;
+                                    index0 = i;
+                                }
+                                else
+                                {
+                                    best1 = dist;
+                                    index1 = i;
+                                }
+                            }
+                        }
+
+                        queryBestDistances[0] = best0;
+                        queryBestDistances[1] = best1;
+                        queryBestIndices[0] = index0;
+                        queryBestIndices[1] = index1;
+                    }
+                    else
+                    {
+                        const Scalar* rowPtr = datasetPtr + static_cast<std::size_t>(rowBegin) * dimension;
+                        for (int i = rowBegin; i < rowEnd; ++i, rowPtr += dimension)
+                        {
+                            const DistanceType dist = metric(queryPtr, rowPtr, dimension);
+                            insertNeighbour(queryBestDistances, queryBestIndices, nbNeighbours, dist, i);
+                        }
+                    }
+                }
             }
 
-            // Find the N minimum distances:
-            const int maxMinFound = (int)std::min(size_t(NN), vec_distance.size());
-            using namespace stl::indexed_sort;
-            std::vector<sort_index_packet_ascend<DistanceType, int>> packet_vec(vec_distance.size());
-            sort_index_helper(packet_vec, &vec_distance[0], maxMinFound);
-
-            for (int i = 0; i < maxMinFound; ++i)
+            for (int queryIndex = queryBegin; queryIndex < queryEnd; ++queryIndex)
             {
-                (*pvec_distances)[queryIndex * NN + i] = packet_vec[i].val;
-                (*pvec_indices)[queryIndex * NN + i] = IndMatch(queryIndex, packet_vec[i].index);
+                for (int i = 0; i < nbNeighbours; ++i)
+                {
+                    assert(bestIndices[(queryIndex - queryBegin) * NN + i] >= 0);
+                    (*pvec_distances)[queryIndex * NN + i] = bestDistances[(queryIndex - queryBegin) * NN + i];
+                    (*pvec_indices)[queryIndex * NN + i] = IndMatch(queryIndex, bestIndices[(queryIndex - queryBegin) * NN + i]);
+                }
             }
         }
         return true;
     };
 
   private:
+    /// Number of queries and dataset rows of a block
+    static constexpr int queryBlockSize = 32;
+    static constexpr int datasetBlockSize = 256;
+
+    /**
+     * @brief Insert a candidate in a sorted list of the N best neighbours.
+     *        On ties, the first inserted candidate stays first.
+     */
+    static void insertNeighbour(DistanceType* bestDistances, int* bestIndices, int nbNeighbours, DistanceType dist, int index)
+    {
+        int position = nbNeighbours;
+        while (position > 0 && (bestIndices[position - 1] < 0 || dist < bestDistances[position - 1]))
+            --position;
+        if (position == nbNeighbours)
+            return;
+        for (int i = nbNeighbours - 1; i > position; --i)
+        {
+            bestDistances[i] = bestDistances[i - 1];
+            bestIndices[i] = bestIndices[i - 1];
+        }
+        bestDistances[position] = dist;
+        bestIndices[position] = index;
+    }
+
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> BaseMat;
     /// Use a memory mapping in order to avoid memory re-allocation
     std::unique_ptr<Eigen::Map<BaseMat>> memMapping;
@@ -10,33 +10,75 @@
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/feature/metric.hpp>
 #include <aliceVision/matching/IndMatch.hpp>
-#include <aliceVision/stl/DynamicBitset.hpp>
+#include <aliceVision/feature/distanceKernels.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <random>
-#include <cmath>
+#include <utility>
+#include <vector>
 
 namespace aliceVision {
 namespace matching {
 
-struct HashedDescription
+/**
+ * Hash codes and buckets of a set of descriptions, stored in flat arrays.
+ *
+ * Buckets are stored per bucket group in a compressed layout: the descriptions of
+ * the bucket b of the group g are [bucketBegin(g, b), bucketEnd(g, b)).
+ */
+struct HashedDescriptions
 {
-    // Hash code generated by the primary hashing function.
-    stl::dynamic_bitset hash_code;
+    int nbDescriptions = 0;
+    /// number of bytes of a hash code
+    int hashCodeSize = 0;
+    int nbBucketGroups = 0;
+    int nbBucketsPerGroup = 0;
+
+    /// hashCodeSize bytes per description
+    std::vector<uint8_t> hashCodes;
+    /// nbBucketGroups bucket ids per description
+    std::vector<uint16_t> bucketIds;
+    /// nbBucketsPerGroup + 1 offsets per bucket group
+    std::vector<int> bucketOffsets;
+    /// nbDescriptions description ids per bucket group, sorted by bucket id
+    std::vector<int> bucketDescriptions;
+
+    const uint8_t* hashCode(int description) const { return hashCodes.data() + static_cast<std::size_t>(description) * hashCodeSize; }
+
+    uint16_t bucketId(int description, int bucketGroup) const { return bucketIds[static_cast<std::size_t>(description) * nbBucketGroups + bucketGroup]; }
+
+    const int* bucketBegin(int bucketGroup, uint16_t bucket) const
+    {
+        return bucketDescriptions.data() + static_cast<std::size_t>(bucketGroup) * nbDescriptions +
+               bucketOffsets[static_cast<std::size_t>(bucketGroup) * (nbBucketsPerGroup + 1) + bucket];
+    }
 
-    // Each bucket_ids[x] = y means the descriptor belongs to bucket y in bucket
-    // group x.
-    std::vector<uint16_t> bucket_ids;
+    const int* bucketEnd(int bucketGroup, uint16_t bucket) const
+    {
+        return bucketDescriptions.data() + static_cast<std::size_t>(bucketGroup) * nbDescriptions +
+               bucketOffsets[static_cast<std::size_t>(bucketGroup) * (nbBucketsPerGroup + 1) + bucket + 1];
+    }
 };
 
-struct HashedDescriptions
+/**
+ * Buffers used by CascadeHasher::Match_HashedDescriptions.
+ * Keep one per thread and reuse it across the matched pairs to avoid reallocations.
+ */
+struct CascadeHasherMatchingBuffers
 {
-    // The hash information.
-    std::vector<HashedDescription> hashed_desc;
-
-    typedef std::vector<int> Bucket;
-    // buckets[bucket_group][bucket_id] = bucket (container of description ids).
-    std::vector<std::vector<Bucket>> buckets;
+    /// unique candidates of the current query
+    std::vector<int> candidates;
+    /// hamming distance of each candidate
+    std::vector<int> candidateHammingDistances;
+    /// candidates sorted by hamming distance
+    std::vector<int> sortedCandidates;
+    /// number of candidates for each hamming distance (then offsets)
+    std::vector<int> hammingDistanceOffsets;
+    /// flag of the dataset descriptions already in candidates (reset after each query)
+    std::vector<char> usedDescriptions;
 };
 
 /**
@@ -110,6 +152,10 @@ class CascadeHasher
                     secondary_hash_projection_[i](j, k) = d(generator);
             }
         }
+
+        secondary_hash_projection_all_.resize(nb_bucket_groups * nb_bits_per_bucket_, nb_hash_code);
+        for (int i = 0; i < nb_bucket_groups; ++i)
+            secondary_hash_projection_all_.middleRows(i * nb_bits_per_bucket_, nb_bits_per_bucket_) = secondary_hash_projection_[i];
         return true;
     }
 
@@ -140,66 +186,85 @@ class CascadeHasher
         //   2) Construct buckets.
 
         HashedDescriptions hashed_descriptions;
+        hashed_descriptions.nbBucketGroups = nb_bucket_groups_;
+        hashed_descriptions.nbBucketsPerGroup = nb_buckets_per_group_;
+        hashed_descriptions.hashCodeSize = (nb_hash_code_ + 7) / 8;
+        hashed_descriptions.bucketOffsets.assign(static_cast<std::size_t>(nb_bucket_groups_) * (nb_buckets_per_group_ + 1), 0);
+
         if (descriptions.rows() == 0)
         {
             return hashed_descriptions;
         }
 
+        const int nbDescriptions = static_cast<int>(descriptions.rows());
+        hashed_descriptions.nbDescriptions = nbDescriptions;
+        hashed_descriptions.hashCodes.assign(static_cast<std::size_t>(nbDescriptions) * hashed_descriptions.hashCodeSize, 0);
+        hashed_descriptions.bucketIds.resize(static_cast<std::size_t>(nbDescriptions) * nb_bucket_groups_);
+
         // Create hash codes for each description.
+        // Descriptions are projected by blocks with matrix products.
         {
-            // Allocate space for hash codes.
-            const typename MatrixT::Index nbDescriptions = descriptions.rows();
-            hashed_descriptions.hashed_desc.resize(nbDescriptions);
-            Eigen::VectorXf descriptor(descriptions.cols());
-            for (int i = 0; i < nbDescriptions; ++i)
-            {
-                // Allocate space for each bucket id.
-                hashed_descriptions.hashed_desc[i].bucket_ids.resize(nb_bucket_groups_);
+            static const int kBlockSize = 1024;
+            Eigen::MatrixXf block;
+            Eigen::MatrixXf primary_projection;
+            Eigen::MatrixXf secondary_projection;
 
-                for (int k = 0; k < descriptions.cols(); ++k)
-                {
-                    descriptor(k) = descriptions(i, k);
-                }
-                descriptor -= zero_mean_descriptor;
+            for (int blockBegin = 0; blockBegin < nbDescriptions; blockBegin += kBlockSize)
+            {
+                const int blockSize = std::min(kBlockSize, nbDescriptions - blockBegin);
 
-                auto& hash_code = hashed_descriptions.hashed_desc[i].hash_code;
-                hash_code = stl::dynamic_bitset(descriptions.cols());
+                // zero mean descriptions as columns
+                block = descriptions.middleRows(blockBegin, blockSize).template cast<float>().transpose();
+                block.colwise() -= zero_mean_descriptor;
 
                 // Compute hash code.
-                const Eigen::VectorXf primary_projection = primary_hash_projection_ * descriptor;
-                for (int j = 0; j < nb_hash_code_; ++j)
+                primary_projection.noalias() = primary_hash_projection_ * block;
+                for (int i = 0; i < blockSize; ++i)
                 {
-                    hash_code[j] = primary_projection(j) > 0;
+                    uint8_t* hash_code = hashed_descriptions.hashCodes.data() +
+                                         static_cast<std::size_t>(blockBegin + i) * hashed_descriptions.hashCodeSize;
+                    for (int j = 0; j < nb_hash_code_; ++j)
+                    {
+                        if (primary_projection(j, i) > 0)
+                            hash_code[j / 8] |= uint8_t(1) << (j % 8);
+                    }
                 }
 
                 // Determine the bucket index for each group.
-                Eigen::VectorXf secondary_projection;
-                for (int j = 0; j < nb_bucket_groups_; ++j)
+                secondary_projection.noalias() = secondary_hash_projection_all_ * block;
+                for (int i = 0; i < blockSize; ++i)
                 {
-                    uint16_t bucket_id = 0;
-                    secondary_projection = secondary_hash_projection_[j] * descriptor;
-
-                    for (int k = 0; k < nb_bits_per_bucket_; ++k)
+                    uint16_t* bucket_ids = hashed_descriptions.bucketIds.data() + static_cast<std::size_t>(blockBegin + i) * nb_bucket_groups_;
+                    for (int j = 0; j < nb_bucket_groups_; ++j)
                     {
-                        bucket_id = (bucket_id << 1) + (secondary_projection(k) > 0 ? 1 : 0);
+                        uint16_t bucket_id = 0;
+                        for (int k = 0; k < nb_bits_per_bucket_; ++k)
+                        {
+                            bucket_id = (bucket_id << 1) + (secondary_projection(j * nb_bits_per_bucket_ + k, i) > 0 ? 1 : 0);
+                        }
+                        bucket_ids[j] = bucket_id;
                     }
-                    hashed_descriptions.hashed_desc[i].bucket_ids[j] = bucket_id;
                 }
             }
         }
-        // Build the Buckets
+        // Build the Buckets (counting sort of the description ids by bucket id)
         {
-            hashed_descriptions.buckets.resize(nb_bucket_groups_);
+            hashed_descriptions.bucketDescriptions.resize(static_cast<std::size_t>(nb_bucket_groups_) * nbDescriptions);
+            std::vector<int> insertPositions(nb_buckets_per_group_);
+
             for (int i = 0; i < nb_bucket_groups_; ++i)
             {
-                hashed_descriptions.buckets[i].resize(nb_buckets_per_group_);
+                int* offsets = hashed_descriptions.bucketOffsets.data() + static_cast<std::size_t>(i) * (nb_buckets_per_group_ + 1);
+                for (int j = 0; j < nbDescriptions; ++j)
+                    ++offsets[hashed_descriptions.bucketId(j, i) + 1];
+                for (int b = 0; b < nb_buckets_per_group_; ++b)
+                    offsets[b + 1] += offsets[b];
 
                 // Add the descriptor ID to the proper bucket group and id.
-                for (int j = 0; j < hashed_descriptions.hashed_desc.size(); ++j)
-                {
-                    const uint16_t bucket_id = hashed_descriptions.hashed_desc[j].bucket_ids[i];
-                    hashed_descriptions.buckets[i][bucket_id].push_back(j);
-                }
+                std::copy(offsets, offsets + nb_buckets_per_group_, insertPositions.begin());
+                int* bucketDescriptions = hashed_descriptions.bucketDescriptions.data() + static_cast<std::size_t>(i) * nbDescriptions;
+                for (int j = 0; j < nbDescriptions; ++j)
+                    bucketDescriptions[insertPositions[hashed_descriptions.bucketId(j, i)]++] = j;
             }
         }
         return hashed_descriptions;
@@ -215,95 +280,108 @@ class CascadeHasher
                                   IndMatches* pvec_indices,
                                   std::vector<DistanceType>* pvec_distances,
                                   const int NN = 2) const
+    {
+        CascadeHasherMatchingBuffers buffers;
+        Match_HashedDescriptions(hashed_descriptions1, descriptions1, hashed_descriptions2, descriptions2, pvec_indices, pvec_distances, buffers, NN);
+    }
+
+    // Matches two collection of hashed descriptions, reusing the given buffers.
+    template<typename MatrixT, typename DistanceType>
+    void Match_HashedDescriptions(const HashedDescriptions& hashed_descriptions1,
+                                  const MatrixT& descriptions1,
+                                  const HashedDescriptions& hashed_descriptions2,
+                                  const MatrixT& descriptions2,
+                                  IndMatches* pvec_indices,
+                                  std::vector<DistanceType>* pvec_distances,
+                                  CascadeHasherMatchingBuffers& buffers,
+                                  const int NN = 2) const
     {
         typedef feature::L2_Vectorized<typename MatrixT::Scalar> MetricT;
         MetricT metric;
 
         static const int kNumTopCandidates = 10;
 
-        // Preallocate the candidate descriptors container.
-        std::vector<int> candidate_descriptors;
-        candidate_descriptors.reserve(hashed_descriptions2.hashed_desc.size());
+        std::vector<int>& candidate_descriptors = buffers.candidates;
+        std::vector<int>& candidate_hamming_distances = buffers.candidateHammingDistances;
+        std::vector<int>& sorted_candidates = buffers.sortedCandidates;
+        std::vector<int>& hamming_distance_offsets = buffers.hammingDistanceOffsets;
 
-        // Preallocated hamming distances. Each column indicates the hamming distance
-        // and the rows collect the descriptor ids with that
-        // distance. num_descriptors_with_hamming_distance keeps track of how many
-        // descriptors have that distance.
-        Eigen::MatrixXi candidate_hamming_distances(hashed_descriptions2.hashed_desc.size(), nb_hash_code_ + 1);
-        Eigen::VectorXi num_descriptors_with_hamming_distance(nb_hash_code_ + 1);
+        // A vector to determine if we have already used a particular
+        // feature for matching (i.e., prevents duplicates).
+        std::vector<char>& used_descriptor = buffers.usedDescriptions;
+        used_descriptor.assign(hashed_descriptions2.nbDescriptions, 0);
 
-        // Preallocate the container for keeping euclidean distances.
-        std::vector<std::pair<DistanceType, int>> candidate_euclidean_distances;
-        candidate_euclidean_distances.reserve(kNumTopCandidates);
+        // Container for keeping euclidean distances.
+        std::pair<DistanceType, int> candidate_euclidean_distances[kNumTopCandidates];
 
-        // A preallocated vector to determine if we have already used a particular
-        // feature for matching (i.e., prevents duplicates).
-        std::vector<bool> used_descriptor(hashed_descriptions2.hashed_desc.size());
+        const int hashCodeSize = hashed_descriptions1.hashCodeSize;
 
-        typedef feature::Hamming<stl::dynamic_bitset::BlockType> HammingMetricType;
-        static const HammingMetricType metricH = {};
-        for (int i = 0; i < hashed_descriptions1.hashed_desc.size(); ++i)
+        for (int i = 0; i < hashed_descriptions1.nbDescriptions; ++i)
         {
             candidate_descriptors.clear();
-            num_descriptors_with_hamming_distance.setZero();
-            candidate_euclidean_distances.clear();
-
-            const auto& hashed_desc = hashed_descriptions1.hashed_desc[i];
 
             // Accumulate all descriptors in each bucket group that are in the same
             // bucket id as the query descriptor.
+            std::size_t nbCandidates = 0;
             for (int j = 0; j < nb_bucket_groups_; ++j)
             {
-                const uint16_t bucket_id = hashed_desc.bucket_ids[j];
-                for (const auto& feature_id : hashed_descriptions2.buckets[j][bucket_id])
+                const uint16_t bucket_id = hashed_descriptions1.bucketId(i, j);
+                const int* bucketEnd = hashed_descriptions2.bucketEnd(j, bucket_id);
+                for (const int* it = hashed_descriptions2.bucketBegin(j, bucket_id); it != bucketEnd; ++it)
                 {
-                    candidate_descriptors.emplace_back(feature_id);
-                    used_descriptor[feature_id] = false;
+                    if (!used_descriptor[*it])  // avoid selecting the same candidate multiple times
+                    {
+                        used_descriptor[*it] = 1;
+                        candidate_descriptors.push_back(*it);
+                    }
                 }
+                nbCandidates += bucketEnd - hashed_descriptions2.bucketBegin(j, bucket_id);
             }
+            for (const int candidate_id : candidate_descriptors)
+                used_descriptor[candidate_id] = 0;
 
             // Skip matching this descriptor if there are not at least NN candidates.
-            if (candidate_descriptors.size() <= NN)
+            if (nbCandidates <= static_cast<std::size_t>(NN))
             {
                 continue;
             }
 
             // Compute the hamming distance of all candidates based on the comp hash
-            // code. Put the descriptors into buckets corresponding to their hamming
-            // distance.
-            for (const int candidate_id : candidate_descriptors)
+            // code. Sort the candidates by hamming distance (counting sort).
+            const uint8_t* hash_code = hashed_descriptions1.hashCode(i);
+            candidate_hamming_distances.resize(candidate_descriptors.size());
+            hamming_distance_offsets.assign(nb_hash_code_ + 2, 0);
+            for (std::size_t c = 0; c < candidate_descriptors.size(); ++c)
             {
-                if (!used_descriptor[candidate_id])  // avoid selecting the same candidate multiple times
-                {
-                    used_descriptor[candidate_id] = true;
-
-                    const HammingMetricType::ResultType hamming_distance = metricH(hashed_desc.hash_code.data(),
-                                                                                   hashed_descriptions2.hashed_desc[candidate_id].hash_code.data(),
-                                                                                   hashed_desc.hash_code.num_blocks());
-                    candidate_hamming_distances(num_descriptors_with_hamming_distance(hamming_distance)++, hamming_distance) = candidate_id;
-                }
+                const int hamming_distance =
+                  static_cast<int>(feature::hammingDistanceUChar(hash_code, hashed_descriptions2.hashCode(candidate_descriptors[c]), hashCodeSize));
+                candidate_hamming_distances[c] = hamming_distance;
+                ++hamming_distance_offsets[hamming_distance + 1];
             }
+            for (int d = 0; d <= nb_hash_code_; ++d)
+                hamming_distance_offsets[d + 1] += hamming_distance_offsets[d];
+
+            sorted_candidates.resize(candidate_descriptors.size());
+            for (std::size_t c = 0; c < candidate_descriptors.size(); ++c)
+                sorted_candidates[hamming_distance_offsets[candidate_hamming_distances[c]]++] = candidate_descriptors[c];
 
             // Compute the euclidean distance of the k descriptors with the best hamming
             // distance.
-            candidate_euclidean_distances.reserve(kNumTopCandidates);
-            for (int j = 0; j < candidate_hamming_distances.cols() && (candidate_euclidean_distances.size() < kNumTopCandidates); ++j)
+            const int nbEuclideanDistances = std::min(kNumTopCandidates, static_cast<int>(sorted_candidates.size()));
+            for (int k = 0; k < nbEuclideanDistances; ++k)
             {
-                for (int k = 0; k < num_descriptors_with_hamming_distance(j) && (candidate_euclidean_distances.size() < kNumTopCandidates); ++k)
-                {
-                    const int candidate_id = candidate_hamming_distances(k, j);
-                    const DistanceType distance = metric(descriptions2.row(candidate_id).data(), descriptions1.row(i).data(), descriptions1.cols());
+                const int candidate_id = sorted_candidates[k];
+                const DistanceType distance = metric(descriptions2.row(candidate_id).data(), descriptions1.row(i).data(), descriptions1.cols());
 
-                    candidate_euclidean_distances.emplace_back(distance, candidate_id);
-                }
+                candidate_euclidean_distances[k] = std::make_pair(distance, candidate_id);
             }
 
             // Assert that each query is having at least NN retrieved neighbors
-            if (candidate_euclidean_distances.size() >= NN)
+            if (nbEuclideanDistances >= NN)
             {
                 // Find the top NN candidates based on euclidean distance.
                 std::partial_sort(
-                  candidate_euclidean_distances.begin(), candidate_euclidean_distances.begin() + NN, candidate_euclidean_distances.end());
+                  candidate_euclidean_distances, candidate_euclidean_distances + NN, candidate_euclidean_distances + nbEuclideanDistances);
                 // save resulting neighbors
                 for (int l = 0; l < NN; ++l)
                 {
@@ -321,6 +399,9 @@ class CascadeHasher
 
     // Secondary hashing function.
     std::vector<Eigen::MatrixXf> secondary_hash_projection_;
+
+    // Secondary hashing functions of all the bucket groups, stacked.
+    Eigen::MatrixXf secondary_hash_projection_all_;
 };
 
 }  // namespace matching
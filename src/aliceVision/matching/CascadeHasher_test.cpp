@@ -0,0 +1,271 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "aliceVision/matching/CascadeHasher.hpp"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#define BOOST_TEST_MODULE CascadeHasher
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::matching;
+
+namespace {
+
+using DescriptorMatrix = Eigen::Matrix<unsigned char, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+using DistanceType = feature::L2_Vectorized<unsigned char>::ResultType;
+
+/**
+ * Reference cascade hashing, with one hash code and one bucket ids vector per description
+ * and one vector per bucket, projecting the descriptions one by one.
+ */
+struct ReferenceCascadeHasher
+{
+    struct HashedDescription
+    {
+        std::vector<bool> hashCode;
+        std::vector<uint16_t> bucketIds;
+    };
+
+    struct HashedDescriptions
+    {
+        std::vector<HashedDescription> hashedDesc;
+        std::vector<std::vector<std::vector<int>>> buckets;
+    };
+
+    int nbHashCode = 0;
+    int nbBucketGroups = 0;
+    int nbBitsPerBucket = 0;
+    Eigen::MatrixXf primaryProjection;
+    std::vector<Eigen::MatrixXf> secondaryProjections;
+
+    // same random projections as CascadeHasher::Init
+    void init(std::mt19937& generator, int nbHashCode_ = 128, int nbBucketGroups_ = 6, int nbBitsPerBucket_ = 10)
+    {
+        nbHashCode = nbHashCode_;
+        nbBucketGroups = nbBucketGroups_;
+        nbBitsPerBucket = nbBitsPerBucket_;
+
+        std::normal_distribution<> d(0, 1);
+        primaryProjection.resize(nbHashCode, nbHashCode);
+        for (int i = 0; i < nbHashCode; ++i)
+            for (int j = 0; j < nbHashCode; ++j)
+                primaryProjection(i, j) = d(generator);
+
+        secondaryProjections.resize(nbBucketGroups);
+        for (auto& projection : secondaryProjections)
+        {
+            projection.resize(nbBitsPerBucket, nbHashCode);
+            for (int j = 0; j < nbBitsPerBucket; ++j)
+                for (int k = 0; k < nbHashCode; ++k)
+                    projection(j, k) = d(generator);
+        }
+    }
+
+    HashedDescriptions createHashedDescriptions(const DescriptorMatrix& descriptions, const Eigen::VectorXf& zeroMeanDescriptor) const
+    {
+        HashedDescriptions hashed;
+        hashed.hashedDesc.resize(descriptions.rows());
+        for (int i = 0; i < descriptions.rows(); ++i)
+        {
+            const Eigen::VectorXf descriptor = descriptions.row(i).transpose().cast<float>() - zeroMeanDescriptor;
+
+            const Eigen::VectorXf primary = primaryProjection * descriptor;
+            hashed.hashedDesc[i].hashCode.resize(nbHashCode);
+            for (int j = 0; j < nbHashCode; ++j)
+                hashed.hashedDesc[i].hashCode[j] = primary(j) > 0;
+
+            hashed.hashedDesc[i].bucketIds.resize(nbBucketGroups);
+            for (int j = 0; j < nbBucketGroups; ++j)
+            {
+                const Eigen::VectorXf secondary = secondaryProjections[j] * descriptor;
+                uint16_t bucketId = 0;
+                for (int k = 0; k < nbBitsPerBucket; ++k)
+                    bucketId = (bucketId << 1) + (secondary(k) > 0 ? 1 : 0);
+                hashed.hashedDesc[i].bucketIds[j] = bucketId;
+            }
+        }
+
+        hashed.buckets.assign(nbBucketGroups, std::vector<std::vector<int>>(1 << nbBitsPerBucket));
+        for (int j = 0; j < nbBucketGroups; ++j)
+            for (int i = 0; i < hashed.hashedDesc.size(); ++i)
+                hashed.buckets[j][hashed.hashedDesc[i].bucketIds[j]].push_back(i);
+        return hashed;
+    }
+
+    void match(const HashedDescriptions& hashed1,
+               const DescriptorMatrix& descriptions1,
+               const HashedDescriptions& hashed2,
+               const DescriptorMatrix& descriptions2,
+               IndMatches& matches,
+               std::vector<DistanceType>& distances,
+               int NN = 2) const
+    {
+        const feature::L2_Vectorized<unsigned char> metric;
+        const int nbTopCandidates = 10;
+
+        for (int i = 0; i < hashed1.hashedDesc.size(); ++i)
+        {
+            const HashedDescription& query = hashed1.hashedDesc[i];
+
+            // candidates of all the bucket groups, with duplicates
+            std::vector<int> candidates;
+            for (int j = 0; j < nbBucketGroups; ++j)
+            {
+                const std::vector<int>& bucket = hashed2.buckets[j][query.bucketIds[j]];
+                candidates.insert(candidates.end(), bucket.begin(), bucket.end());
+            }
+            if (candidates.size() <= NN)
+                continue;
+
+            // unique candidates by hamming distance, in their order of appearance
+            std::vector<std::vector<int>> candidatesPerHammingDistance(nbHashCode + 1);
+            std::vector<bool> used(hashed2.hashedDesc.size(), false);
+            for (const int candidate : candidates)
+            {
+                if (used[candidate])
+                    continue;
+                used[candidate] = true;
+                int hammingDistance = 0;
+                for (int k = 0; k < nbHashCode; ++k)
+                    hammingDistance += query.hashCode[k] != hashed2.hashedDesc[candidate].hashCode[k];
+                candidatesPerHammingDistance[hammingDistance].push_back(candidate);
+            }
+
+            std::vector<std::pair<DistanceType, int>> euclideanDistances;
+            for (const auto& sameDistanceCandidates : candidatesPerHammingDistance)
+            {
+                for (const int candidate : sameDistanceCandidates)
+                {
+                    if (euclideanDistances.size() < nbTopCandidates)
+                        euclideanDistances.emplace_back(metric(descriptions2.row(candidate).data(), descriptions1.row(i).data(), descriptions1.cols()),
+                                                        candidate);
+                }
+            }
+            if (euclideanDistances.size() < NN)
+                continue;
+
+            std::partial_sort(euclideanDistances.begin(), euclideanDistances.begin() + NN, euclideanDistances.end());
+            for (int l = 0; l < NN; ++l)
+            {
+                distances.push_back(euclideanDistances[l].first);
+                matches.emplace_back(i, euclideanDistances[l].second);
+            }
+        }
+    }
+};
+
+/// noisy observations of a shared set of random descriptors
+DescriptorMatrix makeDescriptors(std::mt19937& gen, const DescriptorMatrix& sceneDescriptors, int nbDescriptors)
+{
+    std::uniform_int_distribution<int> indexDist(0, sceneDescriptors.rows() - 1);
+    std::normal_distribution<float> noiseDist(0.f, 6.f);
+
+    DescriptorMatrix descriptors(nbDescriptors, sceneDescriptors.cols());
+    for (int i = 0; i < nbDescriptors; ++i)
+    {
+        const int index = indexDist(gen);
+        for (int k = 0; k < descriptors.cols(); ++k)
+            descriptors(i, k) = static_cast<unsigned char>(std::clamp(sceneDescriptors(index, k) + noiseDist(gen), 0.f, 255.f));
+    }
+    return descriptors;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(CascadeHasher_compactHashedDescriptions)
+{
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> valueDist(0, 255);
+    // more descriptions than a projection block
+    DescriptorMatrix sceneDescriptors(1500, 128);
+    for (int i = 0; i < sceneDescriptors.size(); ++i)
+        sceneDescriptors.data()[i] = static_cast<unsigned char>(valueDist(gen));
+
+    const DescriptorMatrix descriptions1 = makeDescriptors(gen, sceneDescriptors, 1200);
+    const DescriptorMatrix descriptions2 = makeDescriptors(gen, sceneDescriptors, 2100);
+
+    CascadeHasher hasher;
+    ReferenceCascadeHasher referenceHasher;
+    {
+        std::mt19937 hasherGen(42);
+        hasher.Init(hasherGen, 128);
+        std::mt19937 referenceGen(42);
+        referenceHasher.init(referenceGen, 128);
+    }
+
+    const Eigen::VectorXf zeroMeanDescriptor = CascadeHasher::GetZeroMeanDescriptor(descriptions2);
+
+    const HashedDescriptions hashed1 = hasher.CreateHashedDescriptions(descriptions1, zeroMeanDescriptor);
+    const HashedDescriptions hashed2 = hasher.CreateHashedDescriptions(descriptions2, zeroMeanDescriptor);
+    const ReferenceCascadeHasher::HashedDescriptions referenceHashed1 = referenceHasher.createHashedDescriptions(descriptions1, zeroMeanDescriptor);
+    const ReferenceCascadeHasher::HashedDescriptions referenceHashed2 = referenceHasher.createHashedDescriptions(descriptions2, zeroMeanDescriptor);
+
+    // hash codes, bucket ids and buckets
+    BOOST_REQUIRE_EQUAL(hashed2.nbDescriptions, descriptions2.rows());
+    BOOST_REQUIRE_EQUAL(hashed2.nbBucketGroups, referenceHasher.nbBucketGroups);
+    for (int i = 0; i < hashed2.nbDescriptions; ++i)
+    {
+        const ReferenceCascadeHasher::HashedDescription& reference = referenceHashed2.hashedDesc[i];
+        for (int k = 0; k < referenceHasher.nbHashCode; ++k)
+            BOOST_CHECK_EQUAL(bool(hashed2.hashCode(i)[k / 8] & (1 << (k % 8))), bool(reference.hashCode[k]));
+        for (int j = 0; j < hashed2.nbBucketGroups; ++j)
+            BOOST_CHECK_EQUAL(hashed2.bucketId(i, j), reference.bucketIds[j]);
+    }
+    for (int j = 0; j < hashed2.nbBucketGroups; ++j)
+    {
+        for (int b = 0; b < hashed2.nbBucketsPerGroup; ++b)
+        {
+            const std::vector<int> bucket(hashed2.bucketBegin(j, b), hashed2.bucketEnd(j, b));
+            BOOST_CHECK(bucket == referenceHashed2.buckets[j][b]);
+        }
+    }
+
+    // matches, with buffers reused across the matchings
+    CascadeHasherMatchingBuffers buffers;
+    for (int iteration = 0; iteration < 2; ++iteration)
+    {
+        IndMatches matches;
+        std::vector<DistanceType> distances;
+        hasher.Match_HashedDescriptions(hashed1, descriptions1, hashed2, descriptions2, &matches, &distances, buffers);
+
+        IndMatches referenceMatches;
+        std::vector<DistanceType> referenceDistances;
+        referenceHasher.match(referenceHashed1, descriptions1, referenceHashed2, descriptions2, referenceMatches, referenceDistances);
+
+        BOOST_CHECK_GT(matches.size(), descriptions1.rows());
+        BOOST_CHECK(matches == referenceMatches);
+        BOOST_CHECK(distances == referenceDistances);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CascadeHasher_emptyDescriptions)
+{
+    std::mt19937 gen(42);
+    CascadeHasher hasher;
+    hasher.Init(gen, 128);
+
+    const DescriptorMatrix descriptions1(0, 128);
+    DescriptorMatrix descriptions2(10, 128);
+    descriptions2.setConstant(12);
+
+    const Eigen::VectorXf zeroMeanDescriptor = CascadeHasher::GetZeroMeanDescriptor(descriptions2);
+    const HashedDescriptions hashed1 = hasher.CreateHashedDescriptions(descriptions1, zeroMeanDescriptor);
+    const HashedDescriptions hashed2 = hasher.CreateHashedDescriptions(descriptions2, zeroMeanDescriptor);
+    BOOST_CHECK_EQUAL(hashed1.nbDescriptions, 0);
+
+    IndMatches matches;
+    std::vector<DistanceType> distances;
+    hasher.Match_HashedDescriptions(hashed1, descriptions1, hashed2, descriptions2, &matches, &distances);
+    hasher.Match_HashedDescriptions(hashed2, descriptions2, hashed1, descriptions1, &matches, &distances);
+    BOOST_CHECK(matches.empty());
+    BOOST_CHECK(distances.empty());
+}
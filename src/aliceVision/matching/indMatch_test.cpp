@@ -7,6 +7,7 @@
 
 #include "aliceVision/matching/IndMatch.hpp"
 #include "aliceVision/matching/io.hpp"
+#include "aliceVision/matching/matchesBinaryIO.hpp"
 
 #define BOOST_TEST_MODULE IndMatch
 
@@ -107,6 +108,52 @@ BOOST_AUTO_TEST_CASE(IndMatch_IO)
     fs::remove_all(testFolder);
 }
 
+BOOST_AUTO_TEST_CASE(IndMatch_IO_binary)
+{
+    const std::string testFolder = "matchingBinaryTest";
+    fs::create_directory(testFolder);
+    {
+        PairwiseMatches matches;
+        matches[std::make_pair(0, 1)][EImageDescriberType::SIFT] = {{0, 0}, {1, 1}};
+        matches[std::make_pair(0, 1)][EImageDescriberType::AKAZE] = {{5, 6}};
+        matches[std::make_pair(1, 2)][EImageDescriberType::SIFT] = {{0, 0}, {1, 1}, {2, 2}};
+        matches[std::make_pair(2, 3)][EImageDescriberType::SIFT] = {{7, 8}, {9, 10}};
+
+        BOOST_CHECK(Save(matches, testFolder, "bin", false));
+
+        // full load
+        PairwiseMatches loadedMatches;
+        BOOST_CHECK(Load(loadedMatches, {}, {testFolder}, {}));
+        BOOST_CHECK(loadedMatches == matches);
+
+        // load only the selected views and describer types
+        loadedMatches.clear();
+        BOOST_CHECK(Load(loadedMatches, {0, 1, 2}, {testFolder}, {EImageDescriberType::SIFT}));
+        BOOST_CHECK_EQUAL(2, loadedMatches.size());
+        BOOST_CHECK_EQUAL(1, loadedMatches.at(std::make_pair(0, 1)).size());
+        BOOST_CHECK_EQUAL(3, loadedMatches.at(std::make_pair(1, 2)).at(EImageDescriberType::SIFT).size());
+
+        // random access to one pair
+        MatchesBinaryReader reader((fs::path(testFolder) / "matches.bin").string());
+        BOOST_CHECK_EQUAL(4, reader.getEntries().size());
+        MatchesPerDescType pairMatches;
+        BOOST_CHECK(reader.readPair(std::make_pair(2, 3), pairMatches));
+        BOOST_CHECK(pairMatches.at(EImageDescriberType::SIFT) == matches.at(std::make_pair(2, 3)).at(EImageDescriberType::SIFT));
+        BOOST_CHECK(!reader.readPair(std::make_pair(0, 3), pairMatches));
+
+        // one file per image, converted from the text format
+        BOOST_CHECK(Save(matches, testFolder, "txt", true, "text."));
+        PairwiseMatches textMatches;
+        BOOST_CHECK(LoadMatchFile(textMatches, (fs::path(testFolder) / "0.text.matches.txt").string()));
+        BOOST_CHECK(Save(textMatches, testFolder, "bin", true, "converted."));
+        loadedMatches.clear();
+        BOOST_CHECK(LoadMatchFile(loadedMatches, (fs::path(testFolder) / "0.converted.matches.bin").string()));
+        BOOST_CHECK(loadedMatches == textMatches);
+        BOOST_CHECK_EQUAL(2, loadedMatches.at(std::make_pair(0, 1)).size());
+    }
+    fs::remove_all(testFolder);
+}
+
 BOOST_AUTO_TEST_CASE(IndMatch_DuplicateRemoval_NoRemoval)
 {
     std::vector<IndMatch> vec_indMatch;
@@ -7,12 +7,14 @@
 
 #include "io.hpp"
 #include <aliceVision/matching/IndMatch.hpp>
+#include <aliceVision/matching/matchesBinaryIO.hpp>
 #include <aliceVision/config.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 
 #include <boost/range/iterator_range.hpp>
 
+#include <algorithm>
 #include <map>
 #include <filesystem>
 #include <fstream>
@@ -26,13 +28,36 @@ namespace aliceVision {
 namespace matching {
 
 bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath)
+{
+    return LoadMatchFile(matches, filepath, std::set<IndexT>(), std::vector<feature::EImageDescriberType>());
+}
+
+bool LoadMatchFile(PairwiseMatches& matches,
+                   const std::string& filepath,
+                   const std::set<IndexT>& viewsKeysFilter,
+                   const std::vector<feature::EImageDescriberType>& descTypesFilter)
 {
     const std::string ext = fs::path(filepath).extension().string();
 
     if (!utils::exists(filepath))
         return false;
 
-    if (ext == ".txt")
+    if (ext == ".bin")
+    {
+        // only the selected pairs are read, using the index of the file
+        try
+        {
+            MatchesBinaryReader reader(filepath);
+            reader.readAll(matches, viewsKeysFilter, descTypesFilter);
+        }
+        catch (const std::exception& e)
+        {
+            ALICEVISION_LOG_WARNING(e.what());
+            return false;
+        }
+        return true;
+    }
+    else if (ext == ".txt")
     {
         std::ifstream stream(filepath);
         if (!stream.is_open())
@@ -66,6 +91,10 @@ bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath)
                 {
                     stream >> matchesPerDesc[i];
                 }
+                if (!viewsKeysFilter.empty() && (viewsKeysFilter.count(I) == 0 || viewsKeysFilter.count(J) == 0))
+                    continue;
+                if (!descTypesFilter.empty() && std::find(descTypesFilter.begin(), descTypesFilter.end(), descType) == descTypesFilter.end())
+                    continue;
                 matches[std::make_pair(I, J)][descType] = std::move(matchesPerDesc);
             }
         }
@@ -165,31 +194,64 @@ std::size_t LoadMatchFilePerImage(PairwiseMatches& matches,
 }
 
 /**
- * Load and add pair-wise matches to \p matches from all files in \p folder matching \p pattern.
+ * Load and add pair-wise matches to \p matches from all files in \p folder matching one of \p patterns.
  * @param[out] matches PairwiseMatches to add loaded matches to
  * @param[in] folder Folder to load matches files from
- * @param[in] pattern Pattern that files must respect to be loaded
+ * @param[in] patterns Patterns that files must respect to be loaded.
+ *            Files only differing by the pattern (the same matches in another format) are loaded once, with the first pattern.
+ * @param[in] viewsKeysFilter Restrict the matches to these views (empty takes all)
+ * @param[in] descTypesFilter Restrict the matches to these types of descriptors (empty takes all)
  */
-std::size_t loadMatchesFromFolder(PairwiseMatches& matches, const std::string& folder, const std::string& pattern)
+std::size_t loadMatchesFromFolder(PairwiseMatches& matches,
+                                  const std::string& folder,
+                                  const std::vector<std::string>& patterns,
+                                  const std::set<IndexT>& viewsKeysFilter,
+                                  const std::vector<feature::EImageDescriberType>& descTypesFilter)
 {
     std::size_t nbLoadedMatchFiles = 0;
-    std::vector<std::string> matchFiles;
-    // list all matches files in 'folder' matching (i.e containing) 'pattern'
+    // list all matches files in 'folder' matching (i.e containing) one of the 'patterns'
+    // key: path without the pattern, value: (pattern index, path)
+    std::map<std::string, std::pair<std::size_t, std::string>> matchFilesPerKey;
     for (const auto& entry : boost::make_iterator_range(fs::directory_iterator(folder), {}))
     {
-        if (entry.path().string().find(pattern) != std::string::npos)
+        const std::string path = entry.path().string();
+        for (std::size_t p = 0; p < patterns.size(); ++p)
         {
-            matchFiles.push_back(entry.path().string());
+            const std::size_t position = path.find(patterns[p]);
+            if (position == std::string::npos)
+                continue;
+
+            const std::string key = path.substr(0, position) + path.substr(position + patterns[p].size());
+            const auto it = matchFilesPerKey.find(key);
+            if (it == matchFilesPerKey.end())
+            {
+                matchFilesPerKey.emplace(key, std::make_pair(p, path));
+            }
+            else
+            {
+                // same matches in another format: keep the file of the first pattern
+                const std::pair<std::size_t, std::string> matchFile(p, path);
+                const auto& kept = std::min(it->second, matchFile);
+                const auto& skipped = std::max(it->second, matchFile);
+                ALICEVISION_LOG_DEBUG("Skip match file: " << skipped.second << " (same matches as: " << kept.second << ")");
+                it->second = kept;
+            }
+            break;
         }
     }
 
+    std::vector<std::string> matchFiles;
+    matchFiles.reserve(matchFilesPerKey.size());
+    for (const auto& matchFile : matchFilesPerKey)
+        matchFiles.push_back(matchFile.second.second);
+
 #pragma omp parallel for num_threads(3)
     for (int i = 0; i < matchFiles.size(); ++i)
     {
         const std::string& matchFile = matchFiles[i];
         PairwiseMatches fileMatches;
         ALICEVISION_LOG_DEBUG("Loading match file: " << matchFile);
-        if (!LoadMatchFile(fileMatches, matchFile))
+        if (!LoadMatchFile(fileMatches, matchFile, viewsKeysFilter, descTypesFilter))
         {
             ALICEVISION_LOG_WARNING("Unable to load match file: " << matchFile);
             continue;
@@ -226,7 +288,8 @@ bool Load(PairwiseMatches& matches,
           int minNbMatches)
 {
     std::size_t nbLoadedMatchFiles = 0;
-    const std::string pattern = "matches.txt";
+    // note: the binary matches are preferred to the text matches of the same pairs
+    const std::vector<std::string> patterns = {"matches.bin", "matches.txt"};
 
     // build up a set with normalized paths to remove duplicates
     std::set<std::string> foldersSet;
@@ -241,7 +304,7 @@ bool Load(PairwiseMatches& matches,
 
     for (const auto& folder : foldersSet)
     {
-        nbLoadedMatchFiles += loadMatchesFromFolder(matches, folder, pattern);
+        nbLoadedMatchFiles += loadMatchesFromFolder(matches, folder, patterns, viewsKeysFilter, descTypesFilter);
     }
 
     if (!nbLoadedMatchFiles)
@@ -305,6 +368,19 @@ class MatchExporter
         fs::rename(tmpPath, filepath);
     }
 
+    void saveBin(const std::string& filepath, const PairwiseMatches::const_iterator& matchBegin, const PairwiseMatches::const_iterator& matchEnd)
+    {
+        const fs::path bPath = fs::path(filepath);
+        const std::string tmpPath =
+          (bPath.parent_path() / bPath.stem()).string() + "." + utils::generateUniqueFilename() + bPath.extension().string();
+
+        // write temporary file
+        saveMatchesBinary(tmpPath, matchBegin, matchEnd);
+
+        // rename temporary file
+        fs::rename(tmpPath, filepath);
+    }
+
   public:
     MatchExporter(const PairwiseMatches& matches, const std::string& folder, const std::string& filename)
       : m_matches(matches),
@@ -321,6 +397,8 @@ class MatchExporter
 
         if (m_ext == ".txt")
             saveTxt(filepath, m_matches.begin(), m_matches.end());
+        else if (m_ext == ".bin")
+            saveBin(filepath, m_matches.begin(), m_matches.end());
         else
             throw std::runtime_error(std::string("Unknown matching file format: ") + m_ext);
     }
@@ -344,6 +422,8 @@ class MatchExporter
 
             if (m_ext == ".txt")
                 saveTxt(filepath, matchBegin, match);
+            else if (m_ext == ".bin")
+                saveBin(filepath, matchBegin, match);
             else
                 throw std::runtime_error(std::string("Unknown matching file format: ") + m_ext);
 
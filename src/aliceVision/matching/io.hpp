@@ -22,6 +22,20 @@ namespace matching {
  */
 bool LoadMatchFile(PairwiseMatches& matches, const std::string& filepath);
 
+/**
+ * @brief Load a match file, keeping only the selected views and types of descriptors.
+ *        With the binary format, only the selected pairs are read from the file.
+ *
+ * @param[out] matches container for the output matches
+ * @param[in] filepath the match file to load (.txt or .bin)
+ * @param[in] viewsKeysFilter Restrict the matches to these views (empty takes all).
+ * @param[in] descTypesFilter Restrict the matches to these types of descriptors (empty takes all).
+ */
+bool LoadMatchFile(PairwiseMatches& matches,
+                   const std::string& filepath,
+                   const std::set<IndexT>& viewsKeysFilter,
+                   const std::vector<feature::EImageDescriberType>& descTypesFilter);
+
 /**
  * @brief Load the match file for each image.
  * @param[out] matches container for the output matches.
@@ -36,8 +50,8 @@ std::size_t LoadMatchFilePerImage(PairwiseMatches& matches,
                                   const std::string& extension);
 
 /**
- * @brief Load all the matches from the folder. Optionally filter the view, the type of descriptors
- * and the number of matches.
+ * @brief Load all the matches (.txt and .bin files) from the folder. Optionally filter the view,
+ * the type of descriptors and the number of matches.
  *
  * @param[out] matches container for the output matches.
  * @param[in] viewsKeysFilter Restrict the matches to these views.
@@ -0,0 +1,220 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "matchesBinaryIO.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace aliceVision {
+namespace matching {
+
+namespace {
+
+constexpr char MATCHES_FILE_MAGIC[8] = {'A', 'V', 'M', 'A', 'T', 'C', 'H', '\0'};
+constexpr uint32_t MATCHES_FILE_VERSION = 1;
+constexpr std::size_t DESCTYPE_NAME_SIZE = 32;
+
+struct MatchesFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t descTypeCount;
+    uint64_t entryCount;
+    uint64_t reserved;
+};
+
+struct MatchesFileEntry
+{
+    uint32_t I;
+    uint32_t J;
+    uint32_t descTypeIndex;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t count;
+};
+
+static_assert(sizeof(MatchesFileHeader) == 32, "Unexpected MatchesFileHeader size");
+static_assert(sizeof(MatchesFileEntry) == 32, "Unexpected MatchesFileEntry size");
+
+bool entryLess(const MatchesBinaryReader::Entry& a, const MatchesBinaryReader::Entry& b)
+{
+    return a.pair < b.pair || (a.pair == b.pair && a.descType < b.descType);
+}
+
+}  // namespace
+
+MatchesBinaryReader::MatchesBinaryReader(const std::string& filepath)
+  : _filepath(filepath),
+    _stream(filepath, std::ios::in | std::ios::binary)
+{
+    if (!_stream.is_open())
+        throw std::runtime_error("Can't load matches binary file, can't open '" + filepath + "' !");
+
+    MatchesFileHeader header;
+    _stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!_stream || std::memcmp(header.magic, MATCHES_FILE_MAGIC, sizeof(header.magic)) != 0)
+        throw std::runtime_error("Can't load matches binary file, '" + filepath + "' is not a matches file !");
+    if (header.version != MATCHES_FILE_VERSION)
+        throw std::runtime_error("Can't load matches binary file, '" + filepath + "' has unsupported version " + std::to_string(header.version) + " !");
+
+    std::vector<feature::EImageDescriberType> descTypes(header.descTypeCount);
+    for (feature::EImageDescriberType& descType : descTypes)
+    {
+        char name[DESCTYPE_NAME_SIZE + 1] = {};
+        _stream.read(name, DESCTYPE_NAME_SIZE);
+        descType = feature::EImageDescriberType_stringToEnum(name);
+    }
+
+    std::vector<MatchesFileEntry> fileEntries(header.entryCount);
+    _stream.read(reinterpret_cast<char*>(fileEntries.data()), fileEntries.size() * sizeof(MatchesFileEntry));
+    if (!_stream)
+        throw std::runtime_error("Can't load matches binary file, '" + filepath + "' has an invalid index !");
+
+    _entries.reserve(fileEntries.size());
+    for (const MatchesFileEntry& fileEntry : fileEntries)
+    {
+        if (fileEntry.descTypeIndex >= descTypes.size())
+            throw std::runtime_error("Can't load matches binary file, '" + filepath + "' has an invalid index !");
+        _entries.push_back({Pair(fileEntry.I, fileEntry.J), descTypes[fileEntry.descTypeIndex], fileEntry.offset, fileEntry.count});
+    }
+    // the writer sorts the entries, but the describer types order depends on the enum values
+    std::sort(_entries.begin(), _entries.end(), entryLess);
+}
+
+void MatchesBinaryReader::read(const Entry& entry, IndMatches& matches)
+{
+    _buffer.resize(2 * entry.count);
+    _stream.clear();
+    _stream.seekg(static_cast<std::streamoff>(entry.offset));
+    _stream.read(reinterpret_cast<char*>(_buffer.data()), _buffer.size() * sizeof(uint32_t));
+    if (!_stream)
+        throw std::runtime_error("Can't load matches binary file, '" + _filepath + "' is incorrect !");
+
+    matches.resize(entry.count);
+    for (std::size_t i = 0; i < entry.count; ++i)
+        matches[i] = IndMatch(_buffer[2 * i], _buffer[2 * i + 1]);
+}
+
+bool MatchesBinaryReader::readPair(const Pair& pair, MatchesPerDescType& matches)
+{
+    const auto begin = std::lower_bound(
+      _entries.begin(), _entries.end(), pair, [](const Entry& entry, const Pair& value) { return entry.pair < value; });
+
+    bool found = false;
+    for (auto it = begin; it != _entries.end() && it->pair == pair; ++it)
+    {
+        read(*it, matches[it->descType]);
+        found = true;
+    }
+    return found;
+}
+
+void MatchesBinaryReader::readAll(PairwiseMatches& matches,
+                                  const std::set<IndexT>& viewsKeysFilter,
+                                  const std::vector<feature::EImageDescriberType>& descTypesFilter)
+{
+    IndMatches entryMatches;
+    for (const Entry& entry : _entries)
+    {
+        if (!viewsKeysFilter.empty() && (viewsKeysFilter.count(entry.pair.first) == 0 || viewsKeysFilter.count(entry.pair.second) == 0))
+            continue;
+        if (!descTypesFilter.empty() && std::find(descTypesFilter.begin(), descTypesFilter.end(), entry.descType) == descTypesFilter.end())
+            continue;
+
+        read(entry, entryMatches);
+        IndMatches& pairMatches = matches[entry.pair][entry.descType];
+        pairMatches.insert(pairMatches.end(), entryMatches.begin(), entryMatches.end());
+    }
+}
+
+bool isMatchesBinaryFile(const std::string& filepath) { return fs::path(filepath).extension().string() == ".bin"; }
+
+void saveMatchesBinary(const std::string& filepath, const PairwiseMatches::const_iterator& matchBegin, const PairwiseMatches::const_iterator& matchEnd)
+{
+    // describer types table
+    std::map<feature::EImageDescriberType, uint32_t> descTypeIndexes;
+    std::size_t entryCount = 0;
+    for (PairwiseMatches::const_iterator match = matchBegin; match != matchEnd; ++match)
+    {
+        for (const auto& m : match->second)
+        {
+            descTypeIndexes.emplace(m.first, 0);
+            ++entryCount;
+        }
+    }
+    {
+        uint32_t index = 0;
+        for (auto& descTypeIndex : descTypeIndexes)
+            descTypeIndex.second = index++;
+    }
+
+    MatchesFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MATCHES_FILE_MAGIC, sizeof(header.magic));
+    header.version = MATCHES_FILE_VERSION;
+    header.descTypeCount = static_cast<uint32_t>(descTypeIndexes.size());
+    header.entryCount = entryCount;
+
+    // index: PairwiseMatches and MatchesPerDescType are ordered maps, so the entries are sorted
+    std::vector<MatchesFileEntry> fileEntries;
+    fileEntries.reserve(entryCount);
+    uint64_t offset = sizeof(MatchesFileHeader) + descTypeIndexes.size() * DESCTYPE_NAME_SIZE + entryCount * sizeof(MatchesFileEntry);
+    for (PairwiseMatches::const_iterator match = matchBegin; match != matchEnd; ++match)
+    {
+        for (const auto& m : match->second)
+        {
+            MatchesFileEntry fileEntry;
+            fileEntry.I = static_cast<uint32_t>(match->first.first);
+            fileEntry.J = static_cast<uint32_t>(match->first.second);
+            fileEntry.descTypeIndex = descTypeIndexes.at(m.first);
+            fileEntry.reserved = 0;
+            fileEntry.offset = offset;
+            fileEntry.count = m.second.size();
+            fileEntries.push_back(fileEntry);
+            offset += m.second.size() * 2 * sizeof(uint32_t);
+        }
+    }
+
+    std::ofstream stream(filepath, std::ios::out | std::ios::binary);
+    if (!stream.is_open())
+        throw std::runtime_error("Can't save matches binary file, can't open '" + filepath + "' !");
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& descTypeIndex : descTypeIndexes)
+    {
+        char name[DESCTYPE_NAME_SIZE] = {};
+        std::strncpy(name, feature::EImageDescriberType_enumToString(descTypeIndex.first).c_str(), DESCTYPE_NAME_SIZE - 1);
+        stream.write(name, DESCTYPE_NAME_SIZE);
+    }
+    stream.write(reinterpret_cast<const char*>(fileEntries.data()), fileEntries.size() * sizeof(MatchesFileEntry));
+
+    std::vector<uint32_t> buffer;
+    for (PairwiseMatches::const_iterator match = matchBegin; match != matchEnd; ++match)
+    {
+        for (const auto& m : match->second)
+        {
+            buffer.resize(2 * m.second.size());
+            for (std::size_t i = 0; i < m.second.size(); ++i)
+            {
+                buffer[2 * i] = static_cast<uint32_t>(m.second[i]._i);
+                buffer[2 * i + 1] = static_cast<uint32_t>(m.second[i]._j);
+            }
+            stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(uint32_t));
+        }
+    }
+
+    if (!stream.good())
+        throw std::runtime_error("Can't save matches binary file, '" + filepath + "' is incorrect !");
+}
+
+}  // namespace matching
+}  // namespace aliceVision
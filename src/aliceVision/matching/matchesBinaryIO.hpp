@@ -0,0 +1,117 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/matching/IndMatch.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace aliceVision {
+namespace matching {
+
+/**
+ * Binary matches file (".bin").
+ *
+ * Layout (version 1, native little-endian):
+ *  - header: magic "AVMATCH\0", version, number of describer types, number of index entries
+ *  - describer type names (32 chars each, zero-padded)
+ *  - index: one entry per (I, J, descType), sorted, with the offset and the number of matches
+ *  - matches: per index entry, a contiguous array of (i, j) feature indexes as uint32
+ *
+ * The index gives random access to the matches of any pair without reading the others.
+ */
+class MatchesBinaryReader
+{
+  public:
+    struct Entry
+    {
+        Pair pair;
+        feature::EImageDescriberType descType;
+        uint64_t offset;
+        uint64_t count;
+    };
+
+    /**
+     * @brief Open a binary matches file and read its index.
+     * @param[in] filepath the binary matches file
+     * @throw std::runtime_error if the file cannot be read
+     */
+    explicit MatchesBinaryReader(const std::string& filepath);
+
+    /// Index entries, sorted by (I, J, descType)
+    const std::vector<Entry>& getEntries() const { return _entries; }
+
+    /**
+     * @brief Read the matches of one index entry.
+     * @param[in] entry an entry of the index
+     * @param[out] matches the matches of the entry
+     */
+    void read(const Entry& entry, IndMatches& matches);
+
+    /**
+     * @brief Read the matches of one pair, for all describer types.
+     * @param[in] pair the image pair
+     * @param[out] matches the matches of the pair per describer type
+     * @return false if the pair is not in the file
+     */
+    bool readPair(const Pair& pair, MatchesPerDescType& matches);
+
+    /**
+     * @brief Read the matches of the selected pairs and describer types.
+     * @param[out] matches container for the output matches (merged with existing content)
+     * @param[in] viewsKeysFilter keep only the pairs with both views in this set (empty takes all)
+     * @param[in] descTypesFilter keep only these describer types (empty takes all)
+     */
+    void readAll(PairwiseMatches& matches,
+                 const std::set<IndexT>& viewsKeysFilter = std::set<IndexT>(),
+                 const std::vector<feature::EImageDescriberType>& descTypesFilter = std::vector<feature::EImageDescriberType>());
+
+    /**
+     * @brief Stream the matches of the selected entries, one entry at a time, in the index order.
+     *        The matches buffer is reused between the calls.
+     * @param[in] callback called with (entry, matches) for each entry
+     * @param[in] viewsKeysFilter keep only the pairs with both views in this set (empty takes all)
+     */
+    template<typename Callback>
+    void forEach(Callback&& callback, const std::set<IndexT>& viewsKeysFilter = std::set<IndexT>())
+    {
+        IndMatches matches;
+        for (const Entry& entry : _entries)
+        {
+            if (!viewsKeysFilter.empty() && (viewsKeysFilter.count(entry.pair.first) == 0 || viewsKeysFilter.count(entry.pair.second) == 0))
+                continue;
+            read(entry, matches);
+            callback(entry, matches);
+        }
+    }
+
+  private:
+    std::string _filepath;
+    std::ifstream _stream;
+    std::vector<Entry> _entries;
+    std::vector<uint32_t> _buffer;
+};
+
+/**
+ * @brief Check if a file is a binary matches file (from its extension).
+ */
+bool isMatchesBinaryFile(const std::string& filepath);
+
+/**
+ * @brief Save matches in a binary matches file.
+ * @param[in] filepath the output file
+ * @param[in] matchBegin first pair to export
+ * @param[in] matchEnd end of the pairs to export
+ */
+void saveMatchesBinary(const std::string& filepath, const PairwiseMatches::const_iterator& matchBegin, const PairwiseMatches::const_iterator& matchEnd);
+
+}  // namespace matching
+}  // namespace aliceVision
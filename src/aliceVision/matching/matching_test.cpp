@@ -70,6 +70,84 @@ BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_bruteForce_NN)
     BOOST_CHECK_EQUAL(IndMatch(0, 4), vec_nIndice[4]);
 }
 
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_bruteForce_NN_MoreThanRows)
+{
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    const float array[] = {0, 1, 5};
+    ArrayMatcher_bruteForce<float> matcher;
+    BOOST_CHECK(matcher.Build(gen, array, 3, 1));
+
+    const float query[] = {2, 4};
+    IndMatches vec_nIndice;
+    std::vector<float> vec_fDistance;
+
+    // less dataset rows than requested neighbours: no result
+    BOOST_CHECK(!matcher.SearchNeighbours(query, 2, &vec_nIndice, &vec_fDistance, 4));
+    BOOST_CHECK(vec_nIndice.empty());
+    BOOST_CHECK(vec_fDistance.empty());
+
+    // as many dataset rows as requested neighbours: every neighbour is a valid row
+    BOOST_CHECK(matcher.SearchNeighbours(query, 2, &vec_nIndice, &vec_fDistance, 3));
+    BOOST_CHECK_EQUAL(6, vec_nIndice.size());
+    BOOST_CHECK_EQUAL(IndMatch(0, 1), vec_nIndice[0]);
+    BOOST_CHECK_EQUAL(IndMatch(0, 0), vec_nIndice[1]);
+    BOOST_CHECK_EQUAL(IndMatch(0, 2), vec_nIndice[2]);
+    BOOST_CHECK_EQUAL(IndMatch(1, 2), vec_nIndice[3]);
+    BOOST_CHECK_EQUAL(IndMatch(1, 1), vec_nIndice[4]);
+    BOOST_CHECK_EQUAL(IndMatch(1, 0), vec_nIndice[5]);
+    BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[5] - Square(0.0f - 4.0f)), 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_bruteForce_NN_Blocks)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> value(0, 3);
+
+    // several query and dataset blocks, with many distance ties
+    const int nbRows = 600;
+    const int nbQuery = 70;
+    const int dimension = 4;
+    std::vector<float> array(nbRows * dimension);
+    std::vector<float> query(nbQuery * dimension);
+    for (float& v : array)
+        v = static_cast<float>(value(gen));
+    for (float& v : query)
+        v = static_cast<float>(value(gen));
+
+    ArrayMatcher_bruteForce<float> matcher;
+    BOOST_CHECK(matcher.Build(gen, array.data(), nbRows, dimension));
+
+    for (const std::size_t NN : {std::size_t(1), std::size_t(2), std::size_t(5)})
+    {
+        IndMatches vec_nIndice;
+        std::vector<float> vec_fDistance;
+        BOOST_CHECK(matcher.SearchNeighbours(query.data(), nbQuery, &vec_nIndice, &vec_fDistance, NN));
+        BOOST_CHECK_EQUAL(nbQuery * NN, vec_nIndice.size());
+
+        for (int q = 0; q < nbQuery; ++q)
+        {
+            // reference: stable sort of all the distances, ties keep the lowest index first
+            std::vector<std::pair<float, int>> distances(nbRows);
+            for (int i = 0; i < nbRows; ++i)
+            {
+                float dist = 0.f;
+                for (int d = 0; d < dimension; ++d)
+                    dist += Square(query[q * dimension + d] - array[i * dimension + d]);
+                distances[i] = std::make_pair(dist, i);
+            }
+            std::stable_sort(distances.begin(), distances.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+            for (std::size_t n = 0; n < NN; ++n)
+            {
+                BOOST_CHECK_EQUAL(IndMatch(q, distances[n].second), vec_nIndice[q * NN + n]);
+                BOOST_CHECK_SMALL(static_cast<double>(vec_fDistance[q * NN + n] - distances[n].first), 1e-6);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(Matching_ArrayMatcher_bruteForce_Simple_Dim4)
 {
     std::random_device rd;
@@ -240,7 +240,7 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
 
         robustEstimation::Mat3Model model;
         const std::pair<double, double> ACRansacOut =
-          ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upper_bound_precision);
+          ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upper_bound_precision, true);
 
         m_F = model.getMatrix();
 
@@ -287,7 +287,7 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
 
         ModelT_ model;
         const std::pair<double, double> ACRansacOut =
-          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upperBoundPrecision);
+          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upperBoundPrecision, true);
         m_F = model.getMatrix();
 
         if (out_inliers.empty())
@@ -82,7 +82,7 @@ struct GeometricFilterMatrix_H_AC : public GeometricFilterMatrix
         std::vector<std::size_t> inliers;
         robustEstimation::Mat3Model model;
         const std::pair<double, double> ACRansacOut =
-          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, inliers, m_stIteration, &model, upperBoundPrecision);
+          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, inliers, m_stIteration, &model, upperBoundPrecision, true);
         m_H = model.getMatrix();
 
         if (inliers.empty())
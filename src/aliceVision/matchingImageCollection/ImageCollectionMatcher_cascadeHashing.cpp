@@ -12,6 +12,9 @@
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/config.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace aliceVision {
 namespace matchingImageCollection {
 
@@ -25,7 +28,17 @@ ImageCollectionMatcher_cascadeHashing ::ImageCollectionMatcher_cascadeHashing(fl
 
 namespace impl {
 template<typename ScalarT>
-void Match(std::mt19937& gen,
+Eigen::VectorXf getMeanDescriptor(const feature::Regions& regions)
+{
+    typedef Eigen::Matrix<ScalarT, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> BaseMat;
+    const ScalarT* tab = reinterpret_cast<const ScalarT*>(regions.DescriptorRawData());
+    Eigen::Map<BaseMat> mat((ScalarT*)tab, regions.RegionCount(), regions.DescriptorLength());
+    return CascadeHasher::GetZeroMeanDescriptor(mat);
+}
+
+template<typename ScalarT>
+void Match(const CascadeHasher& cascade_hasher,
+           const Eigen::VectorXf& sharedZeroMeanDescriptor,
            const feature::RegionsPerView& regionsPerView,
            const PairSet& pairs,
            EImageDescriberType descType,
@@ -37,117 +50,101 @@ void Match(std::mt19937& gen,
 
     // Collect used view indexes
     std::set<IndexT> used_index;
-    // Sort pairs according the first index to minimize later memory swapping
-    typedef std::map<IndexT, std::vector<IndexT>> Map_vectorT;
-    Map_vectorT map_Pairs;
     for (PairSet::const_iterator iter = pairs.begin(); iter != pairs.end(); ++iter)
     {
-        map_Pairs[iter->first].push_back(iter->second);
         used_index.insert(iter->first);
         used_index.insert(iter->second);
     }
+    const std::vector<IndexT> usedViews(used_index.begin(), used_index.end());
 
     typedef Eigen::Matrix<ScalarT, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> BaseMat;
 
-    // Init the cascade hasher
-    CascadeHasher cascade_hasher;
-    if (!used_index.empty())
-    {
-        const IndexT I = *used_index.begin();
-        const feature::Regions& regionsI = regionsPerView.getRegions(I, descType);
-        const size_t dimension = regionsI.DescriptorLength();
-        cascade_hasher.Init(gen, dimension);
-    }
-
-    std::map<IndexT, HashedDescriptions> hashed_base_;
-
-    // Compute the zero mean descriptor that will be used for hashing (one for all the image regions)
-    Eigen::VectorXf zero_mean_descriptor;
+    // Compute the zero mean descriptor that will be used for hashing (one for all the image regions),
+    // unless it was computed from all the views before the call
+    Eigen::VectorXf zero_mean_descriptor = sharedZeroMeanDescriptor;
+    if (zero_mean_descriptor.size() == 0)
     {
         Eigen::MatrixXf matForZeroMean;
-        for (int i = 0; i < used_index.size(); ++i)
+        for (int i = 0; i < usedViews.size(); ++i)
         {
-            std::set<IndexT>::const_iterator iter = used_index.begin();
-            std::advance(iter, i);
-            const IndexT I = *iter;
-            const feature::Regions& regionsI = regionsPerView.getRegions(I, descType);
-            const ScalarT* tabI = reinterpret_cast<const ScalarT*>(regionsI.DescriptorRawData());
-            const size_t dimension = regionsI.DescriptorLength();
+            const feature::Regions& regionsI = regionsPerView.getRegions(usedViews[i], descType);
             if (i == 0)
             {
-                matForZeroMean.resize(used_index.size(), dimension);
+                matForZeroMean.resize(usedViews.size(), regionsI.DescriptorLength());
                 matForZeroMean.fill(0.0f);
             }
             if (regionsI.RegionCount() > 0)
-            {
-                Eigen::Map<BaseMat> mat_I((ScalarT*)tabI, regionsI.RegionCount(), dimension);
-                matForZeroMean.row(i) = CascadeHasher::GetZeroMeanDescriptor(mat_I);
-            }
+                matForZeroMean.row(i) = getMeanDescriptor<ScalarT>(regionsI);
         }
         zero_mean_descriptor = CascadeHasher::GetZeroMeanDescriptor(matForZeroMean);
     }
 
-// Index the input regions
+    // Index the input regions: each view is hashed exactly once,
+    // the hashed descriptions and the features positions are shared by all its pairs.
+    std::vector<HashedDescriptions> hashedDescriptions(usedViews.size());
+    std::vector<std::vector<feature::PointFeature>> pointFeatures(usedViews.size());
+
 #pragma omp parallel for schedule(dynamic)
-    for (int i = 0; i < used_index.size(); ++i)
+    for (int i = 0; i < usedViews.size(); ++i)
     {
-        std::set<IndexT>::const_iterator iter = used_index.begin();
-        std::advance(iter, i);
-        const IndexT I = *iter;
-        const feature::Regions& regionsI = regionsPerView.getRegions(I, descType);
+        const feature::Regions& regionsI = regionsPerView.getRegions(usedViews[i], descType);
         const ScalarT* tabI = reinterpret_cast<const ScalarT*>(regionsI.DescriptorRawData());
         const size_t dimension = regionsI.DescriptorLength();
 
         Eigen::Map<BaseMat> mat_I((ScalarT*)tabI, regionsI.RegionCount(), dimension);
-        HashedDescriptions hashed_description = cascade_hasher.CreateHashedDescriptions(mat_I, zero_mean_descriptor);
-#pragma omp critical
-        {
-            hashed_base_[I] = std::move(hashed_description);
-        }
+        hashedDescriptions[i] = cascade_hasher.CreateHashedDescriptions(mat_I, zero_mean_descriptor);
+        pointFeatures[i] = regionsI.GetRegionsPositions();
     }
 
-    // Perform matching between all the pairs
-    for (Map_vectorT::const_iterator iter = map_Pairs.begin(); iter != map_Pairs.end(); ++iter)
+    const auto getViewIndex = [&usedViews](IndexT viewId) -> std::size_t {
+        return std::distance(usedViews.begin(), std::lower_bound(usedViews.begin(), usedViews.end(), viewId));
+    };
+
+    // Perform matching between all the pairs, streamed against the shared hashed descriptions
+    const std::vector<Pair> pairsToMatch(pairs.begin(), pairs.end());
+
+#pragma omp parallel
     {
-        const IndexT I = iter->first;
-        const std::vector<IndexT>& indexToCompare = iter->second;
+        // matching buffers, reused for all the pairs of this thread
+        CascadeHasherMatchingBuffers matchingBuffers;
+        IndMatches pvec_indices;
+        typedef typename Accumulator<ScalarT>::Type ResultType;
+        std::vector<ResultType> pvec_distances;
 
-        const feature::Regions& regionsI = regionsPerView.getRegions(I, descType);
-        if (regionsI.RegionCount() == 0)
+#pragma omp for schedule(dynamic)
+        for (int p = 0; p < (int)pairsToMatch.size(); ++p)
         {
-            progressDisplay += indexToCompare.size();
-            continue;
-        }
+            const IndexT I = pairsToMatch[p].first;
+            const IndexT J = pairsToMatch[p].second;
 
-        const std::vector<feature::PointFeature> pointFeaturesI = regionsI.GetRegionsPositions();
-        const ScalarT* tabI = reinterpret_cast<const ScalarT*>(regionsI.DescriptorRawData());
-        const size_t dimension = regionsI.DescriptorLength();
-        Eigen::Map<BaseMat> mat_I((ScalarT*)tabI, regionsI.RegionCount(), dimension);
-#pragma omp parallel for schedule(dynamic)
-        for (int j = 0; j < (int)indexToCompare.size(); ++j)
-        {
-            size_t J = indexToCompare[j];
-            const feature::Regions& regionsJ = regionsPerView.getRegions(I, descType);
+            const std::size_t indexI = getViewIndex(I);
+            const std::size_t indexJ = getViewIndex(J);
+
+            const feature::Regions& regionsI = regionsPerView.getRegions(I, descType);
+            const feature::Regions& regionsJ = regionsPerView.getRegions(J, descType);
 
-            if (!regionsPerView.viewExist(J) || regionsI.Type_id() != regionsJ.Type_id())
+            if (regionsI.RegionCount() == 0 || regionsI.Type_id() != regionsJ.Type_id())
             {
+#pragma omp critical
                 ++progressDisplay;
                 continue;
             }
 
-            // Matrix representation of the query input data;
+            // Matrix representation of the input data;
+            const size_t dimension = regionsI.DescriptorLength();
+            const ScalarT* tabI = reinterpret_cast<const ScalarT*>(regionsI.DescriptorRawData());
             const ScalarT* tabJ = reinterpret_cast<const ScalarT*>(regionsJ.DescriptorRawData());
+            Eigen::Map<BaseMat> mat_I((ScalarT*)tabI, regionsI.RegionCount(), dimension);
             Eigen::Map<BaseMat> mat_J((ScalarT*)tabJ, regionsJ.RegionCount(), dimension);
 
-            IndMatches pvec_indices;
-            typedef typename Accumulator<ScalarT>::Type ResultType;
-            std::vector<ResultType> pvec_distances;
+            pvec_indices.clear();
+            pvec_distances.clear();
             pvec_distances.reserve(regionsJ.RegionCount() * 2);
             pvec_indices.reserve(regionsJ.RegionCount() * 2);
 
             // Match the query descriptors to the database
-            cascade_hasher.Match_HashedDescriptions<BaseMat, ResultType>(
-              hashed_base_[J], mat_J, hashed_base_[I], mat_I, &pvec_indices, &pvec_distances);
+            cascade_hasher.Match_HashedDescriptions(
+              hashedDescriptions[indexJ], mat_J, hashedDescriptions[indexI], mat_I, &pvec_indices, &pvec_distances, matchingBuffers);
 
             std::vector<int> vec_nn_ratio_idx;
             // Filter the matches using a distance ratio test:
@@ -172,8 +169,7 @@ void Match(std::mt19937& gen,
             matching::IndMatch::getDeduplicated(vec_putative_matches);
 
             // Remove matches that have the same (X,Y) coordinates
-            const std::vector<feature::PointFeature> pointFeaturesJ = regionsJ.GetRegionsPositions();
-            matching::IndMatchDecorator<float> matchDeduplicator(vec_putative_matches, pointFeaturesI, pointFeaturesJ);
+            matching::IndMatchDecorator<float> matchDeduplicator(vec_putative_matches, pointFeatures[indexI], pointFeatures[indexJ]);
             matchDeduplicator.getDeduplicated(vec_putative_matches);
 
 #pragma omp critical
@@ -209,13 +205,25 @@ void ImageCollectionMatcher_cascadeHashing::Match(std::mt19937& gen,
     if (regions.IsBinary())
         return;
 
+    // the cascade hasher is initialized once per describer type, all the Match calls share the same hashing
+    Hashing& hashing = _hashingPerDescType[descType];
+    if (!hashing.isInitialized)
+    {
+        hashing.cascadeHasher.Init(gen, regions.DescriptorLength());
+        hashing.isInitialized = true;
+    }
+
+    Eigen::VectorXf zeroMeanDescriptor;
+    if (hashing.nbViews > 0)
+        zeroMeanDescriptor = hashing.meanDescriptorsSum / static_cast<double>(hashing.nbViews);
+
     if (regions.Type_id() == typeid(unsigned char).name())
     {
-        impl::Match<unsigned char>(gen, regionsPerView, pairs, descType, f_dist_ratio_, map_PutativesMatches);
+        impl::Match<unsigned char>(hashing.cascadeHasher, zeroMeanDescriptor, regionsPerView, pairs, descType, f_dist_ratio_, map_PutativesMatches);
     }
     else if (regions.Type_id() == typeid(float).name())
     {
-        impl::Match<float>(gen, regionsPerView, pairs, descType, f_dist_ratio_, map_PutativesMatches);
+        impl::Match<float>(hashing.cascadeHasher, zeroMeanDescriptor, regionsPerView, pairs, descType, f_dist_ratio_, map_PutativesMatches);
     }
     else
     {
@@ -223,5 +231,32 @@ void ImageCollectionMatcher_cascadeHashing::Match(std::mt19937& gen,
     }
 }
 
+void ImageCollectionMatcher_cascadeHashing::addToZeroMeanDescriptor(const feature::RegionsPerView& regionsPerView,
+                                                                    const std::set<IndexT>& viewIds,
+                                                                    feature::EImageDescriberType descType)
+{
+    Hashing& hashing = _hashingPerDescType[descType];
+
+    for (const IndexT viewId : viewIds)
+    {
+        const feature::Regions& regions = regionsPerView.getRegions(viewId, descType);
+        if (regions.IsBinary())
+            continue;
+
+        if (hashing.meanDescriptorsSum.size() == 0)
+            hashing.meanDescriptorsSum.setZero(regions.DescriptorLength());
+
+        // views without regions count as null mean descriptors, as in Match
+        ++hashing.nbViews;
+        if (regions.RegionCount() == 0)
+            continue;
+
+        if (regions.Type_id() == typeid(unsigned char).name())
+            hashing.meanDescriptorsSum += impl::getMeanDescriptor<unsigned char>(regions);
+        else if (regions.Type_id() == typeid(float).name())
+            hashing.meanDescriptorsSum += impl::getMeanDescriptor<float>(regions);
+    }
+}
+
 }  // namespace matchingImageCollection
 }  // namespace aliceVision
@@ -8,6 +8,9 @@
 #pragma once
 
 #include "aliceVision/matchingImageCollection/IImageCollectionMatcher.hpp"
+#include "aliceVision/matching/CascadeHasher.hpp"
+
+#include <map>
 
 namespace aliceVision {
 namespace matchingImageCollection {
@@ -18,7 +21,9 @@ namespace matchingImageCollection {
  * Spurious correspondences are discarded by using the
  * a threshold over the distance ratio of the 2 nearest neighbours.
  *
- * @note: Cascade hashing tables are computed once and used for all the regions.
+ * @note: Cascade hashing tables are computed once per describer type and used for all the regions,
+ *        including the following Match calls. Each view is hashed once, then all the pairs are
+ *        matched in parallel against the shared hashed descriptions.
  * @warning: all descriptors are loaded in memory. You need to ensure that it can fit in RAM.
  */
 class ImageCollectionMatcher_cascadeHashing : public IImageCollectionMatcher
@@ -34,9 +39,34 @@ class ImageCollectionMatcher_cascadeHashing : public IImageCollectionMatcher
                matching::PairwiseMatches& map_PutativesMatches  // the pairwise photometric corresponding points
     ) const;
 
+    /**
+     * @brief Add views to the zero mean descriptor of the hashing of a describer type.
+     * @note When the pairs are matched in several Match calls (e.g. by blocks of views), all the views are added
+     *       before the first call so that the matches do not depend on the blocks.
+     *       Otherwise, the zero mean descriptor is computed from the views of each Match call.
+     * @param[in] regionsPerView The regions of the views
+     * @param[in] viewIds The views to add, each view must be added once
+     * @param[in] descType The describer type
+     */
+    void addToZeroMeanDescriptor(const feature::RegionsPerView& regionsPerView, const std::set<IndexT>& viewIds, feature::EImageDescriberType descType);
+
   private:
+    /**
+     * @brief Hashing shared by the Match calls of a describer type
+     */
+    struct Hashing
+    {
+        matching::CascadeHasher cascadeHasher;
+        bool isInitialized = false;
+        /// sum of the mean descriptors of the added views
+        Eigen::VectorXf meanDescriptorsSum;
+        std::size_t nbViews = 0;
+    };
+
     // Distance ratio used to discard spurious correspondence
     float f_dist_ratio_;
+    /// hashing per describer type, initialized by the first Match call
+    mutable std::map<feature::EImageDescriberType, Hashing> _hashingPerDescType;
 };
 
 }  // namespace matchingImageCollection
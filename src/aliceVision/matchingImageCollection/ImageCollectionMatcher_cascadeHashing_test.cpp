@@ -0,0 +1,100 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "aliceVision/matchingImageCollection/ImageCollectionMatcher_cascadeHashing.hpp"
+#include "aliceVision/feature/RegionsPerView.hpp"
+
+#include <random>
+#include <set>
+
+#define BOOST_TEST_MODULE matchingImageCollectionCascadeHashing
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::matchingImageCollection;
+
+namespace {
+
+using TestRegions = feature::ScalarRegions<float, 128>;
+
+const feature::EImageDescriberType descType = feature::EImageDescriberType::SIFT;
+
+// views observing a shared set of noisy descriptors
+feature::RegionsPerView makeRegionsPerView(IndexT nbViews, std::size_t nbDescriptors)
+{
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> descriptorDist(0.f, 255.f);
+    std::normal_distribution<float> noiseDist(0.f, 4.f);
+
+    std::vector<TestRegions::DescriptorT> sceneDescriptors(nbDescriptors);
+    for (auto& descriptor : sceneDescriptors)
+        for (std::size_t i = 0; i < descriptor.size(); ++i)
+            descriptor[i] = descriptorDist(gen);
+
+    feature::RegionsPerView regionsPerView;
+    for (IndexT viewId = 0; viewId < nbViews; ++viewId)
+    {
+        auto* regions = new TestRegions();
+        for (std::size_t d = 0; d < nbDescriptors; ++d)
+        {
+            TestRegions::DescriptorT descriptor = sceneDescriptors[d];
+            for (std::size_t i = 0; i < descriptor.size(); ++i)
+                descriptor[i] += noiseDist(gen);
+            regions->Features().emplace_back(float(d), float(d), 1.f, 0.f);
+            regions->Descriptors().push_back(descriptor);
+        }
+        regionsPerView.addRegions(viewId, descType, regions);
+    }
+    return regionsPerView;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(matchingImageCollection_cascadeHashing_byBlocks)
+{
+    const IndexT nbViews = 6;
+    const feature::RegionsPerView regionsPerView = makeRegionsPerView(nbViews, 200);
+
+    PairSet pairs, firstBlockPairs, secondBlockPairs;
+    for (IndexT i = 0; i < nbViews; ++i)
+        for (IndexT j = i + 1; j < nbViews; ++j)
+        {
+            pairs.insert(std::make_pair(i, j));
+            (j < nbViews / 2 ? firstBlockPairs : secondBlockPairs).insert(std::make_pair(i, j));
+        }
+
+    // all the pairs in a single call
+    matching::PairwiseMatches matches;
+    {
+        std::mt19937 gen(42);
+        ImageCollectionMatcher_cascadeHashing matcher(0.8f);
+        matcher.Match(gen, regionsPerView, pairs, descType, matches);
+    }
+
+    // the pairs by blocks, sharing the hashing and the zero mean descriptor of all the views
+    matching::PairwiseMatches blockMatches;
+    {
+        std::mt19937 gen(42);
+        ImageCollectionMatcher_cascadeHashing matcher(0.8f);
+        std::set<IndexT> viewIds;
+        for (IndexT viewId = 0; viewId < nbViews; ++viewId)
+            viewIds.insert(viewId);
+        matcher.addToZeroMeanDescriptor(regionsPerView, viewIds, descType);
+
+        matcher.Match(gen, regionsPerView, firstBlockPairs, descType, blockMatches);
+        matcher.Match(gen, regionsPerView, secondBlockPairs, descType, blockMatches);
+    }
+
+    BOOST_CHECK_EQUAL(matches.size(), pairs.size());
+    BOOST_REQUIRE_EQUAL(blockMatches.size(), matches.size());
+    for (const auto& pairMatches : matches)
+    {
+        const auto& descMatches = pairMatches.second.at(descType);
+        BOOST_CHECK_GT(descMatches.size(), 100);
+        BOOST_CHECK(blockMatches.at(pairMatches.first).at(descType) == descMatches);
+    }
+}
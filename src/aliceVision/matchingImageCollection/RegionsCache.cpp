@@ -0,0 +1,137 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "RegionsCache.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <exception>
+
+namespace aliceVision {
+namespace matchingImageCollection {
+
+RegionsCache::RegionsCache(RegionsLoader loader, const std::vector<feature::EImageDescriberType>& descTypes, std::size_t maxResidentBytes)
+  : _loader(std::move(loader)),
+    _descTypes(descTypes),
+    _maxResidentBytes(maxResidentBytes)
+{}
+
+void RegionsCache::evict(const std::set<IndexT>& keptViewIds, std::size_t maxBytes)
+{
+    auto it = _lru.end();
+    while (_residentBytes > maxBytes && it != _lru.begin())
+    {
+        --it;
+        const IndexT viewId = *it;
+        if (keptViewIds.count(viewId))
+            continue;
+
+        const Entry& entry = _entries.at(viewId);
+        _residentBytes -= entry.bytes;
+        _residentDescriptors -= entry.nbDescriptors;
+        _entries.erase(viewId);
+        _regionsPerView.removeRegions(viewId);
+        it = _lru.erase(it);
+        ++_statistics.evictions;
+    }
+}
+
+void RegionsCache::acquire(const std::set<IndexT>& viewIds)
+{
+    // update the resident views and collect the missing ones
+    std::vector<IndexT> missingViewIds;
+    for (const IndexT viewId : viewIds)
+    {
+        auto entryIt = _entries.find(viewId);
+        if (entryIt != _entries.end())
+        {
+            _lru.splice(_lru.begin(), _lru, entryIt->second.lruIt);
+            ++_statistics.hits;
+        }
+        else
+        {
+            missingViewIds.push_back(viewId);
+            ++_statistics.misses;
+        }
+    }
+
+    if (missingViewIds.empty())
+        return;
+
+    // make room for the missing views, estimated from the average size of the resident views
+    if (!_entries.empty())
+    {
+        const std::size_t averageBytes = _residentBytes / _entries.size();
+        const std::size_t neededBytes = averageBytes * missingViewIds.size();
+        evict(viewIds, neededBytes < _maxResidentBytes ? _maxResidentBytes - neededBytes : 0);
+    }
+
+    // load the missing views in parallel
+    const std::size_t nbDescTypes = _descTypes.size();
+    std::vector<std::unique_ptr<feature::Regions>> loadedRegions(missingViewIds.size() * nbDescTypes);
+    std::exception_ptr loadingException;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(loadedRegions.size()); ++i)
+    {
+        try
+        {
+            loadedRegions[i] = _loader(missingViewIds[i / nbDescTypes], _descTypes[i % nbDescTypes]);
+        }
+        catch (...)
+        {
+#pragma omp critical
+            loadingException = std::current_exception();
+        }
+    }
+
+    if (loadingException)
+        std::rethrow_exception(loadingException);
+
+    for (std::size_t v = 0; v < missingViewIds.size(); ++v)
+    {
+        const IndexT viewId = missingViewIds[v];
+        Entry entry;
+        for (std::size_t d = 0; d < nbDescTypes; ++d)
+        {
+            std::unique_ptr<feature::Regions>& regions = loadedRegions[v * nbDescTypes + d];
+            entry.nbDescriptors += regions->RegionCount();
+            entry.bytes += regions->RegionCount() * regions->DescriptorSize();
+            _regionsPerView.addRegions(viewId, _descTypes[d], regions.release());
+        }
+        _lru.push_front(viewId);
+        entry.lruIt = _lru.begin();
+        _residentBytes += entry.bytes;
+        _residentDescriptors += entry.nbDescriptors;
+        _entries.emplace(viewId, entry);
+    }
+
+    _statistics.peakResidentViews = std::max(_statistics.peakResidentViews, _entries.size());
+    _statistics.peakResidentDescriptors = std::max(_statistics.peakResidentDescriptors, _residentDescriptors);
+    _statistics.peakResidentBytes = std::max(_statistics.peakResidentBytes, _residentBytes);
+
+    // fit in the budget with the actual sizes
+    evict(viewIds, _maxResidentBytes);
+
+    if (_residentBytes > _maxResidentBytes)
+    {
+        ALICEVISION_LOG_WARNING("The regions of " << viewIds.size() << " views need " << _residentBytes / (1024 * 1024)
+                                                  << " MB, more than the regions cache size (" << _maxResidentBytes / (1024 * 1024) << " MB).");
+    }
+}
+
+void RegionsCache::logStatistics() const
+{
+    ALICEVISION_LOG_INFO("Regions cache statistics:" << "\n\t- hit rate: " << 100.0 * _statistics.hitRate() << "% (" << _statistics.hits << " hits, "
+                                                     << _statistics.misses << " misses, " << _statistics.evictions << " evictions)"
+                                                     << "\n\t- peak resident views: " << _statistics.peakResidentViews
+                                                     << "\n\t- peak resident descriptors: " << _statistics.peakResidentDescriptors << " ("
+                                                     << _statistics.peakResidentBytes / (1024 * 1024) << " MB)");
+}
+
+}  // namespace matchingImageCollection
+}  // namespace aliceVision
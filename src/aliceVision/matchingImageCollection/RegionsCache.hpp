@@ -0,0 +1,102 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/feature/imageDescriberCommon.hpp>
+#include <aliceVision/feature/RegionsPerView.hpp>
+#include <aliceVision/types.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace aliceVision {
+namespace matchingImageCollection {
+
+/**
+ * @brief LRU cache of the regions of the views, bounded by the memory of the descriptors.
+ *
+ * The regions of a set of views are made resident with acquire(), the least recently used
+ * views that are not requested are evicted to stay within the memory budget.
+ * The budget can only be exceeded if the requested views alone do not fit in it.
+ */
+class RegionsCache
+{
+  public:
+    /// Load the regions of a view for one describer type (called concurrently)
+    using RegionsLoader = std::function<std::unique_ptr<feature::Regions>(IndexT viewId, feature::EImageDescriberType descType)>;
+
+    struct Statistics
+    {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+        std::size_t peakResidentViews = 0;
+        std::size_t peakResidentDescriptors = 0;
+        std::size_t peakResidentBytes = 0;
+
+        double hitRate() const { return (hits + misses) == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses); }
+    };
+
+    /**
+     * @param[in] loader The regions loader
+     * @param[in] descTypes The describer types to load for each view
+     * @param[in] maxResidentBytes The memory budget for the resident descriptors (in bytes)
+     */
+    RegionsCache(RegionsLoader loader, const std::vector<feature::EImageDescriberType>& descTypes, std::size_t maxResidentBytes);
+
+    /**
+     * @brief Make the regions of the given views resident.
+     * @param[in] viewIds The views needed until the next call
+     */
+    void acquire(const std::set<IndexT>& viewIds);
+
+    /// The resident regions, valid until the next call to acquire()
+    const feature::RegionsPerView& getRegionsPerView() const { return _regionsPerView; }
+
+    std::size_t getMaxResidentBytes() const { return _maxResidentBytes; }
+
+    std::size_t getResidentBytes() const { return _residentBytes; }
+
+    std::size_t getResidentViews() const { return _entries.size(); }
+
+    const Statistics& getStatistics() const { return _statistics; }
+
+    /// Log the cache hit rate and the peak resident descriptors
+    void logStatistics() const;
+
+  private:
+    struct Entry
+    {
+        std::list<IndexT>::iterator lruIt;
+        std::size_t nbDescriptors = 0;
+        std::size_t bytes = 0;
+    };
+
+    /// Evict the least recently used views not in the given set, until the resident memory is below the given size.
+    void evict(const std::set<IndexT>& keptViewIds, std::size_t maxBytes);
+
+    RegionsLoader _loader;
+    std::vector<feature::EImageDescriberType> _descTypes;
+    std::size_t _maxResidentBytes;
+
+    feature::RegionsPerView _regionsPerView;
+    /// view ids, most recently used first
+    std::list<IndexT> _lru;
+    std::map<IndexT, Entry> _entries;
+    std::size_t _residentBytes = 0;
+    std::size_t _residentDescriptors = 0;
+
+    Statistics _statistics;
+};
+
+}  // namespace matchingImageCollection
+}  // namespace aliceVision
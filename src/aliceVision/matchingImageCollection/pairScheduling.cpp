@@ -0,0 +1,129 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "pairScheduling.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <set>
+
+namespace aliceVision {
+namespace matchingImageCollection {
+
+std::vector<IndexT> localityViewsOrder(const PairSet& pairs)
+{
+    std::map<IndexT, std::vector<IndexT>> adjacency;
+    for (const Pair& pair : pairs)
+    {
+        adjacency[pair.first].push_back(pair.second);
+        adjacency[pair.second].push_back(pair.first);
+    }
+
+    const auto lessDegree = [&adjacency](IndexT a, IndexT b) {
+        const std::size_t degreeA = adjacency.at(a).size();
+        const std::size_t degreeB = adjacency.at(b).size();
+        return degreeA < degreeB || (degreeA == degreeB && a < b);
+    };
+
+    // candidate start views, by increasing degree
+    std::vector<IndexT> startViews;
+    startViews.reserve(adjacency.size());
+    for (const auto& it : adjacency)
+        startViews.push_back(it.first);
+    std::sort(startViews.begin(), startViews.end(), lessDegree);
+
+    std::vector<IndexT> order;
+    order.reserve(adjacency.size());
+    std::set<IndexT> visited;
+    std::deque<IndexT> queue;
+
+    for (const IndexT startView : startViews)
+    {
+        if (!visited.insert(startView).second)
+            continue;
+
+        queue.push_back(startView);
+        while (!queue.empty())
+        {
+            const IndexT viewId = queue.front();
+            queue.pop_front();
+            order.push_back(viewId);
+
+            std::vector<IndexT> neighbours;
+            for (const IndexT neighbour : adjacency.at(viewId))
+            {
+                if (visited.insert(neighbour).second)
+                    neighbours.push_back(neighbour);
+            }
+            std::sort(neighbours.begin(), neighbours.end(), lessDegree);
+            queue.insert(queue.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+    return order;
+}
+
+std::vector<PairSet> blockPairsSchedule(const PairSet& pairs, std::size_t viewsPerBlock)
+{
+    viewsPerBlock = std::max<std::size_t>(viewsPerBlock, 1);
+
+    const std::vector<IndexT> order = localityViewsOrder(pairs);
+    std::map<IndexT, std::size_t> blockPerView;
+    for (std::size_t i = 0; i < order.size(); ++i)
+        blockPerView[order[i]] = i / viewsPerBlock;
+
+    std::map<std::pair<std::size_t, std::size_t>, PairSet> tiles;
+    for (const Pair& pair : pairs)
+    {
+        const std::size_t blockA = blockPerView.at(pair.first);
+        const std::size_t blockB = blockPerView.at(pair.second);
+        tiles[std::minmax(blockA, blockB)].insert(pair);
+    }
+
+    std::vector<PairSet> schedule;
+    schedule.reserve(tiles.size());
+    for (auto& tile : tiles)
+        schedule.push_back(std::move(tile.second));
+    return schedule;
+}
+
+void processPairsByBlocks(RegionsCache& regionsCache,
+                          const PairSet& pairs,
+                          const std::function<void(const feature::RegionsPerView& regionsPerView, const PairSet& tilePairs)>& processTile)
+{
+    if (pairs.empty())
+        return;
+
+    // estimate the memory of the regions of one view from the first views
+    const std::vector<IndexT> order = localityViewsOrder(pairs);
+    const std::size_t nbSampleViews = std::min<std::size_t>(order.size(), 8);
+    regionsCache.acquire(std::set<IndexT>(order.begin(), order.begin() + nbSampleViews));
+    const std::size_t bytesPerView = std::max<std::size_t>(regionsCache.getResidentBytes() / nbSampleViews, 1);
+
+    // a tile involves two blocks of views
+    const std::size_t viewsPerBlock = std::max<std::size_t>(regionsCache.getMaxResidentBytes() / (2 * bytesPerView), 1);
+    const std::vector<PairSet> schedule = blockPairsSchedule(pairs, viewsPerBlock);
+
+    ALICEVISION_LOG_INFO("Process " << pairs.size() << " pairs in " << schedule.size() << " tiles of " << viewsPerBlock << " x "
+                                    << viewsPerBlock << " views.");
+
+    for (const PairSet& tilePairs : schedule)
+    {
+        std::set<IndexT> tileViewIds;
+        for (const Pair& pair : tilePairs)
+        {
+            tileViewIds.insert(pair.first);
+            tileViewIds.insert(pair.second);
+        }
+        regionsCache.acquire(tileViewIds);
+        processTile(regionsCache.getRegionsPerView(), tilePairs);
+    }
+}
+
+}  // namespace matchingImageCollection
+}  // namespace aliceVision
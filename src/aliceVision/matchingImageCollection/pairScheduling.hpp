@@ -0,0 +1,49 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/matchingImageCollection/RegionsCache.hpp>
+#include <aliceVision/types.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace aliceVision {
+namespace matchingImageCollection {
+
+/**
+ * @brief Order the views of the pair graph to keep connected views close to each other
+ *        (Cuthill-McKee breadth-first ordering, each connected component in turn).
+ * @param[in] pairs The pairs to match
+ * @return The ordered view ids
+ */
+std::vector<IndexT> localityViewsOrder(const PairSet& pairs);
+
+/**
+ * @brief Split the pairs into tiles of the pair matrix, such that each tile only involves
+ *        the views of two blocks of consecutive views in the locality order.
+ *        Tiles (i, j) are sorted by block i then block j, so block i stays in use along its row.
+ * @param[in] pairs The pairs to match
+ * @param[in] viewsPerBlock The number of views per block
+ * @return The non-empty tiles, every pair is in exactly one tile
+ */
+std::vector<PairSet> blockPairsSchedule(const PairSet& pairs, std::size_t viewsPerBlock);
+
+/**
+ * @brief Process the pairs by tiles, with only the regions of the views of the current tile
+ *        guaranteed to be resident in the regions cache.
+ *        The size of the blocks is deduced from the cache size and the regions of the first views.
+ * @param[in,out] regionsCache The regions cache
+ * @param[in] pairs The pairs to process
+ * @param[in] processTile The function called for each tile with the resident regions
+ */
+void processPairsByBlocks(RegionsCache& regionsCache,
+                          const PairSet& pairs,
+                          const std::function<void(const feature::RegionsPerView& regionsPerView, const PairSet& tilePairs)>& processTile);
+
+}  // namespace matchingImageCollection
+}  // namespace aliceVision
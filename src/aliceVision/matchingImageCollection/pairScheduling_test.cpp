@@ -0,0 +1,146 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "aliceVision/matchingImageCollection/pairScheduling.hpp"
+#include "aliceVision/matchingImageCollection/RegionsCache.hpp"
+#include "aliceVision/feature/Regions.hpp"
+
+#include <memory>
+#include <set>
+
+#define BOOST_TEST_MODULE matchingImageCollectionPairScheduling
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::matchingImageCollection;
+
+namespace {
+
+// exhaustive pairs on two groups of views with a few links between the groups
+PairSet twoClustersPairs()
+{
+    PairSet pairs;
+    for (IndexT i = 0; i < 10; ++i)
+        for (IndexT j = i + 1; j < 10; ++j)
+        {
+            pairs.insert(std::make_pair(i, j));
+            pairs.insert(std::make_pair(100 + i, 100 + j));
+        }
+    pairs.insert(std::make_pair(3, 105));
+    pairs.insert(std::make_pair(7, 101));
+    return pairs;
+}
+
+using TestRegions = feature::ScalarRegions<unsigned char, 128>;
+
+std::unique_ptr<feature::Regions> loadTestRegions(IndexT viewId, feature::EImageDescriberType)
+{
+    auto regions = std::make_unique<TestRegions>();
+    for (IndexT i = 0; i < 10 + viewId; ++i)
+    {
+        regions->Features().emplace_back(float(i), float(viewId), 1.f, 0.f);
+        regions->Descriptors().emplace_back();
+    }
+    return regions;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(matchingImageCollection_localityViewsOrder)
+{
+    const PairSet pairs = twoClustersPairs();
+    const std::vector<IndexT> order = localityViewsOrder(pairs);
+
+    BOOST_CHECK_EQUAL(order.size(), 20);
+    BOOST_CHECK_EQUAL(std::set<IndexT>(order.begin(), order.end()).size(), 20);
+
+    // disconnected views are ordered too
+    const PairSet disconnectedPairs = {{0, 1}, {2, 3}, {4, 5}};
+    BOOST_CHECK_EQUAL(localityViewsOrder(disconnectedPairs).size(), 6);
+    BOOST_CHECK(localityViewsOrder(PairSet()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(matchingImageCollection_blockPairsSchedule)
+{
+    const PairSet pairs = twoClustersPairs();
+
+    for (std::size_t viewsPerBlock : {1, 3, 5, 10, 100})
+    {
+        const std::vector<PairSet> schedule = blockPairsSchedule(pairs, viewsPerBlock);
+
+        std::size_t nbPairs = 0;
+        PairSet scheduledPairs;
+        for (const PairSet& tilePairs : schedule)
+        {
+            BOOST_CHECK(!tilePairs.empty());
+            nbPairs += tilePairs.size();
+            scheduledPairs.insert(tilePairs.begin(), tilePairs.end());
+
+            std::set<IndexT> tileViewIds;
+            for (const Pair& pair : tilePairs)
+            {
+                tileViewIds.insert(pair.first);
+                tileViewIds.insert(pair.second);
+            }
+            BOOST_CHECK_LE(tileViewIds.size(), 2 * viewsPerBlock);
+        }
+        // each pair is scheduled exactly once
+        BOOST_CHECK_EQUAL(nbPairs, pairs.size());
+        BOOST_CHECK(scheduledPairs == pairs);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(matchingImageCollection_RegionsCache)
+{
+    const std::size_t viewBytes = 128 * 10;
+    RegionsCache cache(&loadTestRegions, {feature::EImageDescriberType::SIFT}, 4 * viewBytes);
+
+    cache.acquire({0, 1});
+    BOOST_CHECK_EQUAL(cache.getResidentViews(), 2);
+    BOOST_CHECK(cache.getRegionsPerView().viewExist(0));
+    BOOST_CHECK_EQUAL(cache.getRegionsPerView().getRegions(1, feature::EImageDescriberType::SIFT).RegionCount(), 11);
+
+    cache.acquire({1, 2});
+    BOOST_CHECK_EQUAL(cache.getStatistics().hits, 1);
+    BOOST_CHECK_EQUAL(cache.getStatistics().misses, 3);
+    BOOST_CHECK_EQUAL(cache.getStatistics().evictions, 0);
+
+    // view 0 is the least recently used
+    cache.acquire({2, 3});
+    BOOST_CHECK(!cache.getRegionsPerView().viewExist(0));
+    BOOST_CHECK(cache.getRegionsPerView().viewExist(1));
+    BOOST_CHECK_LE(cache.getResidentBytes(), cache.getMaxResidentBytes());
+
+    // requested views are always resident, even above the budget
+    cache.acquire({10, 11, 12, 13, 14});
+    BOOST_CHECK_EQUAL(cache.getResidentViews(), 5);
+    for (IndexT viewId = 10; viewId < 15; ++viewId)
+        BOOST_CHECK(cache.getRegionsPerView().viewExist(viewId));
+
+    BOOST_CHECK_GE(cache.getStatistics().peakResidentViews, 5);
+    BOOST_CHECK_GE(cache.getStatistics().peakResidentDescriptors, 5 * 10);
+}
+
+BOOST_AUTO_TEST_CASE(matchingImageCollection_processPairsByBlocks)
+{
+    const PairSet pairs = twoClustersPairs();
+    const std::size_t viewBytes = 128 * 20;
+    RegionsCache cache(&loadTestRegions, {feature::EImageDescriberType::SIFT}, 8 * viewBytes);
+
+    PairSet processedPairs;
+    processPairsByBlocks(cache, pairs, [&](const feature::RegionsPerView& regionsPerView, const PairSet& tilePairs) {
+        for (const Pair& pair : tilePairs)
+        {
+            BOOST_CHECK(regionsPerView.viewExist(pair.first));
+            BOOST_CHECK(regionsPerView.viewExist(pair.second));
+        }
+        processedPairs.insert(tilePairs.begin(), tilePairs.end());
+    });
+
+    BOOST_CHECK(processedPairs == pairs);
+    BOOST_CHECK_LT(cache.getStatistics().peakResidentViews, 20);
+}
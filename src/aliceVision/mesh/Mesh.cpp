@@ -7,6 +7,7 @@
 #include "Mesh.hpp"
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/utils/filesIO.hpp>
+#include <aliceVision/mesh/MeshAdjacency.hpp>
 #include <aliceVision/mesh/meshVisibility.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/OrientedPoint.hpp>
@@ -539,54 +540,16 @@ bool Mesh::doesTriangleIntersectsRectangle(Mesh::triangle_proj& tp, Mesh::rectan
 
 void Mesh::getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const
 {
-    // array of tuples <x: vertexIndex, y: triangleIndex, z: numberOfNeighbors>
-    StaticVector<Voxel> vertexNeighborhoodPairs;
-    vertexNeighborhoodPairs.reserve(tris.size() * 3);
-    for (int i = 0; i < tris.size(); ++i)
-    {
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[0], i, 0));
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[1], i, 0));
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[2], i, 0));
-    }
-    qsort(&vertexNeighborhoodPairs[0], vertexNeighborhoodPairs.size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
-
-    int i = 0;  // index of the unique pair of <vertex, neighborhood>
-    int j = 0;  // index of the vertex
-    int k = 0;  // number of neighbors
-    int firstid = 0;
-    while (i < vertexNeighborhoodPairs.size())
-    {
-        ++k;
-        // (*vertexNeighborhoodPairs)[i].z = j;
-        if ((i == vertexNeighborhoodPairs.size() - 1) || (vertexNeighborhoodPairs[i].x != vertexNeighborhoodPairs[i + 1].x))
-        {
-            vertexNeighborhoodPairs[firstid].z = k;  // store the number of neighbors
-            ++j;
-            firstid = i + 1;
-            k = 0;
-        }
-        ++i;
-    }
-    int npts = j;
+    const MeshAdjacency adjacency(*this);
 
     out_ptsNeighTris.reserve(pts.size());
     out_ptsNeighTris.resize(pts.size());
 
-    i = 0;
-    for (j = 0; j < npts; ++j)
+#pragma omp parallel for
+    for (int i = 0; i < pts.size(); ++i)
     {
-        int middlePtId = vertexNeighborhoodPairs[i].x;
-        int nbNeighbors = vertexNeighborhoodPairs[i].z;
-        int i0 = i;
-        int i1 = i + nbNeighbors;
-        i = i1;
-
-        StaticVector<int>& triTmp = out_ptsNeighTris[middlePtId];
-        triTmp.reserve(nbNeighbors);
-        for (int l = i0; l < i1; ++l)
-        {
-            triTmp.push_back(vertexNeighborhoodPairs[l].y);  // index of triangle
-        }
+        const MeshAdjacency::IndexRange ptTris = adjacency.getVertexTriangles(i);
+        out_ptsNeighTris[i].getDataWritable().assign(ptTris.begin(), ptTris.end());
     }
 }
 
@@ -610,78 +573,85 @@ void Mesh::getPtsNeighbors(std::vector<std::vector<int>>& out_ptsNeigh) const
 
 void Mesh::getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighPts) const
 {
-    StaticVector<StaticVector<int>> ptsNeighborTriangles;
-    getPtsNeighborTriangles(ptsNeighborTriangles);
+    const MeshAdjacency adjacency(*this);
+    getPtsNeighPtsOrdered(adjacency, out_ptsNeighPts);
+}
 
+void Mesh::getPtsNeighPtsOrdered(const MeshAdjacency& adjacency, StaticVector<StaticVector<int>>& out_ptsNeighPts) const
+{
     out_ptsNeighPts.resize(pts.size());
 
-    for (int middlePtId = 0; middlePtId < pts.size(); ++middlePtId)
+#pragma omp parallel
     {
-        StaticVector<int>& neighborTriangles = ptsNeighborTriangles[middlePtId];
-        if (neighborTriangles.empty())
-            continue;
-
-        StaticVector<int> vhid;
-        vhid.reserve(neighborTriangles.size() * 2);
-        int currentTriPtId = tris[neighborTriangles[0]].v[0];
-        int firstTriPtId = currentTriPtId;
-        vhid.push_back(currentTriPtId);
+        std::vector<int> neighborTriangles;
+        std::vector<int> vhid;
 
-        bool isThereTWithCurrentTriPtId = true;
-        while (!neighborTriangles.empty() && isThereTWithCurrentTriPtId)
+#pragma omp for
+        for (int middlePtId = 0; middlePtId < pts.size(); ++middlePtId)
         {
-            isThereTWithCurrentTriPtId = false;
+            const MeshAdjacency::IndexRange ptTris = adjacency.getVertexTriangles(middlePtId);
+            if (ptTris.empty())
+                continue;
 
-            // find triangle with middlePtId and currentTriPtId and get remaining point id
-            for (int n = 0; n < neighborTriangles.size(); ++n)
+            neighborTriangles.assign(ptTris.begin(), ptTris.end());
+            vhid.clear();
+            int currentTriPtId = tris[neighborTriangles[0]].v[0];
+            int firstTriPtId = currentTriPtId;
+            vhid.push_back(currentTriPtId);
+
+            bool isThereTWithCurrentTriPtId = true;
+            while (!neighborTriangles.empty() && isThereTWithCurrentTriPtId)
             {
-                bool ok_middlePtId = false;
-                bool ok_actTriPtId = false;
-                int remainingPtId = -1;  // remaining pt id
-                for (int k = 0; k < 3; ++k)
+                isThereTWithCurrentTriPtId = false;
+
+                // find triangle with middlePtId and currentTriPtId and get remaining point id
+                for (int n = 0; n < neighborTriangles.size(); ++n)
                 {
-                    int triPtId = tris[neighborTriangles[n]].v[k];
-                    double length = (pts[middlePtId] - pts[triPtId]).size();
-                    if ((triPtId != middlePtId) && (triPtId != currentTriPtId) && (length > 0.0) && (!std::isnan(length)))
+                    bool ok_middlePtId = false;
+                    bool ok_actTriPtId = false;
+                    int remainingPtId = -1;  // remaining pt id
+                    for (int k = 0; k < 3; ++k)
                     {
-                        remainingPtId = triPtId;
-                    }
-                    if (triPtId == middlePtId)
-                    {
-                        ok_middlePtId = true;
+                        int triPtId = tris[neighborTriangles[n]].v[k];
+                        double length = (pts[middlePtId] - pts[triPtId]).size();
+                        if ((triPtId != middlePtId) && (triPtId != currentTriPtId) && (length > 0.0) && (!std::isnan(length)))
+                        {
+                            remainingPtId = triPtId;
+                        }
+                        if (triPtId == middlePtId)
+                        {
+                            ok_middlePtId = true;
+                        }
+                        if (triPtId == currentTriPtId)
+                        {
+                            ok_actTriPtId = true;
+                        }
                     }
-                    if (triPtId == currentTriPtId)
+
+                    if (ok_middlePtId && ok_actTriPtId && (remainingPtId > -1))
                     {
-                        ok_actTriPtId = true;
+                        currentTriPtId = remainingPtId;
+                        neighborTriangles.erase(neighborTriangles.begin() + n);
+                        vhid.push_back(currentTriPtId);
+                        isThereTWithCurrentTriPtId = true;  // we removed one, so we try again
+                        break;
                     }
                 }
-
-                if (ok_middlePtId && ok_actTriPtId && (remainingPtId > -1))
-                {
-                    currentTriPtId = remainingPtId;
-                    neighborTriangles.remove(n);
-                    vhid.push_back(currentTriPtId);
-                    isThereTWithCurrentTriPtId = true;  // we removed one, so we try again
-                    break;
-                }
             }
-        }
 
-        if (!vhid.empty())
-        {
             if (currentTriPtId == firstTriPtId)
             {
-                vhid.pop();  // remove last ... which is first
+                vhid.pop_back();  // remove last ... which is first
             }
 
             // remove duplicates
             StaticVector<int>& vhid1 = out_ptsNeighPts[middlePtId];
             vhid1.reserve(vhid.size());
-            for (int k1 = 0; k1 < vhid.size(); ++k1)
+            for (const int ptId : vhid)
             {
-                if (vhid1.indexOf(vhid[k1]) == -1)
+                if (vhid1.indexOf(ptId) == -1)
                 {
-                    vhid1.push_back(vhid[k1]);
+                    vhid1.push_back(ptId);
                 }
             }
         }
@@ -1156,56 +1126,33 @@ void Mesh::generateMeshFromTrianglesSubset(const StaticVector<int>& visTris, Mes
 
 void Mesh::getNotOrientedEdges(StaticVector<StaticVector<int>>& edgesNeighTris, StaticVector<Pixel>& edgesPointsPairs)
 {
-    StaticVector<Voxel> edges;
-    edges.reserve(tris.size() * 3);
+    const MeshAdjacency adjacency(*this);
 
-    for (int i = 0; i < tris.size(); ++i)
+    // edges are sorted by first (smaller) point id, then by second point id
+    std::vector<int> edgesOffsets(pts.size() + 1, 0);
+    for (int a = 0; a < pts.size(); ++a)
     {
-        int a = tris[i].v[0];
-        int b = tris[i].v[1];
-        int c = tris[i].v[2];
-        edges.push_back(Voxel(std::min(a, b), std::max(a, b), i));
-        edges.push_back(Voxel(std::min(b, c), std::max(b, c), i));
-        edges.push_back(Voxel(std::min(c, a), std::max(c, a), i));
+        const MeshAdjacency::IndexRange neighbors = adjacency.getVertexNeighbors(a);
+        edgesOffsets[a + 1] = edgesOffsets[a] + int(neighbors.end() - std::upper_bound(neighbors.begin(), neighbors.end(), a));
     }
 
-    qsort(&edges[0], edges.size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
+    edgesNeighTris.resize(edgesOffsets.back());
+    edgesPointsPairs.resize(edgesOffsets.back());
 
-    edgesNeighTris.reserve(tris.size() * 3);
-    edgesPointsPairs.reserve(tris.size() * 3);
-    // remove duplicities
-    int i0 = 0;
-    long t1 = mvsUtils::initEstimate();
-    for (int i = 0; i < edges.size(); ++i)
+#pragma omp parallel for
+    for (int a = 0; a < pts.size(); ++a)
     {
-        if ((i == edges.size() - 1) || (edges[i].x != edges[i + 1].x))
-        {
-            StaticVector<Voxel> edges1;
-            edges1.reserve(i - i0 + 1);
-            edges1.getDataWritable().insert(edges1.begin(), edges.begin() + i0, edges.begin() + i + 1);
-            qsort(&edges1[0], edges1.size(), sizeof(Voxel), qSortCompareVoxelByYAsc);
+        const MeshAdjacency::IndexRange neighbors = adjacency.getVertexNeighbors(a);
+        int edgeIndex = edgesOffsets[a];
 
-            int j0 = 0;
-            for (int j = 0; j < edges1.size(); ++j)
-            {
-                if ((j == edges1.size() - 1) || (edges1[j].y != edges1[j + 1].y))
-                {
-                    edgesPointsPairs.push_back(Pixel(edges1[j].x, edges1[j].y));
-                    edgesNeighTris.resize(edgesNeighTris.size() + 1);
-                    StaticVector<int>& neighTris = edgesNeighTris.back();
-                    neighTris.reserve(j - j0 + 1);
-                    for (int k = j0; k <= j; ++k)
-                    {
-                        neighTris.push_back(edges1[k].z);
-                    }
-                    j0 = j + 1;
-                }
-            }
-            i0 = i + 1;
+        for (const int* it = std::upper_bound(neighbors.begin(), neighbors.end(), a); it != neighbors.end(); ++it, ++edgeIndex)
+        {
+            edgesPointsPairs[edgeIndex] = Pixel(a, *it);
+            StaticVector<int>& neighTris = edgesNeighTris[edgeIndex];
+            neighTris.reserve(adjacency.getNbEdgeTriangles(a, *it));
+            adjacency.forEachEdgeTriangle(a, *it, [&](int triIndex) { neighTris.push_back(triIndex); });
         }
-        mvsUtils::printfEstimate(i, edges.size(), t1);
     }
-    mvsUtils::finishEstimate();
 }
 
 void Mesh::getLaplacianSmoothingVectors(StaticVector<StaticVector<int>>& ptsNeighPts, StaticVector<Point3d>& out_nms, double maximalNeighDist)
@@ -1267,8 +1214,10 @@ void Mesh::getLaplacianSmoothingVectors(StaticVector<StaticVector<int>>& ptsNeig
 
 void Mesh::laplacianSmoothPts(float maximalNeighDist)
 {
+    // ordered one-ring neighbors: on boundary vertices the walk may stop before visiting all the adjacent vertices
+    const MeshAdjacency adjacency(*this);
     StaticVector<StaticVector<int>> ptsNei;
-    getPtsNeighPtsOrdered(ptsNei);
+    getPtsNeighPtsOrdered(adjacency, ptsNei);
     laplacianSmoothPts(ptsNei, maximalNeighDist);
 }
 
@@ -1310,9 +1259,43 @@ double Mesh::computeTriangleMinEdgeLength(int idTri) const
 
 void Mesh::computeNormalsForPts(StaticVector<Point3d>& out_nms) const
 {
-    StaticVector<StaticVector<int>> ptsNeighTris;
-    getPtsNeighborTriangles(ptsNeighTris);
-    computeNormalsForPts(ptsNeighTris, out_nms);
+    const MeshAdjacency adjacency(*this);
+    computeNormalsForPts(adjacency, out_nms);
+}
+
+void Mesh::computeNormalsForPts(const MeshAdjacency& adjacency, StaticVector<Point3d>& out_nms) const
+{
+    out_nms.reserve(pts.size());
+    out_nms.resize_with(pts.size(), Point3d(0.0f, 0.0f, 0.0f));
+
+#pragma omp parallel for
+    for (int i = 0; i < pts.size(); ++i)
+    {
+        const MeshAdjacency::IndexRange ptTris = adjacency.getVertexTriangles(i);
+        if (ptTris.empty())
+            continue;
+
+        Point3d n = Point3d(0.0f, 0.0f, 0.0f);
+        float nn = 0.0f;
+        for (const int triId : ptTris)
+        {
+            const Point3d n1 = computeTriangleNormal(triId);
+            if (!std::isnan(n1.x) && !std::isnan(n1.y) && !std::isnan(n1.z))  // check if is not NaN
+            {
+                n = n + n1;
+                nn += 1.0f;
+            }
+        }
+        n = n / nn;
+
+        n = n.normalize();
+        if (std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z))  // check if is not NaN
+        {
+            n = Point3d(0.0f, 0.0f, 0.0f);
+        }
+
+        out_nms[i] = n;
+    }
 }
 
 void Mesh::computeNormalsForPts(StaticVector<StaticVector<int>>& ptsNeighTris, StaticVector<Point3d>& out_nms) const
@@ -1718,9 +1701,7 @@ int Mesh::subdivideMesh(const Mesh& refMesh, float ratioSubdiv, bool remapVisibi
 
 int Mesh::subdivideMeshOnce(const Mesh& refMesh, const GEO::AdaptiveKdTree& refMesh_kdTree, float lengthRatio)
 {
-    StaticVector<StaticVector<int>> edgesNeighTris;
-    StaticVector<Pixel> edgesPointsPairs;
-    getNotOrientedEdges(edgesNeighTris, edgesPointsPairs);
+    const MeshAdjacency adjacency(*this);
 
     // for edge (A,B): <A, B, newPointId> with A,B in triangle local system (0, 1 or 2)
     // Edges to subdivise per triangle
@@ -1736,68 +1717,70 @@ int Mesh::subdivideMeshOnce(const Mesh& refMesh, const GEO::AdaptiveKdTree& refM
 
     int nEdgesToSubdivide = 0;
     // find which edges to subdivide
-    for (int i = 0; i < edgesPointsPairs.size(); ++i)
+    for (int idA = 0; idA < pts.size(); ++idA)
     {
-        int idA = edgesPointsPairs[i].x;
-        int idB = edgesPointsPairs[i].y;
-
-        double refLocalEdgeLength = 0;  // rough estimation of points distances around point A and B
+        for (const int idB : adjacency.getVertexNeighbors(idA))
         {
-            int j = 0;
-            GEO::index_t neighborsId[8];
-            double sqDist[8];
-            refMesh_kdTree.get_nearest_neighbors(4, pts[idA].m, neighborsId, sqDist);
-            refMesh_kdTree.get_nearest_neighbors(4, pts[idB].m, neighborsId + 4, sqDist + 4);
-            if (GEO::signed_index_t(neighborsId[0]) == -1 || GEO::signed_index_t(neighborsId[4]) == -1)
+            if (idB < idA)
                 continue;
 
-            for (int i = 1; i < 4; ++i)
+            double refLocalEdgeLength = 0;  // rough estimation of points distances around point A and B
             {
-                if (GEO::signed_index_t(neighborsId[i]) != -1)
+                int j = 0;
+                GEO::index_t neighborsId[8];
+                double sqDist[8];
+                refMesh_kdTree.get_nearest_neighbors(4, pts[idA].m, neighborsId, sqDist);
+                refMesh_kdTree.get_nearest_neighbors(4, pts[idB].m, neighborsId + 4, sqDist + 4);
+                if (GEO::signed_index_t(neighborsId[0]) == -1 || GEO::signed_index_t(neighborsId[4]) == -1)
+                    continue;
+
+                for (int i = 1; i < 4; ++i)
                 {
-                    refLocalEdgeLength += std::sqrt(sqDist[i]);
-                    ++j;
+                    if (GEO::signed_index_t(neighborsId[i]) != -1)
+                    {
+                        refLocalEdgeLength += std::sqrt(sqDist[i]);
+                        ++j;
+                    }
                 }
-            }
-            for (int i = 5; i < 8; ++i)
-            {
-                if (GEO::signed_index_t(neighborsId[i]) != -1)
+                for (int i = 5; i < 8; ++i)
                 {
-                    refLocalEdgeLength += std::sqrt(sqDist[i]);
-                    ++j;
+                    if (GEO::signed_index_t(neighborsId[i]) != -1)
+                    {
+                        refLocalEdgeLength += std::sqrt(sqDist[i]);
+                        ++j;
+                    }
                 }
+                refLocalEdgeLength /= j;
             }
-            refLocalEdgeLength /= j;
-        }
 
-        Point3d& pointA = pts[idA];
-        Point3d& pointB = pts[idB];
+            Point3d& pointA = pts[idA];
+            Point3d& pointB = pts[idB];
 
-        const double edgeLength = dist(pointA, pointB);
-        //        ALICEVISION_LOG_INFO("edge length: " << edgeLength);
-        //        ALICEVISION_LOG_INFO("refLocalEdgeLength: " << refLocalEdgeLength);
+            const double edgeLength = dist(pointA, pointB);
+            //        ALICEVISION_LOG_INFO("edge length: " << edgeLength);
+            //        ALICEVISION_LOG_INFO("refLocalEdgeLength: " << refLocalEdgeLength);
 
-        if (refLocalEdgeLength > 0 && edgeLength * lengthRatio > refLocalEdgeLength)
-        {
-            // add new point
-            Point3d newPoint = (pointA + pointB) * 0.5;
-            int newPointId = new_pts.size();
-            new_pts.push_back(newPoint);
-
-            // which triangles to subdivide (= edge neighbors triangles)
-            for (int triangleId : edgesNeighTris[i])
+            if (refLocalEdgeLength > 0 && edgeLength * lengthRatio > refLocalEdgeLength)
             {
-                const Mesh::triangle& triangle = tris[triangleId];
+                // add new point
+                Point3d newPoint = (pointA + pointB) * 0.5;
+                int newPointId = new_pts.size();
+                new_pts.push_back(newPoint);
+
+                // which triangles to subdivide (= edge neighbors triangles)
+                adjacency.forEachEdgeTriangle(idA, idB, [&](int triangleId) {
+                    const Mesh::triangle& triangle = tris[triangleId];
 
-                int localIdA = std::distance(triangle.v, std::find(triangle.v, triangle.v + 3, idA));
-                int localIdB = std::distance(triangle.v, std::find(triangle.v, triangle.v + 3, idB));
+                    int localIdA = std::distance(triangle.v, std::find(triangle.v, triangle.v + 3, idA));
+                    int localIdB = std::distance(triangle.v, std::find(triangle.v, triangle.v + 3, idB));
 
-                subdiv::edge newEdge(localIdA, localIdB, newPointId);
-                newEdge.orient();
+                    subdiv::edge newEdge(localIdA, localIdB, newPointId);
+                    newEdge.orient();
 
-                trianglesToSubdivide[triangleId].push_back(newEdge);
+                    trianglesToSubdivide[triangleId].push_back(newEdge);
+                });
+                ++nEdgesToSubdivide;
             }
-            ++nEdgesToSubdivide;
         }
     }
 
@@ -2275,8 +2258,7 @@ bool Mesh::isTriangleObtuse(int triId) const
 
 void Mesh::getLargestConnectedComponentTrisIds(StaticVector<int>& out) const
 {
-    StaticVector<StaticVector<int>> ptsNeighPtsOrdered;
-    getPtsNeighPtsOrdered(ptsNeighPtsOrdered);
+    const MeshAdjacency adjacency(*this);
 
     StaticVector<int> colors;
     colors.reserve(pts.size());
@@ -2311,9 +2293,8 @@ void Mesh::getLargestConnectedComponentTrisIds(StaticVector<int>& out) const
                     throw std::runtime_error("getLargestConnectedComponentTrisIds: bad condition.");
                 }
             }
-            for (int j = 0; j < sizeOfStaticVector<int>(ptsNeighPtsOrdered[ptid]); ++j)
+            for (const int nptid : adjacency.getVertexNeighbors(ptid))
             {
-                int nptid = ptsNeighPtsOrdered[ptid][j];
                 if ((nptid > -1) && (colors[nptid] == -1))
                 {
                     if (buff.size() >= buff.capacity())  // should not happen but no problem
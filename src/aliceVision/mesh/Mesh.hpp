@@ -23,6 +23,8 @@ class AdaptiveKdTree;
 namespace aliceVision {
 namespace mesh {
 
+class MeshAdjacency;
+
 using PointVisibility = StaticVector<int>;
 using PointsVisibility = StaticVector<PointVisibility>;
 
@@ -200,6 +202,7 @@ class Mesh
     void getPtsNeighbors(std::vector<std::vector<int>>& out_ptsNeighTris) const;
     void getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const;
     void getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighTris) const;
+    void getPtsNeighPtsOrdered(const MeshAdjacency& adjacency, StaticVector<StaticVector<int>>& out_ptsNeighPts) const;
 
     void getVisibleTrianglesIndexes(StaticVector<int>& out_visTri,
                                     const std::string& tmpDir,
@@ -238,6 +241,7 @@ class Mesh
     void laplacianSmoothPts(StaticVector<StaticVector<int>>& ptsNeighPts, double maximalNeighDist = -1.0f);
     void computeNormalsForPts(StaticVector<Point3d>& out_nms) const;
     void computeNormalsForPts(StaticVector<StaticVector<int>>& ptsNeighTris, StaticVector<Point3d>& out_nms) const;
+    void computeNormalsForPts(const MeshAdjacency& adjacency, StaticVector<Point3d>& out_nms) const;
     void smoothNormals(StaticVector<Point3d>& nms, StaticVector<StaticVector<int>>& ptsNeighPts);
     Point3d computeTriangleNormal(int idTri) const;
     Point3d computeTriangleCenterOfGravity(int idTri) const;
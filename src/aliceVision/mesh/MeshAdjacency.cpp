@@ -0,0 +1,170 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MeshAdjacency.hpp"
+
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace aliceVision {
+namespace mesh {
+
+namespace {
+
+struct VertexTriangle
+{
+    std::uint32_t vertex;
+    int triangle;
+};
+
+/**
+ * @brief Stable parallel LSD radix sort of the pairs by vertex index.
+ * @note Pairs are split into chunks with their own digit histograms,
+ *       each chunk is scattered after the chunks before it, so the sort is stable.
+ */
+void radixSortByVertex(std::vector<VertexTriangle>& pairs, std::uint32_t maxVertex)
+{
+    constexpr int digitBits = 11;
+    constexpr std::size_t nbBuckets = std::size_t(1) << digitBits;
+    constexpr std::uint32_t digitMask = std::uint32_t(nbBuckets - 1);
+
+    const int nbChunks = std::max(1, omp_get_max_threads());
+    const std::size_t nbPairs = pairs.size();
+    const auto chunkBegin = [&](int c) { return nbPairs * std::size_t(c) / std::size_t(nbChunks); };
+
+    std::vector<VertexTriangle> buffer(nbPairs);
+    std::vector<std::size_t> histograms(nbChunks * nbBuckets);
+
+    for (int shift = 0; shift < 32 && (maxVertex >> shift) != 0; shift += digitBits)
+    {
+        std::fill(histograms.begin(), histograms.end(), 0);
+
+#pragma omp parallel for schedule(static, 1)
+        for (int c = 0; c < nbChunks; ++c)
+        {
+            std::size_t* histogram = &histograms[c * nbBuckets];
+            for (std::size_t i = chunkBegin(c), iEnd = chunkBegin(c + 1); i < iEnd; ++i)
+                ++histogram[(pairs[i].vertex >> shift) & digitMask];
+        }
+
+        // output offsets: by digit, then by chunk
+        std::size_t offset = 0;
+        for (std::size_t b = 0; b < nbBuckets; ++b)
+        {
+            for (int c = 0; c < nbChunks; ++c)
+            {
+                const std::size_t count = histograms[c * nbBuckets + b];
+                histograms[c * nbBuckets + b] = offset;
+                offset += count;
+            }
+        }
+
+#pragma omp parallel for schedule(static, 1)
+        for (int c = 0; c < nbChunks; ++c)
+        {
+            std::size_t* histogram = &histograms[c * nbBuckets];
+            for (std::size_t i = chunkBegin(c), iEnd = chunkBegin(c + 1); i < iEnd; ++i)
+                buffer[histogram[(pairs[i].vertex >> shift) & digitMask]++] = pairs[i];
+        }
+
+        pairs.swap(buffer);
+    }
+}
+
+/// get the sorted neighbor vertices of a vertex from its triangles
+void getNeighbors(const Mesh& mesh, int vertexIndex, const MeshAdjacency::IndexRange& vertexTris, std::vector<int>& out_neighbors)
+{
+    out_neighbors.clear();
+    for (const int triIndex : vertexTris)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            const int v = mesh.tris[triIndex].v[k];
+            if (v != vertexIndex)
+                out_neighbors.push_back(v);
+        }
+    }
+    std::sort(out_neighbors.begin(), out_neighbors.end());
+    out_neighbors.erase(std::unique(out_neighbors.begin(), out_neighbors.end()), out_neighbors.end());
+}
+
+}  // namespace
+
+void MeshAdjacency::build(const Mesh& mesh)
+{
+    const int nbVertices = mesh.pts.size();
+    const int nbTris = mesh.tris.size();
+
+    // vertex to triangles, grouped by vertex
+    // note: triangles are added by ascending index and the sort is stable, so each vertex triangles are sorted
+    {
+        std::vector<VertexTriangle> pairs(std::size_t(nbTris) * 3);
+
+#pragma omp parallel for
+        for (int i = 0; i < nbTris; ++i)
+        {
+            for (int k = 0; k < 3; ++k)
+                pairs[std::size_t(i) * 3 + k] = {std::uint32_t(mesh.tris[i].v[k]), i};
+        }
+
+        radixSortByVertex(pairs, nbVertices > 0 ? std::uint32_t(nbVertices - 1) : 0);
+
+        _vertexTris.resize(pairs.size());
+        _vertexTrisOffsets.assign(nbVertices + 1, int(pairs.size()));
+
+#pragma omp parallel for
+        for (int i = 0; i < int(pairs.size()); ++i)
+        {
+            _vertexTris[i] = pairs[i].triangle;
+
+            // first triangle of a vertex: set the offsets of this vertex and of the previous vertices without triangles
+            const int previousVertex = (i == 0) ? -1 : int(pairs[i - 1].vertex);
+            for (int v = previousVertex + 1; v <= int(pairs[i].vertex); ++v)
+                _vertexTrisOffsets[v] = i;
+        }
+    }
+
+    // vertex to vertices
+    _vertexNeighborsOffsets.assign(nbVertices + 1, 0);
+
+#pragma omp parallel
+    {
+        std::vector<int> neighbors;
+
+#pragma omp for
+        for (int v = 0; v < nbVertices; ++v)
+        {
+            getNeighbors(mesh, v, getVertexTriangles(v), neighbors);
+            _vertexNeighborsOffsets[v + 1] = int(neighbors.size());
+        }
+    }
+
+    std::partial_sum(_vertexNeighborsOffsets.begin(), _vertexNeighborsOffsets.end(), _vertexNeighborsOffsets.begin());
+    _vertexNeighbors.resize(_vertexNeighborsOffsets.back());
+
+#pragma omp parallel
+    {
+        std::vector<int> neighbors;
+
+#pragma omp for
+        for (int v = 0; v < nbVertices; ++v)
+        {
+            getNeighbors(mesh, v, getVertexTriangles(v), neighbors);
+            std::copy(neighbors.begin(), neighbors.end(), _vertexNeighbors.begin() + _vertexNeighborsOffsets[v]);
+        }
+    }
+}
+
+std::size_t MeshAdjacency::getMemoryConsumption() const
+{
+    return (_vertexTrisOffsets.capacity() + _vertexTris.capacity() + _vertexNeighborsOffsets.capacity() + _vertexNeighbors.capacity()) * sizeof(int);
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
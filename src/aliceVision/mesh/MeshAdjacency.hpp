@@ -0,0 +1,130 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mesh/Mesh.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+/**
+ * @class Mesh adjacency
+ * @brief Compressed (CSR) vertex to triangles and vertex to vertices adjacency of a mesh.
+ * @note All neighborhoods are stored in two flat arrays (offsets and indices),
+ *       so the build does not allocate per vertex.
+ *       The adjacency is built in parallel, vertex to triangles pairs are grouped with a radix sort.
+ *       It is a snapshot of the mesh topology: it should be rebuilt if the triangles are modified.
+ */
+class MeshAdjacency
+{
+  public:
+    /// contiguous range of indexes in a CSR array
+    class IndexRange
+    {
+      public:
+        IndexRange(const int* first, const int* last)
+          : _first(first),
+            _last(last)
+        {}
+
+        inline const int* begin() const { return _first; }
+        inline const int* end() const { return _last; }
+        inline int size() const { return int(_last - _first); }
+        inline bool empty() const { return _first == _last; }
+        inline int operator[](int i) const { return _first[i]; }
+
+      private:
+        const int* _first;
+        const int* _last;
+    };
+
+    MeshAdjacency() = default;
+
+    /**
+     * @brief MeshAdjacency constructor, build the adjacency of the given mesh.
+     * @param[in] mesh the input mesh
+     */
+    explicit MeshAdjacency(const Mesh& mesh) { build(mesh); }
+
+    /**
+     * @brief Build the adjacency of the given mesh.
+     * @param[in] mesh the input mesh
+     */
+    void build(const Mesh& mesh);
+
+    /// get the number of vertices
+    inline int getNbVertices() const { return _vertexTrisOffsets.empty() ? 0 : int(_vertexTrisOffsets.size()) - 1; }
+
+    /// get the triangles of the given vertex, sorted by ascending index
+    inline IndexRange getVertexTriangles(int vertexIndex) const
+    {
+        return IndexRange(_vertexTris.data() + _vertexTrisOffsets[vertexIndex], _vertexTris.data() + _vertexTrisOffsets[vertexIndex + 1]);
+    }
+
+    /// get the neighbor vertices of the given vertex (vertices sharing an edge), sorted by ascending index
+    inline IndexRange getVertexNeighbors(int vertexIndex) const
+    {
+        return IndexRange(_vertexNeighbors.data() + _vertexNeighborsOffsets[vertexIndex],
+                          _vertexNeighbors.data() + _vertexNeighborsOffsets[vertexIndex + 1]);
+    }
+
+    /// get the number of edges
+    inline std::size_t getNbEdges() const { return _vertexNeighbors.size() / 2; }
+
+    /**
+     * @brief Call the given function for each triangle of the edge (a, b), by ascending index.
+     * @param[in] a the edge first vertex
+     * @param[in] b the edge second vertex
+     * @param[in] f the function: void(int triangleIndex)
+     */
+    template<typename Function>
+    void forEachEdgeTriangle(int a, int b, Function f) const
+    {
+        // intersection of the sorted vertices triangles
+        const IndexRange trisA = getVertexTriangles(a);
+        const IndexRange trisB = getVertexTriangles(b);
+        const int* itA = trisA.begin();
+        const int* itB = trisB.begin();
+
+        while (itA != trisA.end() && itB != trisB.end())
+        {
+            if (*itA < *itB)
+                ++itA;
+            else if (*itB < *itA)
+                ++itB;
+            else
+            {
+                f(*itA);
+                ++itA;
+                ++itB;
+            }
+        }
+    }
+
+    /// get the number of triangles of the edge (a, b)
+    inline int getNbEdgeTriangles(int a, int b) const
+    {
+        int nbTris = 0;
+        forEachEdgeTriangle(a, b, [&](int) { ++nbTris; });
+        return nbTris;
+    }
+
+    /// get the memory consumption in bytes
+    std::size_t getMemoryConsumption() const;
+
+  private:
+    std::vector<int> _vertexTrisOffsets;       //< vertex first index in _vertexTris
+    std::vector<int> _vertexTris;              //< vertices triangles
+    std::vector<int> _vertexNeighborsOffsets;  //< vertex first index in _vertexNeighbors
+    std::vector<int> _vertexNeighbors;         //< vertices neighbor vertices
+};
+
+}  // namespace mesh
+}  // namespace aliceVision
@@ -0,0 +1,117 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mesh/MeshAdjacency.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+#include <vector>
+
+#define BOOST_TEST_MODULE meshAdjacency
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace {
+
+/**
+ * @brief Create a grid mesh of gridSize x gridSize vertices.
+ * @param[in] gridSize the number of vertices per side
+ * @param[in] closed wrap the grid on a torus (no boundary), otherwise a plane
+ */
+Mesh createGridMesh(int gridSize, bool closed)
+{
+    Mesh mesh;
+    for (int j = 0; j < gridSize; ++j)
+    {
+        for (int i = 0; i < gridSize; ++i)
+        {
+            if (closed)
+            {
+                const double u = 2.0 * M_PI * i / gridSize;
+                const double v = 2.0 * M_PI * j / gridSize;
+                mesh.pts.push_back(Point3d((3.0 + std::cos(v)) * std::cos(u), (3.0 + std::cos(v)) * std::sin(u), std::sin(v)));
+            }
+            else
+            {
+                mesh.pts.push_back(Point3d(i, j, 0.0));
+            }
+        }
+    }
+
+    const int nbCells = closed ? gridSize : gridSize - 1;
+    const auto vertex = [gridSize](int i, int j) { return (j % gridSize) * gridSize + (i % gridSize); };
+    for (int j = 0; j < nbCells; ++j)
+    {
+        for (int i = 0; i < nbCells; ++i)
+        {
+            mesh.tris.push_back(Mesh::triangle(vertex(i, j), vertex(i + 1, j), vertex(i + 1, j + 1)));
+            mesh.tris.push_back(Mesh::triangle(vertex(i, j), vertex(i + 1, j + 1), vertex(i, j + 1)));
+        }
+    }
+    return mesh;
+}
+
+/// check the adjacency against the triangles and the ordered one-ring neighbors of the mesh
+void checkAdjacency(const Mesh& mesh)
+{
+    const MeshAdjacency adjacency(mesh);
+    BOOST_REQUIRE_EQUAL(adjacency.getNbVertices(), mesh.pts.size());
+
+    // brute force adjacency
+    std::vector<std::vector<int>> vertexTriangles(mesh.pts.size());
+    std::vector<std::set<int>> vertexNeighbors(mesh.pts.size());
+    std::map<std::pair<int, int>, int> edgesNbTriangles;
+    for (int t = 0; t < mesh.tris.size(); ++t)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            const int a = mesh.tris[t].v[k];
+            const int b = mesh.tris[t].v[(k + 1) % 3];
+            vertexTriangles[a].push_back(t);
+            vertexNeighbors[a].insert(b);
+            vertexNeighbors[b].insert(a);
+            ++edgesNbTriangles[std::make_pair(std::min(a, b), std::max(a, b))];
+        }
+    }
+
+    BOOST_CHECK_EQUAL(adjacency.getNbEdges(), edgesNbTriangles.size());
+    for (const auto& edgeNbTriangles : edgesNbTriangles)
+        BOOST_CHECK_EQUAL(adjacency.getNbEdgeTriangles(edgeNbTriangles.first.first, edgeNbTriangles.first.second), edgeNbTriangles.second);
+
+    StaticVector<StaticVector<int>> ptsNeighPtsOrdered;
+    mesh.getPtsNeighPtsOrdered(ptsNeighPtsOrdered);
+
+    for (int v = 0; v < mesh.pts.size(); ++v)
+    {
+        const MeshAdjacency::IndexRange triangles = adjacency.getVertexTriangles(v);
+        BOOST_CHECK(std::vector<int>(triangles.begin(), triangles.end()) == vertexTriangles[v]);
+
+        const MeshAdjacency::IndexRange neighbors = adjacency.getVertexNeighbors(v);
+        BOOST_CHECK(std::vector<int>(neighbors.begin(), neighbors.end()) == std::vector<int>(vertexNeighbors[v].begin(), vertexNeighbors[v].end()));
+
+        // the ordered walk may start from the vertex itself, and stops at the first boundary edge
+        std::set<int> orderedNeighbors(ptsNeighPtsOrdered[v].begin(), ptsNeighPtsOrdered[v].end());
+        orderedNeighbors.erase(v);
+
+        const bool isBoundary = std::any_of(neighbors.begin(), neighbors.end(), [&](int n) { return adjacency.getNbEdgeTriangles(v, n) == 1; });
+        if (isBoundary)
+            BOOST_CHECK(std::includes(vertexNeighbors[v].begin(), vertexNeighbors[v].end(), orderedNeighbors.begin(), orderedNeighbors.end()));
+        else
+            BOOST_CHECK(orderedNeighbors == vertexNeighbors[v]);
+    }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(meshAdjacency_closedMesh) { checkAdjacency(createGridMesh(20, true)); }
+
+BOOST_AUTO_TEST_CASE(meshAdjacency_openMesh) { checkAdjacency(createGridMesh(20, false)); }
@@ -0,0 +1,465 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MeshBVH.hpp"
+
+#include <aliceVision/config.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+    #include <xmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace aliceVision {
+namespace mesh {
+
+namespace {
+
+constexpr int maxLeafSize = 4;
+constexpr int maxStackSize = 64;
+
+/// unit roundoff of single precision
+constexpr float floatRoundoff = std::numeric_limits<float>::epsilon() * 0.5f;
+
+/**
+ * @brief Bound on the relative error of the single precision intersection test, in unit roundoff.
+ * @note The forward error analysis of the inputs rounding and of the cross and dot products
+ *       gives less than 16 unit roundoffs per term, the bound keeps a margin of 2.
+ */
+constexpr float errorFactor = 32.0f * floatRoundoff;
+
+/// round a coordinate to single precision, towards the given direction
+inline float roundToFloat(double value, float direction)
+{
+    const float f = static_cast<float>(value);
+    return std::nextafter(f, direction);
+}
+
+/**
+ * @brief Conservative intersection test of a ray with a packet of 4 triangles in single precision
+ *        (Moller-Trumbore, without back-face culling).
+ * @note The barycentric coordinates and distance tolerances are a bound of the rounding errors of each lane,
+ *       which grows with the distance of the ray origin and the triangle to the packets origin
+ *       and with the inverse of the triangle size. A triangle is a candidate if the double precision test
+ *       may succeed; triangles with an uncertain determinant sign are always candidates.
+ *       Empty lanes have null edges, so they are never intersected.
+ * @param[in] oNorm the L1 norm of the ray origin o (relative to the packets origin)
+ * @param[in] dNorm the L1 norm of the ray direction d
+ * @return the bitmask of the candidate triangles
+ */
+inline int intersectPacket(const float v0[3][4],
+                           const float e1[3][4],
+                           const float e2[3][4],
+                           const float o[3],
+                           const float d[3],
+                           float oNorm,
+                           float dNorm,
+                           float minDist,
+                           float maxDist)
+{
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const auto abs = [&](__m128 x) { return _mm_andnot_ps(signMask, x); };
+    const auto norm = [&](__m128 x, __m128 y, __m128 z) { return _mm_add_ps(_mm_add_ps(abs(x), abs(y)), abs(z)); };
+
+    const __m128 dx = _mm_set1_ps(d[0]);
+    const __m128 dy = _mm_set1_ps(d[1]);
+    const __m128 dz = _mm_set1_ps(d[2]);
+    const __m128 e1x = _mm_load_ps(e1[0]);
+    const __m128 e1y = _mm_load_ps(e1[1]);
+    const __m128 e1z = _mm_load_ps(e1[2]);
+    const __m128 e2x = _mm_load_ps(e2[0]);
+    const __m128 e2y = _mm_load_ps(e2[1]);
+    const __m128 e2z = _mm_load_ps(e2[2]);
+    const __m128 v0x = _mm_load_ps(v0[0]);
+    const __m128 v0y = _mm_load_ps(v0[1]);
+    const __m128 v0z = _mm_load_ps(v0[2]);
+
+    // pvec = d x e2
+    const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+    const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+    const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+    // tvec = o - v0
+    const __m128 tx = _mm_sub_ps(_mm_set1_ps(o[0]), v0x);
+    const __m128 ty = _mm_sub_ps(_mm_set1_ps(o[1]), v0y);
+    const __m128 tz = _mm_sub_ps(_mm_set1_ps(o[2]), v0z);
+
+    const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), invDet);
+
+    // qvec = tvec x e1
+    const __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+    const __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+    const __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+
+    const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+    const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+    // error bounds
+    const __m128 k = _mm_set1_ps(errorFactor);
+    const __m128 dNorm4 = _mm_set1_ps(dNorm);
+    const __m128 e1Norm = norm(e1x, e1y, e1z);
+    const __m128 e2Norm = norm(e2x, e2y, e2z);
+    const __m128 tErr = _mm_mul_ps(k, _mm_add_ps(_mm_add_ps(_mm_set1_ps(oNorm), norm(v0x, v0y, v0z)), norm(tx, ty, tz)));
+
+    const __m128 detErr = _mm_mul_ps(_mm_mul_ps(k, e1Norm), _mm_mul_ps(dNorm4, e2Norm));
+    const __m128 absDet = abs(det);
+    const __m128 invDetLow = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sub_ps(absDet, detErr));
+
+    const __m128 uErr = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(tErr, _mm_mul_ps(dNorm4, e2Norm)), _mm_mul_ps(abs(u), detErr)), invDetLow);
+    const __m128 vErr = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(tErr, _mm_mul_ps(e1Norm, dNorm4)), _mm_mul_ps(abs(v), detErr)), invDetLow);
+    const __m128 distErr = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(tErr, _mm_mul_ps(e1Norm, e2Norm)), _mm_mul_ps(abs(t), detErr)), invDetLow);
+
+    // note: comparisons with NaN are false
+    __m128 mask = _mm_cmpgt_ps(absDet, detErr);
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(u, _mm_sub_ps(_mm_setzero_ps(), uErr)));
+    mask = _mm_and_ps(mask, _mm_cmpge_ps(v, _mm_sub_ps(_mm_setzero_ps(), vErr)));
+    mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), _mm_add_ps(_mm_set1_ps(1.0f), _mm_add_ps(uErr, vErr))));
+    mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, _mm_sub_ps(_mm_set1_ps(minDist), distErr)));
+    mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_add_ps(_mm_set1_ps(maxDist), distErr)));
+
+    // uncertain determinant sign (the ray may be parallel to the triangle)
+    mask = _mm_or_ps(mask, _mm_cmpgt_ps(detErr, absDet));
+
+    return _mm_movemask_ps(mask);
+#else
+    int mask = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        const float px = d[1] * e2[2][i] - d[2] * e2[1][i];
+        const float py = d[2] * e2[0][i] - d[0] * e2[2][i];
+        const float pz = d[0] * e2[1][i] - d[1] * e2[0][i];
+
+        const float det = e1[0][i] * px + e1[1][i] * py + e1[2][i] * pz;
+
+        const float tx = o[0] - v0[0][i];
+        const float ty = o[1] - v0[1][i];
+        const float tz = o[2] - v0[2][i];
+
+        // error bounds
+        const float e1Norm = std::abs(e1[0][i]) + std::abs(e1[1][i]) + std::abs(e1[2][i]);
+        const float e2Norm = std::abs(e2[0][i]) + std::abs(e2[1][i]) + std::abs(e2[2][i]);
+        const float v0Norm = std::abs(v0[0][i]) + std::abs(v0[1][i]) + std::abs(v0[2][i]);
+        const float tErr = errorFactor * (oNorm + v0Norm + std::abs(tx) + std::abs(ty) + std::abs(tz));
+        const float detErr = errorFactor * e1Norm * dNorm * e2Norm;
+        const float absDet = std::abs(det);
+
+        // uncertain determinant sign (the ray may be parallel to the triangle)
+        if (detErr > absDet)
+        {
+            mask |= (1 << i);
+            continue;
+        }
+        if (!(absDet > detErr))
+            continue;
+
+        const float invDet = 1.0f / det;
+        const float invDetLow = 1.0f / (absDet - detErr);
+
+        const float u = (tx * px + ty * py + tz * pz) * invDet;
+
+        const float qx = ty * e1[2][i] - tz * e1[1][i];
+        const float qy = tz * e1[0][i] - tx * e1[2][i];
+        const float qz = tx * e1[1][i] - ty * e1[0][i];
+
+        const float v = (d[0] * qx + d[1] * qy + d[2] * qz) * invDet;
+        const float t = (e2[0][i] * qx + e2[1][i] * qy + e2[2][i] * qz) * invDet;
+
+        const float uErr = (tErr * dNorm * e2Norm + std::abs(u) * detErr) * invDetLow;
+        const float vErr = (tErr * e1Norm * dNorm + std::abs(v) * detErr) * invDetLow;
+        const float distErr = (tErr * e1Norm * e2Norm + std::abs(t) * detErr) * invDetLow;
+
+        if (u >= -uErr && v >= -vErr && u + v <= 1.0f + uErr + vErr && t > minDist - distErr && t < maxDist + distErr)
+            mask |= (1 << i);
+    }
+    return mask;
+#endif
+}
+
+}  // namespace
+
+void MeshBVH::build(const Mesh& mesh)
+{
+    _mesh = &mesh;
+    _nodes.clear();
+    _packets.clear();
+
+    const int nbTris = mesh.tris.size();
+
+    if (nbTris == 0)
+        return;
+
+    // mesh bounding box
+    Point3d bbMin(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    Point3d bbMax(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+
+    for (int i = 0; i < mesh.pts.size(); ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            bbMin.m[k] = std::min(bbMin.m[k], mesh.pts[i].m[k]);
+            bbMax.m[k] = std::max(bbMax.m[k], mesh.pts[i].m[k]);
+        }
+    }
+
+    _center = (bbMin + bbMax) * 0.5;
+
+    std::vector<Point3d> centroids(nbTris);
+
+#pragma omp parallel for
+    for (int i = 0; i < nbTris; ++i)
+    {
+        const Mesh::triangle& t = mesh.tris[i];
+        centroids[i] = (mesh.pts[t.v[0]] + mesh.pts[t.v[1]] + mesh.pts[t.v[2]]) / 3.0;
+    }
+
+    std::vector<int> triangles(nbTris);
+    std::iota(triangles.begin(), triangles.end(), 0);
+
+    const int nbLeavesMax = 2 * ((nbTris + maxLeafSize - 1) / maxLeafSize);
+    _nodes.reserve(2 * nbLeavesMax);
+    _packets.reserve(nbLeavesMax);
+
+    buildNode(triangles, centroids, 0, nbTris);
+
+    ALICEVISION_LOG_DEBUG("MeshBVH: " << nbTris << " triangles, " << _nodes.size() << " nodes, " << _packets.size() << " leaves ("
+                                      << getMemoryConsumption() / (1024 * 1024) << " MB).");
+}
+
+int MeshBVH::buildNode(std::vector<int>& triangles, const std::vector<Point3d>& centroids, int begin, int end)
+{
+    const int nodeIndex = _nodes.size();
+    _nodes.emplace_back();
+
+    const Mesh& mesh = *_mesh;
+
+    // node bounding box and triangles centroids bounding box
+    Point3d bbMin(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    Point3d bbMax(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+    Point3d centroidsMin = bbMin;
+    Point3d centroidsMax = bbMax;
+
+    for (int i = begin; i < end; ++i)
+    {
+        const Mesh::triangle& t = mesh.tris[triangles[i]];
+        for (int k = 0; k < 3; ++k)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                bbMin.m[k] = std::min(bbMin.m[k], mesh.pts[t.v[j]].m[k]);
+                bbMax.m[k] = std::max(bbMax.m[k], mesh.pts[t.v[j]].m[k]);
+            }
+            centroidsMin.m[k] = std::min(centroidsMin.m[k], centroids[triangles[i]].m[k]);
+            centroidsMax.m[k] = std::max(centroidsMax.m[k], centroids[triangles[i]].m[k]);
+        }
+    }
+
+    Node node;
+    for (int k = 0; k < 3; ++k)
+    {
+        // round outwards: the single precision box contains the triangles
+        node.bbMin[k] = roundToFloat(bbMin.m[k], -std::numeric_limits<float>::infinity());
+        node.bbMax[k] = roundToFloat(bbMax.m[k], std::numeric_limits<float>::infinity());
+    }
+
+    if (end - begin <= maxLeafSize)
+    {
+        node.index = _packets.size();
+        node.nbTriangles = end - begin;
+        node.axis = 0;
+
+        TrianglePacket packet{};
+        for (int lane = 0; lane < maxLeafSize; ++lane)
+        {
+            packet.triangles[lane] = -1;
+            if (begin + lane >= end)
+                continue;
+
+            const int triangleIndex = triangles[begin + lane];
+            const Mesh::triangle& t = mesh.tris[triangleIndex];
+            const Point3d v0 = mesh.pts[t.v[0]] - _center;
+            const Point3d e1 = mesh.pts[t.v[1]] - mesh.pts[t.v[0]];
+            const Point3d e2 = mesh.pts[t.v[2]] - mesh.pts[t.v[0]];
+
+            for (int k = 0; k < 3; ++k)
+            {
+                packet.v0[k][lane] = static_cast<float>(v0.m[k]);
+                packet.e1[k][lane] = static_cast<float>(e1.m[k]);
+                packet.e2[k][lane] = static_cast<float>(e2.m[k]);
+            }
+            packet.triangles[lane] = triangleIndex;
+        }
+        _packets.push_back(packet);
+        _nodes[nodeIndex] = node;
+        return nodeIndex;
+    }
+
+    // split at the median centroid along the largest centroids extent
+    int axis = 0;
+    for (int k = 1; k < 3; ++k)
+    {
+        if (centroidsMax.m[k] - centroidsMin.m[k] > centroidsMax.m[axis] - centroidsMin.m[axis])
+            axis = k;
+    }
+
+    const int middle = begin + (end - begin) / 2;
+    std::nth_element(triangles.begin() + begin, triangles.begin() + middle, triangles.begin() + end, [&](int a, int b) {
+        return centroids[a].m[axis] < centroids[b].m[axis];
+    });
+
+    node.nbTriangles = 0;
+    node.axis = axis;
+
+    // first child is the next node
+    buildNode(triangles, centroids, begin, middle);
+    node.index = buildNode(triangles, centroids, middle, end);
+
+    _nodes[nodeIndex] = node;
+    return nodeIndex;
+}
+
+bool MeshBVH::intersectTriangle(int triangleIndex, const Point3d& origin, const Point3d& direction, double maxDist, double& out_dist) const
+{
+    const Mesh::triangle& t = _mesh->tris[triangleIndex];
+    const Point3d& p0 = _mesh->pts[t.v[0]];
+    const Point3d e1 = _mesh->pts[t.v[1]] - p0;
+    const Point3d e2 = _mesh->pts[t.v[2]] - p0;
+
+    const Point3d pvec = cross(direction, e2);
+    const double det = dot(e1, pvec);
+    if (det == 0.0)
+        return false;
+    const double invDet = 1.0 / det;
+
+    const Point3d tvec = origin - p0;
+    const double u = dot(tvec, pvec) * invDet;
+    if (u < 0.0 || u > 1.0)
+        return false;
+
+    const Point3d qvec = cross(tvec, e1);
+    const double v = dot(direction, qvec) * invDet;
+    if (v < 0.0 || u + v > 1.0)
+        return false;
+
+    const double dist = dot(e2, qvec) * invDet;
+    if (!(dist > 0.0 && dist < maxDist))
+        return false;
+
+    out_dist = dist;
+    return true;
+}
+
+template<bool anyHit>
+bool MeshBVH::traverse(const Point3d& origin, const Point3d& direction, double maxDist, int& out_triangleIndex, double& out_dist) const
+{
+    const double directionLength = direction.size();
+
+    if (_nodes.empty() || directionLength == 0.0)
+        return false;
+
+    // ray in the packets frame, in single precision
+    const Point3d localOrigin = origin - _center;
+    const float o[3] = {static_cast<float>(localOrigin.x), static_cast<float>(localOrigin.y), static_cast<float>(localOrigin.z)};
+    const float d[3] = {static_cast<float>(direction.x), static_cast<float>(direction.y), static_cast<float>(direction.z)};
+    const float oNorm = std::abs(o[0]) + std::abs(o[1]) + std::abs(o[2]);
+    const float dNorm = std::abs(d[0]) + std::abs(d[1]) + std::abs(d[2]);
+
+    // note: null direction components give infinite values, NaN values are ignored by the min/max below
+    const Point3d invDirection(1.0 / direction.x, 1.0 / direction.y, 1.0 / direction.z);
+
+    int stack[maxStackSize];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    bool hit = false;
+    double closestDist = maxDist;
+
+    while (stackSize > 0)
+    {
+        const int nodeIndex = stack[--stackSize];
+        const Node& node = _nodes[nodeIndex];
+
+        // slab test
+        double tNear = 0.0;
+        double tFar = closestDist;
+        for (int k = 0; k < 3; ++k)
+        {
+            double t0 = (node.bbMin[k] - origin.m[k]) * invDirection.m[k];
+            double t1 = (node.bbMax[k] - origin.m[k]) * invDirection.m[k];
+            if (t0 > t1)
+                std::swap(t0, t1);
+            tNear = std::max(tNear, t0);
+            tFar = std::min(tFar, t1);
+        }
+        if (tNear > tFar)
+            continue;
+
+        if (node.nbTriangles > 0)
+        {
+            const TrianglePacket& packet = _packets[node.index];
+            // note: the distance is clamped as the conversion of an out of range double (e.g. an unbounded ray) is undefined
+            const float maxDistFloat = static_cast<float>(std::min(closestDist, static_cast<double>(std::numeric_limits<float>::max())));
+            const int mask = intersectPacket(packet.v0, packet.e1, packet.e2, o, d, oNorm, dNorm, 0.0f, maxDistFloat);
+
+            for (int lane = 0; lane < node.nbTriangles; ++lane)
+            {
+                if (!(mask & (1 << lane)))
+                    continue;
+
+                double dist;
+                if (intersectTriangle(packet.triangles[lane], origin, direction, closestDist, dist))
+                {
+                    hit = true;
+                    out_triangleIndex = packet.triangles[lane];
+                    out_dist = dist;
+                    closestDist = dist;
+
+                    if (anyHit)
+                        return true;
+                }
+            }
+            continue;
+        }
+
+        // visit the nearest child first
+        if (direction.m[node.axis] < 0.0)
+        {
+            stack[stackSize++] = nodeIndex + 1;
+            stack[stackSize++] = node.index;
+        }
+        else
+        {
+            stack[stackSize++] = node.index;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+    return hit;
+}
+
+bool MeshBVH::intersect(const Point3d& origin, const Point3d& direction, double maxDist, int& out_triangleIndex, double& out_dist) const
+{
+    return traverse<false>(origin, direction, maxDist, out_triangleIndex, out_dist);
+}
+
+bool MeshBVH::isOccluded(const Point3d& origin, const Point3d& direction, double maxDist) const
+{
+    int triangleIndex;
+    double dist;
+    return traverse<true>(origin, direction, maxDist, triangleIndex, dist);
+}
+
+std::size_t MeshBVH::getMemoryConsumption() const { return _nodes.capacity() * sizeof(Node) + _packets.capacity() * sizeof(TrianglePacket); }
+
+}  // namespace mesh
+}  // namespace aliceVision
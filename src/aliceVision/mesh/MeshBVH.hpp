@@ -0,0 +1,107 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mvsData/Point3d.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+/**
+ * @class Mesh BVH
+ * @brief Bounding volume hierarchy of the mesh triangles for ray casting.
+ * @note Leaves store up to 4 triangles in a packet (structure of arrays in single precision),
+ *       which are tested at once (with SSE if available) with a bound of the single precision rounding errors.
+ *       Candidate hits are confirmed in double precision, so the result is the same as a double precision test
+ *       of all the triangles.
+ *       The BVH is read-only once built: it can be shared between cameras and queried in parallel.
+ *       It keeps a reference to the mesh, which should not be modified or destroyed while the BVH is used.
+ */
+class MeshBVH
+{
+  public:
+    MeshBVH() = default;
+
+    /**
+     * @brief MeshBVH constructor, build the BVH of the given mesh.
+     * @param[in] mesh the input mesh
+     */
+    explicit MeshBVH(const Mesh& mesh) { build(mesh); }
+
+    /**
+     * @brief Build the BVH of the given mesh.
+     * @param[in] mesh the input mesh
+     */
+    void build(const Mesh& mesh);
+
+    /// get the number of nodes
+    inline std::size_t getNbNodes() const { return _nodes.size(); }
+
+    /**
+     * @brief Find the closest triangle intersected by the ray.
+     * @param[in] origin the ray origin
+     * @param[in] direction the ray direction (distances are expressed in direction length units)
+     * @param[in] maxDist the maximum distance
+     * @param[out] out_triangleIndex the intersected triangle index
+     * @param[out] out_dist the distance to the intersection
+     * @return true if a triangle is intersected in ]0, maxDist[
+     */
+    bool intersect(const Point3d& origin, const Point3d& direction, double maxDist, int& out_triangleIndex, double& out_dist) const;
+
+    /**
+     * @brief Check if the ray intersects any triangle.
+     * @param[in] origin the ray origin
+     * @param[in] direction the ray direction (distances are expressed in direction length units)
+     * @param[in] maxDist the maximum distance
+     * @return true if a triangle is intersected in ]0, maxDist[
+     */
+    bool isOccluded(const Point3d& origin, const Point3d& direction, double maxDist) const;
+
+    /// get the memory consumption in bytes
+    std::size_t getMemoryConsumption() const;
+
+  private:
+    struct Node
+    {
+        float bbMin[3];
+        float bbMax[3];
+        int index;                   //< leaf: packet index, inner node: second child index (first child is the next node)
+        std::uint16_t nbTriangles;   //< 0 for inner nodes
+        std::uint16_t axis;          //< split axis of inner nodes
+    };
+
+    struct alignas(16) TrianglePacket
+    {
+        float v0[3][4];  //< first vertex of each triangle
+        float e1[3][4];  //< first edge (v1 - v0) of each triangle
+        float e2[3][4];  //< second edge (v2 - v0) of each triangle
+        int triangles[4];
+    };
+
+    int buildNode(std::vector<int>& triangles, const std::vector<Point3d>& centroids, int begin, int end);
+
+    /// traverse the BVH, stop at the first hit if anyHit
+    template<bool anyHit>
+    bool traverse(const Point3d& origin, const Point3d& direction, double maxDist, int& out_triangleIndex, double& out_dist) const;
+
+    /// exact intersection test of a triangle (double precision)
+    bool intersectTriangle(int triangleIndex, const Point3d& origin, const Point3d& direction, double maxDist, double& out_dist) const;
+
+    const Mesh* _mesh = nullptr;
+    Point3d _center;        //< packets coordinates origin (mesh bounding box center)
+    std::vector<Node> _nodes;
+    std::vector<TrianglePacket> _packets;
+};
+
+}  // namespace mesh
+}  // namespace aliceVision
@@ -0,0 +1,234 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mesh/MeshBVH.hpp>
+
+#include <limits>
+#include <random>
+
+#define BOOST_TEST_MODULE meshBVH
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace {
+
+/// double precision intersection of a ray with a triangle (same test as the BVH candidates confirmation)
+bool intersectTriangle(const Mesh& mesh, int triangleIndex, const Point3d& origin, const Point3d& direction, double maxDist, double& out_dist)
+{
+    const Mesh::triangle& t = mesh.tris[triangleIndex];
+    const Point3d& p0 = mesh.pts[t.v[0]];
+    const Point3d e1 = mesh.pts[t.v[1]] - p0;
+    const Point3d e2 = mesh.pts[t.v[2]] - p0;
+
+    const Point3d pvec = cross(direction, e2);
+    const double det = dot(e1, pvec);
+    if (det == 0.0)
+        return false;
+    const double invDet = 1.0 / det;
+
+    const Point3d tvec = origin - p0;
+    const double u = dot(tvec, pvec) * invDet;
+    if (u < 0.0 || u > 1.0)
+        return false;
+
+    const Point3d qvec = cross(tvec, e1);
+    const double v = dot(direction, qvec) * invDet;
+    if (v < 0.0 || u + v > 1.0)
+        return false;
+
+    const double dist = dot(e2, qvec) * invDet;
+    if (!(dist > 0.0 && dist < maxDist))
+        return false;
+
+    out_dist = dist;
+    return true;
+}
+
+/// closest intersection by testing all the triangles
+bool intersectBruteForce(const Mesh& mesh, const Point3d& origin, const Point3d& direction, double maxDist, double& out_dist)
+{
+    bool hit = false;
+    out_dist = maxDist;
+
+    for (int i = 0; i < mesh.tris.size(); ++i)
+    {
+        double dist;
+        if (intersectTriangle(mesh, i, origin, direction, out_dist, dist))
+        {
+            hit = true;
+            out_dist = dist;
+        }
+    }
+    return hit;
+}
+
+/// compare the BVH queries with the brute force intersections, return the number of hits
+int checkRays(const Mesh& mesh, const MeshBVH& bvh, const std::vector<std::pair<Point3d, Point3d>>& rays)
+{
+    int nbHits = 0;
+    int nbHitMismatches = 0;
+    int nbDistMismatches = 0;
+    int nbOcclusionMismatches = 0;
+
+    for (const auto& ray : rays)
+    {
+        const Point3d& origin = ray.first;
+        const Point3d& direction = ray.second;
+
+        double refDist;
+        const bool refHit = intersectBruteForce(mesh, origin, direction, std::numeric_limits<double>::max(), refDist);
+
+        int triangleIndex = -1;
+        double dist;
+        const bool hit = bvh.intersect(origin, direction, std::numeric_limits<double>::max(), triangleIndex, dist);
+
+        if (hit != refHit)
+        {
+            ++nbHitMismatches;
+            continue;
+        }
+        if (!hit)
+            continue;
+
+        ++nbHits;
+
+        // a ray through a shared edge may hit one or the other triangle, at the same distance
+        if (std::abs(dist - refDist) > 1e-9 * refDist)
+            ++nbDistMismatches;
+
+        double triangleDist;
+        if (!intersectTriangle(mesh, triangleIndex, origin, direction, std::numeric_limits<double>::max(), triangleDist) ||
+            triangleDist != dist)
+            ++nbDistMismatches;
+
+        // occlusion test before and after the closest hit
+        if (bvh.isOccluded(origin, direction, refDist * 0.999) || !bvh.isOccluded(origin, direction, refDist * 1.001))
+            ++nbOcclusionMismatches;
+    }
+
+    BOOST_CHECK_EQUAL(nbHitMismatches, 0);
+    BOOST_CHECK_EQUAL(nbDistMismatches, 0);
+    BOOST_CHECK_EQUAL(nbOcclusionMismatches, 0);
+
+    return nbHits;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(meshBVH_randomTriangles)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> position(-1.0, 1.0);
+    std::uniform_real_distribution<double> size(-0.2, 0.2);
+
+    // random triangles soup, including some degenerated triangles
+    Mesh mesh;
+    const int nbTris = 2000;
+    for (int i = 0; i < nbTris; ++i)
+    {
+        const Point3d center(position(generator), position(generator), position(generator));
+        const int ptId = mesh.pts.size();
+
+        mesh.pts.push_back(center + Point3d(size(generator), size(generator), size(generator)));
+        mesh.pts.push_back(center + Point3d(size(generator), size(generator), size(generator)));
+        if (i % 100 == 0)
+            mesh.pts.push_back(mesh.pts[ptId]);
+        else
+            mesh.pts.push_back(center + Point3d(size(generator), size(generator), size(generator)));
+
+        mesh.tris.push_back(Mesh::triangle(ptId, ptId + 1, ptId + 2));
+    }
+
+    const MeshBVH bvh(mesh);
+    BOOST_CHECK_GT(bvh.getNbNodes(), 0);
+
+    // rays from outside and inside the soup, with non-normalized directions
+    std::vector<std::pair<Point3d, Point3d>> rays;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const double scale = (i % 2 == 0) ? 3.0 : 0.5;
+        const Point3d origin(scale * position(generator), scale * position(generator), scale * position(generator));
+        const Point3d target(position(generator), position(generator), position(generator));
+        rays.emplace_back(origin, (target - origin) * (0.1 + std::abs(position(generator))));
+    }
+
+    // axis aligned rays (null direction components)
+    for (int i = 0; i < 200; ++i)
+    {
+        const Point3d origin(position(generator), position(generator), -3.0);
+        rays.emplace_back(origin, Point3d(0.0, 0.0, 1.0));
+    }
+
+    const int nbHits = checkRays(mesh, bvh, rays);
+    BOOST_CHECK_GT(nbHits, int(rays.size()) / 4);
+}
+
+BOOST_AUTO_TEST_CASE(meshBVH_largeOffset)
+{
+    // small triangles far from the mesh bounding box center (packets origin):
+    // the single precision rounding errors are large relative to the triangles size
+    const Point3d offset(1e4, -2e4, 5e3);
+    const int gridSize = 100;
+    const double cellSize = 0.01;
+
+    Mesh mesh;
+    for (int y = 0; y <= gridSize; ++y)
+    {
+        for (int x = 0; x <= gridSize; ++x)
+            mesh.pts.push_back(offset + Point3d(x * cellSize, y * cellSize, 0.01 * std::sin(x * 0.3) * std::cos(y * 0.2)));
+    }
+    for (int y = 0; y < gridSize; ++y)
+    {
+        for (int x = 0; x < gridSize; ++x)
+        {
+            const int ptId = y * (gridSize + 1) + x;
+            mesh.tris.push_back(Mesh::triangle(ptId, ptId + 1, ptId + gridSize + 1));
+            mesh.tris.push_back(Mesh::triangle(ptId + 1, ptId + gridSize + 2, ptId + gridSize + 1));
+        }
+    }
+
+    // large triangle on the other side of the origin
+    {
+        const int ptId = mesh.pts.size();
+        mesh.pts.push_back(offset * -1.0);
+        mesh.pts.push_back(offset * -1.0 + Point3d(10.0, 0.0, 0.0));
+        mesh.pts.push_back(offset * -1.0 + Point3d(0.0, 10.0, 0.0));
+        mesh.tris.push_back(Mesh::triangle(ptId, ptId + 1, ptId + 2));
+    }
+
+    const MeshBVH bvh(mesh);
+
+    // rays through the grid, from close and far origins
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> gridPosition(0.0, gridSize * cellSize);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+
+    std::vector<std::pair<Point3d, Point3d>> rays;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const double height = (i % 2 == 0) ? 0.5 : 100.0;
+        const Point3d origin = offset + Point3d(gridPosition(generator) + unit(generator), gridPosition(generator) + unit(generator), height);
+        const Point3d target = offset + Point3d(gridPosition(generator), gridPosition(generator), 0.0);
+        rays.emplace_back(origin, target - origin);
+    }
+
+    // rays through the grid vertices and edges
+    for (int i = 0; i < 500; ++i)
+    {
+        const double x = std::floor(gridPosition(generator) / cellSize) * cellSize;
+        const double y = gridPosition(generator);
+        const Point3d target = offset + Point3d((i % 2 == 0) ? x : y, (i % 2 == 0) ? y : x, 0.0);
+        const Point3d origin = target + Point3d(0.1 * unit(generator), 0.1 * unit(generator), 1.0);
+        rays.emplace_back(origin, target - origin);
+    }
+
+    const int nbHits = checkRays(mesh, bvh, rays);
+    BOOST_CHECK_GT(nbHits, int(rays.size()) * 9 / 10);
+}
@@ -5,8 +5,11 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "MeshClean.hpp"
+#include <aliceVision/mesh/MeshAdjacency.hpp>
 #include <aliceVision/system/Logger.hpp>
 
+#include <numeric>
+
 namespace aliceVision {
 namespace mesh {
 
@@ -633,14 +636,17 @@ void MeshClean::init()
 {
     deallocateCleaningAttributes();
 
-    getPtsNeighborTriangles(ptsNeighTrisSortedAsc);
-    for (int i = 0; i < pts.size(); i++)
+    const MeshAdjacency adjacency(*this);
+    const int nbPts = pts.size();
+
+    // adjacency triangles are sorted by ascending index
+    ptsNeighTrisSortedAsc.resize(nbPts);
+
+#pragma omp parallel for
+    for (int i = 0; i < nbPts; i++)
     {
-        StaticVector<int>& ptNeigTris = ptsNeighTrisSortedAsc[i];
-        if (sizeOfStaticVector<int>(ptNeigTris) > 1)
-        {
-            qsort(&ptNeigTris[0], ptNeigTris.size(), sizeof(int), qSortCompareIntAsc);
-        }
+        const MeshAdjacency::IndexRange ptTris = adjacency.getVertexTriangles(i);
+        ptsNeighTrisSortedAsc[i].getDataWritable().assign(ptTris.begin(), ptTris.end());
     }
 
     ptsNeighPtsOrdered.reserve(pts.size());
@@ -652,63 +658,59 @@ void MeshClean::init()
     newPtsOldPtId.reserve(pts.size());
     nPtsInit = pts.size();
 
-    edgesNeigTrisAlive.reserve(tris.size() * 3);
-    edgesNeigTris.reserve(tris.size() * 3);
-    edgesXStat.reserve(pts.size());
-    edgesXYStat.reserve(tris.size() * 3);
-
-    for (int i = 0; i < tris.size(); i++)
-    {
-        int a = tris[i].v[0];
-        int b = tris[i].v[1];
-        int c = tris[i].v[2];
-        edgesNeigTris.push_back(Voxel(std::max(a, b), std::min(a, b), i));
-        edgesNeigTris.push_back(Voxel(std::max(b, c), std::min(b, c), i));
-        edgesNeigTris.push_back(Voxel(std::max(c, a), std::min(c, a), i));
-
-        edgesNeigTrisAlive.push_back(true);
-        edgesNeigTrisAlive.push_back(true);
-        edgesNeigTrisAlive.push_back(true);
-    }
-
-    qsort(&edgesNeigTris[0], edgesNeigTris.size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
+    // edgesNeigTris: <max pt id, min pt id, triangle id> sorted by x, y and z
+    // edgesXYStat: <min pt id, first, last> interval in edgesNeigTris of each edge
+    // edgesXStat: <max pt id, first, last> interval in edgesXYStat of each max pt id
+    // each point stores its edges with the lower neighbor points, in the order of the points
+    std::vector<int> edgesOffsets(nbPts + 1, 0);
+    std::vector<int> edgesTrisOffsets(nbPts + 1, 0);
+    std::vector<int> xStatOffsets(nbPts + 1, 0);
 
-    // sort
-    int i0 = 0;
-    long t1 = mvsUtils::initEstimate();
-    for (int i = 0; i < edgesNeigTris.size(); i++)
+#pragma omp parallel for
+    for (int i = 0; i < nbPts; i++)
     {
-        if ((i == edgesNeigTris.size() - 1) || (edgesNeigTris[i].x != edgesNeigTris[i + 1].x))
+        int nbEdges = 0;
+        int nbEdgesTris = 0;
+        for (const int j : adjacency.getVertexNeighbors(i))
         {
-            if (i - i0 + 1 > 1)
-                qsort(&edgesNeigTris[i0], i - i0 + 1, sizeof(Voxel), qSortCompareVoxelByYAsc);
+            if (j > i)
+                break;
+            ++nbEdges;
+            nbEdgesTris += adjacency.getNbEdgeTriangles(i, j);
+        }
+        edgesOffsets[i + 1] = nbEdges;
+        edgesTrisOffsets[i + 1] = nbEdgesTris;
+        xStatOffsets[i + 1] = (nbEdges > 0) ? 1 : 0;
+    }
 
-            int xyI0 = edgesXYStat.size();
+    std::partial_sum(edgesOffsets.begin(), edgesOffsets.end(), edgesOffsets.begin());
+    std::partial_sum(edgesTrisOffsets.begin(), edgesTrisOffsets.end(), edgesTrisOffsets.begin());
+    std::partial_sum(xStatOffsets.begin(), xStatOffsets.end(), xStatOffsets.begin());
 
-            int j0 = i0;
-            for (int j = i0; j <= i; j++)
-            {
-                if ((j == i) || (edgesNeigTris[j].y != edgesNeigTris[j + 1].y))
-                {
-                    if (j - j0 + 1 > 1)
-                        qsort(&edgesNeigTris[j0], j - j0 + 1, sizeof(Voxel), qSortCompareVoxelByZAsc);
+    edgesNeigTris.resize(edgesTrisOffsets.back());
+    edgesNeigTrisAlive.resize_with(edgesTrisOffsets.back(), true);
+    edgesXYStat.resize(edgesOffsets.back());
+    edgesXStat.resize(xStatOffsets.back());
 
-                    edgesXYStat.push_back(Voxel(edgesNeigTris[j].y, j0, j));
-                    j0 = j + 1;
-                }
-            }
-
-            int xyI = edgesXYStat.size() - 1;
+#pragma omp parallel for
+    for (int i = 0; i < nbPts; i++)
+    {
+        if (edgesOffsets[i] == edgesOffsets[i + 1])
+            continue;
 
-            // printf("%i of %i\n",edgesXStat->size(),edgesXStat->reserved());
-            edgesXStat.push_back(Voxel(edgesNeigTris[i].x, xyI0, xyI));
+        int xyI = edgesOffsets[i];
+        int k = edgesTrisOffsets[i];
+        for (const int j : adjacency.getVertexNeighbors(i))
+        {
+            if (j > i)
+                break;
 
-            i0 = i + 1;
+            const int k0 = k;
+            adjacency.forEachEdgeTriangle(i, j, [&](int triId) { edgesNeigTris[k++] = Voxel(i, j, triId); });
+            edgesXYStat[xyI++] = Voxel(j, k0, k - 1);
         }
-
-        mvsUtils::printfEstimate(i, edgesNeigTris.size(), t1);
+        edgesXStat[xStatOffsets[i]] = Voxel(i, edgesOffsets[i], xyI - 1);
     }
-    mvsUtils::finishEstimate();
 }
 
 void MeshClean::testPtsNeighTrisSortedAsc()
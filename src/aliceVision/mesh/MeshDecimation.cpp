@@ -0,0 +1,650 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MeshDecimation.hpp"
+
+#include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/mvsData/Point3d.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <OpenMesh/Core/IO/MeshIO.hh>
+#include <OpenMesh/Core/Mesh/TriMesh_ArrayKernelT.hh>
+#include <OpenMesh/Tools/Decimater/DecimaterT.hh>
+
+#include <aliceVision/mesh/ModQuadricMetricT.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace aliceVision {
+namespace mesh {
+
+namespace {
+
+// double precision points, as lidar meshes may be far from the origin
+struct DecimationTraits : public OpenMesh::DefaultTraits
+{
+    typedef OpenMesh::Vec3d Point;
+};
+
+typedef OpenMesh::TriMesh_ArrayKernelT<DecimationTraits> DecimationMesh;
+typedef OpenMesh::Decimater::DecimaterT<DecimationMesh> Decimater;
+typedef OpenMesh::Decimater::ModQuadricMetricT<DecimationMesh>::Handle HModQuadricMetric;
+
+struct VertexRecord
+{
+    double x, y, z;
+    std::uint64_t id;
+};
+
+struct TriangleRecord
+{
+    std::uint32_t v[3];
+};
+
+struct DecimatedCluster
+{
+    std::vector<Point3d> points;
+    std::vector<std::int64_t> globalIds;  //< input vertex index of the vertices shared with other clusters, -1 otherwise
+    std::vector<int> triangles;           //< 3 vertex indexes per triangle
+};
+
+/**
+ * @brief Stream the vertices and triangles of an OBJ file.
+ * @note Polygons are split in triangle fans, negative (relative) indexes are supported.
+ *       Texture coordinates and normals are ignored.
+ * @param[in] path the OBJ file path
+ * @param[in] readFaces parse the faces
+ * @param[in] onVertex the vertex function: void(std::uint32_t vertexIndex, const Point3d& p)
+ * @param[in] onTriangle the triangle function: void(std::uint32_t a, std::uint32_t b, std::uint32_t c)
+ * @return the number of vertices
+ */
+template<typename VertexFunction, typename TriangleFunction>
+std::size_t readObj(const std::string& path, bool readFaces, VertexFunction onVertex, TriangleFunction onTriangle)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+        ALICEVISION_THROW_ERROR("Unable to open the mesh file: " << path);
+
+    std::string line;
+    std::size_t nbVertices = 0;
+    std::vector<std::uint32_t> polygon;
+
+    while (std::getline(file, line))
+    {
+        const char* str = line.c_str();
+
+        if (str[0] == 'v' && (str[1] == ' ' || str[1] == '\t'))
+        {
+            char* end;
+            Point3d p;
+            p.x = std::strtod(str + 2, &end);
+            p.y = std::strtod(end, &end);
+            p.z = std::strtod(end, &end);
+
+            if (nbVertices >= std::numeric_limits<std::uint32_t>::max())
+                ALICEVISION_THROW_ERROR("Too many vertices in the mesh file: " << path);
+
+            onVertex(std::uint32_t(nbVertices), p);
+            ++nbVertices;
+        }
+        else if (readFaces && str[0] == 'f' && (str[1] == ' ' || str[1] == '\t'))
+        {
+            polygon.clear();
+            const char* s = str + 1;
+            while (true)
+            {
+                char* end;
+                const long index = std::strtol(s, &end, 10);
+                if (end == s)
+                    break;
+
+                // OBJ indexes start at 1, negative indexes are relative to the last vertex
+                polygon.push_back(std::uint32_t(index > 0 ? index - 1 : long(nbVertices) + index));
+
+                // skip texture coordinates and normal indexes
+                s = end;
+                while (*s != '\0' && *s != ' ' && *s != '\t')
+                    ++s;
+            }
+
+            for (std::size_t i = 2; i < polygon.size(); ++i)
+                onTriangle(polygon[0], polygon[i - 1], polygon[i]);
+        }
+    }
+    return nbVertices;
+}
+
+/**
+ * @brief Spatial partition in clusters (kd-tree), built from a sample of the mesh vertices.
+ */
+class ClusterPartition
+{
+  public:
+    /**
+     * @brief Build the partition.
+     * @param[in,out] samples the vertices sample (reordered)
+     * @param[in] maxSamplesPerCluster the max number of samples per cluster
+     */
+    void build(std::vector<Point3d>& samples, int maxSamplesPerCluster)
+    {
+        _nodes.clear();
+        _nbClusters = 0;
+        buildNode(samples, 0, int(samples.size()), maxSamplesPerCluster);
+    }
+
+    inline int getNbClusters() const { return _nbClusters; }
+
+    int getCluster(const Point3d& p) const
+    {
+        int nodeIndex = 0;
+        while (_nodes[nodeIndex].cluster < 0)
+        {
+            const Node& node = _nodes[nodeIndex];
+            nodeIndex = (p.m[node.axis] < node.split) ? nodeIndex + 1 : node.rightChild;
+        }
+        return _nodes[nodeIndex].cluster;
+    }
+
+  private:
+    struct Node
+    {
+        double split;
+        int axis;
+        int rightChild;  //< left child is the next node
+        int cluster;     //< -1 for inner nodes
+    };
+
+    int buildNode(std::vector<Point3d>& samples, int begin, int end, int maxSamplesPerCluster)
+    {
+        const int nodeIndex = int(_nodes.size());
+        _nodes.push_back({0.0, 0, -1, -1});
+
+        // split axis: largest extent of the samples
+        int axis = 0;
+        double maxExtent = 0.0;
+        if (end - begin > maxSamplesPerCluster)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                const auto minMax = std::minmax_element(
+                  samples.begin() + begin, samples.begin() + end, [k](const Point3d& a, const Point3d& b) { return a.m[k] < b.m[k]; });
+                const double extent = minMax.second->m[k] - minMax.first->m[k];
+                if (extent > maxExtent)
+                {
+                    maxExtent = extent;
+                    axis = k;
+                }
+            }
+        }
+
+        if (maxExtent <= 0.0)
+        {
+            _nodes[nodeIndex].cluster = _nbClusters++;
+            return nodeIndex;
+        }
+
+        const int middle = begin + (end - begin) / 2;
+        std::nth_element(samples.begin() + begin, samples.begin() + middle, samples.begin() + end, [axis](const Point3d& a, const Point3d& b) {
+            return a.m[axis] < b.m[axis];
+        });
+        const double split = samples[middle].m[axis];
+
+        buildNode(samples, begin, middle, maxSamplesPerCluster);
+        const int rightChild = buildNode(samples, middle, end, maxSamplesPerCluster);
+
+        _nodes[nodeIndex] = {split, axis, rightChild, -1};
+        return nodeIndex;
+    }
+
+    std::vector<Node> _nodes;
+    int _nbClusters = 0;
+};
+
+/**
+ * @brief Binary file written by buffered appends, to keep many cluster files without keeping them open.
+ */
+class ClusterFileWriter
+{
+  public:
+    explicit ClusterFileWriter(const std::string& path)
+      : _path(path)
+    {}
+
+    template<typename T>
+    void write(const T& value)
+    {
+        const char* data = reinterpret_cast<const char*>(&value);
+        _buffer.insert(_buffer.end(), data, data + sizeof(T));
+        if (_buffer.size() >= bufferSize)
+            flush();
+    }
+
+    void flush()
+    {
+        if (_buffer.empty())
+            return;
+
+        std::ofstream file(_path, std::ios::binary | std::ios::app);
+        if (!file.write(_buffer.data(), std::streamsize(_buffer.size())))
+            ALICEVISION_THROW_ERROR("Unable to write the decimation cluster file: " << _path);
+        _buffer.clear();
+    }
+
+    inline const std::string& getPath() const { return _path; }
+
+  private:
+    static constexpr std::size_t bufferSize = 1 << 18;
+
+    std::string _path;
+    std::vector<char> _buffer;
+};
+
+/// read and remove a cluster file
+template<typename T>
+std::vector<T> readClusterFile(const std::string& path)
+{
+    std::vector<T> records;
+    if (!fs::exists(path))
+        return records;
+
+    records.resize(fs::file_size(path) / sizeof(T));
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.read(reinterpret_cast<char*>(records.data()), std::streamsize(records.size() * sizeof(T))))
+            ALICEVISION_THROW_ERROR("Unable to read the decimation cluster file: " << path);
+    }
+    fs::remove(path);
+    return records;
+}
+
+/**
+ * @brief Add the quadric module to the decimater, with the given error limit.
+ * @param[in,out] decimater the decimater
+ * @param[in] errorLimit max error allowed for a collapse (0: disabled)
+ */
+void initializeDecimater(Decimater& decimater, double errorLimit)
+{
+    HModQuadricMetric hModQuadric;
+    decimater.add(hModQuadric);
+
+    if (errorLimit > 0.0)
+        decimater.module(hModQuadric).set_max_err(errorLimit * errorLimit);
+    else
+        decimater.module(hModQuadric).unset_max_err();
+
+    decimater.initialize();
+}
+
+/**
+ * @brief Decimate a cluster with its shared vertices locked.
+ * @param[in] vertexFile the cluster vertices file (cluster vertices and foreign vertices of its triangles)
+ * @param[in] triangleFile the cluster triangles file
+ * @param[in] sharedVertices the input vertices used by several clusters
+ * @param[in] ratio the ratio of output vertices (0: error limit only)
+ * @param[in] errorLimit max error allowed for a collapse (0: disabled)
+ * @param[out] out_cluster the decimated cluster
+ */
+void decimateCluster(const std::string& vertexFile,
+                     const std::string& triangleFile,
+                     const std::vector<bool>& sharedVertices,
+                     double ratio,
+                     double errorLimit,
+                     DecimatedCluster& out_cluster)
+{
+    std::vector<VertexRecord> vertices = readClusterFile<VertexRecord>(vertexFile);
+    const std::vector<TriangleRecord> triangles = readClusterFile<TriangleRecord>(triangleFile);
+
+    if (triangles.empty())
+        return;
+
+    std::sort(vertices.begin(), vertices.end(), [](const VertexRecord& a, const VertexRecord& b) { return a.id < b.id; });
+
+    DecimationMesh mesh;
+    OpenMesh::VPropHandleT<std::int64_t> globalIdProp;
+    mesh.add_property(globalIdProp);
+
+    // only the vertices used by the cluster triangles are added
+    std::vector<DecimationMesh::VertexHandle> vertexHandles(vertices.size());
+    const auto getVertexHandle = [&](std::uint32_t id) {
+        const auto it =
+          std::lower_bound(vertices.begin(), vertices.end(), id, [](const VertexRecord& r, std::uint64_t value) { return r.id < value; });
+        DecimationMesh::VertexHandle& vh = vertexHandles[it - vertices.begin()];
+        if (!vh.is_valid())
+        {
+            vh = mesh.add_vertex(DecimationMesh::Point(it->x, it->y, it->z));
+            mesh.property(globalIdProp, vh) = sharedVertices[id] ? std::int64_t(id) : -1;
+        }
+        return vh;
+    };
+
+    for (const TriangleRecord& t : triangles)
+        mesh.add_face(getVertexHandle(t.v[0]), getVertexHandle(t.v[1]), getVertexHandle(t.v[2]));
+
+    std::vector<VertexRecord>().swap(vertices);
+    std::vector<DecimationMesh::VertexHandle>().swap(vertexHandles);
+
+    // lock the shared vertices, so the clusters stay connected
+    mesh.request_vertex_status();
+    for (DecimationMesh::VertexIter v_it = mesh.vertices_begin(); v_it != mesh.vertices_end(); ++v_it)
+    {
+        if (mesh.property(globalIdProp, *v_it) >= 0)
+            mesh.status(*v_it).set_locked(true);
+    }
+
+    {
+        Decimater decimater(mesh);
+        initializeDecimater(decimater, errorLimit);
+
+        if (ratio > 0.0)
+            decimater.decimate_to(std::size_t(std::round(double(mesh.n_vertices()) * ratio)));
+        else
+            decimater.decimate(0);
+
+        mesh.garbage_collection();
+    }
+
+    out_cluster.points.reserve(mesh.n_vertices());
+    out_cluster.globalIds.reserve(mesh.n_vertices());
+    for (DecimationMesh::VertexIter v_it = mesh.vertices_begin(); v_it != mesh.vertices_end(); ++v_it)
+    {
+        const DecimationMesh::Point& p = mesh.point(*v_it);
+        out_cluster.points.emplace_back(p[0], p[1], p[2]);
+        out_cluster.globalIds.push_back(mesh.property(globalIdProp, *v_it));
+    }
+
+    out_cluster.triangles.reserve(mesh.n_faces() * 3);
+    for (DecimationMesh::FaceIter f_it = mesh.faces_begin(); f_it != mesh.faces_end(); ++f_it)
+    {
+        for (DecimationMesh::FaceVertexIter fv_it = mesh.fv_iter(*f_it); fv_it.is_valid(); ++fv_it)
+            out_cluster.triangles.push_back(fv_it->idx());
+    }
+}
+
+}  // namespace
+
+int getDecimationTargetNbVertices(int nbInputVertices, const StreamingDecimationParams& params)
+{
+    if (params.fixedNbVertices != 0)
+        return params.fixedNbVertices;
+
+    int nbOutputVertices = 0;
+    if (params.simplificationFactor != 0.0)
+        nbOutputVertices = int(params.simplificationFactor * nbInputVertices);
+    if (params.minVertices != 0)
+    {
+        if (nbInputVertices > params.minVertices && nbOutputVertices < params.minVertices)
+            nbOutputVertices = params.minVertices;
+    }
+    if (params.maxVertices != 0)
+    {
+        if (nbInputVertices > params.maxVertices && nbOutputVertices > params.maxVertices)
+            nbOutputVertices = params.maxVertices;
+    }
+    return nbOutputVertices;
+}
+
+bool decimateMeshOutOfCore(const std::string& inputMeshPath,
+                           const std::string& outputMeshPath,
+                           const std::string& tmpDirectory,
+                           const StreamingDecimationParams& params)
+{
+    // the input mesh is streamed with its own OBJ reader
+    std::string inputExtension = fs::path(inputMeshPath).extension().string();
+    std::transform(inputExtension.begin(), inputExtension.end(), inputExtension.begin(), ::tolower);
+    if (inputExtension != ".obj")
+    {
+        ALICEVISION_LOG_ERROR("Failed: the out-of-core decimation only supports OBJ input meshes: " << inputMeshPath);
+        return false;
+    }
+
+    // first pass: count the vertices and sample them (reservoir sampling)
+    constexpr std::size_t maxNbSamples = 1 << 20;
+    std::vector<Point3d> samples;
+    samples.reserve(maxNbSamples);
+    std::mt19937 generator(0);
+
+    const std::size_t nbVertices = readObj(
+      inputMeshPath,
+      false,
+      [&](std::uint32_t i, const Point3d& p) {
+          if (i < maxNbSamples)
+          {
+              samples.push_back(p);
+              return;
+          }
+          const std::uint32_t j = std::uniform_int_distribution<std::uint32_t>(0, i)(generator);
+          if (j < maxNbSamples)
+              samples[j] = p;
+      },
+      [](std::uint32_t, std::uint32_t, std::uint32_t) {});
+
+    if (nbVertices == 0)
+    {
+        ALICEVISION_LOG_ERROR("Failed: the input mesh is empty: " << inputMeshPath);
+        return false;
+    }
+
+    const int targetNbVertices = getDecimationTargetNbVertices(int(std::min<std::size_t>(nbVertices, std::numeric_limits<int>::max())), params);
+    if (targetNbVertices <= 0 && params.errorLimit <= 0.0)
+    {
+        ALICEVISION_LOG_ERROR("Failed: no number of vertices or error limit for the decimation.");
+        return false;
+    }
+    const double ratio = (targetNbVertices > 0) ? std::min(1.0, double(targetNbVertices) / double(nbVertices)) : 0.0;
+
+    ClusterPartition partition;
+    {
+        const double samplesRatio = double(samples.size()) / double(nbVertices);
+        partition.build(samples, std::max(1, int(double(params.maxVerticesPerCluster) * samplesRatio)));
+        std::vector<Point3d>().swap(samples);
+    }
+    const int nbClusters = partition.getNbClusters();
+
+    ALICEVISION_LOG_INFO("Input mesh: " << nbVertices << " vertices, split in " << nbClusters << " clusters.");
+
+    const fs::path clustersDirectory = fs::path(tmpDirectory) / (fs::path(outputMeshPath).stem().string() + "_decimationClusters");
+    fs::remove_all(clustersDirectory);
+    fs::create_directories(clustersDirectory);
+
+    std::vector<ClusterFileWriter> vertexWriters;
+    std::vector<ClusterFileWriter> triangleWriters;
+    vertexWriters.reserve(nbClusters);
+    triangleWriters.reserve(nbClusters);
+    for (int c = 0; c < nbClusters; ++c)
+    {
+        vertexWriters.emplace_back((clustersDirectory / ("vertices_" + std::to_string(c) + ".bin")).string());
+        triangleWriters.emplace_back((clustersDirectory / ("triangles_" + std::to_string(c) + ".bin")).string());
+    }
+
+    // second pass: write the vertices and triangles of each cluster
+    // a triangle belongs to the cluster of its first vertex, its other vertices may be foreign vertices
+    std::vector<int> vertexClusters(nbVertices, -1);
+    std::vector<bool> sharedVertices(nbVertices, false);
+    std::vector<std::pair<std::uint32_t, int>> foreignVertices;
+    std::size_t nbTriangles = 0;
+    std::size_t nbInvalidTriangles = 0;
+
+    readObj(
+      inputMeshPath,
+      true,
+      [&](std::uint32_t i, const Point3d& p) {
+          const int c = partition.getCluster(p);
+          vertexClusters[i] = c;
+          vertexWriters[c].write(VertexRecord{p.x, p.y, p.z, i});
+      },
+      [&](std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+          // skip degenerate triangles and references to undefined vertices
+          if (a == b || b == c || a == c || a >= nbVertices || b >= nbVertices || c >= nbVertices || vertexClusters[a] < 0 ||
+              vertexClusters[b] < 0 || vertexClusters[c] < 0)
+          {
+              ++nbInvalidTriangles;
+              return;
+          }
+
+          const int cluster = vertexClusters[a];
+          triangleWriters[cluster].write(TriangleRecord{{a, b, c}});
+          ++nbTriangles;
+
+          for (const std::uint32_t v : {b, c})
+          {
+              if (vertexClusters[v] != cluster)
+              {
+                  sharedVertices[v] = true;
+                  foreignVertices.emplace_back(v, cluster);
+              }
+          }
+      });
+
+    std::vector<int>().swap(vertexClusters);
+
+    if (nbInvalidTriangles > 0)
+        ALICEVISION_LOG_WARNING(nbInvalidTriangles << " invalid triangles ignored.");
+
+    // third pass: write the foreign vertices of each cluster
+    if (!foreignVertices.empty())
+    {
+        std::sort(foreignVertices.begin(), foreignVertices.end());
+        foreignVertices.erase(std::unique(foreignVertices.begin(), foreignVertices.end()), foreignVertices.end());
+
+        auto foreignIt = foreignVertices.cbegin();
+        readObj(
+          inputMeshPath,
+          false,
+          [&](std::uint32_t i, const Point3d& p) {
+              for (; foreignIt != foreignVertices.cend() && foreignIt->first == i; ++foreignIt)
+                  vertexWriters[foreignIt->second].write(VertexRecord{p.x, p.y, p.z, i});
+          },
+          [](std::uint32_t, std::uint32_t, std::uint32_t) {});
+
+        ALICEVISION_LOG_INFO(foreignVertices.size() << " vertices shared between clusters.");
+        std::vector<std::pair<std::uint32_t, int>>().swap(foreignVertices);
+    }
+
+    for (int c = 0; c < nbClusters; ++c)
+    {
+        vertexWriters[c].flush();
+        triangleWriters[c].flush();
+    }
+
+    ALICEVISION_LOG_INFO("Input mesh: " << nbTriangles << " triangles written in clusters.");
+
+    // decimate the clusters in parallel
+    // note: dynamic schedule, the clusters sizes may differ
+    std::vector<DecimatedCluster> decimatedClusters(nbClusters);
+    {
+        const int nbParallelClusters = (params.nbParallelClusters > 0) ? params.nbParallelClusters : omp_get_max_threads();
+        std::exception_ptr exception = nullptr;
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nbParallelClusters)
+        for (int c = 0; c < nbClusters; ++c)
+        {
+            try
+            {
+                decimateCluster(vertexWriters[c].getPath(), triangleWriters[c].getPath(), sharedVertices, ratio, params.errorLimit, decimatedClusters[c]);
+            }
+            catch (...)
+            {
+#pragma omp critical
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+
+        if (exception)
+        {
+            fs::remove_all(clustersDirectory);
+            std::rethrow_exception(exception);
+        }
+    }
+
+    fs::remove_all(clustersDirectory);
+    std::vector<bool>().swap(sharedVertices);
+
+    // merge the decimated clusters, shared vertices are merged by input index
+    DecimationMesh mesh;
+    mesh.request_vertex_status();
+    std::unordered_map<std::int64_t, DecimationMesh::VertexHandle> sharedVertexHandles;
+    {
+        std::vector<DecimationMesh::VertexHandle> vertexHandles;
+        for (DecimatedCluster& cluster : decimatedClusters)
+        {
+            vertexHandles.resize(cluster.points.size());
+            for (std::size_t i = 0; i < cluster.points.size(); ++i)
+            {
+                const Point3d& p = cluster.points[i];
+                if (cluster.globalIds[i] < 0)
+                {
+                    vertexHandles[i] = mesh.add_vertex(DecimationMesh::Point(p.x, p.y, p.z));
+                    continue;
+                }
+                const auto it = sharedVertexHandles.emplace(cluster.globalIds[i], DecimationMesh::VertexHandle());
+                if (it.second)
+                    it.first->second = mesh.add_vertex(DecimationMesh::Point(p.x, p.y, p.z));
+                vertexHandles[i] = it.first->second;
+            }
+
+            for (std::size_t i = 0; i < cluster.triangles.size(); i += 3)
+                mesh.add_face(vertexHandles[cluster.triangles[i]], vertexHandles[cluster.triangles[i + 1]], vertexHandles[cluster.triangles[i + 2]]);
+
+            cluster = DecimatedCluster();
+        }
+    }
+
+    ALICEVISION_LOG_INFO("Decimated clusters: " << mesh.n_vertices() << " vertices and " << mesh.n_faces() << " facets.");
+
+    // boundary pass: decimate around the shared vertices, the clusters inner vertices are locked
+    // note: the error quadrics are initialized from the decimated clusters
+    if (!sharedVertexHandles.empty())
+    {
+        for (DecimationMesh::VertexIter v_it = mesh.vertices_begin(); v_it != mesh.vertices_end(); ++v_it)
+            mesh.status(*v_it).set_locked(true);
+        for (const auto& sharedVertex : sharedVertexHandles)
+            mesh.status(sharedVertex.second).set_locked(false);
+
+        Decimater decimater(mesh);
+        initializeDecimater(decimater, params.errorLimit);
+
+        if (targetNbVertices > 0)
+            decimater.decimate_to(std::size_t(targetNbVertices));
+        else
+            decimater.decimate(0);
+
+        mesh.garbage_collection();
+    }
+
+    ALICEVISION_LOG_INFO("Output mesh: " << mesh.n_vertices() << " vertices and " << mesh.n_faces() << " facets.");
+
+    if (mesh.n_faces() == 0)
+    {
+        ALICEVISION_LOG_ERROR("Failed: the output mesh is empty.");
+        return false;
+    }
+
+    if (!OpenMesh::IO::write_mesh(mesh, outputMeshPath))
+    {
+        ALICEVISION_LOG_ERROR("Failed to save mesh \"" << outputMeshPath << "\".");
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
@@ -0,0 +1,59 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <string>
+
+namespace aliceVision {
+namespace mesh {
+
+struct StreamingDecimationParams
+{
+    /// ratio of output vertices (0: disabled)
+    double simplificationFactor = 0.0;
+    /// fixed number of output vertices (0: disabled)
+    int fixedNbVertices = 0;
+    /// min number of output vertices (0: disabled)
+    int minVertices = 0;
+    /// max number of output vertices (0: disabled)
+    int maxVertices = 0;
+    /// max error allowed for a collapse, in mesh units (0: disabled)
+    double errorLimit = 0.0;
+    /// max number of vertices of a cluster, loaded and decimated in memory
+    int maxVerticesPerCluster = 2000000;
+    /// max number of clusters decimated in parallel (0: number of threads)
+    int nbParallelClusters = 0;
+};
+
+/**
+ * @brief Get the target number of output vertices of a decimation.
+ * @param[in] nbInputVertices the number of input vertices
+ * @param[in] params the decimation parameters
+ * @return the target number of output vertices, 0 if there is no target (error limit only)
+ */
+int getDecimationTargetNbVertices(int nbInputVertices, const StreamingDecimationParams& params);
+
+/**
+ * @brief Decimate an OBJ mesh which may not fit in memory, with error quadrics.
+ * @note The input mesh is streamed (never fully loaded) and split into spatial clusters
+ *       of at most params.maxVerticesPerCluster vertices, written to temporary files.
+ *       Clusters are decimated in parallel with their shared vertices locked,
+ *       then the decimated clusters are merged and a final pass only decimates around
+ *       the clusters boundaries. The decimated mesh should fit in memory.
+ * @param[in] inputMeshPath the input mesh file path (OBJ file format)
+ * @param[in] outputMeshPath the output mesh file path
+ * @param[in] tmpDirectory the directory for the clusters temporary files
+ * @param[in] params the decimation parameters
+ * @return true if the decimated mesh is saved, false if the input is not an OBJ file or if the decimation failed
+ */
+bool decimateMeshOutOfCore(const std::string& inputMeshPath,
+                           const std::string& outputMeshPath,
+                           const std::string& tmpDirectory,
+                           const StreamingDecimationParams& params);
+
+}  // namespace mesh
+}  // namespace aliceVision
@@ -0,0 +1,246 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mesh/MeshDecimation.hpp>
+#include <aliceVision/mvsData/Point3d.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE meshDecimation
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct ObjMesh
+{
+    std::vector<Point3d> points;
+    std::vector<std::array<int, 3>> triangles;
+};
+
+double surfaceHeight(double x, double y) { return 0.2 * std::sin(x) * std::cos(y); }
+
+/// distance of a point to the height field surface, to the first order
+double surfaceDistance(const Point3d& p)
+{
+    const double dx = 0.2 * std::cos(p.x) * std::cos(p.y);
+    const double dy = -0.2 * std::sin(p.x) * std::sin(p.y);
+    return std::abs(p.z - surfaceHeight(p.x, p.y)) / std::sqrt(1.0 + dx * dx + dy * dy);
+}
+
+/// write a regular grid of the height field, of gridSize x gridSize vertices
+void writeGridObj(const std::string& path, int gridSize, double extent)
+{
+    std::ofstream file(path);
+    file << std::setprecision(12);
+    for (int j = 0; j < gridSize; ++j)
+    {
+        for (int i = 0; i < gridSize; ++i)
+        {
+            const double x = extent * i / (gridSize - 1);
+            const double y = extent * j / (gridSize - 1);
+            file << "v " << x << " " << y << " " << surfaceHeight(x, y) << "\n";
+        }
+    }
+    for (int j = 0; j + 1 < gridSize; ++j)
+    {
+        for (int i = 0; i + 1 < gridSize; ++i)
+        {
+            const int v = j * gridSize + i + 1;
+            file << "f " << v << " " << v + 1 << " " << v + gridSize + 1 << "\n";
+            file << "f " << v << " " << v + gridSize + 1 << " " << v + gridSize << "\n";
+        }
+    }
+}
+
+ObjMesh readObjMesh(const std::string& path)
+{
+    ObjMesh mesh;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream iss(line);
+        std::string type;
+        iss >> type;
+        if (type == "v")
+        {
+            Point3d p;
+            iss >> p.x >> p.y >> p.z;
+            mesh.points.push_back(p);
+        }
+        else if (type == "f")
+        {
+            std::vector<int> polygon;
+            std::string token;
+            while (iss >> token)
+                polygon.push_back(std::atoi(token.c_str()) - 1);
+            for (std::size_t i = 2; i < polygon.size(); ++i)
+                mesh.triangles.push_back({polygon[0], polygon[i - 1], polygon[i]});
+        }
+    }
+    return mesh;
+}
+
+struct MeshTopology
+{
+    bool isManifold = true;
+    int eulerCharacteristic = 0;
+    int nbBoundaryLoops = 0;
+};
+
+MeshTopology getTopology(const ObjMesh& mesh)
+{
+    std::map<std::pair<int, int>, int> edgesUsage;
+    std::set<int> usedVertices;
+    for (const auto& t : mesh.triangles)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            const int a = t[k];
+            const int b = t[(k + 1) % 3];
+            ++edgesUsage[std::make_pair(std::min(a, b), std::max(a, b))];
+            usedVertices.insert(a);
+        }
+    }
+
+    MeshTopology topology;
+    topology.eulerCharacteristic = int(usedVertices.size()) - int(edgesUsage.size()) + int(mesh.triangles.size());
+
+    // boundary loops: connected components of the boundary edges
+    std::vector<int> parent(mesh.points.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    const auto find = [&parent](int v) {
+        while (parent[v] != v)
+            v = parent[v] = parent[parent[v]];
+        return v;
+    };
+
+    std::set<int> boundaryVertices;
+    for (const auto& edgeUsage : edgesUsage)
+    {
+        if (edgeUsage.second > 2)
+            topology.isManifold = false;
+        if (edgeUsage.second != 1)
+            continue;
+        boundaryVertices.insert(edgeUsage.first.first);
+        boundaryVertices.insert(edgeUsage.first.second);
+        parent[find(edgeUsage.first.first)] = find(edgeUsage.first.second);
+    }
+    for (const int v : boundaryVertices)
+    {
+        if (find(v) == v)
+            ++topology.nbBoundaryLoops;
+    }
+    return topology;
+}
+
+struct TestDirectory
+{
+    TestDirectory()
+      : path(fs::temp_directory_path() / "meshDecimation_test")
+    {
+        fs::remove_all(path);
+        fs::create_directories(path);
+    }
+    ~TestDirectory() { fs::remove_all(path); }
+
+    std::string file(const std::string& filename) const { return (path / filename).string(); }
+
+    fs::path path;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(meshDecimation_outOfCore_targetNbVertices)
+{
+    const TestDirectory directory;
+    const int gridSize = 120;
+    writeGridObj(directory.file("grid.obj"), gridSize, 10.0);
+
+    StreamingDecimationParams params;
+    params.fixedNbVertices = 1500;
+
+    // a single cluster, then clusters decimated with their shared vertices locked
+    for (const int maxVerticesPerCluster : {gridSize * gridSize, 3000})
+    {
+        params.maxVerticesPerCluster = maxVerticesPerCluster;
+        BOOST_REQUIRE(decimateMeshOutOfCore(directory.file("grid.obj"), directory.file("decimated.obj"), directory.path.string(), params));
+
+        const ObjMesh mesh = readObjMesh(directory.file("decimated.obj"));
+        BOOST_CHECK_CLOSE(double(mesh.points.size()), double(params.fixedNbVertices), 10.0);
+
+        // the clusters are stitched on their shared vertices: no crack, the output is still a disk
+        const MeshTopology topology = getTopology(mesh);
+        BOOST_CHECK(topology.isManifold);
+        BOOST_CHECK_EQUAL(topology.eulerCharacteristic, 1);
+        BOOST_CHECK_EQUAL(topology.nbBoundaryLoops, 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(meshDecimation_outOfCore_errorLimit)
+{
+    const TestDirectory directory;
+    const int gridSize = 150;
+    writeGridObj(directory.file("grid.obj"), gridSize, 10.0);
+
+    StreamingDecimationParams params;
+    params.maxVerticesPerCluster = 4000;
+
+    std::size_t previousNbVertices = gridSize * gridSize;
+    for (const double errorLimit : {0.002, 0.005})
+    {
+        params.errorLimit = errorLimit;
+        BOOST_REQUIRE(decimateMeshOutOfCore(directory.file("grid.obj"), directory.file("decimated.obj"), directory.path.string(), params));
+
+        const ObjMesh mesh = readObjMesh(directory.file("decimated.obj"));
+        BOOST_CHECK_LT(mesh.points.size(), previousNbVertices);
+        previousNbVertices = mesh.points.size();
+
+        // the collapses keep input vertices, the error is measured on the triangles:
+        // the quadrics bound the mean squared distance to the input planes, so the max deviation is only in the order of the limit
+        double maxDistance = 0.0;
+        for (const auto& t : mesh.triangles)
+        {
+            const Point3d center = (mesh.points[t[0]] + mesh.points[t[1]] + mesh.points[t[2]]) / 3.0;
+            maxDistance = std::max(maxDistance, surfaceDistance(center));
+        }
+        BOOST_CHECK_LE(maxDistance, 2.0 * errorLimit);
+
+        const MeshTopology topology = getTopology(mesh);
+        BOOST_CHECK(topology.isManifold);
+        BOOST_CHECK_EQUAL(topology.eulerCharacteristic, 1);
+        BOOST_CHECK_EQUAL(topology.nbBoundaryLoops, 1);
+    }
+    BOOST_CHECK_LT(previousNbVertices, gridSize * gridSize / 4);
+}
+
+BOOST_AUTO_TEST_CASE(meshDecimation_outOfCore_objInputOnly)
+{
+    const TestDirectory directory;
+    std::ofstream(directory.file("mesh.ply")) << "ply\n";
+
+    StreamingDecimationParams params;
+    params.simplificationFactor = 0.5;
+    BOOST_CHECK(!decimateMeshOutOfCore(directory.file("mesh.ply"), directory.file("decimated.obj"), directory.path.string(), params));
+}
@@ -5,11 +5,85 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "MeshEnergyOpt.hpp"
+#include <aliceVision/mesh/MeshAdjacency.hpp>
 #include <aliceVision/system/Logger.hpp>
 
 namespace aliceVision {
 namespace mesh {
 
+namespace {
+
+/// laplacian operator on the mesh adjacency, see MeshAnalyze::applyLaplacianOperator
+bool computeLaplacian(const MeshAdjacency& adjacency, int ptId, const StaticVector<Point3d>& ptsToApplyLaplacianOp, Point3d& ln)
+{
+    const MeshAdjacency::IndexRange ptNeighPts = adjacency.getVertexNeighbors(ptId);
+    if (ptNeighPts.empty())
+    {
+        return false;
+    }
+
+    ln = Point3d(0.0f, 0.0f, 0.0f);
+    for (const int neighPtId : ptNeighPts)
+    {
+        const Point3d& npt = ptsToApplyLaplacianOp[neighPtId];
+
+        if ((npt.x == 0.0f) && (npt.y == 0.0f) && (npt.z == 0.0f))
+        {
+            ALICEVISION_LOG_WARNING("MeshEnergyOpt::computeLaplacian: zero neighb pt");
+            return false;
+        }
+        ln = ln + npt;
+    }
+    ln = (ln / (float)ptNeighPts.size()) - ptsToApplyLaplacianOp[ptId];
+
+    Point3d n = ln;
+    float d = n.size();
+    n = n.normalize();
+    if (std::isnan(d) || std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z))  // check if is not NaN
+    {
+        ALICEVISION_LOG_WARNING("MeshEnergyOpt::computeLaplacian: nan");
+        return false;
+    }
+
+    return true;
+}
+
+/// bi-laplacian smoothing vector on the mesh adjacency, see MeshAnalyze::getBiLaplacianSmoothingVector
+bool computeBiLaplacian(const MeshAdjacency& adjacency, int ptId, const StaticVector<Point3d>& ptsLaplacian, Point3d& tp)
+{
+    if (!computeLaplacian(adjacency, ptId, ptsLaplacian, tp))
+    {
+        return false;
+    }
+
+    const MeshAdjacency::IndexRange ptNeighPts = adjacency.getVertexNeighbors(ptId);
+    if (adjacency.getVertexTriangles(ptId).empty())
+    {
+        return false;
+    }
+
+    float sum = 0.0f;
+    for (const int neighPtId : ptNeighPts)
+    {
+        const int neighValence = adjacency.getVertexNeighbors(neighPtId).size();
+        if (neighValence > 0)
+        {
+            sum += 1.0f / (float)neighValence;
+        }
+    }
+    const float v = 1.0f + (1.0f / (float)ptNeighPts.size()) * sum;
+
+    tp = Point3d(0.0f, 0.0f, 0.0f) - tp * (1.0f / v);
+
+    Point3d n = tp;
+    float d = n.size();
+    n = n.normalize();
+    // check if is not NaN
+    return !(std::isnan(d) || std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z));
+}
+
+}  // namespace
+
 MeshEnergyOpt::MeshEnergyOpt(mvsUtils::MultiViewParams* _mp)
   : MeshAnalyze(_mp)
 {
@@ -19,29 +93,30 @@ MeshEnergyOpt::MeshEnergyOpt(mvsUtils::MultiViewParams* _mp)
 
 MeshEnergyOpt::~MeshEnergyOpt() = default;
 
-void MeshEnergyOpt::computeLaplacianPtsParallel(StaticVector<Point3d>& out_lapPts)
+void MeshEnergyOpt::computeLaplacianPtsParallel(const MeshAdjacency& adjacency, StaticVector<Point3d>& out_lapPts)
 {
     out_lapPts.reserve(pts.size());
     out_lapPts.resize_with(pts.size(), Point3d(0.0f, 0.0f, 0.f));
-    int nlabpts = 0;
 
 #pragma omp parallel for
     for (int i = 0; i < pts.size(); i++)
     {
         Point3d lapPt;
-        if (getLaplacianSmoothingVector(i, lapPt))
+        if (computeLaplacian(adjacency, i, pts, lapPt))
         {
             out_lapPts[i] = lapPt;
-            nlabpts++;
         }
     }
 }
 
-void MeshEnergyOpt::updateGradientParallel(float lambda, const Point3d& LU, const Point3d& RD, StaticVectorBool& ptsCanMove)
+void MeshEnergyOpt::updateGradientParallel(const MeshAdjacency& adjacency,
+                                           float lambda,
+                                           const Point3d& LU,
+                                           const Point3d& RD,
+                                           StaticVectorBool& ptsCanMove)
 {
-    // printf("nlabpts %i of %i\n",nlabpts,pts->size());
     StaticVector<Point3d> lapPts;
-    computeLaplacianPtsParallel(lapPts);
+    computeLaplacianPtsParallel(adjacency, lapPts);
 
     StaticVector<Point3d> newPts;
     newPts.reserve(pts.size());
@@ -54,7 +129,7 @@ void MeshEnergyOpt::updateGradientParallel(float lambda, const Point3d& LU, cons
         {
             Point3d n;
 
-            if (getBiLaplacianSmoothingVector(i, lapPts, n))
+            if (computeBiLaplacian(adjacency, i, lapPts, n))
             {
                 Point3d p = newPts[i] + n * lambda;
                 if ((p.x > LU.x) && (p.y > LU.y) && (p.z > LU.z) && (p.x < RD.x) && (p.y < RD.y) && (p.z < RD.z))
@@ -93,10 +168,13 @@ bool MeshEnergyOpt::optimizeSmooth(float lambda, int niter, StaticVectorBool& pt
 
     ALICEVISION_LOG_INFO("Optimizing mesh smooth: " << std::endl << "\t- lamda: " << lambda << std::endl << "\t- niters: " << niter << std::endl);
 
+    // the topology is not modified by the smoothing
+    const MeshAdjacency adjacency(*this);
+
     for (int i = 0; i < niter; i++)
     {
         ALICEVISION_LOG_INFO("Optimizing mesh smooth: iteration " << i);
-        updateGradientParallel(lambda, LU, RD, ptsCanMove);
+        updateGradientParallel(adjacency, lambda, LU, RD, ptsCanMove);
         // if(saveDebug)
         //     save(folder + "mesh_smoothed_" + std::to_string(i));
     }
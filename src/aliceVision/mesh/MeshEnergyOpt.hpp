@@ -22,8 +22,8 @@ class MeshEnergyOpt : public MeshAnalyze
     bool optimizeSmooth(float lambda, int niter, StaticVectorBool& ptsCanMove);
 
   private:
-    void computeLaplacianPtsParallel(StaticVector<Point3d>& out_lapPts);
-    void updateGradientParallel(float lambda, const Point3d& LU, const Point3d& RD, StaticVectorBool& ptsCanMove);
+    void computeLaplacianPtsParallel(const MeshAdjacency& adjacency, StaticVector<Point3d>& out_lapPts);
+    void updateGradientParallel(const MeshAdjacency& adjacency, float lambda, const Point3d& LU, const Point3d& RD, StaticVectorBool& ptsCanMove);
 };
 
 }  // namespace mesh
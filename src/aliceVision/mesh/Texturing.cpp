@@ -16,6 +16,7 @@
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/Pixel.hpp>
 #include <aliceVision/image/imageAlgo.hpp>
+#include <aliceVision/image/cache.hpp>
 
 #include <geogram/basic/common.h>
 #include <geogram/basic/geometry_nd.h>
@@ -39,6 +40,7 @@
 
 #include <filesystem>
 #include <map>
+#include <numeric>
 #include <set>
 
 // Debug mode: save atlases decomposition in frequency bands and
@@ -167,6 +169,48 @@ Point3d barycentricToCartesian(const Point3d* triangle, const Point2d& coords)
     return triangle[0] + (triangle[2] - triangle[0]) * coords.x + (triangle[1] - triangle[0]) * coords.y;
 }
 
+namespace {
+
+/// accumulated color and weight of an atlas pixel, for one frequency band
+struct AccuPixel
+{
+    image::RGBfColor color;
+    float count;
+};
+
+/**
+ * @brief Get the triangle UV coordinates in pixels (remapped in its UDIM) and the triangle 3D coordinates.
+ */
+void getTriangleTextureCoords(const Mesh& mesh, int triangleId, unsigned int textureSide, Point2d* triPixs, Point3d* triPts)
+{
+    const Voxel& triangleUvIds = mesh.trisUvIds[triangleId];
+    const StaticVector<Point2d>& uvCoords = mesh.uvCoords;
+
+    // compute the Bottom-Left minima of the current UDIM for [0,1] range remapping
+    Point2d udimBL;
+    udimBL.x = std::floor(std::min({uvCoords[triangleUvIds.m[0]].x, uvCoords[triangleUvIds.m[1]].x, uvCoords[triangleUvIds.m[2]].x}));
+    udimBL.y = std::floor(std::min({uvCoords[triangleUvIds.m[0]].y, uvCoords[triangleUvIds.m[1]].y, uvCoords[triangleUvIds.m[2]].y}));
+
+    for (int k = 0; k < 3; ++k)
+    {
+        triPts[k] = mesh.pts[mesh.tris[triangleId].v[k]];
+        triPixs[k] = (uvCoords[triangleUvIds.m[k]] - udimBL) * textureSide;
+    }
+}
+
+/**
+ * @brief Get the triangle bounding box in pixel indexes, clamped to [0; textureSide].
+ */
+void getTriangleBoundingBox(const Point2d* triPixs, int textureSide, Pixel& LU, Pixel& RD)
+{
+    LU.x = clamp(static_cast<int>(std::floor(std::min({triPixs[0].x, triPixs[1].x, triPixs[2].x}))), 0, textureSide);
+    LU.y = clamp(static_cast<int>(std::floor(std::min({triPixs[0].y, triPixs[1].y, triPixs[2].y}))), 0, textureSide);
+    RD.x = clamp(static_cast<int>(std::ceil(std::max({triPixs[0].x, triPixs[1].x, triPixs[2].x}))), 0, textureSide);
+    RD.y = clamp(static_cast<int>(std::ceil(std::max({triPixs[0].y, triPixs[1].y, triPixs[2].y}))), 0, textureSide);
+}
+
+}  // namespace
+
 inline GEO::vec3 mesh_facet_interpolate_normal_at_point(const GEO::Mesh& mesh, GEO::index_t f, const GEO::vec3& p)
 {
     const GEO::index_t v0 = mesh.facets.vertex(f, 0);
@@ -436,6 +480,14 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
     const int availableMem =
       availableRam - 2 * (imagePyramidMaxMemSize + imageMaxMemSize);  // keep some memory for the 2 input images in cache and one laplacian pyramid
 
+    if (texParams.outOfCoreAtlases)
+    {
+        ALICEVISION_LOG_INFO("Total amount of available RAM: " << availableRam << " MB.");
+        ALICEVISION_LOG_INFO("Total amount of memory remaining for the computation: " << availableMem << " MB.");
+        generateTexturesOutOfCore(mp, imageCache, outPath, std::size_t(std::max(0, availableMem)) << 20, textureFileType, imageType);
+        return;
+    }
+
     const int nbAtlas = _atlases.size();
     // Memory needed to process each attlas = input + input pyramid + output atlas pyramid
     const int memoryPerAtlas = (imageMaxMemSize + imagePyramidMaxMemSize) + atlasPyramidMaxMemSize;
@@ -485,23 +537,12 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
     }
 }
 
-void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
-                                       const std::vector<size_t>& atlasIDs,
-                                       mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
-                                       const fs::path& outPath,
-                                       image::EImageFileType textureFileType,
-                                       mvsUtils::EFileType imageType)
+void Texturing::computeContributionsPerCamera(const mvsUtils::MultiViewParams& mp,
+                                              const std::vector<size_t>& atlasIDs,
+                                              std::vector<CameraContributions>& out_contributionsPerCamera) const
 {
-    if (atlasIDs.size() > _atlases.size())
-        throw std::runtime_error("Invalid atlas IDs ");
-
-    unsigned int textureSize = texParams.textureSide * texParams.textureSide;
-
-    // We select the best cameras for each triangle and store it per camera for each output texture files.
     // Triangles contributions are stored per frequency bands for multi-band blending.
-    using AtlasIndex = size_t;
-    using ScorePerTriangle = std::vector<std::pair<unsigned int, float>>;  // list of <triangleId, score>
-    std::vector<std::map<AtlasIndex, std::vector<ScorePerTriangle>>> contributionsPerCamera(mp.ncams);
+    out_contributionsPerCamera.assign(mp.ncams, CameraContributions());
 
     // for each atlasID, calculate contributionPerCamera
     for (const size_t atlasID : atlasIDs)
@@ -617,7 +658,7 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
                 // for the camera camId : add triangle score to the corresponding texture, at the right frequency band
                 const int camId = std::get<2>(scorePerCamId[contrib]);
                 const int triangleScore = std::get<1>(scorePerCamId[contrib]);
-                auto& camContribution = contributionsPerCamera[camId];
+                auto& camContribution = out_contributionsPerCamera[camId];
                 if (camContribution.find(atlasID) == camContribution.end())
                     camContribution[atlasID].resize(texParams.nbBand);
                 camContribution.at(atlasID)[band].emplace_back(triangleID, triangleScore);
@@ -629,6 +670,23 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
             }
         }
     }
+}
+
+void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
+                                       const std::vector<size_t>& atlasIDs,
+                                       mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
+                                       const fs::path& outPath,
+                                       image::EImageFileType textureFileType,
+                                       mvsUtils::EFileType imageType)
+{
+    if (atlasIDs.size() > _atlases.size())
+        throw std::runtime_error("Invalid atlas IDs ");
+
+    unsigned int textureSize = texParams.textureSide * texParams.textureSide;
+
+    // We select the best cameras for each triangle and store it per camera for each output texture files.
+    std::vector<CameraContributions> contributionsPerCamera;
+    computeContributionsPerCamera(mp, atlasIDs, contributionsPerCamera);
 
     ALICEVISION_LOG_INFO("Reading pixel color.");
 
@@ -640,7 +698,7 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
     // for each camera, for each texture, iterate over triangles and fill the accuPyramids map
     for (int camId = 0; camId < contributionsPerCamera.size(); ++camId)
     {
-        const std::map<AtlasIndex, std::vector<ScorePerTriangle>>& cameraContributions = contributionsPerCamera[camId];
+        const CameraContributions& cameraContributions = contributionsPerCamera[camId];
 
         if (cameraContributions.empty())
         {
@@ -678,40 +736,9 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
                     // retrieve triangle 3D and UV coordinates
                     Point2d triPixs[3];
                     Point3d triPts[3];
-                    auto& triangleUvIds = mesh->trisUvIds[triangleId];
-                    // compute the Bottom-Left minima of the current UDIM for [0,1] range remapping
-                    Point2d udimBL;
-                    StaticVector<Point2d>& uvCoords = mesh->uvCoords;
-                    udimBL.x = std::floor(std::min({uvCoords[triangleUvIds[0]].x, uvCoords[triangleUvIds[1]].x, uvCoords[triangleUvIds[2]].x}));
-                    udimBL.y = std::floor(std::min({uvCoords[triangleUvIds[0]].y, uvCoords[triangleUvIds[1]].y, uvCoords[triangleUvIds[2]].y}));
-
-                    for (int k = 0; k < 3; ++k)
-                    {
-                        const int pointIndex = mesh->tris[triangleId].v[k];
-                        triPts[k] = mesh->pts[pointIndex];  // 3D coordinates
-                        const int uvPointIndex = triangleUvIds.m[k];
-                        Point2d uv = uvCoords[uvPointIndex];
-                        // UDIM: remap coordinates between [0,1]
-                        uv = uv - udimBL;
-
-                        triPixs[k] = uv * texParams.textureSide;  // UV coordinates
-                    }
-
-                    // compute triangle bounding box in pixel indexes
-                    // min values: floor(value)
-                    // max values: ceil(value)
                     Pixel LU, RD;
-                    LU.x = static_cast<int>(std::floor(std::min({triPixs[0].x, triPixs[1].x, triPixs[2].x})));
-                    LU.y = static_cast<int>(std::floor(std::min({triPixs[0].y, triPixs[1].y, triPixs[2].y})));
-                    RD.x = static_cast<int>(std::ceil(std::max({triPixs[0].x, triPixs[1].x, triPixs[2].x})));
-                    RD.y = static_cast<int>(std::ceil(std::max({triPixs[0].y, triPixs[1].y, triPixs[2].y})));
-
-                    // sanity check: clamp values to [0; textureSide]
-                    int texSide = static_cast<int>(texParams.textureSide);
-                    LU.x = clamp(LU.x, 0, texSide);
-                    LU.y = clamp(LU.y, 0, texSide);
-                    RD.x = clamp(RD.x, 0, texSide);
-                    RD.y = clamp(RD.y, 0, texSide);
+                    getTriangleTextureCoords(*mesh, triangleId, texParams.textureSide, triPixs, triPts);
+                    getTriangleBoundingBox(triPixs, static_cast<int>(texParams.textureSide), LU, RD);
 
                     // iterate over pixels of the triangle's bounding box
                     for (int y = LU.y; y < RD.y; ++y)
@@ -860,114 +887,358 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
             }
         }
 
-        // If mode "normalMaps"
-        if (imageType == mvsUtils::EFileType::normalMap)
+        finalizeTexture(atlasTexture, atlasID, outPath, textureFileType, imageType);
+    }
+}
+
+void Texturing::generateTexturesOutOfCore(const mvsUtils::MultiViewParams& mp,
+                                          mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
+                                          const fs::path& outPath,
+                                          size_t memoryAvailable,
+                                          image::EImageFileType textureFileType,
+                                          mvsUtils::EFileType imageType)
+{
+    const int nbAtlas = _atlases.size();
+    const int texSide = static_cast<int>(texParams.textureSide);
+    const int nbLevels = texParams.nbBand;
+
+    // atlases are split into square tiles, each tile stores all the frequency bands of its pixels
+    const int tileSide = 256;
+    const int nbTilesPerSide = divideRoundUp(texSide, tileSide);
+    const std::size_t nbTilesPerAtlas = std::size_t(nbTilesPerSide) * nbTilesPerSide;
+    const std::size_t tileNbPixels = std::size_t(tileSide) * tileSide;
+    const std::size_t tileMemSize = tileNbPixels * nbLevels * sizeof(AccuPixel);
+
+    // keep memory for one full resolution atlas texture (final color)
+    const std::size_t atlasMemSize = std::size_t(texSide) * texSide * (sizeof(image::RGBfColor) + sizeof(float));
+    const std::size_t minNbTilesInCore = 16;
+    const std::size_t maxNbTilesInCore =
+      std::max(minNbTilesInCore, (memoryAvailable > atlasMemSize ? memoryAvailable - atlasMemSize : std::size_t(0)) / tileMemSize);
+
+    image::TileCacheManager::shared_ptr cacheManager = image::TileCacheManager::create(outPath.string(), tileSide, tileSide, 64 * nbLevels * sizeof(AccuPixel));
+    if (!cacheManager)
+        throw std::runtime_error("Failed to create the atlases tiles cache manager.");
+    cacheManager->setMaxMemory(maxNbTilesInCore * tileMemSize);
+
+    ALICEVISION_LOG_INFO("Processing " << nbAtlas << " atlases in " << nbTilesPerAtlas << " tiles per atlas (" << tileMemSize / std::pow(2, 20)
+                                       << " MB per tile, " << maxNbTilesInCore << " tiles in memory).");
+
+    // tiles are created on the first contribution
+    std::vector<image::CachedTile::smart_pointer> tiles(nbAtlas * nbTilesPerAtlas);
+
+    // get the tile data, the cache manager is not thread safe
+    const auto acquireTile = [&](std::size_t tileIndex) -> AccuPixel* {
+        image::CachedTile::smart_pointer& tile = tiles[tileIndex];
+        const bool isNewTile = (tile == nullptr);
+
+        if (isNewTile)
         {
-            Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> visitedPixels(atlasTexture.img.rows(), atlasTexture.img.cols());
-            visitedPixels.fill(false);
+            const int tileX = int(tileIndex % nbTilesPerAtlas) % nbTilesPerSide;
+            const int tileY = int(tileIndex % nbTilesPerAtlas) / nbTilesPerSide;
+            tile = cacheManager->requireNewCachedTile(std::min(tileSide, texSide - tileX * tileSide),
+                                                      std::min(tileSide, texSide - tileY * tileSide),
+                                                      nbLevels * sizeof(AccuPixel));
+        }
 
-            // Rotation and normalization of normals
-#pragma omp parallel for
-            for (int i = 0; i < static_cast<int>(_atlases[atlasID].size()); ++i)
-            {
-                int triangleId = _atlases[atlasID][i];
+        if (tile == nullptr || !tile->acquire())
+            throw std::runtime_error("Failed to acquire atlas tile " + std::to_string(tileIndex) + ".");
 
-                // Retrieve triangle 3D and UV coordinates
-                Point2d triPixs[3];
-                Point3d triPts[3];
-                auto& triangleUvIds = mesh->trisUvIds[triangleId];
+        AccuPixel* tileData = reinterpret_cast<AccuPixel*>(tile->getDataPointer());
+        if (isNewTile)
+            std::fill(tileData, tileData + tileNbPixels * nbLevels, AccuPixel{image::RGBfColor(0.f, 0.f, 0.f), 0.f});
+        return tileData;
+    };
 
-                // Retrieve triangle normal
+    std::vector<size_t> atlasIDs(nbAtlas);
+    std::iota(atlasIDs.begin(), atlasIDs.end(), 0);
 
-                // Compute the Bottom-Left minima of the current UDIM for [0,1] range remapping
-                Point2d udimBL;
-                StaticVector<Point2d>& uvCoords = mesh->uvCoords;
-                udimBL.x = std::floor(std::min({uvCoords[triangleUvIds[0]].x, uvCoords[triangleUvIds[1]].x, uvCoords[triangleUvIds[2]].x}));
-                udimBL.y = std::floor(std::min({uvCoords[triangleUvIds[0]].y, uvCoords[triangleUvIds[1]].y, uvCoords[triangleUvIds[2]].y}));
+    std::vector<CameraContributions> contributionsPerCamera;
+    computeContributionsPerCamera(mp, atlasIDs, contributionsPerCamera);
 
-                for (int k = 0; k < 3; k++)
-                {
-                    const int pointIndex = (mesh->tris)[triangleId].v[k];
-                    triPts[k] = (mesh->pts)[pointIndex];  // 3D coordinates
-                    const int uvPointIndex = triangleUvIds.m[k];
+    ALICEVISION_LOG_INFO("Reading pixel color.");
 
-                    Point2d uv = uvCoords[uvPointIndex];
-                    // UDIM: remap coordinates between [0,1]
-                    uv = uv - udimBL;
+    // contribution of a triangle to a tile
+    struct TileContribution
+    {
+        std::size_t tileIndex;
+        int band;
+        unsigned int triangleId;
+        float score;
+    };
+    std::vector<TileContribution> tileContributions;
+    std::vector<std::size_t> tilesBegin;
+    std::vector<AccuPixel*> tilesData;
+
+    for (int camId = 0; camId < mp.ncams; ++camId)
+    {
+        const CameraContributions& cameraContributions = contributionsPerCamera[camId];
 
-                    triPixs[k] = uv * texParams.textureSide;  // UV coordinates
-                }
+        if (cameraContributions.empty())
+        {
+            ALICEVISION_LOG_INFO("- camera " << mp.getViewId(camId) << " (" << camId + 1 << "/" << mp.ncams << ") unused.");
+            continue;
+        }
 
-                // compute triangle bounding box in pixel indexes
-                // min values: floor(value)
-                // max values: ceil(value)
-                Pixel LU, RD;
-                LU.x = static_cast<int>(std::floor(std::min({triPixs[0].x, triPixs[1].x, triPixs[2].x})));
-                LU.y = static_cast<int>(std::floor(std::min({triPixs[0].y, triPixs[1].y, triPixs[2].y})));
-                RD.x = static_cast<int>(std::ceil(std::max({triPixs[0].x, triPixs[1].x, triPixs[2].x})));
-                RD.y = static_cast<int>(std::ceil(std::max({triPixs[0].y, triPixs[1].y, triPixs[2].y})));
-
-                // sanity check: clamp values to [0; textureSide]
-                int texSide = static_cast<int>(texParams.textureSide);
-                LU.x = clamp(LU.x, 0, texSide);
-                LU.y = clamp(LU.y, 0, texSide);
-                RD.x = clamp(RD.x, 0, texSide);
-                RD.y = clamp(RD.y, 0, texSide);
-
-                const Eigen::Matrix3d worldToTriangleMatrix = computeTriangleTransform(*mesh, triangleId, triPixs);
-
-                // iterate over bounding box's pixels
-                for (int y = LU.y; y < RD.y; ++y)
+        // dispatch the camera triangles contributions to the atlases tiles
+        tileContributions.clear();
+        for (const auto& c : cameraContributions)
+        {
+            const AtlasIndex atlasID = c.first;
+            for (int band = 0; band < int(c.second.size()); ++band)
+            {
+                for (const auto& triangleScore : c.second[band])
                 {
-                    for (int x = LU.x; x < RD.x; ++x)
-                    {
-                        Pixel pix(x, y);  // top-left corner of the pixel
-                        Point2d barycCoords;
+                    Point2d triPixs[3];
+                    Point3d triPts[3];
+                    Pixel LU, RD;
+                    getTriangleTextureCoords(*mesh, triangleScore.first, texParams.textureSide, triPixs, triPts);
+                    getTriangleBoundingBox(triPixs, texSide, LU, RD);
+
+                    if (LU.x >= RD.x || LU.y >= RD.y)
+                        continue;
 
-                        // test if the pixel is inside triangle
-                        // and retrieve its barycentric coordinates
-                        const double margin = 0.5;
-                        if (!isPixelInTriangle(triPixs, pix, barycCoords, margin))
+                    const float score = texParams.useScore ? triangleScore.second : 1.0f;
+                    for (int tileY = LU.y / tileSide; tileY <= (RD.y - 1) / tileSide; ++tileY)
+                    {
+                        for (int tileX = LU.x / tileSide; tileX <= (RD.x - 1) / tileSide; ++tileX)
                         {
-                            continue;
+                            const std::size_t tileIndex = atlasID * nbTilesPerAtlas + std::size_t(tileY) * nbTilesPerSide + tileX;
+                            tileContributions.push_back({tileIndex, band, triangleScore.first, score});
                         }
+                    }
+                }
+            }
+        }
+
+        // group the contributions per tile, keep the contributions order in each tile
+        std::stable_sort(tileContributions.begin(), tileContributions.end(), [](const TileContribution& a, const TileContribution& b) {
+            return a.tileIndex < b.tileIndex;
+        });
+
+        tilesBegin.clear();
+        for (std::size_t i = 0; i < tileContributions.size(); ++i)
+        {
+            if (i == 0 || tileContributions[i].tileIndex != tileContributions[i - 1].tileIndex)
+                tilesBegin.push_back(i);
+        }
+        const int nbTiles = tilesBegin.size();
+        tilesBegin.push_back(tileContributions.size());
+
+        ALICEVISION_LOG_INFO("- camera " << mp.getViewId(camId) << " (" << camId + 1 << "/" << mp.ncams << ") with contributions to "
+                                         << cameraContributions.size() << " texture files (" << nbTiles << " tiles).");
 
-                        // remap 'y' to image coordinates system (inverted Y axis)
-                        const unsigned int y_ = (texParams.textureSide - 1) - y;
-                        // 1D pixel index
-                        const unsigned int xyoffset = y_ * texParams.textureSide + x;
+        // Load camera image from cache
+        auto imgPtr = imageCache.getImg_sync(camId);
+        const image::Image<image::RGBfColor>& camImg = *imgPtr;
+
+        // Calculate laplacianPyramid
+        std::vector<image::Image<image::RGBfColor>> pyramidL;  // laplacian pyramid
+        imageAlgo::laplacianPyramid(pyramidL, camImg, texParams.nbBand, texParams.multiBandDownscale);
+        const int nbImageLevels = std::min(nbLevels, int(pyramidL.size()));
+
+        // process the tiles by batches fitting in memory
+        for (int batchBegin = 0; batchBegin < nbTiles; batchBegin += int(maxNbTilesInCore))
+        {
+            const int batchEnd = std::min(nbTiles, batchBegin + int(maxNbTilesInCore));
 
-                        /*
-                        // get 3D coordinates
-                        const Point3d pt3d = barycentricToCartesian(triPts, barycCoords);
-                        const GEO::vec3 q(pt3d.x, pt3d.y, pt3d.z);
+            tilesData.resize(batchEnd - batchBegin);
+            for (int t = batchBegin; t < batchEnd; ++t)
+                tilesData[t - batchBegin] = acquireTile(tileContributions[tilesBegin[t]].tileIndex);
 
-                        // Texel normal (weighted normal from the 3 vertices normals), instead of face normal for better
-                        // transitions (reduce seams)
-                        const GEO::vec3 triangleNormal_p = mesh_facet_interpolate_normal_at_point(sparseMesh, triangleId, q);
-                        // const GEO::vec3 triangleNormal_p = GEO::vec3(triangleNormal.m); // to use the triangle normal instead
-                        const GEO::vec3 scaledTriangleNormal = triangleNormal_p * minEdgeLength * 10; // ??????
+            // tiles are independent, each tile is filled by a single thread
+#pragma omp parallel for schedule(dynamic)
+            for (int t = batchBegin; t < batchEnd; ++t)
+            {
+                AccuPixel* tileData = tilesData[t - batchBegin];
+                const std::size_t tileIndexInAtlas = tileContributions[tilesBegin[t]].tileIndex % nbTilesPerAtlas;
+                const int tileX0 = int(tileIndexInAtlas % nbTilesPerSide) * tileSide;
+                const int tileY0 = int(tileIndexInAtlas / nbTilesPerSide) * tileSide;
 
-                        */
+                for (std::size_t i = tilesBegin[t]; i < tilesBegin[t + 1]; ++i)
+                {
+                    const TileContribution& contribution = tileContributions[i];
 
-                        Vec3 origNormal = atlasTexture.img(xyoffset).cast<double>();
-                        if (visitedPixels(x, y))
+                    // retrieve triangle 3D and UV coordinates
+                    Point2d triPixs[3];
+                    Point3d triPts[3];
+                    Pixel LU, RD;
+                    getTriangleTextureCoords(*mesh, contribution.triangleId, texParams.textureSide, triPixs, triPts);
+                    getTriangleBoundingBox(triPixs, texSide, LU, RD);
+
+                    // iterate over pixels of the triangle's bounding box in the tile
+                    const int yEnd = std::min(RD.y, tileY0 + tileSide);
+                    const int xEnd = std::min(RD.x, tileX0 + tileSide);
+                    for (int y = std::max(LU.y, tileY0); y < yEnd; ++y)
+                    {
+                        for (int x = std::max(LU.x, tileX0); x < xEnd; ++x)
                         {
-                            continue;
+                            Pixel pix(x, y);  // top-left corner of the pixel
+                            Point2d barycCoords;
+
+                            // test if the pixel is inside triangle
+                            // and retrieve its barycentric coordinates
+                            if (!isPixelInTriangle(triPixs, pix, barycCoords))
+                                continue;
+
+                            // get 2D coordinates in source image
+                            const Point3d pt3d = barycentricToCartesian(triPts, barycCoords);
+                            Point2d pixRC;
+                            mp.getPixelFor3DPoint(&pixRC, pt3d, camId);
+                            // exclude out of bounds pixels
+                            if (!mp.isPixelInImage(pixRC, camId))
+                                continue;
+
+                            // If the color is pure zero (ie. no contributions), we consider it as an invalid pixel.
+                            if (getInterpolateColor(camImg, pixRC.y, pixRC.x) == image::RGBfColor(0.f, 0.f, 0.f))
+                                continue;
+
+                            // each frequency band also contributes to lower frequencies (higher band indexes)
+                            AccuPixel* pixelLevels = tileData + std::size_t(y - tileY0) * tileSide + (x - tileX0);
+                            for (int level = contribution.band; level < nbImageLevels; ++level)
+                            {
+                                const int downscaleCoef = std::pow(texParams.multiBandDownscale, level);
+                                const auto pixDownscaled = pixRC / downscaleCoef;
+                                AccuPixel& accuPixel = pixelLevels[level * tileNbPixels];
+                                accuPixel.color += getInterpolateColor(pyramidL[level], pixDownscaled.y, pixDownscaled.x) * contribution.score;
+                                accuPixel.count += contribution.score;
+                            }
                         }
-                        visitedPixels(x, y) = true;
+                    }
+                }
+            }
+        }
+    }
 
-                        origNormal = worldToTriangleMatrix * origNormal;
-                        origNormal.normalize();
+    for (int atlasID = 0; atlasID < nbAtlas; ++atlasID)
+    {
+        ALICEVISION_LOG_INFO("Create texture " << atlasID + 1);
+
+        AccuImage atlasTexture;
+        atlasTexture.resize(texSide, texSide);
+
+        ALICEVISION_LOG_INFO("  - Computing final (average) color.");
+        for (std::size_t tileIndexInAtlas = 0; tileIndexInAtlas < nbTilesPerAtlas; ++tileIndexInAtlas)
+        {
+            const std::size_t tileIndex = atlasID * nbTilesPerAtlas + tileIndexInAtlas;
+            if (tiles[tileIndex] == nullptr)
+                continue;  // no contribution
 
-                        origNormal = origNormal * 0.5 + Vec3(0.5, 0.5, 0.5);  // Normal in visual representation
-                        atlasTexture.img(xyoffset) = image::RGBfColor(origNormal[0], origNormal[1], origNormal[2]);
+            const AccuPixel* tileData = acquireTile(tileIndex);
+            const int tileX0 = int(tileIndexInAtlas % nbTilesPerSide) * tileSide;
+            const int tileY0 = int(tileIndexInAtlas / nbTilesPerSide) * tileSide;
+            const int yEnd = std::min(texSide, tileY0 + tileSide);
+            const int xEnd = std::min(texSide, tileX0 + tileSide);
+
+#pragma omp parallel for
+            for (int y = tileY0; y < yEnd; ++y)
+            {
+                // remap 'y' to image coordinates system (inverted Y axis)
+                const unsigned int yoffset = ((texSide - 1) - y) * texSide;
+                for (int x = tileX0; x < xEnd; ++x)
+                {
+                    const AccuPixel* pixelLevels = tileData + std::size_t(y - tileY0) * tileSide + (x - tileX0);
+                    const unsigned int xyoffset = yoffset + x;
+
+                    // average each frequency band and fuse them,
+                    // if the count is valid on the first band, it will be valid on all the other bands
+                    const bool isValid = (pixelLevels[0].count != 0);
+                    image::RGBfColor color(0.f, 0.f, 0.f);
+                    for (int level = 0; level < nbLevels; ++level)
+                    {
+                        const AccuPixel& accuPixel = pixelLevels[level * tileNbPixels];
+                        color += isValid ? accuPixel.color / accuPixel.count : accuPixel.color;
                     }
+                    atlasTexture.img(xyoffset) = color;
+                    atlasTexture.imgCount[xyoffset] = isValid ? 1.f : 0.f;
+                }
+            }
+
+            // release the tile memory and disk space
+            tiles[tileIndex].reset();
+        }
+
+        finalizeTexture(atlasTexture, atlasID, outPath, textureFileType, imageType);
+    }
+}
+
+void Texturing::finalizeTexture(AccuImage& atlasTexture,
+                                const std::size_t atlasID,
+                                const fs::path& outPath,
+                                image::EImageFileType textureFileType,
+                                mvsUtils::EFileType imageType)
+{
+    // If mode "normalMaps"
+    if (imageType == mvsUtils::EFileType::normalMap)
+    {
+        Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> visitedPixels(atlasTexture.img.rows(), atlasTexture.img.cols());
+        visitedPixels.fill(false);
+
+        // Rotation and normalization of normals
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(_atlases[atlasID].size()); ++i)
+        {
+            int triangleId = _atlases[atlasID][i];
+
+            // Retrieve triangle 3D and UV coordinates
+            Point2d triPixs[3];
+            Point3d triPts[3];
+            Pixel LU, RD;
+            getTriangleTextureCoords(*mesh, triangleId, texParams.textureSide, triPixs, triPts);
+            getTriangleBoundingBox(triPixs, static_cast<int>(texParams.textureSide), LU, RD);
+
+            const Eigen::Matrix3d worldToTriangleMatrix = computeTriangleTransform(*mesh, triangleId, triPixs);
+
+            // iterate over bounding box's pixels
+            for (int y = LU.y; y < RD.y; ++y)
+            {
+                for (int x = LU.x; x < RD.x; ++x)
+                {
+                    Pixel pix(x, y);  // top-left corner of the pixel
+                    Point2d barycCoords;
+
+                    // test if the pixel is inside triangle
+                    // and retrieve its barycentric coordinates
+                    const double margin = 0.5;
+                    if (!isPixelInTriangle(triPixs, pix, barycCoords, margin))
+                    {
+                        continue;
+                    }
+
+                    // remap 'y' to image coordinates system (inverted Y axis)
+                    const unsigned int y_ = (texParams.textureSide - 1) - y;
+                    // 1D pixel index
+                    const unsigned int xyoffset = y_ * texParams.textureSide + x;
+
+                    /*
+                    // get 3D coordinates
+                    const Point3d pt3d = barycentricToCartesian(triPts, barycCoords);
+                    const GEO::vec3 q(pt3d.x, pt3d.y, pt3d.z);
+
+                    // Texel normal (weighted normal from the 3 vertices normals), instead of face normal for better
+                    // transitions (reduce seams)
+                    const GEO::vec3 triangleNormal_p = mesh_facet_interpolate_normal_at_point(sparseMesh, triangleId, q);
+                    // const GEO::vec3 triangleNormal_p = GEO::vec3(triangleNormal.m); // to use the triangle normal instead
+                    const GEO::vec3 scaledTriangleNormal = triangleNormal_p * minEdgeLength * 10; // ??????
+
+                    */
+
+                    Vec3 origNormal = atlasTexture.img(xyoffset).cast<double>();
+                    if (visitedPixels(x, y))
+                    {
+                        continue;
+                    }
+                    visitedPixels(x, y) = true;
+
+                    origNormal = worldToTriangleMatrix * origNormal;
+                    origNormal.normalize();
+
+                    origNormal = origNormal * 0.5 + Vec3(0.5, 0.5, 0.5);  // Normal in visual representation
+                    atlasTexture.img(xyoffset) = image::RGBfColor(origNormal[0], origNormal[1], origNormal[2]);
                 }
             }
         }
-        writeTexture(atlasTexture, atlasID, outPath, textureFileType, -1, imageType);
     }
+    writeTexture(atlasTexture, atlasID, outPath, textureFileType, -1, imageType);
 }
 
 void Texturing::generateNormalAndHeightMaps(const mvsUtils::MultiViewParams& mp,
@@ -19,6 +19,7 @@
 #include <aliceVision/stl/bitmask.hpp>
 
 #include <filesystem>
+#include <map>
 
 namespace fs = std::filesystem;
 
@@ -98,6 +99,8 @@ struct TexturingParams
     EVisibilityRemappingMethod visibilityRemappingMethod = EVisibilityRemappingMethod::PullPush;
 
     float subdivisionTargetRatio = 0.8;
+
+    bool outOfCoreAtlases = false;  //< read each image once and accumulate all the atlases in tiles spilled to disk
 };
 
 struct Texturing
@@ -192,6 +195,10 @@ struct Texturing
         }
     };
 
+    using AtlasIndex = size_t;
+    using ScorePerTriangle = std::vector<std::pair<unsigned int, float>>;  // list of <triangleId, score>
+    using CameraContributions = std::map<AtlasIndex, std::vector<ScorePerTriangle>>;  // triangles scores per atlas and per frequency band
+
     /// Generate texture files for all texture atlases
     void generateTextures(const mvsUtils::MultiViewParams& mp,
                           const fs::path& outPath,
@@ -207,6 +214,25 @@ struct Texturing
                                 image::EImageFileType textureFileType = image::EImageFileType::PNG,
                                 mvsUtils::EFileType imageType = mvsUtils::EFileType::none);
 
+    /**
+     * @brief Generate texture files for all texture atlases, reading each image only once.
+     * @note Each image contributes to all the atlases at once, the atlases frequency bands are accumulated
+     *       in tiles managed by an image::TileCacheManager, which are spilled to disk if needed.
+     *       Tiles touched by an image are filled in parallel.
+     * @param[in] memoryAvailable the memory available for the atlases (in bytes)
+     */
+    void generateTexturesOutOfCore(const mvsUtils::MultiViewParams& mp,
+                                   mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
+                                   const fs::path& outPath,
+                                   size_t memoryAvailable,
+                                   image::EImageFileType textureFileType = image::EImageFileType::PNG,
+                                   mvsUtils::EFileType imageType = mvsUtils::EFileType::none);
+
+    /// Select the best cameras for each triangle of the given atlases and store the triangles scores per camera
+    void computeContributionsPerCamera(const mvsUtils::MultiViewParams& mp,
+                                       const std::vector<size_t>& atlasIDs,
+                                       std::vector<CameraContributions>& out_contributionsPerCamera) const;
+
     void generateNormalAndHeightMaps(const mvsUtils::MultiViewParams& mp,
                                      const Mesh& denseMesh,
                                      const fs::path& outPath,
@@ -220,6 +246,13 @@ struct Texturing
                                       const fs::path& outPath,
                                       const mesh::BumpMappingParams& bumpMappingParams);
 
+    /// Convert normals to the triangles frames if needed, fill holes and write texture files for the given texture atlas
+    void finalizeTexture(AccuImage& atlasTexture,
+                         const std::size_t atlasID,
+                         const fs::path& outPath,
+                         image::EImageFileType textureFileType,
+                         mvsUtils::EFileType imageType = mvsUtils::EFileType::none);
+
     /// Fill holes and write texture files for the given texture atlas
     void writeTexture(AccuImage& atlasTexture,
                       const std::size_t atlasID,
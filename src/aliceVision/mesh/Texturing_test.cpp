@@ -0,0 +1,165 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mesh/Texturing.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/image/io.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#define BOOST_TEST_MODULE texturing
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const int imageWidth = 640;
+const int imageHeight = 480;
+
+/// views looking at the plane z=0, with a procedural image per view
+sfmData::SfMData createSfmData(const fs::path& directory)
+{
+    sfmData::SfMData sfmData;
+    sfmData.getIntrinsics().emplace(0,
+                                    camera::createPinhole(camera::EDISTORTION::DISTORTION_NONE,
+                                                          camera::EUNDISTORTION::UNDISTORTION_NONE,
+                                                          imageWidth,
+                                                          imageHeight,
+                                                          500.0,
+                                                          500.0,
+                                                          0.0,
+                                                          0.0));
+
+    const std::vector<Vec3> centers = {Vec3(-0.4, 0.1, 3.0), Vec3(0.5, -0.2, 3.5)};
+    for (IndexT viewId = 0; viewId < centers.size(); ++viewId)
+    {
+        image::Image<image::RGBfColor> img(imageWidth, imageHeight);
+        for (int y = 0; y < imageHeight; ++y)
+        {
+            for (int x = 0; x < imageWidth; ++x)
+            {
+                img(y, x) = image::RGBfColor(0.5f + 0.4f * std::sin(0.05f * x + viewId),
+                                             0.5f + 0.4f * std::cos(0.03f * y),
+                                             0.5f + 0.4f * std::sin(0.02f * (x + y)));
+            }
+        }
+        const std::string imagePath = (directory / ("view_" + std::to_string(viewId) + ".exr")).string();
+        image::writeImage(imagePath, img, image::ImageWriteOptions());
+
+        sfmData.getViews().emplace(viewId, std::make_shared<sfmData::View>(imagePath, viewId, 0, viewId, imageWidth, imageHeight));
+        const geometry::Pose3 pose(LookAt(-centers[viewId]), centers[viewId]);
+        sfmData.setPose(*sfmData.getViews().at(viewId), sfmData::CameraPose(pose));
+    }
+    return sfmData;
+}
+
+/// a UV mapped grid on the plane z=0, seen by all the cameras
+Mesh* createPlaneMesh(int gridSize, int nbCameras)
+{
+    Mesh* mesh = new Mesh();
+    StaticVector<int> cameras;
+    for (int camId = 0; camId < nbCameras; ++camId)
+        cameras.push_back(camId);
+
+    for (int j = 0; j < gridSize; ++j)
+    {
+        for (int i = 0; i < gridSize; ++i)
+        {
+            const double u = i / double(gridSize - 1);
+            const double v = j / double(gridSize - 1);
+            mesh->pts.push_back(Point3d(2.0 * u - 1.0, 2.0 * v - 1.0, 0.0));
+            mesh->uvCoords.push_back(Point2d(u, v));
+            mesh->pointsVisibilities.push_back(cameras);
+        }
+    }
+    for (int j = 0; j + 1 < gridSize; ++j)
+    {
+        for (int i = 0; i + 1 < gridSize; ++i)
+        {
+            const int p = j * gridSize + i;
+            for (const Mesh::triangle& t : {Mesh::triangle(p, p + 1, p + gridSize + 1), Mesh::triangle(p, p + gridSize + 1, p + gridSize)})
+            {
+                mesh->tris.push_back(t);
+                mesh->trisUvIds.push_back(Voxel(t.v[0], t.v[1], t.v[2]));
+                mesh->trisMtlIds().push_back(0);
+            }
+        }
+    }
+    return mesh;
+}
+
+image::Image<image::RGBfColor> generateTexture(const mvsUtils::MultiViewParams& mp, const fs::path& outPath, bool outOfCoreAtlases)
+{
+    fs::create_directories(outPath);
+
+    Texturing texturing;
+    texturing.texParams.textureSide = 1536;
+    texturing.texParams.outOfCoreAtlases = outOfCoreAtlases;
+    texturing.mesh = createPlaneMesh(20, mp.getNbCameras());
+    texturing.updateAtlases();
+
+    // the out-of-core atlases have 36 tiles of 256 pixels, keep the minimum number of tiles in memory to spill some of them to disk
+    const std::size_t memoryAvailable = outOfCoreAtlases ? std::size_t(1) << 20 : std::size_t(16) << 30;
+    texturing.generateTextures(mp, outPath, memoryAvailable, image::EImageFileType::EXR);
+
+    const std::string textureName = texturing.material.textureName(Material::TextureType::DIFFUSE, 0);
+    image::Image<image::RGBfColor> texture;
+    image::readImage((outPath / textureName).string(), texture, image::EImageColorSpace::NO_CONVERSION);
+    return texture;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(texturing_outOfCoreAtlases)
+{
+    const fs::path directory = fs::temp_directory_path() / "texturing_test";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    const sfmData::SfMData sfmData = createSfmData(directory);
+    const mvsUtils::MultiViewParams mp(sfmData);
+    BOOST_REQUIRE_EQUAL(mp.getNbCameras(), 2);
+
+    const image::Image<image::RGBfColor> inCoreTexture = generateTexture(mp, directory / "inCore", false);
+    const image::Image<image::RGBfColor> outOfCoreTexture = generateTexture(mp, directory / "outOfCore", true);
+
+    BOOST_REQUIRE_EQUAL(inCoreTexture.width(), 1536);
+    BOOST_REQUIRE_EQUAL(outOfCoreTexture.width(), inCoreTexture.width());
+    BOOST_REQUIRE_EQUAL(outOfCoreTexture.height(), inCoreTexture.height());
+
+    // same contributions, only the float accumulation order and the half storage differ
+    double maxDiff = 0.0;
+    std::size_t nbTexels = 0;
+    for (int y = 0; y < inCoreTexture.height(); ++y)
+    {
+        for (int x = 0; x < inCoreTexture.width(); ++x)
+        {
+            const image::RGBfColor& a = inCoreTexture(y, x);
+            const image::RGBfColor& b = outOfCoreTexture(y, x);
+            for (int c = 0; c < 3; ++c)
+                maxDiff = std::max(maxDiff, double(std::abs(a(c) - b(c))));
+            if (a.r() + a.g() + a.b() > 0.f)
+                ++nbTexels;
+        }
+    }
+    BOOST_CHECK_LE(maxDiff, 0.01);
+    // the plane covers the whole UV space
+    BOOST_CHECK_GT(nbTexels, std::size_t(inCoreTexture.width()) * inCoreTexture.height() / 2);
+
+    fs::remove_all(directory);
+}
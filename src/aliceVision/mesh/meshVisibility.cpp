@@ -6,6 +6,7 @@
 
 #include "meshVisibility.hpp"
 #include "geoMesh.hpp"
+#include "MeshBVH.hpp"
 
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
@@ -142,18 +143,8 @@ void remapMeshVisibilities_meshItself(const mvsUtils::MultiViewParams& mp, Mesh&
 
     PointsVisibility& out_ptsVisibilities = mesh.pointsVisibilities;
 
-    GEO::initialize();
-    GEO::Mesh meshG;
-    toGeoMesh(mesh, meshG);
-
-    // MeshFacetAABB will reorder the mesh, so we need to keep indices
-    GEO::Attribute<GEO::index_t> reorderedVerticesAttr(meshG.vertices.attributes(), "reorder");
-    for (int i = 0; i < meshG.vertices.nb(); ++i)
-        reorderedVerticesAttr[i] = i;
-
-    GEO::MeshFacetsAABB meshAABB(meshG);  // warning: mesh_reorder called inside
-
-    GEO::vector<GEO::index_t> reorderedVertices = reorderedVerticesAttr.get_vector();
+    // BVH of the mesh triangles (the mesh is not reordered)
+    const MeshBVH meshBVH(mesh);
 
     if (out_ptsVisibilities.size() != mesh.pts.size())
     {
@@ -190,11 +181,9 @@ void remapMeshVisibilities_meshItself(const mvsUtils::MultiViewParams& mp, Mesh&
             if (angle > 90.0)
                 continue;
 
-            const GEO::vec3 gv(v.x, v.y, v.z);
-            const GEO::vec3 gc(c.x, c.y, c.z);
-            const GEO::vec3 vc = gc - gv;
+            const Point3d vc = c - v;
             // check if there is an occlusion on the segment between the current mesh vertex and the camera
-            const bool occlusion = meshAABB.ray_intersection(GEO::Ray(gv + (vc * 0.00001), vc), 1.0);
+            const bool occlusion = meshBVH.isOccluded(v + vc * 0.00001, vc, 1.0);
             if (occlusion)
                 continue;
 
@@ -68,6 +68,8 @@ class RelativePoseKernel : public robustEstimation::PointFittingRansacKernel<Sol
             // ratio of area : unit circle over image area
             _logalpha0 = log10(M_PI / (w2 * (double)h2) / (_N2(0, 0) * _N2(0, 0)));
         }
+
+        PFRansacKernel::PFKernel::initBatchErrors();
     }
 
     void unnormalize(ModelT_& model) const override
@@ -136,6 +138,8 @@ class RelativePoseKernel_K : public robustEstimation::PointFittingRansacKernel<S
         const double D = sqrt(w2 * static_cast<double>(w2) + h2 * static_cast<double>(h2));  // diameter
         const double A = w2 * static_cast<double>(h2);                                       // area
         _logalpha0 = log10(2.0 * D / A * .5);
+
+        PFRansacKernel::PFKernel::initBatchErrors();
     }
 
     void fit(const std::vector<std::size_t>& samples, std::vector<ModelT_>& models) const override
@@ -154,6 +158,29 @@ class RelativePoseKernel_K : public robustEstimation::PointFittingRansacKernel<S
         return _errorEstimator.error(modelF, PFRansacKernel::PFKernel::_x1.col(sample), PFRansacKernel::PFKernel::_x2.col(sample));
     }
 
+    void errors(const ModelT_& model, std::vector<double>& errors) const override
+    {
+        using PFKernel = typename PFRansacKernel::PFKernel;
+
+        Mat3 F;
+        fundamentalFromEssential(model.getMatrix(), _K1, _K2, &F);
+        const ModelT_ modelF(F);
+
+        errors.resize(PFKernel::_x1.cols());
+
+        if constexpr (robustEstimation::HasBatchErrors<ErrorT_, ModelT_>::value)
+        {
+            if (PFKernel::hasBatchErrors())
+            {
+                _errorEstimator.errors(modelF, PFKernel::_x1SoA, PFKernel::_x2SoA, errors.data());
+                return;
+            }
+        }
+
+        for (std::size_t sample = 0; sample < errors.size(); ++sample)
+            errors[sample] = _errorEstimator.error(modelF, PFKernel::_x1.col(sample), PFKernel::_x2.col(sample));
+    }
+
     void unnormalize(ModelT_& model) const override
     {
         // do nothing, no normalization in this case
@@ -48,6 +48,8 @@ class ResectionKernel : public robustEstimation::PointFittingRansacKernel<Solver
         assert(x2d.cols() == x3d.cols());
 
         robustEstimation::normalizePointsFromImageSize(x2d, &_x2d, &_N1, w, h);
+
+        KernelBase::PFKernel::initBatchErrors();
     }
 
     void unnormalize(ModelT_& model) const override
@@ -116,6 +118,8 @@ class ResectionKernel_K : public robustEstimation::PointFittingRansacKernel<Solv
 
         // normalize points by inverse K
         robustEstimation::applyTransformationToPoints(x2d, _N1, &_x2d);
+
+        KernelBase::PFKernel::initBatchErrors();
     }
 
     void unnormalize(ModelT_& model) const override
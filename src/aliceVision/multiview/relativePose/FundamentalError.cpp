@@ -0,0 +1,155 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "FundamentalError.hpp"
+
+#include <aliceVision/config.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+    #include <emmintrin.h>
+#endif
+
+#include <cassert>
+
+namespace aliceVision {
+namespace multiview {
+namespace relativePose {
+
+namespace {
+
+enum class EEpipolarError
+{
+    SAMPSON,
+    SYMMETRIC_EPIPOLAR_DISTANCE,
+    EPIPOLAR_DISTANCE
+};
+
+/**
+ * @brief Compute the epipolar error of all the correspondences,
+ *        two correspondences at once with SSE if available.
+ * @see page 287 equation (11.9) and page 288 equation (11.10) of HZ.
+ */
+template<EEpipolarError errorType>
+void epipolarErrors(const Mat3& F, const robustEstimation::SoAPoints& x1, const robustEstimation::SoAPoints& x2, double* out_errors)
+{
+    assert(x1.size() == x2.size());
+
+    const std::size_t nbPoints = x1.size();
+    const double* x = x1.coords(0);
+    const double* y = x1.coords(1);
+    const double* u = x2.coords(0);
+    const double* v = x2.coords(1);
+
+    std::size_t i = 0;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+    const __m128d f00 = _mm_set1_pd(F(0, 0));
+    const __m128d f01 = _mm_set1_pd(F(0, 1));
+    const __m128d f02 = _mm_set1_pd(F(0, 2));
+    const __m128d f10 = _mm_set1_pd(F(1, 0));
+    const __m128d f11 = _mm_set1_pd(F(1, 1));
+    const __m128d f12 = _mm_set1_pd(F(1, 2));
+    const __m128d f20 = _mm_set1_pd(F(2, 0));
+    const __m128d f21 = _mm_set1_pd(F(2, 1));
+    const __m128d f22 = _mm_set1_pd(F(2, 2));
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d quarter = _mm_set1_pd(0.25);
+
+    for (; i + 2 <= nbPoints; i += 2)
+    {
+        const __m128d xi = _mm_loadu_pd(x + i);
+        const __m128d yi = _mm_loadu_pd(y + i);
+        const __m128d ui = _mm_loadu_pd(u + i);
+        const __m128d vi = _mm_loadu_pd(v + i);
+
+        // F * x
+        const __m128d fx0 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(f00, xi), _mm_mul_pd(f01, yi)), f02);
+        const __m128d fx1 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(f10, xi), _mm_mul_pd(f11, yi)), f12);
+        const __m128d fx2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(f20, xi), _mm_mul_pd(f21, yi)), f22);
+
+        // y^T * F * x
+        const __m128d d = _mm_add_pd(_mm_add_pd(_mm_mul_pd(ui, fx0), _mm_mul_pd(vi, fx1)), fx2);
+        const __m128d d2 = _mm_mul_pd(d, d);
+        const __m128d nfx = _mm_add_pd(_mm_mul_pd(fx0, fx0), _mm_mul_pd(fx1, fx1));
+
+        __m128d error;
+        if constexpr (errorType == EEpipolarError::EPIPOLAR_DISTANCE)
+        {
+            error = _mm_div_pd(d2, nfx);
+        }
+        else
+        {
+            // F^T * y
+            const __m128d fty0 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(f00, ui), _mm_mul_pd(f10, vi)), f20);
+            const __m128d fty1 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(f01, ui), _mm_mul_pd(f11, vi)), f21);
+            const __m128d nfty = _mm_add_pd(_mm_mul_pd(fty0, fty0), _mm_mul_pd(fty1, fty1));
+
+            if constexpr (errorType == EEpipolarError::SAMPSON)
+                error = _mm_div_pd(d2, _mm_add_pd(nfx, nfty));
+            else
+                error = _mm_mul_pd(_mm_mul_pd(d2, _mm_add_pd(_mm_div_pd(one, nfx), _mm_div_pd(one, nfty))), quarter);
+        }
+
+        _mm_storeu_pd(out_errors + i, error);
+    }
+#endif
+
+    for (; i < nbPoints; ++i)
+    {
+        const double fx0 = F(0, 0) * x[i] + F(0, 1) * y[i] + F(0, 2);
+        const double fx1 = F(1, 0) * x[i] + F(1, 1) * y[i] + F(1, 2);
+        const double fx2 = F(2, 0) * x[i] + F(2, 1) * y[i] + F(2, 2);
+
+        const double d2 = Square(u[i] * fx0 + v[i] * fx1 + fx2);
+        const double nfx = fx0 * fx0 + fx1 * fx1;
+
+        if constexpr (errorType == EEpipolarError::EPIPOLAR_DISTANCE)
+        {
+            out_errors[i] = d2 / nfx;
+        }
+        else
+        {
+            const double fty0 = F(0, 0) * u[i] + F(1, 0) * v[i] + F(2, 0);
+            const double fty1 = F(0, 1) * u[i] + F(1, 1) * v[i] + F(2, 1);
+            const double nfty = fty0 * fty0 + fty1 * fty1;
+
+            if constexpr (errorType == EEpipolarError::SAMPSON)
+                out_errors[i] = d2 / (nfx + nfty);
+            else
+                out_errors[i] = d2 * (1.0 / nfx + 1.0 / nfty) * 0.25;
+        }
+    }
+}
+
+}  // namespace
+
+void FundamentalSampsonError::errors(const robustEstimation::Mat3Model& F,
+                                     const robustEstimation::SoAPoints& x1,
+                                     const robustEstimation::SoAPoints& x2,
+                                     double* out_errors) const
+{
+    epipolarErrors<EEpipolarError::SAMPSON>(F.getMatrix(), x1, x2, out_errors);
+}
+
+void FundamentalSymmetricEpipolarDistanceError::errors(const robustEstimation::Mat3Model& F,
+                                                       const robustEstimation::SoAPoints& x1,
+                                                       const robustEstimation::SoAPoints& x2,
+                                                       double* out_errors) const
+{
+    epipolarErrors<EEpipolarError::SYMMETRIC_EPIPOLAR_DISTANCE>(F.getMatrix(), x1, x2, out_errors);
+}
+
+void FundamentalEpipolarDistanceError::errors(const robustEstimation::Mat3Model& F,
+                                              const robustEstimation::SoAPoints& x1,
+                                              const robustEstimation::SoAPoints& x2,
+                                              double* out_errors) const
+{
+    epipolarErrors<EEpipolarError::EPIPOLAR_DISTANCE>(F.getMatrix(), x1, x2, out_errors);
+}
+
+}  // namespace relativePose
+}  // namespace multiview
+}  // namespace aliceVision
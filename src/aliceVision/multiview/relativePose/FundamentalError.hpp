@@ -9,6 +9,7 @@
 #pragma once
 
 #include <aliceVision/robustEstimation/ISolver.hpp>
+#include <aliceVision/robustEstimation/SoAPoints.hpp>
 #include <aliceVision/multiview/relativePose/ISolverErrorRelativePose.hpp>
 
 namespace aliceVision {
@@ -31,6 +32,18 @@ struct FundamentalSampsonError : public ISolverErrorRelativePose<robustEstimatio
 
         return Square(y.dot(F_x)) / (F_x.head<2>().squaredNorm() + Ft_y.head<2>().squaredNorm());
     }
+
+    /**
+     * @brief Compute the error of all the correspondences at once
+     * @param[in] F the fundamental matrix
+     * @param[in] x1 the points in the first image
+     * @param[in] x2 the corresponding points in the second image
+     * @param[out] out_errors the error of each correspondence (x1.size() values)
+     */
+    void errors(const robustEstimation::Mat3Model& F,
+                const robustEstimation::SoAPoints& x1,
+                const robustEstimation::SoAPoints& x2,
+                double* out_errors) const;
 };
 
 struct FundamentalSymmetricEpipolarDistanceError : public ISolverErrorRelativePose<robustEstimation::Mat3Model>
@@ -47,6 +60,18 @@ struct FundamentalSymmetricEpipolarDistanceError : public ISolverErrorRelativePo
         // @note the divide by 4 is to make this match the Sampson distance.
         return Square(y.dot(F_x)) * (1.0 / F_x.head<2>().squaredNorm() + 1.0 / Ft_y.head<2>().squaredNorm()) / 4.0;
     }
+
+    /**
+     * @brief Compute the error of all the correspondences at once
+     * @param[in] F the fundamental matrix
+     * @param[in] x1 the points in the first image
+     * @param[in] x2 the corresponding points in the second image
+     * @param[out] out_errors the error of each correspondence (x1.size() values)
+     */
+    void errors(const robustEstimation::Mat3Model& F,
+                const robustEstimation::SoAPoints& x1,
+                const robustEstimation::SoAPoints& x2,
+                double* out_errors) const;
 };
 
 struct FundamentalEpipolarDistanceError : public ISolverErrorRelativePose<robustEstimation::Mat3Model>
@@ -61,6 +86,18 @@ struct FundamentalEpipolarDistanceError : public ISolverErrorRelativePose<robust
 
         return Square(F_x.dot(y)) / F_x.head<2>().squaredNorm();
     }
+
+    /**
+     * @brief Compute the error of all the correspondences at once
+     * @param[in] F the fundamental matrix
+     * @param[in] x1 the points in the first image
+     * @param[in] x2 the corresponding points in the second image
+     * @param[out] out_errors the error of each correspondence (x1.size() values)
+     */
+    void errors(const robustEstimation::Mat3Model& F,
+                const robustEstimation::SoAPoints& x1,
+                const robustEstimation::SoAPoints& x2,
+                double* out_errors) const;
 };
 
 struct EpipolarSphericalDistanceError
@@ -0,0 +1,80 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "HomographyError.hpp"
+
+#include <aliceVision/config.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+    #include <emmintrin.h>
+#endif
+
+#include <cassert>
+
+namespace aliceVision {
+namespace multiview {
+namespace relativePose {
+
+void HomographyAsymmetricError::errors(const robustEstimation::Mat3Model& model,
+                                       const robustEstimation::SoAPoints& x1,
+                                       const robustEstimation::SoAPoints& x2,
+                                       double* out_errors) const
+{
+    assert(x1.size() == x2.size());
+
+    const Mat3& H = model.getMatrix();
+    const std::size_t nbPoints = x1.size();
+    const double* x = x1.coords(0);
+    const double* y = x1.coords(1);
+    const double* u = x2.coords(0);
+    const double* v = x2.coords(1);
+
+    std::size_t i = 0;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+    const __m128d h00 = _mm_set1_pd(H(0, 0));
+    const __m128d h01 = _mm_set1_pd(H(0, 1));
+    const __m128d h02 = _mm_set1_pd(H(0, 2));
+    const __m128d h10 = _mm_set1_pd(H(1, 0));
+    const __m128d h11 = _mm_set1_pd(H(1, 1));
+    const __m128d h12 = _mm_set1_pd(H(1, 2));
+    const __m128d h20 = _mm_set1_pd(H(2, 0));
+    const __m128d h21 = _mm_set1_pd(H(2, 1));
+    const __m128d h22 = _mm_set1_pd(H(2, 2));
+
+    for (; i + 2 <= nbPoints; i += 2)
+    {
+        const __m128d xi = _mm_loadu_pd(x + i);
+        const __m128d yi = _mm_loadu_pd(y + i);
+
+        // H * x
+        const __m128d hx0 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(h00, xi), _mm_mul_pd(h01, yi)), h02);
+        const __m128d hx1 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(h10, xi), _mm_mul_pd(h11, yi)), h12);
+        const __m128d hx2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(h20, xi), _mm_mul_pd(h21, yi)), h22);
+
+        const __m128d ex = _mm_sub_pd(_mm_loadu_pd(u + i), _mm_div_pd(hx0, hx2));
+        const __m128d ey = _mm_sub_pd(_mm_loadu_pd(v + i), _mm_div_pd(hx1, hx2));
+
+        _mm_storeu_pd(out_errors + i, _mm_add_pd(_mm_mul_pd(ex, ex), _mm_mul_pd(ey, ey)));
+    }
+#endif
+
+    for (; i < nbPoints; ++i)
+    {
+        const double hx0 = H(0, 0) * x[i] + H(0, 1) * y[i] + H(0, 2);
+        const double hx1 = H(1, 0) * x[i] + H(1, 1) * y[i] + H(1, 2);
+        const double hx2 = H(2, 0) * x[i] + H(2, 1) * y[i] + H(2, 2);
+
+        const double ex = u[i] - hx0 / hx2;
+        const double ey = v[i] - hx1 / hx2;
+
+        out_errors[i] = ex * ex + ey * ey;
+    }
+}
+
+}  // namespace relativePose
+}  // namespace multiview
+}  // namespace aliceVision
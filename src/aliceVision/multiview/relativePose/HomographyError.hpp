@@ -10,6 +10,7 @@
 
 #include <aliceVision/numeric/projection.hpp>
 #include <aliceVision/robustEstimation/ISolver.hpp>
+#include <aliceVision/robustEstimation/SoAPoints.hpp>
 #include <aliceVision/multiview/relativePose/ISolverErrorRelativePose.hpp>
 
 namespace aliceVision {
@@ -28,6 +29,18 @@ struct HomographyAsymmetricError : ISolverErrorRelativePose<robustEstimation::Ma
         const Vec2 x2_est = x2h_est.head<2>() / x2h_est[2];
         return (x2 - x2_est).squaredNorm();
     }
+
+    /**
+     * @brief Compute the error of all the correspondences at once
+     * @param[in] H the homography matrix
+     * @param[in] x1 the points in the first image
+     * @param[in] x2 the corresponding points in the second image
+     * @param[out] out_errors the error of each correspondence (x1.size() values)
+     */
+    void errors(const robustEstimation::Mat3Model& H,
+                const robustEstimation::SoAPoints& x1,
+                const robustEstimation::SoAPoints& x2,
+                double* out_errors) const;
 };
 
 }  // namespace relativePose
@@ -122,3 +122,30 @@ BOOST_AUTO_TEST_CASE(NormalizedFundamental8PKernel_EasyCase)
 
     BOOST_CHECK(expectKernelProperties<relativePose::NormalizedFundamental8PKernel>(x1, x2));
 }
+
+template<typename ErrorT>
+void checkBatchErrors(const Mat& x1, const Mat& x2, const robustEstimation::Mat3Model& F)
+{
+    const ErrorT errorEstimator;
+    const robustEstimation::SoAPoints x1SoA(x1);
+    const robustEstimation::SoAPoints x2SoA(x2);
+
+    std::vector<double> errors(x1.cols());
+    errorEstimator.errors(F, x1SoA, x2SoA, errors.data());
+
+    for (std::size_t i = 0; i < x1.cols(); ++i)
+        BOOST_CHECK_CLOSE(errors[i], errorEstimator.error(F, x1.col(i), x2.col(i)), 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(FundamentalError_BatchErrors)
+{
+    // odd number of points to check the non vectorized tail
+    const int nbPoints = 101;
+    const Mat x1 = Mat::Random(2, nbPoints) * 1000.0;
+    const Mat x2 = Mat::Random(2, nbPoints) * 1000.0;
+    const robustEstimation::Mat3Model F(Mat3::Random());
+
+    checkBatchErrors<relativePose::FundamentalSampsonError>(x1, x2, F);
+    checkBatchErrors<relativePose::FundamentalSymmetricEpipolarDistanceError>(x1, x2, F);
+    checkBatchErrors<relativePose::FundamentalEpipolarDistanceError>(x1, x2, F);
+}
@@ -7,12 +7,19 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/multiview/relativePose/HomographyKernel.hpp>
+#include <aliceVision/multiview/relativePose/HomographyError.hpp>
+#include <aliceVision/multiview/relativePose/Homography4PSolver.hpp>
+#include <aliceVision/robustEstimation/ACRansac.hpp>
+#include <aliceVision/multiview/RelativePoseKernel.hpp>
 
 #define BOOST_TEST_MODULE homographyKernelSolver
 #include <boost/test/unit_test.hpp>
 #include <boost/test/tools/floating_point_comparison.hpp>
 #include <aliceVision/unitTest.hpp>
 
+#include <limits>
+#include <random>
+
 using namespace aliceVision;
 using namespace aliceVision::multiview;
 
@@ -90,3 +97,89 @@ BOOST_AUTO_TEST_CASE(Homography4PKernel_Fitting)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(HomographyError_BatchErrors)
+{
+    // odd number of points to check the non vectorized tail
+    const int nbPoints = 101;
+    const Mat x1 = Mat::Random(2, nbPoints) * 1000.0;
+    const Mat x2 = Mat::Random(2, nbPoints) * 1000.0;
+
+    Mat3 H = Mat3::Random();
+    H(2, 2) = 1000.0;  // avoid points at infinity
+    const robustEstimation::Mat3Model model(H);
+
+    const relativePose::HomographyAsymmetricError errorEstimator;
+    std::vector<double> errors(nbPoints);
+    errorEstimator.errors(model, robustEstimation::SoAPoints(x1), robustEstimation::SoAPoints(x2), errors.data());
+
+    for (std::size_t i = 0; i < nbPoints; ++i)
+        BOOST_CHECK_CLOSE(errors[i], errorEstimator.error(model, x1.col(i), x2.col(i)), 1e-8);
+}
+
+// check that the pre-rejection of the hypotheses does not change the homography selected by AC-RANSAC
+BOOST_AUTO_TEST_CASE(Homography4PKernel_ACRansacPreRejection)
+{
+    using KernelT = RelativePoseKernel<relativePose::Homography4PSolver,
+                                       relativePose::HomographyAsymmetricError,
+                                       UnnormalizerI,
+                                       robustEstimation::Mat3Model>;
+
+    const int width = 1000;
+    const int height = 800;
+    const int nbPoints = 1000;
+
+    Mat3 H_gt;
+    H_gt << 1.1, 0.05, 20.0, -0.03, 0.95, -15.0, 1e-5, -2e-5, 1.0;
+
+    for (unsigned int seed = 0; seed < 10; ++seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> distributionX(0.0, width);
+        std::uniform_real_distribution<double> distributionY(0.0, height);
+        std::normal_distribution<double> noise(0.0, 0.5);
+
+        // 30% of outliers, inliers with a gaussian noise
+        Mat x1(2, nbPoints), x2(2, nbPoints);
+        for (int i = 0; i < nbPoints; ++i)
+        {
+            x1.col(i) << distributionX(generator), distributionY(generator);
+            if (i % 10 < 3)
+            {
+                x2.col(i) << distributionX(generator), distributionY(generator);
+            }
+            else
+            {
+                const Vec3 p = H_gt * x1.col(i).homogeneous();
+                x2.col(i) << p(0) / p(2) + noise(generator), p(1) / p(2) + noise(generator);
+            }
+        }
+
+        const KernelT kernel(x1, width, height, x2, width, height, false);
+
+        // sequential and parallel estimations, AC-RANSAC and upper bound precision modes
+        for (const int nbThreads : {1, 0})
+        {
+            for (const double precision : {std::numeric_limits<double>::infinity(), 4.0})
+            {
+                std::vector<std::size_t> inliers;
+                robustEstimation::Mat3Model model;
+                std::mt19937 randomNumberGenerator(seed);
+                const std::pair<double, double> ret =
+                  robustEstimation::ACRANSAC(kernel, randomNumberGenerator, inliers, 1024, &model, precision, false, nbThreads);
+
+                std::vector<std::size_t> inliersPreRejection;
+                robustEstimation::Mat3Model modelPreRejection;
+                std::mt19937 randomNumberGeneratorPreRejection(seed);
+                const std::pair<double, double> retPreRejection = robustEstimation::ACRANSAC(
+                  kernel, randomNumberGeneratorPreRejection, inliersPreRejection, 1024, &modelPreRejection, precision, true, nbThreads);
+
+                BOOST_CHECK_GE(inliers.size(), nbPoints * 7 / 10 * 9 / 10);
+                BOOST_CHECK(inliers == inliersPreRejection);
+                BOOST_CHECK_EQUAL(ret.first, retPreRejection.first);
+                BOOST_CHECK_EQUAL(ret.second, retPreRejection.second);
+                BOOST_CHECK(model.getMatrix() == modelPreRejection.getMatrix());
+            }
+        }
+    }
+}
@@ -0,0 +1,101 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "ProjectionDistanceError.hpp"
+
+#include <aliceVision/config.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+    #include <emmintrin.h>
+#endif
+
+#include <cassert>
+#include <cmath>
+
+namespace aliceVision {
+namespace multiview {
+namespace resection {
+
+namespace {
+
+/**
+ * @brief Compute the (squared) projection distance of all the correspondences,
+ *        two correspondences at once with SSE if available.
+ */
+template<bool squared>
+void projectionDistanceErrors(const Mat34& P, const robustEstimation::SoAPoints& p2d, const robustEstimation::SoAPoints& p3d, double* out_errors)
+{
+    assert(p2d.size() == p3d.size());
+
+    const std::size_t nbPoints = p2d.size();
+    const double* u = p2d.coords(0);
+    const double* v = p2d.coords(1);
+    const double* x = p3d.coords(0);
+    const double* y = p3d.coords(1);
+    const double* z = p3d.coords(2);
+
+    std::size_t i = 0;
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+    __m128d p[3][4];
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 4; ++c)
+            p[r][c] = _mm_set1_pd(P(r, c));
+
+    for (; i + 2 <= nbPoints; i += 2)
+    {
+        const __m128d xi = _mm_loadu_pd(x + i);
+        const __m128d yi = _mm_loadu_pd(y + i);
+        const __m128d zi = _mm_loadu_pd(z + i);
+
+        // P * [X|1]
+        __m128d px[3];
+        for (int r = 0; r < 3; ++r)
+            px[r] = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(p[r][0], xi), _mm_mul_pd(p[r][1], yi)), _mm_mul_pd(p[r][2], zi)), p[r][3]);
+
+        const __m128d ex = _mm_sub_pd(_mm_div_pd(px[0], px[2]), _mm_loadu_pd(u + i));
+        const __m128d ey = _mm_sub_pd(_mm_div_pd(px[1], px[2]), _mm_loadu_pd(v + i));
+        const __m128d error = _mm_add_pd(_mm_mul_pd(ex, ex), _mm_mul_pd(ey, ey));
+
+        _mm_storeu_pd(out_errors + i, squared ? error : _mm_sqrt_pd(error));
+    }
+#endif
+
+    for (; i < nbPoints; ++i)
+    {
+        double px[3];
+        for (int r = 0; r < 3; ++r)
+            px[r] = P(r, 0) * x[i] + P(r, 1) * y[i] + P(r, 2) * z[i] + P(r, 3);
+
+        const double ex = px[0] / px[2] - u[i];
+        const double ey = px[1] / px[2] - v[i];
+        const double error = ex * ex + ey * ey;
+
+        out_errors[i] = squared ? error : std::sqrt(error);
+    }
+}
+
+}  // namespace
+
+void ProjectionDistanceError::errors(const robustEstimation::Mat34Model& P,
+                                     const robustEstimation::SoAPoints& p2d,
+                                     const robustEstimation::SoAPoints& p3d,
+                                     double* out_errors) const
+{
+    projectionDistanceErrors<false>(P.getMatrix(), p2d, p3d, out_errors);
+}
+
+void ProjectionDistanceSquaredError::errors(const robustEstimation::Mat34Model& P,
+                                            const robustEstimation::SoAPoints& p2d,
+                                            const robustEstimation::SoAPoints& p3d,
+                                            double* out_errors) const
+{
+    projectionDistanceErrors<true>(P.getMatrix(), p2d, p3d, out_errors);
+}
+
+}  // namespace resection
+}  // namespace multiview
+}  // namespace aliceVision
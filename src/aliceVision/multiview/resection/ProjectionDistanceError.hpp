@@ -9,6 +9,7 @@
 
 #include <aliceVision/numeric/projection.hpp>
 #include <aliceVision/robustEstimation/ISolver.hpp>
+#include <aliceVision/robustEstimation/SoAPoints.hpp>
 #include <aliceVision/multiview/resection/ISolverErrorResection.hpp>
 
 namespace aliceVision {
@@ -25,6 +26,18 @@ struct ProjectionDistanceError : public ISolverErrorResection<robustEstimation::
     {
         return (project(P.getMatrix(), p3d) - p2d).norm();
     }
+
+    /**
+     * @brief Compute the residual of all the correspondences at once
+     * @param[in] P the projection matrix
+     * @param[in] p2d the 2d points
+     * @param[in] p3d the corresponding 3d points
+     * @param[out] out_errors the residual of each correspondence (p2d.size() values)
+     */
+    void errors(const robustEstimation::Mat34Model& P,
+                const robustEstimation::SoAPoints& p2d,
+                const robustEstimation::SoAPoints& p3d,
+                double* out_errors) const;
 };
 
 /**
@@ -37,6 +50,18 @@ struct ProjectionDistanceSquaredError : public ISolverErrorResection<robustEstim
     {
         return (project(P.getMatrix(), p3d) - p2d).squaredNorm();
     }
+
+    /**
+     * @brief Compute the residual of all the correspondences at once
+     * @param[in] P the projection matrix
+     * @param[in] p2d the 2d points
+     * @param[in] p3d the corresponding 3d points
+     * @param[out] out_errors the residual of each correspondence (p2d.size() values)
+     */
+    void errors(const robustEstimation::Mat34Model& P,
+                const robustEstimation::SoAPoints& p2d,
+                const robustEstimation::SoAPoints& p3d,
+                double* out_errors) const;
 };
 
 }  // namespace resection
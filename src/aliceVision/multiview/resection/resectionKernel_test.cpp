@@ -6,6 +6,8 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/multiview/NViewDataSet.hpp>
+#include <aliceVision/multiview/ResectionKernel.hpp>
+#include <aliceVision/multiview/Unnormalizer.hpp>
 
 #include <aliceVision/multiview/resection/ResectionKernel.hpp>
 #include <aliceVision/multiview/resection/EPnPKernel.hpp>
@@ -55,6 +57,54 @@ BOOST_AUTO_TEST_CASE(Resection_Kernel_Multiview)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ProjectionDistanceError_BatchErrors)
+{
+    // odd number of points to check the non vectorized tail
+    const int nbPoints = 101;
+    const Mat x2d = Mat::Random(2, nbPoints) * 1000.0;
+    Mat x3d = Mat::Random(3, nbPoints);
+    x3d.row(2).array() += 5.0;  // in front of the camera
+
+    Mat34 P;
+    P << 1000, 0, 500, 1, 0, 1000, 500, 2, 0, 0, 1, 3;
+    const robustEstimation::Mat34Model model(P);
+
+    std::vector<double> errors(nbPoints);
+    const robustEstimation::SoAPoints x2dSoA(x2d);
+    const robustEstimation::SoAPoints x3dSoA(x3d);
+
+    {
+        const resection::ProjectionDistanceError errorEstimator;
+        errorEstimator.errors(model, x2dSoA, x3dSoA, errors.data());
+
+        for (std::size_t i = 0; i < nbPoints; ++i)
+            BOOST_CHECK_CLOSE(errors[i], errorEstimator.error(model, x2d.col(i), x3d.col(i)), 1e-8);
+    }
+    {
+        const resection::ProjectionDistanceSquaredError errorEstimator;
+        errorEstimator.errors(model, x2dSoA, x3dSoA, errors.data());
+
+        for (std::size_t i = 0; i < nbPoints; ++i)
+            BOOST_CHECK_CLOSE(errors[i], errorEstimator.error(model, x2d.col(i), x3d.col(i)), 1e-8);
+    }
+
+    // the kernel evaluates all the samples at once
+    {
+        using KernelT = multiview::ResectionKernel_K<resection::Resection6PSolver,
+                                                     resection::ProjectionDistanceSquaredError,
+                                                     multiview::UnnormalizerResection,
+                                                     robustEstimation::Mat34Model>;
+        const KernelT kernel(x2d, x3d, Mat3::Identity());
+        BOOST_CHECK(kernel.hasBatchErrors());
+
+        kernel.errors(model, errors);
+        BOOST_CHECK_EQUAL(errors.size(), nbPoints);
+
+        for (std::size_t i = 0; i < nbPoints; ++i)
+            BOOST_CHECK_CLOSE(errors[i], kernel.error(i, model), 1e-8);
+    }
+}
+
 /*
 BOOST_AUTO_TEST_CASE(P3P_Kneip_CVPR11_Multiview)
 {
@@ -0,0 +1,140 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MapCache.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/mvsUtils/mapIO.hpp>
+
+#include <exception>
+
+namespace aliceVision {
+namespace mvsUtils {
+
+MapCache::MapCache(const MultiViewParams& mp, std::size_t maxMemory)
+  : _mp(mp),
+    _maxMemory(maxMemory)
+{}
+
+MapCache::MapSharedPtr MapCache::getMap_sync(int rc, EFileType fileType, int scale, int step, const std::string& customSuffix)
+{
+    const Key key(rc, fileType, scale, step, customSuffix);
+
+    std::promise<MapSharedPtr> promise;
+    std::shared_future<MapSharedPtr> map;
+    bool needLoad = false;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _entries.find(key);
+
+        if (it != _entries.end())
+        {
+            ++_nbHits;
+        }
+        else
+        {
+            ++_nbMisses;
+            it = _entries.emplace(key, Entry()).first;
+            it->second.map = promise.get_future().share();
+            needLoad = true;
+        }
+
+        it->second.lastAccess = ++_clock;
+        map = it->second.map;
+    }
+
+    if (!needLoad)
+        return map.get();  // wait if the map is being loaded by another thread
+
+    // read the map outside the lock, other maps can be read in parallel
+    try
+    {
+        std::shared_ptr<image::Image<float>> loadedMap = std::make_shared<image::Image<float>>();
+        readMap(rc, _mp, fileType, *loadedMap, scale, step, customSuffix);
+
+        const std::size_t memory = std::size_t(loadedMap->size()) * sizeof(float);
+        promise.set_value(loadedMap);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.at(key).memory = memory;
+        _memory += memory;
+        releaseMaps_locked(key);
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.erase(key);
+    }
+
+    return map.get();
+}
+
+void MapCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto it = _entries.begin(); it != _entries.end();)
+    {
+        if (it->second.memory > 0)  // do not release maps being loaded
+        {
+            _memory -= it->second.memory;
+            it = _entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+std::size_t MapCache::getMemoryConsumption() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _memory;
+}
+
+void MapCache::logStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    ALICEVISION_LOG_INFO("Map cache:" << std::endl
+                                      << "\t- # hits: " << _nbHits << std::endl
+                                      << "\t- # misses (file reads): " << _nbMisses << std::endl
+                                      << "\t- # maps in cache: " << _entries.size() << std::endl
+                                      << "\t- memory: " << (_memory / (1024.0 * 1024.0)) << " MB / " << (_maxMemory / (1024.0 * 1024.0)) << " MB");
+}
+
+void MapCache::releaseMaps_locked(const Key& keep)
+{
+    while (_memory > _maxMemory)
+    {
+        // find the least recently used loaded map
+        auto lru = _entries.end();
+
+        for (auto it = _entries.begin(); it != _entries.end(); ++it)
+        {
+            if (it->second.memory == 0 || it->first == keep)
+                continue;
+
+            if (lru == _entries.end() || it->second.lastAccess < lru->second.lastAccess)
+                lru = it;
+        }
+
+        if (lru == _entries.end())
+            break;  // nothing to release, budget is smaller than the working set
+
+        // note: readers still holding the map keep it alive
+        _memory -= lru->second.memory;
+        _entries.erase(lru);
+    }
+}
+
+}  // namespace mvsUtils
+}  // namespace aliceVision
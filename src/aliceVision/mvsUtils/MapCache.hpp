@@ -0,0 +1,107 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+
+#include <cstddef>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace aliceVision {
+namespace mvsUtils {
+
+/**
+ * @class Map cache
+ * @brief Thread-safe cache of fullsize maps (depth, sim, ...) read with mvsUtils::readMap.
+ * @note Maps are keyed by camera index, file type, scale, step and suffix.
+ *       Tiled maps are merged once when loaded, then shared by all readers.
+ *       A map requested by several threads at the same time is read only once.
+ *       Least recently used maps are released when the memory budget is exceeded.
+ */
+class MapCache
+{
+  public:
+    using MapSharedPtr = std::shared_ptr<const image::Image<float>>;
+
+    /**
+     * @brief MapCache constructor.
+     * @param[in] mp the multi-view parameters
+     * @param[in] maxMemory the cache memory budget (in bytes)
+     */
+    MapCache(const MultiViewParams& mp, std::size_t maxMemory);
+
+    // no copy constructor
+    MapCache(const MapCache&) = delete;
+
+    // no copy operator
+    void operator=(const MapCache&) = delete;
+
+    ~MapCache() = default;
+
+    /**
+     * @brief Get a fullsize map, read it from file(s) if not in the cache.
+     * @param[in] rc the related R camera index
+     * @param[in] fileType the map fileType enum
+     * @param[in] scale the map downscale factor
+     * @param[in] step the map step factor
+     * @param[in] customSuffix the map filename custom suffix
+     * @return shared pointer to the map, valid even if the map is released from the cache
+     */
+    MapSharedPtr getMap_sync(int rc, EFileType fileType, int scale = 1, int step = 1, const std::string& customSuffix = "");
+
+    /**
+     * @brief Release all the maps of the cache.
+     */
+    void clear();
+
+    /**
+     * @brief Get the cache memory consumption.
+     * @return memory consumption (in bytes)
+     */
+    std::size_t getMemoryConsumption() const;
+
+    /**
+     * @brief Log cache hits / misses and memory consumption.
+     */
+    void logStatistics() const;
+
+  private:
+    using Key = std::tuple<int, EFileType, int, int, std::string>;  //< rc, fileType, scale, step, customSuffix
+
+    struct Entry
+    {
+        std::shared_future<MapSharedPtr> map;  //< map, ready when loaded
+        std::size_t memory = 0;                //< map memory (0 while loading)
+        long lastAccess = 0;                   //< last access clock
+    };
+
+    /**
+     * @brief Release least recently used maps until the memory budget is respected.
+     * @note Mutex should be locked. Maps being loaded and the given key are kept.
+     * @param[in] keep the key of the map to keep
+     */
+    void releaseMaps_locked(const Key& keep);
+
+    const MultiViewParams& _mp;
+    const std::size_t _maxMemory;
+
+    mutable std::mutex _mutex;
+    std::map<Key, Entry> _entries;
+    std::size_t _memory = 0;
+    long _clock = 0;
+    std::size_t _nbHits = 0;
+    std::size_t _nbMisses = 0;
+};
+
+}  // namespace mvsUtils
+}  // namespace aliceVision
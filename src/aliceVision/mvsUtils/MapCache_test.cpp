@@ -0,0 +1,177 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mvsUtils/MapCache.hpp>
+#include <aliceVision/mvsUtils/mapIO.hpp>
+#include <aliceVision/mvsUtils/TileParams.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/camera/camera.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#define BOOST_TEST_MODULE mapCache
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mvsUtils;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const int width = 320;
+const int height = 240;
+const int nbCameras = 4;
+
+sfmData::SfMData createSfmData()
+{
+    sfmData::SfMData sfmData;
+    sfmData.getIntrinsics().emplace(
+      0, camera::createPinhole(camera::EDISTORTION::DISTORTION_NONE, camera::EUNDISTORTION::UNDISTORTION_NONE, width, height, 300.0, 300.0, 0.0, 0.0));
+
+    for (IndexT viewId = 0; viewId < nbCameras; ++viewId)
+    {
+        sfmData.getViews().emplace(viewId, std::make_shared<sfmData::View>("", viewId, 0, viewId, width, height));
+        const geometry::Pose3 pose(Mat3::Identity(), Vec3(0.1 * viewId, 0.0, 0.0));
+        sfmData.setPose(*sfmData.getViews().at(viewId), sfmData::CameraPose(pose));
+    }
+    return sfmData;
+}
+
+image::Image<float> createMap(int rc)
+{
+    image::Image<float> map(width, height);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            map(y, x) = 2.f + std::sin(0.05f * x + rc) * std::cos(0.03f * y);
+    return map;
+}
+
+/// write the depth maps, the last one by tiles
+void writeDepthMaps(const MultiViewParams& mp)
+{
+    for (int rc = 0; rc < nbCameras - 1; ++rc)
+        writeMap(rc, mp, EFileType::depthMap, createMap(rc));
+
+    const int rc = nbCameras - 1;
+    const image::Image<float> map = createMap(rc);
+
+    TileParams tileParams;
+    tileParams.bufferWidth = 128;
+    tileParams.bufferHeight = 128;
+    tileParams.padding = 16;
+
+    std::vector<ROI> tileRoiList;
+    getTileRoiList(tileParams, width, height, 1, tileRoiList);
+    BOOST_REQUIRE_GT(tileRoiList.size(), 1);
+
+    for (const ROI& roi : tileRoiList)
+    {
+        const image::Image<float> tileMap(map.block(roi.y.begin, roi.x.begin, roi.height(), roi.width()));
+        writeMap(rc, mp, EFileType::depthMap, tileParams, roi, tileMap, 1, 1);
+    }
+}
+
+struct TestDirectory
+{
+    TestDirectory()
+      : path(fs::temp_directory_path() / "mapCache_test")
+    {
+        fs::remove_all(path);
+        fs::create_directories(path);
+    }
+    ~TestDirectory() { fs::remove_all(path); }
+
+    fs::path path;
+};
+
+bool isSameMap(const image::Image<float>& a, const image::Image<float>& b)
+{
+    return a.width() == b.width() && a.height() == b.height() && (a.array() == b.array()).all();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(mapCache_sameAsReadMap)
+{
+    const TestDirectory directory;
+    const sfmData::SfMData sfmData = createSfmData();
+    const MultiViewParams mp(sfmData, "", directory.path.string(), "");
+    writeDepthMaps(mp);
+
+    MapCache cache(mp, std::size_t(1) << 30);
+
+    for (int rc = 0; rc < nbCameras; ++rc)
+    {
+        image::Image<float> map;
+        readMap(rc, mp, EFileType::depthMap, map);
+
+        const MapCache::MapSharedPtr cachedMap = cache.getMap_sync(rc, EFileType::depthMap);
+        BOOST_CHECK(isSameMap(*cachedMap, map));
+
+        // the second request is a cache hit
+        BOOST_CHECK(cache.getMap_sync(rc, EFileType::depthMap) == cachedMap);
+    }
+    BOOST_CHECK_EQUAL(cache.getMemoryConsumption(), nbCameras * width * height * sizeof(float));
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.getMemoryConsumption(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(mapCache_memoryBudget)
+{
+    const TestDirectory directory;
+    const sfmData::SfMData sfmData = createSfmData();
+    const MultiViewParams mp(sfmData, "", directory.path.string(), "");
+    writeDepthMaps(mp);
+
+    const std::size_t mapMemory = width * height * sizeof(float);
+    MapCache cache(mp, 2 * mapMemory);
+
+    std::vector<MapCache::MapSharedPtr> cachedMaps;
+    for (int rc = 0; rc < nbCameras; ++rc)
+    {
+        cachedMaps.push_back(cache.getMap_sync(rc, EFileType::depthMap));
+        BOOST_CHECK_LE(cache.getMemoryConsumption(), 2 * mapMemory);
+    }
+
+    // released maps are still valid for their readers
+    for (int rc = 0; rc < nbCameras; ++rc)
+    {
+        image::Image<float> map;
+        readMap(rc, mp, EFileType::depthMap, map);
+        BOOST_CHECK(isSameMap(*cachedMaps[rc], map));
+    }
+
+    // the most recently used map is kept, the least recently used is read again
+    BOOST_CHECK(cache.getMap_sync(nbCameras - 1, EFileType::depthMap) == cachedMaps.back());
+    BOOST_CHECK(cache.getMap_sync(0, EFileType::depthMap) != cachedMaps.front());
+}
+
+BOOST_AUTO_TEST_CASE(mapCache_concurrentRequests)
+{
+    const TestDirectory directory;
+    const sfmData::SfMData sfmData = createSfmData();
+    const MultiViewParams mp(sfmData, "", directory.path.string(), "");
+    writeDepthMaps(mp);
+
+    MapCache cache(mp, std::size_t(1) << 30);
+
+    // each map is read once, all the threads share it
+    const int nbRequests = 64;
+    std::vector<MapCache::MapSharedPtr> cachedMaps(nbRequests);
+#pragma omp parallel for
+    for (int i = 0; i < nbRequests; ++i)
+        cachedMaps[i] = cache.getMap_sync(i % nbCameras, EFileType::depthMap);
+
+    for (int i = nbCameras; i < nbRequests; ++i)
+        BOOST_CHECK(cachedMaps[i] == cachedMaps[i % nbCameras]);
+    BOOST_CHECK_EQUAL(cache.getMemoryConsumption(), nbCameras * width * height * sizeof(float));
+}
@@ -10,14 +10,20 @@
 #pragma once
 
 #include <aliceVision/robustEstimation/randSampling.hpp>
+#include <aliceVision/robustEstimation/ransacTools.hpp>
 #include <aliceVision/system/Logger.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <numeric>
+#include <random>
 #include <vector>
 
 namespace aliceVision {
@@ -111,6 +117,484 @@ inline ErrorIndex bestNFA(int startIndex,  // number of point required for estim
     return bestIndex;
 }
 
+/**
+ * @brief A contrario scoring of the residuals of a model, without sorting all the residuals.
+ * @note Residuals are dispatched in buckets of increasing values (counting sort on their floating point
+ *       representation). Buckets are processed in order and a bucket is only sorted if the lower bound
+ *       of its NFA can be better than the given NFA bound. The result is the same as sorting all the
+ *       residuals and calling bestNFA, as soon as the best NFA is lower than the NFA bound.
+ *       Buffers are kept between calls, a scorer should be reused.
+ */
+class ACRansacScorer
+{
+  public:
+    /**
+     * @brief Set the a contrario parameters, same as bestNFA.
+     */
+    void setup(std::size_t startIndex,
+               double logalpha0,
+               double loge0,
+               double maxThreshold,
+               const std::vector<float>& logc_n,
+               const std::vector<float>& logc_k,
+               double errorVectorDimension)
+    {
+        _startIndex = startIndex;
+        _logalpha0 = logalpha0;
+        _loge0 = loge0;
+        _maxThreshold = maxThreshold;
+        _logc_n = &logc_n;
+        _logc_k = &logc_k;
+        _errorVectorDimension = errorVectorDimension;
+    }
+
+    /**
+     * @brief Find the best NFA and its index wrt square error threshold in residuals.
+     * @param[in] residuals the squared residuals
+     * @param[in] nfaBound the NFA to improve, buckets which cannot reach a lower NFA are skipped
+     * @return the best NFA and the number of inliers, only valid if the best NFA is lower than nfaBound
+     */
+    ErrorIndex bestNFA(const std::vector<double>& residuals, double nfaBound)
+    {
+        // residuals range, residuals above the max threshold are not used
+        std::size_t nbValid = 0;
+        double minResidual = std::numeric_limits<double>::infinity();
+        double maxResidual = 0.0;
+        for (const double r : residuals)
+        {
+            if (r <= _maxThreshold)
+            {
+                ++nbValid;
+                minResidual = std::min(minResidual, r);
+                maxResidual = std::max(maxResidual, r);
+            }
+        }
+
+        _sorted.resize(nbValid);
+        _bucketOffsets.clear();
+
+        if (nbValid <= _startIndex)
+            return ErrorIndex(std::numeric_limits<double>::infinity(), _startIndex);
+
+        // the floating point representation of positive values is ordered as the values
+        // note: negative residuals (unexpected) are not ordered, then all residuals are in a single bucket
+        const bool singleBucket = (minResidual < 0.0);
+        _minKey = singleBucket ? 0 : getKey(minResidual);
+        const std::uint64_t keyRange = singleBucket ? 0 : getKey(maxResidual) - _minKey;
+        const std::uint64_t maxNbBuckets = std::max<std::uint64_t>(1, std::min<std::uint64_t>(nbValid / 4, 4096));
+        _shift = 0;
+        while ((keyRange >> _shift) >= maxNbBuckets)
+            ++_shift;
+        const std::size_t nbBuckets = std::size_t(keyRange >> _shift) + 1;
+
+        // counting sort, stable wrt residual index
+        _bucketOffsets.assign(nbBuckets + 1, 0);
+        for (const double r : residuals)
+        {
+            if (r <= _maxThreshold)
+                ++_bucketOffsets[getBucket(r, singleBucket) + 1];
+        }
+        std::partial_sum(_bucketOffsets.begin(), _bucketOffsets.end(), _bucketOffsets.begin());
+
+        _bucketCursors.assign(_bucketOffsets.begin(), _bucketOffsets.end() - 1);
+        for (std::size_t i = 0; i < residuals.size(); ++i)
+        {
+            const double r = residuals[i];
+            if (r <= _maxThreshold)
+                _sorted[_bucketCursors[getBucket(r, singleBucket)]++] = ErrorIndex(r, i);
+        }
+
+        _bucketSorted.assign(nbBuckets, 0);
+
+        ErrorIndex bestIndex(std::numeric_limits<double>::infinity(), _startIndex);
+
+        for (std::size_t b = 0; b < nbBuckets; ++b)
+        {
+            const std::size_t begin = _bucketOffsets[b];
+            const std::size_t end = _bucketOffsets[b + 1];
+            if (end <= _startIndex)
+                continue;
+
+            // first residual index k - 1 considered by bestNFA
+            const std::size_t first = std::max(begin, _startIndex);
+
+            // skip the bucket if its NFA lower bound (from the bucket smallest possible residual) is not better
+            const double nfaThreshold = std::min(bestIndex.first, nfaBound);
+            if (!singleBucket && nfaThreshold < std::numeric_limits<double>::infinity())
+            {
+                const double logalpha = getLogAlpha(getBucketMinResidual(b));
+                double nfaLowerBound = std::numeric_limits<double>::infinity();
+                for (std::size_t k = first + 1; k <= end; ++k)
+                    nfaLowerBound = std::min(nfaLowerBound, getNFA(logalpha, k));
+
+                // margin for the rounding errors of the monotonic functions
+                if (nfaLowerBound > nfaThreshold + 1e-9 * (1.0 + std::abs(nfaThreshold)))
+                    continue;
+            }
+
+            sortBucket(b);
+
+            for (std::size_t k = first + 1; k <= end; ++k)
+            {
+                const double nfa = getNFA(getLogAlpha(_sorted[k - 1].first), k);
+                if (nfa < bestIndex.first)
+                    bestIndex = ErrorIndex(nfa, k);
+            }
+        }
+
+        return bestIndex;
+    }
+
+    /**
+     * @brief Get the inliers of the last scored residuals, by increasing residual.
+     * @param[in] nbInliers the number of inliers (best NFA index)
+     * @param[out] out_inliers the inliers indexes
+     * @return the largest inlier squared residual
+     */
+    double getInliers(std::size_t nbInliers, std::vector<std::size_t>& out_inliers)
+    {
+        out_inliers.resize(nbInliers);
+        for (std::size_t b = 0; b + 1 < _bucketOffsets.size() && _bucketOffsets[b] < nbInliers; ++b)
+            sortBucket(b);
+
+        for (std::size_t i = 0; i < nbInliers; ++i)
+            out_inliers[i] = _sorted[i].second;
+        return _sorted[nbInliers - 1].first;
+    }
+
+  private:
+    static inline std::uint64_t getBits(double value)
+    {
+        // +0.0 for -0.0
+        value += 0.0;
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline std::uint64_t getKey(double residual) const { return getBits(residual); }
+
+    inline std::size_t getBucket(double residual, bool singleBucket) const
+    {
+        return singleBucket ? 0 : std::size_t((getKey(residual) - _minKey) >> _shift);
+    }
+
+    inline double getBucketMinResidual(std::size_t b) const
+    {
+        const std::uint64_t bits = _minKey + (std::uint64_t(b) << _shift);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    inline double getLogAlpha(double squaredResidual) const
+    {
+        const double residual = std::sqrt(squaredResidual) + std::numeric_limits<float>::epsilon();
+        return _logalpha0 + _errorVectorDimension * std::log10(residual);
+    }
+
+    /// NFA of the k first residuals, same as bestNFA
+    inline double getNFA(double logalpha, std::size_t k) const
+    {
+        return _loge0 + logalpha * (double)(k - _startIndex) + (*_logc_n)[k] + (*_logc_k)[k];
+    }
+
+    void sortBucket(std::size_t b)
+    {
+        if (_bucketSorted[b])
+            return;
+        std::sort(_sorted.begin() + _bucketOffsets[b], _sorted.begin() + _bucketOffsets[b + 1]);
+        _bucketSorted[b] = 1;
+    }
+
+    std::size_t _startIndex = 0;
+    double _logalpha0 = 0.0;
+    double _loge0 = 0.0;
+    double _maxThreshold = std::numeric_limits<double>::infinity();
+    const std::vector<float>* _logc_n = nullptr;
+    const std::vector<float>* _logc_k = nullptr;
+    double _errorVectorDimension = 1.0;
+
+    std::uint64_t _minKey = 0;
+    int _shift = 0;
+    std::vector<ErrorIndex> _sorted;           //< residuals grouped by bucket
+    std::vector<std::size_t> _bucketOffsets;   //< bucket first index in _sorted
+    std::vector<std::size_t> _bucketCursors;
+    std::vector<char> _bucketSorted;
+};
+
+/**
+ * @brief AC-RANSAC buffers, reused between calls by each thread.
+ */
+struct ACRansacScratch
+{
+    ACRansacScorer scorer;
+    std::vector<double> residuals;
+    std::vector<std::size_t> index;
+    std::vector<std::size_t> sample;
+    std::vector<std::size_t> preRejectionIndexes;
+    std::vector<float> logc_n;
+    std::vector<float> logc_k;
+};
+
+/**
+ * @brief Multi-threaded AC-RANSAC, independent chunks of hypotheses run in parallel.
+ * @see ACRANSAC for the parameters
+ * @param[in] nbThreads the number of threads running the chunks
+ * @note The iterations are statically partitioned in robustEstimationNbChunks chunks. Each chunk has its own random number generator,
+ *       AC-RANSAC mode and best model, and only stops its own iterations.
+ *       The best models of the chunks are merged by (NFA, chunk index)
+ *       after the search (uniform sampling, until the chunk finds a meaningful model)
+ *       and after the refinement (sampling among the inliers of the best model, starting from the merged model and its NFA).
+ *       The chunks do not share their best NFA during a phase: a bound read at a time given by the threads scheduling
+ *       would change the models kept by a chunk, hence its early stop and its refinement samples.
+ *       The result only depends on the random number generator, not on the number of threads nor their scheduling.
+ *       Kernel const functions should be thread-safe.
+ * @return (errorMax, minNFA)
+ */
+template<typename Kernel>
+std::pair<double, double> ACRANSACParallel(const Kernel& kernel,
+                                           std::mt19937& randomNumberGenerator,
+                                           std::vector<size_t>& vec_inliers,
+                                           std::size_t nIter,
+                                           typename Kernel::ModelT* model,
+                                           double precision,
+                                           bool preRejection,
+                                           int nbThreads)
+{
+    using ModelT = typename Kernel::ModelT;
+
+    struct Candidate
+    {
+        double nfa = std::numeric_limits<double>::infinity();
+        double errorMax = std::numeric_limits<double>::infinity();
+        std::vector<std::size_t> inliers;
+        ModelT model;
+    };
+
+    vec_inliers.clear();
+
+    const std::size_t sizeSample = kernel.getMinimumNbRequiredSamples();
+    const std::size_t nData = kernel.nbSamples();
+    if (nData <= (std::size_t)sizeSample)
+        return std::make_pair(0.0, 0.0);
+
+    const double maxThreshold = (precision == std::numeric_limits<double>::infinity())
+                                  ? std::numeric_limits<double>::infinity()
+                                  : precision * precision * kernel.thresholdNormalizer() * kernel.thresholdNormalizer();
+
+    // Precompute log combi, shared by the threads
+    std::vector<float> logc_n;
+    std::vector<float> logc_k;
+    const double loge0 = log10((double)kernel.getMaximumNbModels() * (nData - sizeSample));
+    makelogcombi(sizeSample, nData, logc_k, logc_n);
+
+    // Pre-rejection subset: regular subset of the data, only if much smaller than the data
+    const std::size_t nbPreRejectionSamples = 64;
+    std::vector<std::size_t> preRejectionIndexes;
+    if (preRejection && nData >= 4 * nbPreRejectionSamples)
+    {
+        for (std::size_t i = 0; i < nbPreRejectionSamples; ++i)
+            preRejectionIndexes.push_back(i * nData / nbPreRejectionSamples);
+    }
+
+    // Independent random number generator for each chunk
+    const int nbChunks = robustEstimationNbChunks;
+    std::vector<std::mt19937> generators;
+    generators.reserve(nbChunks);
+    for (int c = 0; c < nbChunks; ++c)
+        generators.emplace_back(randomNumberGenerator());
+
+    std::vector<Candidate> candidates(nbChunks);
+    std::vector<char> acRansacModes(nbChunks, precision == std::numeric_limits<double>::infinity());
+    std::atomic<bool> failed(false);
+    std::exception_ptr exception;
+
+    // Reserve 10% of iterations for focused sampling
+    std::size_t nIterReserve = nIter / 10;
+    nIter -= nIterReserve;
+
+    // Run the given number of iterations, statically partitioned between the chunks.
+    // The search stops when the chunk finds a meaningful model, the refinement samples among the inliers of the chunk best model.
+    const auto runIterations = [&](std::size_t nbIterations, bool refine) {
+#pragma omp parallel for num_threads(nbThreads) schedule(dynamic, 1)
+        for (int c = 0; c < nbChunks; ++c)
+        {
+            if (failed)
+                continue;
+
+            try
+            {
+                thread_local ACRansacScratch scratch;
+                scratch.scorer.setup(sizeSample, kernel.logalpha0(), loge0, maxThreshold, logc_n, logc_k, kernel.errorVectorDimension());
+                scratch.residuals.resize(nData);
+
+                std::mt19937& generator = generators[c];
+                Candidate& candidate = candidates[c];
+                bool bACRansacMode = acRansacModes[c];
+                std::vector<std::size_t>& vec_index = scratch.index;
+                if (refine)
+                    vec_index = candidate.inliers;
+
+                std::vector<ModelT> vec_models;
+
+                const std::size_t iterBegin = nbIterations * c / nbChunks;
+                const std::size_t iterEnd = nbIterations * (c + 1) / nbChunks;
+
+                for (std::size_t iter = iterBegin; iter < iterEnd && !failed; ++iter)
+                {
+                    // Early exit test -> no meaningful model found after nIterReserve*2 iterations (of all the chunks)
+                    if (!bACRansacMode && (iter - iterBegin) * nbChunks > nIterReserve * 2)
+                        break;
+
+                    if (refine)
+                        uniformSample(generator, sizeSample, vec_index, scratch.sample);
+                    else
+                        uniformSample(generator, sizeSample, nData, scratch.sample);
+
+                    vec_models.clear();
+                    kernel.fit(scratch.sample, vec_models);
+
+                    bool meaningfulFound = false;
+
+                    for (const ModelT& currentModel : vec_models)
+                    {
+                        // Pre-rejection: the inliers ratio of a better model should be close to the chunk best model one
+                        if (bACRansacMode && !preRejectionIndexes.empty() && candidate.nfa < 0)
+                        {
+                            const double inlierRatio = double(candidate.inliers.size()) / double(nData);
+                            std::size_t nbInliers = 0;
+                            for (const std::size_t i : preRejectionIndexes)
+                            {
+                                if (kernel.error(i, currentModel) <= candidate.errorMax)
+                                    ++nbInliers;
+                            }
+                            const double expectedNbInliers = inlierRatio * double(preRejectionIndexes.size());
+                            if (double(nbInliers) < expectedNbInliers - 3.0 * std::sqrt(expectedNbInliers * (1.0 - inlierRatio)))
+                                continue;
+                        }
+
+                        // Residuals computation
+                        kernel.errors(currentModel, scratch.residuals);
+
+                        if (!bACRansacMode)
+                        {
+                            unsigned int nInlier = 0;
+                            for (std::size_t i = 0; i < nData; ++i)
+                            {
+                                if (scratch.residuals[i] <= maxThreshold)
+                                    ++nInlier;
+                            }
+                            if (nInlier > 2.5 * sizeSample)  // does the model is meaningful
+                                bACRansacMode = true;
+                        }
+                        if (bACRansacMode)
+                        {
+                            // Models which cannot improve the chunk best NFA are skipped
+                            const ErrorIndex best = scratch.scorer.bestNFA(scratch.residuals, candidate.nfa);
+
+                            if (best.first < candidate.nfa)
+                            {
+                                candidate.nfa = best.first;
+                                candidate.errorMax = scratch.scorer.getInliers(best.second, candidate.inliers);
+                                candidate.model = currentModel;
+
+                                if (best.first < 0)
+                                {
+                                    if (refine)
+                                        vec_index = candidate.inliers;  // draw samples among the best set of inliers so far
+                                    else
+                                        meaningfulFound = true;
+                                }
+                            }
+                        }
+                    }
+
+                    if (meaningfulFound)
+                        break;
+                }
+
+                acRansacModes[c] = bACRansacMode;
+            }
+            catch (...)
+            {
+#pragma omp critical
+                {
+                    if (!exception)
+                        exception = std::current_exception();
+                }
+                // stop the other threads
+                failed = true;
+            }
+        }
+
+        if (exception)
+            std::rethrow_exception(exception);
+    };
+
+    // Merge the best model of each chunk, ordered by (NFA, chunk index)
+    const auto mergeCandidates = [&]() -> Candidate& {
+        std::size_t bestIndex = 0;
+        for (std::size_t c = 1; c < candidates.size(); ++c)
+        {
+            if (candidates[c].nfa < candidates[bestIndex].nfa)
+                bestIndex = c;
+        }
+        return candidates[bestIndex];
+    };
+
+    runIterations(nIter, false);
+
+    // AC-RANSAC mode if any chunk switched to it
+    const bool bACRansacMode = std::any_of(acRansacModes.begin(), acRansacModes.end(), [](char mode) { return mode != 0; });
+    std::fill(acRansacModes.begin(), acRansacModes.end(), bACRansacMode);
+
+    const bool hasModel = std::any_of(candidates.begin(), candidates.end(), [](const Candidate& c) { return !c.inliers.empty(); });
+    if (bACRansacMode && !hasModel && nIterReserve)
+    {
+        // No model found at all so far, continue to look for any model, even not meaningful
+        runIterations(nIterReserve, false);
+        nIterReserve = 0;
+    }
+
+    Candidate* bestCandidate = &mergeCandidates();
+
+    // ACRANSAC optimization: draw samples among best set of inliers so far
+    if (bACRansacMode && nIterReserve && !bestCandidate->inliers.empty())
+    {
+        for (Candidate& candidate : candidates)
+        {
+            if (&candidate != bestCandidate)
+                candidate = *bestCandidate;
+        }
+        runIterations(nIterReserve, true);
+        bestCandidate = &mergeCandidates();
+    }
+
+    double minNFA = bestCandidate->nfa;
+    double errorMax = bestCandidate->errorMax;
+
+    if (!bestCandidate->inliers.empty())
+    {
+        ALICEVISION_LOG_TRACE("  nfa=" << minNFA << " inliers=" << bestCandidate->inliers.size() << "/" << nData
+                                       << " precisionNormalized=" << errorMax << " precision=" << kernel.unormalizeError(errorMax)
+                                       << " (chunks=" << nbChunks << ", threads=" << nbThreads << ")");
+        if (model)
+            *model = bestCandidate->model;
+        if (minNFA < 0)
+            vec_inliers.swap(bestCandidate->inliers);
+    }
+
+    if (!vec_inliers.empty())
+    {
+        if (model)
+            kernel.unnormalize(*model);
+        errorMax = kernel.unormalizeError(errorMax);
+    }
+
+    return std::make_pair(errorMax, minNFA);
+}
+
 /**
  * @brief An implementation of the "Random Sample Consensus" algorithm based on a-contrario estimator
  * to automatically estimate the error threshold.
@@ -139,6 +623,12 @@ inline ErrorIndex bestNFA(int startIndex,  // number of point required for estim
  * @param[in] nIter maximum number of consecutive iterations
  * @param[out] model returned model if found
  * @param[in] precision upper bound of the precision
+ * @param[in] preRejection reject the models with significantly less inliers than the best model on a subset
+ *            of the data, before computing all their residuals (not exact: a better model may be rejected)
+ * @param[in] nbThreads the number of threads drawing hypotheses (0: automatic, 1: sequential, see useParallelRobustEstimation)
+ *
+ * @note Buffers are reused between calls by each thread and residuals are not fully sorted (see ACRansacScorer).
+ *       With several threads, see ACRANSACParallel.
  *
  * @return (errorMax, minNFA)
  */
@@ -148,8 +638,14 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
                                    std::vector<size_t>& vec_inliers,
                                    std::size_t nIter = 1024,
                                    typename Kernel::ModelT* model = nullptr,
-                                   double precision = std::numeric_limits<double>::infinity())
+                                   double precision = std::numeric_limits<double>::infinity(),
+                                   bool preRejection = false,
+                                   int nbThreads = 0)
 {
+    if (useParallelRobustEstimation(kernel.nbSamples(), nbThreads))
+        return ACRANSACParallel(
+          kernel, randomNumberGenerator, vec_inliers, nIter, model, precision, preRejection, getNbThreadsRobustEstimation(nbThreads));
+
     vec_inliers.clear();
 
     const std::size_t sizeSample = kernel.getMinimumNbRequiredSamples();
@@ -161,17 +657,33 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
                                   ? std::numeric_limits<double>::infinity()
                                   : precision * precision * kernel.thresholdNormalizer() * kernel.thresholdNormalizer();
 
-    std::vector<ErrorIndex> vec_residuals(nData);  // [residual,index]
-    std::vector<double> vec_residuals_(nData);
+    thread_local ACRansacScratch scratch;
+
+    std::vector<double>& vec_residuals_ = scratch.residuals;
+    vec_residuals_.resize(nData);
 
     // Possible sampling indices [0,..,nData] (will change in the optimization phase)
-    std::vector<size_t> vec_index(nData);
+    std::vector<size_t>& vec_index = scratch.index;
+    vec_index.resize(nData);
     std::iota(vec_index.begin(), vec_index.end(), 0);
 
+    std::vector<std::size_t>& vec_sample = scratch.sample;  // Sample indices
+    std::vector<typename Kernel::ModelT> vec_models;        // Up to max_models solutions
+
     // Precompute log combi
     const double loge0 = log10((double)kernel.getMaximumNbModels() * (nData - sizeSample));
-    std::vector<float> vec_logc_n, vec_logc_k;
-    makelogcombi(sizeSample, nData, vec_logc_k, vec_logc_n);
+    makelogcombi(sizeSample, nData, scratch.logc_k, scratch.logc_n);
+    scratch.scorer.setup(sizeSample, kernel.logalpha0(), loge0, maxThreshold, scratch.logc_n, scratch.logc_k, kernel.errorVectorDimension());
+
+    // Pre-rejection subset: regular subset of the data, only if much smaller than the data
+    const std::size_t nbPreRejectionSamples = 64;
+    std::vector<std::size_t>& preRejectionIndexes = scratch.preRejectionIndexes;
+    preRejectionIndexes.clear();
+    if (preRejection && nData >= 4 * nbPreRejectionSamples)
+    {
+        for (std::size_t i = 0; i < nbPreRejectionSamples; ++i)
+            preRejectionIndexes.push_back(i * nData / nbPreRejectionSamples);
+    }
 
     // Output parameters
     double minNFA = std::numeric_limits<double>::infinity();
@@ -186,20 +698,34 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
     // Main estimation loop.
     for (std::size_t iter = 0; iter < nIter; ++iter)
     {
-        std::vector<std::size_t> vec_sample(sizeSample);  // Sample indices
         if (bACRansacMode)
             uniformSample(randomNumberGenerator, sizeSample, vec_index, vec_sample);  // Get random sample
         else
             uniformSample(randomNumberGenerator, sizeSample, nData, vec_sample);  // Get random sample
 
-        std::vector<typename Kernel::ModelT> vec_models;  // Up to max_models solutions
+        vec_models.clear();
         kernel.fit(vec_sample, vec_models);
 
         // Evaluate models
         bool better = false;
         for (std::size_t k = 0; k < vec_models.size(); ++k)
         {
-            // Residuals computation and ordering
+            // Pre-rejection: the inliers ratio of a better model should be close to the best model one
+            if (bACRansacMode && !preRejectionIndexes.empty() && minNFA < 0 && !vec_inliers.empty())
+            {
+                const double inlierRatio = double(vec_inliers.size()) / double(nData);
+                std::size_t nbInliers = 0;
+                for (const std::size_t i : preRejectionIndexes)
+                {
+                    if (kernel.error(i, vec_models[k]) <= errorMax)
+                        ++nbInliers;
+                }
+                const double expectedNbInliers = inlierRatio * double(preRejectionIndexes.size());
+                if (double(nbInliers) < expectedNbInliers - 3.0 * std::sqrt(expectedNbInliers * (1.0 - inlierRatio)))
+                    continue;
+            }
+
+            // Residuals computation
             kernel.errors(vec_models[k], vec_residuals_);
 
             if (!bACRansacMode)
@@ -215,26 +741,15 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
             }
             if (bACRansacMode)
             {
-                for (size_t i = 0; i < nData; ++i)
-                {
-                    const double error = vec_residuals_[i];
-                    vec_residuals[i] = ErrorIndex(error, i);
-                }
-                std::sort(vec_residuals.begin(), vec_residuals.end());
-
                 // Most meaningful discrimination inliers/outliers
-                const ErrorIndex best =
-                  bestNFA(sizeSample, kernel.logalpha0(), vec_residuals, loge0, maxThreshold, vec_logc_n, vec_logc_k, kernel.errorVectorDimension());
+                const ErrorIndex best = scratch.scorer.bestNFA(vec_residuals_, minNFA);
 
                 if (best.first < minNFA /*&& vec_residuals[best.second-1].first < errorMax*/)
                 {
                     // A better model was found
                     better = true;
                     minNFA = best.first;
-                    vec_inliers.resize(best.second);
-                    for (size_t i = 0; i < best.second; ++i)
-                        vec_inliers[i] = vec_residuals[i].second;
-                    errorMax = vec_residuals[best.second - 1].first;  // Error threshold
+                    errorMax = scratch.scorer.getInliers(best.second, vec_inliers);  // Error threshold
                     if (model)
                         *model = vec_models[k];
 
@@ -10,9 +10,12 @@
 #include <aliceVision/robustEstimation/ACRansac.hpp>
 #include <aliceVision/robustEstimation/ransacTools.hpp>
 #include <aliceVision/robustEstimation/IRansacKernel.hpp>
+#include <atomic>
+#include <exception>
 #include <limits>
 #include <numeric>
 #include <iostream>
+#include <random>
 #include <vector>
 #include <iterator>
 
@@ -275,6 +278,172 @@ double localOptimization(const Kernel& kernel,
     return bestScore;
 }
 
+/**
+ * @brief Multi-threaded LORansac, independent chunks of hypotheses run in parallel.
+ * @see LO_RANSAC for the parameters
+ * @param[in] nbThreads the number of threads running the chunks
+ * @note The iterations are statically partitioned in robustEstimationNbChunks chunks: the chunk c runs the iterations
+ *       c, c + nbChunks, ... below the adaptive number of iterations given by its own best model.
+ *       Each chunk has its own random number generator and best model, the best models of the chunks
+ *       are merged by (number of inliers, chunk index).
+ *       The result only depends on the random number generator, not on the number of threads nor their scheduling.
+ *       Kernel const functions should be thread-safe.
+ * @return The best model found.
+ */
+template<typename Kernel, typename Scorer>
+typename Kernel::ModelT LO_RANSACParallel(const Kernel& kernel,
+                                          const Scorer& scorer,
+                                          std::mt19937& randomNumberGenerator,
+                                          std::vector<std::size_t>* best_inliers,
+                                          double* best_score,
+                                          bool bVerbose,
+                                          std::size_t max_iterations,
+                                          double outliers_probability,
+                                          int nbThreads)
+{
+    using ModelT = typename Kernel::ModelT;
+
+    assert(outliers_probability < 1.0);
+    assert(outliers_probability > 0.0);
+    const std::size_t min_samples = kernel.getMinimumNbRequiredSamples();
+    const std::size_t total_samples = kernel.nbSamples();
+
+    const std::size_t really_max_iterations = 4096;
+
+    struct Candidate
+    {
+        bool hasModel = false;
+        std::size_t nbInliers = 0;
+        std::vector<std::size_t> inliers;
+        ModelT model;
+    };
+
+    // Test if we have sufficient points for the kernel.
+    if (total_samples < min_samples)
+    {
+        if (best_inliers)
+        {
+            best_inliers->clear();
+        }
+        return ModelT();
+    }
+
+    // In this robust estimator, the scorer always works on all the data points
+    // at once. So precompute the list ahead of time [0,..,total_samples].
+    std::vector<std::size_t> all_samples(total_samples);
+    std::iota(all_samples.begin(), all_samples.end(), 0);
+
+    // Independent random number generator for each chunk
+    const int nbChunks = robustEstimationNbChunks;
+    std::vector<std::mt19937> generators;
+    generators.reserve(nbChunks);
+    for (int c = 0; c < nbChunks; ++c)
+        generators.emplace_back(randomNumberGenerator());
+
+    std::vector<Candidate> candidates(nbChunks);
+    std::atomic<bool> failed(false);
+    std::exception_ptr exception;
+
+#pragma omp parallel for num_threads(nbThreads) schedule(dynamic, 1)
+    for (int c = 0; c < nbChunks; ++c)
+    {
+        if (failed)
+            continue;
+
+        try
+        {
+            std::mt19937& generator = generators[c];
+            Candidate& candidate = candidates[c];
+            std::size_t maxIterations = max_iterations;
+            std::vector<std::size_t> sample;
+            std::vector<ModelT> models;
+            std::vector<std::size_t> inliers;
+
+            for (std::size_t iteration = c; iteration < maxIterations && !failed; iteration += nbChunks)
+            {
+                uniformSample(generator, min_samples, total_samples, sample);
+
+                models.clear();
+                kernel.fit(sample, models);
+
+                for (ModelT& currentModel : models)
+                {
+                    inliers.clear();
+                    double score = scorer.score(kernel, currentModel, all_samples, inliers);
+
+                    // only the candidates at least as good as the chunk best model are refined
+                    if (inliers.size() < candidate.nbInliers)
+                        continue;
+
+                    //** LOCAL OPTIMIZATION
+                    if (inliers.size() > kernel.getMinimumNbRequiredSamplesLS())
+                    {
+                        score = localOptimization(kernel, scorer, generator, currentModel, inliers);
+                    }
+
+                    // the first refined candidate is kept among the candidates with the same number of inliers
+                    if (!candidate.hasModel || inliers.size() > candidate.nbInliers)
+                    {
+                        candidate.hasModel = true;
+                        candidate.model = currentModel;
+                        candidate.nbInliers = inliers.size();
+                        candidate.inliers.swap(inliers);
+
+                        if (bVerbose)
+                        {
+                            ALICEVISION_LOG_DEBUG(" inliers=" << candidate.nbInliers << "/" << total_samples << " score: " << score
+                                                              << " (chunk=" << c << ", iter=" << iteration << ")");
+                        }
+
+                        const double bestInlierRatio = candidate.nbInliers / double(total_samples);
+                        if (bestInlierRatio)
+                        {
+                            // safeguard to not get stuck in a big number of iterations
+                            maxIterations = std::min(iterationsRequired(min_samples, outliers_probability, bestInlierRatio), really_max_iterations);
+                        }
+                    }
+                }
+            }
+        }
+        catch (...)
+        {
+#pragma omp critical
+            {
+                if (!exception)
+                    exception = std::current_exception();
+            }
+            // stop the other threads
+            failed = true;
+        }
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+
+    // Merge the best model of each chunk, ordered by (number of inliers, chunk index)
+    std::size_t bestIndex = 0;
+    for (std::size_t c = 1; c < candidates.size(); ++c)
+    {
+        if (candidates[c].hasModel && (!candidates[bestIndex].hasModel || candidates[c].nbInliers > candidates[bestIndex].nbInliers))
+            bestIndex = c;
+    }
+
+    const std::size_t bestNumInliers = candidates[bestIndex].nbInliers;
+    std::vector<std::size_t>& bestInliers = candidates[bestIndex].inliers;
+    ModelT& bestModel = candidates[bestIndex].model;
+
+    if (best_inliers)
+        best_inliers->swap(bestInliers);
+
+    if (best_score)
+        *best_score = bestNumInliers;
+
+    if (bestNumInliers)
+        kernel.unnormalize(bestModel);
+
+    return bestModel;
+}
+
 //@todo make visible parameters for the optimization step
 /**
  * @brief Implementation of the LORansac framework.
@@ -297,6 +466,8 @@ double localOptimization(const Kernel& kernel,
  * @param[in] bVerbose Enable/Disable log messages
  * @param[in] max_iterations Maximum number of iterations for the ransac part.
  * @param[in] outliers_probability The wanted probability of picking outliers.
+ * @param[in] nbThreads The number of threads drawing hypotheses (0: automatic, 1: sequential, see useParallelRobustEstimation).
+ *            With several threads, see LO_RANSACParallel.
  * @return The best model found.
  */
 template<typename Kernel, typename Scorer>
@@ -307,8 +478,20 @@ typename Kernel::ModelT LO_RANSAC(const Kernel& kernel,
                                   double* best_score = NULL,
                                   bool bVerbose = false,
                                   std::size_t max_iterations = 100,
-                                  double outliers_probability = 1e-2)
+                                  double outliers_probability = 1e-2,
+                                  int nbThreads = 0)
 {
+    if (useParallelRobustEstimation(kernel.nbSamples(), nbThreads))
+        return LO_RANSACParallel(kernel,
+                                 scorer,
+                                 randomNumberGenerator,
+                                 best_inliers,
+                                 best_score,
+                                 bVerbose,
+                                 max_iterations,
+                                 outliers_probability,
+                                 getNbThreadsRobustEstimation(nbThreads));
+
     assert(outliers_probability < 1.0);
     assert(outliers_probability > 0.0);
     std::size_t iteration = 0;
@@ -11,6 +11,7 @@
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/robustEstimation/conditioning.hpp>
 #include <aliceVision/robustEstimation/ISolver.hpp>
+#include <aliceVision/robustEstimation/SoAPoints.hpp>
 
 #include <vector>
 #include <cassert>
@@ -41,6 +42,10 @@ namespace robustEstimation {
  *   3. kernel.fit(std::vector<std::size_t>, std::vector<ModelT>&)
  *   4. kernel.error(std::size_t, ModelT) -> error
  *
+ * If the error functor provides a batch evaluation of the residuals (@see HasBatchErrors),
+ * kernel.errors(ModelT, std::vector<double>&) evaluates all the samples at once
+ * once the data have been copied as structure of arrays with initBatchErrors().
+ *
  * The fit routine must not clear existing entries in the vector of models; it
  * should append new solutions to the end.
  */
@@ -100,6 +105,16 @@ class PointFittingKernel
     inline virtual void errors(const ModelT& model, std::vector<double>& errors) const
     {
         errors.resize(_x1.cols());
+
+        if constexpr (HasBatchErrors<ErrorT, ModelT>::value)
+        {
+            if (hasBatchErrors())
+            {
+                _errorEstimator.errors(model, _x1SoA, _x2SoA, errors.data());
+                return;
+            }
+        }
+
         for (std::size_t sample = 0; sample < _x1.cols(); ++sample)
             errors.at(sample) = error(sample, model);
     }
@@ -110,7 +125,28 @@ class PointFittingKernel
      */
     inline std::size_t nbSamples() const { return _x1.cols(); }
 
+    /**
+     * @brief Return true if the errors are evaluated at once for all the samples
+     * @return true if the batch evaluation is initialized
+     */
+    inline bool hasBatchErrors() const { return _x1SoA.size() == nbSamples() && _x1SoA.size() != 0; }
+
   protected:
+    /**
+     * @brief Copy the data as structure of arrays for the batch evaluation of the errors,
+     *        if the error functor provides it.
+     * @note Should be called once the data are set (i.e. at the end of derived constructors
+     *       which normalize the data in place), the per-sample evaluation is used otherwise.
+     */
+    void initBatchErrors()
+    {
+        if constexpr (HasBatchErrors<ErrorT, ModelT>::value)
+        {
+            _x1SoA.set(_x1);
+            _x2SoA.set(_x2);
+        }
+    }
+
     /// left corresponding data
     const Mat& _x1;
     /// right corresponding data
@@ -119,6 +155,10 @@ class PointFittingKernel
     const SolverT _kernelSolver{};
     /// solver error estimation
     const ErrorT _errorEstimator{};
+    /// left corresponding data as structure of arrays (batch evaluation of the errors)
+    SoAPoints _x1SoA;
+    /// right corresponding data as structure of arrays (batch evaluation of the errors)
+    SoAPoints _x2SoA;
 };
 
 template<typename SolverT_, typename ErrorT_, typename UnnormalizerT_, typename ModelT_ = Mat3Model>
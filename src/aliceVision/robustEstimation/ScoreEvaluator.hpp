@@ -7,9 +7,25 @@
 
 #pragma once
 
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace aliceVision {
 namespace robustEstimation {
 
+/**
+ * @brief Check if the kernel may evaluate the errors of all the samples at once
+ *        (@see PointFittingKernel::hasBatchErrors)
+ */
+template<typename Kernel, typename = void>
+struct IsBatchErrorsKernel : std::false_type
+{};
+
+template<typename Kernel>
+struct IsBatchErrorsKernel<Kernel, std::void_t<decltype(std::declval<const Kernel&>().hasBatchErrors())>> : std::true_type
+{};
+
 /**
  * @brief Templated Functor class to evaluate a given model over a set of samples.
  */
@@ -25,6 +41,17 @@ class ScoreEvaluator
     double score(const Kernel& kernel, const typename Kernel::ModelT& model, const std::vector<T>& samples, std::vector<T>& inliers, double threshold)
       const
     {
+        if constexpr (IsBatchErrorsKernel<Kernel>::value)
+        {
+            // all the samples are evaluated at once
+            if (kernel.hasBatchErrors() && samples.size() == kernel.nbSamples())
+            {
+                thread_local std::vector<double> residuals;
+                kernel.errors(model, residuals);
+                return scoreResiduals(residuals, samples, inliers, threshold);
+            }
+        }
+
         double cost = 0.0;
         for (std::size_t j = 0; j < samples.size(); ++j)
         {
@@ -52,6 +79,21 @@ class ScoreEvaluator
     double getThreshold() const { return _threshold; }
 
   private:
+    /// score the precomputed residuals of the given samples
+    template<typename T>
+    static double scoreResiduals(const std::vector<double>& residuals, const std::vector<T>& samples, std::vector<T>& inliers, double threshold)
+    {
+        double cost = 0.0;
+        for (std::size_t j = 0; j < samples.size(); ++j)
+        {
+            const double error = residuals[samples[j]];
+            if (error < threshold)
+                inliers.push_back(samples[j]);
+            cost += error;
+        }
+        return cost;
+    }
+
     double _threshold;
 };
 
@@ -0,0 +1,82 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/numeric/numeric.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+namespace robustEstimation {
+
+/**
+ * @brief Points stored as a structure of arrays:
+ *        the coordinates of each dimension are contiguous (x0 x1 ... xn, y0 y1 ... yn, ...),
+ *        so residuals of all the points can be evaluated with SIMD instructions.
+ */
+class SoAPoints
+{
+  public:
+    SoAPoints() = default;
+
+    /**
+     * @brief SoAPoints constructor
+     * @param[in] points the input points, one per column
+     */
+    explicit SoAPoints(const Mat& points) { set(points); }
+
+    /**
+     * @brief Copy the given points
+     * @param[in] points the input points, one per column
+     */
+    void set(const Mat& points)
+    {
+        _dim = points.rows();
+        _size = points.cols();
+        _coords.resize(_dim * _size);
+
+        for (std::size_t i = 0; i < _size; ++i)
+            for (std::size_t d = 0; d < _dim; ++d)
+                _coords[d * _size + i] = points(d, i);
+    }
+
+    /// get the number of points
+    inline std::size_t size() const { return _size; }
+
+    /// get the dimension of the points
+    inline std::size_t dim() const { return _dim; }
+
+    /// get the contiguous coordinates of the given dimension
+    inline const double* coords(std::size_t d) const { return _coords.data() + d * _size; }
+
+  private:
+    std::vector<double> _coords;
+    std::size_t _dim = 0;
+    std::size_t _size = 0;
+};
+
+/**
+ * @brief Check if the error functor ErrorT provides a batch evaluation of the residuals:
+ *        void errors(const ModelT& model, const SoAPoints& x1, const SoAPoints& x2, double* out_errors) const
+ */
+template<typename ErrorT, typename ModelT, typename = void>
+struct HasBatchErrors : std::false_type
+{};
+
+template<typename ErrorT, typename ModelT>
+struct HasBatchErrors<ErrorT,
+                      ModelT,
+                      std::void_t<decltype(std::declval<const ErrorT&>().errors(
+                        std::declval<const ModelT&>(), std::declval<const SoAPoints&>(), std::declval<const SoAPoints&>(), std::declval<double*>()))>>
+  : std::true_type
+{};
+
+}  // namespace robustEstimation
+}  // namespace aliceVision
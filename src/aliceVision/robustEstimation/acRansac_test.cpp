@@ -267,3 +267,196 @@ BOOST_AUTO_TEST_CASE(RansacLineFitter_ACRANSACSimu)
         BOOST_CHECK(vec_inliers.size() <= expectedInliers);
     }
 }
+
+// check that the bucketed scorer gives the same NFA and inliers as sorting all the residuals
+BOOST_AUTO_TEST_CASE(ACRansacScorer_SameAsSortedResiduals)
+{
+    std::mt19937 gen;
+    std::uniform_real_distribution<> uniform(0.0, 1.0);
+    ACRansacScorer scorer;
+
+    for (int test = 0; test < 50; ++test)
+    {
+        const std::size_t nData = 10 + test * 37;
+        const std::size_t sizeSample = 2 + test % 3;
+
+        // inliers residuals, outliers residuals and ties
+        std::vector<double> residuals(nData);
+        for (std::size_t i = 0; i < nData; ++i)
+        {
+            const double r = (uniform(gen) < 0.6) ? 1e-3 * uniform(gen) : 10.0 * uniform(gen);
+            residuals[i] = (i % 5 == 0) ? std::round(r * 100.0) / 100.0 : r;
+        }
+
+        const double maxThreshold = (test % 4 == 0) ? 5.0 : std::numeric_limits<double>::infinity();
+        const double loge0 = log10(3.0 * (nData - sizeSample));
+        std::vector<float> logc_n, logc_k;
+        makelogcombi(sizeSample, nData, logc_k, logc_n);
+
+        std::vector<ErrorIndex> sortedResiduals(nData);
+        for (std::size_t i = 0; i < nData; ++i)
+            sortedResiduals[i] = ErrorIndex(residuals[i], i);
+        std::sort(sortedResiduals.begin(), sortedResiduals.end());
+
+        const ErrorIndex expected = bestNFA(sizeSample, -1.5, sortedResiduals, loge0, maxThreshold, logc_n, logc_k, 1.0);
+
+        scorer.setup(sizeSample, -1.5, loge0, maxThreshold, logc_n, logc_k, 1.0);
+
+        for (const double nfaBound : {std::numeric_limits<double>::infinity(), expected.first + 1.0})
+        {
+            const ErrorIndex best = scorer.bestNFA(residuals, nfaBound);
+
+            BOOST_CHECK_EQUAL(expected.first, best.first);
+            BOOST_CHECK_EQUAL(expected.second, best.second);
+
+            if (best.first < std::numeric_limits<double>::infinity())
+            {
+                std::vector<std::size_t> inliers;
+                const double errorMax = scorer.getInliers(best.second, inliers);
+
+                BOOST_CHECK_EQUAL(sortedResiduals[best.second - 1].first, errorMax);
+                BOOST_REQUIRE_EQUAL(best.second, inliers.size());
+                for (std::size_t i = 0; i < inliers.size(); ++i)
+                    BOOST_CHECK_EQUAL(sortedResiduals[i].second, inliers[i]);
+            }
+        }
+    }
+}
+
+// check that the models pre-rejection finds the same model on a large dataset
+BOOST_AUTO_TEST_CASE(RansacLineFitter_PreRejection)
+{
+    const int nbPoints = 1000;
+    const int nbPtToNoise = 400;
+    Mat2X xy(2, nbPoints);
+
+    Vec2 GTModel;  // y = 6.3 x + (-2.0)
+    GTModel << -2.0, 6.3;
+
+    std::mt19937 gen;
+    std::normal_distribution<> d(0, 50);
+
+    for (Mat::Index i = 0; i < nbPoints; ++i)
+    {
+        if (i % 5 < 2)
+            xy.col(i) << d(gen), d(gen);
+        else
+            xy.col(i) << i, (double)i * GTModel[1] + GTModel[0];
+    }
+
+    LineKernel lineKernel(xy, 1000, 6300);
+
+    std::vector<std::size_t> inliers;
+    robustEstimation::MatrixModel<Vec2> model;
+    std::mt19937 randomNumberGenerator;
+    ACRANSAC(lineKernel, randomNumberGenerator, inliers, 300, &model, std::numeric_limits<double>::infinity(), true);
+
+    BOOST_CHECK_EQUAL(nbPoints - nbPtToNoise, inliers.size());
+    BOOST_CHECK_SMALL(GTModel(0) - model.getMatrix()[0], 1e-6);
+    BOOST_CHECK_SMALL(GTModel(1) - model.getMatrix()[1], 1e-6);
+}
+
+// check that the threads drawing independent hypotheses find the same model as a single thread
+BOOST_AUTO_TEST_CASE(RansacLineFitter_Parallel)
+{
+    const int nbPoints = 5000;
+    const int nbPtToNoise = 2000;
+    Mat2X xy(2, nbPoints);
+
+    Vec2 GTModel;  // y = 6.3 x + (-2.0)
+    GTModel << -2.0, 6.3;
+
+    std::mt19937 gen;
+    std::uniform_real_distribution<> dx(0, nbPoints);
+    std::uniform_real_distribution<> dy(0, nbPoints * GTModel[1]);
+
+    for (Mat::Index i = 0; i < nbPoints; ++i)
+    {
+        if (i % 5 < 2)
+            xy.col(i) << dx(gen), dy(gen);
+        else
+            xy.col(i) << i, (double)i * GTModel[1] + GTModel[0];
+    }
+
+    LineKernel lineKernel(xy, 5000, 31500);
+
+    for (const int nbThreads : {1, 4})
+    {
+        std::vector<std::size_t> inliers;
+        robustEstimation::MatrixModel<Vec2> model;
+        std::mt19937 randomNumberGenerator;
+        const std::pair<double, double> ret =
+          ACRANSAC(lineKernel, randomNumberGenerator, inliers, 300, &model, std::numeric_limits<double>::infinity(), false, nbThreads);
+
+        BOOST_CHECK_LT(ret.second, 0.0);
+        BOOST_CHECK_EQUAL(nbPoints - nbPtToNoise, inliers.size());
+        BOOST_CHECK_SMALL(GTModel(0) - model.getMatrix()[0], 1e-6);
+        BOOST_CHECK_SMALL(GTModel(1) - model.getMatrix()[1], 1e-6);
+    }
+}
+
+// check that the multi-threaded estimation only depends on the random number generator,
+// not on the number of threads, their scheduling or an active parallel region
+BOOST_AUTO_TEST_CASE(RansacLineFitter_ParallelDeterministic)
+{
+    const int nbPoints = 5000;
+    Mat2X xy(2, nbPoints);
+
+    Vec2 GTModel;  // y = 6.3 x + (-2.0)
+    GTModel << -2.0, 6.3;
+
+    std::mt19937 gen;
+    std::uniform_real_distribution<> dx(0, nbPoints);
+    std::uniform_real_distribution<> dy(0, nbPoints * GTModel[1]);
+    std::normal_distribution<> noise(0.0, 1.0);
+
+    for (Mat::Index i = 0; i < nbPoints; ++i)
+    {
+        if (i % 5 < 2)
+            xy.col(i) << dx(gen), dy(gen);
+        else
+            xy.col(i) << i, (double)i * GTModel[1] + GTModel[0] + noise(gen);
+    }
+
+    LineKernel lineKernel(xy, 5000, 31500);
+
+    const auto estimate = [&](int nbThreads, std::vector<std::size_t>& inliers, robustEstimation::MatrixModel<Vec2>& model) {
+        std::mt19937 randomNumberGenerator;
+        return ACRANSAC(lineKernel, randomNumberGenerator, inliers, 300, &model, std::numeric_limits<double>::infinity(), true, nbThreads);
+    };
+
+    std::vector<std::size_t> firstInliers;
+    robustEstimation::MatrixModel<Vec2> firstModel;
+    const std::pair<double, double> firstRet = estimate(0, firstInliers, firstModel);
+    BOOST_CHECK_LT(firstRet.second, 0.0);
+
+    const auto checkSameResult = [&](const std::pair<double, double>& ret,
+                                     const std::vector<std::size_t>& inliers,
+                                     const robustEstimation::MatrixModel<Vec2>& model) {
+        BOOST_CHECK_EQUAL(ret.first, firstRet.first);
+        BOOST_CHECK_EQUAL(ret.second, firstRet.second);
+        BOOST_CHECK(inliers == firstInliers);
+        BOOST_CHECK_EQUAL(model.getMatrix()[0], firstModel.getMatrix()[0]);
+        BOOST_CHECK_EQUAL(model.getMatrix()[1], firstModel.getMatrix()[1]);
+    };
+
+    for (const int nbThreads : {0, 2, 3, 4, 8, 0, 4})
+    {
+        std::vector<std::size_t> inliers;
+        robustEstimation::MatrixModel<Vec2> model;
+        const std::pair<double, double> ret = estimate(nbThreads, inliers, model);
+        checkSameResult(ret, inliers, model);
+    }
+
+    // in a parallel region, the chunks run on a single thread
+#pragma omp parallel num_threads(2)
+    {
+#pragma omp single
+        {
+            std::vector<std::size_t> inliers;
+            robustEstimation::MatrixModel<Vec2> model;
+            const std::pair<double, double> ret = estimate(0, inliers, model);
+            checkSameResult(ret, inliers, model);
+        }
+    }
+}
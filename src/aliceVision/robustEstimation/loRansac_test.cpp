@@ -105,3 +105,82 @@ BOOST_AUTO_TEST_CASE(LoRansacLineFitter_RealCaseLoRansac)
         BOOST_CHECK_EQUAL(expectedInliers, inliers.size());
     }
 }
+
+BOOST_AUTO_TEST_CASE(LoRansacLineFitter_Parallel)
+{
+    const std::size_t numPoints = 3000;
+    const double outlierRatio = .3;
+    const double gaussianNoiseLevel = 0.0;
+    const double threshold = 0.3;
+
+    Vec2 GTModel;  // y = 6.3x - 2
+    GTModel << -2.0, 6.3;
+
+    std::mt19937 gen;
+    Mat2X xy(2, numPoints);
+    std::vector<std::size_t> vec_inliersGT;
+    generateLine(numPoints, outlierRatio, gaussianNoiseLevel, GTModel, gen, xy, vec_inliersGT);
+
+    LineKernel kernel(xy);
+    std::vector<std::size_t> inliers;
+    const int nbThreads = 4;
+    LineKernel::ModelT model =
+      LO_RANSAC(kernel, ScoreEvaluator<LineKernel>(threshold), gen, &inliers, nullptr, false, 100, 1e-2, nbThreads);
+
+    const std::size_t expectedInliers = numPoints - (std::size_t)numPoints * outlierRatio;
+    BOOST_CHECK_EQUAL(expectedInliers, inliers.size());
+    BOOST_CHECK_SMALL(GTModel[0] - model.getMatrix()[0], 1e-2);
+    BOOST_CHECK_SMALL(GTModel[1] - model.getMatrix()[1], 1e-2);
+}
+
+// check that the multi-threaded estimation only depends on the random number generator,
+// not on the number of threads, their scheduling or an active parallel region
+BOOST_AUTO_TEST_CASE(LoRansacLineFitter_ParallelDeterministic)
+{
+    const std::size_t numPoints = 3000;
+    const double outlierRatio = .3;
+    const double gaussianNoiseLevel = 0.1;
+    const double threshold = 0.3;
+
+    Vec2 GTModel;  // y = 6.3x - 2
+    GTModel << -2.0, 6.3;
+
+    std::mt19937 gen;
+    Mat2X xy(2, numPoints);
+    std::vector<std::size_t> vec_inliersGT;
+    generateLine(numPoints, outlierRatio, gaussianNoiseLevel, GTModel, gen, xy, vec_inliersGT);
+
+    LineKernel kernel(xy);
+
+    const auto estimate = [&](int nbThreads, std::vector<std::size_t>& inliers) {
+        std::mt19937 randomNumberGenerator;
+        return LO_RANSAC(kernel, ScoreEvaluator<LineKernel>(threshold), randomNumberGenerator, &inliers, nullptr, false, 100, 1e-2, nbThreads);
+    };
+
+    std::vector<std::size_t> firstInliers;
+    const LineKernel::ModelT firstModel = estimate(0, firstInliers);
+
+    const auto checkSameResult = [&](const LineKernel::ModelT& model, const std::vector<std::size_t>& inliers) {
+        BOOST_CHECK(inliers == firstInliers);
+        BOOST_CHECK_EQUAL(model.getMatrix()[0], firstModel.getMatrix()[0]);
+        BOOST_CHECK_EQUAL(model.getMatrix()[1], firstModel.getMatrix()[1]);
+    };
+
+    for (const int nbThreads : {0, 2, 3, 4, 8, 0, 4})
+    {
+        std::vector<std::size_t> inliers;
+        const LineKernel::ModelT model = estimate(nbThreads, inliers);
+        checkSameResult(model, inliers);
+    }
+
+    // in a parallel region, the chunks run on a single thread
+#pragma omp parallel num_threads(2)
+    {
+#pragma omp single
+        {
+            std::vector<std::size_t> inliers;
+            const LineKernel::ModelT model = estimate(0, inliers);
+            checkSameResult(model, inliers);
+        }
+    }
+}
@@ -8,7 +8,11 @@
 
 #pragma once
 
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 
 namespace aliceVision {
 namespace robustEstimation {
@@ -31,5 +35,36 @@ inline std::size_t iterationsRequired(std::size_t min_samples, double outliersPr
     return static_cast<std::size_t>(std::log(outliersProbability) / std::log(1.0 - std::pow(inlierRatio, static_cast<int>(min_samples))));
 }
 
+/// number of chunks of independent hypotheses of a parallel robust estimation
+/// note: it does not depend on the number of threads, so that the result is the same on all machines
+constexpr int robustEstimationNbChunks = 8;
+
+/**
+ * @brief Check if a single robust estimation draws its hypotheses in parallel chunks.
+ * @param[in] nbSamples the number of data samples
+ * @param[in] nbThreads the requested number of threads (0: automatic)
+ * @return true to use the parallel estimation, split in robustEstimationNbChunks chunks
+ * @note In automatic mode, the parallel estimation is used if there are enough samples to compensate the threads synchronization.
+ *       The choice does not depend on the available threads, nor on an active parallel region,
+ *       so that the result only depends on the data and the random number generator.
+ */
+inline bool useParallelRobustEstimation(std::size_t nbSamples, int nbThreads = 0)
+{
+    return (nbThreads == 0) ? (nbSamples >= 1000) : (nbThreads > 1);
+}
+
+/**
+ * @brief Get the number of threads running the chunks of a parallel robust estimation.
+ * @param[in] nbThreads the requested number of threads (0: automatic)
+ * @return the number of threads
+ * @note The chunks run on a single thread in an active parallel region (tasks are already parallelized).
+ */
+inline int getNbThreadsRobustEstimation(int nbThreads = 0)
+{
+    if (omp_in_parallel())
+        return 1;
+    return std::min(robustEstimationNbChunks, (nbThreads > 0) ? nbThreads : omp_get_max_threads());
+}
+
 }  // namespace robustEstimation
 }  // namespace aliceVision
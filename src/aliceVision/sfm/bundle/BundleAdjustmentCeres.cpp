@@ -7,19 +7,25 @@
 
 #include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
 #include <aliceVision/sfm/bundle/costfunctions/constraint2d.hpp>
+#include <aliceVision/sfm/bundle/costfunctions/parameterPrior.hpp>
 #include <aliceVision/sfm/bundle/costfunctions/projection.hpp>
 #include <aliceVision/sfm/bundle/costfunctions/rotationPrior.hpp>
 #include <aliceVision/sfm/bundle/manifolds/intrinsics.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmData/LandmarksIndex.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/config.hpp>
 #include <aliceVision/camera/camera.hpp>
 
 #include <ceres/rotation.h>
 
+#include <algorithm>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include <memory>
+#include <set>
 
 namespace fs = std::filesystem;
 
@@ -122,6 +128,90 @@ ceres::CostFunction* createConstraintsCostFunctionFromIntrinsics(std::shared_ptr
     return costFunction;
 }
 
+/**
+ * @brief Create the appropriate cost functor of a landmark observation
+ * @param[in] intrinsic The intrinsic of the observation view
+ * @param[in] view The observation view
+ * @param[in] observation The observation
+ * @return cost functor
+ */
+ceres::CostFunction* createObservationCostFunction(const std::shared_ptr<IntrinsicBase>& intrinsic,
+                                                   const sfmData::View& view,
+                                                   const sfmData::Observation& observation)
+{
+    if (view.isPartOfRig() && !view.isPoseIndependant())
+        return createRigCostFunctionFromIntrinsics(intrinsic, observation);
+    return createCostFunctionFromIntrinsics(intrinsic, observation);
+}
+
+/**
+ * @brief Write a pose in a parameter block according to the Ceres format: [Rx, Ry, Rz, tx, ty, tz]
+ * @param[in] pose The pose
+ * @param[out] poseBlock The pose parameter block
+ */
+void poseToBlock(const geometry::Pose3& pose, double* poseBlock)
+{
+    const Mat3& R = pose.rotation();
+    const Vec3& t = pose.translation();
+
+    ceres::RotationMatrixToAngleAxis(static_cast<const double*>(R.data()), poseBlock);
+    poseBlock[3] = t(0);
+    poseBlock[4] = t(1);
+    poseBlock[5] = t(2);
+}
+
+/**
+ * @brief Get the indexes of the constant parameters of a pose parameter block
+ * @param[in] refineRotation Refine the rotation
+ * @param[in] refineTranslation Refine the translation
+ * @return the constant parameters indexes
+ */
+std::vector<int> getConstantExtrinsicParameters(bool refineRotation, bool refineTranslation)
+{
+    std::vector<int> constantExtrinsic;
+
+    // don't refine rotations
+    if (!refineRotation)
+    {
+        constantExtrinsic.push_back(0);
+        constantExtrinsic.push_back(1);
+        constantExtrinsic.push_back(2);
+    }
+
+    // don't refine translations
+    if (!refineTranslation)
+    {
+        constantExtrinsic.push_back(3);
+        constantExtrinsic.push_back(4);
+        constantExtrinsic.push_back(5);
+    }
+
+    return constantExtrinsic;
+}
+
+/**
+ * @brief Count the number of reconstructed views per intrinsic
+ * @param[in] sfmData The input SfMData
+ * @return the number of reconstructed views per intrinsic referenced by a view
+ */
+std::map<IndexT, std::size_t> getIntrinsicsUsage(const sfmData::SfMData& sfmData)
+{
+    std::map<IndexT, std::size_t> intrinsicsUsage;
+
+    for (const auto& viewPair : sfmData.getViews())
+    {
+        const sfmData::View& view = *(viewPair.second);
+
+        if (intrinsicsUsage.find(view.getIntrinsicId()) == intrinsicsUsage.end())
+            intrinsicsUsage[view.getIntrinsicId()] = 0;
+
+        if (sfmData.isPoseAndIntrinsicDefined(view))
+            ++intrinsicsUsage.at(view.getIntrinsicId());
+    }
+
+    return intrinsicsUsage;
+}
+
 void BundleAdjustmentCeres::CeresOptions::setDenseBA()
 {
     // default configuration use a DENSE representation
@@ -254,6 +344,17 @@ void BundleAdjustmentCeres::Statistics::show() const
         ss << "\t- local strategy enabled: no\n";
     }
 
+    std::stringstream consensus;
+    if (nbConsensusIterations > 0)
+    {
+        consensus << "\n\t- # consensus iterations: " << nbConsensusIterations;
+        for (const auto& residualPair : consensusPrimalResiduals)
+        {
+            consensus << "\n\t- " << ((residualPair.first == EParameter::POSE) ? "poses" : "intrinsics")
+                      << " consensus primal / dual residuals: " << residualPair.second << " / " << consensusDualResiduals.at(residualPair.first);
+        }
+    }
+
     ALICEVISION_LOG_INFO("Bundle Adjustment Statistics:\n"
                          << ss.str() << "\t- adjustment duration: " << time << " s\n"
                          << "\t- poses:\n"
@@ -272,7 +373,7 @@ void BundleAdjustmentCeres::Statistics::show() const
                          << "\t- # successful iterations: " << nbSuccessfullIterations << "\n"
                          << "\t- # unsuccessful iterations: " << nbUnsuccessfullIterations << "\n"
                          << "\t- initial RMSE: " << RMSEinitial << "\n"
-                         << "\t- final   RMSE: " << RMSEfinal);
+                         << "\t- final   RMSE: " << RMSEfinal << consensus.str());
 }
 
 void BundleAdjustmentCeres::setSolverOptions(ceres::Solver::Options& solverOptions) const
@@ -306,20 +407,8 @@ void BundleAdjustmentCeres::addExtrinsicsToProblem(const sfmData::SfMData& sfmDa
     const bool refineTranslation = refineOptions & BundleAdjustment::REFINE_TRANSLATION;
     const bool refineRotation = refineOptions & BundleAdjustment::REFINE_ROTATION;
 
-    const auto addPose = [&](const sfmData::CameraPose& cameraPose, bool isConstant, std::array<double, 6>& poseBlock) {
-        const Mat3& R = cameraPose.getTransform().rotation();
-        const Vec3& t = cameraPose.getTransform().translation();
-
-        double angleAxis[3];
-        ceres::RotationMatrixToAngleAxis(static_cast<const double*>(R.data()), angleAxis);
-        poseBlock.at(0) = angleAxis[0];
-        poseBlock.at(1) = angleAxis[1];
-        poseBlock.at(2) = angleAxis[2];
-        poseBlock.at(3) = t(0);
-        poseBlock.at(4) = t(1);
-        poseBlock.at(5) = t(2);
-
-        double* poseBlockPtr = poseBlock.data();
+    const auto addPose = [&](const sfmData::CameraPose& cameraPose, bool isConstant, double* poseBlockPtr) {
+        poseToBlock(cameraPose.getTransform(), poseBlockPtr);
         problem.AddParameterBlock(poseBlockPtr, 6);
 
         // add pose parameter to the all parameters blocks pointers list
@@ -335,23 +424,7 @@ void BundleAdjustmentCeres::addExtrinsicsToProblem(const sfmData::SfMData& sfmDa
         }
 
         // constant parameters
-        std::vector<int> constantExtrinsic;
-
-        // don't refine rotations
-        if (!refineRotation)
-        {
-            constantExtrinsic.push_back(0);
-            constantExtrinsic.push_back(1);
-            constantExtrinsic.push_back(2);
-        }
-
-        // don't refine translations
-        if (!refineTranslation)
-        {
-            constantExtrinsic.push_back(3);
-            constantExtrinsic.push_back(4);
-            constantExtrinsic.push_back(5);
-        }
+        const std::vector<int> constantExtrinsic = getConstantExtrinsicParameters(refineRotation, refineTranslation);
 
         // subset parametrization
         if (!constantExtrinsic.empty())
@@ -378,7 +451,9 @@ void BundleAdjustmentCeres::addExtrinsicsToProblem(const sfmData::SfMData& sfmDa
 
         const bool isConstant = (pose.getState() == EEstimatorParameterState::CONSTANT);
 
-        addPose(pose, isConstant, _posesBlocks[poseId]);
+        double* poseBlockPtr = _posesPool.allocate();
+        _posesBlocks[poseId] = poseBlockPtr;
+        addPose(pose, isConstant, poseBlockPtr);
     }
 
     // setup sub-poses data
@@ -397,7 +472,9 @@ void BundleAdjustmentCeres::addExtrinsicsToProblem(const sfmData::SfMData& sfmDa
 
             const bool isConstant = (rigSubPose.status == sfmData::ERigSubPoseStatus::CONSTANT);
 
-            addPose(sfmData::CameraPose(rigSubPose.pose), isConstant, _rigBlocks[rigId][subPoseId]);
+            double* rigBlockPtr = _posesPool.allocate();
+            _rigBlocks[rigId][subPoseId] = rigBlockPtr;
+            addPose(sfmData::CameraPose(rigSubPose.pose), isConstant, rigBlockPtr);
         }
     }
 }
@@ -406,25 +483,8 @@ void BundleAdjustmentCeres::addIntrinsicsToProblem(const sfmData::SfMData& sfmDa
                                                    BundleAdjustment::ERefineOptions refineOptions,
                                                    ceres::Problem& problem)
 {
-    const bool refineIntrinsicsOpticalCenter =
-      (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_ALWAYS) || (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_IF_ENOUGH_DATA);
-    const bool refineIntrinsicsFocalLength = refineOptions & REFINE_INTRINSICS_FOCAL;
-    const bool refineIntrinsicsDistortion = refineOptions & REFINE_INTRINSICS_DISTORTION;
-    const bool refineIntrinsics = refineIntrinsicsDistortion || refineIntrinsicsFocalLength || refineIntrinsicsOpticalCenter;
-
-    std::map<IndexT, std::size_t> intrinsicsUsage;
-
     // count the number of reconstructed views per intrinsic
-    for (const auto& viewPair : sfmData.getViews())
-    {
-        const sfmData::View& view = *(viewPair.second);
-
-        if (intrinsicsUsage.find(view.getIntrinsicId()) == intrinsicsUsage.end())
-            intrinsicsUsage[view.getIntrinsicId()] = 0;
-
-        if (sfmData.isPoseAndIntrinsicDefined(view))
-            ++intrinsicsUsage.at(view.getIntrinsicId());
-    }
+    const std::map<IndexT, std::size_t> intrinsicsUsage = getIntrinsicsUsage(sfmData);
 
     for (const auto& intrinsicPair : sfmData.getIntrinsics())
     {
@@ -443,9 +503,7 @@ void BundleAdjustmentCeres::addIntrinsicsToProblem(const sfmData::SfMData& sfmDa
             continue;
         }
 
-        std::shared_ptr<camera::IntrinsicScaleOffset> intrinsicScaleOffset =
-              std::dynamic_pointer_cast<camera::IntrinsicScaleOffset>(intrinsicPtr);
-        if (!intrinsicScaleOffset)
+        if (!std::dynamic_pointer_cast<camera::IntrinsicScaleOffset>(intrinsicPtr))
         {
             continue;
         }
@@ -464,112 +522,132 @@ void BundleAdjustmentCeres::addIntrinsicsToProblem(const sfmData::SfMData& sfmDa
         // add intrinsic parameter to the all parameters blocks pointers list
         _allParametersBlocks.push_back(intrinsicBlockPtr);
 
-        // keep the camera intrinsic constant
-        if (intrinsicPtr->isLocked() || !refineIntrinsics || intrinsicPtr->getState() == EEstimatorParameterState::CONSTANT)
-        {
-            // set the whole parameter block as constant.
-            _statistics.addState(EParameter::INTRINSIC, EEstimatorParameterState::CONSTANT);
-            problem.SetParameterBlockConstant(intrinsicBlockPtr);
-            continue;
-        }
+        setIntrinsicParameterization(intrinsicPtr, usageCount, refineOptions, intrinsicBlock, problem);
+    }
+}
 
-        // constant parameters
-        bool lockCenter = false;
-        bool lockFocal = false;
-        bool lockRatio = true;
-        bool lockDistortion = false;
-        double focalRatio = 1.0;
+void BundleAdjustmentCeres::setIntrinsicParameterization(const std::shared_ptr<camera::IntrinsicBase>& intrinsicPtr,
+                                                         std::size_t usageCount,
+                                                         ERefineOptions refineOptions,
+                                                         std::vector<double>& intrinsicBlock,
+                                                         ceres::Problem& problem)
+{
+    const bool refineIntrinsicsOpticalCenter =
+      (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_ALWAYS) || (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_IF_ENOUGH_DATA);
+    const bool refineIntrinsicsFocalLength = refineOptions & REFINE_INTRINSICS_FOCAL;
+    const bool refineIntrinsicsDistortion = refineOptions & REFINE_INTRINSICS_DISTORTION;
+    const bool refineIntrinsics = refineIntrinsicsDistortion || refineIntrinsicsFocalLength || refineIntrinsicsOpticalCenter;
 
-        lockFocal = (!refineIntrinsicsFocalLength) || intrinsicScaleOffset->isScaleLocked();
+    std::shared_ptr<camera::IntrinsicScaleOffset> intrinsicScaleOffset = std::dynamic_pointer_cast<camera::IntrinsicScaleOffset>(intrinsicPtr);
+    double* intrinsicBlockPtr = intrinsicBlock.data();
 
-        // refine the focal length
-        if (!lockFocal)
-        {
-            if (intrinsicScaleOffset->getInitialScale().x() > 0 && intrinsicScaleOffset->getInitialScale().y() > 0 && _ceresOptions.useFocalPrior)
-            {
-                
-                // if we have an initial guess, we only authorize a margin around this value.
-                assert(intrinsicBlock.size() >= 1);
-                const double maxFocalError = 0.2 * std::max(intrinsicPtr->w(), intrinsicPtr->h());
-
-                const double fx = intrinsicScaleOffset->getInitialScale().x();
-                const double fy = intrinsicScaleOffset->getInitialScale().y();
-
-                const double lboundY = std::max(0.0, fy - maxFocalError);
-                const double uboundY = std::max(0.0, fy + maxFocalError);
-                const double lboundX = std::max(0.0, lboundY * fx/fy);
-                const double uboundX = std::max(0.0, uboundY * fx/fy);
-
-                problem.SetParameterLowerBound(intrinsicBlockPtr, 0, lboundX);
-                problem.SetParameterUpperBound(intrinsicBlockPtr, 0, uboundX);
-                problem.SetParameterLowerBound(intrinsicBlockPtr, 1, lboundY);
-                problem.SetParameterUpperBound(intrinsicBlockPtr, 1, uboundY);
-            }
-            else  // no initial guess
-            {
-                // we don't have an initial guess, but we assume that we use
-                // a converging lens, so the focal length should be positive.
-                problem.SetParameterLowerBound(intrinsicBlockPtr, 0, 0.0);
-                problem.SetParameterLowerBound(intrinsicBlockPtr, 1, 0.0);
-            }
+    // keep the camera intrinsic constant
+    if (intrinsicPtr->isLocked() || !refineIntrinsics || intrinsicPtr->getState() == EEstimatorParameterState::CONSTANT)
+    {
+        // set the whole parameter block as constant.
+        _statistics.addState(EParameter::INTRINSIC, EEstimatorParameterState::CONSTANT);
+        problem.SetParameterBlockConstant(intrinsicBlockPtr);
+        return;
+    }
 
-            focalRatio = intrinsicBlockPtr[0] / intrinsicBlockPtr[1];
-            lockRatio = intrinsicScaleOffset->isRatioLocked();
-        }
+    problem.SetParameterBlockVariable(intrinsicBlockPtr);
 
-        // optical center
-        lockCenter = intrinsicScaleOffset->isOffsetLocked();
-        
-        bool validRefineCenter = (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_ALWAYS) ||
-                        ((refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_IF_ENOUGH_DATA) 
-                        && _minNbImagesToRefineOpticalCenter > 0 
-                        && usageCount >= _minNbImagesToRefineOpticalCenter);
-        if (!validRefineCenter)
+    // constant parameters
+    bool lockCenter = false;
+    bool lockFocal = false;
+    bool lockRatio = true;
+    bool lockDistortion = false;
+    double focalRatio = 1.0;
+
+    lockFocal = (!refineIntrinsicsFocalLength) || intrinsicScaleOffset->isScaleLocked();
+
+    // refine the focal length
+    if (!lockFocal)
+    {
+        if (intrinsicScaleOffset->getInitialScale().x() > 0 && intrinsicScaleOffset->getInitialScale().y() > 0 && _ceresOptions.useFocalPrior)
         {
-            lockCenter = true;
+            
+            // if we have an initial guess, we only authorize a margin around this value.
+            assert(intrinsicBlock.size() >= 1);
+            const double maxFocalError = 0.2 * std::max(intrinsicPtr->w(), intrinsicPtr->h());
+
+            const double fx = intrinsicScaleOffset->getInitialScale().x();
+            const double fy = intrinsicScaleOffset->getInitialScale().y();
+
+            const double lboundY = std::max(0.0, fy - maxFocalError);
+            const double uboundY = std::max(0.0, fy + maxFocalError);
+            const double lboundX = std::max(0.0, lboundY * fx/fy);
+            const double uboundX = std::max(0.0, uboundY * fx/fy);
+
+            problem.SetParameterLowerBound(intrinsicBlockPtr, 0, lboundX);
+            problem.SetParameterUpperBound(intrinsicBlockPtr, 0, uboundX);
+            problem.SetParameterLowerBound(intrinsicBlockPtr, 1, lboundY);
+            problem.SetParameterUpperBound(intrinsicBlockPtr, 1, uboundY);
         }
-
-        if (!lockCenter)
+        else  // no initial guess
         {
-            // refine optical center within 10% of the image size.
-            assert(intrinsicBlock.size() >= 3);
+            // we don't have an initial guess, but we assume that we use
+            // a converging lens, so the focal length should be positive.
+            problem.SetParameterLowerBound(intrinsicBlockPtr, 0, 0.0);
+            problem.SetParameterLowerBound(intrinsicBlockPtr, 1, 0.0);
+        }
 
-            const double opticalCenterMinPercent = -0.05;
-            const double opticalCenterMaxPercent = 0.05;
+        focalRatio = intrinsicBlockPtr[0] / intrinsicBlockPtr[1];
+        lockRatio = intrinsicScaleOffset->isRatioLocked();
+    }
 
-            // add bounds to the principal point
-            problem.SetParameterLowerBound(intrinsicBlockPtr, 2, opticalCenterMinPercent * intrinsicPtr->w());
-            problem.SetParameterUpperBound(intrinsicBlockPtr, 2, opticalCenterMaxPercent * intrinsicPtr->w());
-            problem.SetParameterLowerBound(intrinsicBlockPtr, 3, opticalCenterMinPercent * intrinsicPtr->h());
-            problem.SetParameterUpperBound(intrinsicBlockPtr, 3, opticalCenterMaxPercent * intrinsicPtr->h());
-        }
+    // optical center
+    lockCenter = intrinsicScaleOffset->isOffsetLocked();
+    
+    bool validRefineCenter = (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_ALWAYS) ||
+                    ((refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_IF_ENOUGH_DATA) 
+                    && _minNbImagesToRefineOpticalCenter > 0 
+                    && usageCount >= _minNbImagesToRefineOpticalCenter);
+    if (!validRefineCenter)
+    {
+        lockCenter = true;
+    }
 
-        // lens distortion
-        if (!refineIntrinsicsDistortion || intrinsicPtr->getDistortionInitializationMode() == camera::EInitMode::CALIBRATED)
-        {
-            lockDistortion = true;
-        }
+    if (!lockCenter)
+    {
+        // refine optical center within 10% of the image size.
+        assert(intrinsicBlock.size() >= 3);
+
+        const double opticalCenterMinPercent = -0.05;
+        const double opticalCenterMaxPercent = 0.05;
+
+        // add bounds to the principal point
+        problem.SetParameterLowerBound(intrinsicBlockPtr, 2, opticalCenterMinPercent * intrinsicPtr->w());
+        problem.SetParameterUpperBound(intrinsicBlockPtr, 2, opticalCenterMaxPercent * intrinsicPtr->w());
+        problem.SetParameterLowerBound(intrinsicBlockPtr, 3, opticalCenterMinPercent * intrinsicPtr->h());
+        problem.SetParameterUpperBound(intrinsicBlockPtr, 3, opticalCenterMaxPercent * intrinsicPtr->h());
+    }
 
-        //Check if this particular distortion is locked
-        std::shared_ptr<camera::IntrinsicScaleOffsetDisto> intrinsicScaleOffsetDisto =
-              std::dynamic_pointer_cast<camera::IntrinsicScaleOffsetDisto>(intrinsicPtr);
-        if (intrinsicScaleOffsetDisto)
+    // lens distortion
+    if (!refineIntrinsicsDistortion || intrinsicPtr->getDistortionInitializationMode() == camera::EInitMode::CALIBRATED)
+    {
+        lockDistortion = true;
+    }
+
+    //Check if this particular distortion is locked
+    std::shared_ptr<camera::IntrinsicScaleOffsetDisto> intrinsicScaleOffsetDisto =
+          std::dynamic_pointer_cast<camera::IntrinsicScaleOffsetDisto>(intrinsicPtr);
+    if (intrinsicScaleOffsetDisto)
+    {
+        if (intrinsicScaleOffsetDisto->getDistortion())
         {
-            if (intrinsicScaleOffsetDisto->getDistortion())
+            if (intrinsicScaleOffsetDisto->getDistortion()->isLocked())
             {
-                if (intrinsicScaleOffsetDisto->getDistortion()->isLocked())
-                {
-                    lockDistortion = true;
-                }
+                lockDistortion = true;
             }
         }
+    }
 
-        IntrinsicsManifold* subsetManifold =
-          new IntrinsicsManifold(intrinsicBlock.size(), focalRatio, lockFocal, lockRatio, lockCenter, lockDistortion);
-        problem.SetManifold(intrinsicBlockPtr, subsetManifold);
+    IntrinsicsManifold* subsetManifold =
+      new IntrinsicsManifold(intrinsicBlock.size(), focalRatio, lockFocal, lockRatio, lockCenter, lockDistortion);
+    problem.SetManifold(intrinsicBlockPtr, subsetManifold);
 
-        _statistics.addState(EParameter::INTRINSIC, EEstimatorParameterState::REFINED);
-    }
+    _statistics.addState(EParameter::INTRINSIC, EEstimatorParameterState::REFINED);
 }
 
 void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions, ceres::Problem& problem)
@@ -580,11 +658,50 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
     // note: set it to NULL if you don't want use a lossFunction.
     ceres::LossFunction* lossFunction = _ceresOptions.lossFunction.get();
 
+    // index the landmarks and the offsets of their observations (no copy), to iterate them in parallel
+    const sfmData::LandmarksIndex landmarks(sfmData.getLandmarks());
+    const std::ptrdiff_t nbLandmarks = static_cast<std::ptrdiff_t>(landmarks.size());
+
+    // create the cost functions of all the observations in parallel (observation undistortion),
+    // the ceres problem is then filled sequentially
+    std::vector<ceres::CostFunction*> costFunctions(landmarks.nbObservations(), nullptr);
+    std::exception_ptr costFunctionsException;
+
+#pragma omp parallel for schedule(dynamic, 256)
+    for (std::ptrdiff_t i = 0; i < nbLandmarks; ++i)
+    {
+        const sfmData::Landmark& landmark = landmarks.getLandmark(i);
+        if (landmark.state == EEstimatorParameterState::IGNORED)
+            continue;
+
+        try
+        {
+            std::size_t k = landmarks.observationsBegin(i);
+            for (const auto& observationPair : landmark.getObservations())
+            {
+                const sfmData::View& view = sfmData.getView(observationPair.first);
+                costFunctions[k++] = createObservationCostFunction(_intrinsicObjects.at(view.getIntrinsicId()), view, observationPair.second);
+            }
+        }
+        catch (...)
+        {
+#pragma omp critical
+            costFunctionsException = std::current_exception();
+        }
+    }
+
+    if (costFunctionsException)
+    {
+        for (ceres::CostFunction* costFunction : costFunctions)
+            delete costFunction;
+        std::rethrow_exception(costFunctionsException);
+    }
+
     // build the residual blocks corresponding to the track observations
-    for (const auto& landmarkPair : sfmData.getLandmarks())
+    for (std::ptrdiff_t i = 0; i < nbLandmarks; ++i)
     {
-        const IndexT landmarkId = landmarkPair.first;
-        const sfmData::Landmark& landmark = landmarkPair.second;
+        const IndexT landmarkId = landmarks.getLandmarkId(i);
+        const sfmData::Landmark& landmark = landmarks.getLandmark(i);
 
         // do not create a residual block if the landmark
         // have been set as Ignored by the Local BA strategy
@@ -594,30 +711,28 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
             continue;
         }
 
-        std::array<double, 3>& landmarkBlock = _landmarksBlocks[landmarkId];
-        for (std::size_t i = 0; i < 3; ++i)
-            landmarkBlock.at(i) = landmark.X(Eigen::Index(i));
-
-        double* landmarkBlockPtr = landmarkBlock.data();
+        double* landmarkBlockPtr = _landmarksPool.allocate();
+        _landmarksBlocks[landmarkId] = landmarkBlockPtr;
+        for (std::size_t j = 0; j < 3; ++j)
+            landmarkBlockPtr[j] = landmark.X(Eigen::Index(j));
 
         // add landmark parameter to the all parameters blocks pointers list
         _allParametersBlocks.push_back(landmarkBlockPtr);
 
         // iterate over 2D observation associated to the 3D landmark
+        std::size_t k = landmarks.observationsBegin(i);
         for (const auto& observationPair : landmark.getObservations())
         {
             const sfmData::View& view = sfmData.getView(observationPair.first);
-            const sfmData::Observation& observation = observationPair.second;
+            ceres::CostFunction* costFunction = costFunctions[k++];
 
             // each residual block takes a point and a camera as input and outputs a 2
             // dimensional residual. Internally, the cost function stores the observed
             // image location and compares the reprojection against the observation.
-            const auto& pose = sfmData.getPose(view);
 
             // needed parameters to create a residual block (K, pose)
-            double* poseBlockPtr = _posesBlocks.at(view.getPoseId()).data();
+            double* poseBlockPtr = _posesBlocks.at(view.getPoseId());
             double* intrinsicBlockPtr = _intrinsicsBlocks.at(view.getIntrinsicId()).data();
-            const std::shared_ptr<IntrinsicBase> intrinsic = _intrinsicObjects[view.getIntrinsicId()];
 
             // apply a specific parameter ordering:
             if (_ceresOptions.useParametersOrdering)
@@ -629,9 +744,7 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
 
             if (view.isPartOfRig() && !view.isPoseIndependant())
             {
-                ceres::CostFunction* costFunction = createRigCostFunctionFromIntrinsics(intrinsic, observation);
-
-                double* rigBlockPtr = _rigBlocks.at(view.getRigId()).at(view.getSubPoseId()).data();
+                double* rigBlockPtr = _rigBlocks.at(view.getRigId()).at(view.getSubPoseId());
                 _linearSolverOrdering.AddElementToGroup(rigBlockPtr, 1);
 
                 problem.AddResidualBlock(costFunction,
@@ -643,8 +756,6 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
             }
             else
             {
-                ceres::CostFunction* costFunction = createCostFunctionFromIntrinsics(intrinsic, observation);
-
                 problem.AddResidualBlock(costFunction,
                                          lossFunction,
                                          intrinsicBlockPtr,
@@ -687,8 +798,8 @@ void BundleAdjustmentCeres::addConstraints2DToProblem(const sfmData::SfMData& sf
         assert(pose_2.getState() != EEstimatorParameterState::IGNORED);
         assert(intrinsic_2->getState() != EEstimatorParameterState::IGNORED);
 
-        double* poseBlockPtr_1 = _posesBlocks.at(view_1.getPoseId()).data();
-        double* poseBlockPtr_2 = _posesBlocks.at(view_2.getPoseId()).data();
+        double* poseBlockPtr_1 = _posesBlocks.at(view_1.getPoseId());
+        double* poseBlockPtr_2 = _posesBlocks.at(view_2.getPoseId());
 
         double* intrinsicBlockPtr_1 = _intrinsicsBlocks.at(view_1.getIntrinsicId()).data();
         double* intrinsicBlockPtr_2 = _intrinsicsBlocks.at(view_2.getIntrinsicId()).data();
@@ -703,7 +814,7 @@ void BundleAdjustmentCeres::addConstraints2DToProblem(const sfmData::SfMData& sf
                                                                                         constraint.ObservationFirst,
                                                                                         constraint.ObservationSecond);
         
-        problem.AddResidualBlock(costFunction, lossFunction, intrinsicBlockPtr_1, poseBlockPtr_1, poseBlockPtr_2);
+        _constraintsResiduals.push_back(problem.AddResidualBlock(costFunction, lossFunction, intrinsicBlockPtr_1, poseBlockPtr_1, poseBlockPtr_2));
     }
 }
 
@@ -724,15 +835,64 @@ void BundleAdjustmentCeres::addRotationPriorsToProblem(const sfmData::SfMData& s
         assert(pose_1.getState() != EEstimatorParameterState::IGNORED);
         assert(pose_2.getState() != EEstimatorParameterState::IGNORED);
 
-        double* poseBlockPtr_1 = _posesBlocks.at(view_1.getPoseId()).data();
-        double* poseBlockPtr_2 = _posesBlocks.at(view_2.getPoseId()).data();
+        double* poseBlockPtr_1 = _posesBlocks.at(view_1.getPoseId());
+        double* poseBlockPtr_2 = _posesBlocks.at(view_2.getPoseId());
 
         ceres::CostFunction* costFunction =
           new ceres::AutoDiffCostFunction<RotationPriorErrorFunctor, 3, 6, 6>(new RotationPriorErrorFunctor(prior._second_R_first));
-        problem.AddResidualBlock(costFunction, lossFunction, poseBlockPtr_1, poseBlockPtr_2);
+        _constraintsResiduals.push_back(problem.AddResidualBlock(costFunction, lossFunction, poseBlockPtr_1, poseBlockPtr_2));
     }
 }
 
+void BundleAdjustmentCeres::addParametersPriorsToProblem(ceres::Problem& problem)
+{
+    const auto addPriors = [&](const std::map<IndexT, ParameterPrior>& priors, const auto& getBlock, const auto& createCostFunction) {
+        for (const auto& priorPair : priors)
+        {
+            const ParameterPrior& prior = priorPair.second;
+            double* blockPtr = getBlock(priorPair.first);
+
+            // parameter not in the problem or not refined
+            if (blockPtr == nullptr || prior.weight <= 0.0 || problem.IsParameterBlockConstant(blockPtr))
+                continue;
+
+            assert(static_cast<int>(prior.target.size()) == problem.ParameterBlockSize(blockPtr));
+
+            _constraintsResiduals.push_back(problem.AddResidualBlock(createCostFunction(prior), nullptr, blockPtr));
+        }
+    };
+
+    // euclidean distance to the target
+    const auto createParameterPriorCostFunction = [](const ParameterPrior& prior) -> ceres::CostFunction* {
+        return new ParameterPriorCostFunction(prior.target, prior.weight);
+    };
+
+    // the rotation distance is computed on the rotation manifold, the angle-axis blocks are not compared
+    addPriors(
+      _parametersPriors.poses,
+      [&](IndexT poseId) -> double* {
+          const auto it = _posesBlocks.find(poseId);
+          return (it == _posesBlocks.end() || !problem.HasParameterBlock(it->second)) ? nullptr : it->second;
+      },
+      [](const ParameterPrior& prior) -> ceres::CostFunction* {
+          return new ceres::AutoDiffCostFunction<PosePriorErrorFunctor, 6, 6>(new PosePriorErrorFunctor(prior.target, prior.weight));
+      });
+    addPriors(
+      _parametersPriors.intrinsics,
+      [&](IndexT intrinsicId) -> double* {
+          const auto it = _intrinsicsBlocks.find(intrinsicId);
+          return (it == _intrinsicsBlocks.end() || !problem.HasParameterBlock(it->second.data())) ? nullptr : it->second.data();
+      },
+      createParameterPriorCostFunction);
+    addPriors(
+      _parametersPriors.landmarks,
+      [&](IndexT landmarkId) -> double* {
+          const auto it = _landmarksBlocks.find(landmarkId);
+          return (it == _landmarksBlocks.end() || !problem.HasParameterBlock(it->second)) ? nullptr : it->second;
+      },
+      createParameterPriorCostFunction);
+}
+
 void BundleAdjustmentCeres::createProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions, ceres::Problem& problem)
 {
     // clear previously computed data
@@ -756,21 +916,486 @@ void BundleAdjustmentCeres::createProblem(const sfmData::SfMData& sfmData, ERefi
 
     // add rotation priors to the Ceres problem
     addRotationPriorsToProblem(sfmData, refineOptions, problem);
+
+    // add parameters priors to the Ceres problem
+    addParametersPriorsToProblem(problem);
 }
 
 void BundleAdjustmentCeres::resetProblem()
 {
     _statistics = Statistics();
 
+    // the persistent problem references the parameter blocks
+    _problem.reset();
+    _problemRefineOptions = REFINE_NONE;
+    _problemLossFunction.reset();
+    _landmarksResiduals.clear();
+    _constraintsResiduals.clear();
+
     _allParametersBlocks.clear();
     _posesBlocks.clear();
     _intrinsicsBlocks.clear();
     _landmarksBlocks.clear();
     _rigBlocks.clear();
+    _posesPool.clear();
+    _landmarksPool.clear();
 
     _linearSolverOrdering.Clear();
 }
 
+ceres::Problem& BundleAdjustmentCeres::updateIncrementalProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+    try
+    {
+        updateIncrementalProblemBlocks(sfmData, refineOptions);
+    }
+    catch (...)
+    {
+        // the persistent problem is partially updated
+        resetProblem();
+        throw;
+    }
+    return *_problem;
+}
+
+void BundleAdjustmentCeres::updateIncrementalProblemBlocks(const sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+    // ensure we are not using incompatible options
+    assert(!((refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_ALWAYS) && (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_IF_ENOUGH_DATA)));
+
+    // the parameterization of the blocks depends on the refine options
+    // and the residual blocks reference the loss function
+    if (_problem && (refineOptions != _problemRefineOptions || _ceresOptions.lossFunction != _problemLossFunction))
+        resetProblem();
+
+    // an intrinsic parameter block cannot be resized
+    if (_problem)
+    {
+        for (const auto& intrinsicBlockPair : _intrinsicsBlocks)
+        {
+            const auto intrinsicIt = sfmData.getIntrinsics().find(intrinsicBlockPair.first);
+            if (intrinsicIt != sfmData.getIntrinsics().end() && intrinsicIt->second->getParams().size() != intrinsicBlockPair.second.size())
+            {
+                resetProblem();
+                break;
+            }
+        }
+    }
+
+    if (!_problem)
+    {
+        ceres::Problem::Options problemOptions;
+        problemOptions.loss_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+        problemOptions.evaluation_callback = this;
+        // residual blocks are removed between the adjustments
+        problemOptions.enable_fast_removal = true;
+        _problem = std::make_unique<ceres::Problem>(problemOptions);
+        _problemRefineOptions = refineOptions;
+        _problemLossFunction = _ceresOptions.lossFunction;
+    }
+
+    _statistics = Statistics();
+
+    ceres::Problem& problem = *_problem;
+    ceres::LossFunction* lossFunction = _problemLossFunction.get();
+
+    const bool refineTranslation = refineOptions & REFINE_TRANSLATION;
+    const bool refineRotation = refineOptions & REFINE_ROTATION;
+    const bool refineStructure = refineOptions & REFINE_STRUCTURE;
+    const std::vector<int> constantExtrinsic = getConstantExtrinsicParameters(refineRotation, refineTranslation);
+
+    // the 2D constraints and the rotation priors are rebuilt
+    for (const ceres::ResidualBlockId residualBlockId : _constraintsResiduals)
+        problem.RemoveResidualBlock(residualBlockId);
+    _constraintsResiduals.clear();
+
+    // removed poses and intrinsics blocks, they are removed from the problem
+    // once the residual blocks of the remaining landmarks are updated
+    std::vector<double*> removedPoseBlocks;
+    std::vector<std::vector<double>> removedIntrinsicBlocks;
+    std::set<IndexT> removedPoseIds;
+    std::set<std::pair<IndexT, IndexT>> removedSubPoseIds;
+    std::set<IndexT> removedIntrinsicIds;
+
+    const auto updatePose = [&](const sfmData::CameraPose& cameraPose, bool isConstant, bool isNewBlock, double* poseBlockPtr) {
+        poseToBlock(cameraPose.getTransform(), poseBlockPtr);
+
+        if (isNewBlock)
+        {
+            problem.AddParameterBlock(poseBlockPtr, 6);
+
+            // subset parametrization, the refine options of the problem do not change
+            if (!constantExtrinsic.empty() && constantExtrinsic.size() < 6)
+                problem.SetManifold(poseBlockPtr, new ceres::SubsetManifold(6, constantExtrinsic));
+        }
+
+        // keep the camera extrinsics constants
+        if (cameraPose.isLocked() || isConstant || (!refineTranslation && !refineRotation))
+        {
+            _statistics.addState(EParameter::POSE, EEstimatorParameterState::CONSTANT);
+            problem.SetParameterBlockConstant(poseBlockPtr);
+        }
+        else
+        {
+            _statistics.addState(EParameter::POSE, EEstimatorParameterState::REFINED);
+            problem.SetParameterBlockVariable(poseBlockPtr);
+        }
+    };
+
+    // poses
+    for (auto it = _posesBlocks.begin(); it != _posesBlocks.end();)
+    {
+        const auto poseIt = sfmData.getPoses().find(it->first);
+        if (poseIt == sfmData.getPoses().end() || poseIt->second.getState() == EEstimatorParameterState::IGNORED)
+        {
+            removedPoseIds.insert(it->first);
+            removedPoseBlocks.push_back(it->second);
+            it = _posesBlocks.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (const auto& posePair : sfmData.getPoses())
+    {
+        const sfmData::CameraPose& pose = posePair.second;
+
+        // skip camera pose set as Ignored in the Local strategy
+        if (pose.getState() == EEstimatorParameterState::IGNORED)
+        {
+            _statistics.addState(EParameter::POSE, EEstimatorParameterState::IGNORED);
+            continue;
+        }
+
+        double*& poseBlockPtr = _posesBlocks[posePair.first];
+        const bool isNewBlock = (poseBlockPtr == nullptr);
+        if (isNewBlock)
+            poseBlockPtr = _posesPool.allocate();
+
+        updatePose(pose, pose.getState() == EEstimatorParameterState::CONSTANT, isNewBlock, poseBlockPtr);
+    }
+
+    // rig sub-poses
+    for (auto& rigBlocksPair : _rigBlocks)
+    {
+        const auto rigIt = sfmData.getRigs().find(rigBlocksPair.first);
+
+        for (auto it = rigBlocksPair.second.begin(); it != rigBlocksPair.second.end();)
+        {
+            const bool isValid = (rigIt != sfmData.getRigs().end()) && (it->first < rigIt->second.getNbSubPoses()) &&
+                                 (rigIt->second.getSubPose(it->first).status != sfmData::ERigSubPoseStatus::UNINITIALIZED);
+            if (!isValid)
+            {
+                removedSubPoseIds.emplace(rigBlocksPair.first, it->first);
+                removedPoseBlocks.push_back(it->second);
+                it = rigBlocksPair.second.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    for (const auto& rigPair : sfmData.getRigs())
+    {
+        const IndexT rigId = rigPair.first;
+        const sfmData::Rig& rig = rigPair.second;
+        const std::size_t nbSubPoses = rig.getNbSubPoses();
+
+        for (std::size_t subPoseId = 0; subPoseId < nbSubPoses; ++subPoseId)
+        {
+            const sfmData::RigSubPose& rigSubPose = rig.getSubPose(subPoseId);
+
+            if (rigSubPose.status == sfmData::ERigSubPoseStatus::UNINITIALIZED)
+                continue;
+
+            double*& rigBlockPtr = _rigBlocks[rigId][subPoseId];
+            const bool isNewBlock = (rigBlockPtr == nullptr);
+            if (isNewBlock)
+                rigBlockPtr = _posesPool.allocate();
+
+            updatePose(sfmData::CameraPose(rigSubPose.pose), rigSubPose.status == sfmData::ERigSubPoseStatus::CONSTANT, isNewBlock, rigBlockPtr);
+        }
+    }
+
+    // intrinsics
+    const std::map<IndexT, std::size_t> intrinsicsUsage = getIntrinsicsUsage(sfmData);
+
+    const auto isIntrinsicInProblem = [&](IndexT intrinsicId, const std::shared_ptr<IntrinsicBase>& intrinsicPtr) {
+        const auto usageIt = intrinsicsUsage.find(intrinsicId);
+        return (usageIt != intrinsicsUsage.end()) && (usageIt->second > 0) && (intrinsicPtr->getState() != EEstimatorParameterState::IGNORED) &&
+               (std::dynamic_pointer_cast<camera::IntrinsicScaleOffset>(intrinsicPtr) != nullptr);
+    };
+
+    for (auto it = _intrinsicsBlocks.begin(); it != _intrinsicsBlocks.end();)
+    {
+        const auto intrinsicIt = sfmData.getIntrinsics().find(it->first);
+        if (intrinsicIt == sfmData.getIntrinsics().end() || !isIntrinsicInProblem(it->first, intrinsicIt->second))
+        {
+            // the block memory is kept until the block is removed from the problem
+            removedIntrinsicIds.insert(it->first);
+            removedIntrinsicBlocks.push_back(std::move(it->second));
+            _intrinsicObjects.erase(it->first);
+            it = _intrinsicsBlocks.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (const auto& intrinsicPair : sfmData.getIntrinsics())
+    {
+        const IndexT intrinsicId = intrinsicPair.first;
+        const auto& intrinsicPtr = intrinsicPair.second;
+
+        // if the intrinsic is never referenced by any view, skip it
+        if (intrinsicsUsage.find(intrinsicId) == intrinsicsUsage.end())
+            continue;
+
+        const std::size_t usageCount = intrinsicsUsage.at(intrinsicId);
+
+        // do not refine an intrinsic does not used by any reconstructed view
+        if (usageCount <= 0 || intrinsicPtr->getState() == EEstimatorParameterState::IGNORED)
+        {
+            _statistics.addState(EParameter::INTRINSIC, EEstimatorParameterState::IGNORED);
+            continue;
+        }
+
+        if (!isIntrinsicInProblem(intrinsicId, intrinsicPtr))
+            continue;
+
+        assert(isValid(intrinsicPtr->getType()));
+
+        const auto blockIt = _intrinsicsBlocks.find(intrinsicId);
+
+        if (blockIt == _intrinsicsBlocks.end())
+        {
+            _intrinsicObjects[intrinsicId].reset(intrinsicPtr->clone());
+
+            std::vector<double>& intrinsicBlock = _intrinsicsBlocks[intrinsicId];
+            intrinsicBlock = intrinsicPtr->getParams();
+            problem.AddParameterBlock(intrinsicBlock.data(), intrinsicBlock.size());
+        }
+        else
+        {
+            std::vector<double>& intrinsicBlock = blockIt->second;
+            const std::vector<double> params = intrinsicPtr->getParams();
+            std::copy(params.begin(), params.end(), intrinsicBlock.begin());
+
+            // the cost functions share the intrinsic object, it is updated in place
+            _intrinsicObjects.at(intrinsicId)->updateFromParams(params);
+
+            // clear the bounds of the previous parameterization
+            for (std::size_t i = 0; i < intrinsicBlock.size(); ++i)
+            {
+                problem.SetParameterLowerBound(intrinsicBlock.data(), static_cast<int>(i), std::numeric_limits<double>::lowest());
+                problem.SetParameterUpperBound(intrinsicBlock.data(), static_cast<int>(i), std::numeric_limits<double>::max());
+            }
+        }
+
+        setIntrinsicParameterization(intrinsicPtr, usageCount, refineOptions, _intrinsicsBlocks.at(intrinsicId), problem);
+    }
+
+    // landmarks
+    for (auto it = _landmarksBlocks.begin(); it != _landmarksBlocks.end();)
+    {
+        const auto landmarkIt = sfmData.getLandmarks().find(it->first);
+        if (landmarkIt == sfmData.getLandmarks().end() || landmarkIt->second.state == EEstimatorParameterState::IGNORED)
+        {
+            // the residual blocks of the landmark are removed with its parameter block
+            problem.RemoveParameterBlock(it->second);
+            _linearSolverOrdering.Remove(it->second);
+            _landmarksPool.release(it->second);
+            _landmarksResiduals.erase(it->first);
+            it = _landmarksBlocks.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // check if the residual block of an observation references a removed parameter block
+    const auto isObservationViewRemoved = [&](IndexT viewId) {
+        const sfmData::View& view = sfmData.getView(viewId);
+        return removedPoseIds.count(view.getPoseId()) || removedIntrinsicIds.count(view.getIntrinsicId()) ||
+               (view.isPartOfRig() && !view.isPoseIndependant() && removedSubPoseIds.count(std::make_pair(view.getRigId(), view.getSubPoseId())));
+    };
+
+    // new observations: <landmarkId, viewId>
+    std::vector<std::pair<IndexT, IndexT>> newObservations;
+
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        const IndexT landmarkId = landmarkPair.first;
+        const sfmData::Landmark& landmark = landmarkPair.second;
+
+        // do not create a residual block if the landmark
+        // have been set as Ignored by the Local BA strategy
+        if (landmark.state == EEstimatorParameterState::IGNORED)
+        {
+            _statistics.addState(EParameter::LANDMARK, EEstimatorParameterState::IGNORED);
+            continue;
+        }
+
+        double*& landmarkBlockPtr = _landmarksBlocks[landmarkId];
+        if (landmarkBlockPtr == nullptr)
+        {
+            landmarkBlockPtr = _landmarksPool.allocate();
+            problem.AddParameterBlock(landmarkBlockPtr, 3);
+        }
+
+        for (std::size_t j = 0; j < 3; ++j)
+            landmarkBlockPtr[j] = landmark.X(Eigen::Index(j));
+
+        // remove the residual blocks of the removed or modified observations
+        std::map<IndexT, ObservationResidual>& residuals = _landmarksResiduals[landmarkId];
+
+        for (auto it = residuals.begin(); it != residuals.end();)
+        {
+            const auto observationIt = landmark.getObservations().find(it->first);
+            if (observationIt == landmark.getObservations().end() || !(observationIt->second == it->second.observation) ||
+                isObservationViewRemoved(it->first))
+            {
+                problem.RemoveResidualBlock(it->second.residualBlockId);
+                it = residuals.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        for (const auto& observationPair : landmark.getObservations())
+        {
+            if (residuals.find(observationPair.first) == residuals.end())
+                newObservations.emplace_back(landmarkId, observationPair.first);
+        }
+
+        if (!refineStructure || landmark.state == EEstimatorParameterState::CONSTANT)
+        {
+            // set the whole landmark parameter block as constant.
+            problem.SetParameterBlockConstant(landmarkBlockPtr);
+            for (std::size_t i = 0; i < landmark.getObservations().size(); ++i)
+                _statistics.addState(EParameter::LANDMARK, EEstimatorParameterState::CONSTANT);
+        }
+        else
+        {
+            problem.SetParameterBlockVariable(landmarkBlockPtr);
+            for (std::size_t i = 0; i < landmark.getObservations().size(); ++i)
+                _statistics.addState(EParameter::LANDMARK, EEstimatorParameterState::REFINED);
+        }
+    }
+
+    // create the cost functions of the new observations in parallel (observation undistortion)
+    const std::ptrdiff_t nbNewObservations = static_cast<std::ptrdiff_t>(newObservations.size());
+    std::vector<ceres::CostFunction*> costFunctions(newObservations.size(), nullptr);
+    std::exception_ptr costFunctionsException;
+
+#pragma omp parallel for schedule(dynamic, 256)
+    for (std::ptrdiff_t i = 0; i < nbNewObservations; ++i)
+    {
+        try
+        {
+            const IndexT landmarkId = newObservations[i].first;
+            const IndexT viewId = newObservations[i].second;
+            const sfmData::View& view = sfmData.getView(viewId);
+
+            costFunctions[i] = createObservationCostFunction(
+              _intrinsicObjects.at(view.getIntrinsicId()), view, sfmData.getLandmarks().at(landmarkId).getObservations().at(viewId));
+        }
+        catch (...)
+        {
+#pragma omp critical
+            costFunctionsException = std::current_exception();
+        }
+    }
+
+    if (costFunctionsException)
+    {
+        for (ceres::CostFunction* costFunction : costFunctions)
+            delete costFunction;
+        std::rethrow_exception(costFunctionsException);
+    }
+
+    // add the residual blocks of the new observations
+    std::ptrdiff_t nbAddedCostFunctions = 0;
+    try
+    {
+        for (std::ptrdiff_t i = 0; i < nbNewObservations; ++i)
+        {
+            const IndexT landmarkId = newObservations[i].first;
+            const IndexT viewId = newObservations[i].second;
+            const sfmData::View& view = sfmData.getView(viewId);
+            const sfmData::Observation& observation = sfmData.getLandmarks().at(landmarkId).getObservations().at(viewId);
+
+            double* landmarkBlockPtr = _landmarksBlocks.at(landmarkId);
+            double* poseBlockPtr = _posesBlocks.at(view.getPoseId());
+            double* intrinsicBlockPtr = _intrinsicsBlocks.at(view.getIntrinsicId()).data();
+
+            // apply a specific parameter ordering:
+            if (_ceresOptions.useParametersOrdering)
+            {
+                _linearSolverOrdering.AddElementToGroup(landmarkBlockPtr, 0);
+                _linearSolverOrdering.AddElementToGroup(poseBlockPtr, 1);
+                _linearSolverOrdering.AddElementToGroup(intrinsicBlockPtr, 2);
+            }
+
+            ceres::ResidualBlockId residualBlockId;
+
+            if (view.isPartOfRig() && !view.isPoseIndependant())
+            {
+                double* rigBlockPtr = _rigBlocks.at(view.getRigId()).at(view.getSubPoseId());
+                _linearSolverOrdering.AddElementToGroup(rigBlockPtr, 1);
+
+                residualBlockId = problem.AddResidualBlock(costFunctions[i], lossFunction, intrinsicBlockPtr, poseBlockPtr, rigBlockPtr, landmarkBlockPtr);
+            }
+            else
+            {
+                residualBlockId = problem.AddResidualBlock(costFunctions[i], lossFunction, intrinsicBlockPtr, poseBlockPtr, landmarkBlockPtr);
+            }
+            // the cost function is owned by the problem
+            nbAddedCostFunctions = i + 1;
+
+            _landmarksResiduals[landmarkId][viewId] = {observation, residualBlockId};
+        }
+    }
+    catch (...)
+    {
+        // the cost functions not added yet are not owned by the problem
+        for (std::ptrdiff_t i = nbAddedCostFunctions; i < nbNewObservations; ++i)
+            delete costFunctions[i];
+        throw;
+    }
+
+    // remove the poses and intrinsics blocks, they are not referenced by residual blocks anymore
+    for (double* poseBlockPtr : removedPoseBlocks)
+    {
+        problem.RemoveParameterBlock(poseBlockPtr);
+        _linearSolverOrdering.Remove(poseBlockPtr);
+        _posesPool.release(poseBlockPtr);
+    }
+
+    for (std::vector<double>& intrinsicBlock : removedIntrinsicBlocks)
+    {
+        problem.RemoveParameterBlock(intrinsicBlock.data());
+        _linearSolverOrdering.Remove(intrinsicBlock.data());
+    }
+
+    // add 2D constraints to the Ceres problem
+    addConstraints2DToProblem(sfmData, refineOptions, problem);
+
+    // add rotation priors to the Ceres problem
+    addRotationPriorsToProblem(sfmData, refineOptions, problem);
+
+    // add parameters priors to the Ceres problem
+    addParametersPriorsToProblem(problem);
+}
+
 void BundleAdjustmentCeres::updateFromSolution(sfmData::SfMData& sfmData, ERefineOptions refineOptions) const
 {
     const bool refinePoses = (refineOptions & REFINE_ROTATION) || (refineOptions & REFINE_TRANSLATION);
@@ -792,11 +1417,11 @@ void BundleAdjustmentCeres::updateFromSolution(sfmData::SfMData& sfmData, ERefin
             if (posePair.second.getState() != EEstimatorParameterState::REFINED)
                 continue;
 
-            const std::array<double, 6>& poseBlock = _posesBlocks.at(poseId);
+            const double* poseBlock = _posesBlocks.at(poseId);
 
             Mat3 R_refined;
-            ceres::AngleAxisToRotationMatrix(poseBlock.data(), R_refined.data());
-            const Vec3 t_refined(poseBlock.at(3), poseBlock.at(4), poseBlock.at(5));
+            ceres::AngleAxisToRotationMatrix(poseBlock, R_refined.data());
+            const Vec3 t_refined(poseBlock[3], poseBlock[4], poseBlock[5]);
 
             // update the pose
             posePair.second.setTransform(poseFromRT(R_refined, t_refined));
@@ -810,11 +1435,11 @@ void BundleAdjustmentCeres::updateFromSolution(sfmData::SfMData& sfmData, ERefin
             for (const auto& subPoseit : rigIt.second)
             {
                 sfmData::RigSubPose& subPose = rig.getSubPose(subPoseit.first);
-                const std::array<double, 6>& subPoseBlock = subPoseit.second;
+                const double* subPoseBlock = subPoseit.second;
 
                 Mat3 R_refined;
-                ceres::AngleAxisToRotationMatrix(subPoseBlock.data(), R_refined.data());
-                const Vec3 t_refined(subPoseBlock.at(3), subPoseBlock.at(4), subPoseBlock.at(5));
+                ceres::AngleAxisToRotationMatrix(subPoseBlock, R_refined.data());
+                const Vec3 t_refined(subPoseBlock[3], subPoseBlock[4], subPoseBlock[5]);
 
                 // update the sub-pose
                 subPose.pose = poseFromRT(R_refined, t_refined);
@@ -857,7 +1482,7 @@ void BundleAdjustmentCeres::updateFromSolution(sfmData::SfMData& sfmData, ERefin
 
             for (std::size_t i = 0; i < 3; ++i)
             {
-                landmark.X(Eigen::Index(i)) = landmarksBlockPair.second.at(i);
+                landmark.X(Eigen::Index(i)) = landmarksBlockPair.second[i];
             }
         }
     }
@@ -884,12 +1509,24 @@ void BundleAdjustmentCeres::createJacobian(const sfmData::SfMData& sfmData, ERef
 
 bool BundleAdjustmentCeres::adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions)
 {
-    // create problem
-    ceres::Problem::Options problemOptions;
-    problemOptions.loss_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
-    problemOptions.evaluation_callback = this;
-    ceres::Problem problem(problemOptions);
-    createProblem(sfmData, refineOptions, problem);
+    std::unique_ptr<ceres::Problem> localProblem;
+    ceres::Problem* problem = nullptr;
+
+    if (_ceresOptions.incremental)
+    {
+        // update the persistent problem with the changes of the scene
+        problem = &updateIncrementalProblem(sfmData, refineOptions);
+    }
+    else
+    {
+        // create problem
+        ceres::Problem::Options problemOptions;
+        problemOptions.loss_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+        problemOptions.evaluation_callback = this;
+        localProblem = std::make_unique<ceres::Problem>(problemOptions);
+        createProblem(sfmData, refineOptions, *localProblem);
+        problem = localProblem.get();
+    }
 
     // configure a Bundle Adjustment engine and run it
     // make Ceres automatically detect the bundle structure.
@@ -898,7 +1535,7 @@ bool BundleAdjustmentCeres::adjust(sfmData::SfMData& sfmData, ERefineOptions ref
 
     // solve BA
     ceres::Solver::Summary summary;
-    ceres::Solve(options, &problem, &summary);
+    ceres::Solve(options, problem, &summary);
 
     // print summary
     if (_ceresOptions.summary)
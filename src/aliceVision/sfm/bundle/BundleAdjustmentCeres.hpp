@@ -10,14 +10,18 @@
 #include <aliceVision/types.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
+#include <aliceVision/sfm/bundle/ParameterBlocksPool.hpp>
 #include <aliceVision/sfm/LocalBundleAdjustmentGraph.hpp>
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/sfmData/CameraPose.hpp>
+#include <aliceVision/sfmData/Observation.hpp>
 #include <aliceVision/camera/IntrinsicBase.hpp>
 
 #include <ceres/ceres.h>
 
+#include <map>
 #include <memory>
+#include <vector>
 
 namespace aliceVision {
 
@@ -58,6 +62,8 @@ class BundleAdjustmentCeres : public BundleAdjustment, ceres::EvaluationCallback
         bool summary = false;
         bool verbose = true;
         bool useFocalPrior = true;
+        /// keep the ceres problem across the adjustments and only update what changed in the scene
+        bool incremental = false;
     };
 
     /**
@@ -108,6 +114,39 @@ class BundleAdjustmentCeres : public BundleAdjustment, ceres::EvaluationCallback
         std::map<EParameter, std::map<EEstimatorParameterState, std::size_t>> parametersStates;
         /// The distribution of the cameras for each graph distance <distance, numOfCam>
         std::map<int, std::size_t> nbCamerasPerDistance;
+        /// number of consensus iterations (partitioned bundle adjustment only)
+        int nbConsensusIterations = 0;
+        /// primal residuals of the last consensus iteration, per shared parameter (partitioned bundle adjustment only)
+        std::map<EParameter, double> consensusPrimalResiduals;
+        /// dual residuals of the last consensus iteration, per shared parameter (partitioned bundle adjustment only)
+        std::map<EParameter, double> consensusDualResiduals;
+    };
+
+    /**
+     * @brief Quadratic prior pulling a parameter block toward a target value,
+     *        e.g. the consensus value of a parameter shared between partitions of the scene.
+     */
+    struct ParameterPrior
+    {
+        /// target value in the Ceres block format
+        std::vector<double> target;
+        /// residuals = weight * (block - target), on the rotation manifold for the poses rotation
+        double weight = 0.0;
+    };
+
+    /**
+     * @brief Parameters priors, per parameter id.
+     */
+    struct ParametersPriors
+    {
+        /// poses priors, block: ceres angleAxis(3) + translation(3)
+        std::map<IndexT, ParameterPrior> poses;
+        /// intrinsics priors, block: intrinsics params
+        std::map<IndexT, ParameterPrior> intrinsics;
+        /// landmarks priors, block: 3d position(3)
+        std::map<IndexT, ParameterPrior> landmarks;
+
+        inline bool empty() const { return poses.empty() && intrinsics.empty() && landmarks.empty(); }
     };
 
     /**
@@ -145,6 +184,26 @@ class BundleAdjustmentCeres : public BundleAdjustment, ceres::EvaluationCallback
      */
     inline const Statistics& getStatistics() const { return _statistics; }
 
+    /**
+     * @brief Get the user Ceres options
+     * @return the Ceres options
+     */
+    inline const CeresOptions& getCeresOptions() const { return _ceresOptions; }
+
+    /**
+     * @brief Set the user Ceres options used by the next adjustments
+     * @note In incremental mode, the persistent problem is rebuilt if the loss function changes.
+     * @param[in] options The user Ceres options
+     */
+    inline void setCeresOptions(const CeresOptions& options) { _ceresOptions = options; }
+
+    /**
+     * @brief Set the parameters priors added to the problem of the next adjustments
+     * @note Priors of parameters which are not refined (constant or ignored) have no effect.
+     * @param[in] priors The parameters priors
+     */
+    inline void setParametersPriors(const ParametersPriors& priors) { _parametersPriors = priors; }
+
   private:
     /**
      * @brief Clear structures for a new problem
@@ -197,6 +256,12 @@ class BundleAdjustmentCeres : public BundleAdjustment, ceres::EvaluationCallback
      */
     void addRotationPriorsToProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions, ceres::Problem& problem);
 
+    /**
+     * @brief Create a residual block for each parameter prior
+     * @param[out] problem The Ceres bundle adjustement problem
+     */
+    void addParametersPriorsToProblem(ceres::Problem& problem);
+
     /**
      * @brief Create the Ceres bundle adjustement problem with:
      *  - extrincics and intrinsics parameters blocks.
@@ -207,6 +272,41 @@ class BundleAdjustmentCeres : public BundleAdjustment, ceres::EvaluationCallback
      */
     void createProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions, ceres::Problem& problem);
 
+    /**
+     * @brief Update the persistent Ceres problem with the changes of the scene since the last adjustment:
+     *  - add the new parameter blocks and the residual blocks of the new observations.
+     *  - remove the parameter blocks set as Ignored or removed from the scene, and the residual blocks of the removed observations.
+     *  - update the values and the states of the remaining parameter blocks.
+     * @note The problem is rebuilt if the refine options or the loss function have changed,
+     *       and reset if the update throws.
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] refineOptions The chosen refine flag
+     * @return the persistent Ceres problem
+     */
+    ceres::Problem& updateIncrementalProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions);
+
+    /**
+     * @brief Update the blocks of the persistent Ceres problem, see updateIncrementalProblem
+     * @note The problem can be partially updated if an exception is thrown.
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] refineOptions The chosen refine flag
+     */
+    void updateIncrementalProblemBlocks(const sfmData::SfMData& sfmData, ERefineOptions refineOptions);
+
+    /**
+     * @brief Set the Ceres parameterization of an intrinsic parameter block (constant, bounds, manifold)
+     * @param[in] intrinsic The intrinsic
+     * @param[in] usageCount The number of reconstructed views using this intrinsic
+     * @param[in] refineOptions The chosen refine flag
+     * @param[in,out] intrinsicBlock The intrinsic parameter block
+     * @param[out] problem The Ceres bundle adjustement problem
+     */
+    void setIntrinsicParameterization(const std::shared_ptr<camera::IntrinsicBase>& intrinsic,
+                                      std::size_t usageCount,
+                                      ERefineOptions refineOptions,
+                                      std::vector<double>& intrinsicBlock,
+                                      ceres::Problem& problem);
+
     /**
      * @brief Update The given SfMData with the solver solution
      * @param[in,out] sfmData The input SfMData contains all the information about the reconstruction, notably the poses and sub-poses
@@ -223,6 +323,9 @@ class BundleAdjustmentCeres : public BundleAdjustment, ceres::EvaluationCallback
     /// user FeatureConstraint options to use
     EFeatureConstraint _featureConstraint;
 
+    /// user parameters priors
+    ParametersPriors _parametersPriors;
+
     /// last adjustment iteration statisics
     Statistics _statistics;
 
@@ -230,23 +333,47 @@ class BundleAdjustmentCeres : public BundleAdjustment, ceres::EvaluationCallback
 
     /// all parameters blocks pointers
     std::vector<double*> _allParametersBlocks;
+    /// poses and rig sub-poses blocks storage
+    ParameterBlocksPool<6> _posesPool;
+    /// landmarks blocks storage
+    ParameterBlocksPool<3> _landmarksPool;
     /// poses blocks wrapper
     /// block: ceres angleAxis(3) + translation(3)
-    std::map<IndexT, std::array<double, 6>> _posesBlocks;  // TODO : maybe we can use boost::flat_map instead of std::map ?
+    std::map<IndexT, double*> _posesBlocks;  // TODO : maybe we can use boost::flat_map instead of std::map ?
     /// intrinsics blocks wrapper
     /// block: intrinsics params
     std::map<IndexT, std::vector<double>> _intrinsicsBlocks;
     std::map<IndexT, std::shared_ptr<camera::IntrinsicBase>> _intrinsicObjects;
     /// landmarks blocks wrapper
     /// block: 3d position(3)
-    std::map<IndexT, std::array<double, 3>> _landmarksBlocks;
+    std::map<IndexT, double*> _landmarksBlocks;
     /// rig sub-poses blocks wrapper
     /// block: ceres angleAxis(3) + translation(3)
-    std::map<IndexT, std::map<IndexT, std::array<double, 6>>> _rigBlocks;
+    std::map<IndexT, std::map<IndexT, double*>> _rigBlocks;
 
     /// hinted order for ceres to eliminate blocks when solving.
-    /// note: this ceres parameter is built internally and must be reset on each call to the solver.
+    /// note: this ceres parameter is built internally and copied on each call to the solver.
     ceres::ParameterBlockOrdering _linearSolverOrdering;
+
+    // persistent problem (incremental mode)
+
+    /// residual block of a landmark observation in the persistent problem
+    struct ObservationResidual
+    {
+        sfmData::Observation observation;
+        ceres::ResidualBlockId residualBlockId;
+    };
+
+    /// persistent Ceres problem, kept across the adjustments
+    std::unique_ptr<ceres::Problem> _problem;
+    /// refine options of the persistent problem
+    ERefineOptions _problemRefineOptions = REFINE_NONE;
+    /// loss function of the residual blocks of the persistent problem
+    std::shared_ptr<ceres::LossFunction> _problemLossFunction;
+    /// residual blocks of the landmarks observations: <landmarkId, <viewId, residual>>
+    std::map<IndexT, std::map<IndexT, ObservationResidual>> _landmarksResiduals;
+    /// residual blocks of the 2D constraints, of the rotation priors and of the parameters priors, rebuilt on each update
+    std::vector<ceres::ResidualBlockId> _constraintsResiduals;
 };
 
 }  // namespace sfm
@@ -0,0 +1,971 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/bundle/BundleAdjustmentPartitioned.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <ceres/rotation.h>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace aliceVision {
+namespace sfm {
+
+/**
+ * @brief Copies of a parameter shared between clusters, and their consensus
+ */
+struct SharedParameter
+{
+    /// consensus value (z)
+    std::vector<double> consensus;
+    /// values of the copies of the clusters (x)
+    std::vector<std::vector<double>> values;
+    /// scaled dual variables of the copies (u)
+    std::vector<std::vector<double>> duals;
+};
+
+/**
+ * @brief Write a pose in a consensus block according to the Ceres format: [Rx, Ry, Rz, tx, ty, tz]
+ * @note The angle-axis is the equivalent representation closest to the reference block (if any),
+ *       so the blocks of the copies of a pose can be averaged.
+ * @param[in] pose The pose
+ * @param[in] referenceBlock The reference pose block, may be empty
+ * @return the pose block
+ */
+std::vector<double> poseToConsensusBlock(const geometry::Pose3& pose, const std::vector<double>& referenceBlock)
+{
+    const Mat3& R = pose.rotation();
+    const Vec3& t = pose.translation();
+
+    std::vector<double> poseBlock(6);
+    ceres::RotationMatrixToAngleAxis(static_cast<const double*>(R.data()), poseBlock.data());
+    poseBlock[3] = t(0);
+    poseBlock[4] = t(1);
+    poseBlock[5] = t(2);
+
+    if (!referenceBlock.empty())
+    {
+        const Vec3 angleAxis(poseBlock[0], poseBlock[1], poseBlock[2]);
+        const Vec3 referenceAngleAxis(referenceBlock[0], referenceBlock[1], referenceBlock[2]);
+        const double angle = angleAxis.norm();
+
+        if (angle > 0.0)
+        {
+            // same rotation: angle - 2pi around the same axis
+            const Vec3 otherAngleAxis = angleAxis * (1.0 - 2.0 * M_PI / angle);
+
+            if ((otherAngleAxis - referenceAngleAxis).squaredNorm() < (angleAxis - referenceAngleAxis).squaredNorm())
+            {
+                poseBlock[0] = otherAngleAxis(0);
+                poseBlock[1] = otherAngleAxis(1);
+                poseBlock[2] = otherAngleAxis(2);
+            }
+        }
+    }
+
+    return poseBlock;
+}
+
+/**
+ * @brief Read a pose from a consensus block according to the Ceres format: [Rx, Ry, Rz, tx, ty, tz]
+ * @param[in] poseBlock The pose block
+ * @return the pose
+ */
+geometry::Pose3 consensusBlockToPose(const std::vector<double>& poseBlock)
+{
+    Mat3 R;
+    ceres::AngleAxisToRotationMatrix(poseBlock.data(), R.data());
+    const Vec3 t(poseBlock[3], poseBlock[4], poseBlock[5]);
+    return geometry::poseFromRT(R, t);
+}
+
+/**
+ * @brief Compute the squared euclidean distance between two blocks
+ */
+double squaredDistance(const std::vector<double>& a, const std::vector<double>& b)
+{
+    double distance = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        distance += (a[i] - b[i]) * (a[i] - b[i]);
+    return distance;
+}
+
+/**
+ * @brief Compute the squared euclidean norm of a block
+ */
+double squaredNorm(const std::vector<double>& a)
+{
+    double norm = 0.0;
+    for (const double value : a)
+        norm += value * value;
+    return norm;
+}
+
+/**
+ * @brief Compute the Root Mean Square Error of the reprojection residuals
+ * @note Unlike sfm::RMSE, the residuals are not stored, the scene may be very large.
+ * @param[in] sfmData The given input SfMData
+ * @return RMSE value
+ */
+double computeReprojectionRMSE(const sfmData::SfMData& sfmData)
+{
+    double squaredError = 0.0;
+    std::size_t nbResiduals = 0;
+
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        const sfmData::Landmark& landmark = landmarkPair.second;
+
+        if (landmark.state == EEstimatorParameterState::IGNORED)
+            continue;
+
+        for (const auto& observationPair : landmark.getObservations())
+        {
+            const sfmData::View& view = sfmData.getView(observationPair.first);
+            const geometry::Pose3 pose = sfmData.getPose(view).getTransform();
+            const camera::IntrinsicBase& intrinsic = *sfmData.getIntrinsics().at(view.getIntrinsicId());
+            const Vec2 residual = intrinsic.residual(pose, landmark.X.homogeneous(), observationPair.second.getCoordinates());
+
+            squaredError += residual.squaredNorm();
+            nbResiduals += 2;
+        }
+    }
+
+    return (nbResiduals == 0) ? 0.0 : std::sqrt(squaredError / nbResiduals);
+}
+
+std::size_t BundleAdjustmentPartitioned::estimateProblemMemory(std::size_t nbPoses,
+                                                               std::size_t nbLandmarks,
+                                                               std::size_t nbObservations,
+                                                               std::size_t nbPosesPairs,
+                                                               bool denseSchur)
+{
+    // rough costs of the Ceres blocks: parameter blocks, residual blocks, cost functions,
+    // jacobians and Schur eliminator buffers
+    const std::size_t bytesPerObservation = 512;
+    const std::size_t bytesPerLandmark = 256;
+    const std::size_t bytesPerPose = 1024;
+    // a 6x6 block of the reduced camera system
+    const std::size_t bytesPerPosesBlock = 6 * 6 * sizeof(double);
+    // fill-in of the sparse factorization of the reduced camera system
+    const std::size_t sparseFillFactor = 4;
+
+    std::size_t memory = nbObservations * bytesPerObservation + nbLandmarks * bytesPerLandmark + nbPoses * bytesPerPose;
+
+    if (denseSchur)
+        memory += nbPoses * nbPoses * bytesPerPosesBlock;
+    else
+        memory += (nbPoses + nbPosesPairs) * bytesPerPosesBlock * sparseFillFactor;
+
+    return memory;
+}
+
+BundleAdjustmentPartitioned::ProblemSize BundleAdjustmentPartitioned::getProblemSize(const sfmData::SfMData& sfmData)
+{
+    ProblemSize problemSize;
+
+    for (const auto& posePair : sfmData.getPoses())
+    {
+        if (posePair.second.getState() != EEstimatorParameterState::IGNORED)
+            ++problemSize.nbPoses;
+    }
+
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        if (landmarkPair.second.state == EEstimatorParameterState::IGNORED)
+            continue;
+
+        const std::size_t nbObservations = landmarkPair.second.getObservations().size();
+        ++problemSize.nbLandmarks;
+        problemSize.nbObservations += nbObservations;
+        problemSize.nbPosesPairs += (nbObservations > 1) ? nbObservations * (nbObservations - 1) / 2 : 0;
+    }
+
+    if (problemSize.nbPoses > 1)
+        problemSize.nbPosesPairs = std::min(problemSize.nbPosesPairs, problemSize.nbPoses * (problemSize.nbPoses - 1) / 2);
+
+    return problemSize;
+}
+
+bool BundleAdjustmentPartitioned::isPartitioned(const sfmData::SfMData& sfmData) const
+{
+    const ProblemSize problemSize = getProblemSize(sfmData);
+    const bool denseSchur = (_ceresOptions.linearSolverType == ceres::DENSE_SCHUR);
+    const std::size_t memoryBudget = _partitionOptions.memoryBudgetMB * 1024 * 1024;
+    const std::size_t problemMemory =
+      estimateProblemMemory(problemSize.nbPoses, problemSize.nbLandmarks, problemSize.nbObservations, problemSize.nbPosesPairs, denseSchur);
+
+    return (memoryBudget > 0 && problemMemory > memoryBudget) ||
+           (_partitionOptions.maxNbPosesPerCluster > 0 && problemSize.nbPoses > _partitionOptions.maxNbPosesPerCluster);
+}
+
+std::unique_ptr<BundleAdjustmentPartitioned> BundleAdjustmentPartitioned::createIfPartitioned(const sfmData::SfMData& sfmData,
+                                                                                          const BundleAdjustmentCeres::CeresOptions& ceresOptions,
+                                                                                          std::size_t memoryBudgetMB,
+                                                                                          int minNbImagesToRefineOpticalCenter)
+{
+    if (memoryBudgetMB == 0)
+        return nullptr;
+
+    // the clusters problems are not kept between the adjustments
+    BundleAdjustmentCeres::CeresOptions options = ceresOptions;
+    options.incremental = false;
+
+    PartitionOptions partitionOptions;
+    partitionOptions.memoryBudgetMB = memoryBudgetMB;
+
+    auto partitionedBA = std::make_unique<BundleAdjustmentPartitioned>(options, partitionOptions, minNbImagesToRefineOpticalCenter);
+    if (!partitionedBA->isPartitioned(sfmData))
+        return nullptr;
+
+    return partitionedBA;
+}
+
+void BundleAdjustmentPartitioned::partition(const sfmData::SfMData& sfmData, std::size_t maxNbPosesPerCluster, std::vector<Cluster>& clusters) const
+{
+    clusters.clear();
+
+    // number of observations per pose, all the adjusted poses are clustered
+    std::map<IndexT, std::size_t> nbObservationsPerPose;
+    for (const auto& posePair : sfmData.getPoses())
+    {
+        if (posePair.second.getState() != EEstimatorParameterState::IGNORED)
+            nbObservationsPerPose[posePair.first] = 0;
+    }
+
+    // covisibility graph of the poses: number of landmarks observed by both poses
+    std::map<IndexT, std::map<IndexT, std::size_t>> covisibility;
+    std::vector<IndexT> landmarkPoses;
+
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        if (landmarkPair.second.state == EEstimatorParameterState::IGNORED)
+            continue;
+
+        landmarkPoses.clear();
+        for (const auto& observationPair : landmarkPair.second.getObservations())
+        {
+            const IndexT poseId = sfmData.getView(observationPair.first).getPoseId();
+            const auto poseIt = nbObservationsPerPose.find(poseId);
+            if (poseIt == nbObservationsPerPose.end())
+                continue;
+
+            ++poseIt->second;
+            landmarkPoses.push_back(poseId);
+        }
+
+        std::sort(landmarkPoses.begin(), landmarkPoses.end());
+        landmarkPoses.erase(std::unique(landmarkPoses.begin(), landmarkPoses.end()), landmarkPoses.end());
+
+        for (std::size_t i = 0; i < landmarkPoses.size(); ++i)
+        {
+            for (std::size_t j = i + 1; j < landmarkPoses.size(); ++j)
+            {
+                ++covisibility[landmarkPoses[i]][landmarkPoses[j]];
+                ++covisibility[landmarkPoses[j]][landmarkPoses[i]];
+            }
+        }
+    }
+
+    // 2D constraints and rotation priors also link their poses
+    const auto linkViews = [&](IndexT viewIdFirst, IndexT viewIdSecond) {
+        const IndexT poseIdFirst = sfmData.getView(viewIdFirst).getPoseId();
+        const IndexT poseIdSecond = sfmData.getView(viewIdSecond).getPoseId();
+
+        if (poseIdFirst == poseIdSecond || nbObservationsPerPose.count(poseIdFirst) == 0 || nbObservationsPerPose.count(poseIdSecond) == 0)
+            return;
+
+        ++covisibility[poseIdFirst][poseIdSecond];
+        ++covisibility[poseIdSecond][poseIdFirst];
+    };
+
+    for (const auto& constraint : sfmData.getConstraints2D())
+        linkViews(constraint.ViewFirst, constraint.ViewSecond);
+
+    for (const auto& prior : sfmData.getRotationPriors())
+        linkViews(prior.ViewFirst, prior.ViewSecond);
+
+    // grow the clusters from the most observed poses, with the most connected poses.
+    // the neighbors of the core poses are potential separators: they bound the size of the cluster.
+    std::set<IndexT> unassignedPoses;
+    for (const auto& posePair : nbObservationsPerPose)
+        unassignedPoses.insert(posePair.first);
+
+    std::map<IndexT, std::size_t> clusterPerPose;
+
+    while (!unassignedPoses.empty())
+    {
+        const IndexT seedPoseId = *std::max_element(unassignedPoses.begin(), unassignedPoses.end(), [&](IndexT a, IndexT b) {
+            return nbObservationsPerPose.at(a) < nbObservationsPerPose.at(b);
+        });
+
+        Cluster cluster;
+        // connection weight of the neighbors of the core poses
+        std::map<IndexT, std::size_t> neighbors;
+
+        const auto addCorePose = [&](IndexT poseId) {
+            cluster.corePoses.insert(poseId);
+            unassignedPoses.erase(poseId);
+            clusterPerPose[poseId] = clusters.size();
+            neighbors.erase(poseId);
+
+            const auto covisibilityIt = covisibility.find(poseId);
+            if (covisibilityIt == covisibility.end())
+                return;
+
+            for (const auto& neighborPair : covisibilityIt->second)
+            {
+                if (cluster.corePoses.count(neighborPair.first) == 0)
+                    neighbors[neighborPair.first] += neighborPair.second;
+            }
+        };
+
+        addCorePose(seedPoseId);
+
+        while (cluster.corePoses.size() + neighbors.size() < maxNbPosesPerCluster)
+        {
+            // the unassigned neighbor with the strongest connection to the core poses
+            IndexT bestPoseId = UndefinedIndexT;
+            std::size_t bestWeight = 0;
+
+            for (const auto& neighborPair : neighbors)
+            {
+                if (neighborPair.second > bestWeight && unassignedPoses.count(neighborPair.first))
+                {
+                    bestPoseId = neighborPair.first;
+                    bestWeight = neighborPair.second;
+                }
+            }
+
+            if (bestPoseId == UndefinedIndexT)
+                break;
+
+            // the new neighbors must fit in the cluster
+            std::size_t nbNewNeighbors = 0;
+            for (const auto& neighborPair : covisibility.at(bestPoseId))
+            {
+                if (neighborPair.first != bestPoseId && cluster.corePoses.count(neighborPair.first) == 0 && neighbors.count(neighborPair.first) == 0)
+                    ++nbNewNeighbors;
+            }
+
+            if (cluster.corePoses.size() + neighbors.size() + nbNewNeighbors > maxNbPosesPerCluster)
+                break;
+
+            addCorePose(bestPoseId);
+        }
+
+        clusters.push_back(std::move(cluster));
+    }
+
+    // each landmark is owned by a cluster observing it, with all its observations:
+    // the other poses observing it are separators of the cluster.
+    // the owner is the cluster observing it the most among the clusters where the new separators fit,
+    // a seed pose connected to more poses than the cluster size would bring all its neighbors as separators.
+    std::map<std::size_t, std::size_t> nbObservationsPerCluster;
+
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        if (landmarkPair.second.state == EEstimatorParameterState::IGNORED)
+            continue;
+
+        landmarkPoses.clear();
+        nbObservationsPerCluster.clear();
+        for (const auto& observationPair : landmarkPair.second.getObservations())
+        {
+            const IndexT poseId = sfmData.getView(observationPair.first).getPoseId();
+            const auto clusterIt = clusterPerPose.find(poseId);
+            if (clusterIt == clusterPerPose.end())
+                continue;
+
+            ++nbObservationsPerCluster[clusterIt->second];
+            landmarkPoses.push_back(poseId);
+        }
+
+        if (nbObservationsPerCluster.empty())
+            continue;
+
+        std::sort(landmarkPoses.begin(), landmarkPoses.end());
+        landmarkPoses.erase(std::unique(landmarkPoses.begin(), landmarkPoses.end()), landmarkPoses.end());
+
+        const auto getNbNewSeparators = [&](std::size_t c) {
+            std::size_t nbNewSeparators = 0;
+            for (const IndexT poseId : landmarkPoses)
+                nbNewSeparators += (clusterPerPose.at(poseId) != c && clusters[c].separatorPoses.count(poseId) == 0) ? 1 : 0;
+            return nbNewSeparators;
+        };
+
+        std::size_t owner = 0;
+        bool hasOwner = false;
+        for (const auto& clusterPair : nbObservationsPerCluster)
+        {
+            const Cluster& cluster = clusters[clusterPair.first];
+            const std::size_t clusterSize = cluster.corePoses.size() + cluster.separatorPoses.size() + getNbNewSeparators(clusterPair.first);
+
+            if (clusterSize <= maxNbPosesPerCluster && (!hasOwner || clusterPair.second > nbObservationsPerCluster.at(owner)))
+            {
+                owner = clusterPair.first;
+                hasOwner = true;
+            }
+        }
+
+        // no cluster fits: the cluster observing it the most exceeds the maximum size
+        if (!hasOwner)
+        {
+            owner = std::max_element(nbObservationsPerCluster.begin(), nbObservationsPerCluster.end(), [](const auto& a, const auto& b) {
+                        return a.second < b.second;
+                    })->first;
+        }
+
+        Cluster& cluster = clusters.at(owner);
+        cluster.landmarks.push_back(landmarkPair.first);
+
+        for (const IndexT poseId : landmarkPoses)
+        {
+            if (clusterPerPose.at(poseId) != owner)
+                cluster.separatorPoses.insert(poseId);
+        }
+    }
+
+    // 2D constraints and rotation priors are owned by the cluster of their first view
+    const auto assignConstraint = [&](IndexT viewIdFirst, IndexT viewIdSecond, std::size_t index, bool isRotationPrior) {
+        const auto clusterFirstIt = clusterPerPose.find(sfmData.getView(viewIdFirst).getPoseId());
+        const auto clusterSecondIt = clusterPerPose.find(sfmData.getView(viewIdSecond).getPoseId());
+
+        if (clusterFirstIt == clusterPerPose.end() || clusterSecondIt == clusterPerPose.end())
+            return;
+
+        Cluster& cluster = clusters.at(clusterFirstIt->second);
+        (isRotationPrior ? cluster.rotationPriors : cluster.constraints2D).push_back(index);
+
+        if (clusterSecondIt->second != clusterFirstIt->second)
+            cluster.separatorPoses.insert(clusterSecondIt->first);
+    };
+
+    for (std::size_t i = 0; i < sfmData.getConstraints2D().size(); ++i)
+        assignConstraint(sfmData.getConstraints2D()[i].ViewFirst, sfmData.getConstraints2D()[i].ViewSecond, i, false);
+
+    for (std::size_t i = 0; i < sfmData.getRotationPriors().size(); ++i)
+        assignConstraint(sfmData.getRotationPriors()[i].ViewFirst, sfmData.getRotationPriors()[i].ViewSecond, i, true);
+
+    std::size_t nbOversizedClusters = 0;
+    std::size_t maxClusterSize = 0;
+    for (const Cluster& cluster : clusters)
+    {
+        const std::size_t clusterSize = cluster.corePoses.size() + cluster.separatorPoses.size();
+        nbOversizedClusters += (clusterSize > maxNbPosesPerCluster) ? 1 : 0;
+        maxClusterSize = std::max(maxClusterSize, clusterSize);
+    }
+
+    if (nbOversizedClusters > 0)
+        ALICEVISION_LOG_WARNING("Partitioned bundle adjustment: " << nbOversizedClusters << " cluster(s) exceed the maximum number of poses ("
+                                                                  << maxClusterSize << " > " << maxNbPosesPerCluster
+                                                                  << "), the memory budget may be exceeded.");
+}
+
+void BundleAdjustmentPartitioned::createClusterScene(const sfmData::SfMData& sfmData,
+                                                     const Cluster& cluster,
+                                                     sfmData::SfMData& clusterSfmData) const
+{
+    for (const IndexT poseId : cluster.corePoses)
+        clusterSfmData.getPoses().emplace(poseId, sfmData.getPoses().at(poseId));
+
+    for (const IndexT poseId : cluster.separatorPoses)
+        clusterSfmData.getPoses().emplace(poseId, sfmData.getPoses().at(poseId));
+
+    for (const auto& viewPair : sfmData.getViews())
+    {
+        const sfmData::View& view = *(viewPair.second);
+
+        if (clusterSfmData.getPoses().count(view.getPoseId()) == 0)
+            continue;
+
+        // views are not modified by the adjustment, they are shared with the input scene
+        clusterSfmData.getViews().emplace(viewPair.first, viewPair.second);
+
+        // intrinsics are refined by each cluster
+        const auto intrinsicIt = sfmData.getIntrinsics().find(view.getIntrinsicId());
+        if (intrinsicIt != sfmData.getIntrinsics().end() && clusterSfmData.getIntrinsics().count(intrinsicIt->first) == 0)
+            clusterSfmData.getIntrinsics().emplace(intrinsicIt->first, std::shared_ptr<camera::IntrinsicBase>(intrinsicIt->second->clone()));
+
+        // sub-poses are shared by all the clusters, they are kept constant
+        if (view.isPartOfRig() && clusterSfmData.getRigs().count(view.getRigId()) == 0)
+        {
+            sfmData::Rig& rig = clusterSfmData.getRigs().emplace(view.getRigId(), sfmData.getRigs().at(view.getRigId())).first->second;
+
+            for (sfmData::RigSubPose& subPose : rig.getSubPoses())
+            {
+                if (subPose.status != sfmData::ERigSubPoseStatus::UNINITIALIZED)
+                    subPose.status = sfmData::ERigSubPoseStatus::CONSTANT;
+            }
+        }
+    }
+
+    for (const IndexT landmarkId : cluster.landmarks)
+    {
+        sfmData::Landmark& landmark = clusterSfmData.getLandmarks().emplace(landmarkId, sfmData.getLandmarks().at(landmarkId)).first->second;
+
+        // observations of views without adjusted pose
+        sfmData::Observations& observations = landmark.getObservations();
+        for (auto observationIt = observations.begin(); observationIt != observations.end();)
+        {
+            if (clusterSfmData.getViews().count(observationIt->first) == 0)
+                observationIt = observations.erase(observationIt);
+            else
+                ++observationIt;
+        }
+    }
+
+    for (const std::size_t index : cluster.constraints2D)
+        clusterSfmData.getConstraints2D().push_back(sfmData.getConstraints2D()[index]);
+
+    for (const std::size_t index : cluster.rotationPriors)
+        clusterSfmData.getRotationPriors().push_back(sfmData.getRotationPriors()[index]);
+}
+
+bool BundleAdjustmentPartitioned::adjustClusters(sfmData::SfMData& sfmData, ERefineOptions refineOptions, const std::vector<Cluster>& clusters)
+{
+    const bool refinePoses = (refineOptions & REFINE_ROTATION) || (refineOptions & REFINE_TRANSLATION);
+    const bool refineIntrinsics = (refineOptions & REFINE_INTRINSICS_ALL) || (refineOptions & REFINE_INTRINSICS_OPTICALOFFSET_ALWAYS);
+    const std::size_t nbClusters = clusters.size();
+
+    // intrinsics used by each cluster
+    std::vector<std::set<IndexT>> intrinsicsPerCluster(nbClusters);
+    {
+        std::map<IndexT, std::set<IndexT>> intrinsicsPerPose;
+        for (const auto& viewPair : sfmData.getViews())
+            intrinsicsPerPose[viewPair.second->getPoseId()].insert(viewPair.second->getIntrinsicId());
+
+        for (std::size_t c = 0; c < nbClusters; ++c)
+        {
+            for (const std::set<IndexT>* poseIds : {&clusters[c].corePoses, &clusters[c].separatorPoses})
+                for (const IndexT poseId : *poseIds)
+                    intrinsicsPerCluster[c].insert(intrinsicsPerPose[poseId].begin(), intrinsicsPerPose[poseId].end());
+        }
+    }
+
+    // parameters refined by several clusters, and the index of their copy in each cluster
+    std::map<IndexT, SharedParameter> sharedPoses;
+    std::map<IndexT, SharedParameter> sharedIntrinsics;
+    std::vector<std::map<IndexT, std::size_t>> sharedPosesPerCluster(nbClusters);
+    std::vector<std::map<IndexT, std::size_t>> sharedIntrinsicsPerCluster(nbClusters);
+
+    if (refinePoses)
+    {
+        std::map<IndexT, std::vector<std::size_t>> clustersPerPose;
+        for (std::size_t c = 0; c < nbClusters; ++c)
+            for (const IndexT poseId : clusters[c].separatorPoses)
+                clustersPerPose[poseId].push_back(c);
+
+        for (std::size_t c = 0; c < nbClusters; ++c)
+            for (const IndexT poseId : clusters[c].corePoses)
+            {
+                const auto clustersIt = clustersPerPose.find(poseId);
+                if (clustersIt != clustersPerPose.end())
+                    clustersIt->second.push_back(c);
+            }
+
+        for (const auto& clustersPair : clustersPerPose)
+        {
+            const sfmData::CameraPose& pose = sfmData.getPoses().at(clustersPair.first);
+            if (pose.isLocked() || pose.getState() != EEstimatorParameterState::REFINED)
+                continue;
+
+            SharedParameter& shared = sharedPoses[clustersPair.first];
+            shared.consensus = poseToConsensusBlock(pose.getTransform(), {});
+
+            for (const std::size_t c : clustersPair.second)
+            {
+                sharedPosesPerCluster[c][clustersPair.first] = shared.values.size();
+                shared.values.push_back(shared.consensus);
+                shared.duals.emplace_back(shared.consensus.size(), 0.0);
+            }
+        }
+    }
+
+    if (refineIntrinsics)
+    {
+        std::map<IndexT, std::vector<std::size_t>> clustersPerIntrinsic;
+        for (std::size_t c = 0; c < nbClusters; ++c)
+            for (const IndexT intrinsicId : intrinsicsPerCluster[c])
+                clustersPerIntrinsic[intrinsicId].push_back(c);
+
+        for (const auto& clustersPair : clustersPerIntrinsic)
+        {
+            const auto intrinsicIt = sfmData.getIntrinsics().find(clustersPair.first);
+            if (clustersPair.second.size() < 2 || intrinsicIt == sfmData.getIntrinsics().end() ||
+                intrinsicIt->second->getState() != EEstimatorParameterState::REFINED)
+                continue;
+
+            SharedParameter& shared = sharedIntrinsics[clustersPair.first];
+            shared.consensus = intrinsicIt->second->getParams();
+
+            for (const std::size_t c : clustersPair.second)
+            {
+                sharedIntrinsicsPerCluster[c][clustersPair.first] = shared.values.size();
+                shared.values.push_back(shared.consensus);
+                shared.duals.emplace_back(shared.consensus.size(), 0.0);
+            }
+        }
+    }
+
+    ALICEVISION_LOG_INFO("Partitioned bundle adjustment:" << "\n\t- # clusters: " << nbClusters << "\n\t- # shared poses: " << sharedPoses.size()
+                                                          << "\n\t- # shared intrinsics: " << sharedIntrinsics.size());
+
+    const int nbParallelClusters = (_partitionOptions.nbParallelClusters > 0) ? _partitionOptions.nbParallelClusters : omp_get_max_threads();
+
+    BundleAdjustmentCeres::CeresOptions clusterOptions = _ceresOptions;
+    clusterOptions.incremental = false;
+    clusterOptions.summary = false;
+    clusterOptions.verbose = false;
+    clusterOptions.maxNumIterations = std::min(_ceresOptions.maxNumIterations, _partitionOptions.maxNbClusterIterations);
+    clusterOptions.nbThreads = std::max(1u, _ceresOptions.nbThreads / static_cast<unsigned int>(nbParallelClusters));
+
+    double posesPenalty = _partitionOptions.posesPenalty;
+    double intrinsicsPenalty = _partitionOptions.intrinsicsPenalty;
+    bool success = false;
+    bool converged = false;
+
+    for (int iteration = 0; iteration < _partitionOptions.maxNbIterations; ++iteration)
+    {
+        std::vector<BundleAdjustmentCeres::Statistics> clustersStatistics(nbClusters);
+        std::vector<char> clustersSuccess(nbClusters, 0);
+        std::exception_ptr clustersException;
+
+        // adjust the clusters, the parameters refined by a single cluster are directly updated
+#pragma omp parallel for schedule(dynamic) num_threads(nbParallelClusters)
+        for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t>(nbClusters); ++c)
+        {
+            try
+            {
+                const Cluster& cluster = clusters[c];
+
+                // nothing to adjust
+                if (cluster.landmarks.empty() && cluster.constraints2D.empty() && cluster.rotationPriors.empty() &&
+                    sharedPosesPerCluster[c].empty() && sharedIntrinsicsPerCluster[c].empty())
+                {
+                    clustersSuccess[c] = 1;
+                    continue;
+                }
+
+                sfmData::SfMData clusterSfmData;
+                createClusterScene(sfmData, cluster, clusterSfmData);
+
+                // proximal terms of the shared parameters: penalty * ||x - (z - u)||^2
+                BundleAdjustmentCeres::ParametersPriors priors;
+
+                const auto addPriors = [](const std::map<IndexT, std::size_t>& sharedCopies,
+                                          const std::map<IndexT, SharedParameter>& sharedParameters,
+                                          double penalty,
+                                          std::map<IndexT, BundleAdjustmentCeres::ParameterPrior>& parametersPriors) {
+                    for (const auto& copyPair : sharedCopies)
+                    {
+                        const SharedParameter& shared = sharedParameters.at(copyPair.first);
+                        const std::vector<double>& dual = shared.duals[copyPair.second];
+
+                        BundleAdjustmentCeres::ParameterPrior& prior = parametersPriors[copyPair.first];
+                        prior.target = shared.consensus;
+                        for (std::size_t i = 0; i < dual.size(); ++i)
+                            prior.target[i] -= dual[i];
+                        prior.weight = std::sqrt(penalty);
+                    }
+                };
+
+                addPriors(sharedPosesPerCluster[c], sharedPoses, posesPenalty, priors.poses);
+                addPriors(sharedIntrinsicsPerCluster[c], sharedIntrinsics, intrinsicsPenalty, priors.intrinsics);
+
+                BundleAdjustmentCeres BA(clusterOptions, _minNbImagesToRefineOpticalCenter);
+                BA.setParametersPriors(priors);
+                clustersSuccess[c] = BA.adjust(clusterSfmData, refineOptions);
+                clustersStatistics[c] = BA.getStatistics();
+
+                if (!clustersSuccess[c])
+                    continue;
+
+                // poses
+                for (auto& posePair : clusterSfmData.getPoses())
+                {
+                    const auto copyIt = sharedPosesPerCluster[c].find(posePair.first);
+
+                    if (copyIt != sharedPosesPerCluster[c].end())
+                    {
+                        SharedParameter& shared = sharedPoses.at(posePair.first);
+                        shared.values[copyIt->second] = poseToConsensusBlock(posePair.second.getTransform(), shared.consensus);
+                    }
+                    else if (refinePoses && cluster.corePoses.count(posePair.first) && posePair.second.getState() == EEstimatorParameterState::REFINED)
+                    {
+                        sfmData.getPoses().at(posePair.first).setTransform(posePair.second.getTransform());
+                    }
+                }
+
+                // intrinsics
+                for (const IndexT intrinsicId : intrinsicsPerCluster[c])
+                {
+                    const auto clusterIntrinsicIt = clusterSfmData.getIntrinsics().find(intrinsicId);
+                    if (clusterIntrinsicIt == clusterSfmData.getIntrinsics().end())
+                        continue;
+
+                    const auto copyIt = sharedIntrinsicsPerCluster[c].find(intrinsicId);
+
+                    if (copyIt != sharedIntrinsicsPerCluster[c].end())
+                    {
+                        sharedIntrinsics.at(intrinsicId).values[copyIt->second] = clusterIntrinsicIt->second->getParams();
+                    }
+                    else if (refineIntrinsics && clusterIntrinsicIt->second->getState() == EEstimatorParameterState::REFINED)
+                    {
+                        // not shared: only used by this cluster
+                        sfmData.getIntrinsics().at(intrinsicId)->updateFromParams(clusterIntrinsicIt->second->getParams());
+                    }
+                }
+
+                // landmarks are owned by a single cluster
+                for (const IndexT landmarkId : cluster.landmarks)
+                    sfmData.getLandmarks().at(landmarkId).X = clusterSfmData.getLandmarks().at(landmarkId).X;
+            }
+            catch (...)
+            {
+#pragma omp critical
+                clustersException = std::current_exception();
+            }
+        }
+
+        if (clustersException)
+            std::rethrow_exception(clustersException);
+
+        std::size_t nbResidualBlocks = 0;
+        std::size_t nbFailedClusters = 0;
+        for (std::size_t c = 0; c < nbClusters; ++c)
+        {
+            _statistics.nbSuccessfullIterations += clustersStatistics[c].nbSuccessfullIterations;
+            _statistics.nbUnsuccessfullIterations += clustersStatistics[c].nbUnsuccessfullIterations;
+            nbResidualBlocks += clustersStatistics[c].nbResidualBlocks;
+            nbFailedClusters += clustersSuccess[c] ? 0 : 1;
+        }
+        _statistics.nbResidualBlocks = nbResidualBlocks;
+
+        if (nbFailedClusters > 0)
+            ALICEVISION_LOG_WARNING("Partitioned bundle adjustment: " << nbFailedClusters << " cluster(s) failed at iteration " << iteration << ".");
+
+        success = success || (nbFailedClusters < nbClusters);
+
+        // consensus update: z = mean(x + u), u = u + x - z
+        // the penalty is adapted to balance the primal and dual residuals, the scaled duals are rescaled accordingly
+        const auto updateConsensus = [&](std::map<IndexT, SharedParameter>& sharedParameters, double& penalty, EParameter parameter) -> bool {
+            double primalResidual = 0.0;
+            double dualResidual = 0.0;
+            double valuesNorm = 0.0;
+            double consensusNorm = 0.0;
+            double dualsNorm = 0.0;
+            std::size_t nbValues = 0;
+
+            for (auto& sharedPair : sharedParameters)
+            {
+                SharedParameter& shared = sharedPair.second;
+                const std::vector<double> previousConsensus = shared.consensus;
+                const std::size_t nbCopies = shared.values.size();
+
+                std::fill(shared.consensus.begin(), shared.consensus.end(), 0.0);
+                for (std::size_t k = 0; k < nbCopies; ++k)
+                    for (std::size_t i = 0; i < shared.consensus.size(); ++i)
+                        shared.consensus[i] += (shared.values[k][i] + shared.duals[k][i]) / nbCopies;
+
+                for (std::size_t k = 0; k < nbCopies; ++k)
+                {
+                    for (std::size_t i = 0; i < shared.consensus.size(); ++i)
+                        shared.duals[k][i] += shared.values[k][i] - shared.consensus[i];
+
+                    primalResidual += squaredDistance(shared.values[k], shared.consensus);
+                    dualResidual += squaredDistance(shared.consensus, previousConsensus);
+                    valuesNorm += squaredNorm(shared.values[k]);
+                    consensusNorm += squaredNorm(shared.consensus);
+                    dualsNorm += squaredNorm(shared.duals[k]);
+                    nbValues += shared.values[k].size();
+                }
+            }
+
+            if (nbValues == 0)
+                return true;
+
+            primalResidual = std::sqrt(primalResidual);
+            dualResidual = penalty * std::sqrt(dualResidual);
+
+            const double tolerance = _partitionOptions.tolerance;
+            const bool converged = (primalResidual <= tolerance * (std::sqrt(nbValues) + std::sqrt(std::max(valuesNorm, consensusNorm)))) &&
+                                   (dualResidual <= tolerance * (std::sqrt(nbValues) + penalty * std::sqrt(dualsNorm)));
+
+            _statistics.consensusPrimalResiduals[parameter] = primalResidual;
+            _statistics.consensusDualResiduals[parameter] = dualResidual;
+
+            ALICEVISION_LOG_DEBUG("Partitioned bundle adjustment: iteration " << iteration << ", "
+                                                                              << ((parameter == EParameter::POSE) ? "poses" : "intrinsics")
+                                                                              << " primal residual: " << primalResidual << ", dual residual: " << dualResidual
+                                                                              << ", penalty: " << penalty);
+
+            double dualsScale = 1.0;
+            if (primalResidual > 10.0 * dualResidual)
+            {
+                penalty *= 2.0;
+                dualsScale = 0.5;
+            }
+            else if (dualResidual > 10.0 * primalResidual)
+            {
+                penalty *= 0.5;
+                dualsScale = 2.0;
+            }
+
+            if (dualsScale != 1.0)
+            {
+                for (auto& sharedPair : sharedParameters)
+                    for (std::vector<double>& dual : sharedPair.second.duals)
+                        for (double& value : dual)
+                            value *= dualsScale;
+            }
+
+            return converged;
+        };
+
+        const bool posesConverged = updateConsensus(sharedPoses, posesPenalty, EParameter::POSE);
+        const bool intrinsicsConverged = updateConsensus(sharedIntrinsics, intrinsicsPenalty, EParameter::INTRINSIC);
+
+        // the shared parameters are set to their consensus
+        for (const auto& sharedPair : sharedPoses)
+            sfmData.getPoses().at(sharedPair.first).setTransform(consensusBlockToPose(sharedPair.second.consensus));
+
+        for (const auto& sharedPair : sharedIntrinsics)
+            sfmData.getIntrinsics().at(sharedPair.first)->updateFromParams(sharedPair.second.consensus);
+
+        _nbIterations = iteration + 1;
+        _statistics.nbConsensusIterations = _nbIterations;
+        converged = posesConverged && intrinsicsConverged;
+
+        if (converged)
+        {
+            ALICEVISION_LOG_INFO("Partitioned bundle adjustment: consensus reached after " << _nbIterations << " iteration(s).");
+            break;
+        }
+    }
+
+    if (!converged)
+    {
+        std::stringstream ss;
+        for (const auto& residualPair : _statistics.consensusPrimalResiduals)
+        {
+            ss << "\n\t- " << ((residualPair.first == EParameter::POSE) ? "poses" : "intrinsics") << " primal residual: " << residualPair.second
+               << ", dual residual: " << _statistics.consensusDualResiduals.at(residualPair.first);
+        }
+        ALICEVISION_LOG_WARNING("Partitioned bundle adjustment: consensus not reached after "
+                                << _nbIterations << " iteration(s), the shared parameters are set to the last consensus." << ss.str());
+    }
+
+    return success;
+}
+
+bool BundleAdjustmentPartitioned::adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+    _statistics = BundleAdjustmentCeres::Statistics();
+    _nbClusters = 0;
+    _nbIterations = 0;
+
+    const ProblemSize problemSize = getProblemSize(sfmData);
+    const std::size_t nbPoses = problemSize.nbPoses;
+
+    // the whole problem fits in memory
+    if (!isPartitioned(sfmData))
+    {
+        BundleAdjustmentCeres BA(_ceresOptions, _minNbImagesToRefineOpticalCenter);
+        const bool success = BA.adjust(sfmData, refineOptions);
+        _statistics = BA.getStatistics();
+        _nbClusters = 1;
+        return success;
+    }
+
+    const bool denseSchur = (_ceresOptions.linearSolverType == ceres::DENSE_SCHUR);
+    const std::size_t memoryBudget = _partitionOptions.memoryBudgetMB * 1024 * 1024;
+    const std::size_t problemMemory =
+      estimateProblemMemory(nbPoses, problemSize.nbLandmarks, problemSize.nbObservations, problemSize.nbPosesPairs, denseSchur);
+    const int nbParallelClusters = (_partitionOptions.nbParallelClusters > 0) ? _partitionOptions.nbParallelClusters : omp_get_max_threads();
+
+    // the largest cluster fitting in its share of the memory budget,
+    // assuming the clusters have the average density of the scene
+    std::size_t maxNbPosesPerCluster = nbPoses;
+
+    if (memoryBudget > 0)
+    {
+        const std::size_t clusterMemoryBudget = memoryBudget / nbParallelClusters;
+        const auto getClusterMemory = [&](std::size_t nbClusterPoses) {
+            const double ratio = static_cast<double>(nbClusterPoses) / nbPoses;
+            return estimateProblemMemory(nbClusterPoses,
+                                         static_cast<std::size_t>(problemSize.nbLandmarks * ratio),
+                                         static_cast<std::size_t>(problemSize.nbObservations * ratio),
+                                         std::min(static_cast<std::size_t>(problemSize.nbPosesPairs * ratio), nbClusterPoses * (nbClusterPoses - 1) / 2),
+                                         denseSchur);
+        };
+
+        std::size_t low = 1;
+        std::size_t high = nbPoses;
+        while (low < high)
+        {
+            const std::size_t middle = (low + high + 1) / 2;
+            if (getClusterMemory(middle) <= clusterMemoryBudget)
+                low = middle;
+            else
+                high = middle - 1;
+        }
+        maxNbPosesPerCluster = low;
+    }
+
+    if (_partitionOptions.maxNbPosesPerCluster > 0)
+        maxNbPosesPerCluster = std::min(maxNbPosesPerCluster, _partitionOptions.maxNbPosesPerCluster);
+
+    if (maxNbPosesPerCluster < 2)
+    {
+        ALICEVISION_LOG_WARNING("Partitioned bundle adjustment: the memory budget (" << _partitionOptions.memoryBudgetMB
+                                                                                     << " MB) is too small, use clusters of 2 poses.");
+        maxNbPosesPerCluster = 2;
+    }
+
+    aliceVision::system::Timer timer;
+
+    std::vector<Cluster> clusters;
+    partition(sfmData, maxNbPosesPerCluster, clusters);
+    _nbClusters = clusters.size();
+
+    ALICEVISION_LOG_INFO("Partitioned bundle adjustment:"
+                         << "\n\t- estimated problem memory: " << problemMemory / (1024 * 1024) << " MB"
+                         << "\n\t- memory budget: " << _partitionOptions.memoryBudgetMB << " MB"
+                         << "\n\t- max # poses per cluster: " << maxNbPosesPerCluster);
+
+    _statistics.RMSEinitial = computeReprojectionRMSE(sfmData);
+
+    const bool success = adjustClusters(sfmData, refineOptions, clusters);
+
+    _statistics.RMSEfinal = computeReprojectionRMSE(sfmData);
+    _statistics.time = timer.elapsed();
+
+    for (const auto& posePair : sfmData.getPoses())
+        _statistics.addState(EParameter::POSE, posePair.second.isLocked() ? EEstimatorParameterState::CONSTANT : posePair.second.getState());
+
+    for (const auto& intrinsicPair : sfmData.getIntrinsics())
+        _statistics.addState(EParameter::INTRINSIC, intrinsicPair.second->getState());
+
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+        _statistics.addState(EParameter::LANDMARK, landmarkPair.second.state);
+
+    if (!success)
+        ALICEVISION_LOG_WARNING("Partitioned bundle adjustment failed, the solutions of all the clusters are not usable.");
+
+    return success;
+}
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -0,0 +1,233 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace aliceVision {
+
+namespace sfmData {
+class SfMData;
+}  // namespace sfmData
+
+namespace sfm {
+
+/**
+ * @brief Bundle adjustment of scenes too large to be refined in a single Ceres problem.
+ *
+ * The poses are split into clusters, grown on the covisibility graph of the poses.
+ * Each landmark is owned by a single cluster, with all its observations: the poses observing
+ * the landmarks of a cluster without being part of it are added to the cluster as separators,
+ * so the clusters overlap. The clusters are adjusted in parallel and the parameters shared
+ * between clusters (separators poses and intrinsics) are driven to a global consensus with
+ * the alternating direction method of multipliers (ADMM).
+ *
+ * Only the Ceres problems of the clusters adjusted in parallel are in memory at once,
+ * the size of the clusters is derived from the memory budget.
+ * If the whole scene fits in the memory budget, a single BundleAdjustmentCeres is used.
+ */
+class BundleAdjustmentPartitioned : public BundleAdjustment
+{
+  public:
+    /**
+     * @brief Contains all partitioning and consensus parameters.
+     */
+    struct PartitionOptions
+    {
+        /// memory budget of the Ceres problems in memory at once, in MB (0: no limit)
+        std::size_t memoryBudgetMB = 0;
+        /// max number of poses of a cluster, separators included (0: derived from the memory budget only)
+        std::size_t maxNbPosesPerCluster = 0;
+        /// max number of clusters adjusted in parallel (0: number of threads)
+        int nbParallelClusters = 0;
+        /// max number of consensus iterations
+        int maxNbIterations = 20;
+        /// max number of solver iterations of a cluster per consensus iteration
+        unsigned int maxNbClusterIterations = 10;
+        /// relative primal and dual residuals of the consensus below which it has converged
+        double tolerance = 1e-4;
+        /// initial penalty of the poses consensus, adapted by residual balancing
+        double posesPenalty = 1e4;
+        /// initial penalty of the intrinsics consensus, adapted by residual balancing
+        double intrinsicsPenalty = 1.0;
+    };
+
+    /**
+     * @brief Partitioned bundle adjustment constructor
+     * @param[in] ceresOptions The user Ceres options, used for each cluster
+     * @param[in] partitionOptions The partitioning and consensus options
+     * @param[in] minNbImagesToRefineOpticalCenter The minimum number of images to refine the optical center
+     */
+    BundleAdjustmentPartitioned(const BundleAdjustmentCeres::CeresOptions& ceresOptions,
+                                const PartitionOptions& partitionOptions,
+                                int minNbImagesToRefineOpticalCenter = 3)
+      : _ceresOptions(ceresOptions),
+        _partitionOptions(partitionOptions),
+        _minNbImagesToRefineOpticalCenter(minNbImagesToRefineOpticalCenter)
+    {}
+
+    /**
+     * @brief Create a partitioned bundle adjustment if the given scene exceeds the memory budget
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] ceresOptions The user Ceres options, the incremental problem is disabled
+     * @param[in] memoryBudgetMB The memory budget of the Ceres problems in memory at once, in MB (0: no partitioning)
+     * @param[in] minNbImagesToRefineOpticalCenter The minimum number of images to refine the optical center
+     * @return the partitioned bundle adjustment, nullptr if the scene fits in the memory budget
+     */
+    static std::unique_ptr<BundleAdjustmentPartitioned> createIfPartitioned(const sfmData::SfMData& sfmData,
+                                                                            const BundleAdjustmentCeres::CeresOptions& ceresOptions,
+                                                                            std::size_t memoryBudgetMB,
+                                                                            int minNbImagesToRefineOpticalCenter = 3);
+
+    /**
+     * @brief Perform a Bundle Adjustment on the SfM scene with refinement of the requested parameters
+     * @note Rig sub-poses are kept constant when the scene is partitioned.
+     * @param[in,out] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] refineOptions The chosen refine flag
+     * @return false if the bundle adjustment failed else true
+     * @see BundleAdjustment::Adjust
+     */
+    bool adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions = REFINE_ALL) override;
+
+    /**
+     * @brief Check if the adjustment of the given scene is partitioned:
+     *        the scene does not fit in the memory budget or in the maximum number of poses per cluster.
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @return true if the scene is partitioned
+     */
+    bool isPartitioned(const sfmData::SfMData& sfmData) const;
+
+    /**
+     * @brief Get bundle adjustment statistics structure
+     * @note When the scene is partitioned, the solver statistics are accumulated over
+     *       the clusters and the consensus iterations, the RMSE is the reprojection RMSE of the scene.
+     * @return statistics structure const ptr
+     */
+    inline const BundleAdjustmentCeres::Statistics& getStatistics() const { return _statistics; }
+
+    /**
+     * @brief Get the number of clusters of the last adjustment
+     * @return the number of clusters, 1 if the scene was not partitioned
+     */
+    inline std::size_t getNbClusters() const { return _nbClusters; }
+
+    /**
+     * @brief Get the number of consensus iterations of the last adjustment
+     * @return the number of consensus iterations, 0 if the scene was not partitioned
+     */
+    inline int getNbIterations() const { return _nbIterations; }
+
+    /**
+     * @brief Estimate the memory used by a Ceres bundle adjustment problem
+     * @param[in] nbPoses The number of poses
+     * @param[in] nbLandmarks The number of landmarks
+     * @param[in] nbObservations The number of observations
+     * @param[in] nbPosesPairs The number of pairs of poses observing a common landmark
+     * @param[in] denseSchur True if the Schur complement is dense
+     * @return the estimated memory, in bytes
+     */
+    static std::size_t estimateProblemMemory(std::size_t nbPoses,
+                                             std::size_t nbLandmarks,
+                                             std::size_t nbObservations,
+                                             std::size_t nbPosesPairs,
+                                             bool denseSchur);
+
+  private:
+    /**
+     * @brief Size of a bundle adjustment problem
+     */
+    struct ProblemSize
+    {
+        std::size_t nbPoses = 0;
+        std::size_t nbLandmarks = 0;
+        std::size_t nbObservations = 0;
+        /// number of pairs of poses observing a common landmark (upper bound)
+        std::size_t nbPosesPairs = 0;
+    };
+
+    /**
+     * @brief Compute the size of the bundle adjustment problem of a scene
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @return the problem size
+     */
+    static ProblemSize getProblemSize(const sfmData::SfMData& sfmData);
+
+    /**
+     * @brief A cluster of poses and the landmarks it owns
+     */
+    struct Cluster
+    {
+        /// poses of the cluster, owning the landmarks they observe the most
+        std::set<IndexT> corePoses;
+        /// poses observing landmarks of the cluster without being part of it
+        std::set<IndexT> separatorPoses;
+        /// landmarks owned by the cluster
+        std::vector<IndexT> landmarks;
+        /// 2D constraints and rotation priors owned by the cluster (index in the SfMData vectors)
+        std::vector<std::size_t> constraints2D;
+        std::vector<std::size_t> rotationPriors;
+    };
+
+    /**
+     * @brief Split the poses of the scene into clusters and assign the landmarks to the clusters
+     * @note A landmark is assigned to a cluster where its other poses fit as separators if any:
+     *       a cluster may only exceed the maximum number of poses if a pose observes landmarks with too many other poses,
+     *       a warning is logged.
+     * @note The clusters are grown on a covisibility graph weighted by the number of shared landmarks, built from the scene:
+     *       LocalBundleAdjustmentGraph only exists in the sequential pipeline with the local strategy and its edges are
+     *       thresholded and unweighted, ConnexityGraph only provides distances to a set of views.
+     *       The graph is built in a single pass on the observations, as the reprojection RMSE.
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] maxNbPosesPerCluster The maximum number of poses of a cluster, separators included
+     * @param[out] clusters The clusters
+     */
+    void partition(const sfmData::SfMData& sfmData, std::size_t maxNbPosesPerCluster, std::vector<Cluster>& clusters) const;
+
+    /**
+     * @brief Create the SfMData of a cluster
+     * @note Views are shared with the input SfMData, intrinsics are cloned, rig sub-poses are constant.
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] cluster The cluster
+     * @param[out] clusterSfmData The cluster SfMData
+     */
+    void createClusterScene(const sfmData::SfMData& sfmData, const Cluster& cluster, sfmData::SfMData& clusterSfmData) const;
+
+    /**
+     * @brief Adjust the partitioned scene, with a consensus on the parameters shared by the clusters
+     * @param[in,out] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] refineOptions The chosen refine flag
+     * @param[in] clusters The clusters
+     * @return false if the adjustment of all the clusters failed
+     */
+    bool adjustClusters(sfmData::SfMData& sfmData, ERefineOptions refineOptions, const std::vector<Cluster>& clusters);
+
+    // private members
+
+    /// user Ceres options to use in the solver
+    BundleAdjustmentCeres::CeresOptions _ceresOptions;
+    /// user partitioning and consensus options
+    PartitionOptions _partitionOptions;
+    int _minNbImagesToRefineOpticalCenter = 3;
+
+    /// last adjustment statisics
+    BundleAdjustmentCeres::Statistics _statistics;
+    /// number of clusters of the last adjustment
+    std::size_t _nbClusters = 0;
+    /// number of consensus iterations of the last adjustment
+    int _nbIterations = 0;
+};
+
+}  // namespace sfm
+}  // namespace aliceVision
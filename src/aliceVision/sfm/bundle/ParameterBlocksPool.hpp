@@ -0,0 +1,92 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace aliceVision {
+namespace sfm {
+
+/**
+ * @brief Storage of fixed-size parameter blocks in contiguous chunks.
+ *        The address of a block does not change until it is released,
+ *        so it can be given to a Ceres problem which lives across several solves.
+ *        The released blocks are reused by the next allocations.
+ * @tparam BlockSize The number of parameters of a block
+ */
+template<std::size_t BlockSize>
+class ParameterBlocksPool
+{
+  public:
+    /**
+     * @brief ParameterBlocksPool constructor
+     * @param[in] nbBlocksPerChunk The number of blocks allocated at once
+     */
+    explicit ParameterBlocksPool(std::size_t nbBlocksPerChunk = 1024)
+      : _nbBlocksPerChunk(nbBlocksPerChunk)
+    {}
+
+    /**
+     * @brief Get a parameter block, its values are not initialized
+     * @return a pointer to BlockSize contiguous parameters
+     */
+    double* allocate()
+    {
+        ++_size;
+
+        if (!_freeBlocks.empty())
+        {
+            double* block = _freeBlocks.back();
+            _freeBlocks.pop_back();
+            return block;
+        }
+
+        if (_chunks.empty() || _nbUsedBlocksInLastChunk == _nbBlocksPerChunk)
+        {
+            _chunks.emplace_back(new double[_nbBlocksPerChunk * BlockSize]);
+            _nbUsedBlocksInLastChunk = 0;
+        }
+
+        return _chunks.back().get() + BlockSize * _nbUsedBlocksInLastChunk++;
+    }
+
+    /**
+     * @brief Give back a parameter block to the pool
+     * @param[in] block A block previously returned by allocate()
+     */
+    void release(double* block)
+    {
+        --_size;
+        _freeBlocks.push_back(block);
+    }
+
+    /**
+     * @brief Release all the parameter blocks and free the memory
+     */
+    void clear()
+    {
+        _chunks.clear();
+        _freeBlocks.clear();
+        _nbUsedBlocksInLastChunk = 0;
+        _size = 0;
+    }
+
+    /// get the number of allocated blocks
+    inline std::size_t size() const { return _size; }
+
+  private:
+    std::vector<std::unique_ptr<double[]>> _chunks;
+    std::vector<double*> _freeBlocks;
+    std::size_t _nbBlocksPerChunk;
+    std::size_t _nbUsedBlocksInLastChunk = 0;
+    std::size_t _size = 0;
+};
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -6,12 +6,14 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/sfm/sfm.hpp>
+#include <aliceVision/sfm/bundle/costfunctions/parameterPrior.hpp>
 #include <aliceVision/camera/cameraCommon.hpp>
 #include <aliceVision/multiview/NViewDataSet.hpp>
 
 #include <cmath>
 #include <cstdio>
 #include <iostream>
+#include <random>
 
 #define BOOST_TEST_MODULE bundleAdjustment
 
@@ -28,6 +30,10 @@ double RMSE(const SfMData& sfmData);
 
 SfMData getInputScene(const NViewDataSet& d, const NViewDatasetConfigurator& config, EINTRINSIC eintrinsic, EDISTORTION edistortion);
 
+SfMData copyScene(const SfMData& sfmData);
+
+void checkSameScene(const SfMData& sfmData, const SfMData& sfmDataRef, double tolerance);
+
 // Test summary:
 // - Create a SfMData scene from a synthetic dataset
 //   - since random noise have been added on 2d data point (initial residual is not small)
@@ -241,6 +247,233 @@ BOOST_AUTO_TEST_CASE(LOCAL_BUNDLE_ADJUSTMENT_EffectiveMinimization_Pinhole_Camer
     BOOST_CHECK_LT(dResidual_after, dResidual_before);
 }
 
+BOOST_AUTO_TEST_CASE(BUNDLE_ADJUSTMENT_Incremental_Pinhole)
+{
+    const int nviews = 4;
+    const int npoints = 12;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    // Translate the input dataset to a SfMData scene
+    SfMData sfmData = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA, EDISTORTION::DISTORTION_NONE);
+
+    // the first landmark is added after the first adjustment
+    const Landmark addedLandmark = sfmData.getLandmarks().at(0);
+    sfmData.getLandmarks().erase(0);
+
+    const double dResidual_before = RMSE(sfmData);
+
+    BundleAdjustmentCeres::CeresOptions options;
+    options.incremental = true;
+    BundleAdjustmentCeres BA(options);
+    BOOST_CHECK(BA.adjust(sfmData));
+    BOOST_CHECK_LT(RMSE(sfmData), dResidual_before);
+
+    // update the scene: add a landmark, remove an observation, move a landmark
+    sfmData.getLandmarks()[0] = addedLandmark;
+    sfmData.getLandmarks().at(1).getObservations().erase(1);
+    sfmData.getLandmarks().at(2).X += Vec3(0.01, -0.01, 0.01);
+
+    std::size_t nbObservations = 0;
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+        nbObservations += landmarkPair.second.getObservations().size();
+
+    const double dResidual_update = RMSE(sfmData);
+
+    // the persistent problem only contains the residuals of the current observations
+    BOOST_CHECK(BA.adjust(sfmData));
+    BOOST_CHECK_EQUAL(BA.getStatistics().nbResidualBlocks, 2 * nbObservations);
+    BOOST_CHECK_LT(RMSE(sfmData), dResidual_update);
+}
+
+BOOST_AUTO_TEST_CASE(BUNDLE_ADJUSTMENT_Incremental_States)
+{
+    const int nviews = 8;
+    const int npoints = 40;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    // Translate the input dataset to a SfMData scene
+    SfMData sfmData = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA, EDISTORTION::DISTORTION_NONE);
+
+    // each landmark is only observed by 3 consecutive views of the ring,
+    // so a pose can be ignored with the landmarks it observes (Local BA)
+    for (auto& landmarkPair : sfmData.getLandmarks())
+    {
+        Observations& observations = landmarkPair.second.getObservations();
+        const IndexT firstViewId = landmarkPair.first % nviews;
+
+        for (auto it = observations.begin(); it != observations.end();)
+        {
+            const IndexT offset = (it->first + nviews - firstViewId) % nviews;
+            it = (offset < 3) ? std::next(it) : observations.erase(it);
+        }
+    }
+
+    // two constant poses fix the gauge, the incremental and fresh solutions are comparable
+    sfmData.getPoses().at(3).setState(EEstimatorParameterState::CONSTANT);
+    sfmData.getPoses().at(4).setState(EEstimatorParameterState::CONSTANT);
+
+    BundleAdjustmentCeres::CeresOptions options;
+    options.incremental = true;
+    BundleAdjustmentCeres incrementalBA(options);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> noise(-0.01, 0.01);
+
+    // move the landmarks, run the incremental adjustment and a fresh adjustment of the same scene
+    const auto adjustAndCompare = [&](const std::string& step) {
+        BOOST_TEST_CONTEXT(step)
+        {
+            for (auto& landmarkPair : sfmData.getLandmarks())
+            {
+                if (landmarkPair.second.state == EEstimatorParameterState::REFINED)
+                    landmarkPair.second.X += Vec3(noise(generator), noise(generator), noise(generator));
+            }
+
+            const SfMData sfmDataBefore = copyScene(sfmData);
+            SfMData sfmDataFresh = copyScene(sfmData);
+
+            BOOST_CHECK(incrementalBA.adjust(sfmData));
+
+            BundleAdjustmentCeres freshBA;
+            BOOST_CHECK(freshBA.adjust(sfmDataFresh));
+
+            BOOST_CHECK_EQUAL(incrementalBA.getStatistics().nbResidualBlocks, freshBA.getStatistics().nbResidualBlocks);
+            checkSameScene(sfmData, sfmDataFresh, 1e-4);
+            BOOST_CHECK_LT(RMSE(sfmData), RMSE(sfmDataBefore));
+
+            // the constant and ignored parameters are not modified
+            for (const auto& posePair : sfmData.getPoses())
+            {
+                if (posePair.second.getState() != EEstimatorParameterState::REFINED)
+                    BOOST_CHECK(posePair.second.getTransform() == sfmDataBefore.getPoses().at(posePair.first).getTransform());
+            }
+            for (const auto& landmarkPair : sfmData.getLandmarks())
+            {
+                if (landmarkPair.second.state != EEstimatorParameterState::REFINED)
+                    BOOST_CHECK_EQUAL(landmarkPair.second.X, sfmDataBefore.getLandmarks().at(landmarkPair.first).X);
+            }
+            for (const auto& intrinsicPair : sfmData.getIntrinsics())
+            {
+                if (intrinsicPair.second->getState() != EEstimatorParameterState::REFINED)
+                    BOOST_CHECK(intrinsicPair.second->getParams() == sfmDataBefore.getIntrinsics().at(intrinsicPair.first)->getParams());
+            }
+        }
+    };
+
+    adjustAndCompare("initial adjustment");
+
+    // Local BA: the pose 0 and the landmarks it observes are ignored, its neighbors are constant
+    sfmData.getPoses().at(0).setState(EEstimatorParameterState::IGNORED);
+    sfmData.getPoses().at(1).setState(EEstimatorParameterState::CONSTANT);
+    sfmData.getPoses().at(7).setState(EEstimatorParameterState::CONSTANT);
+    for (auto& landmarkPair : sfmData.getLandmarks())
+    {
+        if (landmarkPair.second.getObservations().count(0))
+            landmarkPair.second.state = EEstimatorParameterState::IGNORED;
+    }
+    sfmData.getLandmarks().at(1).state = EEstimatorParameterState::CONSTANT;
+
+    adjustAndCompare("ignored pose and landmarks");
+
+    // back to a global adjustment, with a constant intrinsic
+    for (const IndexT poseId : {0, 1, 7})
+        sfmData.getPoses().at(poseId).setState(EEstimatorParameterState::REFINED);
+    for (auto& landmarkPair : sfmData.getLandmarks())
+        landmarkPair.second.state = EEstimatorParameterState::REFINED;
+    sfmData.getIntrinsics().at(0)->setState(EEstimatorParameterState::CONSTANT);
+
+    adjustAndCompare("restored pose and landmarks, constant intrinsic");
+
+    // the pose 7 is removed with its observations, the intrinsic is refined again
+    sfmData.erasePose(7);
+    for (auto& landmarkPair : sfmData.getLandmarks())
+        landmarkPair.second.getObservations().erase(7);
+    sfmData.getIntrinsics().at(0)->setState(EEstimatorParameterState::REFINED);
+
+    adjustAndCompare("removed pose, refined intrinsic");
+}
+
+BOOST_AUTO_TEST_CASE(BUNDLE_ADJUSTMENT_Partitioned_Pinhole)
+{
+    const int nviews = 12;
+    const int npoints = 60;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    // Translate the input dataset to a SfMData scene
+    SfMData sfmData = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA, EDISTORTION::DISTORTION_NONE);
+
+    // each landmark is only observed by 3 consecutive views of the ring
+    for (auto& landmarkPair : sfmData.getLandmarks())
+    {
+        Observations& observations = landmarkPair.second.getObservations();
+        const IndexT firstViewId = landmarkPair.first % nviews;
+
+        for (auto it = observations.begin(); it != observations.end();)
+        {
+            const IndexT offset = (it->first + nviews - firstViewId) % nviews;
+            it = (offset < 3) ? std::next(it) : observations.erase(it);
+        }
+    }
+
+    // two constant poses fix the gauge, the partitioned and monolithic solutions are comparable
+    sfmData.getPoses().at(0).setState(EEstimatorParameterState::CONSTANT);
+    sfmData.getPoses().at(nviews / 2).setState(EEstimatorParameterState::CONSTANT);
+
+    const double dResidual_before = RMSE(sfmData);
+
+    // reference: monolithic adjustment of the same scene
+    SfMData sfmDataMonolithic = copyScene(sfmData);
+    BundleAdjustmentCeres monolithicBA;
+    BOOST_CHECK(monolithicBA.adjust(sfmDataMonolithic));
+
+    BundleAdjustmentPartitioned::PartitionOptions partitionOptions;
+    partitionOptions.maxNbPosesPerCluster = 6;
+    partitionOptions.nbParallelClusters = 2;
+    partitionOptions.maxNbIterations = 50;
+    BundleAdjustmentPartitioned BA(BundleAdjustmentCeres::CeresOptions(), partitionOptions);
+
+    BOOST_CHECK(BA.isPartitioned(sfmData));
+    BOOST_CHECK(BA.adjust(sfmData));
+    BOOST_CHECK_GT(BA.getNbClusters(), std::size_t(1));
+    BOOST_CHECK_LT(RMSE(sfmData), dResidual_before);
+
+    // the consensus has converged to the monolithic solution
+    BOOST_CHECK_GT(BA.getNbIterations(), 0);
+    BOOST_CHECK_LT(BA.getNbIterations(), partitionOptions.maxNbIterations);
+    checkSameScene(sfmData, sfmDataMonolithic, 2e-3);
+}
+
+BOOST_AUTO_TEST_CASE(BUNDLE_ADJUSTMENT_PosePrior_RotationManifold)
+{
+    const Vec3 axis = Vec3(1.0, -2.0, 0.5).normalized();
+    const double angle = M_PI - 0.01;
+    const Vec3 t(0.1, 0.2, -0.3);
+
+    // the same pose, with an angle-axis of norm greater than pi
+    const std::vector<double> poseBlock = {axis(0) * angle, axis(1) * angle, axis(2) * angle, t(0), t(1), t(2)};
+    const double otherAngle = angle - 2.0 * M_PI;
+    const std::vector<double> target = {axis(0) * otherAngle, axis(1) * otherAngle, axis(2) * otherAngle, t(0), t(1), t(2)};
+
+    const PosePriorErrorFunctor prior(target, 10.0);
+    double residuals[6];
+
+    BOOST_CHECK(prior(poseBlock.data(), residuals));
+    for (int i = 0; i < 6; ++i)
+        BOOST_CHECK_SMALL(residuals[i], 1e-9);
+
+    // a small rotation across pi: the residual is the rotation angle, not the angle-axis difference
+    const double crossingAngle = M_PI + 0.01;
+    const std::vector<double> crossingBlock = {axis(0) * crossingAngle, axis(1) * crossingAngle, axis(2) * crossingAngle, t(0), t(1), t(2) + 0.01};
+    const PosePriorErrorFunctor crossingPrior(poseBlock, 10.0);
+
+    BOOST_CHECK(crossingPrior(crossingBlock.data(), residuals));
+    BOOST_CHECK_CLOSE(Vec3(residuals[0], residuals[1], residuals[2]).norm(), 10.0 * 0.02, 1e-4);
+    BOOST_CHECK_CLOSE(residuals[5], 10.0 * 0.01, 1e-4);
+}
+
 /// Compute the Root Mean Square Error of the residuals
 double RMSE(const SfMData& sfm_data)
 {
@@ -264,6 +497,41 @@ double RMSE(const SfMData& sfm_data)
     return RMSE;
 }
 
+/// Copy a SfMData scene, the intrinsics are not shared with the copy
+SfMData copyScene(const SfMData& sfmData)
+{
+    SfMData sfmDataCopy = sfmData;
+    for (auto& intrinsicPair : sfmDataCopy.getIntrinsics())
+        intrinsicPair.second.reset(intrinsicPair.second->clone());
+    return sfmDataCopy;
+}
+
+/// Check that the poses, landmarks and intrinsics of two scenes are equal up to a tolerance
+void checkSameScene(const SfMData& sfmData, const SfMData& sfmDataRef, double tolerance)
+{
+    BOOST_REQUIRE_EQUAL(sfmData.getPoses().size(), sfmDataRef.getPoses().size());
+    for (const auto& posePair : sfmData.getPoses())
+    {
+        const Pose3& pose = posePair.second.getTransform();
+        const Pose3& poseRef = sfmDataRef.getPoses().at(posePair.first).getTransform();
+        BOOST_CHECK_SMALL((pose.rotation() - poseRef.rotation()).norm(), tolerance);
+        BOOST_CHECK_SMALL((pose.center() - poseRef.center()).norm(), tolerance);
+    }
+
+    BOOST_REQUIRE_EQUAL(sfmData.getLandmarks().size(), sfmDataRef.getLandmarks().size());
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+        BOOST_CHECK_SMALL((landmarkPair.second.X - sfmDataRef.getLandmarks().at(landmarkPair.first).X).norm(), tolerance);
+
+    for (const auto& intrinsicPair : sfmData.getIntrinsics())
+    {
+        const std::vector<double> params = intrinsicPair.second->getParams();
+        const std::vector<double> paramsRef = sfmDataRef.getIntrinsics().at(intrinsicPair.first)->getParams();
+        BOOST_REQUIRE_EQUAL(params.size(), paramsRef.size());
+        for (std::size_t i = 0; i < params.size(); ++i)
+            BOOST_CHECK_SMALL(params[i] - paramsRef[i], tolerance * std::max(1.0, std::abs(paramsRef[i])));
+    }
+}
+
 // Translation a synthetic scene into a valid SfMData scene.
 // => A synthetic scene is used:
 //    a random noise between [-.5,.5] is added on observed data points
@@ -312,8 +580,8 @@ SfMData getInputScene(const NViewDataSet& d, const NViewDatasetConfigurator& con
         {
             Vec2 pt = d._x[j].col(i);
             // => random noise between [-.5,.5] is added
-            pt(0) += rand() / RAND_MAX - .5;
-            pt(1) += rand() / RAND_MAX - .5;
+            pt(0) += rand() / double(RAND_MAX) - .5;
+            pt(1) += rand() / double(RAND_MAX) - .5;
 
             landmark.getObservations()[j] = Observation(pt, i, unknownScale);
         }
@@ -0,0 +1,108 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/numeric/numeric.hpp>
+
+#include <ceres/ceres.h>
+#include <ceres/rotation.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace aliceVision {
+namespace sfm {
+
+/**
+ * @brief Ceres cost function pulling a parameter block toward a target value:
+ *        residuals = weight * (block - target)
+ *
+ *  Data parameter blocks are the following <N,N>
+ *  - N => dimension of the residuals,
+ *  - N => the parameter block (pose, landmark or intrinsic)
+ */
+class ParameterPriorCostFunction : public ceres::CostFunction
+{
+  public:
+    ParameterPriorCostFunction(const std::vector<double>& target, double weight)
+      : _target(target),
+        _weight(weight)
+    {
+        set_num_residuals(static_cast<int>(_target.size()));
+        mutable_parameter_block_sizes()->push_back(static_cast<int>(_target.size()));
+    }
+
+    bool Evaluate(double const* const* parameters, double* residuals, double** jacobians) const override
+    {
+        const std::size_t size = _target.size();
+
+        for (std::size_t i = 0; i < size; ++i)
+            residuals[i] = _weight * (parameters[0][i] - _target[i]);
+
+        if (jacobians != nullptr && jacobians[0] != nullptr)
+        {
+            // row-major diagonal jacobian
+            std::fill(jacobians[0], jacobians[0] + size * size, 0.0);
+            for (std::size_t i = 0; i < size; ++i)
+                jacobians[0][i * size + i] = _weight;
+        }
+
+        return true;
+    }
+
+  private:
+    std::vector<double> _target;
+    double _weight;
+};
+
+/**
+ * @brief Ceres functor pulling a pose block toward a target pose, on the rotation manifold:
+ *        residuals = weight * [log(R_target^T * R), t - t_target]
+ * @note The target angle-axis may be any representation of the rotation (its norm may exceed pi).
+ *
+ *  Data parameter blocks are the following <6,6>
+ *  - 6 => dimension of the residuals,
+ *  - 6 => the camera extrinsic data block [R;t]
+ */
+struct PosePriorErrorFunctor
+{
+    /**
+     * @param[in] target The target pose block: angle axis(3) + translation(3)
+     * @param[in] weight The residuals weight
+     */
+    PosePriorErrorFunctor(const std::vector<double>& target, double weight)
+      : _targetTranslation(target[3], target[4], target[5]),
+        _weight(weight)
+    {
+        ceres::AngleAxisToRotationMatrix(target.data(), _targetRotation.data());
+    }
+
+    template<typename T>
+    bool operator()(const T* const cam_Rt, T* out_residuals) const
+    {
+        Eigen::Matrix<T, 3, 3> R;
+        ceres::AngleAxisToRotationMatrix(cam_Rt, R.data());
+
+        const Eigen::Matrix<T, 3, 3> R_error = _targetRotation.transpose().cast<T>() * R;
+        ceres::RotationMatrixToAngleAxis(R_error.data(), out_residuals);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            out_residuals[i] *= T(_weight);
+            out_residuals[3 + i] = T(_weight) * (cam_Rt[3 + i] - T(_targetTranslation(i)));
+        }
+
+        return true;
+    }
+
+    Mat3 _targetRotation;
+    Vec3 _targetTranslation;
+    double _weight;
+};
+
+}  // namespace sfm
+}  // namespace aliceVision
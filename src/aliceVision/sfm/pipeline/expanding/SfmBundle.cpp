@@ -7,13 +7,13 @@
 #include "SfmBundle.hpp"
 #include <aliceVision/sfm/sfmFilters.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentPartitioned.hpp>
 
 namespace aliceVision {
 namespace sfm {
 
 bool SfmBundle::process(sfmData::SfMData & sfmData, const track::TracksHandler & tracksHandler, const std::set<IndexT> & viewIds)
 {   
-    BundleAdjustmentCeres::CeresOptions options;
     BundleAdjustment::ERefineOptions refineOptions;
 
     refineOptions |= BundleAdjustment::REFINE_ROTATION; 
@@ -26,13 +26,25 @@ bool SfmBundle::process(sfmData::SfMData & sfmData, const track::TracksHandler &
         return false;
     }
 
-    options.setSparseBA();
-    BundleAdjustmentCeres bundleObject(options, _minNbCamerasToRefinePrincipalPoint);
+    // the bundle adjustment is kept across the calls to reuse its problem
+    if (!_bundleAdjustment)
+    {
+        BundleAdjustmentCeres::CeresOptions options;
+        options.setSparseBA();
+        options.incremental = _useIncrementalBA;
+        _bundleAdjustment = std::make_unique<BundleAdjustmentCeres>(options, _minNbCamerasToRefinePrincipalPoint);
+    }
+
+    BundleAdjustmentCeres & bundleObject = *_bundleAdjustment;
+
+    // a problem exceeding the memory budget is partitioned
+    const std::unique_ptr<BundleAdjustmentPartitioned> partitionedBundleObject = BundleAdjustmentPartitioned::createIfPartitioned(
+      sfmData, bundleObject.getCeresOptions(), _bundleAdjustmentMemoryBudgetMB, _minNbCamerasToRefinePrincipalPoint);
 
     //Repeat until nothing change
     do 
     {
-        const bool success = bundleObject.adjust(sfmData, refineOptions);
+        const bool success = partitionedBundleObject ? partitionedBundleObject->adjust(sfmData, refineOptions) : bundleObject.adjust(sfmData, refineOptions);
         if (!success)
         {
             return false;
@@ -9,6 +9,8 @@
 #include <aliceVision/types.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentPartitioned.hpp>
 #include <aliceVision/track/TracksHandler.hpp>
 #include <aliceVision/sfm/pipeline/expanding/LbaPolicy.hpp>
 #include <aliceVision/sfm/pipeline/expanding/ExpansionHistory.hpp>
@@ -70,6 +72,26 @@ public:
     void setMinNbCamerasToRefinePrincipalPoint(size_t count)
     {
         _minNbCamerasToRefinePrincipalPoint = count;
+        _bundleAdjustment.reset();
+    }
+
+    /**
+     * @brief keep the bundle adjustment problem across the calls to process and only update what changed
+     * @param enable true to enable the incremental bundle adjustment
+    */
+    void setUseIncrementalBundleAdjustment(bool enable)
+    {
+        _useIncrementalBA = enable;
+        _bundleAdjustment.reset();
+    }
+
+    /**
+     * @brief set the memory budget of the bundle adjustment, larger problems are partitioned
+     * @param memoryBudgetMB the memory budget in MB (0: no limit)
+    */
+    void setBundleAdjustmentMemoryBudget(size_t memoryBudgetMB)
+    {
+        _bundleAdjustmentMemoryBudgetMB = memoryBudgetMB;
     }
 
 
@@ -88,6 +110,7 @@ private:
 
 private:
     LbaPolicy::uptr _lbaPolicy;
+    std::unique_ptr<BundleAdjustmentCeres> _bundleAdjustment;
 
 private:
 
@@ -99,6 +122,8 @@ private:
     size_t _bundleAdjustmentMaxOutlier = 50;
     size_t _minNbCamerasToRefinePrincipalPoint = 3;
     bool _useLBA = true;
+    bool _useIncrementalBA = false;
+    size_t _bundleAdjustmentMemoryBudgetMB = 0;
     size_t _minNbCamerasLBA = 100;
     size_t _LBAGraphDistanceLimit = 1;
     size_t _LBAMinNbOfMatches = 50;
@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "ReconstructionEngine_globalSfM.hpp"
+#include <aliceVision/sfm/bundle/BundleAdjustmentPartitioned.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/multiview/triangulation/triangulationDLT.hpp>
@@ -373,7 +374,11 @@ bool ReconstructionEngine_globalSfM::adjust()
     BundleAdjustmentCeres::CeresOptions options;
     options.useParametersOrdering = false;  // disable parameters ordering
 
-    BundleAdjustmentCeres BA(options);
+    // scenes exceeding the memory budget are partitioned
+    BundleAdjustmentPartitioned::PartitionOptions partitionOptions;
+    partitionOptions.memoryBudgetMB = _bundleAdjustmentMemoryBudgetMB;
+
+    BundleAdjustmentPartitioned BA(options, partitionOptions);
     // - refine only Structure and translations
     bool success = BA.adjust(_sfmData, BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE);
     if (success)
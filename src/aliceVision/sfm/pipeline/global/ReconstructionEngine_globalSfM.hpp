@@ -33,6 +33,9 @@ class ReconstructionEngine_globalSfM : public ReconstructionEngine
 
     void setLockAllIntrinsics(bool v) { _lockAllIntrinsics = v; }
 
+    /// Memory budget of the bundle adjustments in MB, larger scenes are partitioned (0: no limit)
+    void setBundleAdjustmentMemoryBudget(std::size_t memoryBudgetMB) { _bundleAdjustmentMemoryBudgetMB = memoryBudgetMB; }
+
     virtual bool process();
 
   protected:
@@ -60,6 +63,7 @@ class ReconstructionEngine_globalSfM : public ReconstructionEngine
     ERotationAveragingMethod _eRotationAveragingMethod;
     ETranslationAveragingMethod _eTranslationAveragingMethod;
     bool _lockAllIntrinsics = false;
+    std::size_t _bundleAdjustmentMemoryBudgetMB = 0;
     EFeatureConstraint _featureConstraint = EFeatureConstraint::BASIC;
 
     // Data provider
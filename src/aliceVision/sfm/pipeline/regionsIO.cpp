@@ -15,6 +15,7 @@
 #include <atomic>
 #include <cassert>
 #include <filesystem>
+#include <functional>
 
 namespace fs = std::filesystem;
 
@@ -23,50 +24,80 @@ namespace sfm {
 
 using namespace sfmData;
 
-std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& folders, IndexT viewId, const feature::ImageDescriber& imageDescriber)
+std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& folders,
+                                              IndexT viewId,
+                                              const feature::ImageDescriber& imageDescriber,
+                                              bool memoryMapped)
 {
     assert(!folders.empty());
 
     const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriber.getDescriberType());
     const std::string basename = std::to_string(viewId);
 
+    std::string regionsFilename;
     std::string featFilename;
     std::string descFilename;
 
     for (const std::string& folder : folders)
     {
+        const fs::path regionsPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + feature::REGIONS_FILE_EXTENSION);
         const fs::path featPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + ".feat");
         const fs::path descPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + ".desc");
 
-        if (utils::exists(featPath) && utils::exists(descPath))
+        // binary regions file first, .feat/.desc files as fallback
+        if (utils::exists(regionsPath))
         {
+            regionsFilename = regionsPath.string();
+            featFilename.clear();
+            descFilename.clear();
+        }
+        else if (utils::exists(featPath) && utils::exists(descPath))
+        {
+            regionsFilename.clear();
             featFilename = featPath.string();
             descFilename = descPath.string();
         }
     }
 
-    if (featFilename.empty() || descFilename.empty())
+    if (regionsFilename.empty() && (featFilename.empty() || descFilename.empty()))
     {
         const std::string foldersStr = boost::algorithm::join(folders, ", ");
         throw std::runtime_error("Can't find view " + basename + " region files in folders " + foldersStr);
     }
 
-    ALICEVISION_LOG_TRACE("Features filename: " << featFilename);
-    ALICEVISION_LOG_TRACE("Descriptors filename: " << descFilename);
+    if (!regionsFilename.empty())
+    {
+        ALICEVISION_LOG_TRACE("Regions filename: " << regionsFilename);
+    }
+    else
+    {
+        ALICEVISION_LOG_TRACE("Features filename: " << featFilename);
+        ALICEVISION_LOG_TRACE("Descriptors filename: " << descFilename);
+    }
 
     std::unique_ptr<feature::Regions> regionsPtr;
     imageDescriber.allocate(regionsPtr);
 
     try
     {
-        regionsPtr->Load(featFilename, descFilename);
+        if (!regionsFilename.empty())
+            regionsPtr->LoadBinary(regionsFilename, memoryMapped);
+        else
+            regionsPtr->Load(featFilename, descFilename);
     }
     catch (const std::exception& e)
     {
         std::stringstream ss;
         ss << "Invalid " << imageDescriberTypeName << " regions files for the view " << basename << " : \n";
-        ss << "\t- Features file : " << featFilename << "\n";
-        ss << "\t- Descriptors file: " << descFilename << "\n";
+        if (!regionsFilename.empty())
+        {
+            ss << "\t- Regions file : " << regionsFilename << "\n";
+        }
+        else
+        {
+            ss << "\t- Features file : " << featFilename << "\n";
+            ss << "\t- Descriptors file: " << descFilename << "\n";
+        }
         ss << "\t  " << e.what() << "\n";
         ALICEVISION_LOG_ERROR(ss.str());
 
@@ -84,6 +115,7 @@ std::unique_ptr<feature::Regions> loadFeatures(const std::vector<std::string>& f
     const std::string imageDescriberTypeName = feature::EImageDescriberType_enumToString(imageDescriber.getDescriberType());
     const std::string basename = std::to_string(viewId);
 
+    std::string regionsFilename;
     std::string featFilename;
 
     // build up a set with normalized paths to remove duplicates
@@ -98,32 +130,47 @@ std::unique_ptr<feature::Regions> loadFeatures(const std::vector<std::string>& f
 
     for (const auto& folder : foldersSet)
     {
+        const fs::path regionsPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + feature::REGIONS_FILE_EXTENSION);
         const fs::path featPath = fs::path(folder) / std::string(basename + "." + imageDescriberTypeName + ".feat");
-        if (utils::exists(featPath))
+
+        // binary regions file first, .feat file as fallback
+        if (utils::exists(regionsPath))
+        {
+            regionsFilename = regionsPath.string();
+            featFilename.clear();
+        }
+        else if (utils::exists(featPath))
+        {
+            regionsFilename.clear();
             featFilename = featPath.string();
+        }
     }
 
-    if (featFilename.empty())
+    if (regionsFilename.empty() && featFilename.empty())
     {
         const std::vector<std::string> folders(foldersSet.begin(), foldersSet.end());
         const std::string foldersStr = boost::algorithm::join(folders, ", ");
         throw std::runtime_error("Can't find view " + basename + " features files in folders " + foldersStr);
     }
 
-    ALICEVISION_LOG_DEBUG("Features filename: " << featFilename);
+    const std::string& filename = regionsFilename.empty() ? featFilename : regionsFilename;
+    ALICEVISION_LOG_DEBUG("Features filename: " << filename);
 
     std::unique_ptr<feature::Regions> regionsPtr;
     imageDescriber.allocate(regionsPtr);
 
     try
     {
-        regionsPtr->LoadFeatures(featFilename);
+        if (!regionsFilename.empty())
+            regionsPtr->LoadFeaturesBinary(regionsFilename);
+        else
+            regionsPtr->LoadFeatures(featFilename);
     }
     catch (const std::exception& e)
     {
         std::stringstream ss;
         ss << "Invalid " << imageDescriberTypeName << " features file for the view " << basename << " : \n";
-        ss << "\t- Features file : " << featFilename << "\n";
+        ss << "\t- Features file : " << filename << "\n";
         ss << "\t  " << e.what() << "\n";
         ALICEVISION_LOG_ERROR(ss.str());
 
@@ -194,11 +241,17 @@ bool loadFeaturesPerDescPerView(std::vector<std::vector<std::unique_ptr<feature:
     return loadingSuccess;
 }
 
-bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
-                        const SfMData& sfmData,
-                        const std::vector<std::string>& folders,
-                        const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
-                        const std::set<IndexT>& viewIdFilter)
+namespace {
+
+using ViewRegionsLoader =
+  std::function<std::unique_ptr<feature::Regions>(const std::vector<std::string>&, IndexT, const feature::ImageDescriber&)>;
+
+bool loadRegionsPerViewWith(feature::RegionsPerView& regionsPerView,
+                            const SfMData& sfmData,
+                            const std::vector<std::string>& folders,
+                            const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
+                            const std::set<IndexT>& viewIdFilter,
+                            const ViewRegionsLoader& loadViewRegions)
 {
     std::vector<std::string> featuresFolders = sfmData.getFeaturesFolders();        // add sfm features folders
     featuresFolders.insert(featuresFolders.end(), folders.begin(), folders.end());  // add user features folders
@@ -228,7 +281,7 @@ bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
                     std::unique_ptr<feature::Regions> regionsPtr;
                     try
                     {
-                        regionsPtr = loadRegions(featuresFolders, iter->second.get()->getViewId(), *(imageDescribers.at(i)));
+                        regionsPtr = loadViewRegions(featuresFolders, iter->second.get()->getViewId(), *(imageDescribers.at(i)));
                     }
                     catch (const std::exception& e)
                     {
@@ -251,6 +304,35 @@ bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
     return !invalid;
 }
 
+}  // namespace
+
+bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
+                        const SfMData& sfmData,
+                        const std::vector<std::string>& folders,
+                        const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
+                        const std::set<IndexT>& viewIdFilter,
+                        bool memoryMapped)
+{
+    return loadRegionsPerViewWith(
+      regionsPerView,
+      sfmData,
+      folders,
+      imageDescriberTypes,
+      viewIdFilter,
+      [memoryMapped](const std::vector<std::string>& featuresFolders, IndexT viewId, const feature::ImageDescriber& imageDescriber) {
+          return loadRegions(featuresFolders, viewId, imageDescriber, memoryMapped);
+      });
+}
+
+bool loadFeaturesRegionsPerView(feature::RegionsPerView& regionsPerView,
+                                const SfMData& sfmData,
+                                const std::vector<std::string>& folders,
+                                const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
+                                const std::set<IndexT>& viewIdFilter)
+{
+    return loadRegionsPerViewWith(regionsPerView, sfmData, folders, imageDescriberTypes, viewIdFilter, &loadFeatures);
+}
+
 bool loadFeaturesPerView(feature::FeaturesPerView& featuresPerView,
                          const SfMData& sfmData,
                          const std::vector<std::string>& folders,
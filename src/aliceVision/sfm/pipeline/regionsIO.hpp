@@ -21,15 +21,21 @@ namespace sfm {
 
 /**
  * @brief Load Regions (Features & Descriptors) for one view.
+ *        A binary regions file is used if available, otherwise the .feat/.desc files.
  * @param[in] folders The list of featureFolders
  * @param[in] viewId The view id
  * @param[in] imageDescriber The imageDescriber type
+ * @param[in] memoryMapped Expose the descriptors of binary regions files from a memory mapping, without copy
  * @return loaded Regions
  */
-std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& folders, IndexT viewId, const feature::ImageDescriber& imageDescriber);
+std::unique_ptr<feature::Regions> loadRegions(const std::vector<std::string>& folders,
+                                              IndexT viewId,
+                                              const feature::ImageDescriber& imageDescriber,
+                                              bool memoryMapped = false);
 
 /**
  * @brief Load Features for one view.
+ *        A binary regions file is used if available, otherwise the .feat file.
  * @param[in] folders The list of featureFolders
  * @param[in] viewId The view id
  * @param[in] imageDescriber The imageDescriber type
@@ -57,13 +63,30 @@ bool loadFeaturesPerDescPerView(std::vector<std::vector<std::unique_ptr<feature:
  * @param[in] folders The feature Folders
  * @param[in] imageDescriberTypes The imageDescriber types
  * @param[in] filter To load Regions only for a sub-set of the views contained in the sfmData
+ * @param[in] memoryMapped Expose the descriptors of binary regions files from a memory mapping, without copy
  * @return true if the regions are correctlty loaded
  */
 bool loadRegionsPerView(feature::RegionsPerView& regionsPerView,
                         const sfmData::SfMData& sfmData,
                         const std::vector<std::string>& folders,
                         const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
-                        const std::set<IndexT>& filter = std::set<IndexT>());
+                        const std::set<IndexT>& filter = std::set<IndexT>(),
+                        bool memoryMapped = false);
+
+/**
+ * @brief Load only the Features for each view of the provided SfMData container, in Regions without descriptors.
+ * @param[in,out] regionsPerView
+ * @param[in] sfmData The provided SfMData container
+ * @param[in] folders The feature Folders
+ * @param[in] imageDescriberTypes The imageDescriber types
+ * @param[in] filter To load Features only for a sub-set of the views contained in the sfmData
+ * @return true if the features are correctlty loaded
+ */
+bool loadFeaturesRegionsPerView(feature::RegionsPerView& regionsPerView,
+                                const sfmData::SfMData& sfmData,
+                                const std::vector<std::string>& folders,
+                                const std::vector<feature::EImageDescriberType>& imageDescriberTypes,
+                                const std::set<IndexT>& filter = std::set<IndexT>());
 
 /**
  * @brief Load Features for each view of the provided SfMData container.
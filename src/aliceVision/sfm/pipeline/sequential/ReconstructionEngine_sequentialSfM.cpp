@@ -683,7 +683,9 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
     ALICEVISION_LOG_INFO("Bundle adjustment start.");
     auto chronoStart = std::chrono::steady_clock::now();
 
-    BundleAdjustmentCeres::CeresOptions options;
+    // start from the options of the previous bundle adjustment to keep the loss function of its persistent problem
+    BundleAdjustmentCeres::CeresOptions options = _bundleAdjustment ? _bundleAdjustment->getCeresOptions() : BundleAdjustmentCeres::CeresOptions();
+    options.incremental = _params.useIncrementalBundleAdjustment;
     BundleAdjustment::ERefineOptions refineOptions =
       BundleAdjustment::REFINE_ROTATION | BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE;
 
@@ -738,7 +740,12 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
         }
     }
 
-    BundleAdjustmentCeres BA(options, _params.minNbCamerasToRefinePrincipalPoint);
+    if (!_bundleAdjustment)
+        _bundleAdjustment = std::make_unique<BundleAdjustmentCeres>(options, _params.minNbCamerasToRefinePrincipalPoint);
+    else
+        _bundleAdjustment->setCeresOptions(options);
+
+    BundleAdjustmentCeres& BA = *_bundleAdjustment;
 
     // give the local strategy graph is local strategy is enable
     if (!enableLocalStrategy)
@@ -746,6 +753,10 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
         _sfmData.resetParameterStates();
     }
 
+    // the bundle adjustment of a scene exceeding the memory budget is partitioned
+    const std::unique_ptr<BundleAdjustmentPartitioned> partitionedBA = BundleAdjustmentPartitioned::createIfPartitioned(
+      _sfmData, options, _params.bundleAdjustmentMemoryBudgetMB, _params.minNbCamerasToRefinePrincipalPoint);
+
     // perform BA until all point are under the given precision
     do
     {
@@ -754,7 +765,7 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
 
         // bundle adjustment iteration
         {
-            const bool success = BA.adjust(_sfmData, refineOptions);
+            const bool success = partitionedBA ? partitionedBA->adjust(_sfmData, refineOptions) : BA.adjust(_sfmData, refineOptions);
 
             if (!success)
                 return false;  // not usable solution
@@ -764,7 +775,7 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
                 _localStrategyGraph->saveIntrinsicsToHistory(_sfmData);
 
             // export and print information about the refinement
-            const BundleAdjustmentCeres::Statistics& statistics = BA.getStatistics();
+            const BundleAdjustmentCeres::Statistics& statistics = partitionedBA ? partitionedBA->getStatistics() : BA.getStatistics();
             statistics.exportToFile(_outputFolder, "bundle_adjustment.csv");
             statistics.show();
         }
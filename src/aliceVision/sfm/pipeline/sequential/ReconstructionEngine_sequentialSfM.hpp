@@ -9,6 +9,8 @@
 
 #include <aliceVision/sfm/pipeline/ReconstructionEngine.hpp>
 #include <aliceVision/sfm/LocalBundleAdjustmentGraph.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentPartitioned.hpp>
 #include <aliceVision/sfm/pipeline/localization/SfMLocalizer.hpp>
 #include <aliceVision/sfm/pipeline/pairwiseMatchesIO.hpp>
 #include <aliceVision/sfm/pipeline/RigSequence.hpp>
@@ -46,6 +48,10 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
         int minPointsPerPose = 30;
         bool useLocalBundleAdjustment = false;
         int localBundelAdjustementGraphDistanceLimit = 1;
+        /// Keep the bundle adjustment problem across the resections and only update what changed
+        bool useIncrementalBundleAdjustment = false;
+        /// Memory budget of the bundle adjustments, in MB: larger problems are partitioned (0: no limit)
+        std::size_t bundleAdjustmentMemoryBudgetMB = 0;
 
         /// Dump current status of the scene every 3 resections
         bool logIntermediateSteps = false;
@@ -379,6 +385,8 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
 
     /// Contains all the data used by the Local BA approach
     std::shared_ptr<LocalBundleAdjustmentGraph> _localStrategyGraph;
+    /// Bundle adjustment kept across the resections (persistent problem in incremental mode)
+    std::unique_ptr<BundleAdjustmentCeres> _bundleAdjustment;
 
     // Log
 
@@ -7,6 +7,7 @@
 
 #include "sfmFilters.hpp"
 #include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmData/LandmarksIndex.hpp>
 #include <aliceVision/stl/stl.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
@@ -21,29 +22,53 @@ IndexT removeOutliersWithPixelResidualError(sfmData::SfMData& sfmData,
                                             const double dThresholdPixel,
                                             const unsigned int minTrackLength)
 {
-    IndexT outlierCount = 0;
-    sfmData::Landmarks::iterator iterTracks = sfmData.getLandmarks().begin();
+    // index the landmarks and the offsets of their observations, to iterate them in parallel
+    const sfmData::LandmarksIndex landmarks(sfmData.getLandmarks());
+    const std::ptrdiff_t nbLandmarks = static_cast<std::ptrdiff_t>(landmarks.size());
+
+    // flag the outlier observations in parallel
+    std::vector<char> isOutlier(landmarks.nbObservations(), 0);
 
-    while (iterTracks != sfmData.getLandmarks().end())
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (std::ptrdiff_t i = 0; i < nbLandmarks; ++i)
     {
-        sfmData::Observations& observations = iterTracks->second.getObservations();
-        sfmData::Observations::iterator itObs = observations.begin();
+        const sfmData::Landmark& landmark = landmarks.getLandmark(i);
+        std::size_t k = landmarks.observationsBegin(i);
 
-        while (itObs != observations.end())
+        for (const auto& observationPair : landmark.getObservations())
         {
-            const sfmData::View* view = sfmData.getViews().at(itObs->first).get();
+            const sfmData::Observation& observation = observationPair.second;
+            const sfmData::View* view = sfmData.getViews().at(observationPair.first).get();
             const geometry::Pose3 pose = sfmData.getPose(*view).getTransform();
             const camera::IntrinsicBase* intrinsic = sfmData.getIntrinsics().at(view->getIntrinsicId()).get();
 
-            Vec2 residual = intrinsic->residual(pose, iterTracks->second.X.homogeneous(), itObs->second.getCoordinates());
-            if (featureConstraint == EFeatureConstraint::SCALE && itObs->second.getScale() > 0.0)
+            Vec2 residual = intrinsic->residual(pose, landmark.X.homogeneous(), observation.getCoordinates());
+            if (featureConstraint == EFeatureConstraint::SCALE && observation.getScale() > 0.0)
             {
                 // Apply the scale of the feature to get a residual value
                 // relative to the feature precision.
-                residual /= itObs->second.getScale();
+                residual /= observation.getScale();
             }
 
-            if ((pose.depth(iterTracks->second.X) < 0) || (residual.norm() > dThresholdPixel))
+            if ((pose.depth(landmark.X) < 0) || (residual.norm() > dThresholdPixel))
+                isOutlier[k] = 1;
+            ++k;
+        }
+    }
+
+    // remove the outlier observations and the too short tracks
+    IndexT outlierCount = 0;
+    sfmData::Landmarks::iterator iterTracks = sfmData.getLandmarks().begin();
+
+    for (std::ptrdiff_t i = 0; i < nbLandmarks; ++i)
+    {
+        sfmData::Observations& observations = iterTracks->second.getObservations();
+        std::size_t k = landmarks.observationsBegin(i);
+        sfmData::Observations::iterator itObs = observations.begin();
+
+        while (itObs != observations.end())
+        {
+            if (isOutlier[k++])
             {
                 ++outlierCount;
                 itObs = observations.erase(itObs);
@@ -65,17 +90,16 @@ IndexT removeOutliersWithAngleError(sfmData::SfMData& sfmData, const double dMin
     // note that smallest accepted angle => largest accepted cos(angle)
     const double dMaxAcceptedCosAngle = std::cos(degreeToRadian(dMinAcceptedAngle));
 
-    using LandmarksKeysVec = std::vector<sfmData::Landmarks::key_type>;
-    LandmarksKeysVec vKeys;
-    vKeys.reserve(sfmData.getLandmarks().size());
-    std::transform(sfmData.getLandmarks().cbegin(), sfmData.getLandmarks().cend(), std::back_inserter(vKeys), stl::RetrieveKey());
+    // index the landmarks, to iterate them in parallel
+    const sfmData::LandmarksIndex landmarks(sfmData.getLandmarks());
 
+    using LandmarksKeysVec = std::vector<sfmData::Landmarks::key_type>;
     LandmarksKeysVec toErase;
 
 #pragma omp parallel for
-    for (int landmarkIndex = 0; landmarkIndex < vKeys.size(); ++landmarkIndex)
+    for (std::ptrdiff_t landmarkIndex = 0; landmarkIndex < static_cast<std::ptrdiff_t>(landmarks.size()); ++landmarkIndex)
     {
-        const sfmData::Observations& observations = sfmData.getLandmarks().at(vKeys[landmarkIndex]).getObservations();
+        const sfmData::Observations& observations = landmarks.getLandmark(landmarkIndex).getObservations();
 
         // create matrix for observation directions from camera to point
         Mat3X viewDirections(3, observations.size());
@@ -140,7 +164,7 @@ IndexT removeOutliersWithAngleError(sfmData::SfMData& sfmData, const double dMin
         if (i == 0)
         {
 #pragma omp critical
-            toErase.push_back(vKeys[landmarkIndex]);
+            toErase.push_back(landmarks.getLandmarkId(landmarkIndex));
         }
     }
 
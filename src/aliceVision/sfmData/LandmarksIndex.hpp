@@ -0,0 +1,58 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sfmData/SfMData.hpp>
+
+#include <vector>
+
+namespace aliceVision {
+namespace sfmData {
+
+/**
+ * @brief Random access index over the landmarks of a scene, to iterate them in parallel.
+ *
+ * The landmarks are not copied: the index references the map entries (sorted by id) and stores
+ * the prefix sum of their observations counts, so the observations of the landmark i can address
+ * per-observation outputs in [observationsBegin(i), observationsEnd(i)).
+ * The index is invalidated if landmarks are added or removed, or if observations are modified.
+ */
+class LandmarksIndex
+{
+  public:
+    explicit LandmarksIndex(const Landmarks& landmarks)
+    {
+        _landmarks.reserve(landmarks.size());
+        _observationsOffsets.reserve(landmarks.size() + 1);
+        for (const auto& landmarkPair : landmarks)
+        {
+            _landmarks.push_back(&landmarkPair);
+            _observationsOffsets.push_back(_observationsOffsets.back() + landmarkPair.second.getObservations().size());
+        }
+    }
+
+    std::size_t size() const { return _landmarks.size(); }
+
+    /// total number of observations
+    std::size_t nbObservations() const { return _observationsOffsets.back(); }
+
+    IndexT getLandmarkId(std::size_t i) const { return _landmarks[i]->first; }
+
+    const Landmark& getLandmark(std::size_t i) const { return _landmarks[i]->second; }
+
+    std::size_t observationsBegin(std::size_t i) const { return _observationsOffsets[i]; }
+
+    std::size_t observationsEnd(std::size_t i) const { return _observationsOffsets[i + 1]; }
+
+  private:
+    std::vector<const Landmarks::value_type*> _landmarks;
+    /// size() + 1 offsets of the landmarks observations
+    std::vector<std::size_t> _observationsOffsets{0};
+};
+
+}  // namespace sfmData
+}  // namespace aliceVision
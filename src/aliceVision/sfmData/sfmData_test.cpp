@@ -1,4 +1,5 @@
 #include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmData/LandmarksIndex.hpp>
 
 #define BOOST_TEST_MODULE sfmData
 
@@ -50,3 +51,32 @@ BOOST_AUTO_TEST_CASE(SfMData_InternalFolders)
     BOOST_CHECK_EQUAL(sfmData.getRelativeFeaturesFolders()[0], fs::relative(refFolder, otherFolder));
     BOOST_CHECK_EQUAL(sfmData.getRelativeMatchesFolders()[0], fs::relative(refFolder, otherFolder));
 }
+
+BOOST_AUTO_TEST_CASE(SfMData_LandmarksIndex)
+{
+    sfmData::Landmarks landmarks;
+    for (IndexT landmarkId = 0; landmarkId < 100; ++landmarkId)
+    {
+        sfmData::Landmark& landmark = landmarks[3 * landmarkId + 1];
+        landmark.X = Vec3(landmarkId, 2.0 * landmarkId, -1.0);
+        for (IndexT viewId = 0; viewId < landmarkId % 5; ++viewId)
+            landmark.getObservations()[2 * viewId] = sfmData::Observation(Vec2(viewId, landmarkId), landmarkId + viewId, 1.5);
+    }
+
+    const sfmData::LandmarksIndex landmarksIndex(landmarks);
+    BOOST_CHECK_EQUAL(landmarksIndex.size(), landmarks.size());
+
+    // the landmarks are referenced in the map order, the observations ranges are contiguous
+    std::size_t nbObservations = 0;
+    std::size_t i = 0;
+    for (const auto& landmarkPair : landmarks)
+    {
+        BOOST_CHECK_EQUAL(landmarksIndex.getLandmarkId(i), landmarkPair.first);
+        BOOST_CHECK_EQUAL(&landmarksIndex.getLandmark(i), &landmarkPair.second);
+        BOOST_CHECK_EQUAL(landmarksIndex.observationsBegin(i), nbObservations);
+        nbObservations += landmarkPair.second.getObservations().size();
+        BOOST_CHECK_EQUAL(landmarksIndex.observationsEnd(i), nbObservations);
+        ++i;
+    }
+    BOOST_CHECK_EQUAL(landmarksIndex.nbObservations(), nbObservations);
+}
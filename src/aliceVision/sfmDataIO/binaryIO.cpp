@@ -0,0 +1,623 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "binaryIO.hpp"
+#include <aliceVision/sfmDataIO/jsonIO.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace aliceVision {
+namespace sfmDataIO {
+
+namespace {
+
+constexpr char SFMB_MAGIC[8] = {'A', 'V', 'S', 'F', 'M', 'B', '\0', '\0'};
+constexpr uint32_t SFMB_FORMAT_VERSION = 1;
+constexpr std::size_t SFMB_ALIGNMENT = 8;
+constexpr std::size_t SFMB_WRITE_CHUNK = 1 << 16;
+
+enum class ESection : uint32_t
+{
+    FOLDERS = 1,
+    VIEWS = 2,
+    ANCESTORS = 3,
+    INTRINSICS = 4,
+    POSES = 5,
+    RIGS = 6,
+    LANDMARKS = 7,
+    OBSERVATIONS = 8,
+    OBSERVATIONS_FEATURES = 9
+};
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t sectionCount;
+    int32_t sfmDataVersion[3];
+    uint32_t reserved;
+};
+
+struct SectionEntry
+{
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct LandmarkRecord
+{
+    double X[3];
+    uint64_t firstObservation;
+    uint32_t landmarkId;
+    uint32_t observationCount;
+    int32_t descType;
+    uint8_t rgb[3];
+    uint8_t reserved;
+};
+
+struct ObservationFeatureRecord
+{
+    double x[2];
+    double scale;
+    uint32_t featureId;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 32, "Unexpected FileHeader size");
+static_assert(sizeof(SectionEntry) == 24, "Unexpected SectionEntry size");
+static_assert(sizeof(LandmarkRecord) == 48, "Unexpected LandmarkRecord size");
+static_assert(sizeof(ObservationFeatureRecord) == 32, "Unexpected ObservationFeatureRecord size");
+
+/**
+ * @brief Write the sections of a file one after the other and keep track of their location.
+ */
+class SectionWriter
+{
+  public:
+    explicit SectionWriter(std::ofstream& stream)
+      : _stream(stream)
+    {}
+
+    void begin(ESection type)
+    {
+        const std::size_t position = static_cast<std::size_t>(_stream.tellp());
+        const std::size_t aligned = (position + SFMB_ALIGNMENT - 1) / SFMB_ALIGNMENT * SFMB_ALIGNMENT;
+        const char padding[SFMB_ALIGNMENT] = {};
+        _stream.write(padding, aligned - position);
+
+        SectionEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.type = static_cast<uint32_t>(type);
+        entry.offset = aligned;
+        _sections.push_back(entry);
+    }
+
+    void end() { _sections.back().size = static_cast<uint64_t>(_stream.tellp()) - _sections.back().offset; }
+
+    void writeTree(ESection type, const bpt::ptree& tree)
+    {
+        begin(type);
+        bpt::write_json(_stream, tree, false);
+        end();
+    }
+
+    /// Write a section of records, appended to the buffer by fill(element, buffer) for each element of the container
+    template<typename Record, typename Container, typename Fill>
+    void writeRecords(ESection type, const Container& container, Fill fill)
+    {
+        begin(type);
+        std::vector<Record> buffer;
+        buffer.reserve(SFMB_WRITE_CHUNK);
+        for (const auto& element : container)
+        {
+            fill(element, buffer);
+            if (buffer.size() >= SFMB_WRITE_CHUNK)
+            {
+                _stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Record));
+                buffer.clear();
+            }
+        }
+        _stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Record));
+        end();
+    }
+
+    const std::vector<SectionEntry>& getSections() const { return _sections; }
+
+  private:
+    std::ofstream& _stream;
+    std::vector<SectionEntry> _sections;
+};
+
+/**
+ * @brief Random access to the sections of a file.
+ */
+class SectionReader
+{
+  public:
+    SectionReader(std::ifstream& stream, const std::string& filename)
+      : _stream(stream),
+        _filename(filename)
+    {}
+
+    void addSection(const SectionEntry& entry) { _sections[static_cast<ESection>(entry.type)] = entry; }
+
+    bool hasSection(ESection type) const { return _sections.count(type) != 0; }
+
+    bool readTree(ESection type, bpt::ptree& tree)
+    {
+        if (!hasSection(type))
+            return false;
+        std::string buffer;
+        read(type, buffer);
+        std::istringstream iss(buffer);
+        bpt::read_json(iss, tree);
+        return true;
+    }
+
+    template<typename Record>
+    bool readRecords(ESection type, std::vector<Record>& records)
+    {
+        if (!hasSection(type))
+            return false;
+        const SectionEntry& entry = _sections.at(type);
+        if (entry.size % sizeof(Record) != 0)
+            throw std::runtime_error("Can't load SfMData binary file, '" + _filename + "' has an invalid section !");
+        records.resize(entry.size / sizeof(Record));
+        seek(entry);
+        _stream.read(reinterpret_cast<char*>(records.data()), entry.size);
+        check();
+        return true;
+    }
+
+  private:
+    void read(ESection type, std::string& buffer)
+    {
+        const SectionEntry& entry = _sections.at(type);
+        buffer.resize(entry.size);
+        seek(entry);
+        _stream.read(&buffer[0], entry.size);
+        check();
+    }
+
+    void seek(const SectionEntry& entry)
+    {
+        _stream.clear();
+        _stream.seekg(static_cast<std::streamoff>(entry.offset));
+    }
+
+    void check() const
+    {
+        if (!_stream)
+            throw std::runtime_error("Can't load SfMData binary file, '" + _filename + "' is incorrect !");
+    }
+
+    std::ifstream& _stream;
+    const std::string& _filename;
+    std::map<ESection, SectionEntry> _sections;
+};
+
+}  // namespace
+
+bool saveBinary(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
+{
+    // save flags
+    const bool saveViews = (partFlag & VIEWS) == VIEWS;
+    const bool saveAncestors = (partFlag & ANCESTORS) == ANCESTORS;
+    const bool saveIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
+    const bool saveExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
+    const bool saveStructure = (partFlag & STRUCTURE) == STRUCTURE;
+    const bool saveFeatures = (partFlag & OBSERVATIONS_WITH_FEATURES) == OBSERVATIONS_WITH_FEATURES;
+    const bool saveObservations = saveFeatures || ((partFlag & OBSERVATIONS) == OBSERVATIONS);
+
+    std::ofstream stream(filename, std::ios::out | std::ios::binary);
+    if (!stream.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Cannot save the SfMData binary file, cannot open '" << filename << "'.");
+        return false;
+    }
+
+    // the section table is written at the end, once the sections are known (at most one per ESection)
+    const std::size_t maxSectionCount = static_cast<std::size_t>(ESection::OBSERVATIONS_FEATURES);
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::vector<SectionEntry> sectionTable(maxSectionCount);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(sectionTable.data()), sectionTable.size() * sizeof(SectionEntry));
+
+    SectionWriter writer(stream);
+
+    // folders
+    if (!sfmData.getRelativeFeaturesFolders().empty() || !sfmData.getRelativeMatchesFolders().empty())
+    {
+        bpt::ptree foldersTree;
+        bpt::ptree featureFoldersTree;
+        for (const std::string& featuresFolder : sfmData.getRelativeFeaturesFolders())
+        {
+            bpt::ptree featureFolderTree;
+            featureFolderTree.put("", featuresFolder);
+            featureFoldersTree.push_back(std::make_pair("", featureFolderTree));
+        }
+        foldersTree.add_child("featuresFolders", featureFoldersTree);
+
+        bpt::ptree matchingFoldersTree;
+        for (const std::string& matchesFolder : sfmData.getRelativeMatchesFolders())
+        {
+            bpt::ptree matchingFolderTree;
+            matchingFolderTree.put("", matchesFolder);
+            matchingFoldersTree.push_back(std::make_pair("", matchingFolderTree));
+        }
+        foldersTree.add_child("matchesFolders", matchingFoldersTree);
+
+        writer.writeTree(ESection::FOLDERS, foldersTree);
+    }
+
+    // views
+    if (saveViews && !sfmData.getViews().empty())
+    {
+        bpt::ptree viewsTree;
+        for (const auto& viewPair : sfmData.getViews())
+            saveView("", *(viewPair.second), viewsTree);
+
+        bpt::ptree sectionTree;
+        sectionTree.add_child("views", viewsTree);
+        writer.writeTree(ESection::VIEWS, sectionTree);
+    }
+
+    // ancestors
+    if (saveAncestors && !sfmData.getAncestors().empty())
+    {
+        bpt::ptree ancestorsTree;
+        for (const auto& ancestorPair : sfmData.getAncestors())
+            saveAncestor(std::to_string(ancestorPair.first), ancestorPair.first, ancestorPair.second, ancestorsTree);
+
+        bpt::ptree sectionTree;
+        sectionTree.add_child("ancestors", ancestorsTree);
+        writer.writeTree(ESection::ANCESTORS, sectionTree);
+    }
+
+    // intrinsics
+    if (saveIntrinsics && !sfmData.getIntrinsics().empty())
+    {
+        bpt::ptree intrinsicsTree;
+        for (const auto& intrinsicPair : sfmData.getIntrinsics())
+            saveIntrinsic("", intrinsicPair.first, intrinsicPair.second, intrinsicsTree);
+
+        bpt::ptree sectionTree;
+        sectionTree.add_child("intrinsics", intrinsicsTree);
+        writer.writeTree(ESection::INTRINSICS, sectionTree);
+    }
+
+    // extrinsics
+    if (saveExtrinsics)
+    {
+        // poses
+        if (!sfmData.getPoses().empty())
+        {
+            bpt::ptree posesTree;
+            for (const auto& posePair : sfmData.getPoses())
+            {
+                bpt::ptree poseTree;
+                poseTree.put("poseId", posePair.first);
+                saveCameraPose("pose", posePair.second, poseTree);
+                posesTree.push_back(std::make_pair("", poseTree));
+            }
+
+            bpt::ptree sectionTree;
+            sectionTree.add_child("poses", posesTree);
+            writer.writeTree(ESection::POSES, sectionTree);
+        }
+
+        // rigs
+        if (!sfmData.getRigs().empty())
+        {
+            bpt::ptree rigsTree;
+            for (const auto& rigPair : sfmData.getRigs())
+                saveRig("", rigPair.first, rigPair.second, rigsTree);
+
+            bpt::ptree sectionTree;
+            sectionTree.add_child("rigs", rigsTree);
+            writer.writeTree(ESection::RIGS, sectionTree);
+        }
+    }
+
+    // structure
+    if (saveStructure && !sfmData.getLandmarks().empty())
+    {
+        uint64_t firstObservation = 0;
+        writer.writeRecords<LandmarkRecord>(
+          ESection::LANDMARKS, sfmData.getLandmarks(), [&](const sfmData::Landmarks::value_type& landmarkPair, std::vector<LandmarkRecord>& buffer) {
+              const sfmData::Landmark& landmark = landmarkPair.second;
+              LandmarkRecord record;
+              std::memset(&record, 0, sizeof(record));
+              for (int i = 0; i < 3; ++i)
+              {
+                  record.X[i] = landmark.X(i);
+                  record.rgb[i] = landmark.rgb(i);
+              }
+              record.landmarkId = landmarkPair.first;
+              record.descType = static_cast<int32_t>(landmark.descType);
+              if (saveObservations)
+              {
+                  record.firstObservation = firstObservation;
+                  record.observationCount = static_cast<uint32_t>(landmark.getObservations().size());
+                  firstObservation += record.observationCount;
+              }
+              buffer.push_back(record);
+          });
+
+        if (saveObservations)
+        {
+            writer.writeRecords<uint32_t>(
+              ESection::OBSERVATIONS, sfmData.getLandmarks(), [](const sfmData::Landmarks::value_type& landmarkPair, std::vector<uint32_t>& buffer) {
+                  for (const auto& obsPair : landmarkPair.second.getObservations())
+                      buffer.push_back(obsPair.first);
+              });
+        }
+
+        if (saveFeatures)
+        {
+            writer.writeRecords<ObservationFeatureRecord>(
+              ESection::OBSERVATIONS_FEATURES,
+              sfmData.getLandmarks(),
+              [](const sfmData::Landmarks::value_type& landmarkPair, std::vector<ObservationFeatureRecord>& buffer) {
+                  for (const auto& obsPair : landmarkPair.second.getObservations())
+                  {
+                      const sfmData::Observation& observation = obsPair.second;
+                      ObservationFeatureRecord record;
+                      std::memset(&record, 0, sizeof(record));
+                      record.x[0] = observation.getX();
+                      record.x[1] = observation.getY();
+                      record.scale = observation.getScale();
+                      record.featureId = observation.getFeatureId();
+                      buffer.push_back(record);
+                  }
+              });
+        }
+    }
+
+    // header and section table
+    std::memcpy(header.magic, SFMB_MAGIC, sizeof(header.magic));
+    header.formatVersion = SFMB_FORMAT_VERSION;
+    header.sectionCount = static_cast<uint32_t>(writer.getSections().size());
+    header.sfmDataVersion[0] = ALICEVISION_SFMDATAIO_VERSION_MAJOR;
+    header.sfmDataVersion[1] = ALICEVISION_SFMDATAIO_VERSION_MINOR;
+    header.sfmDataVersion[2] = ALICEVISION_SFMDATAIO_VERSION_REVISION;
+    std::copy(writer.getSections().begin(), writer.getSections().end(), sectionTable.begin());
+
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(sectionTable.data()), sectionTable.size() * sizeof(SectionEntry));
+
+    if (!stream.good())
+    {
+        ALICEVISION_LOG_ERROR("Cannot save the SfMData binary file '" << filename << "'.");
+        return false;
+    }
+
+    return true;
+}
+
+bool loadBinary(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
+{
+    // load flags
+    const bool loadViews = (partFlag & VIEWS) == VIEWS;
+    const bool loadAncestors = (partFlag & ANCESTORS) == ANCESTORS;
+    const bool loadIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
+    const bool loadExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
+    const bool loadStructure = (partFlag & STRUCTURE) == STRUCTURE;
+    const bool loadFeatures = (partFlag & OBSERVATIONS_WITH_FEATURES) == OBSERVATIONS_WITH_FEATURES;
+    const bool loadObservations = loadFeatures || ((partFlag & OBSERVATIONS) == OBSERVATIONS);
+
+    std::ifstream stream(filename, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Cannot load the SfMData binary file, cannot open '" << filename << "'.");
+        return false;
+    }
+
+    FileHeader header;
+    stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!stream || std::memcmp(header.magic, SFMB_MAGIC, sizeof(header.magic)) != 0)
+    {
+        ALICEVISION_LOG_ERROR("The file '" << filename << "' is not an SfMData binary file.");
+        return false;
+    }
+    if (header.formatVersion != SFMB_FORMAT_VERSION)
+    {
+        ALICEVISION_LOG_ERROR("The SfMData binary file '" << filename << "' has an unsupported format version: " << header.formatVersion << ".");
+        return false;
+    }
+
+    const Version version(header.sfmDataVersion[0], header.sfmDataVersion[1], header.sfmDataVersion[2]);
+    const Version currentVersion(ALICEVISION_SFMDATAIO_VERSION_MAJOR, ALICEVISION_SFMDATAIO_VERSION_MINOR, ALICEVISION_SFMDATAIO_VERSION_REVISION);
+    if (currentVersion < version)
+    {
+        ALICEVISION_LOG_ERROR("File has a version more recent than this library");
+        return false;
+    }
+
+    std::vector<SectionEntry> sectionTable(header.sectionCount);
+    stream.read(reinterpret_cast<char*>(sectionTable.data()), sectionTable.size() * sizeof(SectionEntry));
+    if (!stream)
+    {
+        ALICEVISION_LOG_ERROR("The SfMData binary file '" << filename << "' has an invalid section table.");
+        return false;
+    }
+
+    SectionReader reader(stream, filename);
+    for (const SectionEntry& entry : sectionTable)
+        reader.addSection(entry);
+
+    // folders
+    {
+        bpt::ptree foldersTree;
+        if (reader.readTree(ESection::FOLDERS, foldersTree))
+        {
+            for (bpt::ptree::value_type& featureFolderNode : foldersTree.get_child("featuresFolders"))
+                sfmData.addFeaturesFolder(featureFolderNode.second.get_value<std::string>());
+            for (bpt::ptree::value_type& matchingFolderNode : foldersTree.get_child("matchesFolders"))
+                sfmData.addMatchesFolder(matchingFolderNode.second.get_value<std::string>());
+        }
+    }
+
+    // intrinsics
+    bpt::ptree sectionTree;
+    if (loadIntrinsics && reader.readTree(ESection::INTRINSICS, sectionTree))
+    {
+        sfmData::Intrinsics& intrinsics = sfmData.getIntrinsics();
+
+        for (bpt::ptree::value_type& intrinsicNode : sectionTree.get_child("intrinsics"))
+        {
+            IndexT intrinsicId;
+            std::shared_ptr<camera::IntrinsicBase> intrinsic;
+
+            loadIntrinsic(version, intrinsicId, intrinsic, intrinsicNode.second);
+
+            intrinsics.emplace(intrinsicId, intrinsic);
+        }
+    }
+
+    // ancestors
+    sectionTree.clear();
+    if (loadAncestors && reader.readTree(ESection::ANCESTORS, sectionTree))
+    {
+        sfmData::ImageInfos& ancestors = sfmData.getAncestors();
+
+        for (bpt::ptree::value_type& ancestorNode : sectionTree.get_child("ancestors"))
+        {
+            IndexT ancestorId;
+            std::shared_ptr<sfmData::ImageInfo> ancestor = std::make_shared<sfmData::ImageInfo>();
+
+            loadAncestor(ancestorId, ancestor, ancestorNode.second);
+
+            ancestors.emplace(ancestorId, ancestor);
+        }
+    }
+
+    // views
+    sectionTree.clear();
+    if (loadViews && reader.readTree(ESection::VIEWS, sectionTree))
+    {
+        sfmData::Views& views = sfmData.getViews();
+
+        for (bpt::ptree::value_type& viewNode : sectionTree.get_child("views"))
+        {
+            auto view = std::make_shared<sfmData::View>();
+            loadView(*view, viewNode.second);
+            views.emplace(view->getViewId(), view);
+        }
+    }
+
+    // extrinsics
+    if (loadExtrinsics)
+    {
+        // poses
+        sectionTree.clear();
+        if (reader.readTree(ESection::POSES, sectionTree))
+        {
+            sfmData::Poses& poses = sfmData.getPoses();
+
+            for (bpt::ptree::value_type& poseNode : sectionTree.get_child("poses"))
+            {
+                bpt::ptree& poseTree = poseNode.second;
+                sfmData::CameraPose pose;
+
+                loadCameraPose("pose", pose, poseTree);
+
+                poses.emplace(poseTree.get<IndexT>("poseId"), pose);
+            }
+        }
+
+        // rigs
+        sectionTree.clear();
+        if (reader.readTree(ESection::RIGS, sectionTree))
+        {
+            sfmData::Rigs& rigs = sfmData.getRigs();
+
+            for (bpt::ptree::value_type& rigNode : sectionTree.get_child("rigs"))
+            {
+                IndexT rigId;
+                sfmData::Rig rig;
+
+                loadRig(rigId, rig, rigNode.second);
+
+                rigs.emplace(rigId, rig);
+            }
+        }
+    }
+    sectionTree.clear();
+
+    // structure
+    std::vector<LandmarkRecord> landmarkRecords;
+    if (loadStructure && reader.readRecords(ESection::LANDMARKS, landmarkRecords))
+    {
+        std::vector<uint32_t> observationViewIds;
+        std::vector<ObservationFeatureRecord> observationFeatures;
+        const bool withObservations = loadObservations && reader.readRecords(ESection::OBSERVATIONS, observationViewIds);
+        const bool withFeatures = withObservations && loadFeatures && reader.readRecords(ESection::OBSERVATIONS_FEATURES, observationFeatures);
+
+        if (withFeatures && observationFeatures.size() != observationViewIds.size())
+            throw std::runtime_error("Can't load SfMData binary file, '" + filename + "' has inconsistent observations !");
+
+        // the landmarks are stored sorted by id: insertions are at the end of the map
+        sfmData::Landmarks& landmarks = sfmData.getLandmarks();
+        std::vector<sfmData::Landmark*> landmarksPtr(landmarkRecords.size());
+        for (std::size_t i = 0; i < landmarkRecords.size(); ++i)
+        {
+            const LandmarkRecord& record = landmarkRecords[i];
+            auto it = landmarks.emplace_hint(landmarks.end(),
+                                             record.landmarkId,
+                                             sfmData::Landmark(Vec3(record.X[0], record.X[1], record.X[2]),
+                                                               static_cast<feature::EImageDescriberType>(record.descType),
+                                                               image::RGBColor(record.rgb[0], record.rgb[1], record.rgb[2])));
+            landmarksPtr[i] = &it->second;
+
+            if (withObservations && record.firstObservation + record.observationCount > observationViewIds.size())
+                throw std::runtime_error("Can't load SfMData binary file, '" + filename + "' has inconsistent observations !");
+        }
+
+        // the observations of the landmarks are independent
+        if (withObservations)
+        {
+#pragma omp parallel for schedule(dynamic, 1024)
+            for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(landmarkRecords.size()); ++i)
+            {
+                const LandmarkRecord& record = landmarkRecords[i];
+                sfmData::Observations& observations = landmarksPtr[i]->getObservations();
+                observations.reserve(record.observationCount);
+
+                for (uint64_t k = record.firstObservation; k < record.firstObservation + record.observationCount; ++k)
+                {
+                    sfmData::Observation observation;
+                    if (withFeatures)
+                    {
+                        const ObservationFeatureRecord& feature = observationFeatures[k];
+                        observation.setCoordinates(feature.x[0], feature.x[1]);
+                        observation.setFeatureId(feature.featureId);
+                        observation.setScale(feature.scale);
+                    }
+                    // the observations are stored sorted by view id
+                    observations.emplace_hint(observations.end(), observationViewIds[k], observation);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+}  // namespace sfmDataIO
+}  // namespace aliceVision
@@ -0,0 +1,49 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+
+#include <string>
+
+namespace aliceVision {
+namespace sfmDataIO {
+
+// AliceVision binary SfMData file (.sfmb):
+// -- Header
+// magic "AVSFMB", file format version, SfMData version, number of sections
+// -- Section table
+// one entry per section: type, offset, size in bytes
+// -- Sections
+// Views, ancestors, intrinsics, poses, rigs and folders are small: they are stored as
+// JSON documents with the same schema as the .sfm file.
+// Landmarks are stored as a contiguous array of fixed size records, followed by
+// the observations of all landmarks as two contiguous arrays (view ids, then features),
+// in the landmarks order.
+// --
+// Each part is a separate section, so the parts that are not requested are not read.
+
+/**
+ * @brief Save an SfMData in a binary file.
+ * @param[in] sfmData The input SfMData
+ * @param[in] filename The filename
+ * @param[in] partFlag The ESfMData save flag
+ * @return true if completed
+ */
+bool saveBinary(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
+
+/**
+ * @brief Load a binary SfMData file.
+ * @param[out] sfmData The output SfMData
+ * @param[in] filename The filename
+ * @param[in] partFlag The ESfMData load flag
+ * @return true if completed
+ */
+bool loadBinary(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
+
+}  // namespace sfmDataIO
+}  // namespace aliceVision
@@ -153,6 +153,23 @@ void saveView(const std::string& name, const sfmData::View& view, bpt::ptree& pa
  */
 void loadView(sfmData::View& view, bpt::ptree& viewTree);
 
+/**
+ * @brief Save an ancestor ImageInfo in a boost property tree.
+ * @param[in] name The node name ( "" = no name )
+ * @param[in] ancestorId The ancestor Id
+ * @param[in] ancestor The ancestor ImageInfo
+ * @param[out] parentTree The parent tree
+ */
+void saveAncestor(const std::string& name, IndexT ancestorId, const std::shared_ptr<sfmData::ImageInfo>& ancestor, bpt::ptree& parentTree);
+
+/**
+ * @brief Load an ancestor ImageInfo from a boost property tree.
+ * @param[out] ancestorId The output ancestor Id
+ * @param[out] ancestor The output ancestor ImageInfo (must be allocated)
+ * @param[in,out] ancestorTree The input tree
+ */
+void loadAncestor(IndexT& ancestorId, std::shared_ptr<sfmData::ImageInfo>& ancestor, bpt::ptree& ancestorTree);
+
 /**
  * @brief Save an Intrinsic in a boost property tree.
  * @param[in] name The node name ( "" = no name )
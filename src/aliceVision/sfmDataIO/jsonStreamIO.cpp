@@ -0,0 +1,938 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "jsonStreamIO.hpp"
+#include <aliceVision/sfmDataIO/jsonIO.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/json/basic_parser_impl.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+namespace aliceVision {
+namespace sfmDataIO {
+
+namespace {
+
+constexpr std::size_t JSON_READ_CHUNK = 1 << 20;
+
+std::string toString(double value)
+{
+    // same precision as the property tree (max_digits10)
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return buffer;
+}
+
+/**
+ * @brief Indented JSON writer, with the same output conventions as the property tree JSON writer.
+ */
+class JSONStreamWriter
+{
+  public:
+    explicit JSONStreamWriter(std::ostream& os)
+      : _os(os)
+    {}
+
+    void beginObject(const std::string& key = "") { begin(key, true); }
+
+    void beginArray(const std::string& key = "") { begin(key, false); }
+
+    void end()
+    {
+        const Level level = _stack.back();
+        _stack.pop_back();
+        if (!level.first)
+        {
+            _os.put('\n');
+            indent();
+        }
+        _os.put(level.isObject ? '}' : ']');
+        if (_stack.empty())
+            _os.put('\n');
+    }
+
+    /// Write a value (the key is ignored in arrays)
+    void value(const std::string& key, const std::string& text)
+    {
+        next(key);
+        writeString(text);
+    }
+
+    /// Write a property tree: leaves as strings, children with empty keys as arrays, others as objects
+    void writeTree(const std::string& key, const bpt::ptree& tree)
+    {
+        if (tree.empty())
+        {
+            value(key, tree.data());
+            return;
+        }
+
+        const bool isArray = tree.count("") == tree.size();
+        begin(key, !isArray);
+        for (const auto& child : tree)
+            writeTree(child.first, child.second);
+        end();
+    }
+
+  private:
+    struct Level
+    {
+        bool isObject;
+        bool first;
+    };
+
+    void begin(const std::string& key, bool isObject)
+    {
+        if (!_stack.empty())
+            next(key);
+        _os.put(isObject ? '{' : '[');
+        _stack.push_back({isObject, true});
+    }
+
+    void next(const std::string& key)
+    {
+        Level& level = _stack.back();
+        if (!level.first)
+            _os.put(',');
+        _os.put('\n');
+        level.first = false;
+        indent();
+        if (level.isObject)
+        {
+            writeString(key);
+            _os.write(": ", 2);
+        }
+    }
+
+    void indent()
+    {
+        for (std::size_t i = 0; i < _stack.size(); ++i)
+            _os.write("    ", 4);
+    }
+
+    void writeString(const std::string& text)
+    {
+        static const char hexDigits[] = "0123456789ABCDEF";
+
+        _os.put('"');
+        for (const char ch : text)
+        {
+            const unsigned char c = static_cast<unsigned char>(ch);
+            switch (ch)
+            {
+                case '"':
+                    _os.write("\\\"", 2);
+                    break;
+                case '\\':
+                    _os.write("\\\\", 2);
+                    break;
+                case '/':
+                    _os.write("\\/", 2);
+                    break;
+                case '\b':
+                    _os.write("\\b", 2);
+                    break;
+                case '\f':
+                    _os.write("\\f", 2);
+                    break;
+                case '\n':
+                    _os.write("\\n", 2);
+                    break;
+                case '\r':
+                    _os.write("\\r", 2);
+                    break;
+                case '\t':
+                    _os.write("\\t", 2);
+                    break;
+                default:
+                    if (c < 0x20)
+                    {
+                        const char escaped[] = {'\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xF]};
+                        _os.write(escaped, sizeof(escaped));
+                    }
+                    else
+                    {
+                        _os.put(ch);
+                    }
+                    break;
+            }
+        }
+        _os.put('"');
+    }
+
+    std::ostream& _os;
+    std::vector<Level> _stack;
+};
+
+/**
+ * @brief Build the property tree of one element from the parser events.
+ */
+class TreeBuilder
+{
+  public:
+    void begin(const std::string& key) { _stack.emplace_back(key, bpt::ptree()); }
+
+    /// Close the current node, return true if it is a whole element
+    bool end(std::pair<std::string, bpt::ptree>& element)
+    {
+        std::pair<std::string, bpt::ptree> node = std::move(_stack.back());
+        _stack.pop_back();
+        if (_stack.empty())
+        {
+            element = std::move(node);
+            return true;
+        }
+        _stack.back().second.push_back(std::move(node));
+        return false;
+    }
+
+    void leaf(const std::string& key, const std::string& text) { _stack.back().second.push_back(std::make_pair(key, bpt::ptree(text))); }
+
+  private:
+    std::vector<std::pair<std::string, bpt::ptree>> _stack;
+};
+
+/**
+ * @brief Landmarks of the file in flat arrays, before their insertion in the SfMData.
+ */
+struct LandmarksBuffer
+{
+    std::vector<IndexT> ids;
+    std::vector<feature::EImageDescriberType> descTypes;
+    std::vector<Vec3> positions;
+    std::vector<image::RGBColor> colors;
+    std::vector<std::size_t> firstObservations;
+
+    std::vector<IndexT> observationViewIds;
+    std::vector<IndexT> observationFeatureIds;
+    std::vector<double> observationX;
+    std::vector<double> observationY;
+    std::vector<double> observationScales;
+};
+
+/**
+ * @brief SAX handler of the JSON SfMData file for boost::json::basic_parser.
+ *
+ * The nesting depth identifies the parsed values:
+ * 1: document, 2: part (views, intrinsics, structure...), 3: element of a part,
+ * 4+: content of an element (for the landmarks: 4 color/X/observations, 5 observation, 6 observation x).
+ */
+class SfMDataJSONHandler
+{
+  public:
+    constexpr static std::size_t max_object_size = std::size_t(-1);
+    constexpr static std::size_t max_array_size = std::size_t(-1);
+    constexpr static std::size_t max_key_size = std::size_t(-1);
+    constexpr static std::size_t max_string_size = std::size_t(-1);
+
+    SfMDataJSONHandler(sfmData::SfMData& sfmData, ESfMData partFlag)
+      : _sfmData(sfmData),
+        _loadViews((partFlag & VIEWS) == VIEWS),
+        _loadAncestors((partFlag & ANCESTORS) == ANCESTORS),
+        _loadIntrinsics((partFlag & INTRINSICS) == INTRINSICS),
+        _loadExtrinsics((partFlag & EXTRINSICS) == EXTRINSICS),
+        _loadStructure((partFlag & STRUCTURE) == STRUCTURE),
+        _loadFeatures((partFlag & OBSERVATIONS_WITH_FEATURES) == OBSERVATIONS_WITH_FEATURES),
+        _loadObservations(_loadFeatures || ((partFlag & OBSERVATIONS) == OBSERVATIONS))
+    {}
+
+    bool on_document_begin(boost::json::error_code&) { return true; }
+    bool on_document_end(boost::json::error_code&) { return true; }
+
+    bool on_object_begin(boost::json::error_code&)
+    {
+        beginContainer(true);
+        return true;
+    }
+
+    bool on_object_end(std::size_t, boost::json::error_code&)
+    {
+        endContainer();
+        return true;
+    }
+
+    bool on_array_begin(boost::json::error_code&)
+    {
+        beginContainer(false);
+        return true;
+    }
+
+    bool on_array_end(std::size_t, boost::json::error_code&)
+    {
+        endContainer();
+        return true;
+    }
+
+    bool on_key_part(boost::json::string_view s, std::size_t, boost::json::error_code&)
+    {
+        _keyBuffer.append(s.data(), s.size());
+        return true;
+    }
+
+    bool on_key(boost::json::string_view s, std::size_t, boost::json::error_code&)
+    {
+        _keyBuffer.append(s.data(), s.size());
+        _key.swap(_keyBuffer);
+        _keyBuffer.clear();
+        if (_isObject.size() == 1)
+            _part = partFromKey(_key);
+        return true;
+    }
+
+    bool on_string_part(boost::json::string_view s, std::size_t, boost::json::error_code&)
+    {
+        _text.append(s.data(), s.size());
+        return true;
+    }
+
+    bool on_string(boost::json::string_view s, std::size_t, boost::json::error_code&)
+    {
+        _text.append(s.data(), s.size());
+        scalar();
+        return true;
+    }
+
+    bool on_number_part(boost::json::string_view s, boost::json::error_code&)
+    {
+        _text.append(s.data(), s.size());
+        return true;
+    }
+
+    bool on_int64(int64_t, boost::json::string_view s, boost::json::error_code&)
+    {
+        _text.append(s.data(), s.size());
+        scalar();
+        return true;
+    }
+
+    bool on_uint64(uint64_t, boost::json::string_view s, boost::json::error_code&)
+    {
+        _text.append(s.data(), s.size());
+        scalar();
+        return true;
+    }
+
+    bool on_double(double, boost::json::string_view s, boost::json::error_code&)
+    {
+        _text.append(s.data(), s.size());
+        scalar();
+        return true;
+    }
+
+    bool on_bool(bool b, boost::json::error_code&)
+    {
+        _text = b ? "true" : "false";
+        scalar();
+        return true;
+    }
+
+    bool on_null(boost::json::error_code&)
+    {
+        _text = "null";
+        scalar();
+        return true;
+    }
+
+    bool on_comment_part(boost::json::string_view, boost::json::error_code&) { return true; }
+    bool on_comment(boost::json::string_view, boost::json::error_code&) { return true; }
+
+    /**
+     * @brief Load the parts that depend on the whole document and insert the landmarks.
+     * @return false if the file version is not supported
+     */
+    bool finalize()
+    {
+        const Version currentVersion(ALICEVISION_SFMDATAIO_VERSION_MAJOR, ALICEVISION_SFMDATAIO_VERSION_MINOR, ALICEVISION_SFMDATAIO_VERSION_REVISION);
+        if (currentVersion < _version)
+        {
+            ALICEVISION_LOG_ERROR("File has a version more recent than this library");
+            return false;
+        }
+
+        // intrinsics are loaded once the file version is known
+        for (auto& intrinsicNode : _intrinsicTrees)
+        {
+            IndexT intrinsicId;
+            std::shared_ptr<camera::IntrinsicBase> intrinsic;
+
+            loadIntrinsic(_version, intrinsicId, intrinsic, intrinsicNode.second);
+
+            _sfmData.getIntrinsics().emplace(intrinsicId, intrinsic);
+        }
+        _intrinsicTrees.clear();
+
+        insertLandmarks();
+        return true;
+    }
+
+  private:
+    enum class EPart
+    {
+        NONE,
+        VERSION,
+        FEATURES_FOLDERS,
+        MATCHES_FOLDERS,
+        VIEWS,
+        ANCESTORS,
+        INTRINSICS,
+        POSES,
+        RIGS,
+        STRUCTURE
+    };
+
+    enum class ELandmarkField
+    {
+        NONE,
+        COLOR,
+        POSITION,
+        OBSERVATIONS
+    };
+
+    EPart partFromKey(const std::string& key) const
+    {
+        if (key == "version")
+            return EPart::VERSION;
+        if (key == "featuresFolders")
+            return EPart::FEATURES_FOLDERS;
+        if (key == "matchesFolders")
+            return EPart::MATCHES_FOLDERS;
+        if (key == "views")
+            return _loadViews ? EPart::VIEWS : EPart::NONE;
+        if (key == "ancestors")
+            return _loadAncestors ? EPart::ANCESTORS : EPart::NONE;
+        if (key == "intrinsics")
+            return _loadIntrinsics ? EPart::INTRINSICS : EPart::NONE;
+        if (key == "poses")
+            return _loadExtrinsics ? EPart::POSES : EPart::NONE;
+        if (key == "rigs")
+            return _loadExtrinsics ? EPart::RIGS : EPart::NONE;
+        if (key == "structure")
+            return _loadStructure ? EPart::STRUCTURE : EPart::NONE;
+        return EPart::NONE;
+    }
+
+    bool isTreePart() const
+    {
+        return _part == EPart::VIEWS || _part == EPart::ANCESTORS || _part == EPart::INTRINSICS || _part == EPart::POSES || _part == EPart::RIGS;
+    }
+
+    /// Key of the current value in its parent container (empty in arrays)
+    const std::string& currentKey() const
+    {
+        static const std::string emptyKey;
+        return (!_isObject.empty() && _isObject.back()) ? _key : emptyKey;
+    }
+
+    void beginContainer(bool isObject)
+    {
+        const std::string key = currentKey();
+        _isObject.push_back(isObject);
+        const std::size_t depth = _isObject.size();
+
+        if (depth == 2)
+            _valueIndex = 0;
+        else if (depth >= 3 && isTreePart())
+            _tree.begin(key);
+        else if (depth >= 3 && _part == EPart::STRUCTURE)
+            beginLandmarkContainer(depth, key);
+    }
+
+    void endContainer()
+    {
+        const std::size_t depth = _isObject.size();
+        _isObject.pop_back();
+
+        if (depth >= 3 && isTreePart())
+        {
+            std::pair<std::string, bpt::ptree> element;
+            if (_tree.end(element))
+                loadElement(element);
+        }
+        else if (depth == 2)
+        {
+            _part = EPart::NONE;
+        }
+    }
+
+    void scalar()
+    {
+        const std::size_t depth = _isObject.size();
+
+        if (depth == 2)
+        {
+            switch (_part)
+            {
+                case EPart::VERSION:
+                    if (_valueIndex < 3)
+                        _versionValues(_valueIndex++) = std::atoi(_text.c_str());
+                    _version = Version(_versionValues);
+                    break;
+                case EPart::FEATURES_FOLDERS:
+                    _sfmData.addFeaturesFolder(_text);
+                    break;
+                case EPart::MATCHES_FOLDERS:
+                    _sfmData.addMatchesFolder(_text);
+                    break;
+                default:
+                    break;
+            }
+        }
+        else if (depth >= 3 && isTreePart())
+        {
+            _tree.leaf(currentKey(), _text);
+        }
+        else if (depth >= 3 && _part == EPart::STRUCTURE)
+        {
+            landmarkScalar(depth, currentKey());
+        }
+
+        _text.clear();
+    }
+
+    void loadElement(std::pair<std::string, bpt::ptree>& element)
+    {
+        bpt::ptree& tree = element.second;
+        switch (_part)
+        {
+            case EPart::VIEWS:
+            {
+                auto view = std::make_shared<sfmData::View>();
+                loadView(*view, tree);
+                _sfmData.getViews().emplace(view->getViewId(), view);
+                break;
+            }
+            case EPart::ANCESTORS:
+            {
+                IndexT ancestorId;
+                std::shared_ptr<sfmData::ImageInfo> ancestor = std::make_shared<sfmData::ImageInfo>();
+                loadAncestor(ancestorId, ancestor, tree);
+                _sfmData.getAncestors().emplace(ancestorId, ancestor);
+                break;
+            }
+            case EPart::INTRINSICS:
+                _intrinsicTrees.push_back(std::move(element));
+                break;
+            case EPart::POSES:
+            {
+                sfmData::CameraPose pose;
+                loadCameraPose("pose", pose, tree);
+                _sfmData.getPoses().emplace(tree.get<IndexT>("poseId"), pose);
+                break;
+            }
+            case EPart::RIGS:
+            {
+                IndexT rigId;
+                sfmData::Rig rig;
+                loadRig(rigId, rig, tree);
+                _sfmData.getRigs().emplace(rigId, rig);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void beginLandmarkContainer(std::size_t depth, const std::string& key)
+    {
+        LandmarksBuffer& b = _landmarks;
+        if (depth == 3)
+        {
+            // new landmark
+            b.ids.push_back(UndefinedIndexT);
+            b.descTypes.push_back(feature::EImageDescriberType::UNINITIALIZED);
+            b.positions.push_back(Vec3::Zero());
+            b.colors.push_back(image::WHITE);
+            b.firstObservations.push_back(b.observationViewIds.size());
+            _landmarkField = ELandmarkField::NONE;
+        }
+        else if (depth == 4)
+        {
+            _valueIndex = 0;
+            if (key == "color")
+                _landmarkField = ELandmarkField::COLOR;
+            else if (key == "X")
+                _landmarkField = ELandmarkField::POSITION;
+            else if (key == "observations")
+                _landmarkField = ELandmarkField::OBSERVATIONS;
+            else
+                _landmarkField = ELandmarkField::NONE;
+        }
+        else if (depth == 5 && _landmarkField == ELandmarkField::OBSERVATIONS && _loadObservations)
+        {
+            // new observation
+            b.observationViewIds.push_back(UndefinedIndexT);
+            if (_loadFeatures)
+            {
+                b.observationFeatureIds.push_back(UndefinedIndexT);
+                b.observationX.push_back(0.0);
+                b.observationY.push_back(0.0);
+                b.observationScales.push_back(0.0);
+            }
+        }
+        else if (depth == 6)
+        {
+            _valueIndex = 0;
+        }
+    }
+
+    void landmarkScalar(std::size_t depth, const std::string& key)
+    {
+        LandmarksBuffer& b = _landmarks;
+        if (depth == 3)
+        {
+            if (key == "landmarkId")
+            {
+                b.ids.back() = toIndex(_text);
+            }
+            else if (key == "descType")
+            {
+                // consecutive landmarks usually share the same describer type
+                if (_text != _lastDescTypeName)
+                {
+                    _lastDescType = feature::EImageDescriberType_stringToEnum(_text);
+                    _lastDescTypeName = _text;
+                }
+                b.descTypes.back() = _lastDescType;
+            }
+        }
+        else if (depth == 4 && _valueIndex < 3)
+        {
+            if (_landmarkField == ELandmarkField::COLOR)
+                b.colors.back()(_valueIndex++) = static_cast<unsigned char>(toIndex(_text));
+            else if (_landmarkField == ELandmarkField::POSITION)
+                b.positions.back()(_valueIndex++) = toDouble(_text);
+        }
+        else if (depth == 5 && _landmarkField == ELandmarkField::OBSERVATIONS && _loadObservations)
+        {
+            if (key == "observationId")
+                b.observationViewIds.back() = toIndex(_text);
+            else if (_loadFeatures && key == "featureId")
+                b.observationFeatureIds.back() = toIndex(_text);
+            else if (_loadFeatures && key == "scale")
+                b.observationScales.back() = toDouble(_text);
+        }
+        else if (depth == 6 && _landmarkField == ELandmarkField::OBSERVATIONS && _loadFeatures && _key == "x")
+        {
+            if (_valueIndex == 0)
+                b.observationX.back() = toDouble(_text);
+            else if (_valueIndex == 1)
+                b.observationY.back() = toDouble(_text);
+            ++_valueIndex;
+        }
+    }
+
+    void insertLandmarks()
+    {
+        LandmarksBuffer& b = _landmarks;
+        const std::size_t nbLandmarks = b.ids.size();
+        if (nbLandmarks == 0)
+            return;
+
+        // the landmarks are written sorted by id: insertions are at the end of the map
+        sfmData::Landmarks& landmarks = _sfmData.getLandmarks();
+        std::vector<sfmData::Landmark*> landmarksPtr(nbLandmarks, nullptr);
+        for (std::size_t i = 0; i < nbLandmarks; ++i)
+        {
+            const std::size_t sizeBefore = landmarks.size();
+            auto it = landmarks.emplace_hint(landmarks.end(), b.ids[i], sfmData::Landmark(b.positions[i], b.descTypes[i], b.colors[i]));
+            if (landmarks.size() != sizeBefore)
+                landmarksPtr[i] = &it->second;
+        }
+
+        if (!_loadObservations)
+            return;
+
+        // the observations of the landmarks are independent
+        b.firstObservations.push_back(b.observationViewIds.size());
+
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(nbLandmarks); ++i)
+        {
+            if (landmarksPtr[i] == nullptr)
+                continue;
+
+            sfmData::Observations& observations = landmarksPtr[i]->getObservations();
+            observations.reserve(b.firstObservations[i + 1] - b.firstObservations[i]);
+
+            for (std::size_t k = b.firstObservations[i]; k < b.firstObservations[i + 1]; ++k)
+            {
+                sfmData::Observation observation;
+                if (_loadFeatures)
+                {
+                    observation.setCoordinates(b.observationX[k], b.observationY[k]);
+                    observation.setFeatureId(b.observationFeatureIds[k]);
+                    observation.setScale(b.observationScales[k]);
+                }
+                // the observations are written sorted by view id
+                observations.emplace_hint(observations.end(), b.observationViewIds[k], observation);
+            }
+        }
+
+        _landmarks = LandmarksBuffer();
+    }
+
+    static IndexT toIndex(const std::string& text) { return static_cast<IndexT>(std::strtoul(text.c_str(), nullptr, 10)); }
+
+    static double toDouble(const std::string& text) { return std::strtod(text.c_str(), nullptr); }
+
+    sfmData::SfMData& _sfmData;
+    const bool _loadViews;
+    const bool _loadAncestors;
+    const bool _loadIntrinsics;
+    const bool _loadExtrinsics;
+    const bool _loadStructure;
+    const bool _loadFeatures;
+    const bool _loadObservations;
+
+    /// parser state
+    std::vector<bool> _isObject;
+    std::string _keyBuffer;
+    std::string _key;
+    std::string _text;
+    EPart _part = EPart::NONE;
+    int _valueIndex = 0;
+
+    Vec3i _versionValues = Vec3i::Zero();
+    Version _version;
+
+    TreeBuilder _tree;
+    std::vector<std::pair<std::string, bpt::ptree>> _intrinsicTrees;
+
+    LandmarksBuffer _landmarks;
+    ELandmarkField _landmarkField = ELandmarkField::NONE;
+    std::string _lastDescTypeName;
+    feature::EImageDescriberType _lastDescType = feature::EImageDescriberType::UNINITIALIZED;
+};
+
+void saveLandmarks(JSONStreamWriter& writer, const sfmData::Landmarks& landmarks, bool saveObservations, bool saveFeatures)
+{
+    writer.beginArray("structure");
+    for (const auto& landmarkPair : landmarks)
+    {
+        const sfmData::Landmark& landmark = landmarkPair.second;
+
+        writer.beginObject();
+        writer.value("landmarkId", std::to_string(landmarkPair.first));
+        writer.value("descType", feature::EImageDescriberType_enumToString(landmark.descType));
+
+        writer.beginArray("color");
+        for (int i = 0; i < 3; ++i)
+            writer.value("", std::to_string(static_cast<int>(landmark.rgb(i))));
+        writer.end();
+
+        writer.beginArray("X");
+        for (int i = 0; i < 3; ++i)
+            writer.value("", toString(landmark.X(i)));
+        writer.end();
+
+        // observations
+        if (saveObservations)
+        {
+            if (landmark.getObservations().empty())
+            {
+                // empty node of the property tree
+                writer.value("observations", "");
+            }
+            else
+            {
+                writer.beginArray("observations");
+                for (const auto& obsPair : landmark.getObservations())
+                {
+                    const sfmData::Observation& observation = obsPair.second;
+
+                    writer.beginObject();
+                    writer.value("observationId", std::to_string(obsPair.first));
+
+                    // features
+                    if (saveFeatures)
+                    {
+                        writer.value("featureId", std::to_string(observation.getFeatureId()));
+                        writer.beginArray("x");
+                        writer.value("", toString(observation.getX()));
+                        writer.value("", toString(observation.getY()));
+                        writer.end();
+                        writer.value("scale", toString(observation.getScale()));
+                    }
+                    writer.end();
+                }
+                writer.end();
+            }
+        }
+        writer.end();
+    }
+    writer.end();
+}
+
+}  // namespace
+
+bool saveJSONStream(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
+{
+    // save flags
+    const bool saveViews = (partFlag & VIEWS) == VIEWS;
+    const bool saveAncestors = (partFlag & ANCESTORS) == ANCESTORS;
+    const bool saveIntrinsics = (partFlag & INTRINSICS) == INTRINSICS;
+    const bool saveExtrinsics = (partFlag & EXTRINSICS) == EXTRINSICS;
+    const bool saveStructure = (partFlag & STRUCTURE) == STRUCTURE;
+    const bool saveFeatures = (partFlag & OBSERVATIONS_WITH_FEATURES) == OBSERVATIONS_WITH_FEATURES;
+    const bool saveObservations = saveFeatures || ((partFlag & OBSERVATIONS) == OBSERVATIONS);
+
+    std::ofstream stream(filename);
+    if (!stream.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Cannot save the SfMData JSON file, cannot open '" << filename << "'.");
+        return false;
+    }
+
+    JSONStreamWriter writer(stream);
+    writer.beginObject();
+
+    // file version
+    writer.beginArray("version");
+    writer.value("", std::to_string(ALICEVISION_SFMDATAIO_VERSION_MAJOR));
+    writer.value("", std::to_string(ALICEVISION_SFMDATAIO_VERSION_MINOR));
+    writer.value("", std::to_string(ALICEVISION_SFMDATAIO_VERSION_REVISION));
+    writer.end();
+
+    // folders
+    if (!sfmData.getRelativeFeaturesFolders().empty())
+    {
+        writer.beginArray("featuresFolders");
+        for (const std::string& featuresFolder : sfmData.getRelativeFeaturesFolders())
+            writer.value("", featuresFolder);
+        writer.end();
+    }
+
+    if (!sfmData.getRelativeMatchesFolders().empty())
+    {
+        writer.beginArray("matchesFolders");
+        for (const std::string& matchesFolder : sfmData.getRelativeMatchesFolders())
+            writer.value("", matchesFolder);
+        writer.end();
+    }
+
+    // views
+    if (saveViews && !sfmData.getViews().empty())
+    {
+        writer.beginArray("views");
+        for (const auto& viewPair : sfmData.getViews())
+        {
+            bpt::ptree viewTree;
+            saveView("", *(viewPair.second), viewTree);
+            writer.writeTree("", viewTree.front().second);
+        }
+        writer.end();
+    }
+
+    // ancestors
+    if (saveAncestors && !sfmData.getAncestors().empty())
+    {
+        writer.beginObject("ancestors");
+        for (const auto& ancestorPair : sfmData.getAncestors())
+        {
+            bpt::ptree ancestorTree;
+            saveAncestor(std::to_string(ancestorPair.first), ancestorPair.first, ancestorPair.second, ancestorTree);
+            writer.writeTree(ancestorTree.front().first, ancestorTree.front().second);
+        }
+        writer.end();
+    }
+
+    // intrinsics
+    if (saveIntrinsics && !sfmData.getIntrinsics().empty())
+    {
+        writer.beginArray("intrinsics");
+        for (const auto& intrinsicPair : sfmData.getIntrinsics())
+        {
+            bpt::ptree intrinsicTree;
+            saveIntrinsic("", intrinsicPair.first, intrinsicPair.second, intrinsicTree);
+            writer.writeTree("", intrinsicTree.front().second);
+        }
+        writer.end();
+    }
+
+    // extrinsics
+    if (saveExtrinsics)
+    {
+        // poses
+        if (!sfmData.getPoses().empty())
+        {
+            writer.beginArray("poses");
+            for (const auto& posePair : sfmData.getPoses())
+            {
+                bpt::ptree poseTree;
+                poseTree.put("poseId", posePair.first);
+                saveCameraPose("pose", posePair.second, poseTree);
+                writer.writeTree("", poseTree);
+            }
+            writer.end();
+        }
+
+        // rigs
+        if (!sfmData.getRigs().empty())
+        {
+            writer.beginArray("rigs");
+            for (const auto& rigPair : sfmData.getRigs())
+            {
+                bpt::ptree rigTree;
+                saveRig("", rigPair.first, rigPair.second, rigTree);
+                writer.writeTree("", rigTree.front().second);
+            }
+            writer.end();
+        }
+    }
+
+    // structure
+    if (saveStructure && !sfmData.getLandmarks().empty())
+        saveLandmarks(writer, sfmData.getLandmarks(), saveObservations, saveFeatures);
+
+    writer.end();
+
+    if (!stream.good())
+    {
+        ALICEVISION_LOG_ERROR("Cannot save the SfMData JSON file '" << filename << "'.");
+        return false;
+    }
+
+    return true;
+}
+
+bool loadJSONStream(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag)
+{
+    std::ifstream stream(filename, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Cannot load the SfMData JSON file, cannot open '" << filename << "'.");
+        return false;
+    }
+
+    boost::json::basic_parser<SfMDataJSONHandler> parser(boost::json::parse_options(), sfmData, partFlag);
+    std::vector<char> buffer(JSON_READ_CHUNK);
+    boost::json::error_code ec;
+
+    bool more = true;
+    while (more)
+    {
+        stream.read(buffer.data(), buffer.size());
+        const std::size_t count = static_cast<std::size_t>(stream.gcount());
+        more = !stream.eof();
+
+        parser.write_some(more, buffer.data(), count, ec);
+        if (ec)
+        {
+            ALICEVISION_LOG_ERROR("Cannot load the SfMData JSON file '" << filename << "': " << ec.message());
+            return false;
+        }
+    }
+
+    return parser.handler().finalize();
+}
+
+}  // namespace sfmDataIO
+}  // namespace aliceVision
@@ -0,0 +1,43 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+
+#include <string>
+
+namespace aliceVision {
+namespace sfmDataIO {
+
+// Streaming reader and writer of the JSON SfMData file (.sfm, .json).
+// The file schema is the one of saveJSON / loadJSON (all values are written as strings).
+// --
+// The reader is an incremental (SAX) parser: the file is read by chunks and the landmarks
+// are parsed directly into flat arrays, then inserted into the SfMData in parallel.
+// Views, intrinsics, poses and rigs are small: each element is loaded with the
+// loaders of jsonIO from a property tree of the element only.
+
+/**
+ * @brief Save an SfMData in a JSON file, without building a tree of the whole document.
+ * @param[in] sfmData The input SfMData
+ * @param[in] filename The filename
+ * @param[in] partFlag The ESfMData save flag
+ * @return true if completed
+ */
+bool saveJSONStream(const sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
+
+/**
+ * @brief Load a JSON SfMData file with an incremental parser.
+ * @param[out] sfmData The output SfMData
+ * @param[in] filename The filename
+ * @param[in] partFlag The ESfMData load flag
+ * @return true if completed
+ */
+bool loadJSONStream(sfmData::SfMData& sfmData, const std::string& filename, ESfMData partFlag);
+
+}  // namespace sfmDataIO
+}  // namespace aliceVision
@@ -8,7 +8,9 @@
 #include "sfmDataIO.hpp"
 #include <aliceVision/config.hpp>
 #include <aliceVision/stl/mapUtils.hpp>
+#include <aliceVision/sfmDataIO/binaryIO.hpp>
 #include <aliceVision/sfmDataIO/jsonIO.hpp>
+#include <aliceVision/sfmDataIO/jsonStreamIO.hpp>
 #include <aliceVision/sfmDataIO/plyIO.hpp>
 #include <aliceVision/sfmDataIO/bafIO.hpp>
 #include <aliceVision/sfmDataIO/gtIO.hpp>
@@ -113,7 +115,11 @@ bool load(aliceVision::sfmData::SfMData& sfmData, const std::string& filename, E
 
     if (extension == ".sfm" || extension == ".json")  // JSON File
     {
-        status = loadJSON(sfmData, filename, partFlag);
+        status = loadJSONStream(sfmData, filename, partFlag);
+    }
+    else if (extension == ".sfmb")  // Binary File
+    {
+        status = loadBinary(sfmData, filename, partFlag);
     }
     else if (extension == ".abc")  // Alembic
     {
@@ -157,7 +163,11 @@ bool save(const aliceVision::sfmData::SfMData& sfmData, const std::string& filen
 
     if (extension == ".sfm" || extension == ".json")  // JSON File
     {
-        status = saveJSON(sfmData, tmpPath, partFlag);
+        status = saveJSONStream(sfmData, tmpPath, partFlag);
+    }
+    else if (extension == ".sfmb")  // Binary File
+    {
+        status = saveBinary(sfmData, tmpPath, partFlag);
     }
     else if (extension == ".ply")  // Polygon File
     {
@@ -8,9 +8,12 @@
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+#include <aliceVision/sfmDataIO/jsonIO.hpp>
+#include <aliceVision/sfmDataIO/jsonStreamIO.hpp>
 #include <aliceVision/config.hpp>
 
 #include <filesystem>
+#include <fstream>
 #include <sstream>
 
 #define BOOST_TEST_MODULE sfmDataIO
@@ -76,7 +79,7 @@ sfmData::SfMData createTestScene(std::size_t viewsCount = 2, std::size_t observa
 
 BOOST_AUTO_TEST_CASE(SfMData_IO_SAVE_LOAD)
 {
-    std::vector<std::string> ext_Type = {"sfm", "json"};
+    std::vector<std::string> ext_Type = {"sfm", "json", "sfmb"};
 
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
     ext_Type.push_back("abc");
@@ -178,11 +181,38 @@ BOOST_AUTO_TEST_CASE(SfMData_IO_SAVE_LOAD)
     }
 }
 
+BOOST_AUTO_TEST_CASE(SfMData_IO_JSON_STREAM)
+{
+    const sfmData::SfMData sfmData = createTestScene(3, 5, false);
+
+    const auto readFile = [](const std::string& filename) {
+        std::ifstream stream(filename);
+        std::stringstream buffer;
+        buffer << stream.rdbuf();
+        return buffer.str();
+    };
+
+    for (const ESfMData flags_part : {ESfMData::ALL, ESfMData(ALL & ~OBSERVATIONS_WITH_FEATURES), ESfMData(VIEWS | INTRINSICS)})
+    {
+        // the streaming writer and the property tree writer produce the same file
+        BOOST_CHECK(saveJSON(sfmData, "SAVE_LOAD_TREE.sfm", flags_part));
+        BOOST_CHECK(saveJSONStream(sfmData, "SAVE_LOAD_STREAM.sfm", flags_part));
+        BOOST_CHECK_EQUAL(readFile("SAVE_LOAD_TREE.sfm"), readFile("SAVE_LOAD_STREAM.sfm"));
+
+        // the streaming reader and the property tree reader load the same scene
+        sfmData::SfMData sfmDataTree;
+        sfmData::SfMData sfmDataStream;
+        BOOST_CHECK(loadJSON(sfmDataTree, "SAVE_LOAD_TREE.sfm", flags_part));
+        BOOST_CHECK(loadJSONStream(sfmDataStream, "SAVE_LOAD_TREE.sfm", flags_part));
+        BOOST_CHECK(sfmDataTree == sfmDataStream);
+    }
+}
+
 /*
 BOOST_AUTO_TEST_CASE(SfMData_IO_BigFile) {
   const int nbViews = 1000;
   const int nbObservationPerView = 100000;
-  std::vector<std::string> ext_Type = {"sfm","json"};
+  std::vector<std::string> ext_Type = {"sfm","json","sfmb"};
 
 #if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_ALEMBIC)
   ext_Type.push_back("abc");
@@ -0,0 +1,323 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "FlatTracksBuilder.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace aliceVision {
+namespace track {
+
+namespace {
+
+/// Matches of one pair for one describer type, with the keypoint blocks of both views
+struct PairTask
+{
+    const IndMatches* matches;
+    std::size_t blockI;
+    std::size_t blockJ;
+};
+
+}  // namespace
+
+uint32_t FlatTracksBuilder::nodeIndex(std::size_t block, IndexT featureIndex) const
+{
+    const auto begin = _nodeFeatures.begin() + _blockOffsets[block];
+    const auto end = _nodeFeatures.begin() + _blockOffsets[block + 1];
+    return static_cast<uint32_t>(std::lower_bound(begin, end, featureIndex) - _nodeFeatures.begin());
+}
+
+std::size_t FlatTracksBuilder::nodeBlock(uint32_t node) const
+{
+    return std::upper_bound(_blockOffsets.begin(), _blockOffsets.end(), node) - _blockOffsets.begin() - 1;
+}
+
+uint32_t FlatTracksBuilder::find(uint32_t node)
+{
+    while (true)
+    {
+        uint32_t parent = _parents[node].load();
+        if (parent == node)
+            return node;
+        const uint32_t grandParent = _parents[parent].load();
+        if (parent != grandParent)
+            _parents[node].compare_exchange_weak(parent, grandParent);
+        node = grandParent;
+    }
+}
+
+void FlatTracksBuilder::unite(uint32_t a, uint32_t b)
+{
+    while (true)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return;
+        // always link under the smallest index: the root of a set is its first keypoint
+        if (a < b)
+            std::swap(a, b);
+        uint32_t expected = a;
+        // fails if a is no longer a root, then retry from the new roots
+        if (_parents[a].compare_exchange_strong(expected, b))
+            return;
+    }
+}
+
+void FlatTracksBuilder::build(const PairwiseMatches& pairwiseMatches, bool multithreaded)
+{
+    // keypoint blocks: one per (viewId, descType)
+    _blocks.clear();
+    for (const auto& matchesPerDescIt : pairwiseMatches)
+    {
+        for (const auto& matchesIt : matchesPerDescIt.second)
+        {
+            if (matchesIt.second.empty())
+                continue;
+            _blocks.emplace_back(matchesPerDescIt.first.first, matchesIt.first);
+            _blocks.emplace_back(matchesPerDescIt.first.second, matchesIt.first);
+        }
+    }
+    std::sort(_blocks.begin(), _blocks.end());
+    _blocks.erase(std::unique(_blocks.begin(), _blocks.end()), _blocks.end());
+
+    const auto blockIndex = [&](IndexT viewId, feature::EImageDescriberType descType) -> std::size_t {
+        return std::lower_bound(_blocks.begin(), _blocks.end(), BlockKey(viewId, descType)) - _blocks.begin();
+    };
+
+    std::vector<PairTask> tasks;
+    std::vector<std::vector<std::pair<std::size_t, bool>>> tasksPerBlock(_blocks.size());
+    for (const auto& matchesPerDescIt : pairwiseMatches)
+    {
+        for (const auto& matchesIt : matchesPerDescIt.second)
+        {
+            if (matchesIt.second.empty())
+                continue;
+            const PairTask task{&matchesIt.second,
+                                blockIndex(matchesPerDescIt.first.first, matchesIt.first),
+                                blockIndex(matchesPerDescIt.first.second, matchesIt.first)};
+            tasksPerBlock[task.blockI].emplace_back(tasks.size(), true);
+            tasksPerBlock[task.blockJ].emplace_back(tasks.size(), false);
+            tasks.push_back(task);
+        }
+    }
+
+    // sorted unique matched features of each block
+    std::vector<std::vector<IndexT>> blockFeatures(_blocks.size());
+
+#pragma omp parallel for schedule(dynamic) if (multithreaded)
+    for (std::ptrdiff_t b = 0; b < static_cast<std::ptrdiff_t>(_blocks.size()); ++b)
+    {
+        std::vector<IndexT>& features = blockFeatures[b];
+        for (const auto& blockTask : tasksPerBlock[b])
+        {
+            for (const IndMatch& m : *tasks[blockTask.first].matches)
+                features.push_back(blockTask.second ? m._i : m._j);
+        }
+        std::sort(features.begin(), features.end());
+        features.erase(std::unique(features.begin(), features.end()), features.end());
+        features.shrink_to_fit();
+    }
+    tasksPerBlock.clear();
+    tasksPerBlock.shrink_to_fit();
+
+    // global keypoint indexing
+    _blockOffsets.assign(_blocks.size() + 1, 0);
+    std::size_t nbNodes = 0;
+    for (std::size_t b = 0; b < _blocks.size(); ++b)
+    {
+        nbNodes += blockFeatures[b].size();
+        if (nbNodes >= std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error("Can't build tracks, too many matched features (" + std::to_string(nbNodes) + ") !");
+        _blockOffsets[b + 1] = static_cast<uint32_t>(nbNodes);
+    }
+
+    _nodeFeatures.resize(nbNodes);
+#pragma omp parallel for if (multithreaded)
+    for (std::ptrdiff_t b = 0; b < static_cast<std::ptrdiff_t>(_blocks.size()); ++b)
+    {
+        std::copy(blockFeatures[b].begin(), blockFeatures[b].end(), _nodeFeatures.begin() + _blockOffsets[b]);
+        std::vector<IndexT>().swap(blockFeatures[b]);
+    }
+
+    // union of the matched keypoints, each pair independently
+    _parents = std::vector<std::atomic<uint32_t>>(nbNodes);
+#pragma omp parallel for if (multithreaded)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(nbNodes); ++i)
+        _parents[i].store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+
+#pragma omp parallel for schedule(dynamic) if (multithreaded)
+    for (std::ptrdiff_t t = 0; t < static_cast<std::ptrdiff_t>(tasks.size()); ++t)
+    {
+        const PairTask& task = tasks[t];
+        for (const IndMatch& m : *task.matches)
+            unite(nodeIndex(task.blockI, m._i), nodeIndex(task.blockJ, m._j));
+    }
+
+    std::vector<uint32_t> nodeTracks(nbNodes);
+#pragma omp parallel for if (multithreaded)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(nbNodes); ++i)
+        nodeTracks[i] = find(static_cast<uint32_t>(i));
+    std::vector<std::atomic<uint32_t>>().swap(_parents);
+
+    // number the tracks in the order of their roots,
+    // a root is always before the other keypoints of its set so it is renumbered first
+    uint32_t nbTracks = 0;
+    for (std::size_t i = 0; i < nbNodes; ++i)
+        nodeTracks[i] = (nodeTracks[i] == i) ? nbTracks++ : nodeTracks[nodeTracks[i]];
+
+    // tracks in CSR layout
+    _trackOffsets.assign(nbTracks + 1, 0);
+    for (std::size_t i = 0; i < nbNodes; ++i)
+        ++_trackOffsets[nodeTracks[i] + 1];
+    for (std::size_t t = 0; t < nbTracks; ++t)
+        _trackOffsets[t + 1] += _trackOffsets[t];
+
+    _trackNodes.resize(nbNodes);
+    {
+        std::vector<std::size_t> fill(_trackOffsets.begin(), _trackOffsets.end() - 1);
+        for (std::size_t i = 0; i < nbNodes; ++i)
+            _trackNodes[fill[nodeTracks[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    // all descType inside the track are the same
+    _trackDescTypes.resize(nbTracks);
+#pragma omp parallel for if (multithreaded)
+    for (std::ptrdiff_t t = 0; t < static_cast<std::ptrdiff_t>(nbTracks); ++t)
+        _trackDescTypes[t] = _blocks[nodeBlock(_trackNodes[_trackOffsets[t]])].second;
+}
+
+void FlatTracksBuilder::filter(bool clearForks, std::size_t minTrackLength, bool multithreaded)
+{
+    // remove bad tracks:
+    // - track that are too short,
+    // - track with id conflicts (many times the same image index)
+    if (!clearForks && minTrackLength == 0)
+        return;
+
+    const std::size_t nbTracks = _trackDescTypes.size();
+    std::vector<unsigned char> keep(nbTracks);
+
+#pragma omp parallel for if (multithreaded)
+    for (std::ptrdiff_t t = 0; t < static_cast<std::ptrdiff_t>(nbTracks); ++t)
+    {
+        // keypoints are sorted by view, so the observations of a view are contiguous
+        std::size_t nbViews = 0;
+        IndexT previousView = UndefinedIndexT;
+        for (std::size_t k = _trackOffsets[t]; k < _trackOffsets[t + 1]; ++k)
+        {
+            const IndexT viewId = _blocks[nodeBlock(_trackNodes[k])].first;
+            if (k == _trackOffsets[t] || viewId != previousView)
+                ++nbViews;
+            previousView = viewId;
+        }
+        const std::size_t cpt = _trackOffsets[t + 1] - _trackOffsets[t];
+        keep[t] = !((clearForks && nbViews != cpt) || nbViews < minTrackLength);
+    }
+
+    // compact in place, the kept tracks keep their relative order
+    std::size_t nbKept = 0;
+    std::size_t nbKeptNodes = 0;
+    for (std::size_t t = 0; t < nbTracks; ++t)
+    {
+        const std::size_t begin = _trackOffsets[t];
+        const std::size_t end = _trackOffsets[t + 1];
+        if (!keep[t])
+            continue;
+        std::copy(_trackNodes.begin() + begin, _trackNodes.begin() + end, _trackNodes.begin() + nbKeptNodes);
+        _trackOffsets[nbKept] = nbKeptNodes;
+        _trackDescTypes[nbKept] = _trackDescTypes[t];
+        nbKeptNodes += end - begin;
+        ++nbKept;
+    }
+    _trackOffsets[nbKept] = nbKeptNodes;
+    _trackOffsets.resize(nbKept + 1);
+    _trackNodes.resize(nbKeptNodes);
+    _trackDescTypes.resize(nbKept);
+}
+
+bool FlatTracksBuilder::exportToStream(std::ostream& os) const
+{
+    for (std::size_t t = 0; t < _trackDescTypes.size(); ++t)
+    {
+        os << "Class: " << t << std::endl;
+        os << "\t"
+           << "track length: " << _trackOffsets[t + 1] - _trackOffsets[t] << std::endl;
+
+        for (std::size_t k = _trackOffsets[t]; k < _trackOffsets[t + 1]; ++k)
+        {
+            const uint32_t node = _trackNodes[k];
+            const BlockKey& block = _blocks[nodeBlock(node)];
+            os << block.first << "  " << KeypointId(block.second, _nodeFeatures[node]) << std::endl;
+        }
+    }
+    return os.good();
+}
+
+void FlatTracksBuilder::exportToSTL(TracksMap& allTracks, const feature::FeaturesPerView* featuresPerView) const
+{
+    allTracks.clear();
+    allTracks.reserve(_trackDescTypes.size());
+
+    for (std::size_t t = 0; t < _trackDescTypes.size(); ++t)
+    {
+        // track ids are increasing, insertions are at the end
+        Track& outTrack = allTracks.emplace_hint(allTracks.end(), t, Track())->second;
+        outTrack.descType = _trackDescTypes[t];
+        outTrack.featPerView.reserve(_trackOffsets[t + 1] - _trackOffsets[t]);
+
+        for (std::size_t k = _trackOffsets[t]; k < _trackOffsets[t + 1]; ++k)
+        {
+            const uint32_t node = _trackNodes[k];
+            const IndexT viewId = _blocks[nodeBlock(node)].first;
+            outTrack.featPerView.emplace_hint(outTrack.featPerView.end(), viewId, TrackItem())->second.featureId = _nodeFeatures[node];
+        }
+    }
+
+    // Fill additional data
+    if (featuresPerView != nullptr)
+    {
+#pragma omp parallel for
+        for (std::ptrdiff_t t = 0; t < static_cast<std::ptrdiff_t>(allTracks.size()); ++t)
+        {
+            Track& track = allTracks.nth(t)->second;
+
+            for (auto& pitem : track.featPerView)
+            {
+                const IndexT viewId = pitem.first;
+                TrackItem& item = pitem.second;
+                const auto& feats = featuresPerView->getFeaturesPerDesc(viewId);
+
+                const feature::PointFeatures& features = feats.at(track.descType);
+                const feature::PointFeature& feature = features.at(item.featureId);
+
+                item.coords = feature.coords().cast<double>();
+                item.scale = feature.scale();
+            }
+        }
+    }
+}
+
+void FlatTracksBuilder::exportToCSR(TracksCSR& tracks) const
+{
+    tracks.trackOffsets = _trackOffsets;
+    tracks.descTypes = _trackDescTypes;
+    tracks.viewIds.resize(_trackNodes.size());
+    tracks.featureIds.resize(_trackNodes.size());
+
+#pragma omp parallel for
+    for (std::ptrdiff_t k = 0; k < static_cast<std::ptrdiff_t>(_trackNodes.size()); ++k)
+    {
+        const uint32_t node = _trackNodes[k];
+        tracks.viewIds[k] = _blocks[nodeBlock(node)].first;
+        tracks.featureIds[k] = _nodeFeatures[node];
+    }
+}
+
+}  // namespace track
+}  // namespace aliceVision
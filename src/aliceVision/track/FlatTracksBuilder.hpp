@@ -0,0 +1,117 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/track/Track.hpp>
+#include <aliceVision/feature/FeaturesPerView.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace aliceVision {
+namespace track {
+
+/**
+ * @brief Build tracks from a set of matches across views, with a flat union-find.
+ *
+ * Same algorithm and same interface as TracksBuilder, with a different storage:
+ * every matched keypoint gets a global index (keypoints are sorted by view, describer type
+ * and feature index) and the union-find is a contiguous array of parents, merged
+ * concurrently with compare-and-swap. Tracks are then stored in CSR layout.
+ *
+ * The root of each set is its smallest keypoint index, so the tracks are numbered
+ * deterministically, in the order of their first observation.
+ *
+ * Usage:
+ * @code{.cpp}
+ *  FlatTracksBuilder tracksBuilder;
+ *  tracksBuilder.build(pairwiseMatches);
+ *  tracksBuilder.filter(true, 2);
+ *  track::TracksCSR tracks;
+ *  tracksBuilder.exportToCSR(tracks);
+ * @endcode
+ */
+class FlatTracksBuilder
+{
+  public:
+    /**
+     * @brief Build tracks for a given series of pairWise matches
+     * @param[in] pairwiseMatches PairWise matches
+     * @param[in] multithreaded Merge the matches of the pairs in parallel
+     */
+    void build(const PairwiseMatches& pairwiseMatches, bool multithreaded = true);
+
+    /**
+     * @brief Remove bad tracks (too short or track with ids collision)
+     * @param[in] clearForks: remove tracks with multiple observation in a single image
+     * @param[in] minTrackLength: minimal number of observations to keep the track
+     * @param[in] multithreaded Is multithreaded
+     */
+    void filter(bool clearForks = true, std::size_t minTrackLength = 2, bool multithreaded = true);
+
+    /**
+     * @brief Export data of tracks to stream
+     * @param[out] os char output stream
+     * @return true if no error flag are set
+     */
+    bool exportToStream(std::ostream& os) const;
+
+    /**
+     * @brief Export tracks as a map (each entry is a sequence of imageId and keypointId):
+     *        {TrackIndex => {(imageIndex, keypointId), ... ,(imageIndex, keypointId)}
+     * @param allTracks output to tracks
+     * @param featuresPerView is the feature per view map for accessing features information.
+     * If nullptr, then no coordinates or scale will be saved (For legacy purpose)
+     */
+    void exportToSTL(TracksMap& allTracks, const feature::FeaturesPerView* featuresPerView = nullptr) const;
+
+    /**
+     * @brief Export tracks in CSR layout (track => observations)
+     * @param[out] tracks output tracks
+     */
+    void exportToCSR(TracksCSR& tracks) const;
+
+    /**
+     * @brief Return the number of tracks
+     */
+    std::size_t nbTracks() const { return _trackDescTypes.size(); }
+
+  private:
+    /// Key of a group of keypoints: (viewId, descType)
+    using BlockKey = std::pair<IndexT, feature::EImageDescriberType>;
+
+    /// Return the global index of a keypoint of a block
+    uint32_t nodeIndex(std::size_t block, IndexT featureIndex) const;
+
+    /// Return the block of a global keypoint index
+    std::size_t nodeBlock(uint32_t node) const;
+
+    /// Return the root of a keypoint set, halving the path on the way
+    uint32_t find(uint32_t node);
+
+    /// Merge the sets of two keypoints
+    void unite(uint32_t a, uint32_t b);
+
+    /// Sorted (viewId, descType) of the matched keypoints
+    std::vector<BlockKey> _blocks;
+    /// Start of each block in the global keypoint indexing (size: nb blocks + 1)
+    std::vector<uint32_t> _blockOffsets;
+    /// Feature index of each keypoint, sorted within each block
+    std::vector<IndexT> _nodeFeatures;
+    /// Union-find parent of each keypoint, only alive during build
+    std::vector<std::atomic<uint32_t>> _parents;
+
+    /// Keypoints of each track (CSR)
+    std::vector<std::size_t> _trackOffsets = std::vector<std::size_t>(1, 0);
+    std::vector<uint32_t> _trackNodes;
+    std::vector<feature::EImageDescriberType> _trackDescTypes;
+};
+
+}  // namespace track
+}  // namespace aliceVision
@@ -84,6 +84,27 @@ struct Track
 using TracksMap = stl::flat_map<std::size_t, Track>;
 using TrackIdSet = std::vector<std::size_t>;
 
+/**
+ * @brief Compact storage of a set of tracks (compressed sparse rows).
+ * The observations of the track t are stored in [trackOffsets[t], trackOffsets[t+1]),
+ * sorted by view id.
+ */
+struct TracksCSR
+{
+    /// Start of the observations of each track, plus the total number of observations (size: nbTracks + 1)
+    std::vector<std::size_t> trackOffsets;
+    /// Descriptor type of each track
+    std::vector<feature::EImageDescriberType> descTypes;
+    /// View id of each observation
+    std::vector<IndexT> viewIds;
+    /// Feature index of each observation
+    std::vector<IndexT> featureIds;
+
+    std::size_t nbTracks() const { return descTypes.size(); }
+    std::size_t nbObservations() const { return viewIds.size(); }
+    std::size_t trackLength(std::size_t trackId) const { return trackOffsets[trackId + 1] - trackOffsets[trackId]; }
+};
+
 /**
  * @brief Data structure that contains for each features of each view, its corresponding cell positions for each level of the pyramid, i.e.
  * for each view:
@@ -5,10 +5,14 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file,
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
+#include "aliceVision/track/FlatTracksBuilder.hpp"
 #include "aliceVision/track/TracksBuilder.hpp"
 #include "aliceVision/track/tracksUtils.hpp"
 #include "aliceVision/matching/IndMatch.hpp"
 
+#include <random>
+#include <set>
+#include <tuple>
 #include <vector>
 #include <utility>
 
@@ -17,6 +21,7 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/tools/floating_point_comparison.hpp>
 
+using namespace aliceVision;
 using namespace aliceVision::feature;
 using namespace aliceVision::track;
 using namespace aliceVision::matching;
@@ -173,6 +178,108 @@ BOOST_AUTO_TEST_CASE(Track_Conflict)
     }
 }
 
+BOOST_AUTO_TEST_CASE(Track_Flat_Conflict)
+{
+    // Same configuration as Track_Conflict
+    PairwiseMatches map_pairwisematches;
+    map_pairwisematches[std::make_pair(0, 1)][EImageDescriberType::UNKNOWN] = {IndMatch(0, 0), IndMatch(1, 1), IndMatch(2, 3)};
+    map_pairwisematches[std::make_pair(1, 2)][EImageDescriberType::UNKNOWN] = {IndMatch(0, 0), IndMatch(1, 6), IndMatch(3, 2), IndMatch(3, 8)};
+
+    FlatTracksBuilder trackBuilder;
+    trackBuilder.build(map_pairwisematches);
+
+    BOOST_CHECK_EQUAL(3, trackBuilder.nbTracks());
+    trackBuilder.filter(true, 2);
+    BOOST_CHECK_EQUAL(2, trackBuilder.nbTracks());
+
+    // 0, {(0,0) (1,0) (2,0)}
+    // 1, {(0,1) (1,1) (2,6)}
+    const std::pair<std::size_t, std::size_t> GT_Tracks[] = {
+      std::make_pair(0, 0), std::make_pair(1, 0), std::make_pair(2, 0), std::make_pair(0, 1), std::make_pair(1, 1), std::make_pair(2, 6)};
+
+    TracksMap map_tracks;
+    trackBuilder.exportToSTL(map_tracks);
+
+    BOOST_CHECK_EQUAL(2, map_tracks.size());
+    std::size_t cpt = 0, i = 0;
+    for (TracksMap::const_iterator iterT = map_tracks.begin(); iterT != map_tracks.end(); ++iterT, ++i)
+    {
+        BOOST_CHECK_EQUAL(i, iterT->first);
+        for (auto iter = iterT->second.featPerView.begin(); iter != iterT->second.featPerView.end(); ++iter)
+        {
+            BOOST_CHECK(GT_Tracks[cpt].first == iter->first);
+            BOOST_CHECK(GT_Tracks[cpt].second == iter->second.featureId);
+            ++cpt;
+        }
+    }
+
+    TracksCSR csr_tracks;
+    trackBuilder.exportToCSR(csr_tracks);
+
+    BOOST_CHECK_EQUAL(2, csr_tracks.nbTracks());
+    BOOST_CHECK_EQUAL(6, csr_tracks.nbObservations());
+    for (std::size_t k = 0; k < csr_tracks.nbObservations(); ++k)
+    {
+        BOOST_CHECK_EQUAL(GT_Tracks[k].first, csr_tracks.viewIds[k]);
+        BOOST_CHECK_EQUAL(GT_Tracks[k].second, csr_tracks.featureIds[k]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Track_Flat_SameAsTracksBuilder)
+{
+    // random matches between 20 views, with forks and two describer types
+    std::mt19937 randomNumberGenerator(0);
+    std::uniform_int_distribution<IndexT> featureDistribution(0, 200);
+
+    PairwiseMatches map_pairwisematches;
+    for (IndexT I = 0; I < 20; ++I)
+    {
+        for (IndexT J = I + 1; J < 20; J += 3)
+        {
+            for (const EImageDescriberType descType : {EImageDescriberType::UNKNOWN, EImageDescriberType::SIFT})
+            {
+                IndMatches& matches = map_pairwisematches[std::make_pair(I, J)][descType];
+                for (int m = 0; m < 50; ++m)
+                    matches.emplace_back(featureDistribution(randomNumberGenerator), featureDistribution(randomNumberGenerator));
+            }
+        }
+    }
+
+    // compare the tracks as sets of observations, the track ids may differ
+    using TrackObservations = std::set<std::tuple<EImageDescriberType, std::size_t, std::size_t>>;
+    const auto toSet = [](const TracksMap& tracks) {
+        std::set<TrackObservations> result;
+        for (const auto& trackIt : tracks)
+        {
+            TrackObservations observations;
+            for (const auto& itemIt : trackIt.second.featPerView)
+                observations.emplace(trackIt.second.descType, itemIt.first, itemIt.second.featureId);
+            result.insert(observations);
+        }
+        return result;
+    };
+
+    for (const std::size_t minTrackLength : {2, 4})
+    {
+        TracksBuilder trackBuilder;
+        trackBuilder.build(map_pairwisematches);
+        trackBuilder.filter(true, minTrackLength);
+
+        FlatTracksBuilder flatTrackBuilder;
+        flatTrackBuilder.build(map_pairwisematches);
+        flatTrackBuilder.filter(true, minTrackLength);
+
+        BOOST_CHECK_EQUAL(trackBuilder.nbTracks(), flatTrackBuilder.nbTracks());
+
+        TracksMap map_tracks;
+        trackBuilder.exportToSTL(map_tracks);
+        TracksMap flat_tracks;
+        flatTrackBuilder.exportToSTL(flat_tracks);
+
+        BOOST_CHECK(toSet(map_tracks) == toSet(flat_tracks));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(Track_GetCommonTracksInImages)
 {
     {
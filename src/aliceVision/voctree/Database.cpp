@@ -8,6 +8,7 @@
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/tail.hpp>
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <stdexcept>
@@ -16,6 +17,82 @@
 namespace aliceVision {
 namespace voctree {
 
+namespace {
+
+/**
+ * @brief Bounded max-heap keeping the N best (smallest score) matches seen so far.
+ * Ties are broken on the document id to get a deterministic ranking.
+ */
+class TopMatches
+{
+  public:
+    explicit TopMatches(std::size_t n)
+      : _n(n)
+    {
+        _heap.reserve(n);
+    }
+
+    bool full() const { return _heap.size() == _n; }
+
+    void push(DocId id, float score)
+    {
+        if (_n == 0)
+            return;
+        const DocMatch match(id, score);
+        if (!full())
+        {
+            _heap.push_back(match);
+            std::push_heap(_heap.begin(), _heap.end(), worse);
+        }
+        else if (worse(match, _heap.front()))
+        {
+            std::pop_heap(_heap.begin(), _heap.end(), worse);
+            _heap.back() = match;
+            std::push_heap(_heap.begin(), _heap.end(), worse);
+        }
+    }
+
+    /// Move the matches out of the heap, sorted from best to worst
+    void extract(std::vector<DocMatch>& matches)
+    {
+        std::sort_heap(_heap.begin(), _heap.end(), worse);
+        matches.swap(_heap);
+        _heap.clear();
+    }
+
+  private:
+    static bool worse(const DocMatch& a, const DocMatch& b) { return a.score < b.score || (a.score == b.score && a.id < b.id); }
+
+    std::size_t _n;
+    std::vector<DocMatch> _heap;
+};
+
+/// Distance methods that can be evaluated from the inverted files
+enum class EInvertedFileDistance
+{
+    CLASSIC,
+    COMMON_POINTS,
+    STRONG_COMMON_POINTS,
+    INVERSED_WEIGHTED_COMMON_POINTS
+};
+
+bool invertedFileDistanceFromString(const std::string& distanceMethod, EInvertedFileDistance& out)
+{
+    if (distanceMethod == "classic")
+        out = EInvertedFileDistance::CLASSIC;
+    else if (distanceMethod == "commonPoints")
+        out = EInvertedFileDistance::COMMON_POINTS;
+    else if (distanceMethod == "strongCommonPoints")
+        out = EInvertedFileDistance::STRONG_COMMON_POINTS;
+    else if (distanceMethod == "inversedWeightedCommonPoints")
+        out = EInvertedFileDistance::INVERSED_WEIGHTED_COMMON_POINTS;
+    else
+        return false;
+    return true;
+}
+
+}  // namespace
+
 std::ostream& operator<<(std::ostream& os, const SparseHistogram& dv)
 {
     for (const auto& e : dv)
@@ -47,17 +124,26 @@ DocId Database::insert(DocId doc_id, const SparseHistogram& document)
     // Ensure that the new document to insert is not already there.
     assert(database_.find(doc_id) == database_.end());
 
-    // For each word, retrieve its inverted file and increment the count for doc_id.
+    const uint32_t docIndex = static_cast<uint32_t>(doc_ids_.size());
+    uint32_t nbFeatures = 0;
+
+    // For each word, append the document to its inverted file.
+    // Words are unique in the histogram, so each inverted file gets at most one entry per document.
     for (SparseHistogram::const_iterator it = document.begin(), end = document.end(); it != end; ++it)
     {
-        Word word = it->first;
-        InvertedFile& file = word_files_[word];
-        if (file.empty() || file.back().id != doc_id)
-            file.push_back(WordFrequency(doc_id, it->second.size()));
-        else
-            file.back().count += it->second.size();
+        const Word word = it->first;
+        if (static_cast<std::size_t>(word) >= word_files_.size())
+        {
+            word_files_.resize(word + 1);
+            word_weights_.resize(word + 1, 1.0f);
+        }
+        const uint32_t count = static_cast<uint32_t>(it->second.size());
+        word_files_[word].emplace_back(docIndex, count);
+        nbFeatures += count;
     }
 
+    doc_ids_.push_back(doc_id);
+    doc_feature_counts_.push_back(nbFeatures);
     database_[doc_id] = document;
 
     return doc_id;
@@ -122,18 +208,100 @@ void Database::find(const std::vector<Word>& document, std::size_t N, std::vecto
  */
 void Database::find(const SparseHistogram& query, std::size_t N, std::vector<DocMatch>& matches, const std::string& distanceMethod) const
 {
-    matches.clear();
-    matches.reserve(database_.size());
+    EInvertedFileDistance method;
+    if (!invertedFileDistanceFromString(distanceMethod, method))
+    {
+        findExhaustive(query, N, matches, distanceMethod);
+        return;
+    }
+
+    const std::size_t nbDocs = doc_ids_.size();
+    TopMatches topMatches(std::min(N, nbDocs));
+
+    // accumulate the contribution of the shared words for the documents of the inverted files
+    std::vector<float> accumulators(nbDocs, 0.0f);
+    std::vector<char> isTouched(nbDocs, 0);
+    std::vector<uint32_t> touchedDocs;
+    uint32_t queryNbFeatures = 0;
+
+    for (const auto& queryWord : query)
+    {
+        const uint32_t queryCount = static_cast<uint32_t>(queryWord.second.size());
+        queryNbFeatures += queryCount;
+
+        if (static_cast<std::size_t>(queryWord.first) >= word_files_.size())
+            continue;
+
+        for (const WordFrequency& posting : word_files_[queryWord.first])
+        {
+            if (!isTouched[posting.docIndex])
+            {
+                isTouched[posting.docIndex] = 1;
+                touchedDocs.push_back(posting.docIndex);
+            }
+
+            float& acc = accumulators[posting.docIndex];
+            switch (method)
+            {
+                case EInvertedFileDistance::CLASSIC:
+                case EInvertedFileDistance::COMMON_POINTS:
+                    acc += std::min(queryCount, posting.count);
+                    break;
+                case EInvertedFileDistance::STRONG_COMMON_POINTS:
+                    if (queryCount == 1 && posting.count == 1)
+                        acc += 1.0f;
+                    break;
+                case EInvertedFileDistance::INVERSED_WEIGHTED_COMMON_POINTS:
+                    acc += (1.f / std::min(queryCount, posting.count)) * word_weights_[queryWord.first];
+                    break;
+            }
+        }
+    }
+
+    // classic is the L1 distance between the histograms: |q| + |d| - 2 * sum(min(q_w, d_w))
+    const auto classicDistance = [&](uint32_t docIndex) {
+        return static_cast<float>(queryNbFeatures) + static_cast<float>(doc_feature_counts_[docIndex]) - 2.0f * accumulators[docIndex];
+    };
+
+    for (const uint32_t docIndex : touchedDocs)
+    {
+        const float distance = (method == EInvertedFileDistance::CLASSIC) ? classicDistance(docIndex) : -accumulators[docIndex];
+        topMatches.push(doc_ids_[docIndex], distance);
+    }
+
+    // documents without any shared word still have a distance:
+    // |q| + |d| with the classic method, 0 with the common points methods
+    if (method == EInvertedFileDistance::CLASSIC)
+    {
+        for (uint32_t docIndex = 0; docIndex < nbDocs; ++docIndex)
+        {
+            if (!isTouched[docIndex])
+                topMatches.push(doc_ids_[docIndex], classicDistance(docIndex));
+        }
+    }
+    else
+    {
+        for (uint32_t docIndex = 0; docIndex < nbDocs && !topMatches.full(); ++docIndex)
+        {
+            if (!isTouched[docIndex])
+                topMatches.push(doc_ids_[docIndex], 0.0f);
+        }
+    }
+
+    topMatches.extract(matches);
+}
+
+void Database::findExhaustive(const SparseHistogram& query, std::size_t N, std::vector<DocMatch>& matches, const std::string& distanceMethod) const
+{
+    TopMatches topMatches(std::min(N, database_.size()));
     for (const auto& document : database_)
     {
         // for each document/image in the database compute the distance between the
         // histograms of the query image and the others
         const float distance = sparseDistance(query, document.second, distanceMethod, word_weights_);
-        matches.emplace_back(document.first, distance);
+        topMatches.push(document.first, distance);
     }
-    const std::size_t nMatches = std::min(N, matches.size());
-    std::partial_sort(matches.begin(), matches.begin() + nMatches, matches.end());
-    matches.resize(nMatches);
+    topMatches.extract(matches);
 }
 
 /**
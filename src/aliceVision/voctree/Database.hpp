@@ -92,6 +92,11 @@ class Database
     /**
      * @brief Find the top N matches in the database for the query document.
      *
+     * The distance methods that decompose over the shared words ("classic", "commonPoints",
+     * "strongCommonPoints" and "inversedWeightedCommonPoints") are evaluated through the inverted files,
+     * so only the documents sharing at least one word with the query are scored explicitly.
+     * The other methods fall back to an exhaustive scan of the database.
+     *
      * @param[in] query The query document, a normalized set of quantized words.
      * @param[int] N        The number of matches to return.
      * @param[in] distanceMethod distance method (norm L1, etc.)
@@ -130,17 +135,19 @@ class Database
   private:
     struct WordFrequency
     {
-        DocId id;
+        /// dense index of the document in doc_ids_
+        uint32_t docIndex;
+        /// number of features of the document quantized into the word
         uint32_t count;
 
         WordFrequency() = default;
-        WordFrequency(DocId _id, uint32_t _count)
-          : id(_id),
+        WordFrequency(uint32_t _docIndex, uint32_t _count)
+          : docIndex(_docIndex),
             count(_count)
         {}
     };
 
-    // Stored in increasing order by DocId
+    // Stored in increasing order by docIndex (i.e. insertion order)
     typedef std::vector<WordFrequency> InvertedFile;
 
     /// @todo Use sorted vector?
@@ -151,6 +158,14 @@ class Database
     std::vector<InvertedFile> word_files_;
     std::vector<float> word_weights_;
     SparseHistogramPerImage database_;  // Precomputed for inserted documents
+    std::vector<DocId> doc_ids_;                // DocId of each dense document index
+    std::vector<uint32_t> doc_feature_counts_;  // total number of features of each dense document index
+
+    /**
+     * @brief Find the top N matches by computing the distance to every document of the database.
+     * Used for the distance methods that cannot be evaluated from the inverted files.
+     */
+    void findExhaustive(const SparseHistogram& query, std::size_t N, std::vector<DocMatch>& matches, const std::string& distanceMethod) const;
 
     /**
      * Normalize a document vector representing the histogram of visual words for a given image
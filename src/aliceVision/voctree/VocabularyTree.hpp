@@ -69,11 +69,12 @@ class IVocabularyTree
     virtual void load(const std::string& file) = 0;
 
     /**
-     * @brief Create a SparseHistogram from a blind vector of descriptors.
-     * @param blindDescriptors
+     * @brief Create a SparseHistogram from a blind array of descriptors.
+     * @param blindDescriptors pointer to the first descriptor of a flat array of descriptors
+     * @param nbDescriptors number of descriptors
      * @return
      */
-    virtual SparseHistogram quantizeToSparse(const void* blindDescriptors) const = 0;
+    virtual SparseHistogram quantizeToSparse(const void* blindDescriptors, std::size_t nbDescriptors) const = 0;
 
     /// Get the depth (number of levels) of the tree.
     virtual uint32_t levels() const = 0;
@@ -116,16 +117,29 @@ class VocabularyTree : public IVocabularyTree
 
     /// Quantizes a set of features into visual words.
     template<class DescriptorT>
-    std::vector<Word> quantize(const std::vector<DescriptorT>& features) const;
+    std::vector<Word> quantize(const std::vector<DescriptorT>& features) const
+    {
+        return quantize(features.data(), features.size());
+    }
+
+    /// Quantizes a flat array of features into visual words.
+    template<class DescriptorT>
+    std::vector<Word> quantize(const DescriptorT* features, std::size_t nbFeatures) const;
 
     /// Quantizes a set of features into sparse histogram of visual words.
     template<class DescriptorT>
-    SparseHistogram quantizeToSparse(const std::vector<DescriptorT>& features) const;
+    SparseHistogram quantizeToSparse(const std::vector<DescriptorT>& features) const
+    {
+        return quantizeToSparse(features.data(), features.size());
+    }
+
+    /// Quantizes a flat array of features into sparse histogram of visual words.
+    template<class DescriptorT>
+    SparseHistogram quantizeToSparse(const DescriptorT* features, std::size_t nbFeatures) const;
 
-    SparseHistogram quantizeToSparse(const void* blindDescriptors) const override
+    SparseHistogram quantizeToSparse(const void* blindDescriptors, std::size_t nbDescriptors) const override
     {
-        const std::vector<Feature>* descriptors = static_cast<const std::vector<Feature>*>(blindDescriptors);
-        return quantizeToSparse(*descriptors);
+        return quantizeToSparse(static_cast<const Feature*>(blindDescriptors), nbDescriptors);
     }
 
     /// Get the depth (number of levels) of the tree.
@@ -217,14 +231,14 @@ Word VocabularyTree<Feature, Distance>::quantize(const DescriptorT& feature) con
 
 template<class Feature, template<typename, typename> class Distance>
 template<class DescriptorT>
-std::vector<Word> VocabularyTree<Feature, Distance>::quantize(const std::vector<DescriptorT>& features) const
+std::vector<Word> VocabularyTree<Feature, Distance>::quantize(const DescriptorT* features, std::size_t nbFeatures) const
 {
-    // ALICEVISION_LOG_DEBUG("VocabularyTree quantize: " << features.size());
-    std::vector<Word> imgVisualWords(features.size(), 0);
+    // ALICEVISION_LOG_DEBUG("VocabularyTree quantize: " << nbFeatures);
+    std::vector<Word> imgVisualWords(nbFeatures, 0);
 
 // quantize the features
 #pragma omp parallel for
-    for (ptrdiff_t j = 0; j < static_cast<ptrdiff_t>(features.size()); ++j)
+    for (ptrdiff_t j = 0; j < static_cast<ptrdiff_t>(nbFeatures); ++j)
     {
         // store the visual word associated to the feature in the temporary list
         imgVisualWords[j] = quantize<DescriptorT>(features[j]);
@@ -236,10 +250,10 @@ std::vector<Word> VocabularyTree<Feature, Distance>::quantize(const std::vector<
 
 template<class Feature, template<typename, typename> class Distance>
 template<class DescriptorT>
-SparseHistogram VocabularyTree<Feature, Distance>::quantizeToSparse(const std::vector<DescriptorT>& features) const
+SparseHistogram VocabularyTree<Feature, Distance>::quantizeToSparse(const DescriptorT* features, std::size_t nbFeatures) const
 {
     SparseHistogram histo;
-    std::vector<Word> doc = quantize(features);
+    std::vector<Word> doc = quantize(features, nbFeatures);
     computeSparseHistogram(doc, histo);
     return histo;
 }
@@ -6,8 +6,10 @@
 
 #include <aliceVision/voctree/Database.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <random>
 #include <vector>
 
 #define BOOST_TEST_MODULE vocabularyTree
@@ -57,3 +59,52 @@ BOOST_AUTO_TEST_CASE(database)
         BOOST_CHECK_SMALL(static_cast<double>(match[0].score), 0.001);
     }
 }
+
+BOOST_AUTO_TEST_CASE(database_invertedFile)
+{
+    const int cardDocuments = 50;
+    const int cardWords = 40;
+    const int cardFeatures = 30;
+    const std::size_t N = 10;
+
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<Word> wordDistribution(0, cardWords - 1);
+
+    std::vector<SparseHistogram> histograms(cardDocuments);
+    for (int i = 0; i < cardDocuments; ++i)
+    {
+        std::vector<Word> document(cardFeatures);
+        for (Word& word : document)
+            word = wordDistribution(generator);
+        computeSparseHistogram(document, histograms[i]);
+    }
+
+    Database db(cardWords);
+    for (int i = 0; i < cardDocuments; ++i)
+        db.insert(i, histograms[i]);
+
+    // default word weights
+    const std::vector<float> weights(cardWords, 1.0f);
+
+    for (const std::string distanceMethod : {"classic", "commonPoints", "strongCommonPoints", "inversedWeightedCommonPoints"})
+    {
+        for (int i = 0; i < cardDocuments; ++i)
+        {
+            // reference ranking with an exhaustive scan of the database
+            std::vector<float> expectedScores;
+            for (int j = 0; j < cardDocuments; ++j)
+                expectedScores.push_back(sparseDistance(histograms[i], histograms[j], distanceMethod, weights));
+            std::sort(expectedScores.begin(), expectedScores.end());
+
+            std::vector<DocMatch> matches;
+            db.find(histograms[i], N, matches, distanceMethod);
+
+            BOOST_REQUIRE_EQUAL(matches.size(), N);
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                BOOST_CHECK_CLOSE(matches[k].score, expectedScores[k], 1e-4);
+                BOOST_CHECK_CLOSE(matches[k].score, sparseDistance(histograms[i], histograms[matches[k].id], distanceMethod, weights), 1e-4);
+            }
+        }
+    }
+}
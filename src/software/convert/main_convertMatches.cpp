@@ -0,0 +1,109 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/matching/io.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/cmdline/cmdline.hpp>
+#include <aliceVision/system/main.hpp>
+#include <aliceVision/utils/filesIO.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// These constants define the current software version.
+// They must be updated when the command line is changed.
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+
+using namespace aliceVision;
+
+namespace po = boost::program_options;
+namespace fs = std::filesystem;
+
+// convert matches files from a format to another (text / binary)
+int aliceVision_main(int argc, char** argv)
+{
+    // command-line parameters
+    std::vector<std::string> matchesFolders;
+    std::string outputFolder;
+
+    // user optional parameters
+    std::string fileExtension = "bin";
+    bool matchFilePerImage = false;
+    std::string filePrefix;
+
+    // clang-format off
+    po::options_description requiredParams("Required parameters");
+    requiredParams.add_options()
+        ("input,i", po::value<std::vector<std::string>>(&matchesFolders)->multitoken()->required(),
+         "Path to folder(s) containing the matches files to convert.")
+        ("output,o", po::value<std::string>(&outputFolder)->required(),
+         "Path to the output folder.");
+
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("matchesFileFormat", po::value<std::string>(&fileExtension)->default_value(fileExtension),
+         "Output matches file format:\n"
+         "* txt: text format\n"
+         "* bin: binary format with an index of the pairs")
+        ("matchFilePerImage", po::value<bool>(&matchFilePerImage)->default_value(matchFilePerImage),
+         "Save matches in a separate file per image.")
+        ("filePrefix", po::value<std::string>(&filePrefix)->default_value(filePrefix),
+         "Prefix of the output matches file(s).");
+    // clang-format on
+
+    CmdLine cmdline("AliceVision convertMatches");
+    cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
+    if (!cmdline.execute(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (fileExtension != "txt" && fileExtension != "bin")
+    {
+        ALICEVISION_LOG_ERROR("Invalid matches file format '" << fileExtension << "', expected 'txt' or 'bin'.");
+        return EXIT_FAILURE;
+    }
+
+    system::Timer timer;
+
+    // load all the matches from the input folder(s)
+    matching::PairwiseMatches matches;
+    if (!matching::Load(matches, std::set<IndexT>(), matchesFolders, std::vector<feature::EImageDescriberType>()))
+    {
+        ALICEVISION_LOG_ERROR("Unable to read the matches file(s).");
+        return EXIT_FAILURE;
+    }
+
+    ALICEVISION_LOG_INFO(matches.size() << " image pairs loaded in " << timer.elapsed() << " s.");
+
+    if (!utils::exists(outputFolder))
+    {
+        if (!fs::create_directory(outputFolder))
+        {
+            ALICEVISION_LOG_ERROR("Cannot create output folder: " << outputFolder);
+            return EXIT_FAILURE;
+        }
+    }
+
+    timer.reset();
+
+    // export the matches in the requested format
+    if (!matching::Save(matches, outputFolder, fileExtension, matchFilePerImage, filePrefix))
+    {
+        ALICEVISION_LOG_ERROR("Unable to export the matches in: " << outputFolder);
+        return EXIT_FAILURE;
+    }
+
+    ALICEVISION_LOG_INFO("Matches exported in " << timer.elapsed() << " s.");
+
+    return EXIT_SUCCESS;
+}
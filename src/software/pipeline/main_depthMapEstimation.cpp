@@ -248,10 +248,10 @@ int aliceVision_main(int argc, char* argv[])
     ALICEVISION_LOG_INFO(gpu::gpuInformationCUDA());
 
     // check if the gpu suppport CUDA compute capability 2.0
+    // note: without CUDA-Enabled GPU, depth maps are computed on CPU (slower)
     if (!gpu::gpuSupportCUDA(2, 0))
     {
-        ALICEVISION_LOG_ERROR("This program needs a CUDA-Enabled GPU (with at least compute capability 2.0).");
-        return EXIT_FAILURE;
+        ALICEVISION_LOG_WARNING("No CUDA-Enabled GPU (with at least compute capability 2.0), depth maps will be computed on CPU.");
     }
 
     // check if the scale is correct
@@ -32,7 +32,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -59,6 +59,7 @@ int aliceVision_main(int argc, char** argv)
     image::EImageColorSpace workingColorSpace = image::EImageColorSpace::SRGB;
     std::string maskExtension = "png";
     bool maskInvert = false;
+    bool binaryRegions = false;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -95,6 +96,9 @@ int aliceVision_main(int argc, char** argv)
          "File extension for masks.")
         ("maskInvert", po::value<bool>(&maskInvert)->default_value(maskInvert),
          "Invert mask values.")
+        ("binaryRegions", po::value<bool>(&binaryRegions)->default_value(binaryRegions),
+         "Export the features and descriptors of each view in a single binary '.regions' file per describer type, "
+         "which can be memory-mapped at loading, instead of the '.feat' and '.desc' files.")
         ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
          "Range image index start.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
@@ -146,6 +150,7 @@ int aliceVision_main(int argc, char** argv)
     featureEngine::FeatureExtractor extractor(sfmData);
     extractor.setMasksFolder(masksFolder, maskExtension, maskInvert);
     extractor.setOutputFolder(outputFolder);
+    extractor.setBinaryRegions(binaryRegions);
 
     // set maxThreads
     HardwareContext hwc = cmdline.getHardwareContext();
@@ -25,6 +25,8 @@
 #include <aliceVision/matchingImageCollection/GeometricFilterMatrix_HGrowing.hpp>
 #include <aliceVision/matchingImageCollection/GeometricFilterType.hpp>
 #include <aliceVision/matchingImageCollection/ImagePairListIO.hpp>
+#include <aliceVision/matchingImageCollection/pairScheduling.hpp>
+#include <aliceVision/matchingImageCollection/RegionsCache.hpp>
 #include <aliceVision/matching/pairwiseAdjacencyDisplay.hpp>
 #include <aliceVision/matching/io.hpp>
 #include <aliceVision/system/main.hpp>
@@ -35,6 +37,7 @@
 
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <cstdlib>
 #include <fstream>
@@ -43,7 +46,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 using namespace aliceVision::camera;
@@ -116,9 +119,10 @@ int aliceVision_main(int argc, char** argv)
     bool useGridSort = true;
     bool exportDebugFiles = false;
     bool matchFromKnownCameraPoses = false;
-    const std::string fileExtension = "txt";
+    std::string fileExtension = "txt";
     int randomSeed = std::mt19937::default_seed;
     double minRequired2DMotion = -1.0;
+    std::size_t regionsCacheSize = 0;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -168,6 +172,10 @@ int aliceVision_main(int argc, char** argv)
          "Make sure that the matching process is symmetric (same matches for I->J than fo J->I).")
         ("matchFilePerImage", po::value<bool>(&matchFilePerImage)->default_value(matchFilePerImage),
          "Save matches in a separate file per image.")
+        ("matchesFileFormat", po::value<std::string>(&fileExtension)->default_value(fileExtension),
+         "Matches file format:\n"
+         "* txt: text format\n"
+         "* bin: binary format with an index of the pairs, for fast loading of all or selected pairs")
         ("distanceRatio", po::value<float>(&distRatio)->default_value(distRatio),
          "Distance ratio to discard non meaningful matches.")
         ("maxIteration", po::value<int>(&maxIteration)->default_value(maxIteration),
@@ -176,6 +184,10 @@ int aliceVision_main(int argc, char** argv)
          "Use matching grid sort.")
         ("minRequired2DMotion", po::value<double>(&minRequired2DMotion)->default_value(minRequired2DMotion),
          "A match is invalid if the 2D motion between the 2 points is less than a threshold (or -1 to disable this filter).")
+        ("regionsCacheSize", po::value<std::size_t>(&regionsCacheSize)->default_value(regionsCacheSize),
+         "Maximum memory (in MB) of the descriptors loaded at the same time for the putative matching. "
+         "The pairs are matched by blocks of views and the regions are loaded on demand. "
+         "If set to 0, the regions of all the views are loaded.")
         ("exportDebugFiles", po::value<bool>(&exportDebugFiles)->default_value(exportDebugFiles),
          "Export debug files (svg, dot).")
         ("maxMatches", po::value<std::size_t>(&numMatchesToKeep)->default_value(numMatchesToKeep),
@@ -201,6 +213,12 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+    if (fileExtension != "txt" && fileExtension != "bin")
+    {
+        ALICEVISION_LOG_ERROR("Invalid matches file format '" << fileExtension << "', expected 'txt' or 'bin'.");
+        return EXIT_FAILURE;
+    }
+
     const double defaultLoRansacMatchingError = 20.0;
     if (!adjustRobustEstimatorThreshold(geometricEstimator, geometricErrorMax, defaultLoRansacMatchingError))
         return EXIT_FAILURE;
@@ -287,15 +305,48 @@ int aliceVision_main(int argc, char** argv)
 
     ALICEVISION_LOG_INFO("There are " << sfmData.getViews().size() << " views and " << pairs.size() << " image pairs.");
 
-    ALICEVISION_LOG_INFO("Load features and descriptors");
-
     // load the corresponding view regions
+    // descriptors of binary regions files are only read through the matchers, so they can stay memory-mapped
+    // with a regions cache, only the features are loaded here and the descriptors are loaded on demand for the matching
+    const bool useRegionsCache = regionsCacheSize > 0;
     RegionsPerView regionPerView;
-    if (!sfm::loadRegionsPerView(regionPerView, sfmData, featuresFolders, describerTypes, filter))
+    if (useRegionsCache && guidedMatching)
+        ALICEVISION_LOG_WARNING("Guided matching needs the descriptors of all the views, the regions cache only bounds the putative matching.");
+
+    if (useRegionsCache && !guidedMatching)
     {
-        ALICEVISION_LOG_ERROR("Invalid regions in '" + sfmDataFilename + "'");
-        return EXIT_FAILURE;
+        ALICEVISION_LOG_INFO("Load features");
+        if (!sfm::loadFeaturesRegionsPerView(regionPerView, sfmData, featuresFolders, describerTypes, filter))
+        {
+            ALICEVISION_LOG_ERROR("Invalid features in '" + sfmDataFilename + "'");
+            return EXIT_FAILURE;
+        }
     }
+    else
+    {
+        ALICEVISION_LOG_INFO("Load features and descriptors");
+        if (!sfm::loadRegionsPerView(regionPerView, sfmData, featuresFolders, describerTypes, filter, true))
+        {
+            ALICEVISION_LOG_ERROR("Invalid regions in '" + sfmDataFilename + "'");
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<std::string> regionsFolders = sfmData.getFeaturesFolders();
+    regionsFolders.insert(regionsFolders.end(), featuresFolders.begin(), featuresFolders.end());
+    std::sort(regionsFolders.begin(), regionsFolders.end());
+    regionsFolders.erase(std::unique(regionsFolders.begin(), regionsFolders.end()), regionsFolders.end());
+
+    std::map<feature::EImageDescriberType, std::unique_ptr<feature::ImageDescriber>> imageDescribers;
+    for (const feature::EImageDescriberType descType : describerTypes)
+        imageDescribers.emplace(descType, createImageDescriber(descType));
+
+    RegionsCache regionsCache(
+      [&](IndexT viewId, feature::EImageDescriberType descType) {
+          return sfm::loadRegions(regionsFolders, viewId, *imageDescribers.at(descType), true);
+      },
+      describerTypes,
+      regionsCacheSize * 1024 * 1024);
 
     // perform the matching
     system::Timer timer;
@@ -327,7 +378,16 @@ int aliceVision_main(int argc, char** argv)
         ALICEVISION_LOG_INFO("Putative matches from known poses: " << pairsPoseKnown.size() << " image pairs.");
 
         sfm::StructureEstimationFromKnownPoses structureEstimator;
-        structureEstimator.match(sfmData, pairsPoseKnown, regionPerView, knownPosesGeometricErrorMax);
+        if (useRegionsCache)
+        {
+            processPairsByBlocks(regionsCache, pairsPoseKnown, [&](const RegionsPerView& tileRegionsPerView, const PairSet& tilePairs) {
+                structureEstimator.match(sfmData, tilePairs, tileRegionsPerView, knownPosesGeometricErrorMax);
+            });
+        }
+        else
+        {
+            structureEstimator.match(sfmData, pairsPoseKnown, regionPerView, knownPosesGeometricErrorMax);
+        }
         mapPutativesMatches = structureEstimator.getPutativesMatches();
     }
 
@@ -336,19 +396,57 @@ int aliceVision_main(int argc, char** argv)
         ALICEVISION_LOG_INFO("Putative matches (unknown poses): " << pairsPoseUnknown.size() << " image pairs.");
         // match feature descriptors between them without geometric notion
 
-        for (const feature::EImageDescriberType descType : describerTypes)
+        if (useRegionsCache)
+        {
+            // the cascade hashing is shared by all the tiles, so the matches do not depend on the regions cache size:
+            // its zero mean descriptor is computed from all the views, loading one view at a time
+            if (collectionMatcherType == EMatcherType::FAST_CASCADE_HASHING_L2)
+            {
+                auto& cascadeHashingMatcher = dynamic_cast<ImageCollectionMatcher_cascadeHashing&>(*imageCollectionMatcher);
+
+                std::set<IndexT> viewIds;
+                for (const Pair& pair : pairsPoseUnknown)
+                {
+                    viewIds.insert(pair.first);
+                    viewIds.insert(pair.second);
+                }
+
+                for (const IndexT viewId : viewIds)
+                {
+                    regionsCache.acquire({viewId});
+                    for (const feature::EImageDescriberType descType : describerTypes)
+                        cascadeHashingMatcher.addToZeroMeanDescriptor(regionsCache.getRegionsPerView(), {viewId}, descType);
+                }
+            }
+
+            // photometric matching of putative pairs, tile by tile
+            processPairsByBlocks(regionsCache, pairsPoseUnknown, [&](const RegionsPerView& tileRegionsPerView, const PairSet& tilePairs) {
+                for (const feature::EImageDescriberType descType : describerTypes)
+                {
+                    assert(descType != feature::EImageDescriberType::UNINITIALIZED);
+                    imageCollectionMatcher->Match(randomNumberGenerator, tileRegionsPerView, tilePairs, descType, mapPutativesMatches);
+                }
+            });
+        }
+        else
         {
-            assert(descType != feature::EImageDescriberType::UNINITIALIZED);
-            ALICEVISION_LOG_INFO(EImageDescriberType_enumToString(descType) + " Regions Matching");
+            for (const feature::EImageDescriberType descType : describerTypes)
+            {
+                assert(descType != feature::EImageDescriberType::UNINITIALIZED);
+                ALICEVISION_LOG_INFO(EImageDescriberType_enumToString(descType) + " Regions Matching");
 
-            // photometric matching of putative pairs
-            imageCollectionMatcher->Match(randomNumberGenerator, regionPerView, pairsPoseUnknown, descType, mapPutativesMatches);
+                // photometric matching of putative pairs
+                imageCollectionMatcher->Match(randomNumberGenerator, regionPerView, pairsPoseUnknown, descType, mapPutativesMatches);
 
-            // TODO: DELI
-            // if(!guided_matching) regionPerView.clearDescriptors()
+                // TODO: DELI
+                // if(!guided_matching) regionPerView.clearDescriptors()
+            }
         }
     }
 
+    if (useRegionsCache)
+        regionsCache.logStatistics();
+
     filterMatchesByMin2DMotion(mapPutativesMatches, regionPerView, minRequired2DMotion);
 
     if (mapPutativesMatches.empty())
@@ -47,6 +47,7 @@ int aliceVision_main(int argc, char** argv)
     sfm::ERotationAveragingMethod rotationAveragingMethod = sfm::ROTATION_AVERAGING_L2;
     sfm::ETranslationAveragingMethod translationAveragingMethod = sfm::TRANSLATION_AVERAGING_SOFTL1;
     bool lockAllIntrinsics = false;
+    std::size_t bundleAdjustmentMemoryBudgetMB = 0;
     int randomSeed = std::mt19937::default_seed;
 
     // clang-format off
@@ -78,6 +79,9 @@ int aliceVision_main(int argc, char** argv)
          "* 3: L1 soft minimization")
         ("lockAllIntrinsics", po::value<bool>(&lockAllIntrinsics)->default_value(lockAllIntrinsics),
          "Force lock of all camera intrinsic parameters, so they will not be refined during Bundle Adjustment.")
+        ("bundleAdjustmentMemoryBudget", po::value<std::size_t>(&bundleAdjustmentMemoryBudgetMB)->default_value(bundleAdjustmentMemoryBudgetMB),
+         "Memory budget of the bundle adjustments (in MB). Larger scenes are split into overlapping clusters of cameras, "
+         "adjusted in parallel and iterated to a consensus on the shared cameras and intrinsics (0: no limit).")
         ("randomSeed", po::value<int>(&randomSeed)->default_value(randomSeed),
          "This seed value will generate a sequence using a linear random generator. Set -1 to use a random seed.");
     // clang-format on
@@ -166,6 +170,7 @@ int aliceVision_main(int argc, char** argv)
 
     // configure reconstruction parameters
     sfmEngine.setLockAllIntrinsics(lockAllIntrinsics);  // TODO: rename param
+    sfmEngine.setBundleAdjustmentMemoryBudget(bundleAdjustmentMemoryBudgetMB);
 
     // configure motion averaging method
     sfmEngine.setRotationAveragingMethod(sfm::ERotationAveragingMethod(rotationAveragingMethod));
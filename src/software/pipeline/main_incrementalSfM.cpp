@@ -154,6 +154,12 @@ int aliceVision_main(int argc, char** argv)
          "It reduces the reconstruction time, especially for big datasets (500+ images).")
         ("localBAGraphDistance", po::value<int>(&sfmParams.localBundelAdjustementGraphDistanceLimit)->default_value(sfmParams.localBundelAdjustementGraphDistanceLimit),
          "Graph-distance limit setting the Active region in the Local Bundle Adjustment strategy.")
+        ("useIncrementalBA", po::value<bool>(&sfmParams.useIncrementalBundleAdjustment)->default_value(sfmParams.useIncrementalBundleAdjustment),
+         "Keep the bundle adjustment problem across the resections and only add/remove the parameters and observations which changed, "
+         "instead of rebuilding it after each resection.")
+        ("bundleAdjustmentMemoryBudget", po::value<std::size_t>(&sfmParams.bundleAdjustmentMemoryBudgetMB)->default_value(sfmParams.bundleAdjustmentMemoryBudgetMB),
+         "Memory budget of the bundle adjustments (in MB). Larger problems are split into overlapping clusters of cameras, "
+         "adjusted in parallel and iterated to a consensus on the shared cameras and intrinsics (0: no limit).")
         ("nbFirstUnstableCameras", po::value<std::size_t>(&sfmParams.nbFirstUnstableCameras)->default_value(sfmParams.nbFirstUnstableCameras),
          "Number of cameras for which the bundle adjustment is performed every single time a camera is added, leading to more stable "
          "results while the computations are not too expensive since there is not much data. Past this number, the bundle adjustment "
@@ -9,16 +9,7 @@
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/fuseCut/InputSet.hpp>
 
-#include <OpenMesh/Core/IO/reader/OBJReader.hh>
-#include <OpenMesh/Core/IO/writer/OBJWriter.hh>
-#include <OpenMesh/Core/IO/MeshIO.hh>
-#include <OpenMesh/Core/Mesh/TriMesh_ArrayKernelT.hh>
-#include <OpenMesh/Core/Geometry/VectorT.hh>
-#include <OpenMesh/Tools/Decimater/DecimaterT.hh>
-#include <OpenMesh/Tools/Decimater/McDecimaterT.hh>
-
-#include <aliceVision/mesh/ModQuadricMetricT.hpp>
-#include <aliceVision/mesh/ModBoundingBoxT.hpp>
+#include <aliceVision/mesh/MeshDecimation.hpp>
 
 #include <boost/program_options.hpp>
 #include <fstream>
@@ -32,63 +23,14 @@ using namespace aliceVision;
 
 namespace po = boost::program_options;
 
-bool computeSubMesh(const std::string& outputMeshPath,
-                    const std::string& inputMeshPath,
-                    const Eigen::Vector3d& bbMin,
-                    const Eigen::Vector3d& bbMax,
-                    double errorLimit)
-{
-    typedef OpenMesh::TriMesh_ArrayKernelT<> Mesh;
-    typedef OpenMesh::Decimater::DecimaterT<Mesh> Decimater;
-    typedef OpenMesh::Decimater::ModQuadricMetricT<Mesh>::Handle HModQuadricMetric;
-    typedef OpenMesh::Decimater::ModBoundingBoxT<Mesh>::Handle HModBoundingBox;
-
-    Mesh mesh;
-    if (!OpenMesh::IO::read_mesh(mesh, inputMeshPath))
-    {
-        ALICEVISION_LOG_ERROR("Unable to read input mesh from the file: " << inputMeshPath);
-        return false;
-    }
-
-    ALICEVISION_LOG_INFO("Mesh file: \"" << inputMeshPath << "\" loaded.");
-
-    int nbInputPoints = mesh.n_vertices();
-
-    Decimater decimater(mesh);
-    HModQuadricMetric hModQuadric;
-    decimater.add(hModQuadric);
-    decimater.module(hModQuadric).set_max_err(errorLimit * errorLimit);
-
-    decimater.initialize();
-    size_t removedVertices = decimater.decimate(0);
-    decimater.mesh().garbage_collection();
-
-    if (mesh.n_faces() == 0)
-    {
-        ALICEVISION_LOG_ERROR("Failed: the output mesh is empty.");
-        return false;
-    }
-
-    ALICEVISION_LOG_INFO("Before : " << nbInputPoints);
-    ALICEVISION_LOG_INFO("After : " << mesh.n_vertices());
-
-    ALICEVISION_LOG_INFO("Save mesh.");
-    if (!OpenMesh::IO::write_mesh(mesh, outputMeshPath))
-    {
-        ALICEVISION_LOG_ERROR("Failed to save mesh \"" << outputMeshPath << "\".");
-        return false;
-    }
-
-    return true;
-}
-
 int aliceVision_main(int argc, char* argv[])
 {
     system::Timer timer;
     int rangeStart = -1;
     int rangeSize = 1;
     int rangeEnd = 1;
-    double errorLimit = 0.001;
+    mesh::StreamingDecimationParams decimationParams;
+    decimationParams.errorLimit = 0.001;
 
     std::string jsonFilename = "";
     std::string outputDirectory = "";
@@ -110,8 +52,11 @@ int aliceVision_main(int argc, char* argv[])
          "Range image index start.")
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
          "Range size.")
-        ("errorLimit", po::value<double>(&errorLimit)->default_value(errorLimit),
-         "Limit on error allowed for collapsing in meters.");
+        ("errorLimit", po::value<double>(&decimationParams.errorLimit)->default_value(decimationParams.errorLimit),
+         "Limit on error allowed for collapsing in meters.")
+        ("maxVerticesPerCluster", po::value<int>(&decimationParams.maxVerticesPerCluster)->default_value(decimationParams.maxVerticesPerCluster),
+         "Max number of vertices of a cluster loaded in memory. "
+         "Larger sub-meshes are streamed and decimated by spatial clusters in parallel.");
     // clang-format on
 
     CmdLine cmdline("AliceVision lidarMeshing");
@@ -161,7 +106,7 @@ int aliceVision_main(int argc, char* argv[])
         std::string ss = outputDirectory + "/subobj_" + std::to_string(idSub) + ".obj";
 
         ALICEVISION_LOG_INFO("Computing sub mesh " << idSub + 1 << " / " << setSize);
-        if (!computeSubMesh(ss, input.subMeshPath, input.bbMin, input.bbMax, errorLimit))
+        if (!mesh::decimateMeshOutOfCore(input.subMeshPath, ss, outputDirectory, decimationParams))
         {
             ALICEVISION_LOG_ERROR("Error computing sub mesh");
             return EXIT_FAILURE;
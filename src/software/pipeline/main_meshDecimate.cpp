@@ -9,6 +9,7 @@
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
+#include <aliceVision/mesh/MeshDecimation.hpp>
 
 #include <OpenMesh/Core/IO/reader/OBJReader.hh>
 #include <OpenMesh/Core/IO/writer/OBJWriter.hh>
@@ -38,11 +39,9 @@ int aliceVision_main(int argc, char* argv[])
     std::string inputMeshPath;
     std::string outputMeshPath;
 
-    float simplificationFactor = 0;
-    int fixedNbVertices = 0;
-    int minVertices = 0;
-    int maxVertices = 0;
+    mesh::StreamingDecimationParams decimationParams;
     bool flipNormals = false;
+    bool outOfCore = false;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -54,17 +53,22 @@ int aliceVision_main(int argc, char* argv[])
 
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
-        ("simplificationFactor", po::value<float>(&simplificationFactor)->default_value(simplificationFactor),
+        ("simplificationFactor", po::value<double>(&decimationParams.simplificationFactor)->default_value(decimationParams.simplificationFactor),
          "Simplification factor.")
-        ("nbVertices", po::value<int>(&fixedNbVertices)->default_value(fixedNbVertices),
+        ("nbVertices", po::value<int>(&decimationParams.fixedNbVertices)->default_value(decimationParams.fixedNbVertices),
          "Fixed number of output vertices.")
-        ("minVertices", po::value<int>(&minVertices)->default_value(minVertices),
+        ("minVertices", po::value<int>(&decimationParams.minVertices)->default_value(decimationParams.minVertices),
          "Min number of output vertices.")
-        ("maxVertices", po::value<int>(&maxVertices)->default_value(maxVertices),
+        ("maxVertices", po::value<int>(&decimationParams.maxVertices)->default_value(decimationParams.maxVertices),
          "Max number of output vertices.")
         ("flipNormals", po::value<bool>(&flipNormals)->default_value(flipNormals),
          "Option to flip face normals. It can be needed as it depends on the vertices order in triangles and the "
-         "convention changes from one software to another.");
+         "convention changes from one software to another.")
+        ("outOfCore", po::value<bool>(&outOfCore)->default_value(outOfCore),
+         "Stream the input mesh (OBJ file format) and decimate it by spatial clusters in parallel, "
+         "for meshes which do not fit in memory.")
+        ("maxVerticesPerCluster", po::value<int>(&decimationParams.maxVerticesPerCluster)->default_value(decimationParams.maxVerticesPerCluster),
+         "Out-of-core decimation: max number of vertices of a cluster loaded in memory.");
     // clang-format on
 
     CmdLine cmdline("AliceVision meshDecimate");
@@ -80,6 +84,16 @@ int aliceVision_main(int argc, char* argv[])
     if (!fs::is_directory(outDirectory))
         fs::create_directory(outDirectory);
 
+    if (outOfCore)
+    {
+        if (!mesh::decimateMeshOutOfCore(inputMeshPath, outputMeshPath, outDirectory.string(), decimationParams))
+            return EXIT_FAILURE;
+
+        ALICEVISION_LOG_INFO("Mesh file: \"" << outputMeshPath << "\" saved.");
+        ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
+        return EXIT_SUCCESS;
+    }
+
     // Mesh type
     typedef OpenMesh::TriMesh_ArrayKernelT<> Mesh;
     // Decimater type
@@ -97,28 +111,7 @@ int aliceVision_main(int argc, char* argv[])
     ALICEVISION_LOG_INFO("Mesh file: \"" << inputMeshPath << "\" loaded.");
 
     int nbInputPoints = mesh.n_vertices();
-    int nbOutputPoints = 0;
-    if (fixedNbVertices != 0)
-    {
-        nbOutputPoints = fixedNbVertices;
-    }
-    else
-    {
-        if (simplificationFactor != 0.0)
-        {
-            nbOutputPoints = simplificationFactor * nbInputPoints;
-        }
-        if (minVertices != 0)
-        {
-            if (nbInputPoints > minVertices && nbOutputPoints < minVertices)
-                nbOutputPoints = minVertices;
-        }
-        if (maxVertices != 0)
-        {
-            if (nbInputPoints > maxVertices && nbOutputPoints > maxVertices)
-                nbOutputPoints = maxVertices;
-        }
-    }
+    const int nbOutputPoints = aliceVision::mesh::getDecimationTargetNbVertices(nbInputPoints, decimationParams);
 
     ALICEVISION_LOG_INFO("Input mesh: " << nbInputPoints << " vertices and " << mesh.n_faces() << " facets.");
     ALICEVISION_LOG_INFO("Target output mesh: " << nbOutputPoints << " vertices.");
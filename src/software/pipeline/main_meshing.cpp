@@ -12,6 +12,7 @@
 #include <aliceVision/fuseCut/BoundingBox.hpp>
 #include <aliceVision/fuseCut/PointCloud.hpp>
 #include <aliceVision/mesh/meshPostProcessing.hpp>
+#include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/mvsData/Point3d.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
@@ -23,6 +24,8 @@
 #include <aliceVision/system/Timer.hpp>
 #include <aliceVision/fuseCut/GraphFiller.hpp>
 #include <aliceVision/fuseCut/Mesher.hpp>
+#include <aliceVision/fuseCut/SpacePartitioning.hpp>
+#include <aliceVision/fuseCut/SubMeshMerger.hpp>
 
 #include <Eigen/Geometry>
 
@@ -34,7 +37,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 4
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -146,6 +149,8 @@ int aliceVision_main(int argc, char* argv[])
     float estimateSpaceMinObservationAngle = 10.0f;
     double universePercentile = 0.999;
     int maxPtsPerVoxel = 6000000;
+    double partitioningOverlap = 0.1;
+    double seamWeldFactor = 1.0;
     bool meshingFromDepthMaps = true;
     bool estimateSpaceFromSfM = true;
     bool addLandmarksToTheDensePointCloud = false;
@@ -168,6 +173,7 @@ int aliceVision_main(int argc, char* argv[])
     double fullWeight = 1.0;
     bool exportDebugTetrahedralization = false;
     int maxNbConnectedHelperPoints = 50;
+    fuseCut::EMaxFlowSolver maxFlowSolver = fuseCut::EMaxFlowSolver::BoykovKolmogorov;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -190,7 +196,7 @@ int aliceVision_main(int argc, char* argv[])
         ("maxPoints", po::value<int>(&fuseParams.maxPoints)->default_value(fuseParams.maxPoints),
          "Maximum number of points at the end of the depth maps fusion.")
         ("maxPointsPerVoxel", po::value<int>(&maxPtsPerVoxel)->default_value(maxPtsPerVoxel),
-         "Maximum number of points per voxel.")
+         "Maximum number of points per voxel. With 'auto' partitioning, the space is divided into blocks of at most this number of points.")
         ("minStep", po::value<int>(&fuseParams.minStep)->default_value(fuseParams.minStep),
          "The step used to load depth values from depth maps is computed from maxInputPts. "
          "Here we define the minimal value for this step, so on small datasets we will not spend too much time at the "
@@ -202,7 +208,7 @@ int aliceVision_main(int argc, char* argv[])
         ("minVis", po::value<int>(&fuseParams.minVis)->default_value(fuseParams.minVis),
          "Filter points based on their number of observations.")
         ("partitioning", po::value<EPartitioningMode>(&partitioningMode)->default_value(partitioningMode),
-         "Partitioning: 'singleBlock' or 'auto'.")
+         "Partitioning: 'singleBlock' or 'auto' (overlapping blocks meshed independently, then merged).")
         ("repartition", po::value<ERepartitionMode>(&repartitionMode)->default_value(repartitionMode),
          "Repartition: 'multiResolution' or 'regularGrid'.")
         ("estimateSpaceFromSfM", po::value<bool>(&estimateSpaceFromSfM)->default_value(estimateSpaceFromSfM),
@@ -267,8 +273,17 @@ int aliceVision_main(int argc, char* argv[])
          "Maximum number of connected helper points before we remove them.")
         ("exportDebugTetrahedralization", po::value<bool>(&exportDebugTetrahedralization)->default_value(exportDebugTetrahedralization),
          "Export debug cells score as tetrahedral mesh. WARNING: could create huge meshes, only use on very small datasets.")
+        ("partitioningOverlap", po::value<double>(&partitioningOverlap)->default_value(partitioningOverlap),
+         "With 'auto' partitioning, overlap margin on each side of a block, relative to the block size.")
+        ("seamWeldFactor", po::value<double>(&seamWeldFactor)->default_value(seamWeldFactor),
+         "With 'auto' partitioning, maximal distance between the ends of the two sub-meshes boundaries stitched along a seam, "
+         "relative to the boundary edges length.")
         ("seed", po::value<unsigned int>(&seed)->default_value(seed),
-         "Seed used in random processes. (0 to use a random seed).");
+         "Seed used in random processes. (0 to use a random seed).")
+        ("maxFlowSolver", po::value<fuseCut::EMaxFlowSolver>(&maxFlowSolver)->default_value(maxFlowSolver),
+         "Max flow solver used for the graph cut:\n"
+         "* BoykovKolmogorov: boost Boykov-Kolmogorov on an adjacency list (single-threaded)\n"
+         "* PushRelabel: parallel push-relabel on a compact CSR graph");
     // clang-format on
 
     CmdLine cmdline("AliceVision meshing");
@@ -340,48 +355,105 @@ int aliceVision_main(int argc, char* argv[])
     {
         case eRepartitionMultiResolution:
         {
-            switch (partitioningMode)
+            std::array<Point3d, 8> hexah;
+
+            float minPixSize;
+            fuseCut::Fuser fs(mp);
+
+            if (boundingBox.isInitialized())
+                boundingBox.toHexahedron(&hexah[0]);
+            else if (meshingFromDepthMaps && (!estimateSpaceFromSfM || sfmData.getLandmarks().empty()))
+                fs.divideSpaceFromDepthMaps(&hexah[0], minPixSize);
+            else
+                fs.divideSpaceFromSfM(sfmData, &hexah[0], estimateSpaceMinObservations, estimateSpaceMinObservationAngle);
+
             {
-                case ePartitioningAuto:
+                const double length = hexah[0].x - hexah[1].x;
+                const double width = hexah[0].y - hexah[3].y;
+                const double height = hexah[0].z - hexah[4].z;
+
+                ALICEVISION_LOG_INFO("bounding Box : length: " << length << ", width: " << width << ", height: " << height);
+
+                // Save bounding box
+                fuseCut::BoundingBox bbox = fuseCut::BoundingBox::fromHexahedron(&hexah[0]);
+                std::string filename = (outDirectory / "boundingBox.txt").string();
+                std::ofstream fs(filename, std::ios::out);
+                if (!fs.is_open())
                 {
-                    throw std::invalid_argument("Meshing mode: 'multiResolution', partitioning: 'auto' is not yet implemented.");
+                    ALICEVISION_LOG_WARNING("Unable to create the bounding box file " << filename);
                 }
-                case ePartitioningSingleBlock:
+                fs << bbox.translation << std::endl;
+                fs << bbox.rotation << std::endl;
+                fs << bbox.scale << std::endl;
+                fs.close();
+            }
+
+            switch (partitioningMode)
+            {
+                case ePartitioningAuto:
                 {
-                    ALICEVISION_LOG_INFO("Meshing mode: multi-resolution, partitioning: single block.");
-                    std::array<Point3d, 8> hexah;
+                    ALICEVISION_LOG_INFO("Meshing mode: multi-resolution, partitioning: auto.");
 
-                    float minPixSize;
-                    fuseCut::Fuser fs(mp);
+                    if (!meshingFromDepthMaps)
+                        throw std::invalid_argument("Meshing mode: 'multiResolution', partitioning: 'auto' requires depth maps.");
 
-                    if (boundingBox.isInitialized())
-                        boundingBox.toHexahedron(&hexah[0]);
-                    else if (meshingFromDepthMaps && (!estimateSpaceFromSfM || sfmData.getLandmarks().empty()))
-                        fs.divideSpaceFromDepthMaps(&hexah[0], minPixSize);
-                    else
-                        fs.divideSpaceFromSfM(sfmData, &hexah[0], estimateSpaceMinObservations, estimateSpaceMinObservationAngle);
+                    if (saveRawDensePointCloud)
+                        ALICEVISION_LOG_WARNING("Save dense point cloud before cut and filtering is not available with 'auto' partitioning.");
+
+                    // each block is fused with at most maxPtsPerVoxel points
+                    const int nbBlocks = divideRoundUp(std::max(1, fuseParams.maxPoints), std::max(1, maxPtsPerVoxel));
+                    const fuseCut::SpacePartitioning partitioning(&hexah[0], nbBlocks, partitioningOverlap);
 
+                    fuseCut::PointCloudFuseParams blockFuseParams = fuseParams;
+                    blockFuseParams.maxPoints = std::min(fuseParams.maxPoints, maxPtsPerVoxel);
+
+                    fuseCut::SubMeshMerger merger(partitioning);
+
+                    // blocks are meshed one after the other, only one tetrahedralization is in memory
+                    for (int blockIndex = 0; blockIndex < partitioning.getNbBlocks(); ++blockIndex)
                     {
-                        const double length = hexah[0].x - hexah[1].x;
-                        const double width = hexah[0].y - hexah[3].y;
-                        const double height = hexah[0].z - hexah[4].z;
+                        ALICEVISION_LOG_INFO("Meshing block " << (blockIndex + 1) << " / " << partitioning.getNbBlocks() << ".");
 
-                        ALICEVISION_LOG_INFO("bounding Box : length: " << length << ", width: " << width << ", height: " << height);
+                        std::array<Point3d, 8> blockHexah = partitioning.getBlockHexahedron(blockIndex);
 
-                        // Save bounding box
-                        fuseCut::BoundingBox bbox = fuseCut::BoundingBox::fromHexahedron(&hexah[0]);
-                        std::string filename = (outDirectory / "boundingBox.txt").string();
-                        std::ofstream fs(filename, std::ios::out);
-                        if (!fs.is_open())
+                        const StaticVector<int> blockCams = mp.findCamsWhichIntersectsHexahedron(&blockHexah[0]);
+                        if (blockCams.empty())
                         {
-                            ALICEVISION_LOG_WARNING("Unable to create the bounding box file " << filename);
+                            ALICEVISION_LOG_INFO("No camera intersects block " << blockIndex << ", skip it.");
+                            continue;
                         }
-                        fs << bbox.translation << std::endl;
-                        fs << bbox.rotation << std::endl;
-                        fs << bbox.scale << std::endl;
-                        fs.close();
+
+                        fuseCut::PointCloud pc(mp);
+                        pc.createDensePointCloud(&blockHexah[0], blockCams, addLandmarksToTheDensePointCloud ? &sfmData : nullptr, &blockFuseParams);
+
+                        fuseCut::Tetrahedralization tetrahedralization(pc.getVertices());
+
+                        fuseCut::GraphFiller gfiller(mp, pc, tetrahedralization);
+                        gfiller.build(blockCams);
+                        gfiller.binarize(maxFlowSolver);
+
+                        fuseCut::Mesher mesher(mp, pc, tetrahedralization, gfiller.getCellsStatus());
+                        mesher.graphCutPostProcessing(&blockHexah[0]);
+
+                        mesh::Mesh* blockMesh = mesher.createMesh(maxNbConnectedHelperPoints);
+                        StaticVector<StaticVector<int>> blockPtsCams;
+                        pc.createPtsCams(blockPtsCams);
+
+                        merger.addSubMesh(*blockMesh, blockPtsCams, blockIndex);
+                        delete blockMesh;
                     }
 
+                    merger.weldSeams(seamWeldFactor);
+
+                    mesh = merger.releaseMesh(ptsCams);
+                    mesh::meshPostProcessing(mesh, ptsCams, mp, outDirectory.string() + "/", nullptr, &hexah[0]);
+
+                    break;
+                }
+                case ePartitioningSingleBlock:
+                {
+                    ALICEVISION_LOG_INFO("Meshing mode: multi-resolution, partitioning: single block.");
+
                     StaticVector<int> cams;
                     if (meshingFromDepthMaps)
                     {
@@ -417,7 +489,7 @@ int aliceVision_main(int argc, char* argv[])
 
                     fuseCut::GraphFiller gfiller(mp, pc, tetrahedralization);
                     gfiller.build(cams);
-                    gfiller.binarize();
+                    gfiller.binarize(maxFlowSolver);
 
                     fuseCut::Mesher mesher(mp, pc, tetrahedralization, gfiller.getCellsStatus());
                     mesher.graphCutPostProcessing(&hexah[0]);
@@ -43,6 +43,8 @@ int aliceVision_main(int argc, char** argv)
     bool lockScenePreviouslyReconstructed = false;
     bool useLocalBA = true;
     int lbaDistanceLimit = 1;
+    bool useIncrementalBA = false;
+    std::size_t bundleAdjustmentMemoryBudgetMB = 0;
     std::size_t nbFirstUnstableCameras = 30;
     std::size_t maxImagesPerGroup = 30;
     int bundleAdjustmentMaxOutliers = 50;
@@ -71,6 +73,8 @@ int aliceVision_main(int argc, char** argv)
     ("lockScenePreviouslyReconstructed", po::value<bool>(&lockScenePreviouslyReconstructed)->default_value(lockScenePreviouslyReconstructed),"Lock/Unlock scene previously reconstructed.")
     ("useLocalBA,l", po::value<bool>(&useLocalBA)->default_value(useLocalBA), "Enable/Disable the Local bundle adjustment strategy.\n It reduces the reconstruction time, especially for big datasets (500+ images).")
     ("localBAGraphDistance", po::value<int>(&lbaDistanceLimit)->default_value(lbaDistanceLimit), "Graph-distance limit setting the Active region in the Local Bundle Adjustment strategy.")
+    ("useIncrementalBA", po::value<bool>(&useIncrementalBA)->default_value(useIncrementalBA), "Keep the bundle adjustment problem across the iterations and only update what changed, instead of rebuilding it.")
+    ("bundleAdjustmentMemoryBudget", po::value<std::size_t>(&bundleAdjustmentMemoryBudgetMB)->default_value(bundleAdjustmentMemoryBudgetMB), "Memory budget of the bundle adjustment (in MB). Larger problems are split into overlapping clusters of cameras, adjusted in parallel and iterated to a consensus on the shared cameras and intrinsics (0: no limit).")
     ("nbFirstUnstableCameras", po::value<std::size_t>(&nbFirstUnstableCameras)->default_value(nbFirstUnstableCameras),
          "Number of cameras for which the bundle adjustment is performed every single time a camera is added, leading to more stable "
          "results while the computations are not too expensive since there is not much data. Past this number, the bundle adjustment "
@@ -172,6 +176,8 @@ int aliceVision_main(int argc, char** argv)
     sfmBundle->setMinAngleLandmark(minAngleForLandmark);
     sfmBundle->setMaxReprojectionError(maxReprojectionError);
     sfmBundle->setMinNbCamerasToRefinePrincipalPoint(minNbCamerasToRefinePrincipalPoint);
+    sfmBundle->setUseIncrementalBundleAdjustment(useIncrementalBA);
+    sfmBundle->setBundleAdjustmentMemoryBudget(bundleAdjustmentMemoryBudgetMB);
 
     sfm::ExpansionChunk::uptr expansionChunk = std::make_unique<sfm::ExpansionChunk>();
     expansionChunk->setBundleHandler(sfmBundle);
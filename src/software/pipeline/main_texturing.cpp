@@ -141,7 +141,10 @@ int aliceVision_main(int argc, char* argv[])
          " * PullPush: Combine results from Pull and Push results.'")
         ("subdivisionTargetRatio", po::value<float>(&texParams.subdivisionTargetRatio)->default_value(texParams.subdivisionTargetRatio),
          "Percentage of the density of the reconstruction as the target for the subdivision "
-         "(0: disable subdivision, 0.5: half density of the reconstruction, 1: full density of the reconstruction).");
+         "(0: disable subdivision, 0.5: half density of the reconstruction, 1: full density of the reconstruction).")
+        ("outOfCoreAtlases", po::value<bool>(&texParams.outOfCoreAtlases)->default_value(texParams.outOfCoreAtlases),
+         "Read each image only once and accumulate all the texture atlases in tiles which can be stored on disk. "
+         "Useful for many atlases or large texture sides, when the atlases do not fit in memory.");
     // clang-format on
 
     CmdLine cmdline("AliceVision texturing");